@@ -167,6 +167,7 @@ LOCAL_SRC_FILES := \
     ats/transports/tcpip_gateway/src/tcpip_gateway_main.cpp \
     ats/transports/tcpip_gateway/src/tcpip_gateway_cmd_server.cpp \
     ats/transports/tcpip_gateway/src/tcpip_gateway_dls_server.cpp \
+    ats/transports/tcpip_gateway/src/tcpip_gateway_mux_session.cpp \
     ats/transports/tcpip_gateway/src/tcpip_gateway_socket_util.cpp \
     ats/sockets/linux/src/ar_sockets.cpp
 
@@ -130,6 +130,13 @@ struct adie_rtc_multi_register_req {
         register_list[0];       /**< the list of registers to set */
 };
 
+struct adie_rtc_register_range_req {
+    uint32_t codec_handle;      /**< The codec to access */
+    uint32_t start_register_id; /**< The first register of the range */
+    uint32_t num_registers;     /**< The number of consecutive register ids */
+    uint32_t register_mask;     /**< The bit-mask applied to every register */
+};
+
 struct adie_rtc_version
 {
     /**< Major version for changes that break backward compatibility */
@@ -210,9 +217,10 @@ int32_t adie_rtc_set_register(struct adie_rtc_register_req *req);
 
 /**
 * \brief
-*		Get data for multiple registers from the specified codec.
+*		Set data to multiple registers for the specified codec. The
+*       registers are written in list order.
 *
-* \params[in/out] req: The registers to get data for
+* \params[in/out] req: The registers to set data for
 * \params[in] size: The size of the request structure in bytes
 *
 * \return 0 on success, non-zero otherwise
@@ -221,15 +229,46 @@ int32_t adie_rtc_set_multiple_registers(struct adie_rtc_multi_register_req *req,
 
 /**
 * \brief
-*		Set data to multiple registers for the specified codec.
+*		Get data for multiple registers from the specified codec. All
+*       values are taken from a single read of the codec register map.
 *
-* \params[in/out] req: The registers to set data for
+* \params[in/out] req: The registers to get data for
 * \params[in] size: The size of the request structure in bytes
 *
 * \return 0 on success, non-zero otherwise
 */
 int32_t adie_rtc_get_multiple_registers(struct adie_rtc_multi_register_req *req, uint32_t size);
 
+/**
+* \brief
+*		Get data for every register the codec exposes within a range of
+*       register ids. Ids the codec does not map are skipped, so the
+*       response may hold fewer registers than the range spans. The
+*       response can be passed to adie_rtc_set_multiple_registers as is.
+*
+* \params[in] req: The range of registers to get data for
+* \params[out] rsp: The registers found in the range, in ascending order
+* \params[in] rsp_size: The size of the response buffer in bytes
+*
+* \return 0 on success, AR_ENEEDMORE if the response buffer is too small,
+*         non-zero otherwise
+*/
+int32_t adie_rtc_get_register_range(struct adie_rtc_register_range_req *req,
+    struct adie_rtc_multi_register_req *rsp, uint32_t rsp_size);
+
+/**
+* \brief
+*		Set data to consecutive registers of the specified codec, starting
+*       at adie_rtc_register_range_req::start_register_id.
+*
+* \params[in] req: The range of registers to set data to
+* \params[in] values: One value per register in the range
+*
+* \return 0 on success, non-zero otherwise
+*/
+int32_t adie_rtc_set_register_range(struct adie_rtc_register_range_req *req,
+    uint32_t *values);
+
 #ifdef __cplusplus
 }
 #endif
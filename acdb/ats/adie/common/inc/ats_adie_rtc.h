@@ -23,33 +23,13 @@
 * Defines and Constants
 *----------------------------------------------------------------------------*/
 #define ATS_ADIE_RTC_MAJOR_VERSION 0x1
-#define ATS_ADIE_RTC_MINOR_VERSION 0x2
+#define ATS_ADIE_RTC_MINOR_VERSION 0x3
 
 //const char* LOG_TAG = "ATS-ADIE-RTC";
 /* ---------------------------------------------------------------------------
 * Public Functions
 *-------------------------------------------------------------------------- */
 
-/**
-* \brief
-*		The Codec Realtime Calibration Service IOCTL
-* \param [in] svc_cmd_id: The command to be issued
-* \param [in] cmd_buf: Pointer to the command structure.
-* \param [in] cmd_buf_size: Size of the command structure
-* \param [out] rsp_buf: The response structre
-* \param [in] rsp_buf_size: The size of the response
-* \param [out] rsp_buf_bytes_filled: Number of bytes written to the response buffer
-* \return AR_EOK on success, non-zero otherwise
-*/
-int32_t ats_adie_rtc_ioctl(
-    uint32_t svc_cmd_id,
-    uint8_t *cmd_buf,
-    uint32_t cmd_buf_size,
-    uint8_t *rsp_buf,
-    uint32_t rsp_buf_size,
-    uint32_t *rsp_buf_bytes_filled
-);
-
 /**
 * \brief
 *		Initializes the codec realtime calibration service to
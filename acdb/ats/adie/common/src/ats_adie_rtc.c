@@ -22,11 +22,16 @@
 #include "acdb_utility.h"
 #include "ats_common.h"
 #include "adie_rtc_api.h"
+#include "ar_osal_mutex.h"
 
 /*------------------------------------------
 * Defines and Constants
 *------------------------------------------*/
 
+/**< Serializes ADIE RTC commands so a batch of register accesses is not
+ * interleaved with requests from other clients */
+static ar_osal_mutex_t ats_adie_rtc_lock;
+
 /*------------------------------------------
 * Private Functions
 *------------------------------------------*/
@@ -209,8 +214,6 @@ int32_t ats_adie_get_multiple_register(
     uint32_t rsp_buf_size,
     uint32_t *rsp_buf_bytes_filled)
 {
-    __UNREFERENCED_PARAM(cmd_buf_size);
-
     int32_t status = AR_EOK;
     uint32_t min_req_size =
         sizeof(struct adie_rtc_multi_register_req);
@@ -229,6 +232,23 @@ int32_t ats_adie_get_multiple_register(
 
     req = (struct adie_rtc_multi_register_req*)cmd_buf;
 
+    if (req->num_registers > (cmd_buf_size - min_req_size)
+        / sizeof(struct adie_rtc_register))
+    {
+        ATS_ERR("Error[%d]: %d registers do not fit in a %d byte request",
+            AR_EBADPARAM, req->num_registers, cmd_buf_size);
+        return AR_EBADPARAM;
+    }
+
+    if (rsp_buf_size < req->num_registers * sizeof(uint32_t))
+    {
+        ATS_ERR("Error[%d]: Not enough memory to copy response. "
+            "The memory avalible is %d bytes and the size needed is %d bytes",
+            AR_ENEEDMORE, rsp_buf_size,
+            (uint32_t)(req->num_registers * sizeof(uint32_t)));
+        return AR_ENEEDMORE;
+    }
+
     req_size = sizeof(struct adie_rtc_multi_register_req)
         + req->num_registers * sizeof(struct adie_rtc_register);
     status = adie_rtc_get_multiple_registers(req, req_size);
@@ -241,13 +261,6 @@ int32_t ats_adie_get_multiple_register(
 
     *rsp_buf_bytes_filled = req->num_registers * sizeof(uint32_t);
 
-    if (rsp_buf_size < *rsp_buf_bytes_filled)
-    {
-        ATS_ERR("Error[%d]: Not enough memory to copy response. "
-            "The memory avalible is %d bytes and the size needed is &d bytes",
-            AR_ENEEDMORE, rsp_buf_size, *rsp_buf_bytes_filled);
-    }
-
     reg_values = (uint32_t*)rsp_buf;
     codec_reg = (struct adie_rtc_register*)(req->register_list);
 
@@ -307,7 +320,6 @@ int32_t ats_adie_set_multiple_register(
     uint32_t rsp_buf_size,
     uint32_t *rsp_buf_bytes_filled)
 {
-    __UNREFERENCED_PARAM(cmd_buf_size);
     __UNREFERENCED_PARAM(rsp_buf);
     __UNREFERENCED_PARAM(rsp_buf_size);
 
@@ -327,6 +339,14 @@ int32_t ats_adie_set_multiple_register(
 
     req = (struct adie_rtc_multi_register_req*)cmd_buf;
 
+    if (req->num_registers > (cmd_buf_size - min_req_size)
+        / sizeof(struct adie_rtc_register))
+    {
+        ATS_ERR("Error[%d]: %d registers do not fit in a %d byte request",
+            AR_EBADPARAM, req->num_registers, cmd_buf_size);
+        return AR_EBADPARAM;
+    }
+
     req_size = sizeof(struct adie_rtc_multi_register_req)
         + req->num_registers * sizeof(struct adie_rtc_register);
     status = adie_rtc_set_multiple_registers(req, req_size);
@@ -340,64 +360,148 @@ int32_t ats_adie_set_multiple_register(
     return status;
 }
 
+int32_t ats_adie_get_register_range(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    uint8_t *rsp_buf,
+    uint32_t rsp_buf_size,
+    uint32_t *rsp_buf_bytes_filled)
+{
+    int32_t status = AR_EOK;
+    struct adie_rtc_register_range_req req = { 0 };
+    struct adie_rtc_multi_register_req *rsp = NULL;
+
+    if (IsNull(cmd_buf) || IsNull(rsp_buf) ||
+        cmd_buf_size < sizeof(struct adie_rtc_register_range_req) ||
+        rsp_buf_size < sizeof(struct adie_rtc_multi_register_req))
+    {
+        ATS_ERR("Error[%d]: Invalid input parameter(s)", AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
 
-/*------------------------------------------
-* Public Functions
-*------------------------------------------*/
+    *rsp_buf_bytes_filled = 0;
+
+    ACDB_MEM_CPY_SAFE(
+        &req, sizeof(struct adie_rtc_register_range_req),
+        cmd_buf, sizeof(struct adie_rtc_register_range_req));
+
+    rsp = (struct adie_rtc_multi_register_req*)rsp_buf;
+    status = adie_rtc_get_register_range(&req, rsp, rsp_buf_size);
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to get register range. "
+            "Handle(0x%x) Start(0x%x) Count(%d)",
+            status, req.codec_handle,
+            req.start_register_id, req.num_registers);
+        return status;
+    }
 
-int32_t ats_adie_rtc_ioctl(
-    uint32_t svc_cmd_id,
+    *rsp_buf_bytes_filled = sizeof(struct adie_rtc_multi_register_req)
+        + rsp->num_registers * sizeof(struct adie_rtc_register);
+
+    return status;
+}
+
+int32_t ats_adie_set_register_range(
     uint8_t *cmd_buf,
     uint32_t cmd_buf_size,
     uint8_t *rsp_buf,
     uint32_t rsp_buf_size,
-    uint32_t *rsp_buf_bytes_filled
-)
+    uint32_t *rsp_buf_bytes_filled)
 {
+    __UNREFERENCED_PARAM(rsp_buf);
+    __UNREFERENCED_PARAM(rsp_buf_size);
+
     int32_t status = AR_EOK;
+    uint32_t min_req_size =
+        sizeof(struct adie_rtc_register_range_req);
+    struct adie_rtc_register_range_req *req = NULL;
+    uint32_t *values = NULL;
+
+    if (IsNull(cmd_buf) || cmd_buf_size < min_req_size)
+    {
+        ATS_ERR("Error[%d]: Invalid input parameter(s)", AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    *rsp_buf_bytes_filled = 0;
 
-    int32_t(*func_cb)(
-        uint8_t *cmd_buf,
-        uint32_t cmd_buf_size,
-        uint8_t *rsp_buf,
-        uint32_t rsp_buf_size,
-        uint32_t *rsp_buf_bytes_filled
-        ) = NULL;
+    req = (struct adie_rtc_register_range_req*)cmd_buf;
+    values = (uint32_t*)(cmd_buf + min_req_size);
 
-    switch (svc_cmd_id)
+    if (req->num_registers > (cmd_buf_size - min_req_size)
+        / sizeof(uint32_t))
     {
-    case ATS_CMD_ADIE_GET_CODEC_INFO:
-        func_cb = ats_adie_get_codec_info;
-        break;
-    case ATS_CMD_ADIE_GET_REGISTER:
-        func_cb = ats_adie_get_register;
-        break;
-    case ATS_CMD_ADIE_GET_MULTIPLE_REGISTER:
-        func_cb = ats_adie_get_multiple_register;
-        break;
-    case ATS_CMD_ADIE_SET_REGISTER:
-        func_cb = ats_adie_set_register;
-        break;
-    case ATS_CMD_ADIE_SET_MULTIPLE_REGISTER:
-        func_cb = ats_adie_set_multiple_register;
-        break;
-    default:
-        ATS_ERR("Command[%x] is not supported", svc_cmd_id);
-        status = AR_EUNSUPPORTED;
+        ATS_ERR("Error[%d]: %d register values do not fit in a %d byte request",
+            AR_EBADPARAM, req->num_registers, cmd_buf_size);
+        return AR_EBADPARAM;
     }
 
-    if (status == AR_EOK)
+    status = adie_rtc_set_register_range(req, values);
+    if (AR_FAILED(status))
     {
-        status = func_cb(cmd_buf,
-            cmd_buf_size,
-            rsp_buf,
-            rsp_buf_size,
-            rsp_buf_bytes_filled);
+        ATS_ERR("Error[%d]: Failed to set register range. "
+            "Handle(0x%x) Start(0x%x) Count(%d)",
+            status, req->codec_handle,
+            req->start_register_id, req->num_registers);
+        return status;
     }
 
     return status;
 }
 
+static int32_t ats_adie_lock(void)
+{
+    return ar_osal_mutex_lock(ats_adie_rtc_lock);
+}
+
+static int32_t ats_adie_unlock(void)
+{
+    return ar_osal_mutex_unlock(ats_adie_rtc_lock);
+}
+
+#define ATS_ADIE_CMD(cmd) ATS_GET_COMMAND_ID(ATS_CMD_ADIE_##cmd)
+#define ATS_ADIE_CMD_LAST ATS_ADIE_CMD(SET_REGISTER_RANGE)
+
+/**< The ADIE Realtime Calibration commands, all run under the service lock */
+static const AtsCmdEntry ats_adie_cmds[ATS_ADIE_CMD_LAST + 1] = {
+    [ATS_ADIE_CMD(GET_CODEC_INFO)] = {
+        ats_adie_get_codec_info, 0, ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ADIE_CMD(GET_REGISTER)] = {
+        ats_adie_get_register,
+        sizeof(struct adie_rtc_register_req) - sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_ADIE_CMD(GET_MULTIPLE_REGISTER)] = {
+        ats_adie_get_multiple_register,
+        sizeof(struct adie_rtc_multi_register_req),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ADIE_CMD(SET_REGISTER)] = {
+        ats_adie_set_register, sizeof(struct adie_rtc_register_req),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ADIE_CMD(SET_MULTIPLE_REGISTER)] = {
+        ats_adie_set_multiple_register,
+        sizeof(struct adie_rtc_multi_register_req),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ADIE_CMD(GET_REGISTER_RANGE)] = {
+        ats_adie_get_register_range,
+        sizeof(struct adie_rtc_register_range_req), ATS_CMD_SIZE_UNBOUNDED,
+        sizeof(struct adie_rtc_multi_register_req), 0 },
+    [ATS_ADIE_CMD(SET_REGISTER_RANGE)] = {
+        ats_adie_set_register_range,
+        sizeof(struct adie_rtc_register_range_req),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+};
+
+static const AtsCmdTable ats_adie_cmd_table = {
+    ats_adie_cmds,
+    sizeof(ats_adie_cmds) / sizeof(ats_adie_cmds[0]),
+    ats_adie_lock,
+    ats_adie_unlock
+};
+
+/*------------------------------------------
+* Public Functions
+*------------------------------------------*/
 
 int32_t ats_adie_rtc_init(void)
 {
@@ -412,11 +516,23 @@ int32_t ats_adie_rtc_init(void)
         return status;
     }
 
-    status = ats_register_service(ATS_CODEC_RTC_SERVICE_ID, ats_adie_rtc_ioctl);
+    status = ar_osal_mutex_create(&ats_adie_rtc_lock);
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to create lock.", status);
+        adie_rtc_deinit();
+        return status;
+    }
+
+    status = ats_register_service_table(ATS_CODEC_RTC_SERVICE_ID,
+        &ats_adie_cmd_table);
 
     if (AR_FAILED(status))
     {
         ATS_ERR("Failed to register the ADIE Realtime Calibration Service.", status);
+        ar_osal_mutex_destroy(ats_adie_rtc_lock);
+        ats_adie_rtc_lock = NULL;
+        adie_rtc_deinit();
     }
 
     return status;
@@ -435,6 +551,12 @@ int32_t ats_adie_rtc_deinit(void)
         ATS_ERR("Failed to deregister the ADIE Realtime Calibration Service.", status);
     }
 
+    if (!IsNull(ats_adie_rtc_lock))
+    {
+        ar_osal_mutex_destroy(ats_adie_rtc_lock);
+        ats_adie_rtc_lock = NULL;
+    }
+
     status = adie_rtc_deinit();
     if (AR_FAILED(status))
     {
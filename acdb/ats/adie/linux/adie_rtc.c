@@ -104,6 +104,8 @@ static int lnx_to_ar(int lx_err)
             return AR_ENORESOURCE;
         case -ENOMEM:
             return AR_ENOMEMORY;
+        case -ENOSPC:
+            return AR_ENEEDMORE;
         case 0:
             return AR_EOK;
         default:
@@ -569,6 +571,324 @@ done:
     return rc;
 }
 
+enum {
+    CODEC_REG_BUS,  /* registers behind the codec regmap */
+    I2C_REG_BUS,    /* WCD939X registers behind the I2C regmap */
+    NUM_REG_BUSES,
+};
+
+struct codec_reg_entry {
+    uint32_t    address;
+    uint32_t    value;
+};
+
+/* A register dump of one regmap, sorted by address */
+struct codec_reg_map {
+    struct codec_reg_entry *entries;
+    uint32_t    count;
+};
+
+/*
+ * State of a batched register access. Each register file is read or opened
+ * at most once per batch, however many registers go through it.
+ */
+struct codec_reg_batch {
+    int32_t     codec_idx;
+    struct codec_reg_map map[NUM_REG_BUSES];
+    int         reg_fd;
+    int         address_fd[NUM_REG_BUSES];
+    int         data_fd[NUM_REG_BUSES];
+};
+
+static int get_reg_bus(int32_t codec_idx, uint32_t regAddr)
+{
+    if (codec_info[codec_idx].chipset_id == WCD939X && IS_I2C_REG(regAddr))
+        return I2C_REG_BUS;
+    return CODEC_REG_BUS;
+}
+
+static const char *get_reg_bus_path(int32_t codec_idx, int bus, int path_id)
+{
+    if (bus == I2C_REG_BUS) {
+        if (path_id == ADDRESS_PATH)
+            return wcd939x_i2c_info.address_path;
+        if (path_id == DATA_PATH)
+            return wcd939x_i2c_info.data_path;
+        return wcd939x_i2c_info.reg_path;
+    }
+
+    if (path_id == ADDRESS_PATH)
+        return codec_info[codec_idx].address_path;
+    if (path_id == DATA_PATH)
+        return codec_info[codec_idx].data_path;
+    return codec_info[codec_idx].reg_path;
+}
+
+static int compare_codec_reg(const void *a, const void *b)
+{
+    uint32_t addr_a = ((const struct codec_reg_entry *)a)->address;
+    uint32_t addr_b = ((const struct codec_reg_entry *)b)->address;
+
+    return (addr_a > addr_b) - (addr_a < addr_b);
+}
+
+static int load_codec_reg_map(struct codec_reg_batch *batch, int bus)
+{
+    struct codec_reg_map *map = &batch->map[bus];
+    const char *path = get_reg_bus_path(batch->codec_idx, bus, REG_PATH);
+    char_t *buf = NULL;
+    char_t *line, *end;
+    int32_t buf_size = 0, i;
+    uint32_t max_entries = 1, address, value;
+    int fd, sorted = 1, ret = 0;
+
+    if (strlen(path) == 0) {
+        AR_LOG_ERR(LOG_TAG, "%s: register path is empty for bus %d\n", __func__, bus);
+        return -EINVAL;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        AR_LOG_ERR(LOG_TAG, "cannot open adie peek error: %d, path: %s", fd, path);
+        return -EINVAL;
+    }
+    ret = parse_codec_reg_file(&buf, &buf_size, fd, batch->codec_idx);
+    close(fd);
+    if (ret < 0 || buf == NULL || buf_size <= 0) {
+        AR_LOG_ERR(LOG_TAG, "cannot read registers, size %d, path: %s", buf_size, path);
+        ret = -EINVAL;
+        goto done;
+    }
+    /* parse_codec_reg_file always leaves READ_STEP_SIZE spare bytes */
+    buf[buf_size] = '\0';
+
+    for (i = 0; i < buf_size; i++)
+        if (buf[i] == '\n')
+            max_entries++;
+
+    map->entries = calloc(max_entries, sizeof(struct codec_reg_entry));
+    if (!map->entries) {
+        ret = -ENOMEM;
+        AR_LOG_ERR(LOG_TAG, "cannot allocate %d register entries", max_entries);
+        goto done;
+    }
+
+    /* each line is "<address>: <value>" in hex */
+    for (line = buf; line != NULL && *line != '\0'; line = end) {
+        address = strtoul(line, &end, 16);
+        if (end != line && *end == ':') {
+            line = end + 1;
+            value = strtoul(line, &end, 16);
+            if (end != line && map->count < max_entries) {
+                if (address >= CDC_REG_DIG_BASE_READ)
+                    address -= CDC_REG_DIG_OFFSET;
+                if (map->count && address < map->entries[map->count - 1].address)
+                    sorted = 0;
+                map->entries[map->count].address = address;
+                map->entries[map->count].value = value;
+                map->count++;
+            }
+        }
+        end = strchr(end, '\n');
+        if (end)
+            end++;
+    }
+
+    if (map->count == 0) {
+        AR_LOG_ERR(LOG_TAG, "no registers found in %s", path);
+        ret = -EINVAL;
+        goto done;
+    }
+    if (!sorted)
+        qsort(map->entries, map->count, sizeof(struct codec_reg_entry),
+                compare_codec_reg);
+    AR_LOG_DEBUG(LOG_TAG, "%s: %d registers read from %s\n", __func__, map->count, path);
+
+ done:
+    free(buf);
+    if (ret) {
+        free(map->entries);
+        map->entries = NULL;
+        map->count = 0;
+    }
+    return ret;
+}
+
+static int begin_codec_reg_batch(struct codec_reg_batch *batch, uint32_t handle)
+{
+    int bus;
+
+    memset(batch, 0, sizeof(*batch));
+    batch->reg_fd = -1;
+    for (bus = 0; bus < NUM_REG_BUSES; bus++) {
+        batch->address_fd[bus] = -1;
+        batch->data_fd[bus] = -1;
+    }
+
+    batch->codec_idx = find_codec_index(handle);
+    if (batch->codec_idx < 0) {
+        AR_LOG_ERR(LOG_TAG, "could not find codec index for handle %d", handle);
+        return -EINVAL;
+    } else if (strlen(codec_info[batch->codec_idx].reg_path) == 0) {
+        AR_LOG_ERR(LOG_TAG, "codec path is empty %d", handle);
+        return -EINVAL;
+    }
+    return 0;
+}
+
+static void end_codec_reg_batch(struct codec_reg_batch *batch)
+{
+    int bus;
+
+    for (bus = 0; bus < NUM_REG_BUSES; bus++) {
+        free(batch->map[bus].entries);
+        if (batch->address_fd[bus] >= 0)
+            close(batch->address_fd[bus]);
+        if (batch->data_fd[bus] >= 0)
+            close(batch->data_fd[bus]);
+    }
+    if (batch->reg_fd >= 0)
+        close(batch->reg_fd);
+}
+
+static int batch_get_register(struct codec_reg_batch *batch, struct adie_rtc_register *reg)
+{
+    int bus = get_reg_bus(batch->codec_idx, reg->register_id);
+    struct codec_reg_entry key = { reg->register_id, 0 };
+    struct codec_reg_entry *entry;
+    int ret;
+
+    if (batch->map[bus].entries == NULL) {
+        ret = load_codec_reg_map(batch, bus);
+        if (ret)
+            return ret;
+    }
+
+    entry = bsearch(&key, batch->map[bus].entries, batch->map[bus].count,
+            sizeof(struct codec_reg_entry), compare_codec_reg);
+    if (!entry) {
+        AR_LOG_ERR(LOG_TAG, "%s: reg[%08x] is not found\n", __func__, reg->register_id);
+        return -EINVAL;
+    }
+    /* return a masked value */
+    reg->value = entry->value & reg->register_mask;
+    return 0;
+}
+
+static int batch_get_register_range(struct codec_reg_batch *batch, int bus,
+        uint32_t first, uint32_t last, uint32_t mask,
+        struct adie_rtc_multi_register_req *rsp, uint32_t max_registers)
+{
+    struct codec_reg_map *map = &batch->map[bus];
+    struct adie_rtc_register *reg;
+    uint32_t lo = 0, hi, mid;
+    int ret;
+
+    if (map->entries == NULL) {
+        ret = load_codec_reg_map(batch, bus);
+        if (ret)
+            return ret;
+    }
+
+    /* find the first register at or above the start of the range */
+    hi = map->count;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (map->entries[mid].address < first)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for (; lo < map->count && map->entries[lo].address <= last; lo++) {
+        if (rsp->num_registers >= max_registers) {
+            AR_LOG_ERR(LOG_TAG, "%s: no room for more than %d registers\n",
+                    __func__, max_registers);
+            return -ENOSPC;
+        }
+        reg = &rsp->register_list[rsp->num_registers++];
+        reg->register_id = map->entries[lo].address;
+        reg->register_mask = mask;
+        reg->value = map->entries[lo].value & mask;
+    }
+    return 0;
+}
+
+static int open_batch_fd(int *fd, const char *path)
+{
+    if (*fd >= 0)
+        return 0;
+
+    if (strlen(path) == 0) {
+        AR_LOG_ERR(LOG_TAG, "%s: register path is empty\n", __func__);
+        return -EINVAL;
+    }
+    *fd = open(path, O_RDWR);
+    if (*fd < 0) {
+        AR_LOG_ERR(LOG_TAG, "ERROR! cannot open adie poke error: %d, path: %s",
+                *fd, path);
+        return -EINVAL;
+    }
+    return 0;
+}
+
+/*
+ * The debugfs write handlers parse their input from the file position, so
+ * every write on a reused descriptor starts at offset 0.
+ */
+static int write_batch_fd(int fd, const char *buf, int len)
+{
+    if (len <= 0 || pwrite(fd, buf, len, 0) != len)
+        return -EINVAL;
+    return 0;
+}
+
+static int batch_set_register(struct codec_reg_batch *batch, uint32_t regAddr,
+        uint32_t ulRegValue)
+{
+    int32_t codec_idx = batch->codec_idx;
+    char buf[32];
+    int len, ret;
+    /* the bus is picked by the address before the digital offset is added */
+    int bus = get_reg_bus(codec_idx, regAddr);
+
+    if (regAddr >= CDC_REG_DIG_BASE_WRITE)
+        regAddr += CDC_REG_DIG_OFFSET;
+
+    if (codec_info[codec_idx].is_address_data_paths_available) {
+        ret = open_batch_fd(&batch->address_fd[bus],
+                get_reg_bus_path(codec_idx, bus, ADDRESS_PATH));
+        if (ret)
+            return ret;
+        ret = open_batch_fd(&batch->data_fd[bus],
+                get_reg_bus_path(codec_idx, bus, DATA_PATH));
+        if (ret)
+            return ret;
+
+        len = snprintf(buf, sizeof(buf), "0x%x", regAddr);
+        ret = write_batch_fd(batch->address_fd[bus], buf, len);
+        if (ret == 0) {
+            len = snprintf(buf, sizeof(buf), "0x%x", ulRegValue);
+            ret = write_batch_fd(batch->data_fd[bus], buf, len);
+        }
+    } else {
+        ret = open_batch_fd(&batch->reg_fd, codec_info[codec_idx].reg_path);
+        if (ret)
+            return ret;
+
+        len = snprintf(buf, sizeof(buf), "0x%x 0x%x", regAddr, ulRegValue);
+        ret = write_batch_fd(batch->reg_fd, buf, len);
+    }
+
+    if (ret) {
+        AR_LOG_ERR(LOG_TAG, "set adie register failed for Register[0x%X]", regAddr);
+        return ret;
+    }
+    AR_LOG_DEBUG(LOG_TAG, "reg[%08X],val[%08X] set\n", regAddr, ulRegValue);
+    usleep(30);
+    return 0;
+}
+
 int32_t adie_rtc_get_api_version(struct adie_rtc_version *api_version)
 {
     if (!api_version)
@@ -982,235 +1302,103 @@ int32_t adie_rtc_set_register(struct adie_rtc_register_req *req)
 
 int32_t adie_rtc_set_multiple_registers(struct adie_rtc_multi_register_req *req, uint32_t size)
 {
-    struct adie_rtc_register_req  sreq;
-    uint32_t i = 0, regAddr = 0, regMask = 0;
-    size_t numBytes1 = 0;
-    size_t numBytes2 = 0;
-    uint32_t ulRegValue = 0;
-    char *temp = NULL;
+    struct codec_reg_batch batch;
+    struct adie_rtc_register *reg;
+    uint32_t i = 0;
     int32_t result = 0;
-    uint32_t handle;
-    int32_t codec_idx = 0;
-    int fd = -1;
-
-    if (!req || (size == 0))
-        return lnx_to_ar(-EINVAL);
 
-    if (req->num_registers == 0)
+    if (!req || size < sizeof(*req) || req->num_registers == 0 ||
+        req->num_registers > (size - sizeof(*req)) / sizeof(*reg))
         return lnx_to_ar(-EINVAL);
 
-    handle = req->codec_handle;
-    codec_idx = find_codec_index(handle);
-    if (codec_idx < 0) {
-        AR_LOG_ERR(LOG_TAG, "could not find codec index for handle %d",
-                handle);
-        result = -EINVAL;
-        goto done;
-    } else if (strlen(codec_info[codec_idx].reg_path) == 0) {
-        AR_LOG_ERR(LOG_TAG, "codec path is empty %d", handle);
-        result = -EINVAL;
-        goto done;
+    result = begin_codec_reg_batch(&batch, req->codec_handle);
+    for (i = 0; result == 0 && i < req->num_registers; ++i) {
+        reg = &req->register_list[i];
+        result = batch_set_register(&batch, reg->register_id,
+                reg->value & reg->register_mask);
     }
-    for (i = 0; i < req->num_registers; ++i) {
-        temp = NULL;
-        regAddr = req->register_list[i].register_id;
-        regMask = req->register_list[i].register_mask;
-        ulRegValue = req->register_list[i].value;
-        ulRegValue &= regMask;
-
-        if (regAddr >= CDC_REG_DIG_BASE_WRITE)
-            regAddr += CDC_REG_DIG_OFFSET;
+    end_codec_reg_batch(&batch);
 
+    return lnx_to_ar(result);
+}
 
-        if (codec_info->is_address_data_paths_available) {
-            result = _adie_rtc_set_register(codec_idx, regAddr, ulRegValue);
-            if (result)
-                goto done;
-        } else {
-            numBytes1 = asprintf(&temp, "0x%x 0x%x", regAddr, ulRegValue);
+int32_t adie_rtc_get_multiple_registers(struct adie_rtc_multi_register_req *req, uint32_t size)
+{
+    struct codec_reg_batch batch;
+    struct adie_rtc_register *reg;
+    uint32_t i = 0;
+    int32_t result = 0;
 
-            fd = open(codec_info[codec_idx].reg_path, O_RDWR);
-            if (fd < 0) {
-                AR_LOG_ERR(LOG_TAG, "ERROR! cannot open adie poke error: %d, path: %s",
-                        fd, codec_info[codec_idx].reg_path);
-                result = -EINVAL;
-                if (temp != NULL) {
-                    free(temp);
-                    temp = NULL;
-                }
-                goto done;
-            }
-            numBytes2 = write(fd, temp, numBytes1);
-            if (temp != NULL) {
-                free(temp);
-                temp = NULL;
-            }
-            close(fd);
+    if (!req || size < sizeof(*req) || req->num_registers == 0 ||
+        req->num_registers > (size - sizeof(*req)) / sizeof(*reg))
+        return lnx_to_ar(-EINVAL);
 
-            if (numBytes1 != numBytes2) {
-                AR_LOG_ERR(LOG_TAG, "set multi registers failed, numBytes1[%zu], numBytes2[%zu]",
-                        numBytes1, numBytes2);
-                result = -EINVAL;
-                goto done;
-            }
-        }
-        usleep(30);
+    result = begin_codec_reg_batch(&batch, req->codec_handle);
+    for (i = 0; result == 0 && i < req->num_registers; ++i) {
+        reg = &req->register_list[i];
+        result = batch_get_register(&batch, reg);
+        AR_LOG_DEBUG(LOG_TAG, "reg[%08X],val[%08X], count[%d]\n",
+                reg->register_id, reg->value, i + 1);
     }
+    end_codec_reg_batch(&batch);
 
-done:
     return lnx_to_ar(result);
 }
 
-int32_t adie_rtc_get_multiple_registers(struct adie_rtc_multi_register_req *req, uint32_t size)
+int32_t adie_rtc_get_register_range(struct adie_rtc_register_range_req *req,
+    struct adie_rtc_multi_register_req *rsp, uint32_t rsp_size)
 {
-    struct adie_rtc_register_req  sreq;
-    uint32_t i = 0;
-    uint32_t handle;
-    int32_t codec_idx = 0;
-    int fd = -1;
-    int result = -EINVAL;
-    int found = 0;
-    uint32_t ultempRegAddr = 0;
-    int32_t lRegValue = 0;
-    char_t *rtc_io_buf_base = NULL;
-    char_t *rtc_io_buf = NULL;
-    int32_t rtc_io_buf_size = 0;
-    size_t numBytes = 0;
-    uint32_t regAddr, regMask;
-    char_t reg[5], val[3];
-    char *save;
-    char *token;
-    int reg_len;
-    uint32_t count = 0;
-    uint32_t offset = 0;
+    struct codec_reg_batch batch;
+    uint32_t first, last, i2c_last;
+    uint32_t max_registers;
+    int32_t result = 0;
 
-    if (!req || (size == 0))
+    if (!req || !rsp || rsp_size < sizeof(*rsp) || req->num_registers == 0 ||
+        req->num_registers - 1 > UINT32_MAX - req->start_register_id)
         return lnx_to_ar(-EINVAL);
 
-    if (req->num_registers == 0)
-        return lnx_to_ar(-EINVAL);
+    first = req->start_register_id;
+    last = first + (req->num_registers - 1);
+    max_registers = (rsp_size - sizeof(*rsp)) / sizeof(struct adie_rtc_register);
+    rsp->codec_handle = req->codec_handle;
+    rsp->num_registers = 0;
 
-    handle = req->codec_handle;
-    codec_idx = find_codec_index(handle);
-    if (codec_idx < 0) {
-        AR_LOG_ERR(LOG_TAG, "could not find codec index for handle %d",
-                handle);
-        goto done;
-    } else if (strlen(codec_info[codec_idx].reg_path) == 0) {
-        AR_LOG_ERR(LOG_TAG, "codec path is empty %d", handle);
-        goto done;
-    }
-    regAddr = req->register_list[0].register_id; //read first reg
-    if (codec_info[codec_idx].chipset_id == WCD939X) {
-        if (IS_I2C_REG(regAddr)) {
-           if (strlen(wcd939x_i2c_info.reg_path) == 0) {
-               result = -EINVAL;
-               AR_LOG_ERR(LOG_TAG,"codec (i2c reg) path is empty\n %d", handle);
-               goto done;
-           }
-           fd = open(wcd939x_i2c_info.reg_path, O_RDWR);
-        } else {
-            fd = open(codec_info[codec_idx].reg_path, O_RDWR);
-        }
-    } else {
-        fd = open(codec_info[codec_idx].reg_path, O_RDWR);
-    }
-    if(fd < 0)
-    {
-        result = -EINVAL;
-        AR_LOG_ERR(LOG_TAG,"cannot open adie peek error: %d, path: %s",
-                fd, codec_info[codec_idx].reg_path);
-        goto done;
-    }
-    result = parse_codec_reg_file(&rtc_io_buf_base, &rtc_io_buf_size, fd, codec_idx);
-    if (rtc_io_buf_base == NULL || result < 0)
-    {
-        result = -EINVAL;
-        AR_LOG_ERR(LOG_TAG,"cannot allocate memory: %d, path: %s",
-                READ_STEP_SIZE, codec_info[codec_idx].reg_path);
-        goto close_fd;
-    }
-    if (rtc_io_buf_size <= 0)
-    {
-        result = -EINVAL;
-        AR_LOG_ERR(LOG_TAG,"length of written bytes does not match expected value %d", rtc_io_buf_size);
-        goto close_fd;
-    }
-    numBytes = rtc_io_buf_size;
-    rtc_io_buf = rtc_io_buf_base;
+    result = begin_codec_reg_batch(&batch, req->codec_handle);
 
-    reg[4] = '\0', val[2] = '\0';
-    for (i = 0; i < req->num_registers; ++i) {
-        regAddr = req->register_list[i].register_id;
-        regMask = req->register_list[i].register_mask;
-
-        found = 0;
-        offset = 0;
-        if (rtc_io_buf == NULL) {
-            AR_LOG_ERR(LOG_TAG, "rtc_io_buf is NULL");
-            result = -EINVAL;
-            goto close_fd;
-        }
-        memcpy((void*)reg, (void*)(rtc_io_buf+offset), sizeof(uint32_t));
-        token = strtok_r(reg, ":", &save);
-        if (token == NULL) {
-            AR_LOG_ERR(LOG_TAG,"%s: strtok failed to find register length : delimiter!\n", __func__);
-            result = -EINVAL;
-            goto close_fd;
-        }
-        reg_len = strlen(token);
-        if (reg_len <= 0) {
-            AR_LOG_ERR(LOG_TAG,"%s: register length is %d!\n", __func__, reg_len);
-            result = -EINVAL;
-            goto done;
-        }
-        register_length = reg_len;
-        AR_LOG_DEBUG(LOG_TAG,"%s: valid register length is %d\n", __func__, register_length);
-        while(numBytes > offset) {
-            memcpy((void*)reg, (void*)(rtc_io_buf+offset), sizeof(uint32_t));
-            offset += register_length;
-            ultempRegAddr = strtoul(reg, NULL, 16);
-            offset += 2;
-            memcpy((void*)val, (void*)(rtc_io_buf+offset), sizeof(uint16_t));
-            lRegValue = strtol(val, NULL, 16);
-            offset += 3;
-            if (ultempRegAddr >= CDC_REG_DIG_BASE_READ)
-                ultempRegAddr -= CDC_REG_DIG_OFFSET;
-
-            if(ultempRegAddr == regAddr)
-            {
-                count++;
-                found = 1;
-                /* return a masked value */
-                lRegValue &= regMask;
-                req->register_list[i].value = lRegValue;
-                usleep(30);
-                AR_LOG_DEBUG(LOG_TAG, "reg[%08X],val[%08X], count[%d]\n",
-                        ultempRegAddr, lRegValue,count);
-                break;
-            }
-        }
-    }
-    if (found == 0) {
-        AR_LOG_ERR(LOG_TAG, "GetMultipleAdieReg failed because reg[%08x] is not found\n", regAddr);
-        result = -EINVAL;
-        goto close_fd;
+    /* WCD939X I2C registers sit below the codec regmap ones */
+    if (result == 0 && get_reg_bus(batch.codec_idx, first) == I2C_REG_BUS) {
+        i2c_last = last < WCD939X_I2C_REG_MAX ? last : WCD939X_I2C_REG_MAX;
+        result = batch_get_register_range(&batch, I2C_REG_BUS, first, i2c_last,
+                req->register_mask, rsp, max_registers);
+        first = i2c_last + 1;
     }
+    if (result == 0 && first <= last)
+        result = batch_get_register_range(&batch, CODEC_REG_BUS, first, last,
+                req->register_mask, rsp, max_registers);
+    end_codec_reg_batch(&batch);
 
-    if (result == 0 && req->num_registers != count) {
-        AR_LOG_ERR(LOG_TAG, "Error in lengths of input or output buffers or total registers");
-        result = 0;
-        goto close_fd;
-    }
+    if (result == 0)
+        AR_LOG_DEBUG(LOG_TAG, "%s: %d registers in [0x%x, 0x%x]\n", __func__,
+                rsp->num_registers, req->start_register_id, last);
+    return lnx_to_ar(result);
+}
 
-close_fd:
-    if (fd != -1)
-        close(fd);
+int32_t adie_rtc_set_register_range(struct adie_rtc_register_range_req *req,
+    uint32_t *values)
+{
+    struct codec_reg_batch batch;
+    uint32_t i = 0;
+    int32_t result = 0;
 
-done:
-    if(rtc_io_buf_base)
-        free(rtc_io_buf_base);
+    if (!req || !values || req->num_registers == 0 ||
+        req->num_registers - 1 > UINT32_MAX - req->start_register_id)
+        return lnx_to_ar(-EINVAL);
+
+    result = begin_codec_reg_batch(&batch, req->codec_handle);
+    for (i = 0; result == 0 && i < req->num_registers; ++i)
+        result = batch_set_register(&batch, req->start_register_id + i,
+                values[i] & req->register_mask);
+    end_codec_reg_batch(&batch);
 
     return lnx_to_ar(result);
 }
-
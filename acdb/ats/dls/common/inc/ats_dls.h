@@ -18,40 +18,20 @@
 */
 
 #include "gsl_dls_client_intf.h"
+#include "ats_transport_api.h"
 
 #define ATS_DLS_MAJOR_VERSION 0x1
-#define ATS_DLS_MINOR_VERSION 0x0
+#define ATS_DLS_MINOR_VERSION 0x1
 
-typedef int32_t (*ATS_DSL_TCPIP_SEND_CALLBACK)(const uint8_t* buffer, uint32_t buffer_size);
-// int32_t ats_transport_dls_send_callback(const uint8_t* buffer, uint32_t buffer_size);
+/**< Sends the buffers back to back as one message, see ats_transport_dls_send_callback */
+typedef int32_t (*ATS_DSL_TCPIP_SEND_CALLBACK)(const ats_transport_buffer_t* buffers, uint32_t buffer_count);
 
 /**
-	\brief
-	The Data Logging Service IOCTL
-
-	\param [in] svc_cmd_id: The command to be issued
-	\param [in] cmd_buf: Pointer to the command structure.
-	\param [in] cmd_buf_size:
-	\param [out] rsp_buf: The response structre
-	\param [in] rsp_buf_size: The size of the response
-	\param [out] rsp_buf_bytes_filled: Number of bytes written to the response buffer
-
-	\return 0 on success, non-zero on failure
-*/
-    int32_t ats_dls_ioctl(
-	uint32_t svc_cmd_id,
-	uint8_t *cmd_buf,
-	uint32_t cmd_buf_size,
-	uint8_t *rsp_buf,
-	uint32_t rsp_buf_size,
-	uint32_t *rsp_buf_bytes_filled
-);
-
-/**
-* \brief Initializes the gsl dls client
+* \brief Initializes the gsl dls client and starts the sender thread that
+*        pushes ready log packets to the transport
 *
-* \param [in] callback: The callback function that is invoked when spf notifies
-*                       gsl about ready dls log buffers
+* \param [in] callback: The callback used by the sender thread to send
+*                       batches of log packets to the transport
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_dls_init(ATS_DSL_TCPIP_SEND_CALLBACK callback);
@@ -61,7 +41,7 @@ int32_t ats_dls_init(ATS_DSL_TCPIP_SEND_CALLBACK callback);
 * \brief Releases resources aquired during ats_dls_init(...). These resources
 * include:
 *	1. the dls shared memory pool
-*	2. the ats dls packet buffer for sending binary packets through the dls tcpip server
+*	2. the sender thread and its queue of log packets waiting to be sent
 *
 * \param [in] callback: The callback function that is invoked when spf notifies
 *                       gsl about ready dls log buffers
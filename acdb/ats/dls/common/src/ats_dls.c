@@ -27,6 +27,7 @@
 #include "ats_common.h"
 #include "ar_osal_mutex.h"
 #include "ar_osal_thread.h"
+#include "ar_osal_signal.h"
 #include "acdb_utility.h"
 #include "acdb_common.h"
 
@@ -38,13 +39,48 @@
 #define ATS_DEFAULT_DLS_BUFFER_SIZE 5120
 /**< The number of DLS buffers in shared memory */
 #define ATS_DEFAULT_DLS_BUFFER_COUNT 30
+/**< The number of log packets the send queue holds, about two DLS pools */
+#define ATS_DLS_SEND_QUEUE_DEPTH 64
+/**< The most log packets the sender puts in one ARTM message */
+#define ATS_DLS_MAX_SEND_BATCH 32
+#define ATS_DLS_SENDER_THREAD_STACK_SIZE 0x10000
+
+/**< Log packets waiting for the sender thread.
+ *   Slots are used as a ring. Only the buffer ready callback fills slots at
+ *   head and only the sender empties slots at tail, so both copy in and out
+ *   of their slots without holding the lock. Each slot holds a 4 byte packet
+ *   size followed by the packet, which is the layout of a log packet in an
+ *   ARTM message, so a slot is sent as is. Slots fit a DLS buffer of the
+ *   configured pool and are reallocated with buffer_ready_lock and send_lock
+ *   held when the pool is reconfigured. */
+typedef struct ats_dls_send_queue_t AtsDlsSendQueue;
+struct ats_dls_send_queue_t
+{
+	/**< Protects head, tail, count and stats */
+	ar_osal_mutex_t lock;
+	/**< Held by the sender while it sends a batch out of the slots */
+	ar_osal_mutex_t send_lock;
+	/**< Set when packets are queued or the sender has to exit */
+	ar_osal_signal_t signal;
+	ar_osal_thread_t thread;
+	volatile bool_t should_exit;
+	/**< ATS_DLS_SEND_QUEUE_DEPTH slots of slot_size bytes */
+	uint8_t *slots;
+	size_t slot_size;
+	/**< Next slot to fill */
+	uint32_t head;
+	/**< Oldest queued slot */
+	uint32_t tail;
+	/**< Number of queued slots */
+	uint32_t count;
+	AtsDlsStats stats;
+};
 
 /* The dls buffer pool configuration */
 struct gsl_dls_buffer_pool_config_t buffer_pool_config;
-//buffer that stores binary log packets before sending to tcpip dls server
-AtsBuffer dls_data_send_buffer;
 ar_osal_mutex_t buffer_ready_lock;
 ATS_DSL_TCPIP_SEND_CALLBACK ats_dls_tcpip_send_callback;
+static AtsDlsSendQueue dls_send_queue;
 
 #if defined(_DEVICE_SIM)
 int32_t gsl_dls_client_is_feature_supported()
@@ -90,6 +126,7 @@ int32_t gsl_dls_client_register_deregister_log_code(uint32_t log_code, bool_t is
 #endif
 
 int32_t ats_dls_buffer_ready_callback(void);
+static int32_t ats_dls_resize_send_queue(uint32_t buffer_size);
 
 int32_t ats_dls_register_log_code(
 	uint8_t *cmd_buf,
@@ -155,11 +192,27 @@ int32_t ats_dls_set_buffer_config(
 	__UNREFERENCED_PARAM(rsp_buf_size);
 
 	int32_t status = AR_EOK;
+	struct gsl_dls_buffer_pool_config_t config;
 
 	if (cmd_buf_size < sizeof(struct gsl_dls_buffer_pool_config_t))
 		return AR_EBADPARAM;
 
-	ATS_MEM_CPY_SAFE(&buffer_pool_config, cmd_buf_size, cmd_buf, cmd_buf_size);
+	ATS_MEM_CPY_SAFE(&config, sizeof(struct gsl_dls_buffer_pool_config_t),
+		cmd_buf, sizeof(struct gsl_dls_buffer_pool_config_t));
+
+	//Packets from the new pool must fit the send queue before gsl hands them out
+	ACDB_MUTEX_LOCK(buffer_ready_lock);
+	status = ats_dls_resize_send_queue(config.buffer_size);
+	if (AR_SUCCEEDED(status))
+		buffer_pool_config = config;
+	ACDB_MUTEX_UNLOCK(buffer_ready_lock);
+	if (AR_FAILED(status))
+	{
+		ATS_ERR("Error[%d]: Failed to resize the dls send queue for %d byte buffers",
+			status, config.buffer_size);
+		*rsp_buf_bytes_filled = 0;
+		return status;
+	}
 
 	status = gsl_dls_client_create_buffer_pool(&buffer_pool_config);
 	if(AR_FAILED(status))
@@ -277,57 +330,284 @@ int32_t ats_dls_get_log_data(
 	return status;
 }
 
-int32_t ats_dls_ioctl(
-	uint32_t svc_cmd_id,
+int32_t ats_dls_get_stats(
 	uint8_t *cmd_buf,
 	uint32_t cmd_buf_size,
 	uint8_t *rsp_buf,
 	uint32_t rsp_buf_size,
-	uint32_t *rsp_buf_bytes_filled
-)
+	uint32_t *rsp_buf_bytes_filled)
+{
+	__UNREFERENCED_PARAM(cmd_buf);
+	__UNREFERENCED_PARAM(cmd_buf_size);
+
+	AtsDlsStats stats = { 0 };
+
+	*rsp_buf_bytes_filled = 0;
+
+	if (rsp_buf_size < sizeof(AtsDlsStats))
+		return AR_EBADPARAM;
+
+	ACDB_MUTEX_LOCK(dls_send_queue.lock);
+	stats = dls_send_queue.stats;
+	stats.queue_depth = dls_send_queue.count;
+	ACDB_MUTEX_UNLOCK(dls_send_queue.lock);
+	stats.queue_capacity = ATS_DLS_SEND_QUEUE_DEPTH;
+
+	ATS_MEM_CPY_SAFE(rsp_buf, sizeof(AtsDlsStats), &stats, sizeof(AtsDlsStats));
+	*rsp_buf_bytes_filled = sizeof(AtsDlsStats);
+	return AR_EOK;
+}
+
+#define ATS_DLS_CMD(cmd) ATS_GET_COMMAND_ID(ATS_CMD_DLS_##cmd)
+#define ATS_DLS_CMD_LAST ATS_DLS_CMD(GET_STATS)
+
+/**< The Data Logging commands. Online get service returns the version of
+ * the DLS service so ATS_CMD_DLS_GET_VERSION is not handled */
+static const AtsCmdEntry ats_dls_cmds[ATS_DLS_CMD_LAST + 1] = {
+	[ATS_DLS_CMD(START)] = {
+		ats_dls_register_log_code, sizeof(uint16_t), sizeof(uint16_t), 0, 0 },
+	[ATS_DLS_CMD(STOP)] = {
+		ats_dls_deregister_log_code, sizeof(uint16_t), sizeof(uint16_t), 0, 0 },
+	[ATS_DLS_CMD(CONFIGURE)] = {
+		ats_dls_set_buffer_config, sizeof(struct gsl_dls_buffer_pool_config_t),
+		sizeof(struct gsl_dls_buffer_pool_config_t), 0, 0 },
+	[ATS_DLS_CMD(GET_LOG_DATA)] = {
+		ats_dls_get_log_data, 0, ATS_CMD_SIZE_UNBOUNDED,
+		sizeof(AtsDlsLogDataHeader), 0 },
+	[ATS_DLS_CMD(GET_STATS)] = {
+		ats_dls_get_stats, 0, ATS_CMD_SIZE_UNBOUNDED, sizeof(AtsDlsStats), 0 },
+};
+
+static const AtsCmdTable ats_dls_cmd_table = {
+	ats_dls_cmds,
+	sizeof(ats_dls_cmds) / sizeof(ats_dls_cmds[0]),
+	NULL,
+	NULL
+};
+
+/**
+* \brief
+*		Sends queued log packets to the transport, up to
+*		ATS_DLS_MAX_SEND_BATCH of them in each ARTM message, until told to
+*		exit. Slots are handed back to the queue only after the send returns,
+*		so a slow client fills the queue instead of holding DSP buffers.
+*/
+static void ats_dls_sender_thread(void *arg)
 {
+	__UNREFERENCED_PARAM(arg);
+
 	int32_t status = AR_EOK;
+	uint32_t num_packets = 0;
+	uint32_t packet_size = 0;
+	uint32_t slot = 0;
+	uint8_t *slot_ptr = NULL;
+	AtsDlsLogDataHeader header = { 0 };
+	ats_transport_buffer_t send_buffers[ATS_DLS_MAX_SEND_BATCH + 1];
 
-	int32_t(*func_cb)(
-		uint8_t *cmd_buf,
-		uint32_t cmd_buf_size,
-		uint8_t *rsp_buf,
-		uint32_t rsp_buf_size,
-		uint32_t *rsp_buf_bytes_filled
-		) = NULL;
+	header.header_id = ATS_DLS_HEADER_TAG;
+	header.header_version = ATS_DLS_HEADER_VERSION;
 
-	switch (svc_cmd_id)
+	while (!dls_send_queue.should_exit)
 	{
-	case ATS_CMD_DLS_START:
-		func_cb = ats_dls_register_log_code;
-		break;
-	case ATS_CMD_DLS_STOP:
-		func_cb = ats_dls_deregister_log_code;
-		break;
-	/*Online get service returns version of DLS service as well*/
-	/*case ATS_CMD_DLS_GET_VERSION:
-		func_cb = get_dls_version;
-		break;*/
-	case ATS_CMD_DLS_CONFIGURE:
-		func_cb = ats_dls_set_buffer_config;
-		break;
-	case ATS_CMD_DLS_GET_LOG_DATA:
-		func_cb = ats_dls_get_log_data;
-		break;
-	default:
-		ATS_ERR("Command[%x] is not supported", svc_cmd_id);
-		status = AR_EUNSUPPORTED;
-		break;
+		ar_osal_signal_wait(dls_send_queue.signal);
+		ar_osal_signal_clear(dls_send_queue.signal);
+
+		while (!dls_send_queue.should_exit)
+		{
+			ACDB_MUTEX_LOCK(dls_send_queue.send_lock);
+			ACDB_MUTEX_LOCK(dls_send_queue.lock);
+			num_packets = dls_send_queue.count;
+			slot = dls_send_queue.tail;
+			ACDB_MUTEX_UNLOCK(dls_send_queue.lock);
+
+			if (0 == num_packets)
+			{
+				ACDB_MUTEX_UNLOCK(dls_send_queue.send_lock);
+				break;
+			}
+			if (num_packets > ATS_DLS_MAX_SEND_BATCH)
+				num_packets = ATS_DLS_MAX_SEND_BATCH;
+
+			header.log_buffer_count = (uint16_t)num_packets;
+			header.total_log_data_size = 0;
+			for (uint32_t i = 0; i < num_packets; i++)
+			{
+				slot_ptr = dls_send_queue.slots +
+					(size_t)((slot + i) % ATS_DLS_SEND_QUEUE_DEPTH) * dls_send_queue.slot_size;
+				ATS_MEM_CPY_SAFE(&packet_size, sizeof(uint32_t), slot_ptr, sizeof(uint32_t));
+
+				send_buffers[i + 1].buffer = slot_ptr;
+				send_buffers[i + 1].buffer_size = sizeof(uint32_t) + packet_size;
+				header.total_log_data_size += sizeof(uint32_t) + packet_size;
+			}
+			send_buffers[0].buffer = (const uint8_t*)&header;
+			send_buffers[0].buffer_size = sizeof(AtsDlsLogDataHeader);
+
+			status = ats_dls_tcpip_send_callback(send_buffers, num_packets + 1);
+
+			ACDB_MUTEX_LOCK(dls_send_queue.lock);
+			dls_send_queue.tail = (slot + num_packets) % ATS_DLS_SEND_QUEUE_DEPTH;
+			dls_send_queue.count -= num_packets;
+			if (AR_FAILED(status))
+			{
+				dls_send_queue.stats.send_failures++;
+				dls_send_queue.stats.packets_dropped += num_packets;
+			}
+			else
+			{
+				dls_send_queue.stats.batches_sent++;
+				dls_send_queue.stats.packets_sent += num_packets;
+				dls_send_queue.stats.bytes_sent +=
+					sizeof(AtsDlsLogDataHeader) + header.total_log_data_size;
+			}
+			ACDB_MUTEX_UNLOCK(dls_send_queue.lock);
+			ACDB_MUTEX_UNLOCK(dls_send_queue.send_lock);
+		}
+	}
+}
+
+static int32_t ats_dls_start_sender(void)
+{
+	int32_t status = AR_EOK;
+	ar_osal_thread_attr_ext_t thd_attr =
+	{
+		sizeof(ar_osal_thread_attr_ext_t),
+		{ "ATS_DLS_SENDER", ATS_DLS_SENDER_THREAD_STACK_SIZE, 0 },
+		AR_OSAL_THREAD_SCHED_OTHER,
+		0,
+		ATS_THREAD_CPU_MASK
+	};
+
+	ar_mem_set(&dls_send_queue, 0, sizeof(AtsDlsSendQueue));
+	dls_send_queue.slot_size = sizeof(uint32_t) + (size_t)buffer_pool_config.buffer_size;
+	dls_send_queue.slots = ACDB_MALLOC(uint8_t,
+		ATS_DLS_SEND_QUEUE_DEPTH * dls_send_queue.slot_size);
+	if (IsNull(dls_send_queue.slots))
+	{
+		ATS_ERR("Error[%d]: Failed to allocate the dls send queue", AR_ENOMEMORY);
+		return AR_ENOMEMORY;
 	}
 
-	if (!AR_FAILED(status))
+	status = ar_osal_mutex_create(&dls_send_queue.lock);
+	if (AR_FAILED(status))
 	{
-		status = func_cb(cmd_buf, cmd_buf_size, rsp_buf, rsp_buf_size, rsp_buf_bytes_filled);
+		ATS_ERR("Error[%d]: Failed to create the dls send queue lock", status);
+		goto free_slots;
+	}
+
+	status = ar_osal_mutex_create(&dls_send_queue.send_lock);
+	if (AR_FAILED(status))
+	{
+		ATS_ERR("Error[%d]: Failed to create the dls sender lock", status);
+		goto destroy_lock;
+	}
+
+	status = ar_osal_signal_create(&dls_send_queue.signal);
+	if (AR_FAILED(status))
+	{
+		ATS_ERR("Error[%d]: Failed to create the dls send queue signal", status);
+		goto destroy_send_lock;
+	}
+
+	status = ar_osal_thread_create_ext(&dls_send_queue.thread, &thd_attr,
+		ats_dls_sender_thread, NULL);
+	if (AR_FAILED(status))
+	{
+		ATS_ERR("Error[%d]: Failed to create the dls sender thread", status);
+		goto destroy_signal;
 	}
 
 	return status;
+
+destroy_signal:
+	ar_osal_signal_destroy(dls_send_queue.signal);
+destroy_send_lock:
+	ar_osal_mutex_destroy(dls_send_queue.send_lock);
+destroy_lock:
+	ar_osal_mutex_destroy(dls_send_queue.lock);
+free_slots:
+	ACDB_FREE(dls_send_queue.slots);
+	ar_mem_set(&dls_send_queue, 0, sizeof(AtsDlsSendQueue));
+	return status;
 }
 
+/**
+* \brief
+*		Stops the sender thread and frees the send queue. The transport bounds
+*		each send with a timeout, so the join does not hang on a client that
+*		stopped reading.
+*/
+static void ats_dls_stop_sender(void)
+{
+	if (IsNull(dls_send_queue.thread))
+		return;
+
+	dls_send_queue.should_exit = TRUE;
+	ar_osal_signal_set(dls_send_queue.signal);
+	ar_osal_thread_join_destroy(dls_send_queue.thread);
+
+	ar_osal_signal_destroy(dls_send_queue.signal);
+	ar_osal_mutex_destroy(dls_send_queue.send_lock);
+	ar_osal_mutex_destroy(dls_send_queue.lock);
+	ACDB_FREE(dls_send_queue.slots);
+	ar_mem_set(&dls_send_queue, 0, sizeof(AtsDlsSendQueue));
+}
+
+/**
+* \brief
+*		Reallocates the send queue slots to fit DLS buffers of buffer_size
+*		bytes. Queued packets that fit the new slots are kept in order, the
+*		others are dropped. The caller holds buffer_ready_lock, and the sender
+*		is kept out of the slots with send_lock.
+*/
+static int32_t ats_dls_resize_send_queue(uint32_t buffer_size)
+{
+	size_t slot_size = 0;
+	uint8_t *slots = NULL;
+	uint8_t *slot_ptr = NULL;
+	uint32_t packet_size = 0;
+	uint32_t num_kept = 0;
+	uint32_t num_dropped = 0;
+
+	if (buffer_size > SIZE_MAX / ATS_DLS_SEND_QUEUE_DEPTH - sizeof(uint32_t))
+		return AR_EBADPARAM;
+
+	slot_size = sizeof(uint32_t) + (size_t)buffer_size;
+	if (slot_size == dls_send_queue.slot_size)
+		return AR_EOK;
+
+	slots = ACDB_MALLOC(uint8_t, ATS_DLS_SEND_QUEUE_DEPTH * slot_size);
+	if (IsNull(slots))
+		return AR_ENOMEMORY;
+
+	ACDB_MUTEX_LOCK(dls_send_queue.send_lock);
+	ACDB_MUTEX_LOCK(dls_send_queue.lock);
+	for (uint32_t i = 0; i < dls_send_queue.count; i++)
+	{
+		slot_ptr = dls_send_queue.slots +
+			(size_t)((dls_send_queue.tail + i) % ATS_DLS_SEND_QUEUE_DEPTH) * dls_send_queue.slot_size;
+		ATS_MEM_CPY_SAFE(&packet_size, sizeof(uint32_t), slot_ptr, sizeof(uint32_t));
+		if (packet_size > buffer_size)
+		{
+			num_dropped++;
+			continue;
+		}
+		ATS_MEM_CPY_SAFE(slots + (size_t)num_kept * slot_size, slot_size,
+			slot_ptr, sizeof(uint32_t) + packet_size);
+		num_kept++;
+	}
+	ACDB_FREE(dls_send_queue.slots);
+	dls_send_queue.slots = slots;
+	dls_send_queue.slot_size = slot_size;
+	dls_send_queue.tail = 0;
+	dls_send_queue.head = num_kept % ATS_DLS_SEND_QUEUE_DEPTH;
+	dls_send_queue.count = num_kept;
+	dls_send_queue.stats.packets_dropped += num_dropped;
+	ACDB_MUTEX_UNLOCK(dls_send_queue.lock);
+	ACDB_MUTEX_UNLOCK(dls_send_queue.send_lock);
+
+	return AR_EOK;
+}
 
 int32_t ats_dls_init(ATS_DSL_TCPIP_SEND_CALLBACK callback)
 {
@@ -351,7 +631,7 @@ int32_t ats_dls_init(ATS_DSL_TCPIP_SEND_CALLBACK callback)
 		return status;
 	}
 
-	status = ats_register_service(ATS_DLS_SERVICE_ID, ats_dls_ioctl);
+	status = ats_register_service_table(ATS_DLS_SERVICE_ID, &ats_dls_cmd_table);
 	if (AR_FAILED(status))
 	{
 		ATS_ERR("Error[%d]: Failed to register the ATS Data Logging Service.", status);
@@ -361,17 +641,23 @@ int32_t ats_dls_init(ATS_DSL_TCPIP_SEND_CALLBACK callback)
 	buffer_pool_config.buffer_size = ATS_DEFAULT_DLS_BUFFER_SIZE;
 	buffer_pool_config.buffer_count = ATS_DEFAULT_DLS_BUFFER_COUNT;
 
+	//The sender must be running before gsl reports the first ready buffers
+	ats_dls_tcpip_send_callback = callback;
+	status = ats_dls_start_sender();
+	if (AR_FAILED(status))
+	{
+		ats_deregister_service(ATS_DLS_SERVICE_ID);
+		goto destroy_lock;
+	}
+
 	status = gsl_dls_client_init(&buffer_pool_config, ats_dls_buffer_ready_callback);
 	if (AR_FAILED(status))
 	{
 		ATS_ERR("Error[%d]: Failed initialize dls client", status);
+		ats_dls_stop_sender();
+		ats_deregister_service(ATS_DLS_SERVICE_ID);
 	}
-	//allocate buffer for storing dls log buffer
 
-	dls_data_send_buffer.buffer_size = buffer_pool_config.buffer_count *buffer_pool_config.buffer_size;
-	dls_data_send_buffer.buffer = ACDB_MALLOC(uint8_t, dls_data_send_buffer.buffer_size);
-
-	ats_dls_tcpip_send_callback = callback;
 destroy_lock:
 	if(AR_FAILED(status))
 		ar_osal_mutex_destroy(buffer_ready_lock);
@@ -406,7 +692,8 @@ int32_t ats_dls_deinit(void)
 
 	ar_osal_mutex_destroy(buffer_ready_lock);
 
-	//free ats dls send buffer
+	//No more buffer ready callbacks after gsl deinit, packets still queued are dropped
+	ats_dls_stop_sender();
 
 	return status;
 }
@@ -414,21 +701,84 @@ int32_t ats_dls_deinit(void)
 int32_t ats_dls_buffer_ready_callback(void)
 {
 	int32_t status = AR_EOK;
-	uint32_t bytes_written = 0;
+	uint32_t num_free = 0;
+	uint32_t num_queued = 0;
+	uint32_t num_dropped = 0;
+	uint32_t slot = 0;
+	uint8_t *slot_ptr = NULL;
+	bool_t is_overflow = FALSE;
+	struct gsl_dls_ready_buffer_index_list_t ready_buffer_index_list;
+	struct gls_dls_buffer_t log_buffer;
 
 	ACDB_MUTEX_LOCK(buffer_ready_lock);
 
-	ar_mem_set(dls_data_send_buffer.buffer, 0, dls_data_send_buffer.buffer_size);
+	gsl_dls_client_get_ready_dls_buffer_list(&ready_buffer_index_list);
+	if (0 == ready_buffer_index_list.buffer_count)
+	{
+		ACDB_MUTEX_UNLOCK(buffer_ready_lock);
+		return status;
+	}
+
+	ACDB_MUTEX_LOCK(dls_send_queue.lock);
+	num_free = ATS_DLS_SEND_QUEUE_DEPTH - dls_send_queue.count;
+	slot = dls_send_queue.head;
+	ACDB_MUTEX_UNLOCK(dls_send_queue.lock);
 
-	status = ats_dls_get_log_data(NULL, 0,
-		dls_data_send_buffer.buffer,
-		dls_data_send_buffer.buffer_size,
-		&bytes_written);
+	/* Copy the packets into the send queue so the DSP gets its buffers
+	 * back right away, whether or not the client keeps up */
+	for (uint16_t index = 0; index < ready_buffer_index_list.buffer_count; index++)
+	{
+		status = gsl_dls_client_get_log_buffer(ready_buffer_index_list.buffer_index_list[index], &log_buffer);
+		if (AR_FAILED(status))
+		{
+			continue;
+		}
 
-	ATS_DBG("calling ats dls tcpip send callback. sending %d bytes", bytes_written);
-	ats_dls_tcpip_send_callback(dls_data_send_buffer.buffer, bytes_written);
+		if (num_queued == num_free)
+		{
+			is_overflow = TRUE;
+			num_dropped++;
+			continue;
+		}
+
+		if (log_buffer.size > dls_send_queue.slot_size - sizeof(uint32_t))
+		{
+			ATS_ERR("Error[%d]: Log packet of %d bytes does not fit a send queue slot",
+				AR_ENORESOURCE, log_buffer.size);
+			num_dropped++;
+			continue;
+		}
+
+		slot_ptr = dls_send_queue.slots + (size_t)slot * dls_send_queue.slot_size;
+		ATS_MEM_CPY_SAFE(slot_ptr, sizeof(uint32_t), &log_buffer.size, sizeof(uint32_t));
+		ATS_MEM_CPY_SAFE(slot_ptr + sizeof(uint32_t), log_buffer.size, log_buffer.buffer, log_buffer.size);
+
+		slot = (slot + 1) % ATS_DLS_SEND_QUEUE_DEPTH;
+		num_queued++;
+	}
+
+	gsl_dls_client_return_used_buffers(&ready_buffer_index_list);
+
+	ACDB_MUTEX_LOCK(dls_send_queue.lock);
+	dls_send_queue.head = slot;
+	dls_send_queue.count += num_queued;
+	if (dls_send_queue.count > dls_send_queue.stats.peak_queue_depth)
+		dls_send_queue.stats.peak_queue_depth = dls_send_queue.count;
+	dls_send_queue.stats.packets_dropped += num_dropped;
+	if (is_overflow)
+		dls_send_queue.stats.queue_overflows++;
+	ACDB_MUTEX_UNLOCK(dls_send_queue.lock);
+
+	if (is_overflow)
+	{
+		ATS_ERR("Error[%d]: dls send queue is full, dropped %d log packets",
+			AR_ENORESOURCE, num_dropped);
+	}
+
+	if (num_queued > 0)
+		ar_osal_signal_set(dls_send_queue.signal);
 
 	ACDB_MUTEX_UNLOCK(buffer_ready_lock);
 
-	return status;
+	return AR_EOK;
 }
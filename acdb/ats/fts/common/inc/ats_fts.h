@@ -21,43 +21,53 @@
 * Defines and Constants
 *----------------------------------------------------------------------------*/
 #define ATS_FTS_MAJOR_VERSION 0x1
-#define ATS_FTS_MINOR_VERSION 0x0
+#define ATS_FTS_MINOR_VERSION 0x1
 
 #define FTS_MAX_FILE_COUNT 100
 
+/**< Number of chunked transfers that can be in progress at once */
+#define FTS_MAX_TRANSFER_COUNT 4
+/**< Writes a client may have in flight on one transfer */
+#define FTS_TRANSFER_WINDOW_SIZE 16
+/**< Largest chunk, leaves room in the ATS buffer for the request header */
+#define FTS_TRANSFER_MAX_CHUNK_SIZE 0x100000
+#define FTS_TRANSFER_MAX_PATH_LENGTH 256
+/**< Suffix of the file a transfer writes to until it is committed */
+#define FTS_TRANSFER_PART_SUFFIX ".part"
+/**< A transfer that was not written to for this long is deleted by the
+ * next BEGIN_TRANSFER */
+#define FTS_TRANSFER_IDLE_TIMEOUT_US (10ull * 60 * 1000 * 1000)
+
+/**< A chunked transfer, in use while fhandle is not NULL */
+typedef struct fts_transfer_t FtsTransfer;
+struct fts_transfer_t {
+    ar_fhandle fhandle;
+    char_t file_path[FTS_TRANSFER_MAX_PATH_LENGTH];
+    uint32_t file_size;
+    uint32_t chunk_size;
+    uint32_t num_chunks;
+    uint32_t num_chunks_received;
+    /**< One bit per chunk, set once the chunk is on disk */
+    uint8_t *received_bitmap;
+    /**< The client that began or resumed the transfer, see ats_get_client_id */
+    uint32_t client_id;
+    /**< Set once that client disconnected, the slot may then be reclaimed */
+    bool_t is_orphaned;
+    /**< When the transfer was last begun or written to */
+    uint64_t last_active_us;
+};
+
 typedef struct fts_file_table_t FtsFileTable;
-#include "acdb_begin_pack.h"
 struct fts_file_table_t {
     ar_osal_mutex_t lock;
     ar_fhandle fhandle[FTS_MAX_FILE_COUNT];
-}
-#include "acdb_end_pack.h"
-;
+    FtsTransfer transfer[FTS_MAX_TRANSFER_COUNT];
+};
 
 /* ---------------------------------------------------------------------------
 * Public Functions
 *-------------------------------------------------------------------------- */
 
-/**
-* \brief
-*		The File Transfer Service IOCTL
-* \param [in] svc_cmd_id: The command to be issued
-* \param [in] cmd_buf: Pointer to the command structure.
-* \param [in] cmd_buf_size: Size of the command structure
-* \param [out] rsp_buf: The response structre
-* \param [in] rsp_buf_size: The size of the response
-* \param [out] rsp_buf_bytes_filled: Number of bytes written to the response buffer
-* \return 0 on success, non-zero on failure
-*/
-int32_t ats_fts_ioctl(
-    uint32_t svc_cmd_id,
-    uint8_t *cmd_buf,
-    uint32_t cmd_buf_size,
-    uint8_t *rsp_buf,
-    uint32_t rsp_buf_size,
-    uint32_t *rsp_buf_bytes_filled
-);
-
 /**
 * \brief
 *		Initializes the file transfer service to allow interaction between
@@ -73,4 +83,14 @@ int32_t ats_fts_init(void);
 * \return AR_EOK, AR_EFAILED, AR_EHANDLE
 */
 int32_t ats_fts_deinit(void);
+
+/**
+* \brief
+*		Orphans the transfers of a client that disconnected. An orphaned
+*		transfer can still be resumed by a new BEGIN_TRANSFER of the same
+*		file, but gives up its slot to any other transfer that needs one.
+* \param [in] client_id: The client that disconnected
+* \return none
+*/
+void ats_fts_release_client(uint32_t client_id);
 #endif /*_ATS_FTS_H_*/
\ No newline at end of file
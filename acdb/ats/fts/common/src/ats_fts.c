@@ -21,6 +21,7 @@
 #include "ats_i.h"
 #include "acdb_utility.h"
 #include "ats_common.h"
+#include "ar_osal_timer.h"
 
 /*------------------------------------------
 * Defines, Constants, Globals
@@ -28,10 +29,154 @@
 
 static FtsFileTable *fts_file_table = NULL;
 
+/**< CRC-32 (IEEE 802.3, reflected) lookup table for transfer checksums */
+static uint32_t fts_crc32_table[256];
+
 /*------------------------------------------
 * Private Functions
 *------------------------------------------*/
 
+static void fts_crc32_init(void)
+{
+    uint32_t crc = 0;
+
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        crc = i;
+        for (uint32_t bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320ul : crc >> 1;
+        fts_crc32_table[i] = crc;
+    }
+}
+
+static uint32_t fts_crc32(const uint8_t *data, uint32_t size)
+{
+    uint32_t crc = 0xFFFFFFFFul;
+
+    for (uint32_t i = 0; i < size; i++)
+        crc = fts_crc32_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    return crc ^ 0xFFFFFFFFul;
+}
+
+static void fts_get_part_path(FtsTransfer *transfer, char_t *part_path, size_t size)
+{
+    ar_strcpy(part_path, size, transfer->file_path,
+        ar_strlen(transfer->file_path, sizeof(transfer->file_path)));
+    ar_strcat(part_path, size, FTS_TRANSFER_PART_SUFFIX,
+        sizeof(FTS_TRANSFER_PART_SUFFIX));
+}
+
+/**
+* \brief
+*		Closes the part file of a transfer and frees its slot.
+* \param [in] transfer: The transfer to release
+* \param [in] delete_part: Whether to delete the part file
+*/
+static void fts_release_transfer(FtsTransfer *transfer, bool_t delete_part)
+{
+    char_t part_path[FTS_TRANSFER_MAX_PATH_LENGTH] = { 0 };
+
+    if (IsNull(transfer->fhandle))
+        return;
+
+    (void)ar_fclose(transfer->fhandle);
+    if (delete_part)
+    {
+        fts_get_part_path(transfer, part_path, sizeof(part_path));
+        (void)ar_fdelete(part_path);
+    }
+
+    if (!IsNull(transfer->received_bitmap))
+        ACDB_FREE(transfer->received_bitmap);
+
+    ar_mem_set(transfer, 0, sizeof(FtsTransfer));
+}
+
+/**
+* \brief
+*		Deletes transfers that were idle for FTS_TRANSFER_IDLE_TIMEOUT_US and
+*		finds a free slot for a new transfer. If every slot is taken, the
+*		orphaned transfer that was idle longest is deleted to make room.
+* \param [in] now_us: The current time
+* \return The index of the free slot, FTS_MAX_TRANSFER_COUNT if none is free
+*/
+static uint32_t fts_reclaim_transfer(uint64_t now_us)
+{
+    uint32_t tindex = 0;
+    uint32_t free_index = FTS_MAX_TRANSFER_COUNT;
+    uint32_t orphan_index = FTS_MAX_TRANSFER_COUNT;
+    FtsTransfer *transfer = NULL;
+
+    for (tindex = 0; tindex < FTS_MAX_TRANSFER_COUNT; tindex++)
+    {
+        transfer = &fts_file_table->transfer[tindex];
+        if (!IsNull(transfer->fhandle) &&
+            now_us - transfer->last_active_us >= FTS_TRANSFER_IDLE_TIMEOUT_US)
+        {
+            ATS_DBG("Deleting transfer of %s, it was idle too long", transfer->file_path);
+            fts_release_transfer(transfer, TRUE);
+        }
+
+        if (IsNull(transfer->fhandle))
+        {
+            if (FTS_MAX_TRANSFER_COUNT == free_index)
+                free_index = tindex;
+        }
+        else if (transfer->is_orphaned && (FTS_MAX_TRANSFER_COUNT == orphan_index ||
+            transfer->last_active_us < fts_file_table->transfer[orphan_index].last_active_us))
+        {
+            orphan_index = tindex;
+        }
+    }
+
+    if (FTS_MAX_TRANSFER_COUNT == free_index && FTS_MAX_TRANSFER_COUNT != orphan_index)
+    {
+        transfer = &fts_file_table->transfer[orphan_index];
+        ATS_DBG("Deleting transfer of %s, its client disconnected", transfer->file_path);
+        fts_release_transfer(transfer, TRUE);
+        free_index = orphan_index;
+    }
+
+    return free_index;
+}
+
+/**
+* \brief
+*		Makes the directory entry of a renamed file durable.
+* \param [in] file_path: The new path of the file
+* \return 0 on success, non-zero on failure
+*/
+static int32_t fts_sync_parent_directory(const char_t *file_path)
+{
+    char_t dir_path[FTS_TRANSFER_MAX_PATH_LENGTH] = { 0 };
+    size_t length = ar_strlen(file_path, FTS_TRANSFER_MAX_PATH_LENGTH);
+
+    while (length > 0 && '/' != file_path[length - 1])
+        length--;
+
+    if (0 == length)
+        ar_strcpy(dir_path, sizeof(dir_path), ".", sizeof("."));
+    else
+        ar_strcpy(dir_path, sizeof(dir_path), file_path, length > 1 ? length - 1 : 1);
+
+    return ar_fsync_dir(dir_path);
+}
+
+static int32_t fts_get_transfer(uint32_t tindex, FtsTransfer **transfer)
+{
+    if (tindex >= FTS_MAX_TRANSFER_COUNT ||
+        IsNull(fts_file_table->transfer[tindex].fhandle))
+    {
+        ATS_ERR("Invalid transfer index %d", tindex);
+        return AR_EHANDLE;
+    }
+
+    *transfer = &fts_file_table->transfer[tindex];
+    return AR_EOK;
+}
+
+
 int32_t fts_open_file(
     uint8_t *cmd_buf,
     uint32_t cmd_buf_size,
@@ -201,70 +346,420 @@ int32_t fts_close_file(
     return status;
 }
 
-/*------------------------------------------
-* Public Functions
-*------------------------------------------*/
+int32_t fts_begin_transfer(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    uint8_t *rsp_buf,
+    uint32_t rsp_buf_size,
+    uint32_t *rsp_buf_bytes_filled)
+{
+    int32_t status = AR_EOK;
+    uint32_t offset = 0;
+    uint32_t tindex = 0;
+    uint32_t bitmap_size = 0;
+    uint32_t window_size = FTS_TRANSFER_WINDOW_SIZE;
+    size_t path_length = 0;
+    uint64_t now_us = ar_timer_get_time_in_us();
+    char_t part_path[FTS_TRANSFER_MAX_PATH_LENGTH] = { 0 };
+    FtsTransfer *transfer = NULL;
+    AtsCmdFtsBeginTransferReq req = { 0 };
+
+    *rsp_buf_bytes_filled = 0;
+
+    if (cmd_buf_size < 3 * sizeof(uint32_t))
+    {
+        return AR_EBADPARAM;
+    }
+
+    //Read Command Request
+    ATS_MEM_CPY_SAFE(&req.file_path_length, sizeof(uint32_t), cmd_buf + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+
+    if (req.file_path_length > cmd_buf_size - 3 * sizeof(uint32_t))
+    {
+        return AR_EBADPARAM;
+    }
+
+    req.file_path = (char*)cmd_buf + offset;
+    offset += req.file_path_length;
+
+    ATS_MEM_CPY_SAFE(&req.file_size, sizeof(uint32_t), cmd_buf + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
 
-int32_t ats_fts_ioctl(
-    uint32_t svc_cmd_id,
+    ATS_MEM_CPY_SAFE(&req.chunk_size, sizeof(uint32_t), cmd_buf + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+
+    path_length = ar_strlen(req.file_path, req.file_path_length);
+    if (0 == path_length || path_length + sizeof(FTS_TRANSFER_PART_SUFFIX) >
+        FTS_TRANSFER_MAX_PATH_LENGTH)
+    {
+        ATS_ERR("Error[%d]: Invalid file path length %d", AR_EBADPARAM, req.file_path_length);
+        return AR_EBADPARAM;
+    }
+
+    if (0 == req.chunk_size || req.chunk_size > FTS_TRANSFER_MAX_CHUNK_SIZE)
+    {
+        ATS_ERR("Error[%d]: Invalid chunk size %d", AR_EBADPARAM, req.chunk_size);
+        return AR_EBADPARAM;
+    }
+
+    //Resume a transfer of the same file that was interrupted
+    for (tindex = 0; tindex < FTS_MAX_TRANSFER_COUNT; tindex++)
+    {
+        //The request path need not be NUL terminated, compare path_length bytes
+        transfer = &fts_file_table->transfer[tindex];
+        if (IsNull(transfer->fhandle) ||
+            path_length != ar_strlen(transfer->file_path, sizeof(transfer->file_path)) ||
+            0 != ar_strcmp(transfer->file_path, req.file_path, path_length))
+            continue;
+
+        if (transfer->file_size == req.file_size &&
+            transfer->chunk_size == req.chunk_size)
+            break;
+
+        ATS_DBG("Restarting transfer of %s, the size changed", transfer->file_path);
+        fts_release_transfer(transfer, TRUE);
+    }
+
+    if (tindex < FTS_MAX_TRANSFER_COUNT)
+    {
+        ATS_DBG("Resuming transfer of %s, %d of %d chunks received",
+            transfer->file_path, transfer->num_chunks_received, transfer->num_chunks);
+    }
+    else
+    {
+        bitmap_size = (uint32_t)(((uint64_t)req.file_size + req.chunk_size - 1) /
+            req.chunk_size + 7) / 8;
+        if (rsp_buf_size < 5 * sizeof(uint32_t) + bitmap_size)
+        {
+            ATS_ERR("Error[%d]: The chunk bitmap does not fit in the response, "
+                "use a larger chunk size", AR_ENORESOURCE);
+            return AR_ENORESOURCE;
+        }
+
+        tindex = fts_reclaim_transfer(now_us);
+        if (tindex >= FTS_MAX_TRANSFER_COUNT)
+        {
+            ATS_ERR("Max number of transfers reached");
+            return AR_ENORESOURCE;
+        }
+
+        transfer = &fts_file_table->transfer[tindex];
+        ar_strcpy(transfer->file_path, sizeof(transfer->file_path),
+            req.file_path, path_length);
+        transfer->file_size = req.file_size;
+        transfer->chunk_size = req.chunk_size;
+        transfer->num_chunks = (uint32_t)(((uint64_t)req.file_size +
+            req.chunk_size - 1) / req.chunk_size);
+
+        if (0 != bitmap_size)
+        {
+            transfer->received_bitmap = ACDB_MALLOC(uint8_t, bitmap_size);
+            if (IsNull(transfer->received_bitmap))
+            {
+                ATS_ERR("Error[%d]: Failed to allocate the chunk bitmap", AR_ENOMEMORY);
+                ar_mem_set(transfer, 0, sizeof(FtsTransfer));
+                return AR_ENOMEMORY;
+            }
+            ar_mem_set(transfer->received_bitmap, 0, bitmap_size);
+        }
+
+        ATS_DBG("Starting transfer of %s, %d bytes in %d chunks",
+            transfer->file_path, transfer->file_size, transfer->num_chunks);
+
+        fts_get_part_path(transfer, part_path, sizeof(part_path));
+        status = ar_fopen(&transfer->fhandle, part_path, AR_FOPEN_WRITE_ONLY);
+        if (AR_FAILED(status))
+        {
+            ATS_ERR("Error[%d]: Failed to create %s", status, part_path);
+            if (!IsNull(transfer->received_bitmap))
+                ACDB_FREE(transfer->received_bitmap);
+            ar_mem_set(transfer, 0, sizeof(FtsTransfer));
+            return status;
+        }
+    }
+
+    transfer->client_id = ats_get_client_id();
+    transfer->is_orphaned = FALSE;
+    transfer->last_active_us = now_us;
+
+    //Write Command Response
+    bitmap_size = (transfer->num_chunks + 7) / 8;
+    if (rsp_buf_size < 5 * sizeof(uint32_t) + bitmap_size)
+    {
+        return AR_ENORESOURCE;
+    }
+
+    offset = 0;
+    ATS_MEM_CPY_SAFE(rsp_buf + offset, sizeof(uint32_t), &tindex, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    ATS_MEM_CPY_SAFE(rsp_buf + offset, sizeof(uint32_t), &window_size, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    ATS_MEM_CPY_SAFE(rsp_buf + offset, sizeof(uint32_t), &transfer->num_chunks, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    ATS_MEM_CPY_SAFE(rsp_buf + offset, sizeof(uint32_t), &transfer->num_chunks_received, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    ATS_MEM_CPY_SAFE(rsp_buf + offset, sizeof(uint32_t), &bitmap_size, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    if (0 != bitmap_size)
+    {
+        ATS_MEM_CPY_SAFE(rsp_buf + offset, bitmap_size, transfer->received_bitmap, bitmap_size);
+        offset += bitmap_size;
+    }
+
+    *rsp_buf_bytes_filled = offset;
+    return status;
+}
+
+int32_t fts_write_chunk(
     uint8_t *cmd_buf,
     uint32_t cmd_buf_size,
     uint8_t *rsp_buf,
     uint32_t rsp_buf_size,
-    uint32_t *rsp_buf_bytes_filled
-)
+    uint32_t *rsp_buf_bytes_filled)
+{
+    int32_t status = AR_EOK;
+    uint32_t offset = 0;
+    uint32_t chunk = 0;
+    uint32_t expected_size = 0;
+    size_t bytes_written = 0;
+    FtsTransfer *transfer = NULL;
+    AtsCmdFtsWriteChunkReq req = { 0 };
+
+    *rsp_buf_bytes_filled = 0;
+
+    if (cmd_buf_size < 4 * sizeof(uint32_t) ||
+        rsp_buf_size < sizeof(AtsCmdFtsWriteChunkRsp))
+    {
+        return AR_EBADPARAM;
+    }
+
+    //Read Command Request
+    ATS_MEM_CPY_SAFE(&req.tindex, sizeof(uint32_t), cmd_buf + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    ATS_MEM_CPY_SAFE(&req.offset, sizeof(uint32_t), cmd_buf + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    ATS_MEM_CPY_SAFE(&req.write_size, sizeof(uint32_t), cmd_buf + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    ATS_MEM_CPY_SAFE(&req.checksum, sizeof(uint32_t), cmd_buf + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    req.buf_ptr = cmd_buf + offset;
+
+    status = fts_get_transfer(req.tindex, &transfer);
+    if (AR_FAILED(status))
+    {
+        return status;
+    }
+
+    chunk = req.offset / transfer->chunk_size;
+    if (0 != req.offset % transfer->chunk_size || chunk >= transfer->num_chunks)
+    {
+        ATS_ERR("Error[%d]: Invalid chunk offset %d", AR_EBADPARAM, req.offset);
+        return AR_EBADPARAM;
+    }
+
+    expected_size = transfer->file_size - req.offset;
+    if (expected_size > transfer->chunk_size)
+        expected_size = transfer->chunk_size;
+
+    if (req.write_size != expected_size || req.write_size > cmd_buf_size - offset)
+    {
+        ATS_ERR("Error[%d]: Chunk at offset %d has size %d, expected %d",
+            AR_EBADPARAM, req.offset, req.write_size, expected_size);
+        return AR_EBADPARAM;
+    }
+
+    if (fts_crc32((uint8_t*)req.buf_ptr, req.write_size) != req.checksum)
+    {
+        ATS_ERR("Error[%d]: Checksum mismatch for chunk at offset %d",
+            AR_EIODATA, req.offset);
+        return AR_EIODATA;
+    }
+
+    //A resent chunk that is already on disk is only acknowledged
+    if (!(transfer->received_bitmap[chunk / 8] & (1u << (chunk % 8))))
+    {
+        status = ar_fseek(transfer->fhandle, req.offset, AR_FSEEK_BEGIN);
+        if (AR_SUCCEEDED(status))
+            status = ar_fwrite(transfer->fhandle, req.buf_ptr, req.write_size, &bytes_written);
+
+        if (AR_FAILED(status) || bytes_written != req.write_size)
+        {
+            ATS_ERR("Error(%d), WriteSize(%d) BytesWritten(%d): Failed to write chunk at offset %d.",
+                status, req.write_size, bytes_written, req.offset);
+            return AR_FAILED(status) ? status : AR_EFAILED;
+        }
+
+        transfer->received_bitmap[chunk / 8] |= (uint8_t)(1u << (chunk % 8));
+        transfer->num_chunks_received++;
+    }
+    transfer->last_active_us = ar_timer_get_time_in_us();
+
+    //Write Command Response
+    ATS_MEM_CPY_SAFE(rsp_buf, sizeof(uint32_t), &req.offset, sizeof(uint32_t));
+    ATS_MEM_CPY_SAFE(rsp_buf + sizeof(uint32_t), sizeof(uint32_t),
+        &transfer->num_chunks_received, sizeof(uint32_t));
+    *rsp_buf_bytes_filled = sizeof(AtsCmdFtsWriteChunkRsp);
+
+    return status;
+}
+
+int32_t fts_commit_transfer(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    uint8_t *rsp_buf,
+    uint32_t rsp_buf_size,
+    uint32_t *rsp_buf_bytes_filled)
 {
+    __UNREFERENCED_PARAM(rsp_buf);
+    __UNREFERENCED_PARAM(rsp_buf_size);
+
     int32_t status = AR_EOK;
+    int32_t close_status = AR_EOK;
+    char_t part_path[FTS_TRANSFER_MAX_PATH_LENGTH] = { 0 };
+    FtsTransfer *transfer = NULL;
+    AtsCmdFtsTransferReq req = { 0 };
+
+    *rsp_buf_bytes_filled = 0;
 
-    int32_t(*func_cb)(
-        uint8_t *cmd_buf,
-        uint32_t cmd_buf_size,
-        uint8_t *rsp_buf,
-        uint32_t rsp_buf_size,
-        uint32_t *rsp_buf_bytes_filled
-        ) = NULL;
+    if (cmd_buf_size < sizeof(AtsCmdFtsTransferReq))
+    {
+        return AR_EBADPARAM;
+    }
 
-    status = ar_osal_mutex_lock(fts_file_table->lock);
+    ATS_MEM_CPY_SAFE(&req.tindex, sizeof(uint32_t), cmd_buf, sizeof(uint32_t));
+
+    status = fts_get_transfer(req.tindex, &transfer);
     if (AR_FAILED(status))
     {
-        ATS_ERR("Error[%d]: Failed to lock.", status);
         return status;
     }
 
-    switch (svc_cmd_id)
+    if (transfer->num_chunks_received != transfer->num_chunks)
     {
-    case ATS_CMD_FTS_OPEN_FILE:
-        func_cb = fts_open_file;
-        break;
-    case ATS_CMD_FTS_WRITE_FILE:
-        func_cb = fts_write_file;
-        break;
-    case ATS_CMD_FTS_CLOSE_FILE:
-        func_cb = fts_close_file;
-        break;
-    default:
-        ATS_ERR("Command[%x] is not supported", svc_cmd_id);
-        status = AR_EUNSUPPORTED;
+        ATS_ERR("Error[%d]: %d of %d chunks received for %s", AR_ENOTREADY,
+            transfer->num_chunks_received, transfer->num_chunks, transfer->file_path);
+        return AR_ENOTREADY;
     }
 
-    if (status == AR_EOK)
+    ATS_DBG("Committing transfer of %s...", transfer->file_path);
+
+    //The data must be on disk before the rename can expose it
+    status = ar_fsync(transfer->fhandle);
+    close_status = ar_fclose(transfer->fhandle);
+    transfer->fhandle = NULL;
+    if (AR_SUCCEEDED(status))
+        status = close_status;
+    fts_get_part_path(transfer, part_path, sizeof(part_path));
+
+    if (AR_SUCCEEDED(status))
+        status = ar_frename(part_path, transfer->file_path);
+
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to replace %s", status, transfer->file_path);
+        (void)ar_fdelete(part_path);
+    }
+    else
     {
-        status = func_cb(cmd_buf,
-            cmd_buf_size,
-            rsp_buf,
-            rsp_buf_size,
-            rsp_buf_bytes_filled);
+        //Keep the rename across a power loss
+        status = fts_sync_parent_directory(transfer->file_path);
+        if (AR_EUNSUPPORTED == status)
+            status = AR_EOK;
+        else if (AR_FAILED(status))
+            ATS_ERR("Error[%d]: Failed to sync the directory of %s", status, transfer->file_path);
     }
 
-    status = ar_osal_mutex_unlock(fts_file_table->lock);
+    if (!IsNull(transfer->received_bitmap))
+        ACDB_FREE(transfer->received_bitmap);
+    ar_mem_set(transfer, 0, sizeof(FtsTransfer));
+
+    return status;
+}
+
+int32_t fts_abort_transfer(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    uint8_t *rsp_buf,
+    uint32_t rsp_buf_size,
+    uint32_t *rsp_buf_bytes_filled)
+{
+    __UNREFERENCED_PARAM(rsp_buf);
+    __UNREFERENCED_PARAM(rsp_buf_size);
+
+    int32_t status = AR_EOK;
+    FtsTransfer *transfer = NULL;
+    AtsCmdFtsTransferReq req = { 0 };
+
+    *rsp_buf_bytes_filled = 0;
+
+    if (cmd_buf_size < sizeof(AtsCmdFtsTransferReq))
+    {
+        return AR_EBADPARAM;
+    }
+
+    ATS_MEM_CPY_SAFE(&req.tindex, sizeof(uint32_t), cmd_buf, sizeof(uint32_t));
+
+    status = fts_get_transfer(req.tindex, &transfer);
     if (AR_FAILED(status))
     {
-        ATS_ERR("Error[%d]: Failed to unlock.", status);
         return status;
     }
+
+    ATS_DBG("Aborting transfer of %s...", transfer->file_path);
+    fts_release_transfer(transfer, TRUE);
+
     return status;
 }
 
+static int32_t fts_lock(void)
+{
+    return ar_osal_mutex_lock(fts_file_table->lock);
+}
+
+static int32_t fts_unlock(void)
+{
+    return ar_osal_mutex_unlock(fts_file_table->lock);
+}
+
+#define FTS_CMD(cmd) ATS_GET_COMMAND_ID(ATS_CMD_FTS_##cmd)
+#define FTS_CMD_LAST FTS_CMD(ABORT_TRANSFER)
+
+/**< The File Transfer commands, all run under the file table lock */
+static const AtsCmdEntry fts_cmds[FTS_CMD_LAST + 1] = {
+    [FTS_CMD(OPEN_FILE)] = {
+        fts_open_file, sizeof(AtsCmdFtsOpenFileReq),
+        ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [FTS_CMD(WRITE_FILE)] = {
+        fts_write_file, sizeof(AtsCmdFtsWriteFileReq),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [FTS_CMD(CLOSE_FILE)] = {
+        fts_close_file, sizeof(AtsCmdFtsCloseFileReq),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [FTS_CMD(BEGIN_TRANSFER)] = {
+        fts_begin_transfer, 3 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, 5 * sizeof(uint32_t), 0 },
+    [FTS_CMD(WRITE_CHUNK)] = {
+        fts_write_chunk, 4 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, sizeof(AtsCmdFtsWriteChunkRsp), 0 },
+    [FTS_CMD(COMMIT_TRANSFER)] = {
+        fts_commit_transfer, sizeof(AtsCmdFtsTransferReq),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [FTS_CMD(ABORT_TRANSFER)] = {
+        fts_abort_transfer, sizeof(AtsCmdFtsTransferReq),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+};
+
+static const AtsCmdTable fts_cmd_table = {
+    fts_cmds,
+    sizeof(fts_cmds) / sizeof(fts_cmds[0]),
+    fts_lock,
+    fts_unlock
+};
+
+/*------------------------------------------
+* Public Functions
+*------------------------------------------*/
 
 int32_t ats_fts_init(void)
 {
@@ -280,6 +775,8 @@ int32_t ats_fts_init(void)
     }
 
     ACDB_CLEAR_BUFFER(fts_file_table->fhandle);
+    ACDB_CLEAR_BUFFER(fts_file_table->transfer);
+    fts_crc32_init();
 
     status = ar_osal_mutex_create(&fts_file_table->lock);
     if (AR_FAILED(status))
@@ -295,7 +792,7 @@ int32_t ats_fts_init(void)
     //    return status;
     //}
 
-    status = ats_register_service(ATS_FTS_SERVICE_ID, ats_fts_ioctl);
+    status = ats_register_service_table(ATS_FTS_SERVICE_ID, &fts_cmd_table);
 
     if (AR_FAILED(status))
     {
@@ -318,6 +815,10 @@ int32_t ats_fts_deinit(void)
         ATS_ERR("Error[%d]: Failed to deregister the File Transfer Service.", status);
     }
 
+    //Transfers that were never committed leave no part files behind
+    for (uint32_t tindex = 0; tindex < FTS_MAX_TRANSFER_COUNT; tindex++)
+        fts_release_transfer(&fts_file_table->transfer[tindex], TRUE);
+
     status = ar_osal_mutex_destroy(fts_file_table->lock);
     if (AR_FAILED(status))
     {
@@ -327,7 +828,25 @@ int32_t ats_fts_deinit(void)
 
     if (!IsNull(fts_file_table))
         ACDB_FREE(fts_file_table);
+    fts_file_table = NULL;
 
     return status;
 }
 
+void ats_fts_release_client(uint32_t client_id)
+{
+    FtsTransfer *transfer = NULL;
+
+    if (0 == client_id || IsNull(fts_file_table))
+        return;
+
+    (void)fts_lock();
+    for (uint32_t tindex = 0; tindex < FTS_MAX_TRANSFER_COUNT; tindex++)
+    {
+        transfer = &fts_file_table->transfer[tindex];
+        if (!IsNull(transfer->fhandle) && transfer->client_id == client_id)
+            transfer->is_orphaned = TRUE;
+    }
+    (void)fts_unlock();
+}
+
@@ -30,6 +30,8 @@ int32_t AtsCmdGetAllDatabasesFileSetInfo(AcdbFileManBlob* rsp);
 
 int32_t AtsCmdGetLoadedFileData(AcdbFileManGetFileDataReq *req, AcdbFileManBlob *rsp);
 
+int32_t AtsCmdOpenLoadedFile(AcdbFileManGetFileDataReq *req, AcdbFileManFileRegion *rsp);
+
 int32_t AtsCmdGetHeapEntryInfo(acdb_handle_t acdb_handle, AcdbBufferContext* rsp);
 
 int32_t AtsCmdGetHeapEntryData(acdb_handle_t acdb_handle, AcdbGraphKeyVector* key_vector, AcdbBufferContext* rsp);
@@ -37,4 +37,10 @@
 
 #define ATS_MEM_CPY_SAFE(dest, dest_size, src, src_size) ar_mem_cpy((int8_t*) dest, dest_size, (int8_t*)src, src_size)
 
+/**< CPUs the ATS server threads may run on, bit n for CPU n. 0 allows every
+CPU; set it at build time to keep tool traffic off the audio cores. */
+#ifndef ATS_THREAD_CPU_MASK
+#define ATS_THREAD_CPU_MASK 0
+#endif
+
 #endif /*_ATS_COMMON_H_*/
@@ -20,6 +20,7 @@
 #include "ar_osal_error.h"
 #include "ar_osal_types.h"
 #include "acdb.h"
+#include "ats_transport_api.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,8 @@ extern "C" {
 #define ATS_BUFFER_LENGTH                   0x200000
 #define ATS_MIN_BUFFER_LENGTH               ATS_1_KB * 32UL
 #define ATS_HEADER_LENGTH                   8
+/**< Size of the chunks streamed responses are sent in */
+#define ATS_RSP_STREAM_CHUNK_SIZE           (ATS_1_KB * 16UL)
 
 #define ATS_SERVICE_COMMAND_ID_LENGTH       4
 #define ATS_DATA_LENGTH_LENGTH              4
@@ -143,6 +146,32 @@ struct _ats_buffer_man_t
 extern AtsBufferManager *ats_buffer_manager;
 extern AtsBuffer ats_main_buffer;
 
+/**< Write cursor for a response sent to the client while it is produced.
+ * Filled through ats_rsp_stream_* only, see ATS_STREAM_CALLBACK */
+typedef struct _ats_rsp_stream_t AtsRspStream;
+struct _ats_rsp_stream_t
+{
+    /**< Transport function that sends a chunk */
+    ats_rsp_stream_write_t write;
+    /**< Transport function that sends from a file, may be NULL */
+    ats_rsp_stream_send_file_t send_file;
+    /**< Passed back to write */
+    void *transport_ctx;
+    /**< The command being responded to */
+    uint32_t svc_cmd_id;
+    /**< Holds the bytes not sent yet */
+    uint8_t *chunk;
+    uint32_t chunk_size;
+    uint32_t chunk_filled;
+    /**< Payload length announced by ats_rsp_stream_begin */
+    uint32_t data_length;
+    /**< Payload bytes committed so far */
+    uint32_t bytes_written;
+    bool_t started;
+    /**< First transport error, every later call returns it */
+    int32_t status;
+};
+
 //TODO: Move to bottom of file
 //void GetBufferManager(AtsBufferManager** buffer_man)
 //{
@@ -922,6 +951,147 @@ struct ats_cmd_rt_set_cal_data_persist_req_v2_t
 ;
 /** \} */ /* end_addtogroup ATS_CMD_RT_SET_CAL_DATA_PERSISTENT_V2 */
 
+/* ---------------------------------------------------------------------------
+* ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT_BULK Declarations and Documentation
+*-------------------------------------------------------------------------- */
+
+/** \addtogroup ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT_BULK
+\{ */
+
+/**
+	Retrieves non-persistent calibration for a list of parameters that may
+	span many graphs, subgraphs and modules. GSL reads all parameters that
+	run on the same processor with a single APM_CMD_GET_CFG.
+
+	Each entry is an AtsRtBulkCalEntry followed by its payload:
+
+			*-----------------------------------------------------------------*
+			| <Graph Handle, SG ID, IID, PID, Size, Error Code, Data[Size]> |
+			*-----------------------------------------------------------------*
+			|                              ...                                |
+			*-----------------------------------------------------------------*
+
+	The response carries the same entries with Data and Error Code filled
+	in. Error Code is the status of the individual entry.
+
+	\param[in] cmd_id
+		Command ID is ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT_BULK.
+	\param[in] cmd
+		Pointer to AtsCmdRtBulkCalDataReq.
+	\param[in] cmd_size
+		Size of AtsCmdRtBulkCalDataReq.
+	\param[out] rsp
+		Pointer to AtsCmdRtGetBulkCalDataRsp.
+	\param[in] rsp_size
+		Size of AtsCmdRtGetBulkCalDataRsp.
+
+	\return
+		- AR_EOK -- Every entry was read successfully.
+		- AR_EBADPARAM -- Invalid input parameters were provided.
+		- AR_EFAILED -- One or more entries failed, see their error codes.
+
+	\sa ATS_CMD_RT_SET_CAL_DATA_NON_PERSISTENT_BULK
+*/
+#define ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT_BULK ATS_RTC_CMD_ID(15)
+
+/**< Header of one entry of a bulk calibration request */
+typedef struct ats_rt_bulk_cal_entry_t AtsRtBulkCalEntry;
+#include "acdb_begin_pack.h"
+struct ats_rt_bulk_cal_entry_t
+{
+	/**< Handle to a graph provided by gsl_open*/
+	uint32_t graph_handle;
+	/**< Subgraph ID*/
+	uint32_t subgraph_id;
+	/**< Module instance ID*/
+	uint32_t instance_id;
+	/**< Parameter ID*/
+	uint32_t param_id;
+	/**< Size of the payload that follows, a multiple of 4*/
+	uint32_t param_size;
+	/**< [out] Status of this entry*/
+	uint32_t error_code;
+}
+#include "acdb_end_pack.h"
+;
+
+/**< The request structure for ATS_CMD_RT_GET/SET_CAL_DATA_NON_PERSISTENT_BULK*/
+typedef struct ats_cmd_rt_bulk_cal_data_req_t AtsCmdRtBulkCalDataReq;
+#include "acdb_begin_pack.h"
+struct ats_cmd_rt_bulk_cal_data_req_t
+{
+	/**< Number of entries*/
+	uint32_t entry_count;
+	/**< Size of the entry list in bytes*/
+	uint32_t data_size;
+	/**< [in/out] entry_count AtsRtBulkCalEntry headers, each
+	followed by its payload */
+	uint8_t entries[0];
+}
+#include "acdb_end_pack.h"
+;
+
+/**< The response structure for ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT_BULK*/
+typedef struct ats_cmd_rt_get_bulk_cal_data_rsp_t AtsCmdRtGetBulkCalDataRsp;
+#include "acdb_begin_pack.h"
+struct ats_cmd_rt_get_bulk_cal_data_rsp_t
+{
+	/**< Size of the entry list in bytes*/
+	uint32_t data_size;
+	/**< The request entries with payloads and error codes filled in */
+	uint8_t entries[0];
+}
+#include "acdb_end_pack.h"
+;
+/** \} */ /* end_addtogroup ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT_BULK */
+
+/* ---------------------------------------------------------------------------
+* ATS_CMD_RT_SET_CAL_DATA_NON_PERSISTENT_BULK Declarations and Documentation
+*-------------------------------------------------------------------------- */
+
+/** \addtogroup ATS_CMD_RT_SET_CAL_DATA_NON_PERSISTENT_BULK
+\{ */
+
+/**
+	Sets non-persistent calibration for a list of parameters that may span
+	many graphs, subgraphs and modules. GSL writes all parameters that run
+	on the same processor with a single APM_CMD_SET_CFG. The entry format is
+	the same as ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT_BULK.
+
+	\param[in] cmd_id
+		Command ID is ATS_CMD_RT_SET_CAL_DATA_NON_PERSISTENT_BULK.
+	\param[in] cmd
+		Pointer to AtsCmdRtBulkCalDataReq.
+	\param[in] cmd_size
+		Size of AtsCmdRtBulkCalDataReq.
+	\param[out] rsp
+		Pointer to AtsCmdRtSetBulkCalDataRsp.
+	\param[in] rsp_size
+		Size of AtsCmdRtSetBulkCalDataRsp.
+
+	\return
+		- AR_EOK -- Every entry was set successfully.
+		- AR_EBADPARAM -- Invalid input parameters were provided.
+		- AR_EFAILED -- One or more entries failed, see their error codes.
+
+	\sa ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT_BULK
+*/
+#define ATS_CMD_RT_SET_CAL_DATA_NON_PERSISTENT_BULK ATS_RTC_CMD_ID(16)
+
+/**< The response structure for ATS_CMD_RT_SET_CAL_DATA_NON_PERSISTENT_BULK*/
+typedef struct ats_cmd_rt_set_bulk_cal_data_rsp_t AtsCmdRtSetBulkCalDataRsp;
+#include "acdb_begin_pack.h"
+struct ats_cmd_rt_set_bulk_cal_data_rsp_t
+{
+	/**< Number of entries*/
+	uint32_t entry_count;
+	/**< Status of each entry, in request order */
+	uint32_t error_codes[0];
+}
+#include "acdb_end_pack.h"
+;
+/** \} */ /* end_addtogroup ATS_CMD_RT_SET_CAL_DATA_NON_PERSISTENT_BULK */
+
 /* ---------------------------------------------------------------------------
 * ATS_CMD_MCS_PLAY Declarations and Documentation
 *-------------------------------------------------------------------------- */
@@ -1363,6 +1533,239 @@ struct ats_cmd_fts_close_file_req_t
 ;
 /** \} */ /* end_addtogroup ATS_CMD_FTS_CLOSE_FILE */
 
+/* ---------------------------------------------------------------------------
+* ATS_CMD_FTS_BEGIN_TRANSFER Declarations and Documentation
+*-------------------------------------------------------------------------- */
+
+/** \addtogroup ATS_CMD_FTS_BEGIN_TRANSFER
+\{ */
+
+/**
+	Starts or resumes a chunked transfer of a file.
+
+	The file is written to <file_path>.part and only replaces file_path
+	when the transfer is committed. Chunks are addressed by offset, so
+	they may be written in any order and a client may keep up to
+	window_size writes in flight before waiting for their responses.
+
+	Transfers outlive the connection. Issuing this command again for the
+	same file_path, file_size and chunk_size after a reconnect returns the
+	same transfer index along with the chunks already received, and the
+	client only resends the missing ones. A different file_size or
+	chunk_size discards the old transfer and starts over.
+
+	\param[in] cmd_id
+		Command ID is ATS_CMD_FTS_BEGIN_TRANSFER.
+	\param[in] cmd
+		Pointer to AtsCmdFtsBeginTransferReq.
+	\param[in] cmd_size
+		Size of AtsCmdFtsBeginTransferReq.
+	\param[out] rsp
+		Pointer to AtsCmdFtsBeginTransferRsp.
+	\param[in] rsp_size
+		Size of AtsCmdFtsBeginTransferRsp.
+
+	\return
+		- AR_EOK -- Command executed successfully.
+		- AR_EBADPARAM -- Invalid input parameters were provided.
+		- AR_ENORESOURCE -- Too many transfers in progress, or the
+		  received chunk bitmap does not fit in the response.
+		- AR_EFAILED -- Command execution failed.
+
+	\sa
+		- ATS_CMD_FTS_WRITE_CHUNK
+		- ATS_CMD_FTS_COMMIT_TRANSFER
+		- ATS_CMD_FTS_ABORT_TRANSFER
+*/
+#define ATS_CMD_FTS_BEGIN_TRANSFER ATS_FTS_CMD_ID(4)
+/**< The request structure for ATS_CMD_FTS_BEGIN_TRANSFER*/
+typedef struct ats_cmd_fts_begin_transfer_req_t AtsCmdFtsBeginTransferReq;
+#include "acdb_begin_pack.h"
+struct ats_cmd_fts_begin_transfer_req_t
+{
+	/**< File path length*/
+	uint32_t file_path_length;
+	/**< File path*/
+	char *file_path;
+	/**< Total size of the file in bytes*/
+	uint32_t file_size;
+	/**< Size of every chunk except the last one*/
+	uint32_t chunk_size;
+}
+#include "acdb_end_pack.h"
+;
+
+/**< The response structure for ATS_CMD_FTS_BEGIN_TRANSFER*/
+typedef struct ats_cmd_fts_begin_transfer_rsp_t AtsCmdFtsBeginTransferRsp;
+#include "acdb_begin_pack.h"
+struct ats_cmd_fts_begin_transfer_rsp_t
+{
+	/**< Transfer index used by the other transfer commands*/
+	uint32_t tindex;
+	/**< Number of writes a client may have in flight*/
+	uint32_t window_size;
+	/**< Number of chunks in the file*/
+	uint32_t num_chunks;
+	/**< Number of chunks already received*/
+	uint32_t num_chunks_received;
+	/**< Size of the received chunk bitmap in bytes*/
+	uint32_t bitmap_size;
+	/**< Bit n (byte n / 8, bit n % 8) is set if chunk n was received*/
+	uint8_t *received_bitmap;
+}
+#include "acdb_end_pack.h"
+;
+/** \} */ /* end_addtogroup ATS_CMD_FTS_BEGIN_TRANSFER */
+
+/* ---------------------------------------------------------------------------
+* ATS_CMD_FTS_WRITE_CHUNK Declarations and Documentation
+*-------------------------------------------------------------------------- */
+
+/** \addtogroup ATS_CMD_FTS_WRITE_CHUNK
+\{ */
+
+/**
+	Writes one chunk of a transfer at the given offset.
+
+	The offset must be a multiple of the chunk size and the write size
+	must be the chunk size, or the remainder of the file for the last
+	chunk. The checksum is the CRC-32 (IEEE 802.3, as computed by zlib)
+	of the data. A chunk that was already received is acknowledged
+	without being written again, so resending after a lost response is
+	safe.
+
+	\param[in] cmd_id
+		Command ID is ATS_CMD_FTS_WRITE_CHUNK.
+	\param[in] cmd
+		Pointer to AtsCmdFtsWriteChunkReq.
+	\param[in] cmd_size
+		Size of AtsCmdFtsWriteChunkReq.
+	\param[out] rsp
+		Pointer to AtsCmdFtsWriteChunkRsp.
+	\param[in] rsp_size
+		Size of AtsCmdFtsWriteChunkRsp.
+
+	\return
+		- AR_EOK -- Command executed successfully.
+		- AR_EBADPARAM -- Invalid input parameters were provided.
+		- AR_EHANDLE -- The transfer index is not in use.
+		- AR_EIODATA -- The checksum does not match, resend the chunk.
+		- AR_EFAILED -- Command execution failed.
+
+	\sa
+		- ATS_CMD_FTS_BEGIN_TRANSFER
+*/
+#define ATS_CMD_FTS_WRITE_CHUNK ATS_FTS_CMD_ID(5)
+/**< The request structure for ATS_CMD_FTS_WRITE_CHUNK*/
+typedef struct ats_cmd_fts_write_chunk_req_t AtsCmdFtsWriteChunkReq;
+#include "acdb_begin_pack.h"
+struct ats_cmd_fts_write_chunk_req_t
+{
+	/**< Transfer index*/
+	uint32_t tindex;
+	/**< Offset of the chunk in the file*/
+	uint32_t offset;
+	/**< Size of the data to write*/
+	uint32_t write_size;
+	/**< CRC-32 of the data*/
+	uint32_t checksum;
+	/**< Pointer to the data to be written*/
+	void *buf_ptr;
+}
+#include "acdb_end_pack.h"
+;
+
+/**< The response structure for ATS_CMD_FTS_WRITE_CHUNK*/
+typedef struct ats_cmd_fts_write_chunk_rsp_t AtsCmdFtsWriteChunkRsp;
+#include "acdb_begin_pack.h"
+struct ats_cmd_fts_write_chunk_rsp_t
+{
+	/**< Offset of the chunk that was acknowledged*/
+	uint32_t offset;
+	/**< Number of chunks received so far*/
+	uint32_t num_chunks_received;
+}
+#include "acdb_end_pack.h"
+;
+/** \} */ /* end_addtogroup ATS_CMD_FTS_WRITE_CHUNK */
+
+/* ---------------------------------------------------------------------------
+* ATS_CMD_FTS_COMMIT_TRANSFER Declarations and Documentation
+*-------------------------------------------------------------------------- */
+
+/** \addtogroup ATS_CMD_FTS_COMMIT_TRANSFER
+\{ */
+
+/**
+	Completes a transfer. Once every chunk has been received the
+	<file_path>.part file is renamed over file_path, so readers of
+	file_path never see a partially written file.
+
+	\param[in] cmd_id
+		Command ID is ATS_CMD_FTS_COMMIT_TRANSFER.
+	\param[in] cmd
+		Pointer to AtsCmdFtsTransferReq.
+	\param[in] cmd_size
+		Size of AtsCmdFtsTransferReq.
+	\param[out] rsp
+		There is no output structure; set this to NULL.
+	\param[in] rsp_size
+		There is no output structure; set this to 0.
+
+	\return
+		- AR_EOK -- Command executed successfully.
+		- AR_EHANDLE -- The transfer index is not in use.
+		- AR_ENOTREADY -- Chunks are missing, the transfer stays open.
+		- AR_EFAILED -- Command execution failed.
+
+	\sa
+		- ATS_CMD_FTS_BEGIN_TRANSFER
+*/
+#define ATS_CMD_FTS_COMMIT_TRANSFER ATS_FTS_CMD_ID(6)
+/**< The request structure for ATS_CMD_FTS_COMMIT_TRANSFER and ATS_CMD_FTS_ABORT_TRANSFER*/
+typedef struct ats_cmd_fts_transfer_req_t AtsCmdFtsTransferReq;
+#include "acdb_begin_pack.h"
+struct ats_cmd_fts_transfer_req_t
+{
+	/**< Transfer index*/
+	uint32_t tindex;
+}
+#include "acdb_end_pack.h"
+;
+/** \} */ /* end_addtogroup ATS_CMD_FTS_COMMIT_TRANSFER */
+
+/* ---------------------------------------------------------------------------
+* ATS_CMD_FTS_ABORT_TRANSFER Declarations and Documentation
+*-------------------------------------------------------------------------- */
+
+/** \addtogroup ATS_CMD_FTS_ABORT_TRANSFER
+\{ */
+
+/**
+	Cancels a transfer and deletes its <file_path>.part file. The file at
+	file_path is left untouched.
+
+	\param[in] cmd_id
+		Command ID is ATS_CMD_FTS_ABORT_TRANSFER.
+	\param[in] cmd
+		Pointer to AtsCmdFtsTransferReq.
+	\param[in] cmd_size
+		Size of AtsCmdFtsTransferReq.
+	\param[out] rsp
+		There is no output structure; set this to NULL.
+	\param[in] rsp_size
+		There is no output structure; set this to 0.
+
+	\return
+		- AR_EOK -- Command executed successfully.
+		- AR_EHANDLE -- The transfer index is not in use.
+
+	\sa
+		- ATS_CMD_FTS_BEGIN_TRANSFER
+*/
+#define ATS_CMD_FTS_ABORT_TRANSFER ATS_FTS_CMD_ID(7)
+/** \} */ /* end_addtogroup ATS_CMD_FTS_ABORT_TRANSFER */
+
 /* ---------------------------------------------------------------------------
 * ATS_CMD_ADIE_GET_VERSION Declarations and Documentation
 *-------------------------------------------------------------------------- */
@@ -1518,7 +1921,8 @@ struct ats_cmd_adie_get_register_rsp_t
 \{ */
 
 /**
-	Calls ATS_CMD_ADIE_GET_REGISTER for each ADIE register
+	Calls ATS_CMD_ADIE_GET_REGISTER for each ADIE register. The codec
+	register map is read once for the whole list.
 
 	\param[in] cmd_id
 		Command ID is ATS_CMD_ADIE_GET_MULTIPLE_REGISTER.
@@ -1598,7 +2002,8 @@ struct ats_cmd_adie_set_register_req_t
 \{ */
 
 /**
-	Calls ATS_CMD_ADIE_SET_REGISTER for each ADIE register
+	Calls ATS_CMD_ADIE_SET_REGISTER for each ADIE register. The codec
+	register files are opened once for the whole list.
 
 	\param[in] cmd_id
 		Command ID is ATS_CMD_ADIE_SET_MULTIPLE_REGISTER.
@@ -1621,6 +2026,114 @@ struct ats_cmd_adie_set_register_req_t
 #define ATS_CMD_ADIE_SET_MULTIPLE_REGISTER ATS_CODEC_RTC_CMD_ID(5)
 /** \} */ /* end_addtogroup ATS_CMD_ADIE_SET_MULTIPLE_REGISTER */
 
+/* ---------------------------------------------------------------------------
+* ATS_CMD_ADIE_GET_REGISTER_RANGE Declarations and Documentation
+*-------------------------------------------------------------------------- */
+
+/** \addtogroup ATS_CMD_ADIE_GET_REGISTER_RANGE
+\{ */
+
+/**
+	Gets the value of every register the codec exposes within a range of
+	register IDs. The codec register map is read once for the whole range
+	and no other ADIE command runs until the response is built.
+
+	Register IDs the codec does not map are skipped. The response has the
+	same layout as the ATS_CMD_ADIE_SET_MULTIPLE_REGISTER request, so a
+	register snapshot can be restored by sending it back unchanged.
+
+	\param[in] cmd_id
+		Command ID is ATS_CMD_ADIE_GET_REGISTER_RANGE.
+	\param[in] cmd
+		Pointer to AtsCmdAdieRegisterRangeReq.
+	\param[in] cmd_size
+		Size of AtsCmdAdieRegisterRangeReq.
+	\param[out] rsp
+		Pointer to AtsCmdAdieGetRegisterRangeRsp.
+	\param[in] rsp_size
+		Size of AtsCmdAdieGetRegisterRangeRsp including the register list.
+
+	\return
+		- AR_EOK -- Command executed successfully.
+		- AR_EBADPARAM -- Invalid input parameters were provided.
+		- AR_ENEEDMORE -- The response buffer cannot hold every register
+		  in the range. Split the range into smaller requests.
+		- AR_EFAILED -- Command execution failed.
+
+	\sa
+		- ATS_CMD_ADIE_SET_MULTIPLE_REGISTER
+*/
+#define ATS_CMD_ADIE_GET_REGISTER_RANGE ATS_CODEC_RTC_CMD_ID(6)
+/**< The request structure for ATS_CMD_ADIE_GET_REGISTER_RANGE and
+ATS_CMD_ADIE_SET_REGISTER_RANGE.*/
+typedef struct ats_cmd_adie_register_range_req_t AtsCmdAdieRegisterRangeReq;
+#include "acdb_begin_pack.h"
+struct ats_cmd_adie_register_range_req_t
+{
+	/**< Codec handle*/
+	uint32_t codec_handle;
+	/**< ID of the first register in the range*/
+	uint32_t start_register_id;
+	/**< Number of consecutive register IDs in the range*/
+	uint32_t register_count;
+	/**< The bit-mask applied to every register in the range*/
+	uint32_t register_mask;
+}
+#include "acdb_end_pack.h"
+;
+
+/**< The response structure for ATS_CMD_ADIE_GET_REGISTER_RANGE.*/
+typedef struct ats_cmd_adie_get_register_range_rsp_t AtsCmdAdieGetRegisterRangeRsp;
+#include "acdb_begin_pack.h"
+struct ats_cmd_adie_get_register_range_rsp_t
+{
+	/**< Codec handle*/
+	uint32_t codec_handle;
+	/**< Number of registers in the list*/
+	uint32_t register_count;
+	/**< The registers found in the range in ascending ID order. Each entry
+	holds the register ID, mask and value as three uint32s*/
+	uint32_t register_list[0];
+}
+#include "acdb_end_pack.h"
+;
+/** \} */ /* end_addtogroup ATS_CMD_ADIE_GET_REGISTER_RANGE */
+
+/* ---------------------------------------------------------------------------
+* ATS_CMD_ADIE_SET_REGISTER_RANGE Declarations and Documentation
+*-------------------------------------------------------------------------- */
+
+/** \addtogroup ATS_CMD_ADIE_SET_REGISTER_RANGE
+\{ */
+
+/**
+	Sets consecutive codec registers starting at
+	AtsCmdAdieRegisterRangeReq::start_register_id. The request is followed
+	by one uint32 value per register. The registers are written in order
+	and no other ADIE command runs until the last one is written.
+
+	\param[in] cmd_id
+		Command ID is ATS_CMD_ADIE_SET_REGISTER_RANGE.
+	\param[in] cmd
+		Pointer to AtsCmdAdieRegisterRangeReq followed by the values.
+	\param[in] cmd_size
+		Size of AtsCmdAdieRegisterRangeReq plus 4 bytes per register.
+	\param[out] rsp
+		There is no output structure; set this to NULL.
+	\param[in] rsp_size
+		There is no output structure; set this to 0.
+
+	\return
+		- AR_EOK -- Command executed successfully.
+		- AR_EBADPARAM -- Invalid input parameters were provided.
+		- AR_EFAILED -- Command execution failed.
+
+	\sa
+		- ATS_CMD_ADIE_GET_REGISTER_RANGE
+*/
+#define ATS_CMD_ADIE_SET_REGISTER_RANGE ATS_CODEC_RTC_CMD_ID(7)
+/** \} */ /* end_addtogroup ATS_CMD_ADIE_SET_REGISTER_RANGE */
+
 /* ---------------------------------------------------------------------------
 * ATS_CMD_ONC_GET_SERVICE_INFO Declarations and Documentation
 *-------------------------------------------------------------------------- */
@@ -1706,7 +2219,7 @@ struct ats_cmd_get_service_info_rsp_t
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_CHECK_CONNECTION ATS_ONLINE_CMD_ID(2)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_CHECK_CONNECTION */
@@ -1737,7 +2250,7 @@ struct ats_cmd_get_service_info_rsp_t
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_MAX_BUFFER_LENGTH ATS_ONLINE_CMD_ID(3)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_GET_MAX_BUFFER_LENGTH */
@@ -1768,7 +2281,7 @@ struct ats_cmd_get_service_info_rsp_t
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_SET_MAX_BUFFER_LENGTH ATS_ONLINE_CMD_ID(4)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_SET_MAX_BUFFER_LENGTH */
@@ -1800,7 +2313,7 @@ struct ats_cmd_get_service_info_rsp_t
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_ACDB_FILES_INFO ATS_ONLINE_CMD_ID(5)
 
@@ -1862,7 +2375,7 @@ struct ats_cmd_get_acdb_file_info_rsp_t
         - AR_EFAILED -- Command execution failed.
 
     \sa
-    ats_online_ioctl
+    ats_online_cmd_table
     ATS_CMD_ONC_GET_ACDB_FILES_INFO
 */
 #define ATS_CMD_ONC_GET_ACDB_FILE ATS_ONLINE_CMD_ID(6)
@@ -1911,7 +2424,7 @@ struct _ats_ocs_get_acdb_file_req_t
         - AR_EFAILED -- Command execution failed.
 
     \sa
-    ats_online_ioctl
+    ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_HEAP_ENTRY_INFO ATS_ONLINE_CMD_ID(7)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_GET_HEAP_ENTRY_INFO */
@@ -1946,7 +2459,7 @@ struct _ats_ocs_get_acdb_file_req_t
         - AR_EFAILED -- Command execution failed.
 
     \sa
-    ats_online_ioctl
+    ats_online_cmd_table
     ATS_CMD_ONC_GET_HEAP_ENTRY_INFO
 */
 #define ATS_CMD_ONC_GET_HEAP_ENTRY_DATA ATS_ONLINE_CMD_ID(8)
@@ -1978,7 +2491,7 @@ struct _ats_ocs_get_acdb_file_req_t
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_CAL_DATA_NON_PERSIST ATS_ONLINE_CMD_ID(9)
 
@@ -2033,7 +2546,7 @@ struct _ats_set_subgraph_cal_data_req_t {
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_SET_CAL_DATA_NON_PERSIST ATS_ONLINE_CMD_ID(10)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_SET_CAL_DATA_NON_PERSIST */
@@ -2064,7 +2577,7 @@ struct _ats_set_subgraph_cal_data_req_t {
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_CAL_DATA_PERSIST ATS_ONLINE_CMD_ID(11)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_GET_CAL_DATA_PERSIST */
@@ -2095,7 +2608,7 @@ struct _ats_set_subgraph_cal_data_req_t {
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_SET_CAL_DATA_PERSIST ATS_ONLINE_CMD_ID(12)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_SET_CAL_DATA_PERSIST */
@@ -2126,7 +2639,7 @@ struct _ats_set_subgraph_cal_data_req_t {
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_TAG_DATA ATS_ONLINE_CMD_ID(13)
 
@@ -2182,7 +2695,7 @@ struct _ats_set_subgraph_tag_data_req_t {
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_SET_TAG_DATA ATS_ONLINE_CMD_ID(14)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_SET_TAG_DATA */
@@ -2212,7 +2725,7 @@ struct _ats_set_subgraph_tag_data_req_t {
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_DELETE_DELTA_FILES ATS_ONLINE_CMD_ID(15)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_DELETE_DELTA_FILES */
@@ -2246,7 +2759,7 @@ struct _ats_set_subgraph_tag_data_req_t {
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_IS_DELTA_DATA_SUPPORTED ATS_ONLINE_CMD_ID(16)
 
@@ -2279,7 +2792,7 @@ struct _ats_set_subgraph_tag_data_req_t {
     - AR_EFAILED -- Command execution failed.
     - AR_ENOTEXIST -- No writable path was found.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_TEMP_PATH ATS_ONLINE_CMD_ID(17)
 
@@ -2325,7 +2838,7 @@ struct ats_get_temp_path_t
     - AR_EBADPARAM -- Invalid input parameters were provided.
     - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_ACDB_REINIT ATS_ONLINE_CMD_ID(18)
 
@@ -2395,7 +2908,7 @@ struct _ats_acdb_reinit_req_t {
 *    - AR_EBADPARAM -- Invalid input parameters were provided.
 *    - AR_EFAILED -- Command execution failed.
 *
-*    \sa ats_online_ioctl
+*    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_ALL_DB_FILE_SETS ATS_ONLINE_CMD_ID(19)
 
@@ -2454,7 +2967,7 @@ typedef struct ats_cmd_get_all_db_file_sets_rsp_t
 *    - AR_EBADPARAM -- Invalid input parameters were provided.
 *    - AR_EFAILED -- Command execution failed.
 *
-*    \sa ats_online_ioctl
+*    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_SELECTED_CLIENT_DB_FILE ATS_ONLINE_CMD_ID(20)
 
@@ -2512,7 +3025,7 @@ typedef struct ats_cmd_get_selected_client_db_file_req_t
 *    - AR_EBADPARAM -- Invalid input parameters were provided.
 *    - AR_EFAILED -- Command execution failed.
 *
-*    \sa ats_online_ioctl
+*    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_SELECTED_CLIENT_DB_HEAP_INFO ATS_ONLINE_CMD_ID(21)
 
@@ -2564,7 +3077,7 @@ typedef struct ats_cmd_get_selected_client_db_heap_info_rsp_t
 *    - AR_EBADPARAM -- Invalid input parameters were provided.
 *    - AR_EFAILED -- Command execution failed.
 *
-*    \sa ats_online_ioctl
+*    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_GET_SELECTED_CLIENT_DB_HEAP_DATA ATS_ONLINE_CMD_ID(22)
 
@@ -2662,7 +3175,7 @@ typedef struct ats_cmd_get_selected_client_db_heap_data_rsp_t
 *    - AR_EBADPARAM -- Invalid input parameters were provided.
 *    - AR_EFAILED -- Command execution failed.
 *
-*    \sa ats_online_ioctl
+*    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_CHECK_SELECTED_CLIENT_CONNECTION ATS_ONLINE_CMD_ID(23)
 
@@ -2699,7 +3212,7 @@ typedef struct ats_cmd_check_selcted_client_connection_req_t {
 *    - AR_EBADPARAM -- Invalid input parameters were provided.
 *    - AR_EFAILED -- Command execution failed.
 *
-*    \sa ats_online_ioctl
+*    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_SELECTED_CLIENT_DB_REINIT ATS_ONLINE_CMD_ID(24)
 
@@ -2742,7 +3255,7 @@ typedef struct ats_cmd_selected_client_db_reinit_req_t {
  *        - AR_EBADPARAM -- Invalid input parameters were provided.
  *        - AR_EFAILED -- Command execution failed.
  *
- *    \sa ats_online_ioctl
+ *    \sa ats_online_cmd_table
  */
 #define ATS_CMD_ONC_SET_CAL_DATA_NON_PERSIST_2 ATS_ONLINE_CMD_ID(25)
 
@@ -2788,7 +3301,7 @@ struct _ats_set_cal_data_non_persist_req_t {
  *        - AR_EBADPARAM -- Invalid input parameters were provided.
  *        - AR_EFAILED -- Command execution failed.
  *
- *    \sa ats_online_ioctl
+ *    \sa ats_online_cmd_table
  */
 #define ATS_CMD_ONC_SET_CAL_DATA_PERSIST_2 ATS_ONLINE_CMD_ID(26)
 
@@ -2834,7 +3347,7 @@ struct _ats_set_cal_data_persist_req_t {
  *        - AR_EBADPARAM -- Invalid input parameters were provided.
  *        - AR_EFAILED -- Command execution failed.
  *
- *    \sa ats_online_ioctl
+ *    \sa ats_online_cmd_table
  */
 #define ATS_CMD_ONC_SET_TAG_DATA_2 ATS_ONLINE_CMD_ID(27)
 
@@ -2878,7 +3391,7 @@ struct _ats_set_tag_data_req_t {
  *        - AR_EBADPARAM -- Invalid input parameters were provided.
  *        - AR_EFAILED -- Command execution failed.
  *
- *    \sa ats_dls_ioctl
+ *    \sa ats_dls_cmd_table
  */
 #define ATS_CMD_DLS_START ATS_DLS_CMD_ID(1)
 
@@ -2916,7 +3429,7 @@ struct _ats_dls_log_code_t {
  *        - AR_EBADPARAM -- Invalid input parameters were provided.
  *        - AR_EFAILED -- Command execution failed.
  *
- *    \sa ats_dls_ioctl
+ *    \sa ats_dls_cmd_table
  */
 #define ATS_CMD_DLS_STOP ATS_DLS_CMD_ID(2)
 /** @} */ /* end_addtogroup ATS_CMD_DLS_STOP */
@@ -2946,7 +3459,7 @@ struct _ats_dls_log_code_t {
  *        - AR_EBADPARAM -- Invalid input parameters were provided.
  *        - AR_EFAILED -- Command execution failed.
  *
- *    \sa ats_dls_ioctl
+ *    \sa ats_dls_cmd_table
  */
 #define ATS_CMD_DLS_CONFIGURE ATS_DLS_CMD_ID(3)
 
@@ -3013,7 +3526,7 @@ struct _ats_dls_buffer_pool_config_t {
  *        - AR_EBADPARAM -- Invalid input parameters were provided.
  *        - AR_EFAILED -- Command execution failed.
  *
- *    \sa ats_dls_ioctl
+ *    \sa ats_dls_cmd_table
  */
 #define ATS_CMD_DLS_GET_LOG_DATA ATS_DLS_CMD_ID(4)
 
@@ -3060,11 +3573,72 @@ struct _ats_dls_get_dls_log_data_header_t {
  *        - AR_EBADPARAM -- Invalid input parameters were provided.
  *        - AR_EFAILED -- Command execution failed.
  *
- *    \sa ats_dls_ioctl
+ *    \sa ats_dls_cmd_table
  */
 #define ATS_CMD_DLS_GET_VERSION ATS_DLS_CMD_ID(5)
 /** @} */ /* end_addtogroup ATS_CMD_DLS_GET_VERSION */
 
+/* ---------------------------------------------------------------------------
+* ATS_CMD_DLS_GET_STATS Declarations and Documentation
+*-------------------------------------------------------------------------- */
+/** \addtogroup ATS_CMD_DLS_GET_STATS
+\{ */
+/**
+ *    Retrieves the delivery counters of the DLS sender, which pushes log
+ *    packets to the client connected to the DLS server.
+ *
+ *    Ready log buffers are copied into a bounded send queue and returned
+ *    to the DSP right away. When the client reads slower than the DSP
+ *    logs, the queue fills up and new packets are dropped rather than
+ *    holding back DSP buffers. A client uses these counters to tell a
+ *    complete capture from one with gaps. The counters start at zero when
+ *    ATS is initialized and are never reset.
+ *
+ *    \param[in] cmd_id
+ *        Command ID is ATS_CMD_DLS_GET_STATS
+ *    \param[in] cmd
+ *        There is no input structure; set this to NULL.
+ *    \param[in] cmd_size
+ *        There is no input structure; set this to 0.
+ *    \param[out] rsp
+ *        This is a pointer to AtsDlsStats
+ *    \param[in] rsp_size
+ *        This is the size of AtsDlsStats
+ *
+ *    \return
+ *        - AR_EOK -- Command executed successfully.
+ *        - AR_EBADPARAM -- Invalid input parameters were provided.
+ *
+ *    \sa ats_dls_cmd_table
+ */
+#define ATS_CMD_DLS_GET_STATS ATS_DLS_CMD_ID(6)
+
+typedef struct _ats_dls_stats_t AtsDlsStats;
+#include "acdb_begin_pack.h"
+struct _ats_dls_stats_t {
+	/**< log packets sent to the client*/
+	uint32_t packets_sent;
+	/**< ARTM messages sent, each carries one or more log packets*/
+	uint32_t batches_sent;
+	/**< bytes sent, including ARTM headers*/
+	uint64_t bytes_sent;
+	/**< log packets lost for any reason below*/
+	uint32_t packets_dropped;
+	/**< times the send queue was full when log buffers became ready*/
+	uint32_t queue_overflows;
+	/**< sends that failed, e.g. because no client was connected*/
+	uint32_t send_failures;
+	/**< log packets waiting in the send queue*/
+	uint32_t queue_depth;
+	/**< most log packets that were ever waiting in the send queue*/
+	uint32_t peak_queue_depth;
+	/**< capacity of the send queue in log packets*/
+	uint32_t queue_capacity;
+}
+#include "acdb_end_pack.h"
+;
+/** @} */ /* end_addtogroup ATS_CMD_DLS_GET_STATS */
+
 /* ---------------------------------------------------------------------------
 * API Definitions
 *-------------------------------------------------------------------------- */
@@ -3089,6 +3663,90 @@ typedef int32_t(*ATS_CALLBACK)(
 	uint32_t rsp_buf_size,
 	uint32_t *rsp_buf_bytes_filled);
 
+/**
+* \brief ATS_STREAM_CALLBACK
+*		A function callback for service commands whose response is streamed.
+*		The callback announces the payload length with ats_rsp_stream_begin
+*		and then writes exactly that many bytes, which are sent to the client
+*		in ATS_RSP_STREAM_CHUNK_SIZE chunks.
+* \param [in] svc_cmd_id: The service command to be issued. Contains the 2 byte
+        service id and 2byte command id
+* \param [in] cmd_buf: Pointer to the command structure.
+* \param [in] cmd_buf_size: Size of the command structure
+* \param [in] rsp_stream: The response cursor
+* \return
+*		AR_EOK on success,
+*		AR_EUNSUPPORTED without calling ats_rsp_stream_begin if the command is
+*		not streamed. It is then executed through the ATS_CALLBACK of the service,
+*		other codes on failure. If ats_rsp_stream_begin was not called yet
+*		the client receives the error code, otherwise the connection is closed
+*/
+typedef int32_t(*ATS_STREAM_CALLBACK)(
+	uint32_t svc_cmd_id,
+	uint8_t *cmd_buf,
+	uint32_t cmd_buf_size,
+	AtsRspStream *rsp_stream);
+
+/**
+* \brief ATS_CMD_HANDLER
+*		Executes one command of a service. Entered through the command table
+*		of the service after ATS has checked the request and response sizes
+*		against the bounds declared for the command.
+* \param [in] cmd_buf: Pointer to the command structure. NULL when the
+*		request has no payload
+* \param [in] cmd_buf_size: Size of the command structure
+* \param [out] rsp_buf: The response structre
+* \param [in] rsp_buf_size: The size of the response
+* \param [out] rsp_buf_bytes_filled: Number of bytes written to the response buffer
+* \return 0 on success, non-zero on failure
+*/
+typedef int32_t(*ATS_CMD_HANDLER)(
+	uint8_t *cmd_buf,
+	uint32_t cmd_buf_size,
+	uint8_t *rsp_buf,
+	uint32_t rsp_buf_size,
+	uint32_t *rsp_buf_bytes_filled);
+
+/**< No upper bound on the request size of a command */
+#define ATS_CMD_SIZE_UNBOUNDED 0xFFFFFFFFul
+
+/**< The handler takes the lock of the service itself, if at all */
+#define ATS_CMD_FLAG_SELF_LOCKING 0x1ul
+
+typedef struct _ats_cmd_entry_t AtsCmdEntry;
+struct _ats_cmd_entry_t
+{
+	/**< Executes the command, NULL if the command id is not supported */
+	ATS_CMD_HANDLER handler;
+	/**< Smallest request the handler accepts, in bytes */
+	uint32_t min_req_size;
+	/**< Largest request the handler accepts, in bytes, or ATS_CMD_SIZE_UNBOUNDED */
+	uint32_t max_req_size;
+	/**< Smallest response buffer the handler can fill, in bytes */
+	uint32_t min_rsp_size;
+	/**< ATS_CMD_FLAG_* */
+	uint32_t flags;
+};
+
+/**
+* \brief AtsCmdTable
+*		The commands of a service indexed by ATS_GET_COMMAND_ID. Commands that
+*		are not flagged ATS_CMD_FLAG_SELF_LOCKING run between lock and unlock
+*		when the service provides them.
+*/
+typedef struct _ats_cmd_table_t AtsCmdTable;
+struct _ats_cmd_table_t
+{
+	/**< Command entries, entry i handles command id i */
+	const AtsCmdEntry *entries;
+	/**< Number of entries, one more than the largest command id */
+	uint32_t entry_count;
+	/**< Serializes the commands of the service, may be NULL */
+	int32_t(*lock)(void);
+	/**< Releases the lock taken by lock, may be NULL */
+	int32_t(*unlock)(void);
+};
+
 typedef int32_t(*ATS_VERSION_CALLBACK)(
     AtsServiceInfo *service_info);
 
@@ -3129,6 +3787,19 @@ void ats_register_simulation(ATS_SIM_CALLBACK sim_callback);
 */
 int32_t ats_register_service(uint32_t service_id, ATS_CALLBACK service_callback);
 
+/**
+* \brief ats_register_service_table
+*		Registers the specified service with a table of command handlers. ATS
+*		validates the request and response sizes of each command against the
+*		table and routes it to its handler without calling into the service.
+* \param [in] service_id: The service ID of a ATS service
+* \param [in] cmd_table: The commands of the service. Must stay valid until
+*		the service is deregistered
+* \return 0 on success, non-zero on failure
+*/
+int32_t ats_register_service_table(uint32_t service_id,
+    const AtsCmdTable *cmd_table);
+
 /**
 * \brief ats_deregister_service
 *		Deregisters the specified service.
@@ -3137,6 +3808,91 @@ int32_t ats_register_service(uint32_t service_id, ATS_CALLBACK service_callback)
 */
 int32_t ats_deregister_service(uint32_t servie_id);
 
+/**
+* \brief ats_register_stream_callback
+*		Lets a registered service stream the responses of some of its commands.
+* \param [in] service_id: The service ID of a registered ATS service
+* \param [in] stream_callback: The callback used to execute streamed commands.
+* \return 0 on success, non-zero on failure
+*/
+int32_t ats_register_stream_callback(uint32_t service_id,
+    ATS_STREAM_CALLBACK stream_callback);
+
+/**
+* \brief ats_rsp_stream_begin
+*		Starts the response with a success status.
+* \param [in] rsp_stream: The response cursor
+* \param [in] data_length: The number of payload bytes that will be written
+* \return 0 on success, non-zero on failure
+*/
+int32_t ats_rsp_stream_begin(AtsRspStream *rsp_stream, uint32_t data_length);
+
+/**
+* \brief ats_rsp_stream_get_buffer
+*		Gets space to produce the next payload bytes in place. Commit what was
+*		filled with ats_rsp_stream_commit before calling any other
+*		ats_rsp_stream_* function.
+* \param [in] rsp_stream: The response cursor
+* \param [out] buffer: Where to write the next payload bytes
+* \param [out] buffer_size: The number of bytes that fit, never more than
+*		the payload bytes left to write
+* \return 0 on success, non-zero on failure
+*/
+int32_t ats_rsp_stream_get_buffer(AtsRspStream *rsp_stream,
+    uint8_t **buffer, uint32_t *buffer_size);
+
+/**
+* \brief ats_rsp_stream_commit
+*		Adds bytes written to the space from ats_rsp_stream_get_buffer to the
+*		response, sending the chunk once it is full.
+* \param [in] rsp_stream: The response cursor
+* \param [in] size: The number of bytes written
+* \return 0 on success, non-zero on failure
+*/
+int32_t ats_rsp_stream_commit(AtsRspStream *rsp_stream, uint32_t size);
+
+/**
+* \brief ats_rsp_stream_write
+*		Copies payload bytes to the response.
+* \param [in] rsp_stream: The response cursor
+* \param [in] data: The bytes to add
+* \param [in] size: The number of bytes to add
+* \return 0 on success, non-zero on failure
+*/
+int32_t ats_rsp_stream_write(AtsRspStream *rsp_stream,
+    const void *data, uint32_t size);
+
+/**
+* \brief ats_rsp_stream_send_file
+*		Adds file data to the response. The transport sends it from the file
+*		directly, so it is not copied through the ATS chunk.
+* \param [in] rsp_stream: The response cursor
+* \param [in] fd: The file to send from, see ar_fget_fd
+* \param [in] file_offset: Where in the file the data starts
+* \param [in] length: The number of bytes to add
+* \return 0 on success, AR_EUNSUPPORTED if the transport cannot send files
+*		(nothing was added), other codes on failure
+*/
+int32_t ats_rsp_stream_send_file(AtsRspStream *rsp_stream,
+    int32_t fd, uint32_t file_offset, uint32_t length);
+
+/**
+* \brief ats_execute_command_stream
+*		Executes a command whose service streams its response.
+* \sa ats_cmd_rsp_stream_callback_t
+*/
+int32_t ats_execute_command_stream(uint8_t *req_buf_ptr, uint32_t req_buf_length,
+    ats_rsp_stream_write_t write_cb, ats_rsp_stream_send_file_t send_file_cb,
+    void *transport_ctx);
+
+/**
+* \brief ats_get_client_id
+*		Gets the client whose request is being executed.
+* \return The id the transport reported the client with, 0 if the
+*		transport does not report clients, see ats_client_callback_t
+*/
+uint32_t ats_get_client_id(void);
+
 /**
 * \brief ats_get_service_info
 *		Get service information for each service registered
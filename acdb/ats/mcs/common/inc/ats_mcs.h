@@ -29,26 +29,6 @@
 * Public Functions
 *-------------------------------------------------------------------------- */
 
-/**
-* \brief
-*		The Media Control Service IOCTL
-* \param [in] svc_cmd_id: The command to be issued
-* \param [in] cmd_buf: Pointer to the command structure.
-* \param [in] cmd_buf_size: Size of the command structure
-* \param [out] rsp_buf: The response structre
-* \param [in] rsp_buf_size: The size of the response
-* \param [out] rsp_buf_bytes_filled: Number of bytes written to the response buffer
-* \return AR_EOK on success, non-zero otherwise
-*/
-int32_t ats_mcs_ioctl(
-    uint32_t svc_cmd_id,
-    uint8_t *cmd_buf,
-    uint32_t cmd_buf_size,
-    uint8_t *rsp_buf,
-    uint32_t rsp_buf_size,
-    uint32_t *rsp_buf_bytes_filled
-);
-
 /**
 * \brief
 *		Initializes the file transfer service to allow interaction between
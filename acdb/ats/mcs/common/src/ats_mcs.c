@@ -816,74 +816,41 @@ int32_t mcs_stop_2(
     return status;
 }
 
+#define MCS_CMD(cmd) ATS_GET_COMMAND_ID(ATS_CMD_MCS_##cmd)
+#define MCS_CMD_LAST MCS_CMD(STOP_2)
+
+/**< The Media Control commands. Session requests start with a 32-bit
+ * field, the stop command takes no request */
+static const AtsCmdEntry mcs_cmds[MCS_CMD_LAST + 1] = {
+    [MCS_CMD(PLAY)] = {
+        mcs_play, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [MCS_CMD(RECORD)] = {
+        mcs_rec, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [MCS_CMD(PLAY_RECORD)] = {
+        mcs_play_rec, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [MCS_CMD(STOP)] = {
+        mcs_stop, 0, ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [MCS_CMD(PLAY_2)] = {
+        mcs_play_2, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [MCS_CMD(RECORD_2)] = {
+        mcs_rec_2, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [MCS_CMD(MULTI_PLAY_REC)] = {
+        mcs_multi_play_rec, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [MCS_CMD(STOP_2)] = {
+        mcs_stop_2, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+};
+
+static const AtsCmdTable mcs_cmd_table = {
+    mcs_cmds,
+    sizeof(mcs_cmds) / sizeof(mcs_cmds[0]),
+    NULL,
+    NULL
+};
+
 /*------------------------------------------
 * Public Functions
 *------------------------------------------*/
 
-
-int32_t ats_mcs_ioctl(
-    uint32_t svc_cmd_id,
-    uint8_t *cmd_buf,
-    uint32_t cmd_buf_size,
-    uint8_t *rsp_buf,
-    uint32_t rsp_buf_size,
-    uint32_t *rsp_buf_bytes_filled
-)
-{
-    int32_t status = AR_EOK;
-
-    int32_t(*func_cb)(
-        uint8_t *cmd_buf,
-        uint32_t cmd_buf_size,
-        uint8_t *rsp_buf,
-        uint32_t rsp_buf_size,
-        uint32_t *rsp_buf_bytes_filled
-        ) = NULL;
-
-    switch (svc_cmd_id)
-    {
-    case ATS_CMD_MCS_PLAY:
-        func_cb = mcs_play;
-        break;
-    case ATS_CMD_MCS_RECORD:
-        func_cb = mcs_rec;
-        break;
-    case ATS_CMD_MCS_PLAY_RECORD:
-        func_cb = mcs_play_rec;
-        break;
-    case ATS_CMD_MCS_STOP:
-        func_cb = mcs_stop;
-        break;
-    case ATS_CMD_MCS_PLAY_2:
-        func_cb = mcs_play_2;
-        break;
-    case ATS_CMD_MCS_RECORD_2:
-        func_cb = mcs_rec_2;
-        break;
-    case ATS_CMD_MCS_MULTI_PLAY_REC:
-        func_cb = mcs_multi_play_rec;
-        break;
-    case ATS_CMD_MCS_STOP_2:
-        func_cb = mcs_stop_2;
-        break;
-    default:
-        ATS_ERR("Command[%x] is not supported", svc_cmd_id);
-        status = AR_EUNSUPPORTED;
-    }
-
-    if (status == AR_EOK)
-    {
-        status = func_cb(cmd_buf,
-            cmd_buf_size,
-            rsp_buf,
-            rsp_buf_size,
-            rsp_buf_bytes_filled);
-    }
-
-    return status;
-}
-
-
 int32_t ats_mcs_init(void)
 {
     ATS_INFO("Registering Media Control Service...");
@@ -898,7 +865,7 @@ int32_t ats_mcs_init(void)
         return status;
     }
 
-    status = ats_register_service(ATS_MCS_SERVICE_ID, ats_mcs_ioctl);
+    status = ats_register_service_table(ATS_MCS_SERVICE_ID, &mcs_cmd_table);
 
     if (AR_FAILED(status))
     {
@@ -20,6 +20,7 @@
 * Includes
 *----------------------------------------------------------------------------*/
 #include "acdb.h"
+#include "ats_i.h"
 
 /*-----------------------------------------------------------------------------
 * Defines and Constants
@@ -32,23 +33,20 @@
 *-------------------------------------------------------------------------- */
 
 /**
-* \brief ats_online_ioctl
-*		The Online Service IOCTL
-* \param [in] cmd_id: The command to be issued
+* \brief ats_online_stream_ioctl
+*		The Online Service IOCTL for commands whose response is streamed
+* \param [in] svc_cmd_id: The command to be issued
 * \param [in] cmd_buf: Pointer to the command structure.
-* \param [in] cmd_buf_size:
-* \param [out] rsp_buf: The response structre
-* \param [in] rsp_buf_size: The size of the response
-* \param [out] rsp_buf_bytes_filled: Number of bytes written to the response buffer
-* \return 0 on success, non-zero on failure
+* \param [in] cmd_buf_size: Size of the command structure
+* \param [in] rsp_stream: The response cursor
+* \return 0 on success, AR_EUNSUPPORTED if the command is not streamed,
+*		other codes on failure
 */
-int32_t ats_online_ioctl(
+int32_t ats_online_stream_ioctl(
 	uint32_t svc_cmd_id,
 	uint8_t *cmd_buf,
 	uint32_t cmd_buf_size,
-	uint8_t *rsp_buf,
-	uint32_t rsp_buf_size,
-	uint32_t *rsp_buf_bytes_filled
+	AtsRspStream *rsp_stream
 );
 
 /**
@@ -23,7 +23,9 @@
 #include "ats_common.h"
 #include "ats_command.h"
 #include "ar_osal_mutex.h"
+#include "ar_osal_file_io.h"
 #include "acdb_common.h"
+#include "acdb_init.h"
 
 /*------------------------------------------
 * Defines and Constants
@@ -40,7 +42,7 @@ ar_osal_mutex_t acdb_client_lock;
 * \brief get_service_info
 *		Queries ATS for information about each service (FTS, MCS, RTS, ADIE, etc?)
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_get_service_info(
@@ -84,7 +86,7 @@ int32_t ats_onc_get_service_info(
 * \brief get_online_version
 *		Queries ATS for the Online Calibration service version.
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 //int32_t get_online_version(
@@ -118,7 +120,7 @@ int32_t ats_onc_get_service_info(
 * \brief check_connection
 *		Checks to see if a connection between ATS and its client can be established or is still alive.
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_check_connection(
@@ -143,7 +145,7 @@ int32_t ats_onc_check_connection(
 * \brief get_max_buffer_length
 *		Queries ATS for its maximum buffer length.
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_get_max_buffer_length(
@@ -174,7 +176,7 @@ int32_t ats_onc_get_max_buffer_length(
 * \brief set_max_buffer_length
 *		Queries ATS for its maximum buffer length.
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_set_max_buffer_length(
@@ -209,7 +211,7 @@ int32_t ats_onc_set_max_buffer_length(
 * \brief get_acdb_files_info
 *		Queries ATS for ACDB file information for all acdb files loaded into RAM.
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_get_acdb_files_info(
@@ -249,7 +251,7 @@ int32_t ats_onc_get_acdb_files_info(
 * \brief get_acdb_file
 *		Downloads the requested ACDB data file from the target.
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \sa get_acdb_files_info
 */
 int32_t ats_onc_get_acdb_file(
@@ -295,7 +297,7 @@ int32_t ats_onc_get_acdb_file(
 * \brief get_heap_entry_count
 *		Queries ATS for the number of heap entries in the ACDB SW Heap.
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_get_heap_entry_info(
@@ -323,7 +325,7 @@ int32_t ats_onc_get_heap_entry_info(
 * \brief
 * Retrieves the entries in the ACDB SW Heap
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_get_heap_entry_data(
@@ -376,7 +378,7 @@ int32_t ats_onc_get_heap_entry_data(
 * Get non-persistent calibration data from the ACDB SW Heap or the data files.
 *
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_get_cal_data_non_persist(
@@ -424,7 +426,7 @@ int32_t ats_onc_get_cal_data_non_persist(
 * Set non-persistent calibration data to the ACDB SW Heap or the data files.
 *
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_set_cal_data_non_persist(
@@ -485,7 +487,7 @@ int32_t ats_onc_set_cal_data_non_persist(
 * Set non-persistent calibration data to the ACDB SW Heap or the data files.
 *
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_set_cal_data_non_persist_2(
@@ -548,7 +550,7 @@ int32_t ats_onc_set_cal_data_non_persist_2(
 * Queries ATS for persistent calibration data from the ACDB SW Heap or the data files.
 *
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_get_cal_data_persist(
@@ -595,7 +597,7 @@ int32_t ats_onc_get_cal_data_persist(
 * Set persistent calibration data to the ACDB SW Heap or the data files.
 *
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_set_cal_data_persist(
@@ -656,7 +658,7 @@ int32_t ats_onc_set_cal_data_persist(
 * Set persistent calibration data to the ACDB SW Heap or the data files.
 *
 * This version alows enabling/disabling persisting the data to the delta file.
-* \sa ats_online_ioctl, ats_onc_set_cal_data_persist
+* \sa ats_online_cmd_table, ats_onc_set_cal_data_persist
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_set_cal_data_persist_2(
@@ -719,7 +721,7 @@ int32_t ats_onc_set_cal_data_persist_2(
 * \brief
 * Get tag data from the ACDB SW Heap or the delta file(s).
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_get_tag_data(
@@ -767,7 +769,7 @@ int32_t ats_onc_get_tag_data(
 * \brief
 * Set tag data to the ACDB SW Heap or the delta file(s).
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_set_tag_data(
@@ -829,7 +831,7 @@ int32_t ats_onc_set_tag_data(
 * \brief
 * Set tag data to the ACDB SW Heap or the delta file(s).
 * This version alows enabling/disabling persisting the data to the delta file.
-* \sa ats_online_ioctl, ats_onc_set_tag_data
+* \sa ats_online_cmd_table, ats_onc_set_tag_data
 *
 * \return 0 on success, non-zero on failure
 */
@@ -894,7 +896,7 @@ int32_t ats_onc_set_tag_data_2(
 * \brief delete_delta_files
 * Removes the *.acdbdelta files from the targets file system
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_delete_delta_files(
@@ -921,7 +923,7 @@ int32_t ats_onc_delete_delta_files(
 * \brief
 * Check to see if the target supports delta data persistence.
 *
-* \sa ats_online_ioctl
+* \sa ats_online_cmd_table
 * \return 0 on success, non-zero on failure
 */
 int32_t ats_onc_is_delta_data_supported(
@@ -1008,6 +1010,36 @@ int32_t acdb_soft_reset(void)
     return status;
 }
 
+/**
+* \brief
+*   Reloads a loaded database from its file set without tearing down ACDB SW.
+*   ACDB clients are only blocked while the new *.acdb file is swapped in.
+*
+* \param [in] acdb_files: the *.qwsp and *.acdb files of the database
+* \param [in] num_files: the number of files in acdb_files
+* \param [in] acdb_handle: the database the files belong to, or NULL
+* \return AR_EOK if the database was reloaded or is unchanged,
+*   AR_EUNSUPPORTED if the database has to be reinitialized
+*/
+static int32_t ats_onc_reload_database(AcdbFile *acdb_files,
+    uint32_t num_files, acdb_handle_t acdb_handle)
+{
+    acdb_init_reload_database_req_t req = { 0 };
+
+    req.acdb_handle = acdb_handle;
+    req.database_paths.num_files = num_files;
+    for (uint32_t i = 0; i < num_files; i++)
+    {
+        req.database_paths.acdb_data_files[i].path_length =
+            acdb_files[i].fileNameLen;
+        req.database_paths.acdb_data_files[i].path =
+            &acdb_files[i].fileName[0];
+    }
+
+    return acdb_init_ioctl(ACDB_INIT_CMD_RELOAD_DATABASE,
+        &req, sizeof(acdb_init_reload_database_req_t), NULL, 0);
+}
+
 int32_t ats_onc_reinit_acdb(
     uint8_t *cmd_buf,
     uint32_t cmd_buf_size,
@@ -1026,6 +1058,8 @@ int32_t ats_onc_reinit_acdb(
     AcdbFile delta_file_path = { 0 };
     AtsAcdbReinitReq *req = NULL;
     AtsGetTempPath path = { 0 };
+    uint32_t free_file_slots = 0;
+    bool_t is_locked = FALSE;
 
     *rsp_buf_bytes_filled = 0;
 
@@ -1068,17 +1102,6 @@ int32_t ats_onc_reinit_acdb(
         &cmd_buf[offset], sizeof(uint32_t));
     offset += sizeof(uint32_t);
 
-    path.path = delta_file_path.fileName;
-    status = AtsCmdGetTempFilePath(
-        ACDB_CTX_MAN_DEFAULT_DB_HANDLE, &path);
-    if (AR_FAILED(status))
-    {
-        ATS_ERR("Error[%d]: Failed to get temp file path from File Manager.");
-        goto end;
-    }
-
-    delta_file_path.fileNameLen = path.path_len;
-
     if (req->is_delta_data_supported)
     {
         status = acdb_ioctl((uint32_t)ACDB_CMD_ENABLE_PERSISTANCE,
@@ -1090,6 +1113,32 @@ int32_t ats_onc_reinit_acdb(
         }
     }
 
+    /* A file set that replaces the only loaded database with newer
+     * versions of the same files is reloaded in place */
+    status = acdb_ctx_man_ioctl(ACDB_CTX_MAN_CMD_GET_AVAILABLE_FILE_SLOTS,
+        NULL, 0, &free_file_slots, sizeof(uint32_t));
+    if (AR_SUCCEEDED(status) && ACDB_MAX_ACDB_FILES - 1 == free_file_slots)
+    {
+        status = ats_onc_reload_database(req->acdb_files.acdbFiles,
+            req->acdb_files.num_files, NULL);
+        if (AR_EUNSUPPORTED != status)
+            goto end;
+    }
+
+    ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    is_locked = TRUE;
+
+    path.path = delta_file_path.fileName;
+    status = AtsCmdGetTempFilePath(
+        ACDB_CTX_MAN_DEFAULT_DB_HANDLE, &path);
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to get temp file path from File Manager.");
+        goto end;
+    }
+
+    delta_file_path.fileNameLen = path.path_len;
+
     ATS_INFO("Re-initializing ACDB SW..");
 
     status = acdb_deinit();
@@ -1107,6 +1156,11 @@ int32_t ats_onc_reinit_acdb(
     }
 
 end:
+    if (is_locked)
+    {
+        ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    }
+
     ACDB_FREE(req);
 
     return status;
@@ -1180,6 +1234,190 @@ int32_t ats_onc_get_selected_acdb_file(uint8_t* cmd_buf,
     return status;
 }
 
+/**
+* \brief send_file_data
+*		Sends the requested range of a loaded *.acdb or *.qwsp file straight
+*		from the file when the transport supports it. The file is opened
+*		under the client lock and sent after it is released.
+*
+* \sa ats_onc_stream_file_data
+* \return 0 on success, AR_EUNSUPPORTED if the file has to be copied
+*		(nothing was sent), other codes on failure
+*/
+static int32_t ats_onc_send_file_data(
+    AcdbFileManGetFileDataReq *req,
+    AtsRspStream *rsp_stream)
+{
+    int32_t status = AR_EOK;
+    int32_t fd = -1;
+    AcdbFileManFileRegion region = { 0 };
+
+    if (IsNull(rsp_stream->send_file))
+        return AR_EUNSUPPORTED;
+
+    ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    status = AtsCmdOpenLoadedFile(req, &region);
+    ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    if (AR_FAILED(status))
+        return status;
+
+    status = ar_fget_fd(region.file_handle, &fd);
+    if (AR_FAILED(status))
+    {
+        status = AR_EUNSUPPORTED;
+        goto end;
+    }
+
+    status = ats_rsp_stream_begin(rsp_stream, region.file_data_len);
+    if (AR_FAILED(status))
+        goto end;
+
+    if (region.file_data_len > 0)
+    {
+        status = ats_rsp_stream_send_file(rsp_stream, fd,
+            region.file_offset, region.file_data_len);
+    }
+
+end:
+    (void)ar_fclose(region.file_handle);
+    return status;
+}
+
+/**
+* \brief stream_file_data
+*		Streams the requested range of a loaded *.acdb or *.qwsp file one
+*		chunk at a time. The client lock is held for the whole transfer so a
+*		reinit cannot swap the file in the middle of it. Transports queue the
+*		chunks rather than wait for the ATS client to read them, so ACDB
+*		clients are only held up while the file is copied.
+*
+* \sa ats_onc_stream_acdb_file, ats_onc_stream_selected_acdb_file
+* \return 0 on success, non-zero on failure
+*/
+static int32_t ats_onc_stream_file_data(
+    AcdbFileManGetFileDataReq *req,
+    AtsRspStream *rsp_stream)
+{
+    int32_t status = AR_EOK;
+    AcdbFileManBlob rsp = { 0 };
+    AcdbFileManGetFileDataReq chunk_req = { 0 };
+    uint32_t remaining = 0;
+    uint32_t offset = 0;
+    uint8_t *buf = NULL;
+    uint32_t buf_size = 0;
+
+    status = ats_onc_send_file_data(req, rsp_stream);
+    if (AR_EUNSUPPORTED != status || rsp_stream->started)
+        return status;
+
+    ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+
+    /* A NULL buffer returns the length clamped to the end of the file */
+    status = AtsCmdGetLoadedFileData(req, &rsp);
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to retrieve loaded acdb file info", status);
+        goto end;
+    }
+
+    status = ats_rsp_stream_begin(rsp_stream, rsp.bytes_filled);
+    if (AR_FAILED(status))
+        goto end;
+
+    chunk_req = *req;
+    offset = req->file_offset;
+    remaining = rsp.bytes_filled;
+    while (remaining > 0)
+    {
+        status = ats_rsp_stream_get_buffer(rsp_stream, &buf, &buf_size);
+        if (AR_FAILED(status))
+            goto end;
+
+        /* The read may move file_offset, so set it for every chunk */
+        chunk_req.file_offset = offset;
+        chunk_req.file_data_len = buf_size;
+        rsp.buf = buf;
+        rsp.size = buf_size;
+        rsp.bytes_filled = 0;
+
+        status = AtsCmdGetLoadedFileData(&chunk_req, &rsp);
+        if (AR_FAILED(status))
+            goto end;
+
+        if (0 == rsp.bytes_filled)
+        {
+            status = AR_EFAILED;
+            ATS_ERR("Error[%d]: File ended %d bytes early",
+                status, remaining);
+            goto end;
+        }
+
+        status = ats_rsp_stream_commit(rsp_stream, rsp.bytes_filled);
+        if (AR_FAILED(status))
+            goto end;
+
+        offset += rsp.bytes_filled;
+        remaining -= rsp.bytes_filled;
+    }
+
+end:
+    ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    return status;
+}
+
+/**
+* \brief stream_acdb_file
+*		Streamed version of get_acdb_file.
+*
+* \sa ats_online_stream_ioctl
+*/
+static int32_t ats_onc_stream_acdb_file(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    AtsRspStream *rsp_stream)
+{
+    AcdbFileManGetFileDataReq req = { 0 };
+    uint32_t sz_request = sizeof(AcdbFileManGetFileDataReq)
+        - sizeof(size_t) - sizeof(req.acdb_handle);
+
+    if (IsNull(cmd_buf) || cmd_buf_size <= sz_request)
+    {
+        return AR_EBADPARAM;
+    }
+
+    ACDB_MEM_CPY_SAFE((uint8_t*)&req + sizeof(req.acdb_handle),
+        sz_request, cmd_buf, sz_request);
+    req.file_name = &cmd_buf[sz_request];
+    req.acdb_handle = 0;
+
+    return ats_onc_stream_file_data(&req, rsp_stream);
+}
+
+/**
+* \brief stream_selected_acdb_file
+*		Streamed version of get_selected_acdb_file.
+*
+* \sa ats_online_stream_ioctl
+*/
+static int32_t ats_onc_stream_selected_acdb_file(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    AtsRspStream *rsp_stream)
+{
+    AcdbFileManGetFileDataReq req = { 0 };
+    uint32_t sz_request = sizeof(AcdbFileManGetFileDataReq) - sizeof(size_t);
+
+    if (IsNull(cmd_buf) || cmd_buf_size <= sz_request)
+    {
+        return AR_EBADPARAM;
+    }
+
+    ACDB_MEM_CPY_SAFE(&req, sz_request, cmd_buf, sz_request);
+    req.file_name = &cmd_buf[sz_request];
+
+    return ats_onc_stream_file_data(&req, rsp_stream);
+}
+
 int32_t ats_onc_get_selected_heap_entry_info(uint8_t* cmd_buf,
     uint32_t cmd_buf_size,
     uint8_t* rsp_buf,
@@ -1274,6 +1512,7 @@ int32_t ats_onc_acdb_reinit_selected_database(uint8_t* cmd_buf,
     ats_cmd_selected_client_db_reinit_req_t* req = NULL;
     AtsGetTempPath path = { 0 };
     acdb_handle_t acdb_handle = NULL;
+    bool_t is_locked = FALSE;
 
     *rsp_buf_bytes_filled = 0;
 
@@ -1310,28 +1549,36 @@ int32_t ats_onc_acdb_reinit_selected_database(uint8_t* cmd_buf,
         offset += req->acdb_files.database_files[i].fileNameLen;
     }
 
-    path.path = writable_path.fileName;
-    status = AtsCmdGetTempFilePath(req->acdb_handle, &path);
+    status = acdb_ctx_man_ioctl(ACDB_CTX_MAN_CMD_GET_ACDB_CLIENT_HANDLE,
+        &req->acdb_handle, sizeof(uint32_t),
+        &acdb_handle, sizeof(acdb_handle_t));
     if (AR_FAILED(status))
     {
-        ATS_ERR("Error[%d]: Failed to get temp file path from File Manager.");
+        ATS_ERR("Error[%d]: An error occured getting client "
+            "database handle for VM-%d.", status, req->acdb_handle);
         goto end;
     }
 
-    writable_path.fileNameLen = path.path_len;
+    status = ats_onc_reload_database(req->acdb_files.database_files,
+        req->acdb_files.num_files, acdb_handle);
+    if (AR_EUNSUPPORTED != status)
+        goto end;
 
-    ATS_INFO("Re-initializing database for VM-%d..", req->acdb_handle);
+    ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    is_locked = TRUE;
 
-    status = acdb_ctx_man_ioctl(ACDB_CTX_MAN_CMD_GET_ACDB_CLIENT_HANDLE,
-        &req->acdb_handle, sizeof(uint32_t),
-        &acdb_handle, sizeof(acdb_handle_t));
+    path.path = writable_path.fileName;
+    status = AtsCmdGetTempFilePath(req->acdb_handle, &path);
     if (AR_FAILED(status))
     {
-        ATS_ERR("Error[%d]: An error occured getting client "
-            "database handle for VM-%d.", status, req->acdb_handle);
+        ATS_ERR("Error[%d]: Failed to get temp file path from File Manager.");
         goto end;
     }
 
+    writable_path.fileNameLen = path.path_len;
+
+    ATS_INFO("Re-initializing database for VM-%d..", req->acdb_handle);
+
     status = acdb_remove_database(&acdb_handle);
     if (AR_FAILED(status))
     {
@@ -1349,6 +1596,11 @@ int32_t ats_onc_acdb_reinit_selected_database(uint8_t* cmd_buf,
     }
 
 end:
+    if (is_locked)
+    {
+        ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    }
+
     ACDB_FREE(req);
 
     return status;
@@ -1382,143 +1634,122 @@ int32_t ats_onc_check_selected_database_connection(uint8_t* cmd_buf,
     return status;
 }
 
+static int32_t ats_online_lock(void)
+{
+    ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    return AR_EOK;
+}
+
+static int32_t ats_online_unlock(void)
+{
+    ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+    return AR_EOK;
+}
+
+#define ATS_ONC_CMD(cmd) ATS_GET_COMMAND_ID(ATS_CMD_ONC_##cmd)
+#define ATS_ONC_CMD_LAST ATS_ONC_CMD(SET_TAG_DATA_2)
+
+/**< The Online Service commands. Requests that carry data start with at
+ * least one 32-bit field. The reinit commands load the new files before
+ * taking the client lock so they are flagged self-locking */
+static const AtsCmdEntry ats_online_cmds[ATS_ONC_CMD_LAST + 1] = {
+    [ATS_ONC_CMD(GET_SERVICE_INFO)] = {
+        ats_onc_get_service_info, 0, ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_ONC_CMD(CHECK_CONNECTION)] = {
+        ats_onc_check_connection, 0, ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_MAX_BUFFER_LENGTH)] = {
+        ats_onc_get_max_buffer_length, 0, ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_ONC_CMD(SET_MAX_BUFFER_LENGTH)] = {
+        ats_onc_set_max_buffer_length, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_ONC_CMD(GET_ACDB_FILES_INFO)] = {
+        ats_onc_get_acdb_files_info, 0, ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_ACDB_FILE)] = {
+        ats_onc_get_acdb_file, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_HEAP_ENTRY_INFO)] = {
+        ats_onc_get_heap_entry_info, 0, ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_HEAP_ENTRY_DATA)] = {
+        ats_onc_get_heap_entry_data, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_ONC_CMD(GET_CAL_DATA_NON_PERSIST)] = {
+        ats_onc_get_cal_data_non_persist, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(SET_CAL_DATA_NON_PERSIST)] = {
+        ats_onc_set_cal_data_non_persist, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_CAL_DATA_PERSIST)] = {
+        ats_onc_get_cal_data_persist, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(SET_CAL_DATA_PERSIST)] = {
+        ats_onc_set_cal_data_persist, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_TAG_DATA)] = {
+        ats_onc_get_tag_data, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(SET_TAG_DATA)] = {
+        ats_onc_set_tag_data, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(DELETE_DELTA_FILES)] = {
+        ats_onc_delete_delta_files, 0, ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(IS_DELTA_DATA_SUPPORTED)] = {
+        ats_onc_is_delta_data_supported, 0, ATS_CMD_SIZE_UNBOUNDED, sizeof(int32_t), 0 },
+    [ATS_ONC_CMD(GET_TEMP_PATH)] = {
+        ats_onc_get_temp_file_path, 0, ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_ONC_CMD(ACDB_REINIT)] = {
+        ats_onc_reinit_acdb, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0,
+        ATS_CMD_FLAG_SELF_LOCKING },
+    [ATS_ONC_CMD(GET_ALL_DB_FILE_SETS)] = {
+        ats_onc_get_fileset_info, 0, ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_SELECTED_CLIENT_DB_FILE)] = {
+        ats_onc_get_selected_acdb_file, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_SELECTED_CLIENT_DB_HEAP_INFO)] = {
+        ats_onc_get_selected_heap_entry_info, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(GET_SELECTED_CLIENT_DB_HEAP_DATA)] = {
+        ats_onc_get_selected_heap_entry_data, 2 * sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_ONC_CMD(CHECK_SELECTED_CLIENT_CONNECTION)] = {
+        ats_onc_check_selected_database_connection, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(SELECTED_CLIENT_DB_REINIT)] = {
+        ats_onc_acdb_reinit_selected_database, 2 * sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0,
+        ATS_CMD_FLAG_SELF_LOCKING },
+    [ATS_ONC_CMD(SET_CAL_DATA_NON_PERSIST_2)] = {
+        ats_onc_set_cal_data_non_persist_2, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(SET_CAL_DATA_PERSIST_2)] = {
+        ats_onc_set_cal_data_persist_2, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_ONC_CMD(SET_TAG_DATA_2)] = {
+        ats_onc_set_tag_data_2, sizeof(uint32_t), ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+};
+
+static const AtsCmdTable ats_online_cmd_table = {
+    ats_online_cmds,
+    sizeof(ats_online_cmds) / sizeof(ats_online_cmds[0]),
+    ats_online_lock,
+    ats_online_unlock
+};
+
 /*------------------------------------------
 * Public Functions
 *------------------------------------------*/
 
 /**
-* \brief ats_online_ioctl
-*		The Online Service IOCTL
+* \brief ats_online_stream_ioctl
+*		The Online Service IOCTL for commands whose response is streamed.
+*		File downloads are streamed so a whole file is never held in memory.
 * \param [in] svc_cmd_id: The command to be issued
 * \param [in] cmd_buf: Pointer to the command structure.
 * \param [in] cmd_buf_size: Size of the command structure
-* \param [out] rsp_buf: The response structre
-* \param [in] rsp_buf_size: The size of the response
-* \param [out] rsp_buf_bytes_filled: Number of bytes written to the response buffer
-* \return 0 on success, non-zero on failure
+* \param [in] rsp_stream: The response cursor
+* \return 0 on success, AR_EUNSUPPORTED if the command is not streamed,
+*		other codes on failure
 */
-int32_t ats_online_ioctl(
+int32_t ats_online_stream_ioctl(
     uint32_t svc_cmd_id,
     uint8_t *cmd_buf,
     uint32_t cmd_buf_size,
-    uint8_t *rsp_buf,
-    uint32_t rsp_buf_size,
-    uint32_t *rsp_buf_bytes_filled
+    AtsRspStream *rsp_stream
 )
 {
-    int32_t status = AR_EOK;
-
-    int32_t(*func_cb)(
-        uint8_t *cmd_buf,
-        uint32_t cmd_buf_size,
-        uint8_t *rsp_buf,
-        uint32_t rsp_buf_size,
-        uint32_t *rsp_buf_bytes_filled
-        ) = NULL;
-
     switch (svc_cmd_id)
     {
-    case ATS_CMD_ONC_GET_SERVICE_INFO:
-        func_cb = ats_onc_get_service_info;
-        break;
-    case ATS_CMD_ONC_CHECK_CONNECTION:
-        func_cb = ats_onc_check_connection;
-        break;
-    case ATS_CMD_ONC_GET_MAX_BUFFER_LENGTH:
-        func_cb = ats_onc_get_max_buffer_length;
-        break;
-    case ATS_CMD_ONC_SET_MAX_BUFFER_LENGTH:
-        func_cb = ats_onc_set_max_buffer_length;
-        break;
-    case ATS_CMD_ONC_GET_ACDB_FILES_INFO:
-        func_cb = ats_onc_get_acdb_files_info;
-        break;
     case ATS_CMD_ONC_GET_ACDB_FILE:
-        func_cb = ats_onc_get_acdb_file;
-        break;
-    case ATS_CMD_ONC_GET_HEAP_ENTRY_INFO:
-        func_cb = ats_onc_get_heap_entry_info;
-        break;
-    case ATS_CMD_ONC_GET_HEAP_ENTRY_DATA:
-        func_cb = ats_onc_get_heap_entry_data;
-        break;
-    case ATS_CMD_ONC_GET_CAL_DATA_NON_PERSIST:
-        func_cb = ats_onc_get_cal_data_non_persist;
-        break;
-    case ATS_CMD_ONC_SET_CAL_DATA_NON_PERSIST:
-        func_cb = ats_onc_set_cal_data_non_persist;
-        break;
-    case ATS_CMD_ONC_SET_CAL_DATA_NON_PERSIST_2:
-        func_cb = ats_onc_set_cal_data_non_persist_2;
-        break;
-    case ATS_CMD_ONC_GET_CAL_DATA_PERSIST:
-        func_cb = ats_onc_get_cal_data_persist;
-        break;
-    case ATS_CMD_ONC_SET_CAL_DATA_PERSIST:
-        func_cb = ats_onc_set_cal_data_persist;
-        break;
-    case ATS_CMD_ONC_SET_CAL_DATA_PERSIST_2:
-        func_cb = ats_onc_set_cal_data_persist_2;
-        break;
-    case ATS_CMD_ONC_GET_TAG_DATA:
-        func_cb = ats_onc_get_tag_data;
-        break;
-    case ATS_CMD_ONC_SET_TAG_DATA:
-        func_cb = ats_onc_set_tag_data;
-        break;
-    case ATS_CMD_ONC_SET_TAG_DATA_2:
-        func_cb = ats_onc_set_tag_data_2;
-        break;
-    case ATS_CMD_ONC_DELETE_DELTA_FILES:
-        func_cb = ats_onc_delete_delta_files;
-        break;
-    case ATS_CMD_ONC_IS_DELTA_DATA_SUPPORTED:
-        func_cb = ats_onc_is_delta_data_supported;
-        break;
-    case ATS_CMD_ONC_GET_TEMP_PATH:
-        func_cb = ats_onc_get_temp_file_path;
-        break;
-    case ATS_CMD_ONC_ACDB_REINIT:
-        func_cb = ats_onc_reinit_acdb;
-        break;
-    case ATS_CMD_ONC_GET_ALL_DB_FILE_SETS:
-        func_cb = ats_onc_get_fileset_info;
-        break;
+        return ats_onc_stream_acdb_file(cmd_buf, cmd_buf_size, rsp_stream);
     case ATS_CMD_ONC_GET_SELECTED_CLIENT_DB_FILE:
-        func_cb = ats_onc_get_selected_acdb_file;
-        break;
-    case ATS_CMD_ONC_GET_SELECTED_CLIENT_DB_HEAP_INFO:
-        func_cb = ats_onc_get_selected_heap_entry_info;
-        break;
-    case ATS_CMD_ONC_GET_SELECTED_CLIENT_DB_HEAP_DATA:
-        func_cb = ats_onc_get_selected_heap_entry_data;
-        break;
-    case ATS_CMD_ONC_SELECTED_CLIENT_DB_REINIT:
-        func_cb = ats_onc_acdb_reinit_selected_database;
-        break;
-    case ATS_CMD_ONC_CHECK_SELECTED_CLIENT_CONNECTION:
-        func_cb = ats_onc_check_selected_database_connection;
-        break;
+        return ats_onc_stream_selected_acdb_file(cmd_buf, cmd_buf_size, rsp_stream);
     default:
-        status = AR_EUNSUPPORTED;
-        ATS_ERR("Error[%d]: Command[%x] is not supported",
-            status, svc_cmd_id);
-    }
-
-    if (status == AR_EOK)
-    {
-        ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
-
-        status = func_cb(cmd_buf,
-            cmd_buf_size,
-            rsp_buf,
-            rsp_buf_size,
-            rsp_buf_bytes_filled);
-
-        ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+        /* Executed through ats_online_cmd_table */
+        return AR_EUNSUPPORTED;
     }
-
-    return status;
 }
 
 /**
@@ -1533,11 +1764,22 @@ int32_t ats_online_init(void)
 
     int32_t status = AR_EOK;
 
-    status = ats_register_service(ATS_ONLINE_SERVICE_ID, ats_online_ioctl);
+    status = ats_register_service_table(ATS_ONLINE_SERVICE_ID,
+        &ats_online_cmd_table);
 
     if (AR_FAILED(status))
     {
         ATS_DBG_MSG_1("Failed to register the Online Service.", status, 0);
+        return status;
+    }
+
+    status = ats_register_stream_callback(ATS_ONLINE_SERVICE_ID,
+        ats_online_stream_ioctl);
+    if (AR_FAILED(status))
+    {
+        /* File downloads fall back to the ATS buffer */
+        ATS_ERR("Error[%d]: Failed to enable streamed file downloads", status);
+        status = AR_EOK;
     }
 
     return status;
@@ -205,6 +205,18 @@ int32_t gsl_rtc_set_non_persist_data(struct gsl_rtc_param *rtc_persist_param)
     return 0;
 }
 
+int32_t gsl_rtc_get_non_persist_data_bulk(struct gsl_rtc_bulk_param *rtc_param)
+{
+    __UNREFERENCED_PARAM(rtc_param);
+    return 0;
+}
+
+int32_t gsl_rtc_set_non_persist_data_bulk(struct gsl_rtc_bulk_param *rtc_param)
+{
+    __UNREFERENCED_PARAM(rtc_param);
+    return 0;
+}
+
 int32_t gsl_rtc_change_graph(struct gsl_rtc_change_graph_info *rtc_persist_param)
 {
     __UNREFERENCED_PARAM(rtc_persist_param);
@@ -524,6 +536,150 @@ int32_t ats_rtc_set_non_persistent_caldata(
     return status;
 }
 
+/**
+* \brief
+*		Reads the request header of a bulk calibration command and points
+*		the GSL bulk parameter at the entry list in the command buffer.
+*
+* \return AR_EOK, AR_EBADPARAM
+*/
+static int32_t ats_rtc_get_bulk_param(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    struct gsl_rtc_bulk_param *bulk_param)
+{
+    uint32_t sz_bulk_req_header = sizeof(bulk_param->num_entries)
+        + sizeof(bulk_param->total_size);
+
+    if (IsNull(cmd_buf) || cmd_buf_size < sz_bulk_req_header)
+    {
+        ATS_ERR("Error[%d]: The bulk request is too small", AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    ATS_MEM_CPY_SAFE(&bulk_param->num_entries, sizeof(bulk_param->num_entries),
+        cmd_buf, sizeof(bulk_param->num_entries));
+    ATS_MEM_CPY_SAFE(&bulk_param->total_size, sizeof(bulk_param->total_size),
+        cmd_buf + sizeof(bulk_param->num_entries),
+        sizeof(bulk_param->total_size));
+
+    if (bulk_param->total_size > cmd_buf_size - sz_bulk_req_header)
+    {
+        ATS_ERR("Error[%d]: Entry list size %d exceeds the request size %d",
+            AR_EBADPARAM, bulk_param->total_size, cmd_buf_size);
+        return AR_EBADPARAM;
+    }
+
+    bulk_param->entries = cmd_buf + sz_bulk_req_header;
+    return AR_EOK;
+}
+
+int32_t ats_rtc_get_non_persistent_caldata_bulk(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    uint8_t *rsp_buf,
+    uint32_t rsp_buf_size,
+    uint32_t *rsp_buf_bytes_filled)
+{
+    int32_t status = AR_EOK;
+    struct gsl_rtc_bulk_param bulk_param = { 0 };
+
+    status = ats_rtc_get_bulk_param(cmd_buf, cmd_buf_size, &bulk_param);
+    if (AR_FAILED(status))
+        return status;
+
+    if (sizeof(bulk_param.total_size) + bulk_param.total_size > rsp_buf_size)
+    {
+        ATS_ERR("Error[%d]: The response buffer is too small for %d bytes "
+            "of calibration", AR_ENEEDMORE, bulk_param.total_size);
+        return AR_ENEEDMORE;
+    }
+
+    /* Entries are read in place; each carries its own error code back */
+    status = gsl_rtc_get_non_persist_data_bulk(&bulk_param);
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to get realtime non-persistent calibration "
+            "data for one or more of %d entries", status, bulk_param.num_entries);
+    }
+
+    ATS_MEM_CPY_SAFE(
+        rsp_buf, sizeof(bulk_param.total_size),
+        &bulk_param.total_size, sizeof(bulk_param.total_size));
+    ATS_MEM_CPY_SAFE(
+        rsp_buf + sizeof(bulk_param.total_size),
+        bulk_param.total_size,
+        bulk_param.entries,
+        bulk_param.total_size);
+
+    *rsp_buf_bytes_filled = sizeof(bulk_param.total_size) + bulk_param.total_size;
+
+    return status;
+}
+
+int32_t ats_rtc_set_non_persistent_caldata_bulk(
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    uint8_t *rsp_buf,
+    uint32_t rsp_buf_size,
+    uint32_t *rsp_buf_bytes_filled)
+{
+    int32_t status = AR_EOK;
+    struct gsl_rtc_bulk_param bulk_param = { 0 };
+    AtsRtBulkCalEntry entry = { 0 };
+    uint32_t offset = 0;
+    uint32_t i = 0;
+
+    status = ats_rtc_get_bulk_param(cmd_buf, cmd_buf_size, &bulk_param);
+    if (AR_FAILED(status))
+        return status;
+
+    if (rsp_buf_size < sizeof(uint32_t) || bulk_param.num_entries >
+        (rsp_buf_size - sizeof(uint32_t)) / sizeof(uint32_t))
+    {
+        ATS_ERR("Error[%d]: The response buffer is too small for %d entries",
+            AR_ENEEDMORE, bulk_param.num_entries);
+        return AR_ENEEDMORE;
+    }
+
+    status = gsl_rtc_set_non_persist_data_bulk(&bulk_param);
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to set realtime non-persistent calibration "
+            "data for one or more of %d entries", status, bulk_param.num_entries);
+    }
+
+    /* Return only the per entry error codes, the payloads are not needed */
+    ATS_MEM_CPY_SAFE(rsp_buf, sizeof(uint32_t),
+        &bulk_param.num_entries, sizeof(uint32_t));
+    for (i = 0; i < bulk_param.num_entries; i++)
+    {
+        if (bulk_param.total_size - offset < sizeof(entry))
+            break;
+
+        ATS_MEM_CPY_SAFE(&entry, sizeof(entry),
+            bulk_param.entries + offset, sizeof(entry));
+        if (entry.param_size > bulk_param.total_size - offset - sizeof(entry))
+            break;
+
+        ATS_MEM_CPY_SAFE(rsp_buf + sizeof(uint32_t) * (i + 1), sizeof(uint32_t),
+            &entry.error_code, sizeof(uint32_t));
+        offset += sizeof(entry) + entry.param_size;
+    }
+
+    /* Entries that could not be parsed were never sent */
+    for (; i < bulk_param.num_entries; i++)
+    {
+        entry.error_code = AR_EBADPARAM;
+        ATS_MEM_CPY_SAFE(rsp_buf + sizeof(uint32_t) * (i + 1), sizeof(uint32_t),
+            &entry.error_code, sizeof(uint32_t));
+    }
+
+    *rsp_buf_bytes_filled = sizeof(uint32_t) * (bulk_param.num_entries + 1);
+
+    return status;
+}
+
 int32_t ats_rtc_set_persistent_caldata(
     uint8_t *cmd_buf,
     uint32_t cmd_buf_size,
@@ -940,83 +1096,61 @@ int32_t ats_rt_notify_connection_state(
     return status;
 }
 
-int32_t ats_rtc_ioctl(
-    uint32_t svc_cmd_id,
-    uint8_t *cmd_buf,
-    uint32_t cmd_buf_size,
-    uint8_t *rsp_buf,
-    uint32_t rsp_buf_size,
-    uint32_t *rsp_buf_bytes_filled
-)
-{
-    int32_t status = AR_EOK;
-
-    int32_t(*func_cb)(
-        uint8_t *cmd_buf,
-        uint32_t cmd_buf_size,
-        uint8_t *rsp_buf,
-        uint32_t rsp_buf_size,
-        uint32_t *rsp_buf_bytes_filled
-        ) = NULL;
-
-    switch (svc_cmd_id)
-    {
-        //case ATS_CMD_RT_GET_VERSION:
-        //	func_cb = get_rtc_version;
-        //	break;
-    case ATS_CMD_RT_GET_ACTIVE_INFO:
-        func_cb = ats_rtc_get_active_usecase_info;
-        break;
-    case ATS_CMD_RT_GET_CAL_DATA_NON_PERSISTENT:
-        func_cb = ats_rtc_get_non_persistent_caldata;
-        break;
-    case ATS_CMD_RT_GET_CAL_DATA_PERSISTENT:
-        func_cb = ats_rtc_get_persistent_caldata;
-        break;
-        //case ATS_CMD_RT_GET_CAL_DATA_GBL_PERSISTENT:
-        //	func_cb = NULL;
-        //	break;
-    case ATS_CMD_RT_SET_CAL_DATA_NON_PERSISTENT:
-        func_cb = ats_rtc_set_non_persistent_caldata;
-        break;
-    case ATS_CMD_RT_SET_CAL_DATA_PERSISTENT:
-        func_cb = ats_rtc_set_persistent_caldata;
-        break;
-    case ATS_CMD_RT_GM_PREPARE_CHANGE_GRAPH:
-        func_cb = ats_rtgm_prepare_change_graph;
-        break;
-    case ATS_CMD_RT_GM_CHANGE_GRAPH:
-        func_cb = ats_rtgm_change_graph;
-        break;
-    case ATS_CMD_RT_OPEN_GRAPH:
-        func_cb = ats_rt_graph_open;
-        break;
-    case ATS_CMD_RT_CLOSE_GRAPH:
-        func_cb = ats_rt_graph_close;
-        break;
-        case ATS_CMD_RT_NOTIFY_CONNECTION_STATE:
-            func_cb = ats_rt_notify_connection_state;
-            break;
-    case ATS_CMD_RT_GET_CAL_DATA_PERSISTENT_V2:
-        func_cb = ats_rtc_get_persistent_caldata_v2;
-        break;
-    case ATS_CMD_RT_SET_CAL_DATA_PERSISTENT_V2:
-        func_cb = ats_rtc_set_persistent_caldata_v2;
-        break;
-    default:
-        status = AR_EUNSUPPORTED;
-        ATS_ERR("Error[%d]: Command[%x] is not supported", svc_cmd_id, status);
-        break;
-    }
-
-    if (!AR_FAILED(status))
-    {
-        status = func_cb(cmd_buf, cmd_buf_size,
-            rsp_buf, rsp_buf_size, rsp_buf_bytes_filled);
-    }
+#define ATS_RTC_CMD(cmd) ATS_GET_COMMAND_ID(ATS_CMD_RT_##cmd)
+#define ATS_RTC_CMD_LAST ATS_RTC_CMD(SET_CAL_DATA_NON_PERSISTENT_BULK)
+
+/**< The Realtime Calibration commands. The minimum request sizes cover the
+ * fixed fields each handler reads before parsing variable length data */
+static const AtsCmdEntry ats_rtc_cmds[ATS_RTC_CMD_LAST + 1] = {
+    [ATS_RTC_CMD(GET_ACTIVE_INFO)] = {
+        ats_rtc_get_active_usecase_info, 0, ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(GET_CAL_DATA_NON_PERSISTENT)] = {
+        ats_rtc_get_non_persistent_caldata, 3 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_RTC_CMD(GET_CAL_DATA_PERSISTENT)] = {
+        ats_rtc_get_persistent_caldata, 3 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(SET_CAL_DATA_NON_PERSISTENT)] = {
+        ats_rtc_set_non_persistent_caldata, 3 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(SET_CAL_DATA_PERSISTENT)] = {
+        ats_rtc_set_persistent_caldata, 4 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(GM_PREPARE_CHANGE_GRAPH)] = {
+        ats_rtgm_prepare_change_graph, 5 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(GM_CHANGE_GRAPH)] = {
+        ats_rtgm_change_graph, 4 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(OPEN_GRAPH)] = {
+        ats_rt_graph_open, 2 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_RTC_CMD(CLOSE_GRAPH)] = {
+        ats_rt_graph_close, sizeof(AtsCmdRtGraphCloseReq),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(NOTIFY_CONNECTION_STATE)] = {
+        ats_rt_notify_connection_state, sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(GET_CAL_DATA_PERSISTENT_V2)] = {
+        ats_rtc_get_persistent_caldata_v2, sizeof(AtsCmdRtGetCalDataPersistV2Req),
+        ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_RTC_CMD(SET_CAL_DATA_PERSISTENT_V2)] = {
+        ats_rtc_set_persistent_caldata_v2, 4 * sizeof(uint32_t),
+        ATS_CMD_SIZE_UNBOUNDED, 0, 0 },
+    [ATS_RTC_CMD(GET_CAL_DATA_NON_PERSISTENT_BULK)] = {
+        ats_rtc_get_non_persistent_caldata_bulk, sizeof(AtsCmdRtBulkCalDataReq),
+        ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+    [ATS_RTC_CMD(SET_CAL_DATA_NON_PERSISTENT_BULK)] = {
+        ats_rtc_set_non_persistent_caldata_bulk, sizeof(AtsCmdRtBulkCalDataReq),
+        ATS_CMD_SIZE_UNBOUNDED, sizeof(uint32_t), 0 },
+};
 
-    return status;
-}
+static const AtsCmdTable ats_rtc_cmd_table = {
+    ats_rtc_cmds,
+    sizeof(ats_rtc_cmds) / sizeof(ats_rtc_cmds[0]),
+    NULL,
+    NULL
+};
 
 /**
 * \brief
@@ -1031,7 +1165,7 @@ int32_t ats_rtc_init(void)
 
     int32_t status = AR_EOK;
 
-    status = ats_register_service(ATS_RTC_SERVICE_ID, ats_rtc_ioctl);
+    status = ats_register_service_table(ATS_RTC_SERVICE_ID, &ats_rtc_cmd_table);
     if (AR_FAILED(status))
     {
         ATS_ERR("Error[%d]: Failed to register the ATS Realtime Calibration Service.", status);
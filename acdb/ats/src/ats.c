@@ -46,16 +46,26 @@
  * Type Declarations
  *--------------------------------------------------------------------------- */
 
-typedef struct ats_service_node_t {
+/**< Slot of each service in the registry, in the order ats_init
+ * registers them so service info lists them in that order */
+typedef enum ats_service_index_t {
+	ATS_SERVICE_INDEX_ONLINE = 0,
+	ATS_SERVICE_INDEX_FTS,
+	ATS_SERVICE_INDEX_RTC,
+	ATS_SERVICE_INDEX_DLS,
+	ATS_SERVICE_INDEX_MCS,
+	ATS_SERVICE_INDEX_CODEC_RTC,
+	ATS_SERVICE_INDEX_COUNT
+}AtsServiceIndex;
+
+typedef struct ats_service_entry_t {
+	/**< 0 if the slot is free */
 	uint32_t service_id;
+	/**< Set by ats_register_service, otherwise cmd_table is used */
 	ATS_CALLBACK service_callback;
-	struct ats_service_node_t *p_next;
-}AtsServiceNode;
-
-typedef struct ats_registry_table_t {
-	AtsServiceNode *p_head;
-	AtsServiceNode *p_tail;
-}AtsRegistryTable;
+	const AtsCmdTable *cmd_table;
+	ATS_STREAM_CALLBACK stream_callback;
+}AtsServiceEntry;
 
 /* ---------------------------------------------------------------------------
  * Global Variables
@@ -63,8 +73,23 @@ typedef struct ats_registry_table_t {
 AtsBuffer ats_main_buffer					= {0};
 ATS_SIM_CALLBACK ats_simulation_callback    = NULL;
 bool_t simulation_enabled                   = FALSE;
-static AtsRegistryTable *g_ats_reg_tbl      = NULL;
+static AtsServiceEntry g_ats_services[ATS_SERVICE_INDEX_COUNT];
+static bool_t g_ats_registry_ready          = FALSE;
+static const char *g_ats_service_names[ATS_SERVICE_INDEX_COUNT] = {
+	"Online service",
+	"File Transfer Service",
+	"Realtime Calibration service",
+	"Data Logging service",
+	"Media Control Service",
+	"ADIE Realtime Calibration Service"
+};
 static uint32_t ats_init_count              = 0;
+/**< Streamed responses are built here one chunk at a time. Commands are
+ * executed one at a time so a single chunk serves every transport */
+static uint8_t ats_rsp_stream_chunk[ATS_RSP_STREAM_CHUNK_SIZE];
+/**< The client whose request is executed, 0 if its transport does not
+ * report clients. Set by the transport before each request */
+static uint32_t ats_client_id               = 0;
 
 /* ---------------------------------------------------------------------------
 * External Functions and Forward Declarations
@@ -88,6 +113,11 @@ static bool_t get_command_length(
     uint32_t *data_length
 );
 
+static void ats_client_event(
+    uint32_t client_id,
+    ats_client_event_t event
+);
+
 static void ats_create_error_resp(
     uint32_t error_code,
     uint8_t *req_buf_ptr,
@@ -103,7 +133,21 @@ static void ats_create_suc_resp(
     uint32_t *resp_buf_length
 );
 
-static bool_t is_service_registered(uint32_t service_id);
+static int32_t ats_get_service_index(uint32_t service_id, uint32_t *index);
+
+static int32_t ats_dispatch_command(const AtsCmdTable *cmd_table,
+    uint32_t svc_cmd_id,
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    uint8_t *rsp_buf,
+    uint32_t rsp_buf_size,
+    uint32_t *rsp_buf_bytes_filled
+);
+
+static int32_t ats_rsp_stream_flush(AtsRspStream *rsp_stream);
+
+static void ats_rsp_stream_set_header(AtsRspStream *rsp_stream,
+    int32_t error_code, uint32_t data_length);
 
 void ats_register_simulation(ATS_SIM_CALLBACK sim_callback);
 
@@ -135,6 +179,22 @@ int32_t ats_init(void)
 	/*-----------------------------------------------------
 	 *				Initialize ATS Transports
 	 *---------------------------------------------------*/
+	service_status = ats_transport_register_stream_callback(
+		ats_execute_command_stream);
+	if (AR_FAILED(service_status) && AR_EUNSUPPORTED != service_status)
+	{
+		ATS_ERR("Error[%d]: Failed to enable streamed responses. "
+			"All responses will be buffered", service_status);
+	}
+
+	service_status = ats_transport_register_client_callback(
+		ats_client_event);
+	if (AR_FAILED(service_status) && AR_EUNSUPPORTED != service_status)
+	{
+		ATS_ERR("Error[%d]: Failed to track clients. State left by "
+			"disconnected clients is released when it expires", service_status);
+	}
+
 	status = ats_transport_init(ats_execute_command);
 	if (AR_FAILED(status))
 	{
@@ -149,20 +209,20 @@ int32_t ats_init(void)
 		ats_main_buffer.buffer_size = ATS_ACDB_BUFFER_POSITION + ATS_BUFFER_LENGTH;
 		ats_main_buffer.buffer = (uint8_t*)ACDB_MALLOC(
 			uint8_t, ats_main_buffer.buffer_size);
-		g_ats_reg_tbl = (AtsRegistryTable*)ACDB_MALLOC(AtsRegistryTable, 1);
 
-		if (NULL == ats_main_buffer.buffer || NULL == g_ats_reg_tbl)
+		if (NULL == ats_main_buffer.buffer)
 		{
 			status = AR_ENOMEMORY;
 			ATS_ERR("Error[%d]: Failed to allocate memory for "
 				"ATS resources",
 				status);
 		}
-		else
-		{
-			g_ats_reg_tbl->p_head = NULL;
-			g_ats_reg_tbl->p_tail = NULL;
-		}
+	}
+
+	if (AR_SUCCEEDED(status))
+	{
+		ar_mem_set(g_ats_services, 0, sizeof(g_ats_services));
+		g_ats_registry_ready = TRUE;
 	}
 
 	if (AR_FAILED(status))
@@ -242,11 +302,7 @@ release_resources:
 		ACDB_FREE(ats_main_buffer.buffer);
 		ats_main_buffer.buffer = NULL;
 	}
-	if (NULL != g_ats_reg_tbl)
-	{
-		ACDB_FREE(g_ats_reg_tbl);
-		g_ats_reg_tbl = NULL;
-	}
+	g_ats_registry_ready = FALSE;
 end:
 	if (AR_FAILED(status))
 	{
@@ -283,26 +339,6 @@ int32_t ats_deinit(void)
 		ats_main_buffer.buffer = NULL;
 	}
 
-	{
-		if (g_ats_reg_tbl != NULL && g_ats_reg_tbl->p_head != NULL)
-		{
-			int32_t count = 0;
-			AtsServiceNode *cur_node = g_ats_reg_tbl->p_head;
-			ATS_DBG("g_ats_reg_tbl is not NULL, g_ats_reg_tbl->p_head is not NULL\n");
-
-			while (cur_node)
-			{
-				count++;
-				ATS_DBG("Node%d is not empty, address[%p]\n", count, cur_node);
-				cur_node = cur_node->p_next;
-			}
-			if (g_ats_reg_tbl->p_tail != NULL)
-			{
-				ATS_DBG("g_ats_reg_tbl->p_tail is not NULL, address[%p]\n", g_ats_reg_tbl->p_tail);
-			}
-		}
-	}
-
 	// Deinitializes services
     (void)ats_online_deinit();
     (void)ats_rtc_deinit();
@@ -313,22 +349,8 @@ int32_t ats_deinit(void)
 	// Deinitializes transport(s)
 	(void)ats_transport_deinit();
 
-	if (NULL != g_ats_reg_tbl)
-	{
-		if (g_ats_reg_tbl->p_head != NULL)
-		{
-			AtsServiceNode *cur_node = g_ats_reg_tbl->p_head->p_next;
-			while (cur_node)
-			{
-				g_ats_reg_tbl->p_head->p_next = cur_node->p_next;
-				ACDB_FREE(cur_node);
-				cur_node = g_ats_reg_tbl->p_head->p_next;
-			}
-			ACDB_FREE(g_ats_reg_tbl->p_head);
-		}
-		ACDB_FREE(g_ats_reg_tbl);
-		g_ats_reg_tbl = NULL;
-	}
+	ar_mem_set(g_ats_services, 0, sizeof(g_ats_services));
+	g_ats_registry_ready = FALSE;
 	ats_init_count = 0;
 
 	return status;
@@ -361,8 +383,11 @@ void ats_execute_command(uint8_t *req_buf_ptr,
 	int32_t status = AR_EFAILED;
     uint32_t service_id = 0;
     uint32_t service_cmd_id = 0;
+    uint32_t service_index = 0;
+    uint32_t cmd_buf_size = 0;
+    uint8_t *cmd_buf = NULL;
 	uint8_t *temp_resp_buf = NULL;
-	ATS_CALLBACK ats_cb_req_op = NULL;
+    AtsServiceEntry *service = NULL;
 	uint32_t resp_buf_size = ATS_BUFFER_LENGTH
 		- ATS_ACDB_BUFFER_POSITION - sizeof(status);
 
@@ -391,85 +416,59 @@ void ats_execute_command(uint8_t *req_buf_ptr,
     service_id = ATS_GET_SERVICE_ID(service_cmd_id);
     ATS_SERVICE_ID_STR(svc_id_str, ATS_SEVICE_ID_STR_LEN, service_cmd_id);
 
-    switch (service_id)
+    if (!g_ats_registry_ready)
+    {
+        ATS_ERR("ATS registry table is not initialized. ats_init must be called prior to executing commands");
+        return;
+    }
+
+    if (AR_FAILED(ats_get_service_index(service_id, &service_index)))
     {
-    case ATS_RTC_SERVICE_ID:
-    case ATS_DLS_SERVICE_ID:
-    case ATS_FTS_SERVICE_ID:
-    case ATS_MCS_SERVICE_ID:
-    case ATS_CODEC_RTC_SERVICE_ID:
-    case ATS_ONLINE_SERVICE_ID:
-        break;
-    default:
         ATS_ERR("The command id provided does not belong to any service category [%x]\n", service_cmd_id);
         ats_create_error_resp(AR_EUNSUPPORTED, req_buf_ptr, *resp_buf_ptr, resp_buf_length);
         return;
     }
 
-	if (g_ats_reg_tbl != NULL)
-	{
-		AtsServiceNode *pCur = g_ats_reg_tbl->p_head;
-		while (pCur)
-		{
-			if (pCur->service_id == service_id)
-			{
-				uint32_t temp_req_buf_len = req_buf_length - ATS_HEADER_LENGTH;
-				ats_cb_req_op = pCur->service_callback;
-
-                // See note at top on Platform Agnostic Services
-                if (simulation_enabled &&
-                    (service_id != ATS_ONLINE_SERVICE_ID &&
-                        service_id != ATS_FTS_SERVICE_ID &&
-                        service_id != ATS_CODEC_RTC_SERVICE_ID))
-                {
-                    status = ats_simulation_callback(req_buf_length, req_buf_ptr,
-                        resp_buf_length, ats_main_buffer.buffer);
-
-                    /* The recorded packet response already contains the status
-                     * so there is no need to call ats_create_suc_resp.
-                     * If the response buffer associated with the request buffer
-                     * cannot be found call ats_create_suc_resp
-                     */
-                    if(AR_SUCCEEDED(status)) return;
-                    else break;
-                }
-
-				if (temp_req_buf_len == 0)
-				{
-					status = ats_cb_req_op(service_cmd_id,
-                        NULL, temp_req_buf_len,
-                        temp_resp_buf, resp_buf_size, resp_buf_length);
-				}
-				else
-				{
-					status = ats_cb_req_op(service_cmd_id,
-                        req_buf_ptr + ATS_HEADER_LENGTH, temp_req_buf_len,
-                        temp_resp_buf, resp_buf_size, resp_buf_length);
-				}
-				break;
-			}
-			else
-			{
-				pCur = pCur->p_next;
-			}
-		}
+    service = &g_ats_services[service_index];
+    *resp_buf_length = 0;
+    cmd_buf_size = req_buf_length - ATS_HEADER_LENGTH;
+    if (cmd_buf_size > 0)
+        cmd_buf = req_buf_ptr + ATS_HEADER_LENGTH;
+
+    // See note at top on Platform Agnostic Services
+    if (0 != service->service_id && simulation_enabled &&
+        (service_id != ATS_ONLINE_SERVICE_ID &&
+            service_id != ATS_FTS_SERVICE_ID &&
+            service_id != ATS_CODEC_RTC_SERVICE_ID))
+    {
+        status = ats_simulation_callback(req_buf_length, req_buf_ptr,
+            resp_buf_length, ats_main_buffer.buffer);
+
+        /* The recorded packet response already contains the status
+         * so there is no need to call ats_create_suc_resp.
+         * If the response buffer associated with the request buffer
+         * cannot be found call ats_create_suc_resp
+         */
+        if (AR_SUCCEEDED(status)) return;
+    }
+    else if (!IsNull(service->cmd_table))
+    {
+        status = ats_dispatch_command(service->cmd_table, service_cmd_id,
+            cmd_buf, cmd_buf_size,
+            temp_resp_buf, resp_buf_size, resp_buf_length);
+    }
+    else if (!IsNull(service->service_callback))
+    {
+        status = service->service_callback(service_cmd_id,
+            cmd_buf, cmd_buf_size,
+            temp_resp_buf, resp_buf_size, resp_buf_length);
+    }
 
-		if (AR_FAILED(status))
-		{
-            ATS_ERR("Error[%d]: Error occured while executing Command[%s-%d]", status, svc_id_str, ATS_GET_COMMAND_ID(service_cmd_id));
-			//ats_create_error_resp(status, req_buf_ptr, *resp_buf_ptr, resp_buf_length);
-			ats_create_suc_resp(status, *resp_buf_length, req_buf_ptr, *resp_buf_ptr, resp_buf_length);
-		}
-		else
-		{
-			ats_create_suc_resp(status, *resp_buf_length, req_buf_ptr, *resp_buf_ptr, resp_buf_length);
-		}
-	}
-	else
-	{
-        ATS_ERR("ATS registry table is not initialized. ats_init must be called prior to executing commands");
-		status = AR_EFAILED;
-	}
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Error occured while executing Command[%s-%d]", status, svc_id_str, ATS_GET_COMMAND_ID(service_cmd_id));
+    }
+    ats_create_suc_resp(status, *resp_buf_length, req_buf_ptr, *resp_buf_ptr, resp_buf_length);
 }
 
 /**
@@ -493,106 +492,76 @@ int32_t ats_register_service(uint32_t service_id,
 )
 {
 	int32_t result = AR_EOK;
+	uint32_t index = 0;
 
-	if ((service_id != ATS_RTC_SERVICE_ID) &&
-		(service_id != ATS_DLS_SERVICE_ID) &&
-		(service_id != ATS_FTS_SERVICE_ID) &&
-		(service_id != ATS_MCS_SERVICE_ID) &&
-        (service_id != ATS_CODEC_RTC_SERVICE_ID)&&
-        (service_id != ATS_ONLINE_SERVICE_ID))
+	if (AR_FAILED(ats_get_service_index(service_id, &index)))
 	{
 		ATS_DBG("[ATS]->Invalid service id Received for ATS registration - %x\n", service_id);
 		return AR_EHANDLE;
 	}
 
-	//ATS_DBG("[ATS]->registering the command - %x\n", nService_id);
-
-	if (g_ats_reg_tbl == NULL)
+	if (!g_ats_registry_ready)
 	{
 		ATS_DBG("[ATS ERROR]->ATS_execute_command->ATS registry table was not initialized\n");
 		result = AR_EFAILED;
 		return result;
 	}
 
-	if (is_service_registered(service_id))
+	if (0 != g_ats_services[index].service_id)
 	{
 		ATS_DBG("[ATS]->Requested service already registered - %x\n", service_id);
 		return AR_EFAILED;
 	}
 
-	if (g_ats_reg_tbl->p_tail != NULL)
-	{
-		AtsServiceNode* pCur = g_ats_reg_tbl->p_tail;
-		pCur->p_next = (AtsServiceNode*)ACDB_MALLOC(AtsServiceNode, 1);
-		if (pCur->p_next != NULL)
-		{
-			pCur->p_next->service_id = service_id;
-            pCur->p_next->service_callback = service_callback;
-			pCur->p_next->p_next = NULL;
-			g_ats_reg_tbl->p_tail = pCur->p_next;
-		}
-		else
-		{
-			ATS_DBG("[ATS ERROR]->ATS_register_command->fail to ACDB_MALLOC memory\n");
-			result = AR_EFAILED;
-		}
-	}
-	else
-	{
-		/* register with cmdId and function pointer */
-		g_ats_reg_tbl->p_head = (AtsServiceNode*)ACDB_MALLOC(AtsServiceNode, 1);
-		if (g_ats_reg_tbl->p_head != NULL)
-		{
-			g_ats_reg_tbl->p_head->service_id = service_id;
-            g_ats_reg_tbl->p_head->service_callback = service_callback;
-			g_ats_reg_tbl->p_head->p_next = NULL;
-			g_ats_reg_tbl->p_tail = g_ats_reg_tbl->p_head;
-		}
-		else
-		{
-			ATS_DBG("[ATS ERROR]->ATS_register_command->fail to ACDB_MALLOC memory\n");
-			result = AR_EFAILED;
-		}
-	}
+	g_ats_services[index].service_id = service_id;
+	g_ats_services[index].service_callback = service_callback;
+	g_ats_services[index].cmd_table = NULL;
+	g_ats_services[index].stream_callback = NULL;
 
-	if (AR_SUCCEEDED(result))
-	{
-		switch (service_id)
-		{
-		case ATS_ONLINE_SERVICE_ID:
-			ATS_INFO("Online service registered with ATS");
-			break;
-		case ATS_CODEC_RTC_SERVICE_ID:
-            ATS_INFO("ADIE Realtime Calibration Service registered with ATS");
-			break;
-		case ATS_MCS_SERVICE_ID:
-            ATS_INFO("Media Control Service registered with ATS");
-			break;
-		case ATS_FTS_SERVICE_ID:
-            ATS_INFO("File Transfer Service registered with ATS");
-			break;
-        case ATS_RTC_SERVICE_ID:
-            ATS_INFO("Realtime Calibration service registered with ATS");
-            break;
-        case ATS_DLS_SERVICE_ID:
-            ATS_INFO("Data Logging service registered with ATS");
-            break;
-		default:
-            ATS_INFO("Unknown service registered with ATS");
-			break;
-		}
-	}
+	ATS_INFO("%s registered with ATS", g_ats_service_names[index]);
 
 	return result;
 }
 
 /**
- * \brief deregister command into ATS registry table
+ * \brief
+ * register a service and the table of its command handlers into the ATS
+ * registry table
  *
- * \depends
- * get_command_length is supposed to be called before this function,
- * which will check the command length and ensures that the
- * service + command id is present.
+ * \param[in] service_id - the service to register
+ * \param[in] cmd_table - the commands of the service indexed by command id
+ *
+ * \return AR_EOK if the service was registered;
+ *         AR_EBADPARAM if the table is malformed;
+ *         AR_EFAILED otherwise.
+ */
+int32_t ats_register_service_table(uint32_t service_id,
+    const AtsCmdTable *cmd_table)
+{
+    int32_t status = AR_EOK;
+    uint32_t index = 0;
+
+    if (IsNull(cmd_table) || IsNull(cmd_table->entries) ||
+        0 == cmd_table->entry_count ||
+        (NULL == cmd_table->lock) != (NULL == cmd_table->unlock))
+    {
+        ATS_ERR("Error[%d]: Invalid command table for service %x",
+            AR_EBADPARAM, service_id);
+        return AR_EBADPARAM;
+    }
+
+    status = ats_register_service(service_id, NULL);
+    if (AR_FAILED(status))
+        return status;
+
+    (void)ats_get_service_index(service_id, &index);
+    g_ats_services[index].cmd_table = cmd_table;
+
+    return status;
+}
+
+/**
+ * \brief deregister command into ATS registry table
  *
  * \param[in] service_id - corresponding to command id to the function
  *                         name, it is dynamically created and client
@@ -606,96 +575,330 @@ int32_t ats_register_service(uint32_t service_id,
 int32_t ats_deregister_service(uint32_t service_id
 )
 {
-	int32_t result = AR_EFAILED;
+	uint32_t index = 0;
 
-	if (g_ats_reg_tbl != NULL && g_ats_reg_tbl->p_head != NULL)
-	{
-		AtsServiceNode* pCur = g_ats_reg_tbl->p_head;
-		AtsServiceNode* pPrev = g_ats_reg_tbl->p_head;
-		//first Node
-		if (pCur->service_id == service_id)
-		{
-			if (pCur == g_ats_reg_tbl->p_tail)
-			{
-				ACDB_FREE(pCur);
-				g_ats_reg_tbl->p_head = NULL;
-				g_ats_reg_tbl->p_tail = g_ats_reg_tbl->p_head;
-			}
-			else
-			{
-				g_ats_reg_tbl->p_head = pCur->p_next;
-				ATS_DBG("Free first node, p_head[%p],pCur[%p],p_next[%p]\n",
-					g_ats_reg_tbl->p_head, pCur, pCur->p_next);
-				ACDB_FREE(pCur);
-			}
-
-			result = AR_EOK;
-		}
-		else
-		{
-			pCur = pCur->p_next;
-
-			//2nd or ... Node
-			while (pCur)
-			{
-				if (pCur->service_id == service_id)
-				{
-					if (pCur == g_ats_reg_tbl->p_tail)
-					{
-						g_ats_reg_tbl->p_tail = pPrev;
-					}
-					pPrev->p_next = pCur->p_next;
-					ACDB_FREE(pCur);
-					result = AR_EOK;
-					break;
-				}
-				else
-				{
-					pPrev = pPrev->p_next;
-					pCur = pCur->p_next;
-				}
-			}
-		}
-		if (AR_FAILED(result))
-		{
-			ATS_DBG("The provided Service ID was not found in the registry\n");
-		}
-	}
-	else
+	if (!g_ats_registry_ready)
 	{
 		ATS_DBG("ATS registry table was not initialized\n");
-		result = AR_EFAILED;
+		return AR_EFAILED;
 	}
 
-	if (AR_SUCCEEDED(result))
+	if (AR_FAILED(ats_get_service_index(service_id, &index)) ||
+		g_ats_services[index].service_id != service_id)
 	{
-        switch (service_id)
+		ATS_DBG("The provided Service ID was not found in the registry\n");
+		return AR_EFAILED;
+	}
+
+	ATS_DBG("Deregistering %s", g_ats_service_names[index]);
+	ar_mem_set(&g_ats_services[index], 0, sizeof(AtsServiceEntry));
+
+	return AR_EOK;
+}
+
+/**
+ * \brief
+ * attach a streaming callback to a service in the ATS registry table
+ *
+ * \param[in] service_id - a service registered with ats_register_service
+ * \param[in] stream_callback - executes the commands of the service whose
+ *                 response is streamed
+ *
+ * \return AR_EOK if the callback was attached;
+ *                AR_ENOTEXIST if the service is not registered.
+ */
+int32_t ats_register_stream_callback(uint32_t service_id,
+    ATS_STREAM_CALLBACK stream_callback)
+{
+    uint32_t index = 0;
+
+    if (!g_ats_registry_ready)
+    {
+        ATS_ERR("ATS registry table was not initialized");
+        return AR_EFAILED;
+    }
+
+    if (AR_FAILED(ats_get_service_index(service_id, &index)) ||
+        g_ats_services[index].service_id != service_id)
+    {
+        ATS_ERR("Error[%d]: Service %x must be registered before its stream callback",
+            AR_ENOTEXIST, service_id);
+        return AR_ENOTEXIST;
+    }
+
+    g_ats_services[index].stream_callback = stream_callback;
+    return AR_EOK;
+}
+
+/**
+ * \brief Execute a command whose response is streamed to the transport.
+ *
+ * \depends ACDB needs to be initialized before this function is called
+ *
+ * \param[in] req_buf_ptr - pointer to request buffer
+ * \param[in] req_buf_length - length of the request buffer
+ * \param[in] write_cb - sends each chunk of the response
+ * \param[in] send_file_cb - sends response data from a file, may be NULL
+ * \param[in] transport_ctx - passed back to write_cb and send_file_cb
+ *
+ * \return AR_EOK if the response was sent, AR_EUNSUPPORTED if the command is
+ *         not streamed and nothing was sent, other codes if the response was
+ *         cut short
+ */
+int32_t ats_execute_command_stream(uint8_t *req_buf_ptr,
+    uint32_t req_buf_length,
+    ats_rsp_stream_write_t write_cb,
+    ats_rsp_stream_send_file_t send_file_cb,
+    void *transport_ctx
+)
+{
+    int32_t status = AR_EOK;
+    uint32_t data_length = 0;
+    uint32_t service_id = 0;
+    uint32_t service_cmd_id = 0;
+    uint32_t cmd_buf_size = 0;
+    uint8_t *cmd_buf = NULL;
+    uint32_t service_index = 0;
+    ATS_STREAM_CALLBACK stream_callback = NULL;
+    AtsRspStream rsp_stream = { 0 };
+    char svc_id_str[ATS_SEVICE_ID_STR_LEN] = { 0 };
+
+    /* Malformed requests are answered by ats_execute_command */
+    if (IsNull(write_cb) || !g_ats_registry_ready ||
+        FALSE == get_command_length(req_buf_ptr, req_buf_length, &data_length))
+    {
+        return AR_EUNSUPPORTED;
+    }
+
+    ATS_MEM_CPY_SAFE((void*)&service_cmd_id, ATS_SERVICE_COMMAND_ID_LENGTH,
+        (void*)(req_buf_ptr + ATS_SERVICE_COMMAND_ID_POSITION),
+        ATS_SERVICE_COMMAND_ID_LENGTH);
+    service_id = ATS_GET_SERVICE_ID(service_cmd_id);
+
+    // See note at top on Platform Agnostic Services
+    if (simulation_enabled &&
+        (service_id != ATS_ONLINE_SERVICE_ID &&
+            service_id != ATS_FTS_SERVICE_ID &&
+            service_id != ATS_CODEC_RTC_SERVICE_ID))
+    {
+        return AR_EUNSUPPORTED;
+    }
+
+    if (AR_FAILED(ats_get_service_index(service_id, &service_index)))
+        return AR_EUNSUPPORTED;
+
+    stream_callback = g_ats_services[service_index].stream_callback;
+    if (IsNull(stream_callback))
+        return AR_EUNSUPPORTED;
+
+    rsp_stream.write = write_cb;
+    rsp_stream.send_file = send_file_cb;
+    rsp_stream.transport_ctx = transport_ctx;
+    rsp_stream.svc_cmd_id = service_cmd_id;
+    rsp_stream.chunk = ats_rsp_stream_chunk;
+    rsp_stream.chunk_size = sizeof(ats_rsp_stream_chunk);
+
+    cmd_buf_size = req_buf_length - ATS_HEADER_LENGTH;
+    if (cmd_buf_size > 0)
+        cmd_buf = req_buf_ptr + ATS_HEADER_LENGTH;
+
+    status = stream_callback(service_cmd_id, cmd_buf, cmd_buf_size, &rsp_stream);
+
+    if (!rsp_stream.started)
+    {
+        if (AR_EUNSUPPORTED == status)
+            return AR_EUNSUPPORTED;
+
+        /* Nothing was sent yet so the client can still be given the error */
+        if (AR_FAILED(status))
         {
-        case ATS_ONLINE_SERVICE_ID:
-            ATS_DBG("Deregistering Online service");
-            break;
-        case ATS_CODEC_RTC_SERVICE_ID:
-            ATS_DBG("Deregistering ADIE Realtime Calibration Service");
-            break;
-        case ATS_MCS_SERVICE_ID:
-            ATS_DBG("Deregistering Media Control Service");
-            break;
-        case ATS_FTS_SERVICE_ID:
-            ATS_DBG("Deregistering File Transfer Service");
-            break;
-        case ATS_RTC_SERVICE_ID:
-            ATS_DBG("Deregistering Realtime Calibration service");
-            break;
-        case ATS_DLS_SERVICE_ID:
-            ATS_DBG("Deregistering Data Logging service");
-            break;
-        default:
-            ATS_DBG("Deregistering unknown service");
-            break;
+            ATS_SERVICE_ID_STR(svc_id_str, ATS_SEVICE_ID_STR_LEN, service_cmd_id);
+            ATS_ERR("Error[%d]: Error occured while executing Command[%s-%d]",
+                status, svc_id_str, ATS_GET_COMMAND_ID(service_cmd_id));
         }
-	}
 
-	return result;
+        ats_rsp_stream_set_header(&rsp_stream, status, 0);
+        return ats_rsp_stream_flush(&rsp_stream);
+    }
+
+    if (AR_SUCCEEDED(status) && rsp_stream.bytes_written != rsp_stream.data_length)
+    {
+        ATS_ERR("Error[%d]: %d of %d response bytes were written",
+            AR_EFAILED, rsp_stream.bytes_written, rsp_stream.data_length);
+        status = AR_EFAILED;
+    }
+
+    if (AR_SUCCEEDED(status))
+        status = ats_rsp_stream_flush(&rsp_stream);
+
+    if (AR_FAILED(status))
+    {
+        ATS_SERVICE_ID_STR(svc_id_str, ATS_SEVICE_ID_STR_LEN, service_cmd_id);
+        ATS_ERR("Error[%d]: The response to Command[%s-%d] was cut short",
+            status, svc_id_str, ATS_GET_COMMAND_ID(service_cmd_id));
+        return AR_FAILED(rsp_stream.status) ? rsp_stream.status : status;
+    }
+
+    return AR_EOK;
+}
+
+int32_t ats_rsp_stream_begin(AtsRspStream *rsp_stream, uint32_t data_length)
+{
+    if (IsNull(rsp_stream) || rsp_stream->started ||
+        data_length > UINT32_MAX - ATS_ERROR_CODE_LENGTH)
+    {
+        return AR_EBADPARAM;
+    }
+
+    ats_rsp_stream_set_header(rsp_stream, AR_EOK, data_length);
+    rsp_stream->data_length = data_length;
+    rsp_stream->bytes_written = 0;
+    rsp_stream->started = TRUE;
+
+    return AR_EOK;
+}
+
+int32_t ats_rsp_stream_get_buffer(AtsRspStream *rsp_stream,
+    uint8_t **buffer, uint32_t *buffer_size)
+{
+    int32_t status = AR_EOK;
+    uint32_t remaining = 0;
+
+    if (IsNull(rsp_stream) || IsNull(buffer) || IsNull(buffer_size))
+        return AR_EBADPARAM;
+    if (!rsp_stream->started)
+        return AR_ENOTREADY;
+
+    if (rsp_stream->chunk_filled == rsp_stream->chunk_size)
+    {
+        status = ats_rsp_stream_flush(rsp_stream);
+        if (AR_FAILED(status))
+            return status;
+    }
+
+    remaining = rsp_stream->data_length - rsp_stream->bytes_written;
+    *buffer = rsp_stream->chunk + rsp_stream->chunk_filled;
+    *buffer_size = rsp_stream->chunk_size - rsp_stream->chunk_filled;
+    if (*buffer_size > remaining)
+        *buffer_size = remaining;
+
+    return AR_EOK;
+}
+
+int32_t ats_rsp_stream_commit(AtsRspStream *rsp_stream, uint32_t size)
+{
+    if (IsNull(rsp_stream) || !rsp_stream->started ||
+        size > rsp_stream->chunk_size - rsp_stream->chunk_filled ||
+        size > rsp_stream->data_length - rsp_stream->bytes_written)
+    {
+        return AR_EBADPARAM;
+    }
+
+    rsp_stream->chunk_filled += size;
+    rsp_stream->bytes_written += size;
+
+    if (rsp_stream->chunk_filled == rsp_stream->chunk_size)
+        return ats_rsp_stream_flush(rsp_stream);
+
+    return rsp_stream->status;
+}
+
+int32_t ats_rsp_stream_write(AtsRspStream *rsp_stream,
+    const void *data, uint32_t size)
+{
+    int32_t status = AR_EOK;
+    const uint8_t *src = (const uint8_t*)data;
+    uint8_t *buffer = NULL;
+    uint32_t buffer_size = 0;
+
+    if (IsNull(rsp_stream) || (IsNull(data) && size > 0))
+        return AR_EBADPARAM;
+    if (!rsp_stream->started)
+        return AR_ENOTREADY;
+    if (size > rsp_stream->data_length - rsp_stream->bytes_written)
+    {
+        ATS_ERR("Error[%d]: Writing %d bytes exceeds the response length of %d bytes",
+            AR_EBADPARAM, size, rsp_stream->data_length);
+        return AR_EBADPARAM;
+    }
+
+    while (size > 0)
+    {
+        status = ats_rsp_stream_get_buffer(rsp_stream, &buffer, &buffer_size);
+        if (AR_FAILED(status))
+            return status;
+        if (buffer_size > size)
+            buffer_size = size;
+
+        ATS_MEM_CPY_SAFE(buffer, buffer_size, src, buffer_size);
+        status = ats_rsp_stream_commit(rsp_stream, buffer_size);
+        if (AR_FAILED(status))
+            return status;
+
+        src += buffer_size;
+        size -= buffer_size;
+    }
+
+    return AR_EOK;
+}
+
+int32_t ats_rsp_stream_send_file(AtsRspStream *rsp_stream,
+    int32_t fd, uint32_t file_offset, uint32_t length)
+{
+    int32_t status = AR_EOK;
+
+    if (IsNull(rsp_stream) || fd < 0)
+        return AR_EBADPARAM;
+    if (!rsp_stream->started)
+        return AR_ENOTREADY;
+    if (IsNull(rsp_stream->send_file))
+        return AR_EUNSUPPORTED;
+    if (length > rsp_stream->data_length - rsp_stream->bytes_written)
+    {
+        ATS_ERR("Error[%d]: Sending %d bytes exceeds the response length of %d bytes",
+            AR_EBADPARAM, length, rsp_stream->data_length);
+        return AR_EBADPARAM;
+    }
+
+    /* Whatever is in the chunk comes first */
+    status = ats_rsp_stream_flush(rsp_stream);
+    if (AR_FAILED(status))
+        return status;
+
+    status = rsp_stream->send_file(rsp_stream->transport_ctx,
+        fd, file_offset, length);
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to send %d bytes of file data",
+            status, length);
+        rsp_stream->status = status;
+        return status;
+    }
+    rsp_stream->bytes_written += length;
+
+    return AR_EOK;
+}
+
+static void ats_client_event(uint32_t client_id, ats_client_event_t event)
+{
+    switch (event)
+    {
+    case ATS_CLIENT_EVENT_REQUEST:
+        ats_client_id = client_id;
+        break;
+    case ATS_CLIENT_EVENT_DISCONNECT:
+        if (ats_client_id == client_id)
+            ats_client_id = 0;
+        ats_fts_release_client(client_id);
+        break;
+    default:
+        break;
+    }
+}
+
+uint32_t ats_get_client_id(void)
+{
+    return ats_client_id;
 }
 
 int32_t ats_get_service_info(AtsCmdGetServiceInfoRsp *svc_info_rsp, uint32_t rsp_buf_len)
@@ -713,14 +916,13 @@ int32_t ats_get_service_info(AtsCmdGetServiceInfoRsp *svc_info_rsp, uint32_t rsp
 
     //}
     AtsServiceInfo svc_info = { 0 };
-    AtsServiceNode *cur_node = g_ats_reg_tbl->p_head;
     uint32_t found = FALSE;
 
-    while (!IsNull(cur_node))
+    for (uint32_t i = 0; i < ATS_SERVICE_INDEX_COUNT; i++)
     {
-        svc_info.service_id = cur_node->service_id;
+        svc_info.service_id = g_ats_services[i].service_id;
 
-        switch (cur_node->service_id)
+        switch (svc_info.service_id)
         {
         case ATS_RTC_SERVICE_ID:
         {
@@ -775,8 +977,6 @@ int32_t ats_get_service_info(AtsCmdGetServiceInfoRsp *svc_info_rsp, uint32_t rsp
                 sizeof(AtsServiceInfo), &svc_info, sizeof(AtsServiceInfo));
             svc_info_rsp->service_count++;
         }
-
-        cur_node = cur_node->p_next;
     }
 
 	svc_info.service_id = 0xACDB0000;
@@ -963,32 +1163,180 @@ static void ats_create_suc_resp(uint32_t error_code, uint32_t data_length,
         &error_code, sizeof(error_code));
 }
 
+/**
+ * \brief
+ * Sends the bytes held in the chunk. A failed send is remembered since the
+ * client has lost its place in the response
+ */
+static int32_t ats_rsp_stream_flush(AtsRspStream *rsp_stream)
+{
+    int32_t status = AR_EOK;
+
+    if (AR_FAILED(rsp_stream->status))
+        return rsp_stream->status;
+    if (0 == rsp_stream->chunk_filled)
+        return AR_EOK;
+
+    status = rsp_stream->write(rsp_stream->transport_ctx,
+        rsp_stream->chunk, rsp_stream->chunk_filled);
+    if (AR_FAILED(status))
+    {
+        ATS_ERR("Error[%d]: Failed to send %d response bytes",
+            status, rsp_stream->chunk_filled);
+        rsp_stream->status = status;
+    }
+    rsp_stream->chunk_filled = 0;
+
+    return rsp_stream->status;
+}
+
+/**
+ * \brief
+ * Starts the chunk with the response header, see ats_create_suc_resp
+ */
+static void ats_rsp_stream_set_header(AtsRspStream *rsp_stream,
+    int32_t error_code, uint32_t data_length)
+{
+    uint32_t resp_data_length = sizeof(error_code) + data_length;
+
+    ATS_MEM_CPY_SAFE(rsp_stream->chunk + ATS_SERVICE_COMMAND_ID_POSITION,
+        ATS_SERVICE_COMMAND_ID_LENGTH,
+        &rsp_stream->svc_cmd_id, ATS_SERVICE_COMMAND_ID_LENGTH);
+    ATS_MEM_CPY_SAFE(rsp_stream->chunk + ATS_DATA_LENGTH_POSITION,
+        ATS_DATA_LENGTH_LENGTH, &resp_data_length, ATS_DATA_LENGTH_LENGTH);
+    ATS_MEM_CPY_SAFE(rsp_stream->chunk + ATS_ACDB_BUFFER_POSITION,
+        ATS_ERROR_CODE_LENGTH, &error_code, ATS_ERROR_CODE_LENGTH);
+    rsp_stream->chunk_filled = ATS_ACDB_BUFFER_POSITION + ATS_ERROR_CODE_LENGTH;
+}
+
 /**
 * \brief
-* Checks if the given service is already registered.
+* Maps a service id to its slot in the registry table.
 *
-* PARAMS:
 * \param[in] service_id - Service ID
+* \param[out] index - The slot of the service
 *
-* \return returns true or false.
+* \return AR_EOK, or AR_EHANDLE if the service id is unknown.
 */
-static bool_t is_service_registered(uint32_t service_id)
+static int32_t ats_get_service_index(uint32_t service_id, uint32_t *index)
 {
-    if (g_ats_reg_tbl != NULL)
+    switch (service_id)
     {
-        AtsServiceNode *cur_node = g_ats_reg_tbl->p_head;
-        while (cur_node)
+    case ATS_ONLINE_SERVICE_ID:
+        *index = ATS_SERVICE_INDEX_ONLINE;
+        break;
+    case ATS_FTS_SERVICE_ID:
+        *index = ATS_SERVICE_INDEX_FTS;
+        break;
+    case ATS_RTC_SERVICE_ID:
+        *index = ATS_SERVICE_INDEX_RTC;
+        break;
+    case ATS_DLS_SERVICE_ID:
+        *index = ATS_SERVICE_INDEX_DLS;
+        break;
+    case ATS_MCS_SERVICE_ID:
+        *index = ATS_SERVICE_INDEX_MCS;
+        break;
+    case ATS_CODEC_RTC_SERVICE_ID:
+        *index = ATS_SERVICE_INDEX_CODEC_RTC;
+        break;
+    default:
+        return AR_EHANDLE;
+    }
+
+    return AR_EOK;
+}
+
+/**
+* \brief
+* Checks a command against the bounds its service declared for it and runs
+* its handler, under the service lock unless the handler takes it itself.
+*
+* \param[in] cmd_table - The command table of the service
+* \param[in] svc_cmd_id - The service and command id
+* \param[in] cmd_buf - The request payload, NULL if it is empty
+* \param[in] cmd_buf_size - Size of the request payload
+* \param[out] rsp_buf - The response payload
+* \param[in] rsp_buf_size - Size of the response buffer
+* \param[out] rsp_buf_bytes_filled - Number of bytes written to the response
+*
+* \return AR_EUNSUPPORTED if the service does not handle the command,
+*         AR_EBADPARAM if the request size is out of bounds,
+*         AR_ENEEDMORE if the response buffer is too small,
+*         otherwise the status of the handler.
+*/
+static int32_t ats_dispatch_command(const AtsCmdTable *cmd_table,
+    uint32_t svc_cmd_id,
+    uint8_t *cmd_buf,
+    uint32_t cmd_buf_size,
+    uint8_t *rsp_buf,
+    uint32_t rsp_buf_size,
+    uint32_t *rsp_buf_bytes_filled
+)
+{
+    int32_t status = AR_EOK;
+    int32_t lock_status = AR_EOK;
+    uint32_t cmd_id = ATS_GET_COMMAND_ID(svc_cmd_id);
+    const AtsCmdEntry *entry = NULL;
+    bool_t is_locked = FALSE;
+
+    if (cmd_id >= cmd_table->entry_count ||
+        IsNull(cmd_table->entries[cmd_id].handler))
+    {
+        ATS_ERR("Error[%d]: Command[%x] is not supported",
+            AR_EUNSUPPORTED, svc_cmd_id);
+        return AR_EUNSUPPORTED;
+    }
+
+    entry = &cmd_table->entries[cmd_id];
+
+    if (cmd_buf_size < entry->min_req_size ||
+        cmd_buf_size > entry->max_req_size)
+    {
+        ATS_ERR("Error[%d]: Command[%x] received a %d byte request, "
+            "expected %d to %u bytes", AR_EBADPARAM, svc_cmd_id,
+            cmd_buf_size, entry->min_req_size, entry->max_req_size);
+        return AR_EBADPARAM;
+    }
+
+    if (rsp_buf_size < entry->min_rsp_size)
+    {
+        ATS_ERR("Error[%d]: Command[%x] needs a %d byte response buffer, "
+            "%d bytes are available", AR_ENEEDMORE, svc_cmd_id,
+            entry->min_rsp_size, rsp_buf_size);
+        return AR_ENEEDMORE;
+    }
+
+    if (!(entry->flags & ATS_CMD_FLAG_SELF_LOCKING) &&
+        !IsNull(cmd_table->lock))
+    {
+        status = cmd_table->lock();
+        if (AR_FAILED(status))
         {
-            if (cur_node->service_id == service_id)
-            {
-                return TRUE;
-            }
+            ATS_ERR("Error[%d]: Failed to lock the service for Command[%x]",
+                status, svc_cmd_id);
+            return status;
+        }
+        is_locked = TRUE;
+    }
+
+    status = entry->handler(cmd_buf, cmd_buf_size,
+        rsp_buf, rsp_buf_size, rsp_buf_bytes_filled);
 
-            cur_node = cur_node->p_next;
+    //Keep the command status, an unlock failure only overrides success
+    if (is_locked)
+    {
+        lock_status = cmd_table->unlock();
+        if (AR_FAILED(lock_status))
+        {
+            ATS_ERR("Error[%d]: Failed to unlock the service after Command[%x]",
+                lock_status, svc_cmd_id);
+            if (AR_SUCCEEDED(status))
+                status = lock_status;
         }
     }
 
-    return FALSE;
+    return status;
 }
 
 /**
@@ -68,6 +68,22 @@ int32_t AtsCmdGetLoadedFileData(
     return status;
 }
 
+int32_t AtsCmdOpenLoadedFile(
+    AcdbFileManGetFileDataReq *req, AcdbFileManFileRegion *rsp)
+{
+    int32_t status = AR_EOK;
+    status = acdb_file_man_ioctl(ACDB_FILE_MAN_OPEN_DATABASE_FILE_SET,
+        req, sizeof(AcdbFileManGetFileDataReq),
+        rsp, sizeof(AcdbFileManFileRegion));
+
+    if (AR_FAILED(status) && AR_EUNSUPPORTED != status)
+    {
+        ATS_ERR("Error[%d]: Failed to open loaded acdb file", status);
+    }
+
+    return status;
+}
+
 int32_t AtsCmdGetHeapEntryInfo(
     acdb_handle_t acdb_handle, AcdbBufferContext *rsp)
 {
@@ -20,6 +20,13 @@
 *------------------------------------------*/
 #include "ar_osal_types.h"
 
+/**< One piece of data in a gathered send */
+typedef struct ats_transport_buffer_t
+{
+    const uint8_t *buffer;
+    uint32_t buffer_size;
+} ats_transport_buffer_t;
+
 /**
 * \brief
 *      The command + response callback used to pass request to the
@@ -35,6 +42,79 @@ typedef void(*ats_cmd_rsp_callback_t)(
     uint8_t *req_buffer, uint32_t req_buffer_length,
     uint8_t **resp_buffer, uint32_t *resp_buffer_length);
 
+/**
+* \brief
+*      Sends part of a streamed response to the client
+*
+* \param [in] transport_ctx: The context passed to ats_cmd_rsp_stream_callback_t
+* \param [in] buffer: The response bytes to send
+* \param [in] buffer_size: The number of bytes to send
+* \return 0 on success, non-zero on failure
+*/
+typedef int32_t(*ats_rsp_stream_write_t)(
+    void *transport_ctx, const uint8_t *buffer, uint32_t buffer_size);
+
+/**
+* \brief
+*      Sends part of a streamed response straight from a file, without
+*      copying it through user space where the platform allows
+*
+* \param [in] transport_ctx: The context passed to ats_cmd_rsp_stream_callback_t
+* \param [in] fd: The file to send from. The caller may close it once the
+*      call returns, a transport that sends later keeps a duplicate
+* \param [in] file_offset: Where in the file the data starts
+* \param [in] length: The number of bytes to send
+* \return 0 on success, non-zero on failure
+*/
+typedef int32_t(*ats_rsp_stream_send_file_t)(
+    void *transport_ctx, int32_t fd, uint32_t file_offset, uint32_t length);
+
+/**
+* \brief
+*      The command + streamed response callback. Commands that support streaming
+*      write their response through write_cb in fixed size chunks instead of
+*      building the whole response in the ATS buffer
+*
+* \param [in] req_buffer: The request buffer containing the command to execute
+* \param [in] req_buffer_length: The length of the request buffer
+* \param [in] write_cb: Called for each chunk of the response
+* \param [in] send_file_cb: Called for response data that is read from a
+*      file. NULL if the transport can only send from memory
+* \param [in] transport_ctx: Passed back to write_cb and send_file_cb
+* \return
+*      AR_EOK if the response was sent,
+*      AR_EUNSUPPORTED if the command does not stream. Nothing was sent, use
+*      ats_cmd_rsp_callback_t instead,
+*      other codes if the response was cut short. The client can no longer
+*      find the next response so the transport must close the connection
+*/
+typedef int32_t(*ats_cmd_rsp_stream_callback_t)(
+    uint8_t *req_buffer, uint32_t req_buffer_length,
+    ats_rsp_stream_write_t write_cb, ats_rsp_stream_send_file_t send_file_cb,
+    void *transport_ctx);
+
+/**< What a transport reports about one of its clients */
+typedef enum ats_client_event_t
+{
+    /**< The client's next request is about to be executed */
+    ATS_CLIENT_EVENT_REQUEST = 0,
+    /**< The client disconnected, it sends no more requests */
+    ATS_CLIENT_EVENT_DISCONNECT
+} ats_client_event_t;
+
+/**
+* \brief
+*      Tells ATS which client requests come from, so state a client leaves
+*      behind can be found when it disconnects
+*
+* \param [in] client_id: Identifies the client within the transport, never
+*      0 and not reused while the transport is running
+* \param [in] event: What happened to the client
+* \return none
+*/
+typedef void(*ats_client_callback_t)(
+    uint32_t client_id, ats_client_event_t event);
+
 /**
 * \brief ats_transport_init
 *      Initializes the transport layer. One or more transports can be initialized depending
@@ -46,6 +126,30 @@ typedef void(*ats_cmd_rsp_callback_t)(
 */
 int32_t ats_transport_init(ats_cmd_rsp_callback_t cmd_rsp_callback);
 
+/**
+* \brief ats_transport_register_stream_callback
+*      Gives transports that can stream responses a callback to
+*      ats_execute_command_stream. Must be called before ats_transport_init
+*
+* \param [in] cmd_rsp_stream_callback: A callback to ats_execute_command_stream
+*
+* \return 0 on success, AR_EUNSUPPORTED if no transport streams responses
+*/
+int32_t ats_transport_register_stream_callback(
+    ats_cmd_rsp_stream_callback_t cmd_rsp_stream_callback);
+
+/**
+* \brief ats_transport_register_client_callback
+*      Gives transports that serve several clients a callback that they
+*      report their clients to. Must be called before ats_transport_init
+*
+* \param [in] client_callback: The callback to report clients to
+*
+* \return 0 on success, AR_EUNSUPPORTED if no transport reports clients
+*/
+int32_t ats_transport_register_client_callback(
+    ats_client_callback_t client_callback);
+
 /**
  * \brief ats_transport_deinit
  *		De-initializes the transport layer by realeasing resources aquired during ats_transport_init
@@ -55,12 +159,13 @@ int32_t ats_transport_deinit(void);
 
 /**
  * \brief ats_transport_dls_send_callback
- *		Sends binary log data through the transport layer
- * \param [in] buffer: the buffer containing the data to send
- * \param [in] buffer_size: the size of the buffer
+ *		Sends binary log data through the transport layer. The buffers are
+ *		sent back to back, in order, as one message
+ * \param [in] buffers: the buffers containing the data to send
+ * \param [in] buffer_count: the number of buffers
  * \return 0 on success, non-zero on failure
  */
-int32_t ats_transport_dls_send_callback(const uint8_t* buffer, uint32_t buffer_size);
+int32_t ats_transport_dls_send_callback(const ats_transport_buffer_t* buffers, uint32_t buffer_count);
 
 #endif /*_ATS_TRANSPORT_API_H_*/
 
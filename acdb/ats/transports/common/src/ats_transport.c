@@ -65,6 +65,30 @@ int32_t ats_transport_init(ats_cmd_rsp_callback_t cmd_rsp_callback)
     return status;
 }
 
+int32_t ats_transport_register_stream_callback(
+    ats_cmd_rsp_stream_callback_t cmd_rsp_stream_callback)
+{
+    #if defined(ATS_TRANSPORT_TCPIP)
+    return tcpip_cmd_server_set_stream_callback(cmd_rsp_stream_callback);
+    #else
+    __UNREFERENCED_PARAM(cmd_rsp_stream_callback);
+    /* Diag hands ATS one request buffer and takes back one response buffer */
+    return AR_EUNSUPPORTED;
+    #endif
+}
+
+int32_t ats_transport_register_client_callback(
+    ats_client_callback_t client_callback)
+{
+    #if defined(ATS_TRANSPORT_TCPIP)
+    return tcpip_cmd_server_set_client_callback(client_callback);
+    #else
+    __UNREFERENCED_PARAM(client_callback);
+    /* Diag requests carry nothing that tells clients apart */
+    return AR_EUNSUPPORTED;
+    #endif
+}
+
 int32_t ats_transport_deinit(void)
 {
     int32_t status = AR_EOK;
@@ -92,16 +116,16 @@ int32_t ats_transport_deinit(void)
     return status;
 }
 
-int32_t ats_transport_dls_send_callback(const uint8_t* buffer, uint32_t buffer_size)
+int32_t ats_transport_dls_send_callback(const ats_transport_buffer_t* buffers, uint32_t buffer_count)
 {
 	#if defined(ATS_TRANSPORT_TCPIP)
 
-	ATS_TRANSPORT_DBG("Sending %d bytes", buffer_size);
-	return tcpip_cmd_server_send_dls_log_data(buffer, buffer_size);
+	ATS_TRANSPORT_DBG("Sending %d buffers", buffer_count);
+	return tcpip_cmd_server_send_dls_log_data(buffers, buffer_count);
 
 	#else
-	__UNREFERENCED_PARAM(buffer);
-	__UNREFERENCED_PARAM(buffer_size);
+	__UNREFERENCED_PARAM(buffers);
+	__UNREFERENCED_PARAM(buffer_count);
 	/* We dont need to support diag since it already has support for pushing
 	 * binary log packets to the ats realtime tuning client */
 
@@ -422,14 +422,16 @@ void* ats_server_start_routine(void* arg)
 
 			char threadName[32];
             ACDB_STR_CPY_SAFE(threadName, 32, ATS_THREAD_TRANSMIT, strlen(ATS_THREAD_TRANSMIT));
-			ar_osal_thread_attr_t thd_attr = \
+			ar_osal_thread_attr_ext_t thd_attr = \
 			{
-				threadName,
-					ATS_THD_STACK_SIZE,
-					ATS_THREAD_PRIORITY_HIGH
+				sizeof(ar_osal_thread_attr_ext_t),
+				{ threadName, ATS_THD_STACK_SIZE, ATS_THREAD_PRIORITY_HIGH },
+				AR_OSAL_THREAD_SCHED_OTHER,
+				0,
+				ATS_THREAD_CPU_MASK
 			};
 
-			status = ar_osal_thread_create(&thd_ats_transmit, &thd_attr,
+			status = ar_osal_thread_create_ext(&thd_ats_transmit, &thd_attr,
                 routine, gateway_socket_ptr);
             if (AR_FAILED(status))
 			{
@@ -734,17 +736,19 @@ int32_t ats_server_init(void(*ats_cb)(uint8_t *buf, uint32_t buf_len, uint8_t **
     char threadName[32];
     ACDB_STR_CPY_SAFE(threadName, 32, ATS_THREAD_LISTENER, strlen(ATS_THREAD_LISTENER));
 
-    ar_osal_thread_attr_t thd_attr =
+    ar_osal_thread_attr_ext_t thd_attr =
     {
-        threadName,
-        ATS_THD_STACK_SIZE,
-        ATS_THREAD_PRIORITY_HIGH
+        sizeof(ar_osal_thread_attr_ext_t),
+        { threadName, ATS_THD_STACK_SIZE, ATS_THREAD_PRIORITY_HIGH },
+        AR_OSAL_THREAD_SCHED_OTHER,
+        0,
+        ATS_THREAD_CPU_MASK
     };
 
     ar_osal_thread_start_routine routine = \
         (ar_osal_thread_start_routine)ats_server_start_routine;
 
-    status = ar_osal_thread_create(&g_thd_ats_listener, &thd_attr, routine, NULL);
+    status = ar_osal_thread_create_ext(&g_thd_ats_listener, &thd_attr, routine, NULL);
 
     if (AR_FAILED(status))
     {
@@ -98,7 +98,7 @@
         - AR_EBADPARAM -- Invalid input parameters were provided.
         - AR_EFAILED -- Command execution failed.
 
-    \sa ats_online_ioctl
+    \sa ats_online_cmd_table
 */
 #define ATS_CMD_ONC_SET_MAX_BUFFER_LENGTH ATS_ONLINE_CMD_ID(4)
 /** \} */ /* end_addtogroup ATS_CMD_ONC_SET_MAX_BUFFER_LENGTH */
@@ -0,0 +1,278 @@
+#ifndef _TCPIP_GATEWAY_MUX_SESSION_H_
+#define _TCPIP_GATEWAY_MUX_SESSION_H_
+/**
+*==============================================================================
+*  \file tcpip_gateway_mux_session.h
+*  \brief
+*              T C P I P  G A T E W A Y  M U X  S E S S I O N
+*                             H E A D E R  F I L E
+*
+*         This file defines the class for a multiplexed gateway session as
+*         well as the framing used on the connection. A multiplexed session
+*         carries several command streams and a DLS stream over the single
+*         connection a client makes to the gateway command port. Each stream
+*         is backed by its own connection to an ATS server.
+*
+*  \copyright
+*      Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+*      SPDX-License-Identifier: BSD-3-Clause
+*==============================================================================
+*/
+
+/*-------------------------------------
+ *             Includes
+ *-----------------------------------*/
+#include <string>
+#include "ar_osal_error.h"
+#include "ar_osal_heap.h"
+#include "ar_sockets_api.h"
+#include "tcpip_gateway_common.h"
+
+/* Multiplexed Session Framing
+ *
+ * A client selects a multiplexed session by sending the hello below as the
+ * first bytes on the connection. Legacy clients start with an ATS request
+ * instead and are served as before. The gateway answers with its own hello.
+ *
+ * <--------- 4 bytes ----------->
+ * +-----------------------------+
+ * |        'A' 'G' 'M' 'X'      |
+ * +-----------------------------+
+ * |   version    | max streams  |
+ * +_____________________________+
+ *
+ * All traffic after the hello is sent in frames:
+ *
+ * <--------- 4 bytes ----------->
+ * +-----------------------------+
+ * |  stream id   | type | flags |
+ * +-----------------------------+
+ * |       payload length        |
+ * +_____________________________+
+ * |                             |
+ * |           payload           |
+ * |            ...              |
+ * +~.-~.-~.-~.-~.-~.-~.-~.-~.-~.+
+ *
+ * The client picks the stream id (non-zero) when it opens a stream. DATA
+ * payloads are forwarded to and from the backend as a byte stream, so an
+ * ATS message may span several frames and the receiver reassembles it
+ * using the ATS header. The gateway reads at most one payload from each
+ * backend per scheduling round, so a large response on one stream does
+ * not hold up the others.
+ *
+ * All sockets of a session are non-blocking. Data for a backend is queued
+ * on its stream and written as the backend reads it, so a backend that is
+ * busy does not hold up the client or the other streams. Only when a
+ * stream has TGWS_MUX_STREAM_MAX_PENDING_SIZE bytes queued does the
+ * gateway stop reading client frames until that backend catches up.
+ */
+
+/**< First 4 bytes of a multiplexed session, 'A''G''M''X' */
+#define TGWS_MUX_MAGIC                      0x584D4741ul
+#define TGWS_MUX_VERSION                    1
+#define TGWS_MUX_HELLO_LENGTH               8
+#define TGWS_MUX_FRAME_HEADER_LENGTH        8
+ /**< Maximum number of streams open at once on one session */
+#define TGWS_MUX_MAX_STREAMS                8
+ /**< Largest frame payload in either direction */
+#define TGWS_MUX_MAX_PAYLOAD_SIZE           (1024UL * 16UL)
+ /**< Stream id 0 addresses the session itself, closing it ends the session */
+#define TGWS_MUX_SESSION_STREAM_ID          0
+ /**< Frames queued for the client before the backends are no longer read */
+#define TGWS_MUX_CLIENT_SEND_BUFFER_SIZE    \
+    (4UL * (TGWS_MUX_FRAME_HEADER_LENGTH + TGWS_MUX_MAX_PAYLOAD_SIZE))
+ /**< Most client data queued for one backend, fits the largest ATS request */
+#define TGWS_MUX_STREAM_MAX_PENDING_SIZE    (1024UL * 1024UL * 4UL)
+ /**< How long a new client has to send its first bytes before it is served
+  * as a legacy client */
+#define TGWS_MUX_HELLO_TIMEOUT_MS           3000
+
+/**< Defines the frame types of a multiplexed session */
+typedef enum tgws_mux_frame_type_t
+{
+    /**< Client to gateway, payload is tgws_mux_open_req_t */
+    TGWS_MUX_FRAME_OPEN         = 1,
+    /**< Gateway to client, payload is the int32 open status */
+    TGWS_MUX_FRAME_OPEN_ACK     = 2,
+    /**< Either direction, payload is stream data */
+    TGWS_MUX_FRAME_DATA         = 3,
+    /**< Either direction, payload is an optional int32 status */
+    TGWS_MUX_FRAME_CLOSE        = 4
+}tgws_mux_frame_type_t;
+
+/**< Defines the kinds of backend a stream can be opened on */
+typedef enum tgws_mux_stream_type_t
+{
+    /**< Command/response stream to an ATS command server */
+    TGWS_MUX_STREAM_CMD         = 0,
+    /**< Log packets from the ATS DLS server, gateway to client only */
+    TGWS_MUX_STREAM_DLS         = 1
+}tgws_mux_stream_type_t;
+
+typedef struct tgws_mux_hello_t
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t max_streams;
+}tgws_mux_hello_t;
+
+typedef struct tgws_mux_frame_header_t
+{
+    uint16_t stream_id;
+    uint8_t frame_type;
+    uint8_t flags;
+    uint32_t payload_length;
+}tgws_mux_frame_header_t;
+
+/**< The OPEN frame payload. An optional backend socket name follows the
+ * structure. It must start with the default socket name of the stream type,
+ * e.g. #AtsCmdServer2, so clients can only reach ATS servers. */
+typedef struct tgws_mux_open_req_t
+{
+    /**< One of tgws_mux_stream_type_t */
+    uint32_t stream_type;
+    /**< Backend TCP/IP port, 0 for the default. Unused for unix sockets */
+    uint32_t port;
+}tgws_mux_open_req_t;
+
+typedef struct tgws_mux_stream_t
+{
+    uint16_t stream_id;
+    uint16_t stream_type;
+    bool_t is_open;
+    ar_socket_t socket;
+    /**< Client data not yet written to the backend, from send_offset to
+     * send_length. Allocated when the first data arrives */
+    buffer_t send_buffer;
+    uint32_t send_offset;
+    uint32_t send_length;
+}tgws_mux_stream_t;
+
+class TcpipGatewayMuxSession {
+private:
+    ar_socket_t client_socket;
+    tgws_mux_stream_t streams[TGWS_MUX_MAX_STREAMS];
+    /**< Stream slot served first in the next scheduling round */
+    uint32_t next_stream_index;
+    /**< Set when a stream is opened or closed while handling a client frame */
+    bool_t streams_changed;
+    /**< Set when a received frame has to wait for buffer space */
+    bool_t is_client_blocked;
+    /**< Client frames received, the unhandled ones from recv_offset to recv_length */
+    buffer_t recv_buffer;
+    uint32_t recv_offset;
+    uint32_t recv_length;
+    /**< Frames for the client, the unsent ones from send_offset to send_length */
+    buffer_t send_buffer;
+    uint32_t send_offset;
+    uint32_t send_length;
+
+public:
+    TcpipGatewayMuxSession(ar_socket_t client_socket);
+    ~TcpipGatewayMuxSession();
+
+    /**
+    * \brief
+    *	  Checks whether a newly accepted client starts a multiplexed session
+    *     by peeking at the first bytes it sent. Nothing is consumed. Waits at
+    *     most TGWS_MUX_HELLO_TIMEOUT_MS for the client to send them.
+    *
+    * \param [in] client_socket: The accepted client socket
+    *
+    * \return TRUE if the client sent the multiplexed session hello
+    */
+    static bool_t is_mux_client(ar_socket_t client_socket);
+
+    /**
+    * \brief
+    *	  Runs the session until the client disconnects or closes stream 0.
+    *     Backend connections are closed on return, the client socket is not.
+    *
+    * \return AR_EOK if the session ended normally, otherwise non-zero
+    */
+    int32_t run();
+
+private:
+    int32_t handshake();
+
+    /**
+    * \brief
+    *	  Receives what the client sent without blocking
+    *
+    * \return AR_EOK on success, otherwise non-zero if the client disconnected
+    */
+    int32_t read_client();
+
+    /**
+    * \brief
+    *	  Handles the complete frames received from the client. Stops at a
+    *     frame that has to wait for buffer space and sets is_client_blocked.
+    *
+    * \param [out] status_code: Set to TGWS_E_END_MSG_FWD when the session ends
+    *
+    * \return AR_EOK on success, otherwise non-zero on failure
+    */
+    int32_t process_client_frames(tgws_status_codes_t &status_code);
+
+    /**
+    * \brief
+    *	  Handles one frame from the client
+    *
+    * \param [in] header: The frame header
+    * \param [in] payload: The frame payload
+    * \param [out] status_code: Set to TGWS_E_END_MSG_FWD when the session ends
+    *
+    * \return AR_EOK on success, otherwise non-zero on failure
+    */
+    int32_t handle_client_frame(const tgws_mux_frame_header_t &header,
+        char_t *payload, tgws_status_codes_t &status_code);
+
+    /**
+    * \brief
+    *	  Reads at most one payload from a stream's backend and queues it for
+    *     the client. Closes the stream if the backend disconnected.
+    */
+    int32_t forward_backend(tgws_mux_stream_t *stream);
+
+    /**
+    * \brief
+    *	  Queues client data for a stream's backend and writes what the
+    *     backend accepts without blocking
+    */
+    int32_t queue_stream_data(tgws_mux_stream_t *stream,
+        const char_t *data, uint32_t length);
+
+    /**
+    * \brief
+    *	  Writes queued data to a stream's backend until it would block
+    */
+    int32_t flush_stream(tgws_mux_stream_t *stream);
+
+    /**
+    * \brief
+    *	  Writes queued frames to the client until it would block
+    */
+    int32_t flush_client();
+
+    /* Free space at the end of the client send buffer after compacting it */
+    uint32_t get_client_send_space();
+
+    int32_t open_stream(uint16_t stream_id, char_t *payload, uint32_t payload_length);
+    void close_stream(tgws_mux_stream_t *stream, int32_t status, bool_t notify_client);
+    tgws_mux_stream_t *find_stream(uint16_t stream_id);
+
+    int32_t connect_backend(uint32_t stream_type, uint32_t port,
+        std::string backend_name, ar_socket_t *backend_socket);
+
+    int32_t send_frame(uint16_t stream_id, uint8_t frame_type,
+        const char_t *payload, uint32_t payload_length);
+    int32_t send_status_frame(uint16_t stream_id, uint8_t frame_type, int32_t status);
+
+    static int32_t send_all(ar_socket_t socket, const char_t *buf, uint32_t length);
+    static int32_t recv_all(ar_socket_t socket, char_t *buf, uint32_t length);
+    static int32_t send_nonblocking(ar_socket_t socket, const char_t *buf,
+        uint32_t *offset, uint32_t length);
+};
+
+#endif /*_TCPIP_GATEWAY_MUX_SESSION_H_*/
@@ -24,6 +24,7 @@
 
 #include "tcpip_gateway_cmd_server.h"
 #include "tcpip_gateway_socket_util.h"
+#include "tcpip_gateway_mux_session.h"
 #include <thread>
 #include <chrono>
 
@@ -384,6 +385,20 @@ void* TcpipGatewayServer::connect_routine(void* arg)
 			inet_ntop(AF_INET, &(sin->sin_addr), str, INET_ADDRSTRLEN);
 			GATEWAY_INFO("Connection from: %s:%d", str, pc_port);
 
+			/* Multiplexed clients open their own command and dls streams,
+			 * so neither the target connection nor the dls server is needed */
+			if (TcpipGatewayMuxSession::is_mux_client(client_socket_temp))
+			{
+				TcpipGatewayMuxSession mux_session{ client_socket_temp };
+				status = mux_session.run();
+				if (AR_FAILED(status))
+				{
+					GATEWAY_ERR("Error[%d]: Multiplexed session ended with an error", status);
+				}
+				ar_socket_close(client_socket_temp);
+				continue;
+			}
+
 			//ar_socket_close(listen_socket);
 			status = connect_to_target_server(server_socket_ptr);
 			if (AR_FAILED(status))
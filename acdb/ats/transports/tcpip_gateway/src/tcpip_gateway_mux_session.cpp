@@ -0,0 +1,820 @@
+/**
+*==============================================================================
+*  \file tcpip_gateway_mux_session.cpp
+*  \brief
+*              T C P I P  G A T E W A Y  M U X  S E S S I O N
+*                             S O U R C E  F I L E
+*
+*         Contains the implementation of a multiplexed gateway session. The
+*         session owns one backend connection per open stream and schedules
+*         the backends round robin when sending to the client. The session
+*         sockets are non-blocking and data in either direction is queued
+*         until the peer reads it. See tcpip_gateway_mux_session.h for the
+*         framing.
+*
+*  \copyright
+*      Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+*      SPDX-License-Identifier: BSD-3-Clause
+*==============================================================================
+*/
+
+#include "tcpip_gateway_mux_session.h"
+#include "tcpip_gateway_socket_util.h"
+#include "ar_osal_string.h"
+#include "ar_osal_sleep.h"
+
+#if defined(_WIN32)
+#define tgws_poll WSAPoll
+#define TGWS_MUX_SEND_FLAGS 0
+#define TGWS_MUX_WOULD_BLOCK(error) (WSAEWOULDBLOCK == (error))
+#else
+#include <fcntl.h>
+#include <poll.h>
+#define tgws_poll poll
+/* A client or backend that disconnects must not kill the gateway */
+#define TGWS_MUX_SEND_FLAGS MSG_NOSIGNAL
+#define TGWS_MUX_WOULD_BLOCK(error) (EAGAIN == (error) || EWOULDBLOCK == (error))
+#endif
+
+/* The names and ports of the ATS servers backing each stream type */
+#define ATS_UNIX_SOCKET_ABSTRACT_DOMAIN_NAME_ATS_CMD "#AtsCmdServer"
+#define ATS_UNIX_SOCKET_ABSTRACT_DOMAIN_NAME_ATS_DLS "#AtsDlsServer"
+#define TCPIP_ATS_CMD_SERVER_PORT 5559
+#define TCPIP_ATS_DLS_SERVER_PORT 5561
+#define TGWS_MUX_LOCALHOST_ADDRESS "127.0.0.1"
+/* How long is_mux_client waits between peeks at a partial hello */
+#define TGWS_MUX_HELLO_POLL_INTERVAL_MS 10
+/* The largest frame the gateway sends besides DATA, a status frame */
+#define TGWS_MUX_STATUS_FRAME_LENGTH (TGWS_MUX_FRAME_HEADER_LENGTH + sizeof(int32_t))
+
+static struct ar_heap_info_t tgws_mux_heap_info =
+{
+    AR_HEAP_ALIGN_DEFAULT,
+    AR_HEAP_POOL_DEFAULT,
+    AR_HEAP_ID_DEFAULT,
+    AR_HEAP_TAG_DEFAULT
+};
+
+static int32_t tgws_mux_set_nonblocking(ar_socket_t socket)
+{
+#if defined(_WIN32)
+    u_long mode = 1;
+
+    return 0 == ioctlsocket(socket, FIONBIO, &mode) ? AR_EOK : AR_EFAILED;
+#else
+    int flags = fcntl(socket, F_GETFL, 0);
+
+    if (0 > flags || 0 > fcntl(socket, F_SETFL, flags | O_NONBLOCK))
+        return AR_EFAILED;
+    return AR_EOK;
+#endif
+}
+
+/*
+============================================================================
+                   TCPIP Gateway Mux Session Implementation
+============================================================================
+*/
+
+TcpipGatewayMuxSession::TcpipGatewayMuxSession(ar_socket_t client_socket)
+    : client_socket{ client_socket }, next_stream_index{ 0 }, streams_changed{ FALSE },
+    is_client_blocked{ FALSE }, recv_offset{ 0 }, recv_length{ 0 },
+    send_offset{ 0 }, send_length{ 0 }
+{
+    ar_mem_set(streams, 0, sizeof(streams));
+
+    recv_buffer.buffer_size = TGWS_MUX_FRAME_HEADER_LENGTH + TGWS_MUX_MAX_PAYLOAD_SIZE;
+    recv_buffer.buffer = (char_t*)ar_heap_malloc(recv_buffer.buffer_size, &tgws_mux_heap_info);
+
+    send_buffer.buffer_size = TGWS_MUX_CLIENT_SEND_BUFFER_SIZE;
+    send_buffer.buffer = (char_t*)ar_heap_malloc(send_buffer.buffer_size, &tgws_mux_heap_info);
+}
+
+TcpipGatewayMuxSession::~TcpipGatewayMuxSession()
+{
+    for (uint32_t i = 0; i < TGWS_MUX_MAX_STREAMS; i++)
+    {
+        if (streams[i].is_open)
+            close_stream(&streams[i], AR_EOK, FALSE);
+    }
+
+    if (NULL != recv_buffer.buffer)
+        ar_heap_free(recv_buffer.buffer, &tgws_mux_heap_info);
+    if (NULL != send_buffer.buffer)
+        ar_heap_free(send_buffer.buffer, &tgws_mux_heap_info);
+}
+
+bool_t TcpipGatewayMuxSession::is_mux_client(ar_socket_t client_socket)
+{
+    uint32_t magic = 0;
+    uint32_t mux_magic = TGWS_MUX_MAGIC;
+    int32_t bytes_read = 0;
+    int32_t wait_ms = TGWS_MUX_HELLO_TIMEOUT_MS;
+    struct pollfd fds = { 0 };
+
+    /* A client that sends nothing in time is a legacy client, which sends
+     * its first request whenever it likes */
+    while (wait_ms > 0)
+    {
+        fds.fd = client_socket;
+        fds.events = POLLIN;
+        fds.revents = 0;
+        bytes_read = tgws_poll(&fds, 1, wait_ms);
+        if (0 > bytes_read && AR_SOCKET_LAST_ERROR == EINTR)
+            continue;
+        if (0 >= bytes_read)
+            return FALSE;
+
+        /* Does not block, the socket is readable */
+        bytes_read = recv(client_socket, (char*)&magic, sizeof(magic), MSG_PEEK);
+        if (0 >= bytes_read)
+            return FALSE;
+        if (sizeof(magic) == (uint32_t)bytes_read)
+            return TGWS_MUX_MAGIC == magic;
+
+        /* Wait for the rest of a partial hello */
+        if (0 != memcmp(&magic, &mux_magic, (size_t)bytes_read))
+            return FALSE;
+        ar_osal_micro_sleep(TGWS_MUX_HELLO_POLL_INTERVAL_MS * 1000);
+        wait_ms -= TGWS_MUX_HELLO_POLL_INTERVAL_MS;
+    }
+
+    return FALSE;
+}
+
+int32_t TcpipGatewayMuxSession::run()
+{
+    int32_t status = AR_EOK;
+    struct pollfd fds[TGWS_MUX_MAX_STREAMS + 1];
+    int32_t fd_index[TGWS_MUX_MAX_STREAMS];
+    short events = 0;
+    short client_revents = 0;
+    uint32_t num_fds = 0;
+    uint32_t send_space = 0;
+    uint32_t stream_index = 0;
+    short revents = 0;
+    tgws_mux_stream_t *stream = NULL;
+    tgws_status_codes_t status_code = TGWS_E_SUCCESS;
+
+    if (NULL == recv_buffer.buffer || NULL == send_buffer.buffer)
+    {
+        GATEWAY_ERR("Error[%d]: Failed to allocate mux session buffers", AR_ENOMEMORY);
+        return AR_ENOMEMORY;
+    }
+
+    status = handshake();
+    if (AR_FAILED(status))
+        return status;
+
+    status = tgws_mux_set_nonblocking(client_socket);
+    if (AR_FAILED(status))
+    {
+        GATEWAY_ERR("Error[%d]: Failed to make the client socket non-blocking", status);
+        return status;
+    }
+
+    GATEWAY_INFO("Multiplexed session started");
+
+    while (TGWS_E_END_MSG_FWD != status_code)
+    {
+        /* A socket with nothing to do is left out, so a hang up on it does
+         * not wake the loop before there is room to handle it. The client
+         * is always in slot 0, unused when it is left out. */
+        num_fds = 1;
+        fds[0].fd = client_socket;
+        fds[0].events = is_client_blocked ? 0 : POLLIN;
+        if (send_offset < send_length)
+            fds[0].events |= POLLOUT;
+        fds[0].revents = 0;
+        send_space = get_client_send_space();
+        for (uint32_t i = 0; i < TGWS_MUX_MAX_STREAMS; i++)
+        {
+            fd_index[i] = -1;
+            if (!streams[i].is_open)
+                continue;
+            /* A backend is read only when a full payload fits in the send
+             * buffer, and served at all only when a close frame would fit */
+            events = send_space >= TGWS_MUX_FRAME_HEADER_LENGTH + TGWS_MUX_MAX_PAYLOAD_SIZE ?
+                POLLIN : 0;
+            if (streams[i].send_offset < streams[i].send_length &&
+                send_space >= TGWS_MUX_STATUS_FRAME_LENGTH)
+                events |= POLLOUT;
+            if (0 == events)
+                continue;
+            fds[num_fds].fd = streams[i].socket;
+            fds[num_fds].events = events;
+            fds[num_fds].revents = 0;
+            fd_index[i] = (int32_t)num_fds++;
+        }
+
+        if (0 > tgws_poll(0 == fds[0].events ? &fds[1] : fds,
+            0 == fds[0].events ? num_fds - 1 : num_fds, -1))
+        {
+            if (AR_SOCKET_LAST_ERROR == EINTR)
+                continue;
+            GATEWAY_ERR("Error[%d]: Mux session poll failed", AR_EFAILED);
+            status = AR_EFAILED;
+            break;
+        }
+
+        client_revents = 0 == fds[0].events ? 0 : fds[0].revents;
+        if (client_revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            status = read_client();
+            if (AR_FAILED(status))
+            {
+                GATEWAY_INFO("Mux session client disconnected");
+                status = AR_EOK;
+                break;
+            }
+        }
+
+        /* Frames left waiting for space in an earlier round are retried too */
+        streams_changed = FALSE;
+        status = process_client_frames(status_code);
+        if (AR_FAILED(status) || TGWS_E_END_MSG_FWD == status_code)
+            break;
+
+        /* The backends are served round robin, at most one payload each. The
+         * backend served first rotates so no stream is always ahead. */
+        for (uint32_t i = 0; i < TGWS_MUX_MAX_STREAMS && !streams_changed; i++)
+        {
+            stream_index = (next_stream_index + i) % TGWS_MUX_MAX_STREAMS;
+            stream = &streams[stream_index];
+            if (-1 == fd_index[stream_index] || !stream->is_open)
+                continue;
+            if (get_client_send_space() < TGWS_MUX_STATUS_FRAME_LENGTH)
+                break;
+
+            revents = fds[fd_index[stream_index]].revents;
+            if ((revents & (POLLOUT | POLLERR)) && AR_FAILED(flush_stream(stream)))
+            {
+                GATEWAY_ERR("Error[%d]: Failed to forward data to the backend of stream %d",
+                    AR_EFAILED, stream->stream_id);
+                close_stream(stream, AR_EFAILED, TRUE);
+                continue;
+            }
+
+            if (revents & (POLLIN | POLLHUP | POLLERR))
+                (void)forward_backend(stream);
+        }
+        next_stream_index = (next_stream_index + 1) % TGWS_MUX_MAX_STREAMS;
+
+        status = flush_client();
+        if (AR_FAILED(status))
+        {
+            GATEWAY_INFO("Mux session client disconnected");
+            status = AR_EOK;
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < TGWS_MUX_MAX_STREAMS; i++)
+    {
+        if (streams[i].is_open)
+            close_stream(&streams[i], AR_EOK, FALSE);
+    }
+
+    GATEWAY_INFO("Multiplexed session ended");
+    return status;
+}
+
+int32_t TcpipGatewayMuxSession::handshake()
+{
+    int32_t status = AR_EOK;
+    tgws_mux_hello_t hello = { 0 };
+
+    status = recv_all(client_socket, (char_t*)&hello, TGWS_MUX_HELLO_LENGTH);
+    if (AR_FAILED(status) || TGWS_MUX_MAGIC != hello.magic)
+    {
+        GATEWAY_ERR("Error[%d]: Invalid mux session hello", AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    if (TGWS_MUX_VERSION != hello.version)
+    {
+        GATEWAY_ERR("Error[%d]: Mux session version %d is not supported, using %d",
+            AR_EUNSUPPORTED, hello.version, TGWS_MUX_VERSION);
+    }
+
+    /* The client compares the version and stream limit we reply with */
+    hello.magic = TGWS_MUX_MAGIC;
+    hello.version = TGWS_MUX_VERSION;
+    hello.max_streams = TGWS_MUX_MAX_STREAMS;
+    return send_all(client_socket, (char_t*)&hello, TGWS_MUX_HELLO_LENGTH);
+}
+
+int32_t TcpipGatewayMuxSession::read_client()
+{
+    int32_t bytes_read = 0;
+
+    /* Move the partial frame left over to the front */
+    if (recv_offset > 0)
+    {
+        if (recv_length > recv_offset)
+            memmove(recv_buffer.buffer, recv_buffer.buffer + recv_offset,
+                recv_length - recv_offset);
+        recv_length -= recv_offset;
+        recv_offset = 0;
+    }
+
+    while (recv_length < recv_buffer.buffer_size)
+    {
+        bytes_read = recv(client_socket, recv_buffer.buffer + recv_length,
+            recv_buffer.buffer_size - recv_length, 0);
+        if (0 < bytes_read)
+        {
+            recv_length += (uint32_t)bytes_read;
+            continue;
+        }
+        if (0 == bytes_read)
+            return AR_ENOTEXIST;
+        if (AR_SOCKET_LAST_ERROR == EINTR)
+            continue;
+        if (TGWS_MUX_WOULD_BLOCK(AR_SOCKET_LAST_ERROR))
+            break;
+        return AR_EFAILED;
+    }
+
+    return AR_EOK;
+}
+
+int32_t TcpipGatewayMuxSession::process_client_frames(tgws_status_codes_t &status_code)
+{
+    int32_t status = AR_EOK;
+    uint32_t frame_length = 0;
+    tgws_mux_frame_header_t header = { 0 };
+    tgws_mux_stream_t *stream = NULL;
+
+    is_client_blocked = FALSE;
+    while (recv_length - recv_offset >= TGWS_MUX_FRAME_HEADER_LENGTH)
+    {
+        ar_mem_cpy(&header, TGWS_MUX_FRAME_HEADER_LENGTH,
+            recv_buffer.buffer + recv_offset, TGWS_MUX_FRAME_HEADER_LENGTH);
+
+        /* The stream cannot be resynchronized after an oversized frame */
+        if (header.payload_length > TGWS_MUX_MAX_PAYLOAD_SIZE)
+        {
+            GATEWAY_ERR("Error[%d]: Frame of %d bytes on stream %d exceeds the %d byte limit",
+                AR_ENEEDMORE, header.payload_length, header.stream_id, TGWS_MUX_MAX_PAYLOAD_SIZE);
+            status_code = TGWS_E_END_MSG_FWD;
+            return AR_ENEEDMORE;
+        }
+
+        /* read_client() makes room for the rest of the frame */
+        frame_length = TGWS_MUX_FRAME_HEADER_LENGTH + header.payload_length;
+        if (recv_length - recv_offset < frame_length)
+            break;
+
+        /* Every frame may be answered with a status frame. Data for a backend
+         * waits until the stream has room for it. */
+        stream = TGWS_MUX_FRAME_DATA == header.frame_type ?
+            find_stream(header.stream_id) : NULL;
+        if (get_client_send_space() < TGWS_MUX_STATUS_FRAME_LENGTH ||
+            (NULL != stream && TGWS_MUX_STREAM_CMD == stream->stream_type &&
+            stream->send_length - stream->send_offset + header.payload_length >
+            TGWS_MUX_STREAM_MAX_PENDING_SIZE))
+        {
+            is_client_blocked = TRUE;
+            break;
+        }
+
+        status = handle_client_frame(header,
+            recv_buffer.buffer + recv_offset + TGWS_MUX_FRAME_HEADER_LENGTH, status_code);
+        recv_offset += frame_length;
+        if (AR_FAILED(status) || TGWS_E_END_MSG_FWD == status_code)
+            return status;
+    }
+
+    if (recv_offset == recv_length)
+        recv_offset = recv_length = 0;
+
+    return AR_EOK;
+}
+
+int32_t TcpipGatewayMuxSession::handle_client_frame(const tgws_mux_frame_header_t &header,
+    char_t *payload, tgws_status_codes_t &status_code)
+{
+    int32_t status = AR_EOK;
+    tgws_mux_stream_t *stream = NULL;
+
+    switch (header.frame_type)
+    {
+    case TGWS_MUX_FRAME_OPEN:
+        status = open_stream(header.stream_id, payload, header.payload_length);
+        return send_status_frame(header.stream_id, TGWS_MUX_FRAME_OPEN_ACK, status);
+    case TGWS_MUX_FRAME_DATA:
+        stream = find_stream(header.stream_id);
+        if (NULL == stream)
+        {
+            GATEWAY_ERR("Error[%d]: Data for stream %d which is not open",
+                AR_ENOTEXIST, header.stream_id);
+            return send_status_frame(header.stream_id, TGWS_MUX_FRAME_CLOSE, AR_ENOTEXIST);
+        }
+        if (TGWS_MUX_STREAM_DLS == stream->stream_type)
+        {
+            GATEWAY_DBG("Dropping %d bytes sent on dls stream %d",
+                header.payload_length, header.stream_id);
+            return AR_EOK;
+        }
+        status = queue_stream_data(stream, payload, header.payload_length);
+        if (AR_FAILED(status))
+        {
+            GATEWAY_ERR("Error[%d]: Failed to forward data to the backend of stream %d",
+                status, header.stream_id);
+            close_stream(stream, status, TRUE);
+        }
+        return AR_EOK;
+    case TGWS_MUX_FRAME_CLOSE:
+        if (TGWS_MUX_SESSION_STREAM_ID == header.stream_id)
+        {
+            status_code = TGWS_E_END_MSG_FWD;
+            return AR_EOK;
+        }
+        stream = find_stream(header.stream_id);
+        if (NULL == stream)
+            return AR_EOK;
+        close_stream(stream, AR_EOK, FALSE);
+        return send_status_frame(header.stream_id, TGWS_MUX_FRAME_CLOSE, AR_EOK);
+    default:
+        GATEWAY_ERR("Error[%d]: Unknown frame type %d on stream %d",
+            AR_EUNSUPPORTED, header.frame_type, header.stream_id);
+        return AR_EOK;
+    }
+}
+
+int32_t TcpipGatewayMuxSession::forward_backend(tgws_mux_stream_t *stream)
+{
+    int32_t bytes_read = 0;
+    uint32_t max_payload = get_client_send_space() - TGWS_MUX_FRAME_HEADER_LENGTH;
+    char_t *frame = send_buffer.buffer + send_length;
+    tgws_mux_frame_header_t header = { 0 };
+
+    if (max_payload > TGWS_MUX_MAX_PAYLOAD_SIZE)
+        max_payload = TGWS_MUX_MAX_PAYLOAD_SIZE;
+
+    do
+    {
+        bytes_read = recv(stream->socket, frame + TGWS_MUX_FRAME_HEADER_LENGTH,
+            max_payload, 0);
+    } while (0 > bytes_read && AR_SOCKET_LAST_ERROR == EINTR);
+
+    if (0 > bytes_read && TGWS_MUX_WOULD_BLOCK(AR_SOCKET_LAST_ERROR))
+        return AR_EOK;
+
+    if (0 >= bytes_read)
+    {
+        GATEWAY_INFO("Backend of stream %d disconnected", stream->stream_id);
+        close_stream(stream, AR_ENOTEXIST, TRUE);
+        return AR_EOK;
+    }
+
+    header.stream_id = stream->stream_id;
+    header.frame_type = TGWS_MUX_FRAME_DATA;
+    header.payload_length = (uint32_t)bytes_read;
+    ar_mem_cpy(frame, TGWS_MUX_FRAME_HEADER_LENGTH, &header, TGWS_MUX_FRAME_HEADER_LENGTH);
+    send_length += TGWS_MUX_FRAME_HEADER_LENGTH + (uint32_t)bytes_read;
+
+    return AR_EOK;
+}
+
+int32_t TcpipGatewayMuxSession::queue_stream_data(tgws_mux_stream_t *stream,
+    const char_t *data, uint32_t length)
+{
+    uint32_t pending = stream->send_length - stream->send_offset;
+    uint32_t buffer_size = stream->send_buffer.buffer_size;
+    char_t *buffer = NULL;
+
+    if (stream->send_offset > 0)
+    {
+        if (pending)
+            memmove(stream->send_buffer.buffer,
+                stream->send_buffer.buffer + stream->send_offset, pending);
+        stream->send_offset = 0;
+        stream->send_length = pending;
+    }
+
+    /* Grows by doubling up to TGWS_MUX_STREAM_MAX_PENDING_SIZE */
+    if (pending + length > buffer_size)
+    {
+        if (0 == buffer_size)
+            buffer_size = TGWS_MUX_MAX_PAYLOAD_SIZE;
+        while (buffer_size < pending + length)
+            buffer_size *= 2;
+        if (buffer_size > TGWS_MUX_STREAM_MAX_PENDING_SIZE)
+            buffer_size = TGWS_MUX_STREAM_MAX_PENDING_SIZE;
+
+        buffer = (char_t*)ar_heap_malloc(buffer_size, &tgws_mux_heap_info);
+        if (NULL == buffer)
+            return AR_ENOMEMORY;
+        if (NULL != stream->send_buffer.buffer)
+        {
+            if (pending)
+                ar_mem_cpy(buffer, buffer_size, stream->send_buffer.buffer, pending);
+            ar_heap_free(stream->send_buffer.buffer, &tgws_mux_heap_info);
+        }
+        stream->send_buffer.buffer = buffer;
+        stream->send_buffer.buffer_size = buffer_size;
+    }
+
+    ar_mem_cpy(stream->send_buffer.buffer + stream->send_length,
+        stream->send_buffer.buffer_size - stream->send_length, (void*)data, length);
+    stream->send_length += length;
+
+    return flush_stream(stream);
+}
+
+int32_t TcpipGatewayMuxSession::flush_stream(tgws_mux_stream_t *stream)
+{
+    int32_t status = send_nonblocking(stream->socket, stream->send_buffer.buffer,
+        &stream->send_offset, stream->send_length);
+
+    if (stream->send_offset == stream->send_length)
+        stream->send_offset = stream->send_length = 0;
+    return status;
+}
+
+int32_t TcpipGatewayMuxSession::flush_client()
+{
+    int32_t status = send_nonblocking(client_socket, send_buffer.buffer,
+        &send_offset, send_length);
+
+    if (send_offset == send_length)
+        send_offset = send_length = 0;
+    return status;
+}
+
+uint32_t TcpipGatewayMuxSession::get_client_send_space()
+{
+    if (send_offset > 0)
+    {
+        if (send_length > send_offset)
+            memmove(send_buffer.buffer, send_buffer.buffer + send_offset,
+                send_length - send_offset);
+        send_length -= send_offset;
+        send_offset = 0;
+    }
+
+    return send_buffer.buffer_size - send_length;
+}
+
+int32_t TcpipGatewayMuxSession::open_stream(uint16_t stream_id,
+    char_t *payload, uint32_t payload_length)
+{
+    int32_t status = AR_EOK;
+    tgws_mux_open_req_t req = { 0 };
+    tgws_mux_stream_t *stream = NULL;
+    std::string backend_name = "";
+
+    if (TGWS_MUX_SESSION_STREAM_ID == stream_id ||
+        payload_length < sizeof(tgws_mux_open_req_t))
+    {
+        GATEWAY_ERR("Error[%d]: Invalid open request for stream %d", AR_EBADPARAM, stream_id);
+        return AR_EBADPARAM;
+    }
+
+    if (NULL != find_stream(stream_id))
+    {
+        GATEWAY_ERR("Error[%d]: Stream %d is already open", AR_EALREADY, stream_id);
+        return AR_EALREADY;
+    }
+
+    ar_mem_cpy(&req, sizeof(req), payload, sizeof(req));
+    if (TGWS_MUX_STREAM_CMD != req.stream_type && TGWS_MUX_STREAM_DLS != req.stream_type)
+    {
+        GATEWAY_ERR("Error[%d]: Unknown stream type %d", AR_EBADPARAM, req.stream_type);
+        return AR_EBADPARAM;
+    }
+
+    /* The ATS DLS server sends log packets to a single client */
+    for (uint32_t i = 0; i < TGWS_MUX_MAX_STREAMS; i++)
+    {
+        if (streams[i].is_open && TGWS_MUX_STREAM_DLS == req.stream_type &&
+            TGWS_MUX_STREAM_DLS == streams[i].stream_type)
+        {
+            GATEWAY_ERR("Error[%d]: A dls stream is already open", AR_EALREADY);
+            return AR_EALREADY;
+        }
+        if (!streams[i].is_open && NULL == stream)
+            stream = &streams[i];
+    }
+
+    if (NULL == stream)
+    {
+        GATEWAY_ERR("Error[%d]: All %d streams are in use", AR_ENORESOURCE, TGWS_MUX_MAX_STREAMS);
+        return AR_ENORESOURCE;
+    }
+
+    if (payload_length > sizeof(req))
+    {
+        backend_name.assign(payload + sizeof(req),
+            strnlen(payload + sizeof(req), payload_length - sizeof(req)));
+    }
+
+    status = connect_backend(req.stream_type, req.port, backend_name, &stream->socket);
+    if (AR_FAILED(status))
+        return status;
+
+    status = tgws_mux_set_nonblocking(stream->socket);
+    if (AR_FAILED(status))
+    {
+        GATEWAY_ERR("Error[%d]: Failed to make the backend socket non-blocking", status);
+        ar_socket_close(stream->socket);
+        return status;
+    }
+
+    stream->stream_id = stream_id;
+    stream->stream_type = (uint16_t)req.stream_type;
+    stream->is_open = TRUE;
+    streams_changed = TRUE;
+
+    GATEWAY_INFO("Opened %s stream %d", TGWS_MUX_STREAM_CMD == req.stream_type ?
+        "command" : "dls", stream_id);
+    return AR_EOK;
+}
+
+void TcpipGatewayMuxSession::close_stream(tgws_mux_stream_t *stream,
+    int32_t status, bool_t notify_client)
+{
+    uint16_t stream_id = stream->stream_id;
+
+    ar_socket_close(stream->socket);
+    if (NULL != stream->send_buffer.buffer)
+        ar_heap_free(stream->send_buffer.buffer, &tgws_mux_heap_info);
+    ar_mem_set(stream, 0, sizeof(tgws_mux_stream_t));
+    streams_changed = TRUE;
+
+    GATEWAY_INFO("Closed stream %d", stream_id);
+    if (notify_client)
+        (void)send_status_frame(stream_id, TGWS_MUX_FRAME_CLOSE, status);
+}
+
+tgws_mux_stream_t *TcpipGatewayMuxSession::find_stream(uint16_t stream_id)
+{
+    for (uint32_t i = 0; i < TGWS_MUX_MAX_STREAMS; i++)
+    {
+        if (streams[i].is_open && stream_id == streams[i].stream_id)
+            return &streams[i];
+    }
+    return NULL;
+}
+
+int32_t TcpipGatewayMuxSession::connect_backend(uint32_t stream_type, uint32_t port,
+    std::string backend_name, ar_socket_t *backend_socket)
+{
+    int32_t status = AR_EOK;
+    uint32_t address_length = 0;
+    ar_socket_addr_storage_t backend_sockaddr = { 0 };
+    tgws_util_address_type_t address_type = tgws_get_address_type();
+    std::string default_name = TGWS_MUX_STREAM_CMD == stream_type ?
+        ATS_UNIX_SOCKET_ABSTRACT_DOMAIN_NAME_ATS_CMD :
+        ATS_UNIX_SOCKET_ABSTRACT_DOMAIN_NAME_ATS_DLS;
+
+    if (0 == port)
+        port = TGWS_MUX_STREAM_CMD == stream_type ?
+            TCPIP_ATS_CMD_SERVER_PORT : TCPIP_ATS_DLS_SERVER_PORT;
+
+    /* Only ATS servers may be reached through the gateway. Over TCP/IP the
+     * backend is always on this host and the client may only pick the port */
+    if (TGWS_ADDRESS_TCPIP == address_type)
+    {
+        backend_name = TGWS_MUX_LOCALHOST_ADDRESS;
+    }
+    else if (backend_name.empty())
+    {
+        backend_name = default_name;
+    }
+    else if (0 != backend_name.compare(0, default_name.length(), default_name) ||
+        backend_name.length() >= AR_UNIX_PATH_MAX)
+    {
+        GATEWAY_ERR("Error[%d]: Backend %s is not an ats server", AR_EBADPARAM,
+            backend_name.c_str());
+        return AR_EBADPARAM;
+    }
+
+    status = (int32_t)tgws_util_create_socket(backend_socket);
+    if (AR_FAILED(status))
+    {
+        GATEWAY_ERR("Error[%d]: Failed to create backend socket", status);
+        return status;
+    }
+
+    /* Unlike the single session servers the backend socket is not bound to a
+     * gateway name, so several streams can connect to the same server */
+    tgws_util_get_socket_address(address_type, backend_name, (uint16_t)port, &backend_sockaddr);
+    address_length = tgws_util_get_socket_address_length(address_type, backend_name);
+
+    status = ar_socket_connect(*backend_socket,
+        (ar_socket_addr_t*)&backend_sockaddr, address_length);
+    if (AR_FAILED(status))
+    {
+        GATEWAY_ERR("Error[%d]: Failed to connect to backend %s", status, backend_name.c_str());
+        ar_socket_close(*backend_socket);
+        return AR_ENOTEXIST;
+    }
+
+    return AR_EOK;
+}
+
+int32_t TcpipGatewayMuxSession::send_frame(uint16_t stream_id, uint8_t frame_type,
+    const char_t *payload, uint32_t payload_length)
+{
+    tgws_mux_frame_header_t header = { 0 };
+
+    if (payload_length > TGWS_MUX_MAX_PAYLOAD_SIZE)
+        return AR_EBADPARAM;
+
+    /* Callers check for space first, the client is not reading otherwise */
+    if (get_client_send_space() < TGWS_MUX_FRAME_HEADER_LENGTH + payload_length)
+    {
+        GATEWAY_ERR("Error[%d]: No space to queue a frame for stream %d",
+            AR_ENORESOURCE, stream_id);
+        return AR_ENORESOURCE;
+    }
+
+    header.stream_id = stream_id;
+    header.frame_type = frame_type;
+    header.payload_length = payload_length;
+    ar_mem_cpy(send_buffer.buffer + send_length, TGWS_MUX_FRAME_HEADER_LENGTH,
+        &header, TGWS_MUX_FRAME_HEADER_LENGTH);
+    if (payload_length)
+        ar_mem_cpy(send_buffer.buffer + send_length + TGWS_MUX_FRAME_HEADER_LENGTH,
+            payload_length, (void*)payload, payload_length);
+    send_length += TGWS_MUX_FRAME_HEADER_LENGTH + payload_length;
+
+    return AR_EOK;
+}
+
+int32_t TcpipGatewayMuxSession::send_status_frame(uint16_t stream_id,
+    uint8_t frame_type, int32_t status)
+{
+    return send_frame(stream_id, frame_type, (char_t*)&status, sizeof(status));
+}
+
+int32_t TcpipGatewayMuxSession::send_all(ar_socket_t socket,
+    const char_t *buf, uint32_t length)
+{
+    int32_t bytes_sent = 0;
+    uint32_t offset = 0;
+
+    while (offset < length)
+    {
+        if (AR_FAILED(ar_socket_send(socket, buf + offset, length - offset,
+            TGWS_MUX_SEND_FLAGS, &bytes_sent)))
+        {
+            if (AR_SOCKET_LAST_ERROR == EINTR)
+                continue;
+            return AR_EFAILED;
+        }
+        offset += (uint32_t)bytes_sent;
+    }
+
+    return AR_EOK;
+}
+
+int32_t TcpipGatewayMuxSession::recv_all(ar_socket_t socket,
+    char_t *buf, uint32_t length)
+{
+    int32_t bytes_read = 0;
+    uint32_t offset = 0;
+
+    while (offset < length)
+    {
+        if (AR_FAILED(ar_socket_recv(socket, buf + offset, length - offset,
+            0, &bytes_read)))
+        {
+            if (AR_SOCKET_LAST_ERROR == EINTR)
+                continue;
+            return AR_EFAILED;
+        }
+        if (0 == bytes_read)
+            return AR_ENOTEXIST;
+        offset += (uint32_t)bytes_read;
+    }
+
+    return AR_EOK;
+}
+
+int32_t TcpipGatewayMuxSession::send_nonblocking(ar_socket_t socket,
+    const char_t *buf, uint32_t *offset, uint32_t length)
+{
+    int32_t bytes_sent = 0;
+
+    /* Calls send() directly, the socket wrapper logs every would block */
+    while (*offset < length)
+    {
+        bytes_sent = send(socket, buf + *offset, length - *offset, TGWS_MUX_SEND_FLAGS);
+        if (0 <= bytes_sent)
+        {
+            *offset += (uint32_t)bytes_sent;
+            continue;
+        }
+        if (AR_SOCKET_LAST_ERROR == EINTR)
+            continue;
+        if (TGWS_MUX_WOULD_BLOCK(AR_SOCKET_LAST_ERROR))
+            break;
+        return AR_EFAILED;
+    }
+
+    return AR_EOK;
+}
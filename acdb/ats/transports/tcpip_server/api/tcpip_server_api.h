@@ -25,6 +25,7 @@
 #include "ar_osal_thread.h"
 #include "ats_common.h"
 #include "acdb_utility.h"
+#include "ats_transport_api.h"
 
 #ifdef __cplusplus
 extern "C"{
@@ -45,8 +46,8 @@ extern "C"{
 *		designated port.
 *		ats communicates with the Gateway Server for any connection to external clients
 *
-*		Note: Only one client can be connected to this target at a time. The use of a mutex
-*		ensures this.
+*		Note: Up to TCPIP_CMD_SERVER_MAX_CLIENTS clients can be connected at a time.
+*		Commands from all clients are executed one at a time on the server thread.
 *
 *	\param [in] ats_cb: A callback to ats_exectue_command
 *
@@ -55,6 +56,41 @@ extern "C"{
 */
 int32_t tcpip_cmd_server_init(void(*ats_cb)(uint8_t *buf, uint32_t buf_len, uint8_t **resp, uint32_t *resp_len));
 
+/**
+*	\brief
+*		Sets the callback used to stream responses to clients
+*
+*	\detdesc
+*		Each request is offered to ats_stream_cb first. Commands that stream
+*		are sent in chunks as ATS produces them, so a large response such as
+*		an ACDB file is never held in memory in full. Other commands fall back
+*		to the callback given to tcpip_cmd_server_init.
+*		Must be called before tcpip_cmd_server_init.
+*
+*	\param [in] ats_stream_cb: A callback to ats_execute_command_stream
+*
+*	\return
+*		0 on success, non-zero on failure
+*/
+int32_t tcpip_cmd_server_set_stream_callback(ats_cmd_rsp_stream_callback_t ats_stream_cb);
+
+/**
+*	\brief
+*		Sets the callback that clients of the command server are reported to
+*
+*	\detdesc
+*		The callback is called with ATS_CLIENT_EVENT_REQUEST before each
+*		request of a client is executed and with ATS_CLIENT_EVENT_DISCONNECT
+*		when the client is closed. Every connection gets a new client id.
+*		Must be called before tcpip_cmd_server_init.
+*
+*	\param [in] ats_client_cb: The callback to report clients to
+*
+*	\return
+*		0 on success, non-zero on failure
+*/
+int32_t tcpip_cmd_server_set_client_callback(ats_client_callback_t ats_client_cb);
+
 /**
 *   \brief
 *		De-initializes the ATS TCP/IP server
@@ -62,9 +98,6 @@ int32_t tcpip_cmd_server_init(void(*ats_cb)(uint8_t *buf, uint32_t buf_len, uint
 *	\detdesc
 *       Releases threading and memory resources aquired during tcpip_cmd_server_init
 *
-*		Note: Only one client can be connected to this target at a time. The use of a mutex
-*		ensures this.
-*
 *	\return
 *		0 on success, non-zero on failure
 */
@@ -88,10 +121,11 @@ int32_t tcpip_cmd_server_deinit(void);
 	\dependencies
 		DLS support must be enabled in the build to successfully forward log data to clients
 
-	\param [in] buffer: logging buffer populated by ats dls service layer
-	\param [in] buffer_size: size of the log data buffer in bytes
+	\param [in] buffers: log data populated by ats dls service layer, sent
+	                     back to back with a single gathered write
+	\param [in] buffer_count: number of buffers
 */
-int32_t tcpip_cmd_server_send_dls_log_data(const uint8_t* buffer, uint32_t buffer_size);
+int32_t tcpip_cmd_server_send_dls_log_data(const ats_transport_buffer_t* buffers, uint32_t buffer_count);
 
 
 #endif /*ATS_TRANSPORT_TCPIP*/
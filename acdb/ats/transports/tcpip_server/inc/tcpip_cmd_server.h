@@ -9,9 +9,12 @@
 *
 *    This file contains the TCP/IP server implementation to host connections
 *    to QACT.
-*    This file first sets up a listening socket on port 5558. Upon accepting
-*    new connections, the server creates new receiving threads that handles
-*    all ATS upcalls.
+*    This file first sets up a listening socket on port 5558. A single
+*    server thread waits on the listening socket and every connected client
+*    with epoll, so several clients can be connected at once. Each client may
+*    send requests back to back without waiting for responses; its requests
+*    are executed in the order received and ATS upcalls from all clients are
+*    serialized on the server thread.
 *
 *  \copyright
 *      Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
@@ -29,6 +32,7 @@
 #include "ar_osal_error.h"
 
 #include "ats_i.h"
+#include "ats_transport_api.h"
 #include "tcpip_dls_server.h"
 
 //#if defined(__linux__)
@@ -47,16 +51,63 @@
 #define TCPIP_CMD_SERVER_MAX_MSG_BUFFER_SIZE      0x200000ul //2MB max size
 #define TCPIP_CMD_SERVER_ADDRESS "127.0.0.1" //local host
 #define TCPIP_CMD_SERVER_PORT 5559
+/**< The maximum number of clients that can be connected at the same time */
+#define TCPIP_CMD_SERVER_MAX_CLIENTS              8
+/**< Once this many response bytes are waiting to be sent to a client, the
+ * server stops executing that client's requests until the client reads */
+#define TCPIP_CMD_SERVER_MAX_PENDING_SEND_SIZE    (ATS_1_KB * 64UL)
+/**< Most response bytes a streamed command may queue for a client, further
+ * chunks wait for the client to read until the queue is below this size */
+#define TCPIP_CMD_SERVER_MAX_SEND_QUEUE_SIZE      (ATS_1_KB * 256UL)
+/**< A streamed command fails once its client has read nothing for this long */
+#define TCPIP_CMD_SERVER_SEND_STALL_TIMEOUT_MS    5000
 
 typedef void(*ATS_EXECUTE_CALLBACK) (
     uint8_t* req, uint32_t req_len,
     uint8_t** resp, uint32_t* resp_len);
 
+typedef ats_cmd_rsp_stream_callback_t ATS_EXECUTE_STREAM_CALLBACK;
+
 struct buffer_t {
     uint32_t buffer_size;
     char_t* buffer;
 };
 
+/**< Per client state kept between epoll events */
+struct tcpip_cmd_client_t {
+    ar_socket_t socket;
+    /**< Reported to ATS with the client's requests, see ats_client_callback_t */
+    uint32_t id;
+    /**< Received bytes not yet executed, may hold several requests */
+    buffer_t recv_buffer;
+    uint32_t recv_length;
+    /**< Bytes left to skip of a request that was too large to store */
+    uint32_t discard_length;
+    /**< Response bytes the socket has not accepted yet */
+    buffer_t send_buffer;
+    uint32_t send_offset;
+    uint32_t send_length;
+    /**< File data sent with sendfile once the first file_anchor bytes of
+     * send_buffer are out, file_fd is -1 if no file is queued */
+    int32_t file_fd;
+    uint32_t file_offset;
+    uint32_t file_length;
+    uint32_t file_anchor;
+    /**< Largest request accepted, see ATS_CMD_ONC_SET_MAX_BUFFER_LENGTH */
+    uint32_t max_message_size;
+    /**< Events the client is registered for with epoll */
+    uint32_t events;
+    bool_t should_close;
+};
+
+class TcpipCmdServer;
+
+/**< Passed to ATS with streamed commands to find the client to write to */
+struct tcpip_cmd_stream_ctx_t {
+    TcpipCmdServer *server;
+    tcpip_cmd_client_t *client;
+};
+
 class TcpipServer;
 
 class TcpipCmdServer
@@ -68,16 +119,20 @@ public:
     uint16_t port;
     std::string address;
     ar_socket_t listen_socket;
-    ar_socket_t accept_socket;
     ATS_EXECUTE_CALLBACK execute_command;
+    ATS_EXECUTE_STREAM_CALLBACK execute_stream;
+    ats_client_callback_t client_event;
 
 private:
-    uint8_t is_connected;
     bool_t is_aborted;
-    bool_t should_close_server;
-    ar_osal_mutex_t connection_lock;
-    buffer_t message_buffer;
-    buffer_t recieve_buffer;
+    volatile bool_t should_close_server;
+    int32_t epoll_fd;
+    /**< eventfd used by stop() to wake the server thread */
+    int32_t wake_fd;
+    uint32_t num_clients;
+    /**< The id of the last client accepted */
+    uint32_t last_client_id;
+    tcpip_cmd_client_t* clients[TCPIP_CMD_SERVER_MAX_CLIENTS];
 
     /*------------------------- Server Commands -------------------------*/
 
@@ -92,7 +147,7 @@ private:
 
 public:
 
-    int32_t send_dls_log_buffers(const char_t* buffer, uint32_t buffer_size);
+    int32_t send_dls_log_buffers(const ats_transport_buffer_t* buffers, uint32_t buffer_count);
 
 public:
 
@@ -100,7 +155,7 @@ public:
 
     /**
     * \brief
-    *       Starts the server by initializing locks and launches the connection routine thread
+    *       Starts the server by launching the connection routine thread
     *
     * \param [in] args: Optional arguments. Unused for now.
     *
@@ -118,12 +173,14 @@ public:
 
     /**
     * \brief
-    *	  Listens for incoming clients and starts the data transmission thread after a client connects
+    *	  Serves all clients of the command server from a single thread
     *
     * \detdesc
-    *     Creates the listening socket on 5559 and accepts incoming connections.
-    *	  Upon accepting a new connection, a thread called recv_thread_proc is
-    *	  created to handle transmitting(send/recieve) data to client.
+    *     Creates the listening socket on 5559 and waits on it, and on every
+    *	  accepted client, with epoll. Complete requests found in a client's
+    *	  receive buffer are executed in order and their responses queued to
+    *	  that client; partial requests and unsent responses are kept until
+    *	  the socket is readable or writable again.
     *
     * \dependencies
     *	  None
@@ -132,38 +189,43 @@ public:
     */
     void *connect_routine(void *args);
 
-    /**
-    * \brief
-    *    Routine for transmitting data between ATS and its client(s)
-    *
-    * \detdesc
-    *    Thread process that is created to handle 2 way message sending between server and client
-    *
-    * \param [in] args: This is unused
-    */
-    void *transmit_routine(void *args);
-
 private:
 
-    int32_t set_connected_lock(uint8_t is_conn);
-
     static void connect(void* arg);
 
-    static void transmit(void* arg);
+    int32_t accept_client();
+
+    void close_client(tcpip_cmd_client_t *client);
+
+    int32_t update_client_events(tcpip_cmd_client_t *client);
+
+    void trim_client_buffers(tcpip_cmd_client_t *client);
+
+    void read_client(tcpip_cmd_client_t *client);
 
-    int32_t recv_message_header(char_t *msgBuf, uint32_t msgbuflen,
-        char_t *recvbuf, uint32_t recvbuflen, uint32_t &msg_len);
+    void process_requests(tcpip_cmd_client_t *client);
 
-    int32_t recv_message(char_t *msgBuf, uint32_t msgbuflen,
-        char_t *recvbuf, uint32_t recvbuflen, uint32_t msg_len);
+    void process_message(tcpip_cmd_client_t *client,
+        char_t *msg_buf, uint32_t msg_len);
 
-    int32_t process_message(
-        char_t *msgBuf, uint32_t msgbuflen, uint32_t msg_len,
-        char_t **out_buf, uint32_t out_buf_len, uint32_t &resp_len);
+    void queue_response(tcpip_cmd_client_t *client,
+        const char_t *buf, uint32_t buf_len);
 
-    int32_t send_message(char_t *buf, uint32_t buf_len, uint32_t msg_len);
+    int32_t flush_client(tcpip_cmd_client_t *client);
 
-    int32_t execute_server_command(uint32_t service_cmd_id, uint32_t message_length);
+    static int32_t stream_write(void *ctx, const uint8_t *buf, uint32_t buf_len);
+
+    static int32_t stream_send_file(void *ctx, int32_t fd,
+        uint32_t file_offset, uint32_t length);
+
+    int32_t stream_response(tcpip_cmd_client_t *client,
+        const char_t *buf, uint32_t buf_len);
+
+    int32_t send_file_response(tcpip_cmd_client_t *client,
+        int32_t fd, uint32_t file_offset, uint32_t length);
+
+    int32_t execute_server_command(tcpip_cmd_client_t *client,
+        uint32_t service_cmd_id, char_t *msg_buf, uint32_t message_length);
 
     void start_dls_server();
 
@@ -188,9 +250,13 @@ public:
 
     int32_t start(ATS_EXECUTE_CALLBACK cb);
 
+    void set_stream_callback(ATS_EXECUTE_STREAM_CALLBACK cb);
+
+    void set_client_callback(ats_client_callback_t cb);
+
     int32_t stop();
 
-    int32_t send_dls_log_buffers(const uint8_t* buffer, uint32_t buffer_size);
+    int32_t send_dls_log_buffers(const ats_transport_buffer_t* buffers, uint32_t buffer_count);
 };
 
 #endif /*ATS_TRANSPORT_TCPIP*/
@@ -31,12 +31,18 @@
 #include "ar_osal_log.h"
 #include "ar_sockets_api.h"
 #include "tcpip_socket_util.h"
+#include "ats_transport_api.h"
 
 #define TCPIP_THREAD_PRIORITY_HIGH 0
 #define TCPIP_THREAD_PRIORITY_LOW 1
 #define TCPIP_THD_STACK_SIZE 0xF4240 //1mb stack size
 
 #define TCPIP_DLS_SERVER_PORT 5561
+/**< Most buffers send_dls_log_buffers accepts in one call */
+#define TCPIP_DLS_MAX_SEND_BUFFERS 64
+/**< Longest a send to the client may block, bounds how long stopping the
+ * DLS sender waits on a client that stopped reading */
+#define TCPIP_DLS_SEND_TIMEOUT_MS 2000
 
 class TcpipDlsServer
 {
@@ -58,15 +64,27 @@ public:
 	void* connect_routine(void* args);
 
 	/* \brief
-	*	Sends DLS log buffers to the client
-	*	param[in] buffer: a data buffer containing the DLS packet data
-	*	param[in] buffer: The size of the buffer containing the DLS packet data
+	*	Sends DLS log buffers to the client with one gathered write. Blocks
+	*	until all of the data is sent, the connection fails or the client
+	*	does not read for TCPIP_DLS_SEND_TIMEOUT_MS. A failure that leaves
+	*	part of the message on the wire closes the connection, since later
+	*	messages could not be framed anymore
+	*	param[in] buffers: the buffers containing the DLS packet data
+	*	param[in] buffer_count: the number of buffers, at most
+	*	                        TCPIP_DLS_MAX_SEND_BUFFERS
 	*/
-	int32_t send_dls_log_buffers(const char_t* buffer, uint32_t buffer_size);
+	int32_t send_dls_log_buffers(const ats_transport_buffer_t* buffers, uint32_t buffer_count);
 
 private:
 	int32_t set_connected_lock(uint8_t is_conn);
 
+	/* \brief
+	*	Closes the client connection. The client connects again at a message
+	*	boundary once the DLS server is restarted with the next command
+	*	server connection
+	*/
+	void close_connection();
+
 	static void connect(void* arg);
 };
 
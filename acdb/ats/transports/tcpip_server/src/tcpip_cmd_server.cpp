@@ -7,9 +7,11 @@
 *
 *    This file contains the TCP/IP server implementation to host connections
 *    to QACT.
-*    This file first sets up a listening socket on port 5558. Upon accepting
-*    new connections, the server creates new receiving threads that handles
-*    all ATS upcalls.
+*    This file first sets up a listening socket on port 5558. A single
+*    server thread runs an epoll event loop over the listening socket and
+*    every connected client. It accepts new connections, reads and executes
+*    each client's requests in the order received, and sends the responses;
+*    no per-client threads are created.
 *
 *  \copyright
 *      Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
@@ -17,8 +19,11 @@
 *=============================================================================
 */
 #ifdef ATS_TRANSPORT_TCPIP
-#include <thread>
-#include <chrono>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
 #include "tcpip_socket_util.h"
 #include "tcpip_dls_server.h"
 #include "tcpip_server_api.h"
@@ -35,12 +40,10 @@
 #define TCPIP_CMD_SVR_DBG(...) AR_LOG_DEBUG(TCPIP_CMD_SRV_LOG_TAG, __VA_ARGS__)
 #define TCPIP_CMD_SVR_INFO(...) AR_LOG_INFO(TCPIP_CMD_SRV_LOG_TAG, __VA_ARGS__)
 
-/**< The maximum number of clients that can connect to the command server*/
-#define MAX_TCPIP_CLIENTS_ALLOWED 1
+/**< The maximum number of events handled per epoll_wait call */
+#define TCPIP_CMD_SERVER_MAX_EVENTS (TCPIP_CMD_SERVER_MAX_CLIENTS + 2)
 /**< The name of the listening thread */
 #define TCPIP_THREAD_LISTENER "ATS_THD_LISTENER"
-/**< The name of the data transmission thread */
-#define TCPIP_THREAD_TRANSMIT "ATS_THD_TRANSMIT"
 /**< The size of the stack used by the threads created by the server */
 #define TCPIP_THD_STACK_SIZE 0xF4240 //1mb stack size
 /**< Indicates a high thread priority when creating a thread */
@@ -50,7 +53,6 @@
 
 typedef void *(TcpipCmdServer::*cmd_server_thread_callback)(void* args);
 static cmd_server_thread_callback thd_cb_connect_routine = &TcpipCmdServer::connect_routine;
-static cmd_server_thread_callback thd_cb_transmit_routine = &TcpipCmdServer::transmit_routine;
 
 /**< Instantiate a global static instance of the server for the duration of the appliation */
 static TcpipServer server;
@@ -124,6 +126,18 @@ static void tcpip_cmd_server_create_error_resp(
     char_t* message_buffer, uint32_t message_buffer_size,
     uint32_t& message_length);
 
+/**
+* \brief
+*   Returns the number of response bytes queued for a client, including
+*   file data that is waiting to be sent with sendfile
+*
+* \param [in] client: The client
+*
+* \return The number of bytes the client has not been sent yet
+*/
+static uint32_t tcpip_cmd_server_get_pending_send_size(
+    const tcpip_cmd_client_t *client);
+
 /*
 ============================================================================
                             Public APIs
@@ -143,6 +157,18 @@ int32_t tcpip_cmd_server_init(void(*ats_exec_callback)(uint8_t* req, uint32_t re
     return status;
 }
 
+int32_t tcpip_cmd_server_set_stream_callback(ats_cmd_rsp_stream_callback_t ats_stream_cb)
+{
+    server.set_stream_callback(ats_stream_cb);
+    return AR_EOK;
+}
+
+int32_t tcpip_cmd_server_set_client_callback(ats_client_callback_t ats_client_cb)
+{
+    server.set_client_callback(ats_client_cb);
+    return AR_EOK;
+}
+
 int32_t tcpip_cmd_server_deinit()
 {
     int32_t status = AR_EOK;
@@ -155,9 +181,9 @@ int32_t tcpip_cmd_server_deinit()
     return status;
 }
 
-int32_t tcpip_cmd_server_send_dls_log_data(const uint8_t * sendbuf, uint32_t payload_size)
+int32_t tcpip_cmd_server_send_dls_log_data(const ats_transport_buffer_t* buffers, uint32_t buffer_count)
 {
-    return server.send_dls_log_buffers(sendbuf, payload_size);
+    return server.send_dls_log_buffers(buffers, buffer_count);
 }
 /*
 ============================================================================
@@ -187,6 +213,16 @@ int32_t TcpipServer::start(ATS_EXECUTE_CALLBACK cb)
     return status;
 }
 
+void TcpipServer::set_stream_callback(ATS_EXECUTE_STREAM_CALLBACK cb)
+{
+    cmd_server.execute_stream = cb;
+}
+
+void TcpipServer::set_client_callback(ats_client_callback_t cb)
+{
+    cmd_server.client_event = cb;
+}
+
 int32_t TcpipServer::stop()
 {
     int32_t status = AR_EOK;
@@ -197,9 +233,9 @@ int32_t TcpipServer::stop()
     return status;
 }
 
-int32_t TcpipServer::send_dls_log_buffers(const uint8_t* buffer, uint32_t buffer_size)
+int32_t TcpipServer::send_dls_log_buffers(const ats_transport_buffer_t* buffers, uint32_t buffer_count)
 {
-    return cmd_server.send_dls_log_buffers((const char_t*)buffer, buffer_size);
+    return cmd_server.send_dls_log_buffers(buffers, buffer_count);
 }
 
 /*
@@ -208,8 +244,18 @@ int32_t TcpipServer::send_dls_log_buffers(const uint8_t* buffer, uint32_t buffer
 ============================================================================
 */
 TcpipCmdServer::TcpipCmdServer(std::string thd_name)
-    : thd_name(thd_name)
+    : thd_name(thd_name),
+    execute_command(NULL),
+    execute_stream(NULL),
+    client_event(NULL),
+    is_aborted(FALSE),
+    should_close_server(FALSE),
+    epoll_fd(-1),
+    wake_fd(-1),
+    num_clients(0),
+    last_client_id(0)
 {
+    ar_mem_set(clients, 0, sizeof(clients));
 }
 
 int32_t TcpipCmdServer::start(void *args)
@@ -220,27 +266,33 @@ int32_t TcpipCmdServer::start(void *args)
     this->address = TCPIP_CMD_SERVER_ADDRESS;
     this->port = TCPIP_CMD_SERVER_PORT;
 
-    status = ar_osal_mutex_create(&connection_lock);
-    if (AR_FAILED(status))
+    /* stop() uses the eventfd to wake the server thread out of epoll_wait */
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd < 0)
     {
-        TCPIP_CMD_SVR_ERR("Error[%d]: Failed to create mutex for %s thread", status, thd_name.c_str());
-        return status;
+        TCPIP_CMD_SVR_ERR("Error[%d]: Failed to create wake event for %s thread. Socket error: %d",
+            AR_EFAILED, thd_name.c_str(), AR_SOCKET_LAST_ERROR);
+        return AR_EFAILED;
     }
 
-    ar_osal_thread_attr_t thd_attr =
+    ar_osal_thread_attr_ext_t thd_attr =
     {
-        (char_t*)thd_name.c_str(),
-        TCPIP_THD_STACK_SIZE,
-        TCPIP_THREAD_PRIORITY_HIGH,
+        sizeof(ar_osal_thread_attr_ext_t),
+        { (char_t*)thd_name.c_str(), TCPIP_THD_STACK_SIZE, TCPIP_THREAD_PRIORITY_HIGH },
+        AR_OSAL_THREAD_SCHED_OTHER,
+        0,
+        ATS_THREAD_CPU_MASK
     };
 
     ar_osal_thread_start_routine r = \
         (ar_osal_thread_start_routine)(connect);
 
-    status = ar_osal_thread_create(&thd_connection_routine, &thd_attr, r, this);
+    status = ar_osal_thread_create_ext(&thd_connection_routine, &thd_attr, r, this);
     if (AR_FAILED(status))
     {
         TCPIP_CMD_SVR_ERR("Error[%d]: Failed to create thread %s", status, thd_name.c_str());
+        close(wake_fd);
+        wake_fd = -1;
         return status;
     }
 
@@ -250,6 +302,7 @@ int32_t TcpipCmdServer::start(void *args)
 int32_t TcpipCmdServer::stop()
 {
     int32_t status = AR_EOK;
+    uint64_t wake = 1;
 
     TCPIP_CMD_SVR_INFO("Closing ATS CMD/RSP Server ...");
     is_aborted = true;
@@ -257,9 +310,11 @@ int32_t TcpipCmdServer::stop()
 
     stop_dls_server();
 
-    ar_socket_close(listen_socket);
-    ar_socket_close(accept_socket);
-    ar_osal_mutex_unlock(connection_lock);
+    if (wake_fd >= 0 && write(wake_fd, &wake, sizeof(wake)) < 0)
+    {
+        TCPIP_CMD_SVR_ERR("Error[%d]: Failed to wake the server thread. Socket error: %d",
+            AR_EFAILED, AR_SOCKET_LAST_ERROR);
+    }
 
     TCPIP_CMD_SVR_DBG("Destroying listening thread...");
     status = ar_osal_thread_join_destroy(thd_connection_routine);
@@ -268,8 +323,11 @@ int32_t TcpipCmdServer::stop()
         TCPIP_CMD_SVR_ERR("Error[%d]:An error occured when waiting to close the listener thread.", status);
     }
 
-    TCPIP_CMD_SVR_DBG("Destroying mutexes thread...");
-    ar_osal_mutex_destroy(connection_lock);
+    if (wake_fd >= 0)
+    {
+        close(wake_fd);
+        wake_fd = -1;
+    }
 
     is_aborted = false;
     should_close_server = false;
@@ -277,58 +335,36 @@ int32_t TcpipCmdServer::stop()
 }
 
 
-int32_t TcpipCmdServer::send_dls_log_buffers(const char_t* buffer, uint32_t buffer_size)
+int32_t TcpipCmdServer::send_dls_log_buffers(const ats_transport_buffer_t* buffers, uint32_t buffer_count)
 {
 #ifdef ATS_DATA_LOGGING
-    return _dls_server.send_dls_log_buffers(buffer, buffer_size);
+    return _dls_server.send_dls_log_buffers(buffers, buffer_count);
 #else
-    __UNREFERENCED_PARAM(buffer);
-    __UNREFERENCED_PARAM(buffer_size);
+    __UNREFERENCED_PARAM(buffers);
+    __UNREFERENCED_PARAM(buffer_count);
     return AR_EUNSUPPORTED;
 #endif
 }
 
-
-int32_t TcpipCmdServer::set_connected_lock(uint8_t value)
-{
-    int32_t status = AR_EOK;
-
-    status = ar_osal_mutex_lock(connection_lock);
-    if (AR_FAILED(status))
-    {
-        return status;
-    }
-
-    is_connected = value;
-
-    status = ar_osal_mutex_lock(connection_lock);
-    if (AR_FAILED(status))
-    {
-        return status;
-    }
-
-    return status;
-}
-
 void TcpipCmdServer::connect(void* arg)
 {
     TcpipCmdServer *thread = (TcpipCmdServer*)arg;
     (thread->*thd_cb_connect_routine)(NULL);
 }
 
-void TcpipCmdServer::transmit(void* arg)
-{
-    TcpipCmdServer * thread = (TcpipCmdServer*)arg;
-    (thread->*thd_cb_transmit_routine)(NULL);
-}
-
 void *TcpipCmdServer::connect_routine(void *args)
 {
     __UNREFERENCED_PARAM(args);
 
     TCPIP_CMD_SVR_INFO("Starting TCP/IP server thread.");
     int32_t status = AR_EOK;
-    ar_osal_thread_t thd_transmit = NULL;
+    int32_t num_events = 0;
+    struct epoll_event event = { 0 };
+    struct epoll_event events[TCPIP_CMD_SERVER_MAX_EVENTS];
+    tcpip_cmd_client_t *client = NULL;
+
+    num_clients = 0;
+    ar_mem_set(clients, 0, sizeof(clients));
 
     status = tcpip_socket_util_create_socket(TCPIP_SERVER_TYPE_CMD, AR_SOCKET_ADDRESS_FAMILY, address, port, &listen_socket);
     if (AR_FAILED(status))
@@ -341,79 +377,86 @@ void *TcpipCmdServer::connect_routine(void *args)
 
     /* Clients will recieve a 'connection refused' error if the the
      * listening queue is full. The size of the queue is
-     * MAX_TCPIP_CLIENTS_ALLOWED */
-    status = ar_socket_listen(listen_socket, MAX_TCPIP_CLIENTS_ALLOWED);
+     * TCPIP_CMD_SERVER_MAX_CLIENTS */
+    status = ar_socket_listen(listen_socket, TCPIP_CMD_SERVER_MAX_CLIENTS);
     if (AR_FAILED(status))
     {
-        TCPIP_CMD_SVR_INFO("Error[%d]: Listen failed. Closing server...");
+        TCPIP_CMD_SVR_INFO("Error[%d]: Listen failed. Closing server...", status);
         ar_socket_close(listen_socket);
         return NULL;
     }
 
-    TCPIP_CMD_SVR_INFO("Waiting to accept ATS TCP/IP Command-Response clients...");
-    while (true)
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0)
     {
-        if (should_close_server) break;
+        TCPIP_CMD_SVR_ERR("Error[%d]: Failed to create epoll instance. Socket error: %d",
+            AR_EFAILED, AR_SOCKET_LAST_ERROR);
+        ar_socket_close(listen_socket);
+        return NULL;
+    }
 
-        status = tcpip_socket_util_accept_connections(AR_SOCKET_ADDRESS_FAMILY, listen_socket, &accept_socket);
-        if (AR_FAILED(status))
-        {
-            ar_socket_close(accept_socket);
+    /* The listening socket and the wake event are told apart from clients by
+     * their NULL and non-NULL sentinels, clients carry their state pointer */
+    (void)fcntl(listen_socket, F_SETFL, fcntl(listen_socket, F_GETFL, 0) | O_NONBLOCK);
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_socket, &event) < 0)
+        goto end;
+    event.data.ptr = &wake_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) < 0)
+        goto end;
 
+    TCPIP_CMD_SVR_INFO("Waiting to accept ATS TCP/IP Command-Response clients...");
+    while (!should_close_server)
+    {
+        num_events = epoll_wait(epoll_fd, events, TCPIP_CMD_SERVER_MAX_EVENTS, -1);
+        if (num_events < 0)
+        {
             if (AR_SOCKET_LAST_ERROR == EINTR) continue;
 
-            continue;
+            TCPIP_CMD_SVR_ERR("Error[%d]: epoll_wait failed. Socket error: %d",
+                AR_EFAILED, AR_SOCKET_LAST_ERROR);
+            break;
         }
 
-        //Start dls Server only after connecting to command server
-        start_dls_server();
-
-        TCPIP_CMD_SVR_INFO("Client connected to ATS TCPIP Command-Response Server");
-        ar_osal_mutex_unlock(connection_lock);
-        is_connected = true;
-
-        //ar_osal_thread_t thd_transmit;
-        ar_osal_thread_start_routine r = \
-            (ar_osal_thread_start_routine)(transmit);
-
-        std::string thd_transmit_name = "";
-        ar_osal_thread_attr_t thd_attr = \
-        {
-            (char_t*)thd_transmit_name.c_str(),
-                TCPIP_THD_STACK_SIZE,
-                TCPIP_THREAD_PRIORITY_HIGH
-        };
-
-        status = ar_osal_thread_create(&thd_transmit, &thd_attr, r, this);
-        if (AR_FAILED(status))
+        for (int32_t i = 0; i < num_events && !should_close_server; i++)
         {
-            TCPIP_CMD_SVR_ERR("Error[%d]: Failed to create transmission thread", status);
-        }
+            if (NULL == events[i].data.ptr)
+            {
+                (void)accept_client();
+                continue;
+            }
+            if (&wake_fd == events[i].data.ptr)
+                continue;
 
+            client = (tcpip_cmd_client_t*)events[i].data.ptr;
 
-        /* Only one client is allowed to connect to the server for now.
-         * Block until client calls QUIT on transmission thread.
-         * Allow 200 msec sleep for thd_transmit to aquire connection_lock*/
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-        ar_osal_mutex_lock(connection_lock);
+            if (events[i].events & EPOLLOUT)
+            {
+                /* Requests held back while the client was not reading */
+                if (AR_SUCCEEDED(flush_client(client)))
+                    process_requests(client);
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                read_client(client);
 
-        status = ar_osal_thread_join_destroy(thd_transmit);
-        if (AR_FAILED(status))
-        {
-            TCPIP_CMD_SVR_ERR("Error[%d]: Failed to destroy connection thread", status);
+            if (client->should_close || AR_FAILED(update_client_events(client)))
+                close_client(client);
+            else
+                trim_client_buffers(client);
         }
     }
 
+end:
+    for (uint32_t i = 0; i < TCPIP_CMD_SERVER_MAX_CLIENTS; i++)
+    {
+        if (NULL != clients[i])
+            close_client(clients[i]);
+    }
+
+    close(epoll_fd);
+    epoll_fd = -1;
     ar_socket_close(listen_socket);
-    ar_socket_close(accept_socket);
-    //for (int j = 0; j < MAX_TCPIP_CLIENTS_ALLOWED; j++)
-    //{
-    //    status = ar_osal_thread_join_destroy(thd_transmit);
-    //    if (AR_FAILED(status))
-    //    {
-    //        TCPIP_CMD_SVR_ERR("Error[%d]: Failed to destroy connection thread", status);
-    //    }
-    //}
 
     return 0;
 }
@@ -442,14 +485,13 @@ void TcpipCmdServer::stop_dls_server()
 #endif
 }
 
-void *TcpipCmdServer::transmit_routine(void *args)
+int32_t TcpipCmdServer::accept_client()
 {
-    __UNREFERENCED_PARAM(args);
-
     int32_t status = AR_EOK;
-    const uint32_t maxsize = ATS_BUFFER_LENGTH;//TODO: We need to introduce a command to change this size. 2mb is too high
-    char_t* outbuf = NULL;
-
+    ar_socket_t accept_socket = INVALID_SOCKET;
+    tcpip_cmd_client_t *client = NULL;
+    uint32_t slot = 0;
+    struct epoll_event event = { 0 };
     struct ar_heap_info_t heap_inf =
     {
         AR_HEAP_ALIGN_DEFAULT,
@@ -458,399 +500,679 @@ void *TcpipCmdServer::transmit_routine(void *args)
         AR_HEAP_TAG_DEFAULT
     };
 
-    ar_osal_mutex_lock(connection_lock);
+    status = tcpip_socket_util_accept_connections(AR_SOCKET_ADDRESS_FAMILY, listen_socket, &accept_socket);
+    if (AR_FAILED(status))
+    {
+        return status;
+    }
 
-    message_buffer.buffer_size = ATS_BUFFER_LENGTH;
-    recieve_buffer.buffer_size = TCPIP_CMD_SERVER_RECV_BUFFER_SIZE;
-    //Stores one message
-    message_buffer.buffer = (char_t*)ar_heap_malloc(message_buffer.buffer_size, &heap_inf);
-    if (NULL == message_buffer.buffer)
-        return 0;
+    if (num_clients >= TCPIP_CMD_SERVER_MAX_CLIENTS)
+    {
+        TCPIP_CMD_SVR_ERR("Error[%d]: Refusing client, %d clients are already connected",
+            AR_ENORESOURCE, num_clients);
+        ar_socket_close(accept_socket);
+        return AR_ENORESOURCE;
+    }
 
-    recieve_buffer.buffer = (char_t*)ar_heap_malloc(recieve_buffer.buffer_size, &heap_inf);
-    if (NULL == recieve_buffer.buffer) {
-        ar_heap_free(message_buffer.buffer, &heap_inf);
-        return 0;
+    while (NULL != clients[slot])
+        slot++;
+
+    client = (tcpip_cmd_client_t*)ar_heap_calloc(sizeof(tcpip_cmd_client_t), &heap_inf);
+    if (NULL == client)
+    {
+        ar_socket_close(accept_socket);
+        return AR_ENOMEMORY;
     }
 
-    outbuf = (char_t*)ar_heap_malloc(maxsize, &heap_inf);
-    if (NULL == outbuf) {
-        ar_heap_free(message_buffer.buffer, &heap_inf);
-        ar_heap_free(recieve_buffer.buffer, &heap_inf);
-        return 0;
+    client->socket = accept_socket;
+    client->id = ++last_client_id;
+    if (0 == client->id)
+        client->id = ++last_client_id;
+    client->file_fd = -1;
+    client->max_message_size = ATS_BUFFER_LENGTH;
+    client->recv_buffer.buffer_size = TCPIP_CMD_SERVER_RECV_BUFFER_SIZE;
+    client->recv_buffer.buffer = (char_t*)ar_heap_malloc(client->recv_buffer.buffer_size, &heap_inf);
+    if (NULL == client->recv_buffer.buffer)
+    {
+        ar_socket_close(accept_socket);
+        ar_heap_free(client, &heap_inf);
+        return AR_ENOMEMORY;
     }
-    ar_mem_set(outbuf, 0, 1);
 
-    while (true)
+    (void)fcntl(accept_socket, F_SETFL, fcntl(accept_socket, F_GETFL, 0) | O_NONBLOCK);
+    client->events = EPOLLIN;
+    event.events = client->events;
+    event.data.ptr = client;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, accept_socket, &event) < 0)
     {
-        uint32_t request_message_length = 0;
-        uint32_t response_message_length = 0;
+        TCPIP_CMD_SVR_ERR("Error[%d]: Failed to watch client socket. Socket error: %d",
+            AR_EFAILED, AR_SOCKET_LAST_ERROR);
+        ar_socket_close(accept_socket);
+        ar_heap_free(client->recv_buffer.buffer, &heap_inf);
+        ar_heap_free(client, &heap_inf);
+        return AR_EFAILED;
+    }
 
-        /* This is for readability when analyzing the logs.We want to separate each command
-         * sent by the client with a new line to understand all the operations that occur
-         * during one command */
-        TCPIP_CMD_SVR_DBG("\n");
+    //Start dls Server only after the first client connects to the command server
+    if (0 == num_clients)
+        start_dls_server();
 
-        status = recv_message_header(
-            message_buffer.buffer, message_buffer.buffer_size,
-            recieve_buffer.buffer, recieve_buffer.buffer_size,
-            request_message_length);
-        if (AR_FAILED(status))
-        {
-            if (AR_ETERMINATED == status)
-            {
-                TCPIP_CMD_SVR_INFO("Ending data transmission...")
-            }
-            else
-            {
-                TCPIP_CMD_SVR_ERR("Error[%d]: Failed to read message header",
-                    status);
-            }
-            break;
-        }
+    clients[slot] = client;
+    num_clients++;
+    TCPIP_CMD_SVR_INFO("Client connected to ATS TCPIP Command-Response Server. %d client(s) connected",
+        num_clients);
 
-        status = recv_message(
-            message_buffer.buffer, message_buffer.buffer_size,
-            recieve_buffer.buffer, recieve_buffer.buffer_size,
-            request_message_length);
-        if (AR_FAILED(status) && status != AR_ENEEDMORE)
-        {
-            TCPIP_CMD_SVR_ERR("Error[%d]: Failed to read message data", status);
-            break;
-        }
+    return AR_EOK;
+}
 
-        status = process_message(
-            message_buffer.buffer, message_buffer.buffer_size, request_message_length,
-            (char_t**)&outbuf,
-            maxsize, response_message_length);
-        if (AR_FAILED(status))
-        {
-            TCPIP_CMD_SVR_ERR("Error[%d]: Failed to read message data", status);
-            break;
-        }
+void TcpipCmdServer::close_client(tcpip_cmd_client_t *client)
+{
+    struct ar_heap_info_t heap_inf =
+    {
+        AR_HEAP_ALIGN_DEFAULT,
+        AR_HEAP_POOL_DEFAULT,
+        AR_HEAP_ID_DEFAULT,
+        AR_HEAP_TAG_DEFAULT
+    };
 
-        status = send_message(outbuf, maxsize, response_message_length);
-        if (AR_FAILED(status))
+    /* Hand over whatever the socket still accepts, e.g. responses to
+     * requests pipelined before a QUIT */
+    if (tcpip_cmd_server_get_pending_send_size(client) > 0)
+        (void)flush_client(client);
+    if (client->file_fd >= 0)
+        close(client->file_fd);
+
+    (void)epoll_ctl(epoll_fd, EPOLL_CTL_DEL, client->socket, NULL);
+    ar_socket_close(client->socket);
+
+    if (NULL != client_event)
+        client_event(client->id, ATS_CLIENT_EVENT_DISCONNECT);
+
+    for (uint32_t i = 0; i < TCPIP_CMD_SERVER_MAX_CLIENTS; i++)
+    {
+        if (client == clients[i])
         {
-            TCPIP_CMD_SVR_ERR("Error[%d]: Failed to send message", status);
+            clients[i] = NULL;
+            num_clients--;
             break;
         }
     }
 
-    //Cleanup
-    TCPIP_CMD_SVR_DBG("%s: closing thread", thd_name.c_str());
+    if (client->recv_buffer.buffer)
+        ar_heap_free(client->recv_buffer.buffer, &heap_inf);
+    if (client->send_buffer.buffer)
+        ar_heap_free(client->send_buffer.buffer, &heap_inf);
+    ar_heap_free(client, &heap_inf);
 
-    ar_heap_free(message_buffer.buffer, &heap_inf);
-    ar_heap_free(recieve_buffer.buffer, &heap_inf);
-
-    is_connected = false;
-    ar_osal_mutex_unlock(connection_lock);
-    return 0;
+    TCPIP_CMD_SVR_INFO("Client disconnected. %d client(s) connected", num_clients);
 }
 
-int32_t TcpipCmdServer::recv_message_header(char_t *msgBuf, uint32_t msgbuflen,
-    char_t *recvbuf, uint32_t recvbuflen, uint32_t &msg_len)
+int32_t TcpipCmdServer::update_client_events(tcpip_cmd_client_t *client)
 {
-    int32_t status = AR_EOK;
-    int32_t bytes_recieved = 0;
-    int32_t headerBytesRead = 0;
-    char svc_id_str[ATS_SEVICE_ID_STR_LEN] = { 0 };
-    uint32_t svc_cmd_id = 0;
+    uint32_t events = 0;
+    uint32_t pending = tcpip_cmd_server_get_pending_send_size(client);
+    struct epoll_event event = { 0 };
+
+    /* Stop reading while the client is not taking its responses, so a client
+     * that only sends cannot grow the server's buffers without bound */
+    if (pending < TCPIP_CMD_SERVER_MAX_PENDING_SEND_SIZE && client->file_fd < 0)
+        events |= EPOLLIN;
+    if (pending > 0)
+        events |= EPOLLOUT;
+
+    if (events == client->events)
+        return AR_EOK;
+
+    event.events = events;
+    event.data.ptr = client;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, client->socket, &event) < 0)
+    {
+        TCPIP_CMD_SVR_ERR("Error[%d]: Failed to update client events. Socket error: %d",
+            AR_EFAILED, AR_SOCKET_LAST_ERROR);
+        return AR_EFAILED;
+    }
+    client->events = events;
 
-    while (true)
+    return AR_EOK;
+}
+
+void TcpipCmdServer::trim_client_buffers(tcpip_cmd_client_t *client)
+{
+    char_t *new_buffer = NULL;
+    struct ar_heap_info_t heap_inf =
     {
-        //receive full message header
-        TCPIP_CMD_SVR_DBG("Waiting to recieve message...");
+        AR_HEAP_ALIGN_DEFAULT,
+        AR_HEAP_POOL_DEFAULT,
+        AR_HEAP_ID_DEFAULT,
+        AR_HEAP_TAG_DEFAULT
+    };
 
-        if (ATS_HEADER_LENGTH - headerBytesRead > (int32_t)recvbuflen)
+    /* Buffers grown for one large request or response are given back once
+     * it is done, so idle clients only hold TCPIP_CMD_SERVER_RECV_BUFFER_SIZE */
+    if (client->recv_buffer.buffer_size > TCPIP_CMD_SERVER_RECV_BUFFER_SIZE &&
+        client->recv_length <= TCPIP_CMD_SERVER_RECV_BUFFER_SIZE)
+    {
+        new_buffer = (char_t*)ar_heap_malloc(TCPIP_CMD_SERVER_RECV_BUFFER_SIZE, &heap_inf);
+        if (NULL != new_buffer)
         {
-            return AR_EBADPARAM;
+            if (client->recv_length > 0)
+                ar_mem_cpy(new_buffer, TCPIP_CMD_SERVER_RECV_BUFFER_SIZE,
+                    client->recv_buffer.buffer, client->recv_length);
+            ar_heap_free(client->recv_buffer.buffer, &heap_inf);
+            client->recv_buffer.buffer = new_buffer;
+            client->recv_buffer.buffer_size = TCPIP_CMD_SERVER_RECV_BUFFER_SIZE;
         }
-        status = ar_socket_recv(accept_socket, recvbuf, ATS_HEADER_LENGTH - headerBytesRead, 0, &bytes_recieved);
+    }
+
+    if (client->send_buffer.buffer_size > TCPIP_CMD_SERVER_RECV_BUFFER_SIZE &&
+        client->send_length == client->send_offset)
+    {
+        ar_heap_free(client->send_buffer.buffer, &heap_inf);
+        client->send_buffer.buffer = NULL;
+        client->send_buffer.buffer_size = 0;
+    }
+}
+
+void TcpipCmdServer::read_client(tcpip_cmd_client_t *client)
+{
+    ssize_t bytes_recieved = 0;
+    uint32_t new_size = 0;
+    char_t *new_buffer = NULL;
+    struct ar_heap_info_t heap_inf =
+    {
+        AR_HEAP_ALIGN_DEFAULT,
+        AR_HEAP_POOL_DEFAULT,
+        AR_HEAP_ID_DEFAULT,
+        AR_HEAP_TAG_DEFAULT
+    };
 
-        if (bytes_recieved < 0)
+    while (!client->should_close && client->file_fd < 0 &&
+        tcpip_cmd_server_get_pending_send_size(client) < TCPIP_CMD_SERVER_MAX_PENDING_SEND_SIZE)
+    {
+        /* A full buffer holds the start of one request larger than the
+         * buffer, grow it up to the size of the largest accepted request */
+        if (client->recv_length == client->recv_buffer.buffer_size)
         {
-            if (AR_SOCKET_LAST_ERROR == EINTR) continue;
+            new_size = client->recv_buffer.buffer_size * 2;
+            if (new_size > client->max_message_size)
+                new_size = client->max_message_size;
+            if (new_size <= client->recv_buffer.buffer_size)
+            {
+                TCPIP_CMD_SVR_ERR("Error[%d]: Receive buffer of %d bytes is full",
+                    AR_ENEEDMORE, client->recv_buffer.buffer_size);
+                client->should_close = TRUE;
+                return;
+            }
 
-            TCPIP_CMD_SVR_ERR("Receive failed with error: %d\n", AR_SOCKET_LAST_ERROR);
-            ar_socket_close(accept_socket);
-            return AR_EFAILED;
+            new_buffer = (char_t*)ar_heap_malloc(new_size, &heap_inf);
+            if (NULL == new_buffer)
+            {
+                TCPIP_CMD_SVR_ERR("Error[%d]: Failed to grow receive buffer to %d bytes",
+                    AR_ENOMEMORY, new_size);
+                client->should_close = TRUE;
+                return;
+            }
+            ar_mem_cpy(new_buffer, new_size, client->recv_buffer.buffer, client->recv_length);
+            ar_heap_free(client->recv_buffer.buffer, &heap_inf);
+            client->recv_buffer.buffer = new_buffer;
+            client->recv_buffer.buffer_size = new_size;
         }
-        else if (bytes_recieved == 0)
+
+        bytes_recieved = recv(client->socket,
+            client->recv_buffer.buffer + client->recv_length,
+            client->recv_buffer.buffer_size - client->recv_length, 0);
+        if (bytes_recieved > 0)
+        {
+            TCPIP_CMD_SVR_DBG("Recieved %d bytes", (int32_t)bytes_recieved);
+            client->recv_length += (uint32_t)bytes_recieved;
+            process_requests(client);
+            continue;
+        }
+
+        if (bytes_recieved == 0)
         {
             TCPIP_CMD_SVR_INFO("Client shutdown socket. Closing connection...");
-            ar_socket_close(accept_socket);
-            return AR_ETERMINATED;
+            client->should_close = TRUE;
         }
+        else if (AR_SOCKET_LAST_ERROR == EINTR)
+        {
+            continue;
+        }
+        else if (AR_SOCKET_LAST_ERROR != EAGAIN && AR_SOCKET_LAST_ERROR != EWOULDBLOCK)
+        {
+            TCPIP_CMD_SVR_ERR("Receive failed with error: %d", AR_SOCKET_LAST_ERROR);
+            client->should_close = TRUE;
+        }
+        break;
+    }
+}
 
-        TCPIP_CMD_SVR_DBG("Recieved %d bytes", bytes_recieved);
+void TcpipCmdServer::process_requests(tcpip_cmd_client_t *client)
+{
+    uint32_t offset = 0;
+    uint32_t available = 0;
+    uint32_t skip = 0;
+    uint32_t data_length = 0;
+    uint32_t msg_len = 0;
+    uint32_t svc_cmd_id = 0;
+    uint32_t resp_len = 0;
+    char_t error_resp[ATS_ERROR_FRAME_LENGTH] = { 0 };
 
-        /* The client sends "QUIT" to signal end of connection. The server will close
-         * the socket and return */
-        if (ar_strcmp(recvbuf, ATS_SERVER_CMD_QUIT.c_str(), 4) == 0)
+    /* Only one file can be queued per client, so requests also wait for a
+     * queued file to be sent */
+    while (!client->should_close && client->file_fd < 0 &&
+        tcpip_cmd_server_get_pending_send_size(client) < TCPIP_CMD_SERVER_MAX_PENDING_SEND_SIZE)
+    {
+        available = client->recv_length - offset;
+
+        if (client->discard_length > 0)
         {
-            TCPIP_CMD_SVR_INFO("Quitting...");
-            ar_socket_close(accept_socket);
-            return AR_ETERMINATED;
+            skip = available < client->discard_length ? available : client->discard_length;
+            offset += skip;
+            client->discard_length -= skip;
+            if (client->discard_length > 0)
+                break;
+            continue;
         }
 
-        if (headerBytesRead > (int32_t)msgbuflen)
+        /* The client sends "QUIT" to signal end of connection. The server will close
+         * the socket once the responses to earlier requests are sent */
+        if (available >= ATS_SERVER_CMD_QUIT.length() &&
+            ar_strcmp(client->recv_buffer.buffer + offset, ATS_SERVER_CMD_QUIT.c_str(),
+                ATS_SERVER_CMD_QUIT.length()) == 0)
         {
-            return AR_EBADPARAM;
+            TCPIP_CMD_SVR_INFO("Quitting...");
+            client->should_close = TRUE;
+            break;
         }
-        ar_mem_cpy(msgBuf + headerBytesRead, bytes_recieved, recvbuf, bytes_recieved);
-        headerBytesRead += bytes_recieved;
 
-        //this determines how many bytes to expect (thus determining how many times to loop).
-        if (tcpip_cmd_server_get_ats_command_length(msgBuf, bytes_recieved, &msg_len))
+        if (available < ATS_HEADER_LENGTH)
+            break;
+
+        tcpip_cmd_server_get_ats_command_length(
+            client->recv_buffer.buffer + offset, available, &data_length);
+        msg_len = data_length + ATS_HEADER_LENGTH;
+
+        if (data_length > client->max_message_size - ATS_HEADER_LENGTH)
         {
-            svc_cmd_id = 0;
+            /* We reject messages that are larger that what we can store in our message buffer */
+            TCPIP_CMD_SVR_ERR("Error[%d]: Not enough memory to store incoming message of %u bytes. "
+                "Use resize buffer command to update the max buffer size", AR_ENEEDMORE, data_length);
+
             ar_mem_cpy(&svc_cmd_id, ATS_SERVICE_COMMAND_ID_LENGTH,
-                msgBuf + ATS_SERVICE_COMMAND_ID_POSITION, ATS_SERVICE_COMMAND_ID_LENGTH);
+                client->recv_buffer.buffer + offset + ATS_SERVICE_COMMAND_ID_POSITION,
+                ATS_SERVICE_COMMAND_ID_LENGTH);
+            tcpip_cmd_server_create_error_resp(svc_cmd_id, AR_ENEEDMORE,
+                error_resp, sizeof(error_resp), resp_len);
+            queue_response(client, error_resp, resp_len);
+
+            client->discard_length = data_length;
+            offset += ATS_HEADER_LENGTH;
+            continue;
+        }
 
-            ATS_SERVICE_ID_STR(svc_id_str, ATS_SEVICE_ID_STR_LEN, svc_cmd_id);
-            TCPIP_CMD_SVR_DBG("Recieved Command[%s-%d] with length %d bytes", svc_id_str, ATS_GET_COMMAND_ID(svc_cmd_id), msg_len);
+        if (available < msg_len)
             break;
-        }
-    }
 
-    msg_len += ATS_HEADER_LENGTH;
+        process_message(client, client->recv_buffer.buffer + offset, msg_len);
+        offset += msg_len;
+    }
 
-    return status;
+    if (offset > 0)
+    {
+        client->recv_length -= offset;
+        if (client->recv_length > 0)
+            ar_mem_move(client->recv_buffer.buffer, client->recv_buffer.buffer_size,
+                client->recv_buffer.buffer + offset, client->recv_length);
+    }
 }
 
-int32_t TcpipCmdServer::recv_message(char_t *msgBuf, uint32_t msgbuflen,
-    char_t *recvbuf, uint32_t recvbuflen, uint32_t msg_len)
+void TcpipCmdServer::process_message(tcpip_cmd_client_t *client,
+    char_t *msg_buf, uint32_t msg_len)
 {
-    __UNREFERENCED_PARAM(recvbuflen);
     int32_t status = AR_EOK;
-    int32_t bytes_recieved = 0;
-    uint32_t message_bytes_read = 0;
-    uint32_t remaining_message_length = 0;
-    uint32_t recv_len = 0;
-    uint32_t data_length = msg_len;
-    bool_t should_write_msg = TRUE;
+    uint32_t svc_cmd_id = 0;
+    uint32_t data_length = 0;
+    uint8_t *resp_buf = NULL;
+    uint32_t resp_len = 0;
+    char_t error_resp[ATS_ERROR_FRAME_LENGTH] = { 0 };
+    char svc_id_str[ATS_SEVICE_ID_STR_LEN] = { 0 };
 
-    if (msg_len > msgbuflen)
-    {
-        /* We reject messages that are larger that what we can store in our message buffer */
-        TCPIP_CMD_SVR_ERR("Error[%d]: Not enough memory to store incoming message of %d bytes. "
-            "Use resize buffer command to update the max buffer size", AR_ENEEDMORE, msg_len);
+    /* This is for readability when analyzing the logs.We want to separate each command
+     * sent by the client with a new line to understand all the operations that occur
+     * during one command */
+    TCPIP_CMD_SVR_DBG("\n");
+
+    ar_mem_cpy(&svc_cmd_id, ATS_SERVICE_COMMAND_ID_LENGTH,
+        msg_buf + ATS_SERVICE_COMMAND_ID_POSITION, ATS_SERVICE_COMMAND_ID_LENGTH);
 
-        should_write_msg = FALSE;
-        status =  AR_ENEEDMORE;
+    tcpip_cmd_server_get_ats_command_length(msg_buf, msg_len, &data_length);
+    ATS_SERVICE_ID_STR(svc_id_str, ATS_SEVICE_ID_STR_LEN, svc_cmd_id);
+    TCPIP_CMD_SVR_DBG("Command[%s-%d]: Request data length is %d bytes", svc_id_str, ATS_GET_COMMAND_ID(svc_cmd_id), data_length);
+
+    if (NULL != client_event)
+        client_event(client->id, ATS_CLIENT_EVENT_REQUEST);
+
+    //Handle server commands like RESIZE_BUFFER, etc..
+    if (ATS_ONLINE_SERVICE_ID == ATS_GET_SERVICE_ID(svc_cmd_id))
+    {
+        status = execute_server_command(client, svc_cmd_id, msg_buf, msg_len);
+        if (AR_FAILED(status))
+        {
+            tcpip_cmd_server_create_error_resp(svc_cmd_id, status,
+                error_resp, sizeof(error_resp), resp_len);
+            queue_response(client, error_resp, resp_len);
+            return;
+        }
     }
 
-    data_length -= ATS_HEADER_LENGTH;
-    while (data_length > 0)
+    /* Commands that stream are sent chunk by chunk as ATS produces them */
+    if (NULL != execute_stream)
     {
-        //receive rest of message
-        if (message_bytes_read > data_length)
+        tcpip_cmd_stream_ctx_t stream_ctx = { this, client };
+
+        status = execute_stream((uint8_t *)msg_buf, msg_len,
+            stream_write, stream_send_file, &stream_ctx);
+        if (AR_SUCCEEDED(status))
+            return;
+        if (AR_EUNSUPPORTED != status)
         {
-            TCPIP_CMD_SVR_ERR("Error[%d]: Read more than message length. Exiting..",
-                AR_ENEEDMORE);
-            ar_socket_close(accept_socket);
+            /* Part of the response may be out already, the client cannot
+             * resynchronize with the stream */
+            TCPIP_CMD_SVR_ERR("Error[%d]: Command[%s-%d] failed while streaming its response. Closing connection...",
+                status, svc_id_str, ATS_GET_COMMAND_ID(svc_cmd_id));
+            client->should_close = TRUE;
+            return;
+        }
+    }
 
-            return AR_ENEEDMORE;
+    //passing received data to the ats upcall, the response points into the ATS buffer
+    execute_command((uint8_t *)msg_buf, msg_len, &resp_buf, &resp_len);
+    if (NULL == resp_buf || 0 == resp_len)
+    {
+        TCPIP_CMD_SVR_ERR("Error[%d]: Command[%s-%d] produced no response",
+            AR_EFAILED, svc_id_str, ATS_GET_COMMAND_ID(svc_cmd_id));
+        tcpip_cmd_server_create_error_resp(svc_cmd_id, AR_EFAILED,
+            error_resp, sizeof(error_resp), resp_len);
+        resp_buf = (uint8_t*)error_resp;
+    }
+
+    TCPIP_CMD_SVR_DBG("Command[%s-%d]: Sending response of %d bytes", svc_id_str, ATS_GET_COMMAND_ID(svc_cmd_id), resp_len);
+
+    /* Must be sent or copied before the next command reuses the ATS buffer */
+    queue_response(client, (const char_t*)resp_buf, resp_len);
+}
+
+void TcpipCmdServer::queue_response(tcpip_cmd_client_t *client,
+    const char_t *buf, uint32_t buf_len)
+{
+    ssize_t bytes_sent = 0;
+    uint32_t pending = client->send_length - client->send_offset;
+    uint32_t new_size = 0;
+    char_t *new_buffer = NULL;
+    struct ar_heap_info_t heap_inf =
+    {
+        AR_HEAP_ALIGN_DEFAULT,
+        AR_HEAP_POOL_DEFAULT,
+        AR_HEAP_ID_DEFAULT,
+        AR_HEAP_TAG_DEFAULT
+    };
+
+    /* Nothing queued ahead of this response, try to send it without copying */
+    while (0 == pending && client->file_fd < 0 && buf_len > 0)
+    {
+        bytes_sent = send(client->socket, buf, buf_len, MSG_NOSIGNAL);
+        if (bytes_sent > 0)
+        {
+            buf += bytes_sent;
+            buf_len -= (uint32_t)bytes_sent;
+            continue;
         }
+        if (bytes_sent < 0 && AR_SOCKET_LAST_ERROR == EINTR)
+            continue;
+        if (bytes_sent < 0 && AR_SOCKET_LAST_ERROR != EAGAIN && AR_SOCKET_LAST_ERROR != EWOULDBLOCK)
+        {
+            TCPIP_CMD_SVR_ERR("Unable to send message. Socket error: %d", AR_SOCKET_LAST_ERROR);
+            client->should_close = TRUE;
+            return;
+        }
+        break;
+    }
 
-        remaining_message_length = data_length - message_bytes_read;
-        recv_len = remaining_message_length < TCPIP_CMD_SERVER_RECV_BUFFER_SIZE ?
-            remaining_message_length : TCPIP_CMD_SERVER_RECV_BUFFER_SIZE;
+    if (0 == buf_len)
+        return;
+
+    if (client->send_offset > 0)
+    {
+        if (pending > 0)
+            ar_mem_move(client->send_buffer.buffer, client->send_buffer.buffer_size,
+                client->send_buffer.buffer + client->send_offset, pending);
+        if (client->file_fd >= 0)
+            client->file_anchor -= client->send_offset;
+        client->send_offset = 0;
+        client->send_length = pending;
+    }
 
-        //will receive min(TCPIP_CMD_SERVER_RECV_BUFFER_SIZE, bytes left to receive to complete message)
-        bytes_recieved = recv(accept_socket, recvbuf, recv_len, 0);
+    if (pending + buf_len > client->send_buffer.buffer_size)
+    {
+        new_size = client->send_buffer.buffer_size ?
+            client->send_buffer.buffer_size : TCPIP_CMD_SERVER_RECV_BUFFER_SIZE;
+        while (new_size < pending + buf_len)
+            new_size *= 2;
 
-        if (bytes_recieved > 0)
+        new_buffer = (char_t*)ar_heap_malloc(new_size, &heap_inf);
+        if (NULL == new_buffer)
         {
-            TCPIP_CMD_SVR_DBG("Recieved %d bytes", bytes_recieved);
+            TCPIP_CMD_SVR_ERR("Error[%d]: Failed to queue response of %d bytes",
+                AR_ENOMEMORY, buf_len);
+            client->should_close = TRUE;
+            return;
+        }
+        if (pending > 0)
+            ar_mem_cpy(new_buffer, new_size, client->send_buffer.buffer, pending);
+        if (client->send_buffer.buffer)
+            ar_heap_free(client->send_buffer.buffer, &heap_inf);
+        client->send_buffer.buffer = new_buffer;
+        client->send_buffer.buffer_size = new_size;
+    }
 
-            if (should_write_msg)
-            {
-                if (ATS_HEADER_LENGTH + message_bytes_read > msgbuflen)
-                {
-                    TCPIP_CMD_SVR_ERR("Message bytes read + ATS Header %d bytes is greater "
-                        "than message buffer length %d bytes",
-                        ATS_HEADER_LENGTH + message_bytes_read, msgbuflen);
-                    return AR_ENEEDMORE;
-                }
+    ar_mem_cpy(client->send_buffer.buffer + pending,
+        client->send_buffer.buffer_size - pending, buf, buf_len);
+    client->send_length = pending + buf_len;
+}
 
-                ar_mem_cpy(msgBuf + ATS_HEADER_LENGTH + message_bytes_read, bytes_recieved,
-                    recvbuf, bytes_recieved);
-            }
+int32_t TcpipCmdServer::flush_client(tcpip_cmd_client_t *client)
+{
+    ssize_t bytes_sent = 0;
+    off_t offset = 0;
+    uint32_t end = 0;
 
-            message_bytes_read += bytes_recieved;
-            if (message_bytes_read == data_length)
+    for (;;)
+    {
+        /* Bytes queued ahead of a file go out before it */
+        end = client->file_fd >= 0 ? client->file_anchor : client->send_length;
+        if (client->send_offset < end)
+        {
+            bytes_sent = send(client->socket,
+                client->send_buffer.buffer + client->send_offset,
+                end - client->send_offset, MSG_NOSIGNAL);
+            if (bytes_sent > 0)
             {
-                break;
+                client->send_offset += (uint32_t)bytes_sent;
+                continue;
             }
         }
-        else if (bytes_recieved <= 0)
+        else if (client->file_fd >= 0)
         {
-            if (AR_SOCKET_LAST_ERROR == EINTR)
+            /* The kernel moves the data from the page cache to the socket */
+            offset = (off_t)client->file_offset;
+            bytes_sent = sendfile(client->socket, client->file_fd, &offset,
+                client->file_length);
+            if (bytes_sent > 0)
             {
-                //TCPIP_CMD_SVR_DBG("Signal interruption detected. Continuing..");
+                client->file_offset += (uint32_t)bytes_sent;
+                client->file_length -= (uint32_t)bytes_sent;
+                if (0 == client->file_length)
+                {
+                    close(client->file_fd);
+                    client->file_fd = -1;
+                }
                 continue;
             }
+            if (bytes_sent == 0)
+            {
+                TCPIP_CMD_SVR_ERR("Error[%d]: File ended %d bytes early",
+                    AR_EFAILED, client->file_length);
+                client->should_close = TRUE;
+                return AR_EFAILED;
+            }
+        }
+        else
+        {
+            break;
+        }
 
-            TCPIP_CMD_SVR_ERR("Receive failed with error: %d", AR_SOCKET_LAST_ERROR);
-            ar_socket_close(accept_socket);
+        if (AR_SOCKET_LAST_ERROR == EINTR)
+            continue;
+        if (AR_SOCKET_LAST_ERROR != EAGAIN && AR_SOCKET_LAST_ERROR != EWOULDBLOCK)
+        {
+            TCPIP_CMD_SVR_ERR("Unable to send message. Socket error: %d", AR_SOCKET_LAST_ERROR);
+            client->should_close = TRUE;
             return AR_EFAILED;
         }
+        break;
     }
 
-    return status;
-}
-
-int32_t TcpipCmdServer::process_message(
-    char_t* msg_buffer, uint32_t msg_buffer_size, uint32_t msg_length,
-    char_t** out_buf, uint32_t out_buf_len, uint32_t& resp_len)
-{
-    __UNREFERENCED_PARAM(out_buf_len);
-    int32_t status = AR_EOK;
-    //uint32_t recvlen_ptr = 0;
-    uint32_t svc_cmd_id = 0;
-    uint32_t data_length = 11;//TODO: Why is this hardcoded to 11?
-    char svc_id_str[ATS_SEVICE_ID_STR_LEN] = { 0 };
-    if (msg_length > msg_buffer_size)
+    if (client->send_offset == client->send_length)
     {
-        /* We reject messages that are larger that what we can store in our message buffer */
-        tcpip_cmd_server_create_error_resp(svc_cmd_id, AR_ENEEDMORE,
-            *out_buf, out_buf_len, resp_len);
-        goto process_message_end;
+        client->send_offset = 0;
+        client->send_length = 0;
+        client->file_anchor = 0;
     }
 
-    svc_cmd_id = 0;
-    ar_mem_cpy(&svc_cmd_id, ATS_SERVICE_COMMAND_ID_LENGTH,
-        msg_buffer + ATS_SERVICE_COMMAND_ID_POSITION, ATS_SERVICE_COMMAND_ID_LENGTH);
+    return AR_EOK;
+}
 
-    tcpip_cmd_server_get_ats_command_length(msg_buffer, msg_length, &data_length);
-    ATS_SERVICE_ID_STR(svc_id_str, ATS_SEVICE_ID_STR_LEN, svc_cmd_id);
-    TCPIP_CMD_SVR_DBG("Command[%s-%d]: Request data length is %d bytes", svc_id_str, ATS_GET_COMMAND_ID(svc_cmd_id), data_length);
+int32_t TcpipCmdServer::stream_write(void *ctx, const uint8_t *buf, uint32_t buf_len)
+{
+    tcpip_cmd_stream_ctx_t *stream_ctx = (tcpip_cmd_stream_ctx_t*)ctx;
 
-    //Handle server commands like RESIZE_BUFFER, etc..
-    if (ATS_ONLINE_SERVICE_ID == ATS_GET_SERVICE_ID(svc_cmd_id))
+    return stream_ctx->server->stream_response(
+        stream_ctx->client, (const char_t*)buf, buf_len);
+}
+
+int32_t TcpipCmdServer::stream_response(tcpip_cmd_client_t *client,
+    const char_t *buf, uint32_t buf_len)
+{
+    struct pollfd pfd;
+    int32_t rc = 0;
+
+    if (client->should_close)
+        return AR_EFAILED;
+
+    /* Chunks are queued and sent from the event loop as the client reads
+     * them. Once the queue would grow past TCPIP_CMD_SERVER_MAX_SEND_QUEUE_SIZE
+     * the stream waits here for the client to drain it, so a command producing
+     * more data than the client reads does not buffer all of it */
+    while (client->send_length - client->send_offset > 0 &&
+        client->send_length - client->send_offset + buf_len > TCPIP_CMD_SERVER_MAX_SEND_QUEUE_SIZE)
     {
-        status = execute_server_command(svc_cmd_id, msg_length);
+        if (AR_FAILED(flush_client(client)))
+            return AR_EFAILED;
+        if (client->send_length - client->send_offset + buf_len <= TCPIP_CMD_SERVER_MAX_SEND_QUEUE_SIZE)
+            break;
 
-        if (AR_FAILED(status))
+        pfd.fd = client->socket;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        rc = poll(&pfd, 1, TCPIP_CMD_SERVER_SEND_STALL_TIMEOUT_MS);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
         {
-            tcpip_cmd_server_create_error_resp(svc_cmd_id, status,
-                *out_buf, out_buf_len, resp_len);
-            status = AR_EOK;
-            goto process_message_end;
+            TCPIP_CMD_SVR_ERR("Error[%d]: Client %d stopped reading, dropping streamed response",
+                rc == 0 ? AR_ETIMEOUT : AR_EFAILED, client->id);
+            client->should_close = TRUE;
+            return AR_EFAILED;
         }
     }
 
-    //passing received data and blank output buffer to ats upcall
-    execute_command((uint8_t *)message_buffer.buffer, (uint32_t)msg_length,
-        (uint8_t**)out_buf, &resp_len);
+    queue_response(client, buf, buf_len);
 
-    //resp_len = recvlen_ptr;
+    return client->should_close ? AR_EFAILED : AR_EOK;
+}
 
-process_message_end:
-    TCPIP_CMD_SVR_DBG("Outbound message of length %d bytes", resp_len);
+int32_t TcpipCmdServer::stream_send_file(void *ctx, int32_t fd,
+    uint32_t file_offset, uint32_t length)
+{
+    tcpip_cmd_stream_ctx_t *stream_ctx = (tcpip_cmd_stream_ctx_t*)ctx;
 
-    return status;
+    return stream_ctx->server->send_file_response(
+        stream_ctx->client, fd, file_offset, length);
 }
 
-int32_t TcpipCmdServer::send_message(char_t* buf, uint32_t buf_len, uint32_t msg_len)
+int32_t TcpipCmdServer::send_file_response(tcpip_cmd_client_t *client,
+    int32_t fd, uint32_t file_offset, uint32_t length)
 {
-    int32_t status = AR_EOK;
-    int32_t bytes_sent = 0;
-    uint32_t data_length = 0;
-    uint32_t svc_cmd_id = 0;
-    char svc_id_str[ATS_SEVICE_ID_STR_LEN] = { 0 };
-
-    if (buf == NULL)
+    if (client->should_close)
+        return AR_EFAILED;
+    if (0 == length)
+        return AR_EOK;
+    if (client->file_fd >= 0)
     {
-        TCPIP_CMD_SVR_ERR("Error[%d]: The send buffer is null", AR_EBADPARAM);
-        return AR_EBADPARAM;
+        TCPIP_CMD_SVR_ERR("Error[%d]: A file is already queued for this client",
+            AR_EBUSY);
+        client->should_close = TRUE;
+        return AR_EFAILED;
     }
 
-    if (msg_len > buf_len)
+    /* The file is queued behind the bytes queued so far and sent from the
+     * event loop as the client reads it. The caller may close fd once this
+     * returns, so the queue keeps a descriptor of its own */
+    client->file_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (client->file_fd < 0)
     {
-        TCPIP_CMD_SVR_ERR("Error[%d]: The message length %d bytes is >"
-            " the send buffer length %d", AR_EBADPARAM, msg_len, buf_len);
-        return AR_EBADPARAM;
+        TCPIP_CMD_SVR_ERR("Error[%d]: Failed to queue file data. Error: %d",
+            AR_EFAILED, errno);
+        client->should_close = TRUE;
+        return AR_EFAILED;
     }
+    client->file_offset = file_offset;
+    client->file_length = length;
+    client->file_anchor = client->send_length;
 
-    tcpip_cmd_server_get_ats_command_length(buf, msg_len, &data_length);
+    (void)flush_client(client);
 
-    ar_mem_cpy(&svc_cmd_id, ATS_SERVICE_COMMAND_ID_LENGTH,
-        buf + ATS_SERVICE_COMMAND_ID_POSITION, ATS_SERVICE_COMMAND_ID_LENGTH);
-    ATS_SERVICE_ID_STR(svc_id_str, ATS_SEVICE_ID_STR_LEN, svc_cmd_id);
-    TCPIP_CMD_SVR_DBG("Command[%s-%d]: Sending response of %d bytes", svc_id_str, ATS_GET_COMMAND_ID(svc_cmd_id), data_length);
-
-    //Send response to client
-    status = ar_socket_send(accept_socket, buf, msg_len, 0, &bytes_sent);
-    if (AR_FAILED(status))
-    {
-        TCPIP_CMD_SVR_ERR("Unable to send message. Socket error: %d", AR_SOCKET_LAST_ERROR);
-        ar_socket_close(accept_socket);
-    }
-    else
-    {
-        TCPIP_CMD_SVR_DBG("Message sent");
-    }
-
-    return status;
+    return client->should_close ? AR_EFAILED : AR_EOK;
 }
 
-int32_t TcpipCmdServer::execute_server_command(uint32_t service_cmd_id, uint32_t message_length)
+int32_t TcpipCmdServer::execute_server_command(tcpip_cmd_client_t *client,
+    uint32_t service_cmd_id, char_t *msg_buf, uint32_t message_length)
 {
     switch (service_cmd_id)
     {
     case ATS_CMD_ONC_SET_MAX_BUFFER_LENGTH:
     {
         uint32_t new_buffer_size = 0;
-        uint32_t data_length = 0;
-        uint32_t offset = 0;
-        struct ar_heap_info_t heap_inf =
-        {
-            AR_HEAP_ALIGN_DEFAULT,
-            AR_HEAP_POOL_DEFAULT,
-            AR_HEAP_ID_DEFAULT,
-            AR_HEAP_TAG_DEFAULT
-        };
 
-        if (message_length < sizeof(uint32_t))
+        if (message_length < ATS_ACDB_BUFFER_POSITION + sizeof(uint32_t))
         {
             return AR_ENEEDMORE;
         }
 
-        ar_mem_cpy(&data_length, sizeof(uint32_t),
-            this->message_buffer.buffer + ATS_DATA_LENGTH_POSITION, sizeof(uint32_t));
         ar_mem_cpy(&new_buffer_size, sizeof(uint32_t),
-            this->message_buffer.buffer + ATS_ACDB_BUFFER_POSITION, sizeof(uint32_t));
+            msg_buf + ATS_ACDB_BUFFER_POSITION, sizeof(uint32_t));
 
         //The new buffer size needs to be between the required range to resize the message buffer:
         //range: AGWS_RECV_BUF_SIZE * 4 < new buffer size < GWS_MAX_BUFFER_SIZE
         //Largest buffer size is 2mb the GWS_MAX_BUFFER_SIZE
         //Smalleset buffer size is 4 * 1024 the recieve buffer size
-        if ((new_buffer_size > this->message_buffer.buffer_size && new_buffer_size < TCPIP_CMD_SERVER_MAX_MSG_BUFFER_SIZE) ||
-            (new_buffer_size < this->message_buffer.buffer_size && new_buffer_size > TCPIP_CMD_SERVER_MIN_MSG_BUFFER_SIZE)
+        //The receive buffer grows on demand up to this size, so only the limit changes here
+        if ((new_buffer_size > client->max_message_size && new_buffer_size < TCPIP_CMD_SERVER_MAX_MSG_BUFFER_SIZE) ||
+            (new_buffer_size < client->max_message_size && new_buffer_size > TCPIP_CMD_SERVER_MIN_MSG_BUFFER_SIZE)
             )
         {
-            ar_heap_free(message_buffer.buffer, &heap_inf);
-
-            message_buffer.buffer_size = new_buffer_size;
-            message_buffer.buffer = (char_t*)ar_heap_malloc(message_buffer.buffer_size, &heap_inf);
-            if (NULL == message_buffer.buffer)
-            {
-                TCPIP_CMD_SVR_ERR("Error[%d]: Failed to resize gateway message buffer", AR_ENOMEMORY);
-                return AR_ENOMEMORY;
-            }
-
-            ar_mem_set(message_buffer.buffer, 0, message_buffer.buffer_size);
-
-            /* Write the ATS command back to the resized message buffer so that the ATS Command
-             * layer can resize its buffer.*/
-            ar_mem_cpy(message_buffer.buffer, sizeof(uint32_t), &service_cmd_id, sizeof(uint32_t));
-            offset += sizeof(uint32_t);
-            ar_mem_cpy(message_buffer.buffer + offset, sizeof(uint32_t), &data_length, sizeof(uint32_t));
-            offset += sizeof(uint32_t);
-            ar_mem_cpy(message_buffer.buffer + offset, sizeof(uint32_t), &new_buffer_size, sizeof(uint32_t));
+            client->max_message_size = new_buffer_size;
         }
     }
     break;
@@ -944,4 +1266,11 @@ static void tcpip_cmd_server_create_error_resp(
         ATS_ERROR_CODE_LENGTH);
 }
 
+static uint32_t tcpip_cmd_server_get_pending_send_size(
+    const tcpip_cmd_client_t *client)
+{
+    return client->send_length - client->send_offset +
+        (client->file_fd >= 0 ? client->file_length : 0);
+}
+
 #endif /*ATS_TRANSPORT_TCPIP*/
@@ -21,6 +21,9 @@
 #ifdef ATS_TRANSPORT_TCPIP
 #ifdef ATS_DATA_LOGGING
 
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include "tcpip_dls_server.h"
 
 #define TCPIP_THREAD_PRIORITY_HIGH 0
@@ -62,17 +65,19 @@ int32_t TcpipDlsServer::start()
         return status;
     }
 
-    ar_osal_thread_attr_t thd_attr =
+    ar_osal_thread_attr_ext_t thd_attr =
     {
-        (char_t*)thd_name.c_str(),
-        TCPIP_THD_STACK_SIZE,
-        TCPIP_THREAD_PRIORITY_HIGH,
+        sizeof(ar_osal_thread_attr_ext_t),
+        { (char_t*)thd_name.c_str(), TCPIP_THD_STACK_SIZE, TCPIP_THREAD_PRIORITY_HIGH },
+        AR_OSAL_THREAD_SCHED_OTHER,
+        0,
+        ATS_THREAD_CPU_MASK
     };
 
     ar_osal_thread_start_routine r = \
         (ar_osal_thread_start_routine)(connect);
 
-    status = ar_osal_thread_create(&thread, &thd_attr, r, this);
+    status = ar_osal_thread_create_ext(&thread, &thd_attr, r, this);
     if (AR_FAILED(status))
     {
         TCPIP_DLS_ERR("Error[%d]: Failed to create thread %s", status, thd_name.c_str());
@@ -136,6 +141,7 @@ void* TcpipDlsServer::connect_routine(void* args)
     int32_t status = AR_EOK;
     char_t* str_addr = (char_t*)address.c_str();
     ar_socket_t listen_socket;
+    struct timeval timeout = { 0 };
 
     status = tcpip_socket_util_create_socket(TCPIP_SERVER_TYPE_DLS, AR_SOCKET_ADDRESS_FAMILY, str_addr, port, &listen_socket);
     if (AR_FAILED(status))
@@ -188,6 +194,15 @@ void* TcpipDlsServer::connect_routine(void* args)
         }
         ar_osal_mutex_unlock(connection_lock);
 
+        timeout.tv_sec = TCPIP_DLS_SEND_TIMEOUT_MS / 1000;
+        timeout.tv_usec = (TCPIP_DLS_SEND_TIMEOUT_MS % 1000) * 1000;
+        status = ar_socket_set_options(accept_socket, SOL_SOCKET, SO_SNDTIMEO,
+            (char_t*)&timeout, sizeof(struct timeval));
+        if (AR_FAILED(status))
+        {
+            TCPIP_DLS_ERR("Error[%d]: Failed to set the send timeout", status);
+        }
+
         TCPIP_DLS_INFO("Client connected to tcpip dls server...");
         break;
     }
@@ -197,10 +212,20 @@ void* TcpipDlsServer::connect_routine(void* args)
     return 0;
 }
 
-int32_t TcpipDlsServer::send_dls_log_buffers(const char_t* buffer, uint32_t buffer_size)
+int32_t TcpipDlsServer::send_dls_log_buffers(const ats_transport_buffer_t* buffers, uint32_t buffer_count)
 {
-    int32_t status = AR_EOK;
-    int32_t bytes_sent = 0;
+    struct iovec iov[TCPIP_DLS_MAX_SEND_BUFFERS];
+    struct msghdr msg;
+    ssize_t bytes_sent = 0;
+    size_t total_size = 0;
+    size_t total_sent = 0;
+    uint32_t first = 0;
+
+    if (NULL == buffers || 0 == buffer_count ||
+        buffer_count > TCPIP_DLS_MAX_SEND_BUFFERS)
+    {
+        return AR_EBADPARAM;
+    }
 
     if(ar_socket_is_invalid(accept_socket))
     {
@@ -208,16 +233,71 @@ int32_t TcpipDlsServer::send_dls_log_buffers(const char_t* buffer, uint32_t buff
         return AR_EFAILED;
     }
 
-    TCPIP_DLS_DBG("Preparing to send %d bytes", buffer_size);
-    status = ar_socket_send(accept_socket, buffer, buffer_size, 0, &bytes_sent);
-    if (AR_SUCCEEDED(status) && bytes_sent >= 0)
+    for (uint32_t i = 0; i < buffer_count; i++)
     {
-        TCPIP_DLS_DBG("Successfully Sent %d bytes:", bytes_sent);
-        return status;
+        iov[i].iov_base = (void*)buffers[i].buffer;
+        iov[i].iov_len = buffers[i].buffer_size;
+        total_size += buffers[i].buffer_size;
+    }
+
+    TCPIP_DLS_DBG("Preparing to send %d bytes in %d buffers", total_size, buffer_count);
+
+    /* MSG_NOSIGNAL so a client that went away fails the send instead of
+     * raising SIGPIPE in the sender */
+    ar_mem_set(&msg, 0, sizeof(msg));
+    while (first < buffer_count)
+    {
+        msg.msg_iov = &iov[first];
+        msg.msg_iovlen = buffer_count - first;
+        bytes_sent = sendmsg(accept_socket, &msg, MSG_NOSIGNAL);
+        if (bytes_sent < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            if (EAGAIN == errno || EWOULDBLOCK == errno)
+            {
+                TCPIP_DLS_ERR("Error[%d]: Client did not read log data for %dms", AR_ETIMEOUT,
+                    TCPIP_DLS_SEND_TIMEOUT_MS);
+                //If none of the message went out the stream is still framed
+                if (total_sent > 0)
+                    close_connection();
+                return AR_ETIMEOUT;
+            }
+
+            TCPIP_DLS_ERR("Error[%d]: Failed to send log data: %s", AR_EFAILED, strerror(errno));
+            close_connection();
+            return AR_EFAILED;
+        }
+        total_sent += (size_t)bytes_sent;
+
+        //Skip what was sent, a partial write resumes within a buffer
+        while (first < buffer_count && (size_t)bytes_sent >= iov[first].iov_len)
+        {
+            bytes_sent -= iov[first].iov_len;
+            first++;
+        }
+        if (first < buffer_count)
+        {
+            iov[first].iov_base = (uint8_t*)iov[first].iov_base + bytes_sent;
+            iov[first].iov_len -= bytes_sent;
+        }
     }
 
+    TCPIP_DLS_DBG("Successfully Sent %d bytes:", total_size);
     return AR_EOK;
 }
 
+void TcpipDlsServer::close_connection()
+{
+    TCPIP_DLS_ERR("Error[%d]: Closing the dls connection, the client has to reconnect",
+        AR_EFAILED);
+
+    ar_osal_mutex_lock(connection_lock);
+    ar_socket_close(accept_socket);
+    accept_socket = INVALID_SOCKET;
+    ar_osal_mutex_unlock(connection_lock);
+}
+
 #endif /*ATS_DATA_LOGGING*/
 #endif /*ATS_TRANSPORT_TCPIP*/
@@ -61,12 +61,23 @@ enum AcdbFileManCmd {
     /**< Retrieves loaded *.acdb and *.qwsp file information for all the
     databases initialied through acdb_init(..) and acdb_add_database(...)) */
     ACDB_FILE_MAN_GET_ALL_DATABASE_FILE_SETS,
-    /**< Retrieves file data for the specified database file (*.qwsp or *.acdb) */
+    /**< Retrieves file data for the specified database file (*.qwsp or *.acdb).
+    With a NULL response buffer only the number of bytes that would be
+    copied is returned */
     ACDB_FILE_MAN_GET_DATABASE_FILE_SET,
     /**< Sets the writable path for the specified database */
     ACDB_FILE_MAN_SET_WRITABLE_PATH,
     /**< Gets the writable path from the specified database */
-    ACDB_FILE_MAN_GET_WRITABLE_PATH
+    ACDB_FILE_MAN_GET_WRITABLE_PATH,
+    /**< Opens a new handle to the specified database file (*.qwsp or *.acdb)
+    so its data can be sent without copying it. The caller closes the handle */
+    ACDB_FILE_MAN_OPEN_DATABASE_FILE_SET,
+    /**< Compares a newly loaded *.acdb file chunk by chunk with the loaded
+    database that has the same file path */
+    ACDB_FILE_MAN_DIFF_DATABASE,
+    /**< Replaces the in-memory *.acdb file of a loaded database. The caller
+    must hold the ACDB client lock */
+    ACDB_FILE_MAN_SWAP_DATABASE
 };
 
 typedef enum _acdb_file_type_t AcdbFileType;
@@ -125,6 +136,49 @@ struct _acdb_file_man_get_file_data_req_t
 	uint8_t *file_name;
 };
 
+typedef struct _acdb_file_man_file_region_t AcdbFileManFileRegion;
+struct _acdb_file_man_file_region_t
+{
+    /*A new handle to the file, closed by the caller with ar_fclose*/
+    ar_fhandle file_handle;
+    /*Offset of the requested data in the file*/
+    uint32_t file_offset;
+    /*Length of the requested data, clamped to the end of the file*/
+    uint32_t file_data_len;
+};
+
+typedef struct _acdb_file_man_database_diff_t AcdbFileManDatabaseDiff;
+struct _acdb_file_man_database_diff_t
+{
+    /*The new *.acdb file, loaded in memory*/
+    AcdbFileManFileInfo *database_file;
+    /*The new *.qwsp file, NULL if the file set has none*/
+    AcdbFileManFileInfo *workspace_file;
+    /*Out: the loaded database with the same *.acdb file path*/
+    acdb_file_man_handle_t handle;
+    /*Out: the virtual machine id of the loaded database*/
+    uint32_t vm_id;
+    /*Out: number of chunks in the new file*/
+    uint32_t num_chunks;
+    /*Out: number of chunks that were added, removed or changed*/
+    uint32_t num_changed_chunks;
+    /*Out: TRUE if the file version changed, the delta data may not apply*/
+    bool_t is_version_changed;
+    /*Out: TRUE if data used to validate shared subgraphs changed*/
+    bool_t is_shared_subgraph_data_changed;
+};
+
+typedef struct _acdb_file_man_database_swap_t AcdbFileManDatabaseSwap;
+struct _acdb_file_man_database_swap_t
+{
+    /*The loaded database to update*/
+    acdb_file_man_handle_t handle;
+    /*In: the new *.acdb file. Out: the replaced file, released by the caller*/
+    AcdbFileManFileInfo *database_file;
+    /*Revalidate shared subgraphs against the other loaded databases*/
+    bool_t validate_shared_subgraphs;
+};
+
 typedef struct _acdb_file_man_rsp_t AcdbFileManBlob;
 struct _acdb_file_man_rsp_t
 {
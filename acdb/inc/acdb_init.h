@@ -43,6 +43,11 @@ typedef enum acdb_init_ioctl_cmd_t
     ACDB_INIT_CMD_REMOVE_DATABASE,
     /* Releases resources in all ACDB SW layers */
     ACDB_INIT_CMD_RESET,
+    /* Reloads the *.acdb file of a loaded database from the same path.
+     * The new file is read and compared outside the ACDB client lock, which
+     * is only held to swap it in. Returns AR_EUNSUPPORTED if the file set
+     * or file version changed and the database has to be re-added */
+    ACDB_INIT_CMD_RELOAD_DATABASE,
 }acdb_init_ioctl_cmd_t;
 
 typedef struct acdb_init_database_paths_t
@@ -52,6 +57,15 @@ typedef struct acdb_init_database_paths_t
     acdb_path_t writable_path;
 }acdb_init_database_paths_t;
 
+typedef struct acdb_init_reload_database_req_t
+{
+    /* The *.qwsp and *.acdb files of the database */
+    acdb_init_database_paths_t database_paths;
+    /* The database the files must belong to, or NULL for the
+     * database that was loaded from the same *.acdb file */
+    acdb_handle_t acdb_handle;
+}acdb_init_reload_database_req_t;
+
 /* ---------------------------------------------------------------------------
  * Function Declarations and Documentation
  *--------------------------------------------------------------------------- */
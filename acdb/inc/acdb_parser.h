@@ -258,4 +258,23 @@ int32_t acdb_parser_validate_file(acdb_buffer_t* in_mem_file);
 int32_t acdb_parser_get_acdb_header_v1(
     acdb_buffer_t* in_mem_file, acdb_header_v1_t* header);
 
+/**
+* \brief
+*		Walks the chunks of an in-memory *.acdb file in file order.
+*
+* \param[in] file_buffer: the *.acdb file
+* \param[in] buffer_length: size of file_buffer
+* \param[in/out] next_offset: 0 to start at the first chunk. Advanced past
+*		the returned chunk
+* \param[out] chunk_id: the chunk identifier
+* \param[out] chunk_offset: offset of the chunk data in the file
+* \param[out] chunk_size: size of the chunk data
+*
+* \return AR_EOK on success, AR_ENOTEXIST after the last chunk,
+*		AR_EFAILED if a chunk runs past the end of the file
+*/
+int32_t acdb_parser_get_next_chunk(
+    void* file_buffer, uint32_t buffer_length, uint32_t *next_offset,
+    uint32_t *chunk_id, uint32_t *chunk_offset, uint32_t *chunk_size);
+
 #endif /* __ACDB_PARSER_H__ */
@@ -121,6 +121,8 @@ struct _acdb_file_man_database_info_t {
     uint32_t database_cache_size;
     /**< A pointer to the database file cached in memory */
     void* database_cache;
+    /**< Identifies the file the cache was read from */
+    ar_fid_t database_file_id;
     /**< The path to the database file */
     acdb_path_256_t database_file;
     /**< The path where the database files reside */
@@ -538,6 +540,7 @@ int32_t AcdbFileManAddAcdb(int32_t index, uint32_t *vm_id,
     db_info->database_cache_size = file_info->file.size;
     db_info->file_handle = file_info->file_handle;
     db_info->file_type = file_info->file_type;
+    (void)ar_fget_id(db_info->file_handle, &db_info->database_file_id);
     db_info->database_file.path_len = file_info->path_length;
     ACDB_MEM_CPY_SAFE(
         &db_info->database_file.path[0], file_info->path_length,
@@ -1391,6 +1394,13 @@ int32_t AcdbFileManGetQwspFileData(AcdbFileManWorkspaceInfo* ws_info,
         data_copy_size = (size_t)req->file_data_len;
     }
 
+    /* Without a buffer only report how much would be copied */
+    if (IsNull(rsp->buf))
+    {
+        rsp->bytes_filled = (uint32_t)data_copy_size;
+        return AR_EOK;
+    }
+
     status = AcdbFileManQwspFileIO(ws_info, ACDB_FM_FILE_OP_OPEN);
     if (AR_FAILED(status)) return status;
 
@@ -1454,6 +1464,13 @@ int32_t AcdbFileManGetAcdbFileData(AcdbFileManDatabaseInfo *db_info,
         data_copy_size = (size_t)req->file_data_len;
     }
 
+    /* Without a buffer only report how much would be copied */
+    if (IsNull(rsp->buf))
+    {
+        rsp->bytes_filled = (uint32_t)data_copy_size;
+        return AR_EOK;
+    }
+
     status = acdb_fm_read_db_mem((acdb_file_man_handle_t)db_info, rsp->buf,
         data_copy_size, &req->file_offset);
     if (AR_FAILED(status))
@@ -1467,8 +1484,20 @@ int32_t AcdbFileManGetAcdbFileData(AcdbFileManDatabaseInfo *db_info,
     return status;
 }
 
-int32_t AcdbFileManGetDatabaseFileSet(
-    AcdbFileManGetFileDataReq* req, AcdbFileManBlob* rsp)
+/**
+* \brief
+*       Finds the loaded *.acdb or *.qwsp file named by the request
+*
+* \param[in] req: Request holding the database handle and file name
+* \param[out] db_info: The database the file belongs to
+* \param[out] ws_info: The workspace of that database
+* \param[out] path_type: Whether the file is the *.acdb or the *.qwsp file
+*
+* \return 0 on success, non-zero on failure
+*/
+static int32_t AcdbFileManFindDatabaseFile(
+    AcdbFileManGetFileDataReq* req, AcdbFileManDatabaseInfo** db_info,
+    AcdbFileManWorkspaceInfo** ws_info, AcdbPathType* path_type)
 {
     int32_t status = AR_EOK;
     char_t* fname = NULL;
@@ -1477,24 +1506,15 @@ int32_t AcdbFileManGetDatabaseFileSet(
     uint32_t path_len = 0;
     uint32_t db_count = acdb_file_man_context.database_count;
     bool_t found_handle = false;
-    AcdbFileManDatabaseInfo* db_info = NULL;
-    AcdbFileManWorkspaceInfo* ws_info = NULL;
-    AcdbPathType path_type = ACDB_PATH_TYPE_NONE;
     const char* WKSP_FILE_NAME_EXT = ".qwsp";
     const char* ACDB_FILE_NAME_EXT = ".acdb";
 
-    if (req == NULL || rsp == NULL)
-    {
-        ACDB_ERR("Error[%d]: One or more input parameter(s) are null");
-        return AR_EBADPARAM;
-    }
-
     for (uint32_t i = 0; i < db_count; i++)
     {
-        db_info = ACDB_FM_DB_INFO_AT_INDEX(i);
-        ws_info = ACDB_FM_WS_INFO_AT_INDEX(i);
+        *db_info = ACDB_FM_DB_INFO_AT_INDEX(i);
+        *ws_info = ACDB_FM_WS_INFO_AT_INDEX(i);
 
-        found_handle = db_info->vm_id == req->acdb_handle;
+        found_handle = (*db_info)->vm_id == req->acdb_handle;
 
         if (found_handle)
             break;
@@ -1509,15 +1529,15 @@ int32_t AcdbFileManGetDatabaseFileSet(
 
     if (!IsNull(ACDB_FIND_STR((char_t*)req->file_name, WKSP_FILE_NAME_EXT)))
     {
-        path_type = ACDB_PATH_TYPE_QWSP_FILE;
-        path = &ws_info->workspace_file.path[0];
-        path_len = ws_info->workspace_file.path_len;
+        *path_type = ACDB_PATH_TYPE_QWSP_FILE;
+        path = &(*ws_info)->workspace_file.path[0];
+        path_len = (*ws_info)->workspace_file.path_len;
     }
     else if (!IsNull(ACDB_FIND_STR((char_t*)req->file_name, ACDB_FILE_NAME_EXT)))
     {
-        path_type = ACDB_PATH_TYPE_ACDB_FILE;
-        path = &db_info->database_file.path[0];
-        path_len = db_info->database_file.path_len;
+        *path_type = ACDB_PATH_TYPE_ACDB_FILE;
+        path = &(*db_info)->database_file.path[0];
+        path_len = (*db_info)->database_file.path_len;
     }
     else
     {
@@ -1543,7 +1563,26 @@ int32_t AcdbFileManGetDatabaseFileSet(
         return AR_ENOTEXIST;
     }
 
-    status = AR_EOK;
+    return AR_EOK;
+}
+
+int32_t AcdbFileManGetDatabaseFileSet(
+    AcdbFileManGetFileDataReq* req, AcdbFileManBlob* rsp)
+{
+    int32_t status = AR_EOK;
+    AcdbFileManDatabaseInfo* db_info = NULL;
+    AcdbFileManWorkspaceInfo* ws_info = NULL;
+    AcdbPathType path_type = ACDB_PATH_TYPE_NONE;
+
+    if (req == NULL || rsp == NULL)
+    {
+        ACDB_ERR("Error[%d]: One or more input parameter(s) are null");
+        return AR_EBADPARAM;
+    }
+
+    status = AcdbFileManFindDatabaseFile(req, &db_info, &ws_info, &path_type);
+    if (AR_FAILED(status))
+        return status;
 
     switch (path_type)
     {
@@ -1566,6 +1605,298 @@ int32_t AcdbFileManGetDatabaseFileSet(
     return status;
 }
 
+/**
+* \brief
+*       Checks whether two file ids name the same, unmodified file
+*
+* \param[in] a: The first file id
+* \param[in] b: The second file id
+*
+* \return TRUE if the ids are equal, FALSE otherwise
+*/
+static bool_t AcdbFileManIsSameFileId(const ar_fid_t* a, const ar_fid_t* b)
+{
+    return (a->dev == b->dev && a->ino == b->ino &&
+        a->size == b->size && a->mtime_ns == b->mtime_ns &&
+        0 != a->ino);
+}
+
+int32_t AcdbFileManOpenDatabaseFileSet(
+    AcdbFileManGetFileDataReq* req, AcdbFileManFileRegion* rsp)
+{
+    int32_t status = AR_EOK;
+    AcdbFileManDatabaseInfo* db_info = NULL;
+    AcdbFileManWorkspaceInfo* ws_info = NULL;
+    AcdbPathType path_type = ACDB_PATH_TYPE_NONE;
+    ar_fhandle fhandle = NULL;
+    char_t* path = NULL;
+    size_t file_size = 0;
+    ar_fid_t file_id = { 0 };
+
+    if (req == NULL || rsp == NULL)
+    {
+        ACDB_ERR("Error[%d]: One or more input parameter(s) are null",
+            AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    status = AcdbFileManFindDatabaseFile(req, &db_info, &ws_info, &path_type);
+    if (AR_FAILED(status))
+        return status;
+
+    path = ACDB_PATH_TYPE_QWSP_FILE == path_type ?
+        &ws_info->workspace_file.path[0] : &db_info->database_file.path[0];
+
+    /* A handle of its own lets the caller read the file after the lock is
+     * released, even if the database is unloaded meanwhile */
+    status = ar_fopen(&fhandle, path, AR_FOPEN_READ_ONLY);
+    if (AR_FAILED(status) || IsNull(fhandle))
+    {
+        ACDB_ERR("Error[%d]: Unable to open file: %s", status, path);
+        return AR_FAILED(status) ? status : AR_EFAILED;
+    }
+
+    file_size = ar_fsize(fhandle);
+
+    /* Clients must get what ACDB loaded, not a file replaced or modified
+     * since. Workspace files are not cached, every read serves the file
+     * currently at the path */
+    if (ACDB_PATH_TYPE_ACDB_FILE == path_type &&
+        (AR_FAILED(ar_fget_id(fhandle, &file_id)) ||
+        !AcdbFileManIsSameFileId(&file_id, &db_info->database_file_id) ||
+        file_size != db_info->database_cache_size))
+    {
+        ACDB_ERR("Error[%d]: %s changed on disk after it was loaded",
+            AR_EUNSUPPORTED, path);
+        (void)ar_fclose(fhandle);
+        return AR_EUNSUPPORTED;
+    }
+
+    if (file_size < req->file_offset)
+    {
+        ACDB_ERR("Error[%d]: The provided offset is past the end of the file",
+            AR_EBADPARAM);
+        (void)ar_fclose(fhandle);
+        return AR_EBADPARAM;
+    }
+
+    rsp->file_handle = fhandle;
+    rsp->file_offset = req->file_offset;
+    rsp->file_data_len = req->file_data_len;
+    if (file_size - req->file_offset < req->file_data_len)
+        rsp->file_data_len = (uint32_t)(file_size - req->file_offset);
+
+    return AR_EOK;
+}
+
+/**
+* \brief
+*       Exchanges the in-memory *.acdb file of a loaded database with the
+*       file described by file_info
+*
+* \param[in] db_info: the loaded database
+* \param[in/out] file_info: the file to put in place, receives the
+*       replaced file
+* \return none
+*/
+static void AcdbFileManExchangeCache(
+    AcdbFileManDatabaseInfo* db_info, AcdbFileManFileInfo* file_info)
+{
+    ar_fhandle file_handle = db_info->file_handle;
+    void* database_cache = db_info->database_cache;
+    uint32_t database_cache_size = db_info->database_cache_size;
+
+    db_info->file_handle = file_info->file_handle;
+    db_info->database_cache = file_info->file.buffer;
+    db_info->database_cache_size = file_info->file.size;
+
+    file_info->file_handle = file_handle;
+    file_info->file.buffer = database_cache;
+    file_info->file.size = database_cache_size;
+
+    ar_mem_set(&db_info->database_file_id, 0, sizeof(ar_fid_t));
+    (void)ar_fget_id(db_info->file_handle, &db_info->database_file_id);
+}
+
+static bool_t AcdbFileManIsSharedSubgraphChunk(uint32_t chunk_id)
+{
+    /* Shared subgraph properties are global properties whose
+     * data lives in the data pool */
+    return ACDB_CHUNKID_GLOBAL_PROP == chunk_id ||
+        ACDB_CHUNKID_DATAPOOL == chunk_id;
+}
+
+int32_t AcdbFileManDiffDatabase(AcdbFileManDatabaseDiff* diff)
+{
+    int32_t status = AR_EOK;
+    int32_t old_status = AR_EOK;
+    AcdbFileManDatabaseInfo* db_info = NULL;
+    AcdbFileManWorkspaceInfo* ws_info = NULL;
+    acdb_buffer_t* new_file = NULL;
+    acdb_buffer_t old_file = { 0 };
+    acdb_header_v1_t new_header = { 0 };
+    acdb_header_v1_t old_header = { 0 };
+    uint32_t new_next = 0, new_id = 0, new_offset = 0, new_size = 0;
+    uint32_t old_next = 0, old_id = 0, old_offset = 0, old_size = 0;
+    bool_t is_changed = FALSE;
+
+    if (IsNull(diff) || IsNull(diff->database_file))
+    {
+        ACDB_ERR("Error[%d]: One or more input parameter(s) are null",
+            AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    for (int32_t i = 0; i < ACDB_MAX_ACDB_FILES; i++)
+    {
+        db_info = ACDB_FM_DB_INFO_AT_INDEX(i);
+        if (!IsNull(db_info) && 0 == ar_strcmp(
+            &db_info->database_file.path[0],
+            diff->database_file->path, ACDB_MAX_PATH_LENGTH))
+            break;
+
+        db_info = NULL;
+    }
+
+    if (IsNull(db_info))
+        return AR_ENOTEXIST;
+
+    ws_info = ACDB_FM_WS_INFO_AT_INDEX(db_info->file_index);
+    if (IsNull(ws_info) != IsNull(diff->workspace_file) ||
+        (!IsNull(ws_info) && 0 != ar_strcmp(
+            &ws_info->workspace_file.path[0],
+            diff->workspace_file->path, ACDB_MAX_PATH_LENGTH)))
+    {
+        ACDB_DBG("The workspace file loaded with %s differs",
+            diff->database_file->path);
+        return AR_ENOTEXIST;
+    }
+
+    old_file.buffer = db_info->database_cache;
+    old_file.size = db_info->database_cache_size;
+    new_file = &diff->database_file->file;
+
+    status = acdb_parser_get_acdb_header_v1(&old_file, &old_header);
+    if (AR_FAILED(status))
+        return status;
+
+    status = acdb_parser_get_acdb_header_v1(new_file, &new_header);
+    if (AR_FAILED(status))
+        return status;
+
+    diff->handle = (acdb_file_man_handle_t)db_info;
+    diff->vm_id = db_info->vm_id;
+    diff->num_chunks = 0;
+    diff->num_changed_chunks = 0;
+    diff->is_version_changed = 0 != ar_mem_cmp(
+        &old_header.file_version, &new_header.file_version,
+        sizeof(acdb_file_version_t));
+    diff->is_shared_subgraph_data_changed = FALSE;
+
+    /* Chunks are compared in file order, so a chunk that was added or
+     * removed also marks the chunks that follow it as changed */
+    for (;;)
+    {
+        status = acdb_parser_get_next_chunk(new_file->buffer, new_file->size,
+            &new_next, &new_id, &new_offset, &new_size);
+        if (AR_ENOTEXIST == status)
+            break;
+        if (AR_FAILED(status))
+        {
+            ACDB_ERR("Error[%d]: Chunk %d of %s is truncated", status,
+                diff->num_chunks, diff->database_file->path);
+            return status;
+        }
+
+        diff->num_chunks++;
+        is_changed = TRUE;
+
+        if (AR_SUCCEEDED(old_status))
+        {
+            old_status = acdb_parser_get_next_chunk(
+                old_file.buffer, old_file.size,
+                &old_next, &old_id, &old_offset, &old_size);
+
+            is_changed = AR_FAILED(old_status) ||
+                old_id != new_id || old_size != new_size ||
+                0 != ar_mem_cmp((uint8_t*)old_file.buffer + old_offset,
+                    (uint8_t*)new_file->buffer + new_offset, new_size);
+        }
+
+        if (!is_changed)
+            continue;
+
+        diff->num_changed_chunks++;
+        if (AcdbFileManIsSharedSubgraphChunk(new_id))
+            diff->is_shared_subgraph_data_changed = TRUE;
+    }
+
+    /* Whatever is left in the loaded file was removed */
+    while (AR_SUCCEEDED(old_status))
+    {
+        old_status = acdb_parser_get_next_chunk(
+            old_file.buffer, old_file.size,
+            &old_next, &old_id, &old_offset, &old_size);
+        if (AR_FAILED(old_status))
+            break;
+
+        diff->num_changed_chunks++;
+        if (AcdbFileManIsSharedSubgraphChunk(old_id))
+            diff->is_shared_subgraph_data_changed = TRUE;
+    }
+
+    return AR_EOK;
+}
+
+int32_t AcdbFileManSwapDatabase(AcdbFileManDatabaseSwap* swap)
+{
+    int32_t status = AR_EOK;
+    int32_t database_index = 0;
+    int32_t latest_database_index = 0;
+    AcdbFileManDatabaseInfo* db_info = NULL;
+
+    if (IsNull(swap) || IsNull(swap->handle) ||
+        IsNull(swap->database_file))
+    {
+        ACDB_ERR("Error[%d]: One or more input parameter(s) are null",
+            AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    db_info = (AcdbFileManDatabaseInfo*)swap->handle;
+
+    ACDB_MUTEX_LOCK(acdb_file_man_context.file_man_lock);
+
+    AcdbFileManExchangeCache(db_info, swap->database_file);
+
+    if (swap->validate_shared_subgraphs &&
+        acdb_file_man_context.database_count > 1)
+    {
+        /* Validate the reloaded database as if it was just added */
+        database_index = acdb_file_man_context.database_index;
+        latest_database_index = acdb_file_man_context.latest_database_index;
+        acdb_file_man_context.latest_database_index =
+            (int32_t)db_info->file_index;
+
+        status = AcdbFileManValidateSharedSubgraphs();
+
+        acdb_file_man_context.latest_database_index = latest_database_index;
+        acdb_file_man_context.database_index = database_index;
+
+        if (AR_FAILED(status))
+        {
+            ACDB_ERR("Error[%d]: The shared subgraphs in %s do not match "
+                "the other databases. Keeping the loaded file",
+                status, db_info->database_file.path);
+            AcdbFileManExchangeCache(db_info, swap->database_file);
+        }
+    }
+
+    ACDB_MUTEX_UNLOCK(acdb_file_man_context.file_man_lock);
+
+    return status;
+}
+
 int32_t AcdbFileManSetWritablePath(
     acdb_file_man_writable_path_info_t* info)
 {
@@ -2106,6 +2437,39 @@ int32_t acdb_file_man_ioctl(uint32_t cmd_id,
             (AcdbFileManBlob*)rsp);
         break;
     }
+    case ACDB_FILE_MAN_OPEN_DATABASE_FILE_SET:
+    {
+        if (req == NULL || req_size == 0 ||
+            rsp == NULL || rsp_size != sizeof(AcdbFileManFileRegion))
+        {
+            return AR_EBADPARAM;
+        }
+
+        status = AcdbFileManOpenDatabaseFileSet(
+            (AcdbFileManGetFileDataReq*)req,
+            (AcdbFileManFileRegion*)rsp);
+        break;
+    }
+    case ACDB_FILE_MAN_DIFF_DATABASE:
+    {
+        if (req == NULL || req_size != sizeof(AcdbFileManDatabaseDiff))
+        {
+            return AR_EBADPARAM;
+        }
+
+        status = AcdbFileManDiffDatabase((AcdbFileManDatabaseDiff*)req);
+        break;
+    }
+    case ACDB_FILE_MAN_SWAP_DATABASE:
+    {
+        if (req == NULL || req_size != sizeof(AcdbFileManDatabaseSwap))
+        {
+            return AR_EBADPARAM;
+        }
+
+        status = AcdbFileManSwapDatabase((AcdbFileManDatabaseSwap*)req);
+        break;
+    }
     case ACDB_FILE_MAN_GET_WRITABLE_PATH:
     {
         if (req == NULL ||
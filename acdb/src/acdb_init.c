@@ -541,6 +541,151 @@ int32_t acdb_init_remove_database(acdb_handle_t *acdb_handle)
 	return status;
 }
 
+int32_t acdb_init_reload_database(acdb_init_reload_database_req_t *req)
+{
+	int32_t status = AR_EOK;
+	int32_t delta_status = AR_EOK;
+	uint32_t i = 0;
+	acdb_init_database_paths_t *database_paths = NULL;
+	acdb_file_version_t acdb_file_version = { 0 };
+	AcdbFileManFileInfo fm_file_info[ACDB_MAX_FILE_ADD_LIMIT] = { 0 };
+	AcdbFileManDatabaseDiff diff = { 0 };
+	AcdbFileManDatabaseSwap swap = { 0 };
+	acdb_context_handle_t *ctx_handle = NULL;
+
+	if (IsNull(req) || req->database_paths.num_files == 0 ||
+		req->database_paths.num_files > ACDB_MAX_FILE_ADD_LIMIT)
+	{
+		ACDB_ERR("Error[%d]: Expected 1 to %d database files.",
+			AR_EBADPARAM, ACDB_MAX_FILE_ADD_LIMIT);
+		return AR_EBADPARAM;
+	}
+
+	database_paths = &req->database_paths;
+
+	/* Load and validate the new files without blocking ACDB clients */
+	for (i = 0; i < database_paths->num_files; i++)
+	{
+		fm_file_info[i].file_index = i;
+		fm_file_info[i].path_length =
+			database_paths->acdb_data_files[i].path_length;
+		fm_file_info[i].path =
+			database_paths->acdb_data_files[i].path;
+
+		status = AcdbInitLoadAcdbFile(&fm_file_info[i], &acdb_file_version);
+		if (AR_FAILED(status))
+		{
+			ACDB_ERR("Error[%d]: Unable to load %s", status,
+				fm_file_info[i].path);
+			goto end;
+		}
+
+		if (ACDB_FILE_TYPE_WORKSPACE == fm_file_info[i].file_type)
+			diff.workspace_file = &fm_file_info[i];
+		else if (IsNull(diff.database_file))
+			diff.database_file = &fm_file_info[i];
+		else
+		{
+			status = AR_EUNSUPPORTED;
+			goto end;
+		}
+	}
+
+	if (IsNull(diff.database_file))
+	{
+		ACDB_ERR("Error[%d]: No *.acdb files were found.", AR_ENORESOURCE);
+		status = AR_ENORESOURCE;
+		goto end;
+	}
+
+	status = acdb_file_man_ioctl(ACDB_FILE_MAN_DIFF_DATABASE,
+		&diff, sizeof(AcdbFileManDatabaseDiff), NULL, 0);
+	if (AR_ENOTEXIST == status ||
+		(AR_SUCCEEDED(status) && !IsNull(req->acdb_handle) &&
+		 ACDB_HANDLE_TO_UINT(&req->acdb_handle) != diff.vm_id))
+	{
+		ACDB_DBG("%s is not loaded with the same file set",
+			diff.database_file->path);
+		status = AR_EUNSUPPORTED;
+		goto end;
+	}
+	else if (AR_FAILED(status))
+	{
+		ACDB_ERR("Error[%d]: Unable to compare %s with the loaded database",
+			status, diff.database_file->path);
+		goto end;
+	}
+
+	if (diff.is_version_changed)
+	{
+		/* The delta file is only valid for one file version */
+		ACDB_DBG("The file version of %s changed",
+			diff.database_file->path);
+		status = AR_EUNSUPPORTED;
+		goto end;
+	}
+
+	if (0 == diff.num_changed_chunks)
+	{
+		ACDB_INFO("%s is unchanged. Skipping reload",
+			diff.database_file->path);
+		goto end;
+	}
+
+	status = acdb_ctx_man_ioctl(ACDB_CTX_MAN_CMD_GET_CONTEXT_HANDLE,
+		&diff.vm_id, sizeof(uint32_t),
+		&ctx_handle, sizeof(acdb_context_handle_t));
+	if (AR_FAILED(status) || IsNull(ctx_handle))
+	{
+		ACDB_ERR("Error[%d]: Unable to get context handle", status);
+		status = AR_FAILED(status) ? status : AR_EHANDLE;
+		goto end;
+	}
+
+	ACDB_INFO("Reloading %s, %d of %d chunks changed",
+		diff.database_file->path, diff.num_changed_chunks, diff.num_chunks);
+
+	swap.handle = diff.handle;
+	swap.database_file = diff.database_file;
+	swap.validate_shared_subgraphs = diff.is_shared_subgraph_data_changed;
+
+	/* Clients still read the old file until it is swapped out here */
+	ACDB_MUTEX_LOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+
+	status = acdb_file_man_ioctl(ACDB_FILE_MAN_SWAP_DATABASE,
+		&swap, sizeof(AcdbFileManDatabaseSwap), NULL, 0);
+	if (AR_SUCCEEDED(status))
+	{
+		/* As with re-adding the database, calibration set at runtime is
+		 * dropped and the delta file contents are loaded again */
+		delta_status = acdb_heap_ioctl(ACDB_HEAP_CMD_CLEAR_DATABASE_HEAP,
+			ctx_handle->heap_handle, sizeof(acdb_heap_handle_t), NULL, 0);
+		if (AR_SUCCEEDED(delta_status) &&
+			!IsNull(ctx_handle->delta_manager_handle))
+		{
+			delta_status = acdb_delta_data_ioctl(ACDB_DELTA_DATA_CMD_INIT_HEAP,
+				ctx_handle, sizeof(acdb_context_handle_t), NULL, 0);
+		}
+
+		if (AR_FAILED(delta_status))
+		{
+			ACDB_ERR("Warning[%d]: Unable to load delta file into heap",
+				delta_status);
+		}
+	}
+
+	ACDB_MUTEX_UNLOCK(ACDB_CTX_MAN_CLIENT_CMD_LOCK);
+
+end:
+	/* After a successful swap this releases the previously loaded file */
+	for (i = 0; i < database_paths->num_files; i++)
+	{
+		AcdbInitUnloadAcdbFile(&fm_file_info[i]);
+	}
+
+	return status;
+}
+
 int32_t acdb_init_reset(void)
 {
 	int32_t status = AR_EOK;
@@ -618,6 +763,13 @@ int32_t acdb_init_ioctl(uint32_t cmd_id,
 	case ACDB_INIT_CMD_RESET:
 		status = acdb_init_reset();
 		break;
+	case ACDB_INIT_CMD_RELOAD_DATABASE:
+		if (IsNull(req) || req_size < sizeof(acdb_init_reload_database_req_t))
+			return AR_EBADPARAM;
+
+		status = acdb_init_reload_database(
+			(acdb_init_reload_database_req_t*)req);
+		break;
     default:
         status = AR_EUNSUPPORTED;
         ACDB_ERR("Error[%d]: Unknown command id %d", cmd_id);
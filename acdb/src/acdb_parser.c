@@ -112,6 +112,46 @@ int32_t acdb_parser_get_chunk(
     return status;
 }
 
+int32_t acdb_parser_get_next_chunk(
+    void* file_buffer, uint32_t buffer_length, uint32_t *next_offset,
+    uint32_t *chunk_id, uint32_t *chunk_offset, uint32_t *chunk_size)
+{
+    uint8_t *start_ptr = NULL;
+    uint8_t *end_ptr = NULL;
+    acdb_chunk_header_t *header = NULL;
+
+    if (file_buffer == NULL || next_offset == NULL || chunk_id == NULL ||
+        chunk_offset == NULL || chunk_size == NULL ||
+        buffer_length < sizeof(acdb_file_properties_t))
+    {
+        return AR_EBADPARAM;
+    }
+
+    if (*next_offset == 0)
+        *next_offset = sizeof(acdb_file_properties_t);
+
+    if (*next_offset >= buffer_length)
+        return AR_ENOTEXIST;
+
+    start_ptr = (uint8_t*)file_buffer + *next_offset;
+    end_ptr = (uint8_t*)file_buffer + buffer_length;
+
+    if (start_ptr + sizeof(acdb_chunk_header_t) > end_ptr)
+        return AR_EFAILED;
+
+    header = (acdb_chunk_header_t*)start_ptr;
+    if (header->size > (uint32_t)(end_ptr - start_ptr)
+        - sizeof(acdb_chunk_header_t))
+        return AR_EFAILED;
+
+    *chunk_id = header->id;
+    *chunk_offset = *next_offset + sizeof(acdb_chunk_header_t);
+    *chunk_size = header->size;
+    *next_offset = *chunk_offset + header->size;
+
+    return AR_EOK;
+}
+
 int32_t acdb_parser_validate_file(acdb_buffer_t *in_mem_file)
 {
 	int32_t status = AR_EOK;
@@ -34,6 +34,7 @@ LOCAL_ADDITIONAL_DEPENDENCIES  := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
 LOCAL_SRC_FILES := src/linux/ar_osal_mutex.c \
                    src/linux/ar_osal_thread.c \
                    src/linux/ar_osal_signal.c \
+                   src/linux/ar_osal_signal2.c \
                    src/linux/ar_osal_log.c \
                    src/linux/ar_osal_file_io.c \
                    src/linux/ar_osal_sleep.c\
@@ -63,6 +63,20 @@ typedef enum ar_fseek_reference {
     AR_FSEEK_CURRENT = 2
 } ar_fseek_reference_t ;
 
+/** Identifies the file behind a handle and the version of its contents,
+  * see ar_fget_id. Two ids are equal only if all fields are equal.
+  */
+typedef struct ar_fid {
+    /** Device holding the file */
+    uint64_t dev;
+    /** File serial number on that device */
+    uint64_t ino;
+    /** Size of the file in bytes */
+    uint64_t size;
+    /** Last modification time, in nanoseconds */
+    uint64_t mtime_ns;
+} ar_fid_t;
+
 /**
  * \brief ar_fopen
  *        open a file or create if does not exist. 
@@ -96,6 +110,38 @@ int32_t ar_fopen(ar_fhandle *handle,
  */
 size_t ar_fsize(ar_fhandle handle);
 
+/**
+ * \brief ar_fget_fd
+ *          Get the native file descriptor of an open file, e.g. to hand
+ *          the file to sendfile. The descriptor is owned by the handle and
+ *          is closed by ar_fclose
+ *
+ * \param[in] handle: Handle to the file
+ * \param[out] fd: The file descriptor
+ *
+ * \return
+ *  0 -- Success
+ *  AR_EUNSUPPORTED -- The platform has no file descriptors
+ *  Nonzero -- Failure
+ */
+int32_t ar_fget_fd(ar_fhandle handle, int32_t *fd);
+
+/**
+ * \brief ar_fget_id
+ *          Get the identity of an open file. Comparing the id of a file
+ *          taken when it was read with the id of a new handle tells whether
+ *          the path still names the same, unmodified file.
+ *
+ * \param[in] handle: Handle to the file
+ * \param[out] id: The identity of the file
+ *
+ * \return
+ *  0 -- Success
+ *  AR_EUNSUPPORTED -- The platform cannot identify files
+ *  Nonzero -- Failure
+ */
+int32_t ar_fget_id(ar_fhandle handle, ar_fid_t *id);
+
 /**
  * \brief ar_fmap
  *          Map a file into Data Memory for Read Only access
@@ -183,6 +229,33 @@ int32_t ar_fwrite(ar_fhandle handle,
                             size_t write_size,
                             size_t *bytes_written);
 
+/**
+ * \brief ar_fsync
+ *          Write data buffered for the file to storage and wait until it
+ *          is durable, e.g. before the file is renamed over another one
+ *
+ * \param[in] handle: Handle to the file
+ *
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_fsync(ar_fhandle handle);
+
+/**
+ * \brief ar_fsync_dir
+ *          Wait until files created, renamed or deleted in a directory
+ *          are durable, e.g. after ar_frename
+ *
+ * \param[in] path: Absolute path of the directory
+ *
+ * \return
+ *  0 -- Success
+ *  AR_EUNSUPPORTED -- The platform cannot sync directories
+ *  Nonzero -- Failure
+ */
+int32_t ar_fsync_dir(const char_t *path);
+
 /**
  * \brief  ar_fclose 
  * \param[in] handle: Handle to the file.  
@@ -201,6 +274,19 @@ int32_t ar_fclose(ar_fhandle handle);
  */
 int32_t ar_fdelete(const char_t *path);
 
+/**
+ *  \brief  ar_frename
+ *          Rename a file, replacing new_path if it exists. Where the
+ *          platform allows it the replacement is atomic, readers of
+ *          new_path see either the old or the new file.
+ *  \param[in]  old_path: Absolute path of the file to rename.
+ *  \param[in]  new_path: Absolute path to rename the file to.
+ *  \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_frename(const char_t *old_path, const char_t *new_path);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
@@ -53,6 +53,14 @@ typedef enum _ar_heap_pool_type
 	AR_HEAP_POOL_NON_PAGED_NX = 2,
 	/** allocated memory is pageable.*/
 	AR_HEAP_POOL_PAGED = 4,
+	/** allocated from the arena created for the tag with ar_heap_arena_create(),
+	    released in bulk by ar_heap_arena_reset(). Falls back to the default pool
+	    when the tag has no arena. */
+	AR_HEAP_POOL_ARENA = 8,
+	/** requests up to 1 KiB are served from per size class slabs and must be
+	    released with ar_heap_free(), never free(). Larger requests and those
+	    aligned beyond 16 bytes come from the default pool. */
+	AR_HEAP_POOL_SLAB = 16,
 } ar_heap_pool_type;
 
 /** default heap memory tag ASCII characters: 'LASO'->'OSAL' */
@@ -63,7 +71,7 @@ typedef enum _ar_heap_pool_type
 */
 typedef struct ar_heap_info_t
 {
-	ar_heap_align_bytes    align_bytes; /** heap memory byte alignment required.*/
+	ar_heap_align_bytes    align_bytes; /** heap memory byte alignment required, other powers of two are taken as a byte count.*/
 	ar_heap_pool_type      pool_type;   /** pool type to allocate heap memory. */
 	ar_heap_id             heap_id;     /** head id to allocate heap memory. */
 	uint32_t                 tag;         /** used for tracing heap memory allocations.default:AR_HEAP_TAG_DEFAULT */
@@ -73,6 +81,22 @@ typedef struct ar_heap_info_t
                                           /** Each ASCII character in the tag must be a value in the range 0x20 (space)to 0x7E (tilde).*/
 } ar_heap_info, * par_heap_info;
 
+/** maximum number of distinct tags accounted by ar_heap_get_tag_stats() */
+#define AR_HEAP_MAX_TAGS        (64)
+
+/**
+* Heap usage of one tag
+*/
+typedef struct ar_heap_tag_stats_t
+{
+	uint32_t tag;            /** tag of the allocations. */
+	uint32_t reserved;
+	uint64_t bytes_in_use;   /** bytes currently allocated, arena bytes until the arena is reset. */
+	uint64_t peak_bytes;     /** highest value of bytes_in_use. */
+	uint64_t num_allocs;     /** number of allocations. */
+	uint64_t num_frees;      /** number of frees, arena allocations count as freed on reset. */
+} ar_heap_tag_stats;
+
 /**
  * \brief ar_heap_init
  *        initialize heap memory interface.
@@ -121,6 +145,10 @@ void* ar_heap_calloc(size_t bytes, par_heap_info heap_info);
  * \brief Frees heap memory.
  *
  * \param[in] heap_ptr: pointer to heap memory obtained from ar_heap_alloc().
+ * Allocations from the default pools are plain system blocks and may also
+ * be released with free(). Memory is accounted against the tag it was
+ * allocated with, and pointers not allocated by ar_heap_malloc() are
+ * rejected without changing the counters.
  *
  * \return
  *  0 -- Success
@@ -128,6 +156,59 @@ void* ar_heap_calloc(size_t bytes, par_heap_info heap_info);
  */
 void ar_heap_free(void* heap_ptr, par_heap_info heap_info);
 
+/**
+ * \brief Creates an arena for the given tag.
+ *
+ * Allocations made with pool_type AR_HEAP_POOL_ARENA and this tag are carved
+ * out of blocks owned by the arena. ar_heap_free() on them is a no-op, they
+ * are all released at once by ar_heap_arena_reset().
+ *
+ * \param[in] tag: tag of the allocations served by the arena.
+ * \param[in] block_bytes: size of each block the arena grows by, 0 for the default.
+ *
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_heap_arena_create(uint32_t tag, size_t block_bytes);
+
+/**
+ * \brief Releases every allocation made from the arena of the given tag.
+ *
+ * The first block is kept for reuse, the others are returned to the system.
+ *
+ * \param[in] tag: tag of the arena.
+ *
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_heap_arena_reset(uint32_t tag);
+
+/**
+ * \brief Resets and destroys the arena of the given tag.
+ *
+ * \param[in] tag: tag of the arena.
+ *
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_heap_arena_destroy(uint32_t tag);
+
+/**
+ * \brief Retrieves per tag allocation counters.
+ *
+ * \param[out] stats: array receiving the counters, may be NULL to query num_tags.
+ * \param[in] max_tags: number of entries in stats.
+ * \param[out] num_tags: number of tags seen so far.
+ *
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_heap_get_tag_stats(ar_heap_tag_stats *stats, uint32_t max_tags, uint32_t *num_tags);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
@@ -45,6 +45,43 @@ void ar_log(uint32_t level, const char_t* log_tag, const char_t* file,
  */
 void ar_set_log_level(uint32_t level);
 
+/* Override the log levels of one tag */
+/* Messages logged with log_tag are filtered with level instead of the global
+ * level, so one component can be made verbose without flooding the log with
+ * the others. Tags are matched by string, up to AR_LOG_TAG_MAX_LEN - 1
+ * characters. Returns AR_EOK, AR_EBADPARAM or AR_ENORESOURCE when
+ * AR_LOG_MAX_TAG_FILTERS tags already have an override.
+ */
+#define AR_LOG_MAX_TAG_FILTERS  (32)
+#define AR_LOG_TAG_MAX_LEN      (16)
+int32_t ar_log_set_tag_level(const char_t *log_tag, uint32_t level);
+
+/* Drop every per tag override set with ar_log_set_tag_level() */
+void ar_log_clear_tag_levels(void);
+
+/* Select the asynchronous logging backend */
+/* When enabled, ar_log() formats the message into a lock-free ring owned by
+ * the calling thread, so no pointer given by the caller is kept, and a
+ * background thread writes the messages oldest first. The text written is
+ * the same as in synchronous mode. A full ring drops the message and the
+ * drop is reported later, the caller is never blocked. Disabling it, and
+ * ar_log_deinit(), write whatever is still queued.
+ * Also enabled by ar_log_init() when vendor.audio.args.log.async is set.
+ */
+int32_t ar_log_set_async(bool_t enable);
+
+/* Wait until every message queued by the asynchronous backend is written */
+void ar_log_flush(void);
+
+/* Receives each formatted message in place of the platform log */
+typedef void (*ar_log_writer_t)(uint32_t level, const char_t *log_tag, const char_t *msg);
+
+/* Route messages to writer, or back to the platform log when NULL */
+/* Messages already queued are flushed to the previous writer first. The
+ * writer must not block; it runs on the asynchronous backend's thread when
+ * that is enabled. */
+void ar_log_set_writer(ar_log_writer_t writer);
+
 #define AR_LOG_VERBOSE(log_tag, ...)                                    \
     if (ar_log_lvl & AR_VERBOSE) {                                    \
         ar_log(AR_VERBOSE, log_tag, __FILE__, __FUNCTION__, __LINE__, __VA_ARGS__); \
@@ -70,6 +70,99 @@ int32_t ar_mem_set(void* dest, int32_t c, size_t size);
  */
 int32_t ar_mem_cmp(const void* buff1, const void* buff2, size_t size);
 
+/**
+ * \brief ar_mem_cpy_nt
+ *        copies bytes between buffers, bypassing the cache for the destination.
+ *        Meant for large buffers the caller will not read back, e.g. PCM handed
+ *        to shared memory. Copies below AR_MEM_CPY_NT_MIN_SIZE, and CPUs without
+ *        streaming stores, use ar_mem_cpy.
+ * \param[in_out] dest: destinatiopn buffer to copy data.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: source buffer pointer to copy data from.
+ * \param[in] size: bytes to copy from source buffer.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_mem_cpy_nt(void* dest, size_t dest_size, const void* src, size_t size);
+
+/** Smallest copy ar_mem_cpy_nt does with streaming stores */
+#define AR_MEM_CPY_NT_MIN_SIZE (4096)
+
+/**
+ * \brief ar_pcm_convert_16_to_32
+ *        copies 16 bit PCM samples to 32 bit samples, MSB aligned (Q31).
+ * \param[in_out] dest: destination buffer, at least num_samples * 4 bytes.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: 16 bit source samples.
+ * \param[in] num_samples: samples to convert, across all channels.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_pcm_convert_16_to_32(void* dest, size_t dest_size, const int16_t* src, size_t num_samples);
+
+/**
+ * \brief ar_pcm_convert_16_to_24_in_32
+ *        copies 16 bit PCM samples to 24 bit samples in 32 bit words,
+ *        LSB aligned and sign extended (Q23).
+ * \param[in_out] dest: destination buffer, at least num_samples * 4 bytes.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: 16 bit source samples.
+ * \param[in] num_samples: samples to convert, across all channels.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_pcm_convert_16_to_24_in_32(void* dest, size_t dest_size, const int16_t* src, size_t num_samples);
+
+/**
+ * \brief ar_pcm_convert_16_to_24_packed
+ *        copies 16 bit PCM samples to packed 3 byte little endian samples.
+ * \param[in_out] dest: destination buffer, at least num_samples * 3 bytes.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: 16 bit source samples.
+ * \param[in] num_samples: samples to convert, across all channels.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_pcm_convert_16_to_24_packed(void* dest, size_t dest_size, const int16_t* src, size_t num_samples);
+
+/**
+ * \brief ar_pcm_interleave
+ *        copies planar PCM, one block of size / num_channels bytes per channel,
+ *        to interleaved frames.
+ * \param[in_out] dest: destination buffer.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: planar source buffer.
+ * \param[in] size: source bytes, a multiple of num_channels * bytes_per_sample.
+ * \param[in] num_channels: number of channels.
+ * \param[in] bytes_per_sample: sample container size, 1 to 4 bytes.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_pcm_interleave(void* dest, size_t dest_size, const void* src, size_t size,
+    uint32_t num_channels, uint32_t bytes_per_sample);
+
+/**
+ * \brief ar_pcm_deinterleave
+ *        copies interleaved PCM frames to planar PCM, one block of
+ *        size / num_channels bytes per channel.
+ * \param[in_out] dest: destination buffer.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: interleaved source buffer.
+ * \param[in] size: source bytes, a multiple of num_channels * bytes_per_sample.
+ * \param[in] num_channels: number of channels.
+ * \param[in] bytes_per_sample: sample container size, 1 to 4 bytes.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_pcm_deinterleave(void* dest, size_t dest_size, const void* src, size_t size,
+    uint32_t num_channels, uint32_t bytes_per_sample);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
@@ -22,6 +22,8 @@ Recursive mutex are always used for thread-safe programming.
  - ar_osal_mutex_lock()
  - ar_osal_mutex_try_lock()
  - ar_osal_mutex_unlock()
+ - ar_osal_mutex_init_v2()
+ - ar_osal_mutex_create_v2()
 */
 
 #ifdef __cplusplus
@@ -44,6 +46,38 @@ INCLUDE FILES FOR MODULE
 */
 typedef void *ar_osal_mutex_t;
 
+/** Mutex creation flags, see ar_osal_mutex_attr_t. */
+/** The owner inherits the priority of the highest priority waiter. Use for
+    locks that real time threads may wait on while a normal thread holds them. */
+#define AR_OSAL_MUTEX_ATTR_PRIO_INHERIT   (0x1)
+/** Spin briefly while the owner is running before blocking. For locks held
+    over a few instructions only. */
+#define AR_OSAL_MUTEX_ATTR_ADAPTIVE       (0x2)
+/** Try the lock spin_count times before blocking. */
+#define AR_OSAL_MUTEX_ATTR_SPIN           (0x4)
+/** The owner may lock the mutex again. */
+#define AR_OSAL_MUTEX_ATTR_RECURSIVE      (0x8)
+
+/** Mutex creation attributes.
+*/
+typedef struct ar_osal_mutex_attr_t
+{
+   uint32_t flags;       /**< Bitmask of AR_OSAL_MUTEX_ATTR_* */
+   uint32_t spin_count;  /**< Attempts before blocking with AR_OSAL_MUTEX_ATTR_SPIN, 0 for the default */
+} ar_osal_mutex_attr_t;
+
+/** Storage for a mutex embedded in a structure or defined statically, no
+    heap allocation is made for it. Initialize it with AR_OSAL_MUTEX_STATIC_INIT
+    to use it with default attributes without any init call, or pass its
+    address to ar_osal_mutex_init_v2(). Its address is the mutex handle.
+*/
+typedef struct ar_osal_mutex_storage_t
+{
+   uint64_t opaque[10];
+} ar_osal_mutex_storage_t;
+
+#define AR_OSAL_MUTEX_STATIC_INIT { { 0 } }
+
 /****************************************************************************
 ** Mutex
 *****************************************************************************/
@@ -196,6 +230,51 @@ int32_t ar_osal_mutex_try_lock(ar_osal_mutex_t mutex);
  */
 int32_t ar_osal_mutex_unlock(ar_osal_mutex_t mutex);
 
+/**
+  Initializes a mutex with the given attributes in memory provided by the
+  client, of at least ar_osal_mutex_get_size() bytes, such as an
+  ar_osal_mutex_storage_t. Release it with ar_osal_mutex_deinit().
+
+  @datatypes
+  ar_osal_mutex_t
+  ar_osal_mutex_attr_t
+
+  @param[in] mutex: Pointer to the mutex memory.
+  @param[in] attr: Creation attributes, NULL for the defaults.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  None. @newpage
+*/
+int32_t ar_osal_mutex_init_v2(ar_osal_mutex_t mutex, const ar_osal_mutex_attr_t *attr);
+
+/**
+  Creates and initializes a mutex with the given attributes. Release it
+  with ar_osal_mutex_destroy().
+
+  Attributes the platform does not support are dropped with an error
+  message rather than failing the call: a mutex that cannot inherit
+  priority is still a mutex.
+
+  @datatypes
+  ar_osal_mutex_t
+  ar_osal_mutex_attr_t
+
+  @param[Out] mutex: Pointer to the mutex object handle.
+  @param[in] attr: Creation attributes, NULL for the defaults.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  None. @newpage
+*/
+int32_t ar_osal_mutex_create_v2(ar_osal_mutex_t *mutex, const ar_osal_mutex_attr_t *attr);
+
 
 #ifdef __cplusplus
 }
@@ -60,6 +60,26 @@ typedef enum ar_shmem_pd_type
 /**< Shift amount for hardware accelerator setup flag */
 #define AR_SHMEM_SHIFT_HW_ACCELERATOR_FLAG 0x0
 
+/**< Backing store of an allocation, for platforms offering a choice */
+#define AR_SHMEM_BACKEND_DEFAULT 0x0 /**< platform default */
+#define AR_SHMEM_BACKEND_HEAP    0x1 /**< process private heap memory */
+#define AR_SHMEM_BACKEND_MEMFD   0x2 /**< memfd, shareable with another process through its fd */
+
+/**< Bit mask for backend flag */
+#define AR_SHMEM_BIT_MASK_BACKEND_FLAG 0x3
+/**< Shift amount for backend flag */
+#define AR_SHMEM_SHIFT_BACKEND_FLAG 0x1
+
+/**< Page size of an allocation, for platforms offering a choice */
+#define AR_SHMEM_PAGE_DEFAULT    0x0 /**< base pages */
+#define AR_SHMEM_PAGE_HUGETLB    0x1 /**< reserved huge pages, base pages when none are available */
+#define AR_SHMEM_PAGE_THP        0x2 /**< transparent huge pages where the kernel allows them */
+
+/**< Bit mask for page size flag */
+#define AR_SHMEM_BIT_MASK_PAGE_FLAG 0x3
+/**< Shift amount for page size flag */
+#define AR_SHMEM_SHIFT_PAGE_FLAG 0x3
+
 typedef struct ar_shmem_proc_info_t {
 	uint8_t proc_id;
 	ar_shmem_pd_type_t proc_type;
@@ -102,6 +122,14 @@ typedef struct ar_shmem_info_t
                                                             - 0 -- hardware accelerator disabled, use AR_SHMEM_HW_ACCELERATOR_DISABLED
                                                             - To set this bit, use #AR_SHMEM_BIT_MASK_HW_ACCELERATOR_FLAG and
                                                               AR_SHMEM_SHIFT_HW_ACCELERATOR_FLAG
+                                                            @values{for bits 1-2}
+                                                            - AR_SHMEM_BACKEND_*, use #AR_SHMEM_BIT_MASK_BACKEND_FLAG and
+                                                              AR_SHMEM_SHIFT_BACKEND_FLAG. With AR_SHMEM_BACKEND_MEMFD the
+                                                              memfd descriptor is returned in pa_lsw/pa_msw.
+                                                            @values{for bits 3-4}
+                                                            - AR_SHMEM_PAGE_*, use #AR_SHMEM_BIT_MASK_PAGE_FLAG and
+                                                              AR_SHMEM_SHIFT_PAGE_FLAG
+                                                            Platforms without a choice ignore bits 1-4.
                                                             All other bits are reserved; must be set to 0. */
 } ar_shmem_info;
 
@@ -22,6 +22,8 @@ This section describes the following signal2 functions:
 - ar_osal_signal2_clear()
 - ar_osal_signal2_wait_any()
 - ar_osal_signal2_wait_all()
+- ar_osal_signal2_timedwait_any()
+- ar_osal_signal2_get_fd()
 */
 
 #ifdef __cplusplus
@@ -284,6 +286,61 @@ uint32_t ar_osal_signal2_get(ar_osal_signal2_t signal2);
 /* ======================================================================*/
 int32_t ar_osal_signal2_clear(ar_osal_signal2_t signal2, uint32_t signal2_mask);
 
+/*======================================================================*/
+/**@ingroup func_osal_signal2_timedwait_any
+  Suspends the current thread until any of the specified signals are set or
+  the timeout expires.
+
+  Same as ar_osal_signal2_wait_any() otherwise.
+
+  @datatypes
+  #ar_osal_signal2_t
+
+  @param[in] signal2:             Pointer to the signal object to wait on.
+  @param[in] signal2_mask:        Mask value identifying the individual signals
+                                       in the signal object to be waited on.
+  @param[in] timeout_in_nsec:     Time to wait in nano seconds, negative to wait
+                                       without a timeout.
+  @param[out] signals:            Optional, current signals when the wait ends.
+
+  @return
+  0 -- Success
+  AR_ETIMEOUT -- None of the signals were set within the timeout.
+  Nonzero -- Failure
+
+  @dependencies
+  None.
+*/
+/* ======================================================================*/
+int32_t ar_osal_signal2_timedwait_any(ar_osal_signal2_t signal2, uint32_t signal2_mask,
+                                      int64_t timeout_in_nsec, uint32_t *signals);
+
+/*======================================================================*/
+/**@ingroup func_osal_signal2_get_fd
+  Gets a file descriptor that is readable while any signal is set.
+
+  The descriptor is created on the first call and owned by the signal
+  object; it is closed by ar_osal_signal2_destroy(). It lets a thread
+  poll/epoll the signal object together with other file descriptors.
+  Reading it is not required, signals are still cleared with
+  ar_osal_signal2_clear().
+
+  @datatypes
+  #ar_osal_signal2_t
+
+  @param[in] signal2:   Pointer to the signal object.
+  @param[out] fd:       File descriptor of the signal object.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  None.
+*/
+/* ======================================================================*/
+int32_t ar_osal_signal2_get_fd(ar_osal_signal2_t signal2, int *fd);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
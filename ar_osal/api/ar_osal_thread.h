@@ -15,11 +15,19 @@ Threads must be joined to avoid memory leaks. The following thread functions
 are used to create and destroy threads, and to change thread priorities.
 - ar_osal_thread_create()
 - ar_osal_thread_attr_init()
+- ar_osal_thread_create_ext()
+- ar_osal_thread_attr_ext_init()
 - ar_osal_thread_join_destroy()
 - ar_osal_thread_get_priority()
 - ar_osal_thread_set_priority()
 - ar_osal_thread_self_get_priority()
 - ar_osal_thread_self_set_priority()
+- ar_osal_thread_set_sched()
+- ar_osal_thread_self_set_sched()
+- ar_osal_thread_set_affinity()
+- ar_osal_thread_self_set_affinity()
+- ar_osal_thread_set_name()
+- ar_osal_thread_self_set_name()
 */
 
 #ifdef __cplusplus
@@ -40,6 +48,16 @@ INCLUDE FILES FOR MODULE
 /** Handle to a thread. */
 typedef void * ar_osal_thread_t;
 
+/** Scheduling policies for ar_osal_thread_attr_ext_t::sched_policy. */
+#define AR_OSAL_THREAD_SCHED_INHERIT  0 /**< Inherit the policy of the creating thread */
+#define AR_OSAL_THREAD_SCHED_OTHER    1 /**< Time sharing, weighted by nice value */
+#define AR_OSAL_THREAD_SCHED_FIFO     2 /**< Real time, first in first out */
+#define AR_OSAL_THREAD_SCHED_RR       3 /**< Real time, round robin */
+
+/** Longest thread name kept, including the terminating NULL. Longer names
+    are truncated. */
+#define AR_OSAL_THREAD_NAME_MAX_LEN   16
+
 /** Thread attributes. */
 typedef struct ar_osal_thread_attr_t
 {
@@ -48,6 +66,20 @@ typedef struct ar_osal_thread_attr_t
     int32_t   priority;           /**< Thread priority */
 }ar_osal_thread_attr_t;
 
+/** Extended thread attributes, see ar_osal_thread_create_ext().
+
+    struct_size is set by ar_osal_thread_attr_ext_init() to the size the
+    caller was built with. Fields added in later versions are appended, and
+    fields beyond struct_size are treated as unset. */
+typedef struct ar_osal_thread_attr_ext_t
+{
+    uint32_t              struct_size;        /**< sizeof(ar_osal_thread_attr_ext_t) */
+    ar_osal_thread_attr_t attr;               /**< Name, stack size and priority */
+    int32_t               sched_policy;       /**< AR_OSAL_THREAD_SCHED_*, 0 inherits the creator's */
+    int32_t               nice;               /**< Nice value, used with AR_OSAL_THREAD_SCHED_OTHER */
+    uint64_t              cpu_affinity_mask;  /**< Bit n allows CPU n, 0 runs on any CPU */
+}ar_osal_thread_attr_ext_t;
+
 /****************************************************************************
 ** Threads
 *****************************************************************************/
@@ -111,6 +143,52 @@ int32_t ar_osal_thread_create( ar_osal_thread_t *thread,
                                  ar_osal_thread_start_routine thread_start,
                                  void *thread_param);
 
+/**
+  Initializes extended thread attributes: the base attributes as by
+  ar_osal_thread_attr_init(), the creator's scheduling policy and any CPU.
+
+  @param[out] attr_ext: Extended attributes to initialize.
+
+  @return
+  0 -- Success
+  Nonzero -- Failure
+
+  @dependencies
+  None.
+*/
+int32_t ar_osal_thread_attr_ext_init(ar_osal_thread_attr_ext_t *attr_ext);
+
+/**
+  Creates and launches a thread with a scheduling policy, nice value and
+  CPU affinity, see ar_osal_thread_create().
+
+  @param[out] thread:       Pointer to the thread.
+  @param[in]  attr_ext:     Extended attributes, initialized with
+                            ar_osal_thread_attr_ext_init() or with
+                            struct_size set to sizeof(ar_osal_thread_attr_ext_t).
+  @param[in]  thread_start: Pointer to the entry function of the thread.
+  @param[in]  thread_param: Pointer to the arguments passed to the entry
+                            function.
+
+  @detdesc
+  The name, affinity and nice value are applied by the new thread before
+  thread_start runs. A real time policy refused for lack of permission
+  falls back to the creator's policy.
+
+  @return
+  0 -- Success
+  AR_EBADPARAM -- struct_size does not cover the base attributes, or the
+                  policy is unknown.
+  Nonzero -- Failure.
+
+  @dependencies
+  None.
+*/
+int32_t ar_osal_thread_create_ext(ar_osal_thread_t *thread,
+                                  const ar_osal_thread_attr_ext_t *attr_ext,
+                                  ar_osal_thread_start_routine thread_start,
+                                  void *thread_param);
+
 /**
   Get current thread id.
 
@@ -202,6 +280,90 @@ int32_t ar_osal_thread_self_get_priority(int32_t *get_priority);
 */
 int32_t ar_osal_thread_self_set_priority(int32_t set_priority);
 
+/**
+  Changes the scheduling policy of a thread using a thread handle.
+
+  @param[in] thread:    Thread handle.
+  @param[in] policy:    AR_OSAL_THREAD_SCHED_OTHER, AR_OSAL_THREAD_SCHED_FIFO
+                        or AR_OSAL_THREAD_SCHED_RR.
+  @param[in] priority:  Real time priority, ignored for
+                        AR_OSAL_THREAD_SCHED_OTHER.
+  @param[in] nice:      Nice value, ignored for the real time policies.
+
+  @return
+  0 -- Success.
+  AR_EBADPARAM -- Invalid handle or policy.
+  AR_ENOTREADY -- The thread has not started running yet.
+  Nonzero -- Failure.
+
+  @dependencies
+  Before calling this function, the object must be created and initialized.
+  Real time policies need CAP_SYS_NICE or a suitable RLIMIT_RTPRIO.
+*/
+int32_t ar_osal_thread_set_sched(ar_osal_thread_t thread, int32_t policy,
+                                 int32_t priority, int32_t nice);
+
+/**
+  Changes the scheduling policy of the calling thread, see
+  ar_osal_thread_set_sched().
+
+  @return
+  0 -- Success.
+  Nonzero -- Failure.
+*/
+int32_t ar_osal_thread_self_set_sched(int32_t policy, int32_t priority, int32_t nice);
+
+/**
+  Restricts a thread to a set of CPUs using a thread handle.
+
+  @param[in] thread:    Thread handle.
+  @param[in] cpu_mask:  Bit n allows CPU n, 0 allows every CPU.
+
+  @return
+  0 -- Success.
+  AR_ENOTREADY -- The thread has not started running yet.
+  Nonzero -- Failure.
+
+  @dependencies
+  Before calling this function, the object must be created and initialized.
+*/
+int32_t ar_osal_thread_set_affinity(ar_osal_thread_t thread, uint64_t cpu_mask);
+
+/**
+  Restricts the calling thread to a set of CPUs, see
+  ar_osal_thread_set_affinity().
+
+  @return
+  0 -- Success.
+  Nonzero -- Failure.
+*/
+int32_t ar_osal_thread_self_set_affinity(uint64_t cpu_mask);
+
+/**
+  Renames a thread using a thread handle. Names longer than
+  AR_OSAL_THREAD_NAME_MAX_LEN - 1 characters are truncated.
+
+  @param[in] thread:  Thread handle.
+  @param[in] name:    New thread name.
+
+  @return
+  0 -- Success.
+  Nonzero -- Failure.
+
+  @dependencies
+  Before calling this function, the object must be created and initialized.
+*/
+int32_t ar_osal_thread_set_name(ar_osal_thread_t thread, const char_t *name);
+
+/**
+  Renames the calling thread, see ar_osal_thread_set_name().
+
+  @return
+  0 -- Success.
+  Nonzero -- Failure.
+*/
+int32_t ar_osal_thread_self_set_name(const char_t *name);
+
 /** @} */ /* end_addtogroup ar_osal_thread */
 
 #ifdef __cplusplus
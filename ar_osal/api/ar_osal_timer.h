@@ -33,6 +33,65 @@ uint64_t ar_timer_get_time_in_us(void);
  */
 uint64_t ar_timer_get_time_in_ms(void);
 
+/** Handle to a timer created with ar_osal_timer_create(). */
+typedef void *ar_osal_timer_t;
+
+/**
+ * Timer expiry callback. Callbacks of all timers run one at a time on the
+ * shared timer thread, so they must not block; hand longer work to a thread
+ * of the client.
+ */
+typedef void (*ar_osal_timer_cb_t)(void *cb_data);
+
+/**
+ * \brief ar_osal_timer_create
+ *        Creates a stopped timer. The first timer starts the timer service,
+ *        one thread waiting on a CLOCK_MONOTONIC timerfd that drives a
+ *        timer wheel with 1 ms resolution; destroying the last timer stops
+ *        it again.
+ * \param[out] timer: created timer
+ * \param[in] cb: called on expiry
+ * \param[in] cb_data: passed to cb
+ * \return
+ *        AR_EOK on success, error code otherwise.
+ */
+int32_t ar_osal_timer_create(ar_osal_timer_t *timer, ar_osal_timer_cb_t cb, void *cb_data);
+
+/**
+ * \brief ar_osal_timer_start
+ *        Arms a timer, replacing any pending expiry. Can be called from the
+ *        timer's own callback.
+ * \param[in] timer: timer to arm
+ * \param[in] delay_us: time to the first expiry
+ * \param[in] period_us: 0 for a one-shot timer, otherwise the interval of
+ *        the following expiries. Expiries missed while a callback ran late
+ *        are skipped rather than delivered back to back.
+ * \return
+ *        AR_EOK on success, error code otherwise.
+ */
+int32_t ar_osal_timer_start(ar_osal_timer_t timer, uint64_t delay_us, uint64_t period_us);
+
+/**
+ * \brief ar_osal_timer_cancel
+ *        Disarms a timer. When the callback is running on the timer thread
+ *        the call waits for it to return, unless it is made from that
+ *        callback, so the callback data can be released afterwards.
+ * \param[in] timer: timer to disarm
+ * \return
+ *        AR_EOK on success, error code otherwise.
+ */
+int32_t ar_osal_timer_cancel(ar_osal_timer_t timer);
+
+/**
+ * \brief ar_osal_timer_destroy
+ *        Cancels and frees a timer. Must not be called from the timer's own
+ *        callback.
+ * \param[in] timer: timer to free
+ * \return
+ *        AR_EOK on success, error code otherwise.
+ */
+int32_t ar_osal_timer_destroy(ar_osal_timer_t timer);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
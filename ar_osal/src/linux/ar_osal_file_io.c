@@ -15,6 +15,7 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <errno.h>
 #include "ar_osal_file_io.h"
@@ -165,6 +166,49 @@ done:
     return rc;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_fget_fd(_In_ ar_fhandle handle, _Out_ int32_t *fd)
+{
+    if (NULL == handle || NULL == fd) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s Invalid file handle\n",__func__);
+        return AR_EBADPARAM;
+    }
+
+    *fd = fileno((FILE *)handle);
+    if (*fd < 0) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s fileno failed %s\n", __func__, strerror(errno));
+        return AR_EFAILED;
+    }
+
+    return AR_EOK;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_fget_id(_In_ ar_fhandle handle, _Out_ ar_fid_t *id)
+{
+    struct stat file_info;
+    int fd = 0;
+
+    if (NULL == handle || NULL == id) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s Invalid file handle\n",__func__);
+        return AR_EBADPARAM;
+    }
+
+    fd = fileno((FILE *)handle);
+    if (fd < 0 || 0 != fstat(fd, &file_info)) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s fstat failed %s\n", __func__, strerror(errno));
+        return AR_EFAILED;
+    }
+
+    id->dev = (uint64_t)file_info.st_dev;
+    id->ino = (uint64_t)file_info.st_ino;
+    id->size = (uint64_t)file_info.st_size;
+    id->mtime_ns = (uint64_t)file_info.st_mtim.tv_sec * 1000000000ULL +
+        (uint64_t)file_info.st_mtim.tv_nsec;
+
+    return AR_EOK;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_fmap(ar_fhandle handle,
                 const void **fbuffer)
@@ -285,6 +329,46 @@ done:
     return rc;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_fsync(_In_ ar_fhandle handle)
+{
+    FILE *file_ptr = (FILE *)handle;
+
+    if (NULL == handle) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s Invalid file handle\n",__func__);
+        return AR_EBADPARAM;
+    }
+
+    if (0 != fflush(file_ptr) || 0 != fsync(fileno(file_ptr))) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s failed %s\n", __func__, strerror(errno));
+        return AR_EFAILED;
+    }
+
+    return AR_EOK;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_fsync_dir(_In_ const char_t *path)
+{
+    int32_t rc = AR_EOK;
+    int fd = -1;
+
+    if (NULL == path) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s Invalid path\n",__func__);
+        return AR_EBADPARAM;
+    }
+
+    fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0 || 0 != fsync(fd)) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s failed for %s %s\n", __func__, path, strerror(errno));
+        rc = AR_EFAILED;
+    }
+
+    if (fd >= 0)
+        close(fd);
+    return rc;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_fclose(_In_ ar_fhandle handle)
 {
@@ -324,3 +408,22 @@ int32_t ar_fdelete(_In_ const char_t *path)
 done:
     return rc;
 }
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_frename(_In_ const char_t *old_path, _In_ const char_t *new_path)
+{
+    int32_t rc = 0;
+
+    if (NULL == old_path || NULL == new_path) {
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s Invalid path\n",__func__);
+        rc = AR_EBADPARAM;
+        goto done;
+    }
+    rc = rename(old_path, new_path);
+    if (0 != rc) {
+        rc = AR_EFAILED;
+        AR_LOG_ERR(AR_OSAL_FILE_IO_LOG_TAG,"%s failed %d %s\n", __func__, rc, strerror(errno));
+    }
+done:
+    return rc;
+}
@@ -4,13 +4,591 @@
  * \brief
  *      Defines public APIs for heap memory allocation.
  *
+ *      The default pools hand out plain system blocks, which may also be
+ *      passed to free() or realloc(). Two pools are opt-in:
+ *       - AR_HEAP_POOL_SLAB requests up to 1 KiB come from per size class
+ *         slab chunks, so churn does not fragment the general purpose heap.
+ *         A chunk whose objects are all freed is returned to the system once
+ *         its class already keeps AR_HEAP_SLAB_MAX_EMPTY_CHUNKS empty chunks,
+ *       - AR_HEAP_POOL_ARENA requests are carved out of the arena of their
+ *         tag and released in bulk by ar_heap_arena_reset().
+ *
+ *      System blocks and slab chunks are registered by address in a table
+ *      split into independently locked stripes. ar_heap_free() uncharges a
+ *      system block from the tag it was allocated for and leaves pointers it
+ *      does not know alone. Slab objects carry a 16 byte header with their
+ *      tag and size, and chunks are aligned to their size so the chunk of an
+ *      object is found from its address.
+ *
  * \copyright
  *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
  *  SPDX-License-Identifier: BSD-3-Clause
  */
+#define AR_OSAL_HEAP_LOG_TAG    "COHP"
 #include "ar_osal_heap.h"
 #include "ar_osal_error.h"
+#include "ar_osal_log.h"
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define AR_HEAP_HDR_SIZE                  (16)
+#define AR_HEAP_MAGIC_ALLOC               (0x50485241) /* 'ARHP' */
+#define AR_HEAP_MAGIC_FREED               (0x45455246) /* 'FREE' */
+
+#define AR_HEAP_BACKEND_SYS               (0)
+#define AR_HEAP_BACKEND_SLAB              (1)
+#define AR_HEAP_BACKEND_ARENA             (2)
+
+/* Slab classes serve 32, 64, ... 1024 byte requests */
+#define AR_HEAP_SLAB_MIN_SHIFT            (5)
+#define AR_HEAP_SLAB_NUM_CLASSES          (6)
+#define AR_HEAP_SLAB_CHUNK_BYTES          (64 * 1024)
+/* Empty chunks kept per class before further empty ones are released */
+#define AR_HEAP_SLAB_MAX_EMPTY_CHUNKS     (1)
+
+#define AR_HEAP_MAX_ARENAS                (16)
+#define AR_HEAP_ARENA_BLOCK_BYTES_DEFAULT (64 * 1024)
+
+/* Address registry, stripe chosen by the top bits of the address hash */
+#define AR_HEAP_REG_STRIPE_BITS           (6)
+#define AR_HEAP_REG_NUM_STRIPES           (1 << AR_HEAP_REG_STRIPE_BITS)
+#define AR_HEAP_REG_MIN_CAPACITY          (64)
+#define AR_HEAP_REG_EMPTY                 ((uintptr_t)0)
+#define AR_HEAP_REG_DELETED               ((uintptr_t)1)
+
+#define AR_HEAP_ROUND_UP(x, a)            (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+
+typedef struct ar_heap_hdr {
+    uint32_t magic;
+    uint16_t tag_idx;
+    uint8_t  backend;
+    uint8_t  pool_idx;   /* slab class or arena index */
+    uint64_t bytes;
+} ar_heap_hdr_t;
+
+typedef char ar_heap_hdr_size_check[(sizeof(ar_heap_hdr_t) == AR_HEAP_HDR_SIZE) ? 1 : -1];
+
+/* Located at the start of each slab chunk, followed by its objects */
+typedef struct ar_heap_slab_chunk {
+    struct ar_heap_slab_chunk *next;      /* chunks of the class with room left */
+    struct ar_heap_slab_chunk *prev;
+    ar_heap_hdr_t             *free_list; /* linked through the first word after the header */
+    char                      *pos;       /* start of the never used tail */
+    char                      *end;
+    uint32_t                   num_live;
+    bool_t                     has_room;
+} ar_heap_slab_chunk_t;
+
+#define AR_HEAP_SLAB_CHUNK_HDR AR_HEAP_ROUND_UP(sizeof(ar_heap_slab_chunk_t), AR_HEAP_HDR_SIZE)
+
+typedef struct ar_heap_slab_class {
+    pthread_mutex_t       lock;
+    ar_heap_slab_chunk_t *chunks;     /* chunks with a free object or unused tail */
+    uint32_t              num_empty;  /* chunks with no live object */
+} ar_heap_slab_class_t;
+
+typedef struct ar_heap_arena_block {
+    struct ar_heap_arena_block *next;
+    size_t                      size;
+    size_t                      used;
+} ar_heap_arena_block_t;
+
+#define AR_HEAP_ARENA_BLOCK_HDR AR_HEAP_ROUND_UP(sizeof(ar_heap_arena_block_t), AR_HEAP_HDR_SIZE)
+
+typedef struct ar_heap_arena {
+    pthread_mutex_t        lock;       /* never destroyed, see ar_heap_arena_lock() */
+    uint32_t               tag;
+    bool_t                 in_use;     /* changed with both ar_heap_lock and lock held */
+    size_t                 block_bytes;
+    ar_heap_arena_block_t *blocks;     /* newest first, the last one is kept on reset */
+    uint64_t               num_allocs; /* since the last reset */
+    uint64_t               bytes;
+} ar_heap_arena_t;
+
+/* A system block or slab chunk known to the registry */
+typedef struct ar_heap_reg_entry {
+    uintptr_t addr;
+    uint64_t  bytes;
+    uint16_t  tag_idx;
+    uint8_t   backend;
+} ar_heap_reg_entry_t;
+
+/* Open addressed table with linear probing, deleted slots are reclaimed
+   when the table is rebuilt */
+typedef struct ar_heap_reg_stripe {
+    pthread_mutex_t      lock;
+    ar_heap_reg_entry_t *entries;
+    uint32_t             capacity;  /* power of two */
+    uint32_t             num_live;
+    uint32_t             num_used;  /* live and deleted slots */
+} ar_heap_reg_stripe_t;
+
+typedef struct ar_heap_tag_entry {
+    uint32_t         tag;
+    _Atomic uint64_t bytes_in_use;
+    _Atomic uint64_t peak_bytes;
+    _Atomic uint64_t num_allocs;
+    _Atomic uint64_t num_frees;
+} ar_heap_tag_entry_t;
+
+#define AR_HEAP_SLAB_CLASS_INIT { .lock = PTHREAD_MUTEX_INITIALIZER }
+
+static ar_heap_slab_class_t ar_heap_slabs[AR_HEAP_SLAB_NUM_CLASSES] = {
+    AR_HEAP_SLAB_CLASS_INIT, AR_HEAP_SLAB_CLASS_INIT, AR_HEAP_SLAB_CLASS_INIT,
+    AR_HEAP_SLAB_CLASS_INIT, AR_HEAP_SLAB_CLASS_INIT, AR_HEAP_SLAB_CLASS_INIT,
+};
+
+/* Guards tag registration and the arena table */
+static pthread_mutex_t ar_heap_lock = PTHREAD_MUTEX_INITIALIZER;
+static ar_heap_arena_t ar_heap_arenas[AR_HEAP_MAX_ARENAS];
+static ar_heap_reg_stripe_t ar_heap_reg[AR_HEAP_REG_NUM_STRIPES];
+static pthread_once_t ar_heap_lock_once = PTHREAD_ONCE_INIT;
+
+/* Entry 0 is the default tag, it also absorbs tags beyond AR_HEAP_MAX_TAGS */
+static ar_heap_tag_entry_t ar_heap_tags[AR_HEAP_MAX_TAGS] = { { .tag = AR_HEAP_TAG_DEFAULT } };
+static atomic_uint ar_heap_num_tags = 1;
+
+static void ar_heap_lock_init(void)
+{
+    for (uint32_t i = 0; i < AR_HEAP_MAX_ARENAS; i++)
+        pthread_mutex_init(&ar_heap_arenas[i].lock, NULL);
+    for (uint32_t i = 0; i < AR_HEAP_REG_NUM_STRIPES; i++)
+        pthread_mutex_init(&ar_heap_reg[i].lock, NULL);
+}
+
+static uint16_t ar_heap_tag_index(uint32_t tag)
+{
+    uint32_t num_tags = atomic_load_explicit(&ar_heap_num_tags, memory_order_acquire);
+    uint32_t i;
+
+    for (i = 0; i < num_tags; i++) {
+        if (ar_heap_tags[i].tag == tag)
+            return (uint16_t)i;
+    }
+
+    pthread_mutex_lock(&ar_heap_lock);
+    num_tags = atomic_load_explicit(&ar_heap_num_tags, memory_order_relaxed);
+    for (; i < num_tags; i++) {
+        if (ar_heap_tags[i].tag == tag)
+            break;
+    }
+    if (i == num_tags) {
+        if (num_tags < AR_HEAP_MAX_TAGS) {
+            ar_heap_tags[num_tags].tag = tag;
+            atomic_store_explicit(&ar_heap_num_tags, num_tags + 1, memory_order_release);
+        } else {
+            i = 0;
+        }
+    }
+    pthread_mutex_unlock(&ar_heap_lock);
+    return (uint16_t)i;
+}
+
+static void ar_heap_account_alloc(uint16_t tag_idx, uint64_t bytes)
+{
+    ar_heap_tag_entry_t *entry = &ar_heap_tags[tag_idx];
+    uint64_t in_use;
+    uint64_t peak;
+
+    atomic_fetch_add_explicit(&entry->num_allocs, 1, memory_order_relaxed);
+    in_use = atomic_fetch_add_explicit(&entry->bytes_in_use, bytes, memory_order_relaxed) + bytes;
+    peak = atomic_load_explicit(&entry->peak_bytes, memory_order_relaxed);
+    while (in_use > peak &&
+           !atomic_compare_exchange_weak_explicit(&entry->peak_bytes, &peak, in_use,
+                                                  memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+static void ar_heap_account_free(uint16_t tag_idx, uint64_t count, uint64_t bytes)
+{
+    ar_heap_tag_entry_t *entry = &ar_heap_tags[tag_idx];
+
+    atomic_fetch_add_explicit(&entry->num_frees, count, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&entry->bytes_in_use, bytes, memory_order_relaxed);
+}
+
+static uint64_t ar_heap_reg_hash(uintptr_t addr)
+{
+    return (uint64_t)(addr >> 4) * 0x9E3779B97F4A7C15ull;
+}
+
+static ar_heap_reg_stripe_t *ar_heap_reg_stripe(uint64_t hash)
+{
+    return &ar_heap_reg[hash >> (64 - AR_HEAP_REG_STRIPE_BITS)];
+}
+
+/* Slot of addr in the stripe, -1 if it is not registered */
+static int32_t ar_heap_reg_lookup(ar_heap_reg_stripe_t *stripe, uintptr_t addr, uint64_t hash)
+{
+    uint32_t mask = stripe->capacity - 1;
+    uint32_t i;
+
+    if (0 == stripe->capacity)
+        return -1;
+    for (i = (uint32_t)hash & mask; ; i = (i + 1) & mask) {
+        if (stripe->entries[i].addr == addr)
+            return (int32_t)i;
+        if (stripe->entries[i].addr == AR_HEAP_REG_EMPTY)
+            return -1;
+    }
+}
+
+/* Rebuilds the stripe with room for one more entry, dropping deleted slots */
+static int32_t ar_heap_reg_grow(ar_heap_reg_stripe_t *stripe)
+{
+    ar_heap_reg_entry_t *entries;
+    uint32_t capacity = AR_HEAP_REG_MIN_CAPACITY;
+    uint32_t mask;
+    uint32_t j;
+
+    while ((stripe->num_live + 1) * 2 > capacity)
+        capacity *= 2;
+    entries = calloc(capacity, sizeof(ar_heap_reg_entry_t));
+    if (NULL == entries)
+        return AR_ENOMEMORY;
+
+    mask = capacity - 1;
+    for (uint32_t i = 0; i < stripe->capacity; i++) {
+        if (stripe->entries[i].addr <= AR_HEAP_REG_DELETED)
+            continue;
+        for (j = (uint32_t)ar_heap_reg_hash(stripe->entries[i].addr) & mask;
+             entries[j].addr != AR_HEAP_REG_EMPTY; j = (j + 1) & mask)
+            ;
+        entries[j] = stripe->entries[i];
+    }
+    free(stripe->entries);
+    stripe->entries = entries;
+    stripe->capacity = capacity;
+    stripe->num_used = stripe->num_live;
+    return AR_EOK;
+}
+
+static int32_t ar_heap_reg_add(void *ptr, uint8_t backend, uint16_t tag_idx, uint64_t bytes)
+{
+    uintptr_t addr = (uintptr_t)ptr;
+    uint64_t hash = ar_heap_reg_hash(addr);
+    ar_heap_reg_stripe_t *stripe = ar_heap_reg_stripe(hash);
+    ar_heap_reg_entry_t *entry;
+    uint32_t mask;
+    uint32_t i;
+    int32_t idx;
+    int32_t rc = AR_EOK;
+
+    pthread_once(&ar_heap_lock_once, ar_heap_lock_init);
+    pthread_mutex_lock(&stripe->lock);
+    idx = ar_heap_reg_lookup(stripe, addr, hash);
+    if (idx >= 0) {
+        /* The previous block at this address went to free() directly */
+        entry = &stripe->entries[idx];
+        if (AR_HEAP_BACKEND_SYS == entry->backend)
+            ar_heap_account_free(entry->tag_idx, 1, entry->bytes);
+    } else {
+        if ((stripe->num_used + 1) * 4 > stripe->capacity * 3) {
+            rc = ar_heap_reg_grow(stripe);
+            if (AR_EOK != rc)
+                goto end;
+        }
+        mask = stripe->capacity - 1;
+        for (i = (uint32_t)hash & mask; stripe->entries[i].addr > AR_HEAP_REG_DELETED; i = (i + 1) & mask)
+            ;
+        if (stripe->entries[i].addr == AR_HEAP_REG_EMPTY)
+            stripe->num_used++;
+        stripe->num_live++;
+        entry = &stripe->entries[i];
+    }
+    entry->addr = addr;
+    entry->bytes = bytes;
+    entry->tag_idx = tag_idx;
+    entry->backend = backend;
+end:
+    pthread_mutex_unlock(&stripe->lock);
+    return rc;
+}
+
+/* Removes ptr if it is registered for backend, entry receives what was registered */
+static bool_t ar_heap_reg_remove(void *ptr, uint8_t backend, ar_heap_reg_entry_t *entry)
+{
+    uintptr_t addr = (uintptr_t)ptr;
+    uint64_t hash = ar_heap_reg_hash(addr);
+    ar_heap_reg_stripe_t *stripe = ar_heap_reg_stripe(hash);
+    bool_t found = FALSE;
+    int32_t idx;
+
+    pthread_once(&ar_heap_lock_once, ar_heap_lock_init);
+    pthread_mutex_lock(&stripe->lock);
+    idx = ar_heap_reg_lookup(stripe, addr, hash);
+    if (idx >= 0 && stripe->entries[idx].backend == backend) {
+        *entry = stripe->entries[idx];
+        stripe->entries[idx].addr = AR_HEAP_REG_DELETED;
+        stripe->num_live--;
+        found = TRUE;
+    }
+    pthread_mutex_unlock(&stripe->lock);
+    return found;
+}
+
+static bool_t ar_heap_reg_contains(void *ptr, uint8_t backend)
+{
+    uintptr_t addr = (uintptr_t)ptr;
+    uint64_t hash = ar_heap_reg_hash(addr);
+    ar_heap_reg_stripe_t *stripe = ar_heap_reg_stripe(hash);
+    bool_t found;
+    int32_t idx;
+
+    pthread_once(&ar_heap_lock_once, ar_heap_lock_init);
+    pthread_mutex_lock(&stripe->lock);
+    idx = ar_heap_reg_lookup(stripe, addr, hash);
+    found = idx >= 0 && stripe->entries[idx].backend == backend;
+    pthread_mutex_unlock(&stripe->lock);
+    return found;
+}
+
+/*
+ * Byte alignment requested by align_bytes, 0 for the malloc() default.
+ * Values beyond ar_heap_align_bytes are taken as a byte count when they
+ * are a power of two and otherwise fall back to pointer alignment.
+ */
+static size_t ar_heap_alignment(ar_heap_align_bytes align_bytes)
+{
+    size_t alignment = (size_t)align_bytes;
+
+    switch (align_bytes) {
+        case AR_HEAP_ALIGN_DEFAULT:
+            return 0;
+        case AR_HEAP_ALIGN_4_BYTES:
+            alignment = 4;
+            break;
+        case AR_HEAP_ALIGN_8_BYTES:
+            alignment = 8;
+            break;
+        case AR_HEAP_ALIGN_16_BYTES:
+            alignment = 16;
+            break;
+        default:
+            if (0 != (alignment & (alignment - 1)))
+                alignment = sizeof(void *);
+            break;
+    }
+    return (alignment < sizeof(void *)) ? sizeof(void *) : alignment;
+}
+
+static uint32_t ar_heap_slab_class(size_t bytes)
+{
+    uint32_t cls = 0;
+
+    while (cls < AR_HEAP_SLAB_NUM_CLASSES &&
+           bytes > ((size_t)1 << (AR_HEAP_SLAB_MIN_SHIFT + cls)))
+        cls++;
+    return cls;
+}
+
+static void ar_heap_slab_link(ar_heap_slab_class_t *slab, ar_heap_slab_chunk_t *chunk)
+{
+    chunk->prev = NULL;
+    chunk->next = slab->chunks;
+    if (NULL != slab->chunks)
+        slab->chunks->prev = chunk;
+    slab->chunks = chunk;
+    chunk->has_room = TRUE;
+}
+
+static void ar_heap_slab_unlink(ar_heap_slab_class_t *slab, ar_heap_slab_chunk_t *chunk)
+{
+    if (NULL != chunk->prev)
+        chunk->prev->next = chunk->next;
+    else
+        slab->chunks = chunk->next;
+    if (NULL != chunk->next)
+        chunk->next->prev = chunk->prev;
+    chunk->has_room = FALSE;
+}
+
+static ar_heap_slab_chunk_t *ar_heap_slab_chunk_new(ar_heap_slab_class_t *slab)
+{
+    ar_heap_slab_chunk_t *chunk = NULL;
+
+    if (posix_memalign((void **)&chunk, AR_HEAP_SLAB_CHUNK_BYTES, AR_HEAP_SLAB_CHUNK_BYTES) != 0)
+        return NULL;
+    if (AR_EOK != ar_heap_reg_add(chunk, AR_HEAP_BACKEND_SLAB, 0, 0)) {
+        free(chunk);
+        return NULL;
+    }
+    chunk->free_list = NULL;
+    chunk->pos = (char *)chunk + AR_HEAP_SLAB_CHUNK_HDR;
+    chunk->end = (char *)chunk + AR_HEAP_SLAB_CHUNK_BYTES;
+    chunk->num_live = 0;
+    ar_heap_slab_link(slab, chunk);
+    slab->num_empty++;
+    return chunk;
+}
+
+static ar_heap_hdr_t *ar_heap_slab_alloc(uint32_t cls)
+{
+    ar_heap_slab_class_t *slab = &ar_heap_slabs[cls];
+    size_t obj_bytes = AR_HEAP_HDR_SIZE + ((size_t)1 << (AR_HEAP_SLAB_MIN_SHIFT + cls));
+    ar_heap_slab_chunk_t *chunk;
+    ar_heap_hdr_t *hdr;
+
+    pthread_mutex_lock(&slab->lock);
+    chunk = slab->chunks;
+    if (NULL == chunk) {
+        chunk = ar_heap_slab_chunk_new(slab);
+        if (NULL == chunk) {
+            pthread_mutex_unlock(&slab->lock);
+            return NULL;
+        }
+    }
+
+    hdr = chunk->free_list;
+    if (NULL != hdr) {
+        chunk->free_list = *(ar_heap_hdr_t **)(hdr + 1);
+    } else {
+        hdr = (ar_heap_hdr_t *)chunk->pos;
+        chunk->pos += obj_bytes;
+    }
+    if (0 == chunk->num_live++)
+        slab->num_empty--;
+    if (NULL == chunk->free_list && chunk->pos + obj_bytes > chunk->end)
+        ar_heap_slab_unlink(slab, chunk);
+    pthread_mutex_unlock(&slab->lock);
+    return hdr;
+}
+
+/* Whether ptr is the start of an object of chunk */
+static bool_t ar_heap_slab_is_object(ar_heap_slab_chunk_t *chunk, void *ptr)
+{
+    ar_heap_hdr_t *hdr = (ar_heap_hdr_t *)ptr - 1;
+    size_t offset = (char *)hdr - ((char *)chunk + AR_HEAP_SLAB_CHUNK_HDR);
+
+    if ((char *)hdr < (char *)chunk + AR_HEAP_SLAB_CHUNK_HDR || hdr->pool_idx >= AR_HEAP_SLAB_NUM_CLASSES)
+        return FALSE;
+    return 0 == offset % (AR_HEAP_HDR_SIZE + ((size_t)1 << (AR_HEAP_SLAB_MIN_SHIFT + hdr->pool_idx)));
+}
+
+static void ar_heap_slab_free(ar_heap_slab_chunk_t *chunk, ar_heap_hdr_t *hdr)
+{
+    ar_heap_slab_class_t *slab = &ar_heap_slabs[hdr->pool_idx];
+    ar_heap_reg_entry_t entry;
+    bool_t release = FALSE;
+
+    pthread_mutex_lock(&slab->lock);
+    *(ar_heap_hdr_t **)(hdr + 1) = chunk->free_list;
+    chunk->free_list = hdr;
+    if (!chunk->has_room)
+        ar_heap_slab_link(slab, chunk);
+    if (0 == --chunk->num_live) {
+        if (slab->num_empty >= AR_HEAP_SLAB_MAX_EMPTY_CHUNKS) {
+            ar_heap_slab_unlink(slab, chunk);
+            release = TRUE;
+        } else {
+            slab->num_empty++;
+        }
+    }
+    pthread_mutex_unlock(&slab->lock);
+
+    if (release) {
+        (void)ar_heap_reg_remove(chunk, AR_HEAP_BACKEND_SLAB, &entry);
+        free(chunk);
+    }
+}
+
+static ar_heap_arena_t *ar_heap_arena_find(uint32_t tag)
+{
+    for (uint32_t i = 0; i < AR_HEAP_MAX_ARENAS; i++) {
+        if (ar_heap_arenas[i].in_use && ar_heap_arenas[i].tag == tag)
+            return &ar_heap_arenas[i];
+    }
+    return NULL;
+}
+
+/*
+ * Looks up and locks the arena of the given tag. Arena locks live as long as
+ * the process, so a destroy that slips in between the lookup and the lock is
+ * caught by checking the arena again once it is locked.
+ */
+static ar_heap_arena_t *ar_heap_arena_lock(uint32_t tag)
+{
+    ar_heap_arena_t *arena;
+
+    pthread_mutex_lock(&ar_heap_lock);
+    arena = ar_heap_arena_find(tag);
+    pthread_mutex_unlock(&ar_heap_lock);
+    if (NULL == arena)
+        return NULL;
+
+    pthread_mutex_lock(&arena->lock);
+    if (!arena->in_use || arena->tag != tag) {
+        pthread_mutex_unlock(&arena->lock);
+        return NULL;
+    }
+    return arena;
+}
+
+static ar_heap_hdr_t *ar_heap_arena_alloc(uint32_t tag, size_t bytes, size_t alignment, uint8_t *arena_idx)
+{
+    ar_heap_arena_t *arena;
+    ar_heap_arena_block_t *block;
+    size_t align = (alignment > AR_HEAP_HDR_SIZE) ? alignment : AR_HEAP_HDR_SIZE;
+    size_t rounded = AR_HEAP_ROUND_UP(bytes, AR_HEAP_HDR_SIZE);
+    /* Worst case padding in front of the header of an aligned object */
+    size_t need = AR_HEAP_HDR_SIZE + rounded + (align - AR_HEAP_HDR_SIZE);
+    size_t block_size;
+    uintptr_t base = 0;
+    uintptr_t data = 0;
+    ar_heap_hdr_t *hdr = NULL;
+
+    arena = ar_heap_arena_lock(tag);
+    if (NULL == arena)
+        return NULL;
+
+    block = arena->blocks;
+    if (NULL != block) {
+        base = (uintptr_t)block + AR_HEAP_ARENA_BLOCK_HDR;
+        data = AR_HEAP_ROUND_UP(base + block->used + AR_HEAP_HDR_SIZE, align);
+    }
+    if (NULL == block || data + rounded > base + block->size) {
+        block_size = (need > arena->block_bytes) ? need : arena->block_bytes;
+        if (posix_memalign((void **)&block, AR_HEAP_HDR_SIZE, AR_HEAP_ARENA_BLOCK_HDR + block_size) != 0)
+            goto end;
+        block->size = block_size;
+        block->used = 0;
+        block->next = arena->blocks;
+        arena->blocks = block;
+        base = (uintptr_t)block + AR_HEAP_ARENA_BLOCK_HDR;
+        data = AR_HEAP_ROUND_UP(base + AR_HEAP_HDR_SIZE, align);
+    }
+    hdr = (ar_heap_hdr_t *)data - 1;
+    block->used = data + rounded - base;
+    arena->num_allocs++;
+    arena->bytes += bytes;
+    *arena_idx = (uint8_t)(arena - ar_heap_arenas);
+end:
+    pthread_mutex_unlock(&arena->lock);
+    return hdr;
+}
+
+static void ar_heap_arena_release(ar_heap_arena_t *arena, bool_t keep_first)
+{
+    ar_heap_arena_block_t *block = arena->blocks;
+    ar_heap_arena_block_t *next;
+
+    while (NULL != block) {
+        next = block->next;
+        if (NULL == next && keep_first) {
+            block->used = 0;
+            break;
+        }
+        free(block);
+        block = next;
+    }
+    arena->blocks = block;
+
+    ar_heap_account_free(ar_heap_tag_index(arena->tag), arena->num_allocs, arena->bytes);
+    arena->num_allocs = 0;
+    arena->bytes = 0;
+}
 
 /**
  * \brief ar_heap_init
@@ -26,7 +604,9 @@ int32_t ar_heap_init(void) {
 
 /**
  * \brief ar_heap_deinit.
- *       De-initialize heap memory interface.
+ *       De-initialize heap memory interface. Slab chunks still holding
+ *       objects are left in place since other clients of the library may
+ *       still hold allocations.
  * \return
  *  0 -- Success
  *  Nonzero -- Failure
@@ -49,39 +629,59 @@ int32_t ar_heap_deinit(void) {
  */
 void* ar_heap_malloc(_In_ size_t bytes, _In_ par_heap_info heap_info)
 {
-    void* pBuff = NULL;
-    size_t alignment = AR_HEAP_ALIGN_DEFAULT;
-    if (NULL == heap_info) {
-        goto end;
+    ar_heap_hdr_t *hdr = NULL;
+    uint8_t backend = AR_HEAP_BACKEND_SYS;
+    uint8_t pool_idx = 0;
+    uint16_t tag_idx;
+    size_t alignment;
+    uint32_t cls;
+    void *mem = NULL;
+
+    if (NULL == heap_info || bytes > SIZE_MAX / 2) {
+        return NULL;
     }
-    switch (heap_info->align_bytes) {
-        case AR_HEAP_ALIGN_4_BYTES: /** 4-byte boundary */
-            alignment = 4;
-            break;
-        case AR_HEAP_ALIGN_8_BYTES: /** 8-byte boundary */
-            alignment = 8;
-            break;
-        case AR_HEAP_ALIGN_16_BYTES: /** 16-byte boundary */
-            alignment = 16;
-            break;
-        case AR_HEAP_ALIGN_DEFAULT: /** Default */
-            break;
+    alignment = ar_heap_alignment(heap_info->align_bytes);
+    tag_idx = ar_heap_tag_index(heap_info->tag);
+
+    if (AR_HEAP_POOL_ARENA == heap_info->pool_type) {
+        hdr = ar_heap_arena_alloc(heap_info->tag, bytes, alignment, &pool_idx);
+        backend = AR_HEAP_BACKEND_ARENA;
+    } else if (AR_HEAP_POOL_SLAB == heap_info->pool_type && alignment <= AR_HEAP_HDR_SIZE) {
+        cls = ar_heap_slab_class(bytes);
+        if (cls < AR_HEAP_SLAB_NUM_CLASSES) {
+            hdr = ar_heap_slab_alloc(cls);
+            backend = AR_HEAP_BACKEND_SLAB;
+            pool_idx = (uint8_t)cls;
+        }
     }
-    if (AR_HEAP_ALIGN_DEFAULT == heap_info->align_bytes) {
-        pBuff = malloc(bytes);
-    } else {
-        if (alignment < sizeof(void *)) {
-            alignment = sizeof(void *);
+
+    if (NULL == hdr) {
+        /* A plain system block */
+        if (0 == alignment) {
+            mem = malloc(bytes ? bytes : 1);
+        } else if (posix_memalign(&mem, alignment, bytes ? bytes : 1) != 0) {
+            mem = NULL;
         }
-        if (posix_memalign(&pBuff, alignment, bytes) != 0) {
-            pBuff = NULL;
+        if (NULL == mem) {
+            return NULL;
         }
+        if (AR_EOK != ar_heap_reg_add(mem, AR_HEAP_BACKEND_SYS, tag_idx, bytes)) {
+            free(mem);
+            return NULL;
+        }
+        ar_heap_account_alloc(tag_idx, bytes);
+        return mem;
     }
 
-end:
-    return pBuff;
-}
+    hdr->magic = AR_HEAP_MAGIC_ALLOC;
+    hdr->tag_idx = tag_idx;
+    hdr->backend = backend;
+    hdr->pool_idx = pool_idx;
+    hdr->bytes = bytes;
+    ar_heap_account_alloc(tag_idx, bytes);
 
+    return hdr + 1;
+}
 
 /**
  * \brief Allocates heap memory and initialize with 0.
@@ -116,9 +716,128 @@ void* ar_heap_calloc(_In_ size_t bytes, _In_ par_heap_info heap_info)
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void ar_heap_free(_In_ void* heap_ptr, _In_ par_heap_info heap_info)
 {
-    if (NULL != heap_ptr && NULL != heap_info) {
+    ar_heap_slab_chunk_t *chunk;
+    ar_heap_reg_entry_t entry;
+    ar_heap_hdr_t *hdr;
+
+    if (NULL == heap_ptr || NULL == heap_info) {
+        return;
+    }
+
+    if (ar_heap_reg_remove(heap_ptr, AR_HEAP_BACKEND_SYS, &entry)) {
+        ar_heap_account_free(entry.tag_idx, 1, entry.bytes);
         free(heap_ptr);
+        return;
+    }
+
+    chunk = (ar_heap_slab_chunk_t *)((uintptr_t)heap_ptr & ~((uintptr_t)AR_HEAP_SLAB_CHUNK_BYTES - 1));
+    if ((void *)chunk != heap_ptr && ar_heap_reg_contains(chunk, AR_HEAP_BACKEND_SLAB) &&
+        ar_heap_slab_is_object(chunk, heap_ptr)) {
+        hdr = (ar_heap_hdr_t *)heap_ptr - 1;
+        if (AR_HEAP_MAGIC_ALLOC != hdr->magic) {
+            AR_LOG_ERR(AR_OSAL_HEAP_LOG_TAG, "%s: double free of %p\n", __func__, heap_ptr);
+            return;
+        }
+        ar_heap_account_free(hdr->tag_idx, 1, hdr->bytes);
+        hdr->magic = AR_HEAP_MAGIC_FREED;
+        ar_heap_slab_free(chunk, hdr);
+        return;
+    }
+
+    /* Arena objects are released by ar_heap_arena_reset() */
+    if (AR_HEAP_POOL_ARENA != heap_info->pool_type) {
+        AR_LOG_ERR(AR_OSAL_HEAP_LOG_TAG, "%s: %p was not allocated by ar_heap_malloc\n", __func__, heap_ptr);
     }
-    return;
 }
 
+int32_t ar_heap_arena_create(uint32_t tag, size_t block_bytes)
+{
+    ar_heap_arena_t *arena = NULL;
+    int32_t rc = AR_EOK;
+
+    pthread_once(&ar_heap_lock_once, ar_heap_lock_init);
+
+    pthread_mutex_lock(&ar_heap_lock);
+    if (NULL != ar_heap_arena_find(tag)) {
+        rc = AR_EALREADY;
+        goto end;
+    }
+    for (uint32_t i = 0; i < AR_HEAP_MAX_ARENAS; i++) {
+        if (!ar_heap_arenas[i].in_use) {
+            arena = &ar_heap_arenas[i];
+            break;
+        }
+    }
+    if (NULL == arena) {
+        AR_LOG_ERR(AR_OSAL_HEAP_LOG_TAG, "%s: no free arena for tag 0x%x\n", __func__, tag);
+        rc = AR_ENORESOURCE;
+        goto end;
+    }
+    pthread_mutex_lock(&arena->lock);
+    arena->tag = tag;
+    arena->block_bytes = block_bytes ? block_bytes : AR_HEAP_ARENA_BLOCK_BYTES_DEFAULT;
+    arena->blocks = NULL;
+    arena->num_allocs = 0;
+    arena->bytes = 0;
+    arena->in_use = TRUE;
+    pthread_mutex_unlock(&arena->lock);
+end:
+    pthread_mutex_unlock(&ar_heap_lock);
+    return rc;
+}
+
+int32_t ar_heap_arena_reset(uint32_t tag)
+{
+    ar_heap_arena_t *arena = ar_heap_arena_lock(tag);
+
+    if (NULL == arena) {
+        return AR_EBADPARAM;
+    }
+    ar_heap_arena_release(arena, TRUE);
+    pthread_mutex_unlock(&arena->lock);
+    return AR_EOK;
+}
+
+int32_t ar_heap_arena_destroy(uint32_t tag)
+{
+    ar_heap_arena_t *arena;
+
+    /* Clearing in_use under the arena lock waits out allocations in
+       progress, and later ones no longer find the arena */
+    pthread_mutex_lock(&ar_heap_lock);
+    arena = ar_heap_arena_find(tag);
+    if (NULL == arena) {
+        pthread_mutex_unlock(&ar_heap_lock);
+        return AR_EBADPARAM;
+    }
+    pthread_mutex_lock(&arena->lock);
+    arena->in_use = FALSE;
+    pthread_mutex_unlock(&ar_heap_lock);
+
+    ar_heap_arena_release(arena, FALSE);
+    pthread_mutex_unlock(&arena->lock);
+    return AR_EOK;
+}
+
+int32_t ar_heap_get_tag_stats(ar_heap_tag_stats *stats, uint32_t max_tags, uint32_t *num_tags)
+{
+    uint32_t count = atomic_load_explicit(&ar_heap_num_tags, memory_order_acquire);
+
+    if (NULL == num_tags) {
+        return AR_EBADPARAM;
+    }
+    *num_tags = count;
+    if (NULL == stats) {
+        return AR_EOK;
+    }
+
+    for (uint32_t i = 0; i < count && i < max_tags; i++) {
+        stats[i].tag = ar_heap_tags[i].tag;
+        stats[i].reserved = 0;
+        stats[i].bytes_in_use = atomic_load_explicit(&ar_heap_tags[i].bytes_in_use, memory_order_relaxed);
+        stats[i].peak_bytes = atomic_load_explicit(&ar_heap_tags[i].peak_bytes, memory_order_relaxed);
+        stats[i].num_allocs = atomic_load_explicit(&ar_heap_tags[i].num_allocs, memory_order_relaxed);
+        stats[i].num_frees = atomic_load_explicit(&ar_heap_tags[i].num_frees, memory_order_relaxed);
+    }
+    return AR_EOK;
+}
@@ -9,8 +9,20 @@
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 #ifdef AR_OSAL_USE_CUTILS
 #include <cutils/properties.h>
 #endif
@@ -47,21 +59,468 @@ static inline void __android_log_write(int prio, const char *tag, const char *ms
 #endif
 
 #include "ar_osal_log.h"
+#include "ar_osal_error.h"
+#include "ar_osal_thread.h"
 #define LOG_BUF_SIZE 1024
 
+/* Asynchronous backend, see ar_log_set_async() */
+#define LOG_ASYNC_RING_SLOTS   64 /* per thread, power of two */
+
 uint32_t ar_log_lvl = (AR_CRITICAL|AR_ERROR|AR_INFO);
 
+/* Levels for tags without an override. ar_log_lvl is the union of this and
+ * every tag override, so the macros stay a single test. */
+static uint32_t ar_log_global_lvl = (AR_CRITICAL|AR_ERROR|AR_INFO);
+
+typedef struct log_tag_filter {
+    char_t   tag[AR_LOG_TAG_MAX_LEN];
+    uint32_t level;
+} log_tag_filter_t;
+
+/* Tag overrides are read lock free under a sequence count */
+static pthread_mutex_t   log_filter_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic uint32_t  log_filter_seq;
+static _Atomic uint32_t  log_num_filters;
+static log_tag_filter_t  log_filters[AR_LOG_MAX_TAG_FILTERS];
+
+static _Atomic(ar_log_writer_t) log_writer;
+
+/* A message formatted by its caller, waiting to be written */
+typedef struct log_rec {
+    uint64_t ts_ns;      /* orders the messages of different threads */
+    uint32_t level;
+    char_t   tag[AR_LOG_TAG_MAX_LEN];
+    char_t   text[LOG_BUF_SIZE];
+} log_rec_t;
+
+/* Single producer (the owning thread), single consumer (the log thread).
+ * The owning thread and the ring list each hold a reference; the thread
+ * drops its own when it exits and the writer drops the list's once the ring
+ * is empty, so whichever comes last frees the ring. */
+typedef struct log_ring {
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+    _Atomic uint32_t dropped;
+    _Atomic uint32_t refs;
+    _Atomic bool_t   dead;
+    pid_t            tid;
+    struct log_ring *next;
+    log_rec_t        recs[LOG_ASYNC_RING_SLOTS];
+} log_ring_t;
+
+static _Atomic bool_t     log_async_enabled;
+static pthread_mutex_t    log_async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t    log_rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static log_ring_t        *log_rings;
+static ar_osal_thread_t   log_async_thread;
+static _Atomic bool_t     log_async_stop;
+static pthread_key_t      log_ring_key;
+static pthread_once_t     log_ring_key_once = PTHREAD_ONCE_INIT;
+static __thread log_ring_t *log_thread_ring;
+static __thread bool_t     log_thread_exiting;
+static __thread bool_t     log_is_async_thread;
+
+/* The log thread sleeps on log_async_wake until a producer queues a message,
+ * and announces each drain pass on log_async_idle for ar_log_flush() */
+static pthread_mutex_t    log_async_wait_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t     log_async_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t     log_async_idle = PTHREAD_COND_INITIALIZER;
+static _Atomic bool_t     log_async_sleeping;
+static uint64_t           log_async_pass;
+
+static int log_level_to_prio(uint32_t level)
+{
+    switch (level) {
+    case AR_DEBUG:
+        return ANDROID_LOG_DEBUG;
+    case AR_INFO:
+        return ANDROID_LOG_INFO;
+    case AR_ERROR:
+        return ANDROID_LOG_ERROR;
+    case AR_VERBOSE:
+        return ANDROID_LOG_VERBOSE;
+    case AR_CRITICAL:
+        return ANDROID_LOG_FATAL;
+    default:
+        return -1;
+    }
+}
+
+static void log_write(uint32_t level, const char_t *log_tag, const char_t *buf)
+{
+    ar_log_writer_t writer = atomic_load_explicit(&log_writer, memory_order_acquire);
+    int prio;
+
+    if (NULL != writer) {
+        writer(level, log_tag, buf);
+        return;
+    }
+    prio = log_level_to_prio(level);
+    if (prio >= 0)
+        __android_log_write(prio, log_tag, buf);
+}
+
+/* Formats one message, the same way for the synchronous and asynchronous paths */
+static void log_format(char_t *buf, size_t size, const char_t *file, const char_t *fn,
+                       int32_t ln, const char_t *format, va_list ap)
+{
+    char buf_temp[LOG_BUF_SIZE];
+
+    snprintf(buf_temp, LOG_BUF_SIZE, "%s:%s:%d %s", file, fn, ln, format);
+    vsnprintf(buf, size, buf_temp, ap);
+}
+
+static void log_update_union_lvl(void)
+{
+    uint32_t lvl = ar_log_global_lvl;
+    uint32_t n = atomic_load(&log_num_filters);
+
+    for (uint32_t i = 0; i < n; i++)
+        lvl |= log_filters[i].level;
+    ar_log_lvl = lvl;
+}
+
+/* Returns the levels enabled for log_tag */
+static uint32_t log_tag_level(const char_t *log_tag)
+{
+    uint32_t seq, n, lvl;
+
+    do {
+        seq = atomic_load_explicit(&log_filter_seq, memory_order_acquire);
+        lvl = ar_log_global_lvl;
+        n = atomic_load_explicit(&log_num_filters, memory_order_relaxed);
+        for (uint32_t i = 0; i < n && NULL != log_tag; i++) {
+            if (0 == strncmp(log_filters[i].tag, log_tag, AR_LOG_TAG_MAX_LEN - 1)) {
+                lvl = log_filters[i].level;
+                break;
+            }
+        }
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1) || seq != atomic_load_explicit(&log_filter_seq, memory_order_relaxed));
+
+    return lvl;
+}
+
+static void log_ring_put(log_ring_t *ring)
+{
+    if (1 == atomic_fetch_sub_explicit(&ring->refs, 1, memory_order_acq_rel))
+        free(ring);
+}
+
+static void log_ring_thread_exit(void *ring)
+{
+    /* messages logged by later TLS destructors are written synchronously */
+    log_thread_exiting = TRUE;
+    log_thread_ring = NULL;
+    atomic_store_explicit(&((log_ring_t *)ring)->dead, TRUE, memory_order_release);
+    log_ring_put((log_ring_t *)ring);
+}
+
+static void log_ring_key_create(void)
+{
+    (void)pthread_key_create(&log_ring_key, log_ring_thread_exit);
+}
+
+static log_ring_t *log_get_thread_ring(void)
+{
+    log_ring_t *ring = log_thread_ring;
+
+    if (NULL != ring || log_thread_exiting)
+        return ring;
+
+    (void)pthread_once(&log_ring_key_once, log_ring_key_create);
+    ring = (log_ring_t *)calloc(1, sizeof(log_ring_t));
+    if (NULL == ring)
+        return NULL;
+    ring->tid = (pid_t)syscall(SYS_gettid);
+    atomic_init(&ring->refs, 2);
+    (void)pthread_setspecific(log_ring_key, ring);
+
+    pthread_mutex_lock(&log_rings_lock);
+    ring->next = log_rings;
+    log_rings = ring;
+    pthread_mutex_unlock(&log_rings_lock);
+
+    log_thread_ring = ring;
+    return ring;
+}
+
+static void log_async_wake_writer(void)
+{
+    /* pairs with the fence in log_async_thread_fn: either the writer sees
+       the new head, or this thread sees it sleeping */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&log_async_sleeping, memory_order_relaxed)) {
+        pthread_mutex_lock(&log_async_wait_lock);
+        pthread_cond_signal(&log_async_wake);
+        pthread_mutex_unlock(&log_async_wait_lock);
+    }
+}
+
+/* Returns FALSE when the message has to be written synchronously */
+static bool_t log_async_push(uint32_t level, const char_t *log_tag, const char_t *file,
+                             const char_t *fn, int32_t ln, const char_t *format, va_list ap)
+{
+    struct timespec ts;
+    log_ring_t *ring;
+    log_rec_t *rec;
+    uint32_t head;
+
+    ring = log_get_thread_ring();
+    if (NULL == ring)
+        return FALSE;
+
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= LOG_ASYNC_RING_SLOTS) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return TRUE;
+    }
+
+    /* formatted here, so nothing refers to the caller's strings afterwards */
+    rec = &ring->recs[head & (LOG_ASYNC_RING_SLOTS - 1)];
+    log_format(rec->text, sizeof(rec->text), file, fn, ln, format, ap);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    rec->ts_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    rec->level = level;
+    strncpy(rec->tag, log_tag ? log_tag : "", AR_LOG_TAG_MAX_LEN - 1);
+    rec->tag[AR_LOG_TAG_MAX_LEN - 1] = '\0';
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    log_async_wake_writer();
+    return TRUE;
+}
+
+static bool_t log_async_pending(void)
+{
+    bool_t pending = FALSE;
+    log_ring_t *ring;
+
+    pthread_mutex_lock(&log_rings_lock);
+    for (ring = log_rings; NULL != ring && !pending; ring = ring->next)
+        pending = atomic_load(&ring->tail) != atomic_load(&ring->head);
+    pthread_mutex_unlock(&log_rings_lock);
+    return pending;
+}
+
+/* Writes queued messages oldest first across all threads. Returns the
+ * number of messages written. Only one thread drains at a time. */
+static uint32_t log_async_drain(void)
+{
+    char_t buf[LOG_BUF_SIZE];
+    log_ring_t *ring, *oldest, **link;
+    uint32_t count = 0, dropped;
+
+    pthread_mutex_lock(&log_rings_lock);
+    for (;;) {
+        oldest = NULL;
+        for (ring = log_rings; NULL != ring; ring = ring->next) {
+            uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+            if (tail == atomic_load_explicit(&ring->head, memory_order_acquire))
+                continue;
+            if (NULL == oldest ||
+                ring->recs[tail & (LOG_ASYNC_RING_SLOTS - 1)].ts_ns <
+                oldest->recs[atomic_load_explicit(&oldest->tail, memory_order_relaxed) &
+                             (LOG_ASYNC_RING_SLOTS - 1)].ts_ns)
+                oldest = ring;
+        }
+        if (NULL == oldest)
+            break;
+
+        uint32_t tail = atomic_load_explicit(&oldest->tail, memory_order_relaxed);
+        const log_rec_t *rec = &oldest->recs[tail & (LOG_ASYNC_RING_SLOTS - 1)];
+        log_write(rec->level, rec->tag, rec->text);
+        atomic_store_explicit(&oldest->tail, tail + 1, memory_order_release);
+        count++;
+    }
+
+    /* report drops, and let go of the rings of exited threads once empty */
+    link = &log_rings;
+    while (NULL != (ring = *link)) {
+        dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+        if (dropped) {
+            snprintf(buf, sizeof(buf), "%u messages dropped by tid %d, log ring full",
+                     dropped, (int)ring->tid);
+            log_write(AR_ERROR, "COLG", buf);
+        }
+        if (atomic_load_explicit(&ring->dead, memory_order_acquire) &&
+            atomic_load(&ring->tail) == atomic_load(&ring->head)) {
+            *link = ring->next;
+            log_ring_put(ring);
+            continue;
+        }
+        link = &ring->next;
+    }
+    pthread_mutex_unlock(&log_rings_lock);
+    return count;
+}
+
+/* Counts a completed drain pass and wakes ar_log_flush() callers */
+static void log_async_pass_done(void)
+{
+    log_async_pass++;
+    pthread_cond_broadcast(&log_async_idle);
+}
+
+static void log_async_thread_fn(void *arg)
+{
+    (void)arg;
+    log_is_async_thread = TRUE;
+    while (!atomic_load(&log_async_stop)) {
+        (void)log_async_drain();
+
+        pthread_mutex_lock(&log_async_wait_lock);
+        log_async_pass_done();
+        atomic_store_explicit(&log_async_sleeping, TRUE, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!atomic_load(&log_async_stop) && !log_async_pending())
+            pthread_cond_wait(&log_async_wake, &log_async_wait_lock);
+        atomic_store_explicit(&log_async_sleeping, FALSE, memory_order_relaxed);
+        pthread_mutex_unlock(&log_async_wait_lock);
+    }
+    (void)log_async_drain();
+
+    pthread_mutex_lock(&log_async_wait_lock);
+    log_async_pass_done();
+    pthread_mutex_unlock(&log_async_wait_lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_log_set_async(bool_t enable)
+{
+    ar_osal_thread_attr_t attr;
+    int32_t rc = AR_EOK;
+
+    pthread_mutex_lock(&log_async_lock);
+    if (enable && NULL == log_async_thread) {
+        atomic_store(&log_async_stop, FALSE);
+        rc = ar_osal_thread_attr_init(&attr);
+        if (AR_EOK != rc)
+            goto done;
+        attr.thread_name = "ar_log";
+        rc = ar_osal_thread_create(&log_async_thread, &attr, log_async_thread_fn, NULL);
+        if (AR_EOK != rc) {
+            log_async_thread = NULL;
+            goto done;
+        }
+        atomic_store(&log_async_enabled, TRUE);
+    } else if (!enable && NULL != log_async_thread) {
+        atomic_store(&log_async_enabled, FALSE);
+        pthread_mutex_lock(&log_async_wait_lock);
+        atomic_store(&log_async_stop, TRUE);
+        pthread_cond_signal(&log_async_wake);
+        pthread_mutex_unlock(&log_async_wait_lock);
+        (void)ar_osal_thread_join_destroy(log_async_thread);
+        log_async_thread = NULL;
+        /* anything queued while the thread was exiting */
+        (void)log_async_drain();
+    }
+done:
+    pthread_mutex_unlock(&log_async_lock);
+    return rc;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void ar_log_flush(void)
+{
+    uint64_t pass;
+
+    if (log_is_async_thread)
+        return;
+
+    while (log_async_pending()) {
+        if (!atomic_load(&log_async_enabled)) {
+            (void)log_async_drain();
+            continue;
+        }
+        /* wait for the log thread to finish a pass, then check again */
+        pthread_mutex_lock(&log_async_wait_lock);
+        pass = log_async_pass;
+        pthread_cond_signal(&log_async_wake);
+        while (pass == log_async_pass && atomic_load(&log_async_enabled))
+            pthread_cond_wait(&log_async_idle, &log_async_wait_lock);
+        pthread_mutex_unlock(&log_async_wait_lock);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void ar_log_set_writer(ar_log_writer_t writer)
+{
+    ar_log_flush();
+    atomic_store_explicit(&log_writer, writer, memory_order_release);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void ar_set_log_level(uint32_t level)
+{
+    pthread_mutex_lock(&log_filter_lock);
+    ar_log_global_lvl = level;
+    log_update_union_lvl();
+    pthread_mutex_unlock(&log_filter_lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_log_set_tag_level(const char_t *log_tag, uint32_t level)
+{
+    uint32_t i, n;
+    int32_t rc = AR_EOK;
+
+    if (NULL == log_tag || '\0' == log_tag[0])
+        return AR_EBADPARAM;
+
+    pthread_mutex_lock(&log_filter_lock);
+    atomic_fetch_add_explicit(&log_filter_seq, 1, memory_order_acq_rel);
+    n = atomic_load(&log_num_filters);
+    for (i = 0; i < n; i++) {
+        if (0 == strncmp(log_filters[i].tag, log_tag, AR_LOG_TAG_MAX_LEN - 1))
+            break;
+    }
+    if (i == n) {
+        if (n == AR_LOG_MAX_TAG_FILTERS) {
+            rc = AR_ENORESOURCE;
+        } else {
+            strncpy(log_filters[i].tag, log_tag, AR_LOG_TAG_MAX_LEN - 1);
+            log_filters[i].tag[AR_LOG_TAG_MAX_LEN - 1] = '\0';
+            atomic_store(&log_num_filters, n + 1);
+        }
+    }
+    if (AR_EOK == rc)
+        log_filters[i].level = level;
+    atomic_fetch_add_explicit(&log_filter_seq, 1, memory_order_release);
+    log_update_union_lvl();
+    pthread_mutex_unlock(&log_filter_lock);
+    return rc;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void ar_log_clear_tag_levels(void)
+{
+    pthread_mutex_lock(&log_filter_lock);
+    atomic_fetch_add_explicit(&log_filter_seq, 1, memory_order_acq_rel);
+    atomic_store(&log_num_filters, 0);
+    atomic_fetch_add_explicit(&log_filter_seq, 1, memory_order_release);
+    log_update_union_lvl();
+    pthread_mutex_unlock(&log_filter_lock);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void ar_log_init(void)
 {
 #ifdef AR_OSAL_USE_CUTILS
+    uint32_t lvl = ar_log_global_lvl;
+
     //set this property to change the args debug logging enabled.
     if(property_get_bool("vendor.audio.args.enable.debug.logs", 0)) {
-        ar_log_lvl = (AR_CRITICAL|AR_ERROR|AR_INFO|AR_DEBUG);
+        lvl = (AR_CRITICAL|AR_ERROR|AR_INFO|AR_DEBUG);
     }
     //set this property to change the args verbose logging enabled.
     if(property_get_bool("vendor.audio.args.enable.verbose.logs", 0)) {
-        ar_log_lvl = (AR_CRITICAL|AR_ERROR|AR_INFO|AR_DEBUG|AR_VERBOSE);
+        lvl = (AR_CRITICAL|AR_ERROR|AR_INFO|AR_DEBUG|AR_VERBOSE);
+    }
+    ar_set_log_level(lvl);
+    //set this property to format and write logs on a background thread.
+    if(property_get_bool("vendor.audio.args.log.async", 0)) {
+        (void)ar_log_set_async(TRUE);
     }
 #endif
 }
@@ -71,31 +530,32 @@ void ar_log(uint32_t level, const char_t* log_tag, const char_t* file,
         const char_t* fn, int32_t ln, const char_t* format, ...)
 {
     va_list ap;
-    char buf_temp[LOG_BUF_SIZE];
     char buf[LOG_BUF_SIZE];
 
+    /* per tag overrides; without any the macro already checked ar_log_lvl */
+    if (atomic_load_explicit(&log_num_filters, memory_order_relaxed) &&
+        !(log_tag_level(log_tag) & level))
+        return;
+
+    if (atomic_load_explicit(&log_async_enabled, memory_order_relaxed) && !log_is_async_thread) {
+        bool_t queued;
+
+        va_start(ap, format);
+        queued = log_async_push(level, log_tag, file, fn, ln, format, ap);
+        va_end(ap);
+        if (queued)
+            return;
+    }
+
     va_start(ap, format);
-    snprintf(buf_temp, LOG_BUF_SIZE, "%s:%s:%d %s", file, fn, ln, format);
-    vsnprintf(buf, LOG_BUF_SIZE, buf_temp, ap);
+    log_format(buf, LOG_BUF_SIZE, file, fn, ln, format, ap);
     va_end(ap);
 
-    if (level == AR_DEBUG) {
-        __android_log_write(ANDROID_LOG_DEBUG, log_tag, buf);
-    } else if (level == AR_INFO){
-        __android_log_write(ANDROID_LOG_INFO, log_tag, buf);
-    } else if (level == AR_ERROR) {
-        __android_log_write(ANDROID_LOG_ERROR, log_tag, buf);
-    }
-    else if (level == AR_VERBOSE) {
-        __android_log_write(ANDROID_LOG_VERBOSE, log_tag, buf);
-    }
-    else if (level == AR_CRITICAL) {
-        __android_log_write(ANDROID_LOG_FATAL, log_tag, buf);
-    }
+    log_write(level, log_tag, buf);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void ar_log_deinit(void)
 {
-
+    (void)ar_log_set_async(FALSE);
 }
@@ -9,9 +9,27 @@
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdatomic.h>
 #include "ar_osal_mem_op.h"
 #include "ar_osal_error.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MEM_OP_NT_X86
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define MEM_OP_NT_ARM64
+#endif
+
+/* streaming store support, resolved on the first ar_mem_cpy_nt */
+#define MEM_OP_NT_ISA_UNKNOWN  (-1)
+#define MEM_OP_NT_ISA_NONE     (0)
+#define MEM_OP_NT_ISA_SSE2     (1)
+#define MEM_OP_NT_ISA_AVX      (2)
+#define MEM_OP_NT_ISA_ARM64    (3)
+
+static _Atomic int32_t mem_op_nt_isa = MEM_OP_NT_ISA_UNKNOWN;
+
 /**
  * \brief ar_mem_cpy
  *        copies bytes between buffers.
@@ -106,3 +124,370 @@ int32_t ar_mem_cmp(_In_ const void* buff1, _In_ const void* buff2, _In_ size_t s
     return memcmp(buff1, buff2, size);
 }
 
+
+#if defined(MEM_OP_NT_X86)
+__attribute__((target("sse2")))
+static void mem_op_cpy_nt_sse2(uint8_t *dest, const uint8_t *src, size_t size)
+{
+    size_t head = (16 - ((uintptr_t)dest & 15)) & 15;
+
+    memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    size -= head;
+    for (; size >= 64; size -= 64, dest += 64, src += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i *)src);
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(src + 48));
+        _mm_stream_si128((__m128i *)dest, a);
+        _mm_stream_si128((__m128i *)(dest + 16), b);
+        _mm_stream_si128((__m128i *)(dest + 32), c);
+        _mm_stream_si128((__m128i *)(dest + 48), d);
+    }
+    /* streaming stores are weakly ordered, drain them before returning */
+    _mm_sfence();
+    memcpy(dest, src, size);
+}
+
+__attribute__((target("avx")))
+static void mem_op_cpy_nt_avx(uint8_t *dest, const uint8_t *src, size_t size)
+{
+    size_t head = (32 - ((uintptr_t)dest & 31)) & 31;
+
+    memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    size -= head;
+    for (; size >= 128; size -= 128, dest += 128, src += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)src);
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(src + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(src + 96));
+        _mm256_stream_si256((__m256i *)dest, a);
+        _mm256_stream_si256((__m256i *)(dest + 32), b);
+        _mm256_stream_si256((__m256i *)(dest + 64), c);
+        _mm256_stream_si256((__m256i *)(dest + 96), d);
+    }
+    _mm_sfence();
+    memcpy(dest, src, size);
+}
+#elif defined(MEM_OP_NT_ARM64)
+static void mem_op_cpy_nt_arm64(uint8_t *dest, const uint8_t *src, size_t size)
+{
+    size_t head = (16 - ((uintptr_t)dest & 15)) & 15;
+
+    memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    size -= head;
+    for (; size >= 64; size -= 64, dest += 64, src += 64) {
+        __asm__ __volatile__(
+            "ldp q0, q1, [%1]\n\t"
+            "ldp q2, q3, [%1, #32]\n\t"
+            "stnp q0, q1, [%0]\n\t"
+            "stnp q2, q3, [%0, #32]\n\t"
+            : : "r" (dest), "r" (src) : "v0", "v1", "v2", "v3", "memory");
+    }
+    /* order the non-temporal stores before whatever publishes the buffer */
+    __asm__ __volatile__("dmb ishst" : : : "memory");
+    memcpy(dest, src, size);
+}
+#endif
+
+static int32_t mem_op_nt_isa_get(void)
+{
+    int32_t isa = atomic_load_explicit(&mem_op_nt_isa, memory_order_relaxed);
+
+    if (MEM_OP_NT_ISA_UNKNOWN != isa)
+        return isa;
+
+    isa = MEM_OP_NT_ISA_NONE;
+#if defined(MEM_OP_NT_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx"))
+        isa = MEM_OP_NT_ISA_AVX;
+    else if (__builtin_cpu_supports("sse2"))
+        isa = MEM_OP_NT_ISA_SSE2;
+#elif defined(MEM_OP_NT_ARM64)
+    isa = MEM_OP_NT_ISA_ARM64;
+#endif
+    /* racing callers resolve the same value */
+    atomic_store_explicit(&mem_op_nt_isa, isa, memory_order_relaxed);
+    return isa;
+}
+
+/**
+ * \brief ar_mem_cpy_nt
+ *        copies bytes between buffers, bypassing the cache for the destination.
+ * \param[in_out] dest: destinatiopn buffer to copy data.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: source buffer pointer to copy data from.
+ * \param[in] size: bytes to copy from source buffer.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+_IRQL_requires_max_(DISPATCH_LEVEL)
+int32_t ar_mem_cpy_nt(_Inout_ void* dest, _In_ size_t dest_size, _In_ const void* src, _In_ size_t size)
+{
+    if (NULL == dest || NULL == src || 0 == dest_size || 0 == size ||
+        dest_size < size) {
+        return AR_EBADPARAM;
+    }
+    if (size < AR_MEM_CPY_NT_MIN_SIZE) {
+        memcpy(dest, src, size);
+        return AR_EOK;
+    }
+
+    switch (mem_op_nt_isa_get()) {
+#if defined(MEM_OP_NT_X86)
+    case MEM_OP_NT_ISA_AVX:
+        mem_op_cpy_nt_avx(dest, src, size);
+        break;
+    case MEM_OP_NT_ISA_SSE2:
+        mem_op_cpy_nt_sse2(dest, src, size);
+        break;
+#elif defined(MEM_OP_NT_ARM64)
+    case MEM_OP_NT_ISA_ARM64:
+        mem_op_cpy_nt_arm64(dest, src, size);
+        break;
+#endif
+    default:
+        memcpy(dest, src, size);
+        break;
+    }
+    return AR_EOK;
+}
+
+static int32_t mem_op_pcm_check(void* dest, size_t dest_size, const void* src,
+    size_t num_samples, size_t dest_sample_size)
+{
+    if (NULL == dest || NULL == src || 0 == num_samples ||
+        num_samples > SIZE_MAX / dest_sample_size ||
+        dest_size < num_samples * dest_sample_size) {
+        return AR_EBADPARAM;
+    }
+    return AR_EOK;
+}
+
+/**
+ * \brief ar_pcm_convert_16_to_32
+ *        copies 16 bit PCM samples to 32 bit samples, MSB aligned (Q31).
+ * \param[in_out] dest: destination buffer, at least num_samples * 4 bytes.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: 16 bit source samples.
+ * \param[in] num_samples: samples to convert, across all channels.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+_IRQL_requires_max_(DISPATCH_LEVEL)
+int32_t ar_pcm_convert_16_to_32(_Inout_ void* dest, _In_ size_t dest_size, _In_ const int16_t* src, _In_ size_t num_samples)
+{
+    int32_t *out = dest;
+    size_t i = 0;
+
+    if (AR_EOK != mem_op_pcm_check(dest, dest_size, src, num_samples, sizeof(int32_t))) {
+        return AR_EBADPARAM;
+    }
+#if defined(__SSE2__)
+    for (; i + 8 <= num_samples; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_unpacklo_epi16(_mm_setzero_si128(), x));
+        _mm_storeu_si128((__m128i *)(out + i + 4), _mm_unpackhi_epi16(_mm_setzero_si128(), x));
+    }
+#elif defined(MEM_OP_NT_ARM64)
+    for (; i + 8 <= num_samples; i += 8) {
+        int16x8_t x = vld1q_s16(src + i);
+        vst1q_s32(out + i, vshll_n_s16(vget_low_s16(x), 16));
+        vst1q_s32(out + i + 4, vshll_n_s16(vget_high_s16(x), 16));
+    }
+#endif
+    for (; i < num_samples; i++) {
+        out[i] = (int32_t)((uint32_t)(uint16_t)src[i] << 16);
+    }
+    return AR_EOK;
+}
+
+/**
+ * \brief ar_pcm_convert_16_to_24_in_32
+ *        copies 16 bit PCM samples to 24 bit samples in 32 bit words,
+ *        LSB aligned and sign extended (Q23).
+ * \param[in_out] dest: destination buffer, at least num_samples * 4 bytes.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: 16 bit source samples.
+ * \param[in] num_samples: samples to convert, across all channels.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+_IRQL_requires_max_(DISPATCH_LEVEL)
+int32_t ar_pcm_convert_16_to_24_in_32(_Inout_ void* dest, _In_ size_t dest_size, _In_ const int16_t* src, _In_ size_t num_samples)
+{
+    int32_t *out = dest;
+    size_t i = 0;
+
+    if (AR_EOK != mem_op_pcm_check(dest, dest_size, src, num_samples, sizeof(int32_t))) {
+        return AR_EBADPARAM;
+    }
+#if defined(__SSE2__)
+    for (; i + 8 <= num_samples; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), x), 8);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), x), 8);
+        _mm_storeu_si128((__m128i *)(out + i), lo);
+        _mm_storeu_si128((__m128i *)(out + i + 4), hi);
+    }
+#elif defined(MEM_OP_NT_ARM64)
+    for (; i + 8 <= num_samples; i += 8) {
+        int16x8_t x = vld1q_s16(src + i);
+        vst1q_s32(out + i, vshlq_n_s32(vmovl_s16(vget_low_s16(x)), 8));
+        vst1q_s32(out + i + 4, vshlq_n_s32(vmovl_s16(vget_high_s16(x)), 8));
+    }
+#endif
+    for (; i < num_samples; i++) {
+        out[i] = (int32_t)src[i] * 256;
+    }
+    return AR_EOK;
+}
+
+/**
+ * \brief ar_pcm_convert_16_to_24_packed
+ *        copies 16 bit PCM samples to packed 3 byte little endian samples.
+ * \param[in_out] dest: destination buffer, at least num_samples * 3 bytes.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: 16 bit source samples.
+ * \param[in] num_samples: samples to convert, across all channels.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+_IRQL_requires_max_(DISPATCH_LEVEL)
+int32_t ar_pcm_convert_16_to_24_packed(_Inout_ void* dest, _In_ size_t dest_size, _In_ const int16_t* src, _In_ size_t num_samples)
+{
+    uint8_t *out = dest;
+
+    if (AR_EOK != mem_op_pcm_check(dest, dest_size, src, num_samples, 3)) {
+        return AR_EBADPARAM;
+    }
+    for (size_t i = 0; i < num_samples; i++, out += 3) {
+        uint16_t x = (uint16_t)src[i];
+        out[0] = 0;
+        out[1] = (uint8_t)x;
+        out[2] = (uint8_t)(x >> 8);
+    }
+    return AR_EOK;
+}
+
+static int32_t mem_op_pcm_layout_check(void* dest, size_t dest_size, const void* src,
+    size_t size, uint32_t num_channels, uint32_t bytes_per_sample)
+{
+    if (NULL == dest || NULL == src || 0 == size || dest_size < size ||
+        0 == num_channels || 0 == bytes_per_sample || bytes_per_sample > 4 ||
+        0 != size % ((size_t)num_channels * bytes_per_sample)) {
+        return AR_EBADPARAM;
+    }
+    return AR_EOK;
+}
+
+/* Moves sample s of channel c between the planar and the interleaved layout,
+ * walking the interleaved side sequentially */
+#define MEM_OP_PCM_SHUFFLE(type, planar, inter, frames, channels, to_inter)   \
+    do {                                                                     \
+        type *p_ = (type *)(planar);                                         \
+        type *i_ = (type *)(inter);                                          \
+        for (size_t f_ = 0; f_ < (frames); f_++) {                           \
+            for (size_t c_ = 0; c_ < (channels); c_++, i_++) {               \
+                if (to_inter)                                                \
+                    *i_ = p_[c_ * (frames) + f_];                            \
+                else                                                         \
+                    p_[c_ * (frames) + f_] = *i_;                            \
+            }                                                                \
+        }                                                                    \
+    } while (0)
+
+static void mem_op_pcm_shuffle(uint8_t *planar, uint8_t *inter, size_t size,
+    uint32_t num_channels, uint32_t bytes_per_sample, bool_t to_inter)
+{
+    size_t frames = size / ((size_t)num_channels * bytes_per_sample);
+
+    switch (bytes_per_sample) {
+    case 1:
+        MEM_OP_PCM_SHUFFLE(uint8_t, planar, inter, frames, num_channels, to_inter);
+        break;
+    case 2:
+        MEM_OP_PCM_SHUFFLE(uint16_t, planar, inter, frames, num_channels, to_inter);
+        break;
+    case 4:
+        MEM_OP_PCM_SHUFFLE(uint32_t, planar, inter, frames, num_channels, to_inter);
+        break;
+    default:
+        for (size_t f = 0; f < frames; f++) {
+            for (size_t c = 0; c < num_channels; c++, inter += bytes_per_sample) {
+                uint8_t *p = planar + (c * frames + f) * bytes_per_sample;
+                if (to_inter)
+                    memcpy(inter, p, bytes_per_sample);
+                else
+                    memcpy(p, inter, bytes_per_sample);
+            }
+        }
+        break;
+    }
+}
+
+/**
+ * \brief ar_pcm_interleave
+ *        copies planar PCM to interleaved frames.
+ * \param[in_out] dest: destination buffer.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: planar source buffer.
+ * \param[in] size: source bytes, a multiple of num_channels * bytes_per_sample.
+ * \param[in] num_channels: number of channels.
+ * \param[in] bytes_per_sample: sample container size, 1 to 4 bytes.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+_IRQL_requires_max_(DISPATCH_LEVEL)
+int32_t ar_pcm_interleave(_Inout_ void* dest, _In_ size_t dest_size, _In_ const void* src, _In_ size_t size,
+    _In_ uint32_t num_channels, _In_ uint32_t bytes_per_sample)
+{
+    if (AR_EOK != mem_op_pcm_layout_check(dest, dest_size, src, size, num_channels, bytes_per_sample)) {
+        return AR_EBADPARAM;
+    }
+    if (1 == num_channels) {
+        memcpy(dest, src, size);
+        return AR_EOK;
+    }
+    mem_op_pcm_shuffle((uint8_t *)src, dest, size, num_channels, bytes_per_sample, TRUE);
+    return AR_EOK;
+}
+
+/**
+ * \brief ar_pcm_deinterleave
+ *        copies interleaved PCM frames to planar PCM.
+ * \param[in_out] dest: destination buffer.
+ * \param[in] dest_size: destination buffer size.
+ * \param[in] src: interleaved source buffer.
+ * \param[in] size: source bytes, a multiple of num_channels * bytes_per_sample.
+ * \param[in] num_channels: number of channels.
+ * \param[in] bytes_per_sample: sample container size, 1 to 4 bytes.
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+_IRQL_requires_max_(DISPATCH_LEVEL)
+int32_t ar_pcm_deinterleave(_Inout_ void* dest, _In_ size_t dest_size, _In_ const void* src, _In_ size_t size,
+    _In_ uint32_t num_channels, _In_ uint32_t bytes_per_sample)
+{
+    if (AR_EOK != mem_op_pcm_layout_check(dest, dest_size, src, size, num_channels, bytes_per_sample)) {
+        return AR_EBADPARAM;
+    }
+    if (1 == num_channels) {
+        memcpy(dest, src, size);
+        return AR_EOK;
+    }
+    mem_op_pcm_shuffle(dest, (uint8_t *)src, size, num_channels, bytes_per_sample, FALSE);
+    return AR_EOK;
+}
@@ -10,30 +10,156 @@
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #define AR_OSAL_MUTEX_LOG_TAG     "COMU"
 #include <stddef.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <sched.h>
 #include <errno.h>
+#include <stdatomic.h>
 #include "ar_osal_mutex.h"
 #include "ar_osal_log.h"
 #include "ar_osal_error.h"
 
-/* Internal lock definition */
+#define OSAL_MUTEX_STATE_UNINIT      (0)
+#define OSAL_MUTEX_STATE_INITIALIZING (1)
+#define OSAL_MUTEX_STATE_READY       (2)
+
+#define OSAL_MUTEX_DEFAULT_SPIN_COUNT (100)
+
+#if defined(__x86_64__) || defined(__i386__)
+#define osal_mutex_cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define osal_mutex_cpu_relax() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define osal_mutex_cpu_relax() do { } while (0)
+#endif
+
+/* Internal lock definition. All zero is a valid, not yet initialized mutex
+ * with default attributes, see AR_OSAL_MUTEX_STATIC_INIT. */
 typedef struct osal_int_mutex {
-    pthread_mutex_t mutex;
+    pthread_mutex_t  mutex;
+    _Atomic uint32_t state;
+    uint32_t         spin_count; /* trylock attempts before blocking, 0 to block at once */
+    bool_t           allocated;
 } osal_int_mutex_t;
 
+typedef char osal_mutex_storage_check[
+    (sizeof(osal_int_mutex_t) <= sizeof(ar_osal_mutex_storage_t)) ? 1 : -1];
+
+static int32_t osal_mutex_setup(osal_int_mutex_t *the_mutex, const ar_osal_mutex_attr_t *attr)
+{
+    pthread_mutexattr_t mattr;
+    uint32_t flags = (NULL != attr) ? attr->flags : 0;
+    int type = PTHREAD_MUTEX_DEFAULT;
+    int rc;
+
+    the_mutex->spin_count = 0;
+    if (flags & AR_OSAL_MUTEX_ATTR_SPIN) {
+        the_mutex->spin_count = attr->spin_count ? attr->spin_count : OSAL_MUTEX_DEFAULT_SPIN_COUNT;
+    }
+
+    if (flags & AR_OSAL_MUTEX_ATTR_RECURSIVE) {
+        type = PTHREAD_MUTEX_RECURSIVE;
+    }
+    if (flags & AR_OSAL_MUTEX_ATTR_ADAPTIVE) {
+#ifdef PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP
+        if (PTHREAD_MUTEX_DEFAULT == type)
+            type = PTHREAD_MUTEX_ADAPTIVE_NP;
+#endif
+        /* without an adaptive kind for this mutex, spin in user space */
+        if (PTHREAD_MUTEX_DEFAULT == type || PTHREAD_MUTEX_RECURSIVE == type) {
+            if (0 == the_mutex->spin_count)
+                the_mutex->spin_count = OSAL_MUTEX_DEFAULT_SPIN_COUNT;
+        }
+    }
+
+    rc = pthread_mutexattr_init(&mattr);
+    if (rc) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: failed to init mutex attributes, rc = %d\n", __func__, rc);
+        return AR_EFAILED;
+    }
+    (void)pthread_mutexattr_settype(&mattr, type);
+    if (flags & AR_OSAL_MUTEX_ATTR_PRIO_INHERIT) {
+        rc = pthread_mutexattr_setprotocol(&mattr, PTHREAD_PRIO_INHERIT);
+        if (rc) {
+            AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: priority inheritance not supported, rc = %d\n", __func__, rc);
+        }
+    }
+
+    rc = pthread_mutex_init(&the_mutex->mutex, &mattr);
+    (void)pthread_mutexattr_destroy(&mattr);
+    if (rc) {
+        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: failed to initialize mutex, rc = %d\n", __func__, rc);
+        return AR_EFAILED;
+    }
+
+    atomic_store_explicit(&the_mutex->state, OSAL_MUTEX_STATE_READY, memory_order_release);
+    return AR_EOK;
+}
+
+/* First use of a statically initialized mutex */
+static void osal_mutex_lazy_init(osal_int_mutex_t *the_mutex)
+{
+    uint32_t expected = OSAL_MUTEX_STATE_UNINIT;
+
+    if (atomic_compare_exchange_strong(&the_mutex->state, &expected, OSAL_MUTEX_STATE_INITIALIZING)) {
+        if (AR_EOK != osal_mutex_setup(the_mutex, NULL))
+            atomic_store(&the_mutex->state, OSAL_MUTEX_STATE_UNINIT);
+        return;
+    }
+    while (OSAL_MUTEX_STATE_INITIALIZING == atomic_load_explicit(&the_mutex->state, memory_order_acquire))
+        sched_yield();
+}
+
+static inline osal_int_mutex_t *osal_mutex_get(ar_osal_mutex_t ar_osal_mutex)
+{
+    osal_int_mutex_t *the_mutex = ar_osal_mutex;
+
+    if (NULL != the_mutex &&
+        OSAL_MUTEX_STATE_READY != atomic_load_explicit(&the_mutex->state, memory_order_acquire))
+        osal_mutex_lazy_init(the_mutex);
+    return the_mutex;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
-int32_t ar_osal_mutex_init(_Inout_ ar_osal_mutex_t mutex __unused)
+int32_t ar_osal_mutex_init(_Inout_ ar_osal_mutex_t mutex)
 {
-    return AR_ENOTIMPL;
+    return ar_osal_mutex_init_v2(mutex, NULL);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
-int32_t ar_osal_mutex_deinit(_In_ ar_osal_mutex_t mutex __unused)
+int32_t ar_osal_mutex_init_v2(_Inout_ ar_osal_mutex_t mutex, _In_ const ar_osal_mutex_attr_t *attr)
 {
-    return AR_ENOTIMPL;
+    osal_int_mutex_t *the_mutex = mutex;
+
+    if (NULL == the_mutex) {
+        return AR_EBADPARAM;
+    }
+    atomic_init(&the_mutex->state, OSAL_MUTEX_STATE_UNINIT);
+    the_mutex->allocated = FALSE;
+    return osal_mutex_setup(the_mutex, attr);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_mutex_deinit(_In_ ar_osal_mutex_t mutex)
+{
+    osal_int_mutex_t *the_mutex = mutex;
+
+    if (NULL == the_mutex) {
+        return AR_EBADPARAM;
+    }
+    if (OSAL_MUTEX_STATE_READY == atomic_load(&the_mutex->state)) {
+        if (pthread_mutex_destroy(&the_mutex->mutex)) {
+            AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: Failed to destroy mutex\n", __func__);
+            return AR_EFAILED;
+        }
+    }
+    atomic_store(&the_mutex->state, OSAL_MUTEX_STATE_UNINIT);
+    return AR_EOK;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -45,6 +171,12 @@ size_t ar_osal_mutex_get_size(void)
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_mutex_create(_Inout_ ar_osal_mutex_t *ar_osal_mutex)
+{
+    return ar_osal_mutex_create_v2(ar_osal_mutex, NULL);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_mutex_create_v2(_Inout_ ar_osal_mutex_t *ar_osal_mutex, _In_ const ar_osal_mutex_attr_t *attr)
 {
     int32_t rc;
     osal_int_mutex_t* the_mutex;
@@ -60,12 +192,11 @@ int32_t ar_osal_mutex_create(_Inout_ ar_osal_mutex_t *ar_osal_mutex)
         goto exit;
     }
 
-    rc = pthread_mutex_init(&the_mutex->mutex, NULL);
+    rc = ar_osal_mutex_init_v2(the_mutex, attr);
     if (rc) {
-        rc = AR_EFAILED;
-        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: failed to initialize mutex\n", __func__);
         goto fail;
     }
+    the_mutex->allocated = TRUE;
 
     *ar_osal_mutex = the_mutex;
     return 0;
@@ -88,13 +219,12 @@ int32_t ar_osal_mutex_destroy(_In_ ar_osal_mutex_t ar_osal_mutex)
         return AR_EBADPARAM;
     }
 
-    rc = pthread_mutex_destroy(&the_mutex->mutex);
+    rc = ar_osal_mutex_deinit(the_mutex);
     if (rc) {
-        AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: Failed to destroy mutex\n", __func__);
-        rc = AR_EFAILED;
         goto exit;
     }
-    free(the_mutex);
+    if (the_mutex->allocated)
+        free(the_mutex);
 
 exit:
     return rc;
@@ -104,13 +234,19 @@ _IRQL_requires_min_(PASSIVE_LEVEL)
 int32_t ar_osal_mutex_lock(_In_ ar_osal_mutex_t ar_osal_mutex)
 {
     int32_t rc;
-    osal_int_mutex_t *the_mutex = ar_osal_mutex;
+    osal_int_mutex_t *the_mutex = osal_mutex_get(ar_osal_mutex);
 
     if (NULL == the_mutex) {
         AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: ar_osal_mutex is NULL\n", __func__);
         return AR_EBADPARAM;
     }
 
+    for (uint32_t i = 0; i < the_mutex->spin_count; i++) {
+        if (0 == pthread_mutex_trylock(&the_mutex->mutex))
+            return AR_EOK;
+        osal_mutex_cpu_relax();
+    }
+
     rc = pthread_mutex_lock(&the_mutex->mutex);
     if (rc) {
         AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: Failed to lock ar_osal_mutex\n", __func__);
@@ -123,7 +259,7 @@ _IRQL_requires_min_(PASSIVE_LEVEL)
 int32_t ar_osal_mutex_try_lock(_In_ ar_osal_mutex_t ar_osal_mutex)
 {
     int32_t rc;
-    osal_int_mutex_t *the_mutex = ar_osal_mutex;
+    osal_int_mutex_t *the_mutex = osal_mutex_get(ar_osal_mutex);
 
     if (NULL == the_mutex) {
         AR_LOG_ERR(AR_OSAL_MUTEX_LOG_TAG,"%s: ar_osal_mutex is NULL\n", __func__);
@@ -11,7 +11,14 @@
  */
 
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include "ar_osal_shmem.h"
 #include "ar_osal_error.h"
 #include "ar_osal_log.h"
@@ -19,6 +26,29 @@
 #define  AR_OSAL_SHMEM_LOG_TAG     "AOSH"
 /*Memory pointer to be 4K aligned for ADSP, MDSP,SDSP and CDSP */
 #define  SHMEM_4K_ALIGNMENT       (4096)
+/* Huge page size assumed for MFD_HUGETLB sizing and THP alignment */
+#define  SHMEM_HUGE_PAGE_SIZE     (2 * 1024 * 1024)
+
+/* Build time defaults for allocations that leave the backend/page flags 0 */
+#ifndef AR_OSAL_SHMEM_DEFAULT_BACKEND
+#define AR_OSAL_SHMEM_DEFAULT_BACKEND  AR_SHMEM_BACKEND_HEAP
+#endif
+#ifndef AR_OSAL_SHMEM_DEFAULT_PAGE
+#define AR_OSAL_SHMEM_DEFAULT_PAGE     AR_SHMEM_PAGE_DEFAULT
+#endif
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC   0x0001U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB   0x0004U
+#endif
+
+/* Kept in ar_shmem_info.metadata for memfd allocations, 0 for heap ones */
+typedef struct ar_shmem_memfd_handle {
+    int    fd;
+    size_t map_size;
+} ar_shmem_memfd_handle_t;
 
 
 /**
@@ -94,6 +124,96 @@ int32_t ar_shmem_init_v2(uint32_t num_master_procs, uint32_t *master_procs)
     return AR_EOK;
 }
 
+static uint32_t ar_shmem_get_backend(const ar_shmem_info *info)
+{
+    uint32_t backend = (info->flags >> AR_SHMEM_SHIFT_BACKEND_FLAG) & AR_SHMEM_BIT_MASK_BACKEND_FLAG;
+
+    return (AR_SHMEM_BACKEND_DEFAULT == backend) ? AR_OSAL_SHMEM_DEFAULT_BACKEND : backend;
+}
+
+static uint32_t ar_shmem_get_page(const ar_shmem_info *info)
+{
+    uint32_t page = (info->flags >> AR_SHMEM_SHIFT_PAGE_FLAG) & AR_SHMEM_BIT_MASK_PAGE_FLAG;
+
+    return (AR_SHMEM_PAGE_DEFAULT == page) ? AR_OSAL_SHMEM_DEFAULT_PAGE : page;
+}
+
+static int ar_shmem_memfd_create(uint32_t mfd_flags)
+{
+    return (int)syscall(__NR_memfd_create, "ar_shmem", mfd_flags);
+}
+
+/*
+ * memfd allocation. The descriptor is reported in pa_lsw/pa_msw, the same
+ * way dma-buf descriptors are passed on targets with an audio ion driver,
+ * so it can be handed to another process (e.g. over SCM_RIGHTS).
+ */
+static int32_t ar_shmem_memfd_alloc(ar_shmem_info *info, uint32_t page)
+{
+    ar_shmem_memfd_handle_t *handle;
+    size_t map_size = info->buf_size;
+    void *vaddr = MAP_FAILED;
+    int fd = -1;
+
+    handle = (ar_shmem_memfd_handle_t *)malloc(sizeof(ar_shmem_memfd_handle_t));
+    if (NULL == handle) {
+        return AR_ENOMEMORY;
+    }
+
+    if (AR_SHMEM_PAGE_HUGETLB == page) {
+        map_size = (info->buf_size + SHMEM_HUGE_PAGE_SIZE - 1) & ~((size_t)SHMEM_HUGE_PAGE_SIZE - 1);
+        fd = ar_shmem_memfd_create(MFD_CLOEXEC | MFD_HUGETLB);
+        if (fd >= 0 && (ftruncate(fd, (off_t)map_size) ||
+            MAP_FAILED == (vaddr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)))) {
+            close(fd);
+            fd = -1;
+        }
+        if (fd < 0) {
+            AR_LOG_INFO(AR_OSAL_SHMEM_LOG_TAG, "no huge pages for size(0x%zx), errno(%d), using base pages",
+                        map_size, errno);
+            map_size = info->buf_size;
+        }
+    }
+
+    if (fd < 0) {
+        fd = ar_shmem_memfd_create(MFD_CLOEXEC);
+        if (fd < 0) {
+            AR_LOG_ERR(AR_OSAL_SHMEM_LOG_TAG, "Error: memfd_create failed, errno(%d)", errno);
+            goto fail;
+        }
+        if (ftruncate(fd, (off_t)map_size)) {
+            AR_LOG_ERR(AR_OSAL_SHMEM_LOG_TAG, "Error: memfd size(0x%zx) failed, errno(%d)", map_size, errno);
+            goto fail;
+        }
+        vaddr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (MAP_FAILED == vaddr) {
+            AR_LOG_ERR(AR_OSAL_SHMEM_LOG_TAG, "Error: memfd mmap failed, errno(%d)", errno);
+            goto fail;
+        }
+#ifdef MADV_HUGEPAGE
+        /* shmem THP needs shmem_enabled=advise (or always) in sysfs */
+        if (AR_SHMEM_PAGE_THP == page)
+            (void)madvise(vaddr, map_size, MADV_HUGEPAGE);
+#endif
+    }
+
+    handle->fd = fd;
+    handle->map_size = map_size;
+    info->vaddr = vaddr;
+    info->metadata = (uint64_t)(uintptr_t)handle;
+    info->index_type = AR_SHMEM_BUFFER_OFFSET;
+    info->mem_type = AR_SHMEM_PHYSICAL_MEMORY;
+    info->pa_lsw = info->ipa_lsw = (uint32_t)fd;
+    info->pa_msw = info->ipa_msw = 0;
+    return AR_EOK;
+
+fail:
+    if (fd >= 0)
+        close(fd);
+    free(handle);
+    return AR_ENOMEMORY;
+}
+
 /*
  * \brief Allocates shared memory.
  *  Only non cached memory allocation supported.
@@ -113,6 +233,7 @@ int32_t ar_shmem_alloc(_Inout_ ar_shmem_info *info)
     PAGED_FUNCTION();
     int32_t status = AR_EOK;
     void *p = 0;
+    uint32_t page;
 
     if (NULL == info || 0 == info->buf_size) {
         AR_LOG_ERR(AR_OSAL_SHMEM_LOG_TAG,"Error: info(NULL)|buf_size(0) passed");
@@ -133,9 +254,26 @@ int32_t ar_shmem_alloc(_Inout_ ar_shmem_info *info)
     info->pa_msw = 0;
     info->index_type = AR_SHMEM_BUFFER_ADDRESS;
     info->mem_type = AR_SHMEM_VIRTUAL_MEMORY;
+    page = ar_shmem_get_page(info);
 
+    if (AR_SHMEM_BACKEND_MEMFD == ar_shmem_get_backend(info)) {
+        status = ar_shmem_memfd_alloc(info, page);
+        if (AR_EOK == status)
+            AR_LOG_VERBOSE(AR_OSAL_SHMEM_LOG_TAG, " SHMEM: memfd(%d)|buf_size(0x%x)|vaddr(0x%p)",
+                           info->pa_lsw, info->buf_size, info->vaddr);
+        goto end;
+    }
 
-    posix_memalign(&p, SHMEM_4K_ALIGNMENT,info->buf_size);
+    /* private memory can only use transparent huge pages */
+    if (AR_SHMEM_PAGE_DEFAULT != page && info->buf_size >= SHMEM_HUGE_PAGE_SIZE) {
+        if (0 == posix_memalign(&p, SHMEM_HUGE_PAGE_SIZE, info->buf_size)) {
+#ifdef MADV_HUGEPAGE
+            (void)madvise(p, info->buf_size, MADV_HUGEPAGE);
+#endif
+        }
+    } else {
+        posix_memalign(&p, SHMEM_4K_ALIGNMENT,info->buf_size);
+    }
     info->vaddr = p;
     AR_LOG_ERR(AR_OSAL_SHMEM_LOG_TAG, "vaddr(0x%p)", info->vaddr);
     if (NULL == info->vaddr)
@@ -189,7 +327,16 @@ int32_t ar_shmem_free(_In_ ar_shmem_info *info)
     }
 
     AR_LOG_VERBOSE(AR_OSAL_SHMEM_LOG_TAG, "SHMEM: freed(0x%p)", info->vaddr);
-    free(info->vaddr);
+    if (info->metadata) {
+        ar_shmem_memfd_handle_t *handle = (ar_shmem_memfd_handle_t *)(uintptr_t)info->metadata;
+
+        munmap(info->vaddr, handle->map_size);
+        close(handle->fd);
+        free(handle);
+        info->metadata = 0;
+    } else {
+        free(info->vaddr);
+    }
     info->vaddr = NULL;
 
 end:
@@ -3,82 +3,303 @@
  *
  * \brief
  *       This file has implementation of signal2 APIs.
+ *       The 32 signals live in one futex word: setting signals nobody waits
+ *       for is a single atomic OR, and a waiter is woken by one futex call.
+ *       An eventfd is created on demand by ar_osal_signal2_get_fd() so the
+ *       signal can also be polled together with other file descriptors.
  *
  * \copyright
  *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define AR_OSAL_SIGNAL2_LOG_TAG   "COS2"
 #include <stdlib.h>
 #include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/futex.h>
 #include "ar_osal_signal2.h"
+#include "ar_osal_log.h"
+#include "ar_osal_error.h"
+
+#define NS_PER_SEC 1000000000LL
+
+/* Internal signal2 definition */
+typedef struct osal_int_signal2 {
+    _Atomic uint32_t signals;
+    _Atomic uint32_t num_waiters;
+    _Atomic int      event_fd;
+    bool_t           allocated;
+} osal_int_signal2_t;
+
+static int osal_signal2_futex_wait(_Atomic uint32_t *word, uint32_t val, const struct timespec *timeout)
+{
+    return (int)syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT_PRIVATE, val, timeout, NULL, 0);
+}
+
+static void osal_signal2_futex_wake(_Atomic uint32_t *word)
+{
+    (void)syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+static void osal_signal2_notify_fd(osal_int_signal2_t *the_signal2)
+{
+    uint64_t one = 1;
+    int fd = atomic_load(&the_signal2->event_fd);
+
+    if (fd >= 0 && write(fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: eventfd write failed, errno = %d\n", __func__, errno);
+    }
+}
+
+/* Waits until (signals & mask) satisfies the condition or the deadline passes */
+static int32_t osal_signal2_wait(osal_int_signal2_t *the_signal2, uint32_t mask, bool_t all,
+                                 const struct timespec *deadline, uint32_t *signals)
+{
+    struct timespec now, rel, *timeout = NULL;
+    int64_t remaining_ns;
+    uint32_t cur;
+    int32_t rc = AR_EOK;
+
+    for (;;) {
+        cur = atomic_load(&the_signal2->signals);
+        if (all ? ((cur & mask) == mask) : (0 != (cur & mask)))
+            break;
+
+        if (NULL != deadline) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            remaining_ns = (deadline->tv_sec - now.tv_sec) * NS_PER_SEC + (deadline->tv_nsec - now.tv_nsec);
+            if (remaining_ns <= 0) {
+                rc = AR_ETIMEOUT;
+                break;
+            }
+            rel.tv_sec = remaining_ns / NS_PER_SEC;
+            rel.tv_nsec = remaining_ns % NS_PER_SEC;
+            timeout = &rel;
+        }
+
+        atomic_fetch_add(&the_signal2->num_waiters, 1);
+        (void)osal_signal2_futex_wait(&the_signal2->signals, cur, timeout);
+        atomic_fetch_sub(&the_signal2->num_waiters, 1);
+    }
+
+    if (NULL != signals)
+        *signals = cur;
+    return rc;
+}
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_signal2_init(_Inout_ ar_osal_signal2_t osal_signal2)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    osal_int_signal2_t *the_signal2 = (osal_int_signal2_t *)osal_signal2;
+
+    if (NULL == the_signal2) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: signal2 is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+    atomic_init(&the_signal2->signals, 0);
+    atomic_init(&the_signal2->num_waiters, 0);
+    atomic_init(&the_signal2->event_fd, -1);
+    the_signal2->allocated = FALSE;
+    return AR_EOK;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_signal2_deinit(_In_ ar_osal_signal2_t osal_signal2)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    osal_int_signal2_t *the_signal2 = (osal_int_signal2_t *)osal_signal2;
+    int fd;
+
+    if (NULL == the_signal2) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: signal2 is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+    fd = atomic_exchange(&the_signal2->event_fd, -1);
+    if (fd >= 0)
+        close(fd);
+    return AR_EOK;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
-size_t ar_osal_signal2_get_size()
+size_t ar_osal_signal2_get_size(void)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    return sizeof(osal_int_signal2_t);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_signal2_create(_Out_ ar_osal_signal2_t *osal_signal2)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    osal_int_signal2_t *the_signal2;
+
+    if (NULL == osal_signal2) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: signal2 is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+    the_signal2 = (osal_int_signal2_t *)malloc(sizeof(osal_int_signal2_t));
+    if (NULL == the_signal2) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: failed to allocate signal2 memory\n", __func__);
+        return AR_ENOMEMORY;
+    }
+    (void)ar_osal_signal2_init(the_signal2);
+    the_signal2->allocated = TRUE;
+    *osal_signal2 = the_signal2;
+    return AR_EOK;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_signal2_destroy(_In_ ar_osal_signal2_t osal_signal2)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    osal_int_signal2_t *the_signal2 = (osal_int_signal2_t *)osal_signal2;
+    int32_t rc;
+
+    rc = ar_osal_signal2_deinit(the_signal2);
+    if (AR_EOK == rc && the_signal2->allocated)
+        free(the_signal2);
+    return rc;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 uint32_t ar_osal_signal2_wait_any(_In_ ar_osal_signal2_t osal_signal2, _In_ uint32_t osal_signal2_mask)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    uint32_t signals = 0;
+
+    if (NULL == osal_signal2 || 0 == osal_signal2_mask) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: invalid signal2 %p or mask\n", __func__, osal_signal2);
+        return 0;
+    }
+    (void)osal_signal2_wait((osal_int_signal2_t *)osal_signal2, osal_signal2_mask, FALSE, NULL, &signals);
+    return signals;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint32_t ar_osal_signal2_wait_all(_In_ ar_osal_signal2_t osal_signal2, _In_ uint32_t osal_signal2_mask)
+{
+    uint32_t signals = 0;
+
+    if (NULL == osal_signal2 || 0 == osal_signal2_mask) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: invalid signal2 %p or mask\n", __func__, osal_signal2);
+        return 0;
+    }
+    (void)osal_signal2_wait((osal_int_signal2_t *)osal_signal2, osal_signal2_mask, TRUE, NULL, &signals);
+    return signals;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
-uint32_t ar_osal_signal2_wait_all( _In_ ar_osal_signal2_t osal_signal2, _In_ uint32_t osal_signal2_mask);
+int32_t ar_osal_signal2_timedwait_any(_In_ ar_osal_signal2_t osal_signal2, _In_ uint32_t osal_signal2_mask,
+                                      _In_ int64_t timeout_in_nsec, _Out_ uint32_t *signals)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    struct timespec deadline;
+    int64_t nsec;
+
+    if (NULL == osal_signal2 || 0 == osal_signal2_mask) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: invalid signal2 %p or mask\n", __func__, osal_signal2);
+        return AR_EBADPARAM;
+    }
+    if (timeout_in_nsec < 0)
+        return osal_signal2_wait((osal_int_signal2_t *)osal_signal2, osal_signal2_mask, FALSE, NULL, signals);
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    nsec = deadline.tv_nsec + timeout_in_nsec % NS_PER_SEC;
+    deadline.tv_sec += timeout_in_nsec / NS_PER_SEC + nsec / NS_PER_SEC;
+    deadline.tv_nsec = nsec % NS_PER_SEC;
+    return osal_signal2_wait((osal_int_signal2_t *)osal_signal2, osal_signal2_mask, FALSE, &deadline, signals);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_signal2_set(_In_ ar_osal_signal2_t osal_signal2, _In_ uint32_t osal_signal2_mask)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    osal_int_signal2_t *the_signal2 = (osal_int_signal2_t *)osal_signal2;
+    uint32_t old;
+
+    if (NULL == the_signal2) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: signal2 is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+
+    old = atomic_fetch_or(&the_signal2->signals, osal_signal2_mask);
+    if ((old & osal_signal2_mask) == osal_signal2_mask)
+        return AR_EOK;
+
+    if (atomic_load(&the_signal2->num_waiters) > 0)
+        osal_signal2_futex_wake(&the_signal2->signals);
+    osal_signal2_notify_fd(the_signal2);
+    return AR_EOK;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 uint32_t ar_osal_signal2_get(_In_ ar_osal_signal2_t osal_signal2)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    osal_int_signal2_t *the_signal2 = (osal_int_signal2_t *)osal_signal2;
+
+    if (NULL == the_signal2) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: signal2 is NULL\n", __func__);
+        return 0;
+    }
+    return atomic_load(&the_signal2->signals);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_signal2_clear(_In_ ar_osal_signal2_t osal_signal2, _In_ uint32_t osal_signal2_mask)
 {
-    ALOGE("%s: not implemented\n", __func__);
-    return -ENOSYS;
+    osal_int_signal2_t *the_signal2 = (osal_int_signal2_t *)osal_signal2;
+    uint64_t count;
+    int fd;
+
+    if (NULL == the_signal2) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: signal2 is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+
+    if (0 != (atomic_fetch_and(&the_signal2->signals, ~osal_signal2_mask) & ~osal_signal2_mask))
+        return AR_EOK;
+
+    /* No signal left, stop reporting the fd readable. A set() racing with the
+     * drain is caught by the re-check below. */
+    fd = atomic_load(&the_signal2->event_fd);
+    if (fd >= 0) {
+        while (read(fd, &count, sizeof(count)) > 0)
+            ;
+        if (0 != atomic_load(&the_signal2->signals))
+            osal_signal2_notify_fd(the_signal2);
+    }
+    return AR_EOK;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_signal2_get_fd(_In_ ar_osal_signal2_t osal_signal2, _Out_ int *fd)
+{
+    osal_int_signal2_t *the_signal2 = (osal_int_signal2_t *)osal_signal2;
+    int expected = -1;
+    int new_fd;
+
+    if (NULL == the_signal2 || NULL == fd) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: invalid signal2 %p or fd\n", __func__, osal_signal2);
+        return AR_EBADPARAM;
+    }
+
+    *fd = atomic_load(&the_signal2->event_fd);
+    if (*fd >= 0)
+        return AR_EOK;
+
+    new_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (new_fd < 0) {
+        AR_LOG_ERR(AR_OSAL_SIGNAL2_LOG_TAG, "%s: eventfd failed, errno = %d\n", __func__, errno);
+        return AR_EFAILED;
+    }
+    if (!atomic_compare_exchange_strong(&the_signal2->event_fd, &expected, new_fd)) {
+        close(new_fd);
+        *fd = expected;
+        return AR_EOK;
+    }
+
+    if (0 != atomic_load(&the_signal2->signals))
+        osal_signal2_notify_fd(the_signal2);
+    *fd = new_fd;
+    return AR_EOK;
 }
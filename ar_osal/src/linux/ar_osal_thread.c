@@ -15,6 +15,12 @@
 #include <errno.h>
 #include <pthread.h>
 #include <string.h>
+#include <stddef.h>
+#include <sched.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
 #include "ar_osal_thread.h"
 #include "ar_osal_log.h"
 #include "ar_osal_error.h"
@@ -23,13 +29,90 @@ typedef struct osal_int_thread {
     pthread_t pthread_handle;
     ar_osal_thread_start_routine fn;
     void* param;
+    _Atomic pid_t tid;           /* kernel thread id, 0 until the thread runs */
+    int32_t sched_policy;
+    int32_t nice;
+    uint64_t cpu_affinity_mask;
+    char_t name[AR_OSAL_THREAD_NAME_MAX_LEN];
 } osal_int_thread_t;
 
+static inline pid_t osal_thread_gettid(void)
+{
+    return (pid_t)syscall(SYS_gettid);
+}
+
+static int32_t osal_thread_to_policy(int32_t sched_policy, int *policy)
+{
+    switch (sched_policy) {
+    case AR_OSAL_THREAD_SCHED_OTHER:
+        *policy = SCHED_OTHER;
+        break;
+    case AR_OSAL_THREAD_SCHED_FIFO:
+        *policy = SCHED_FIFO;
+        break;
+    case AR_OSAL_THREAD_SCHED_RR:
+        *policy = SCHED_RR;
+        break;
+    default:
+        return AR_EBADPARAM;
+    }
+    return AR_EOK;
+}
+
+/* Affinity and nice value are per kernel thread, so they are applied by tid */
+static int32_t osal_thread_apply_affinity(pid_t tid, uint64_t cpu_mask)
+{
+    cpu_set_t cpu_set;
+    uint32_t cpu;
+
+    CPU_ZERO(&cpu_set);
+    for (cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+        if (0 == cpu_mask || (cpu_mask & (1ULL << cpu)))
+            CPU_SET(cpu, &cpu_set);
+    }
+    if (sched_setaffinity(tid, sizeof(cpu_set), &cpu_set)) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to set affinity 0x%llx for tid %d, errno = %d\n",
+                   __func__, (unsigned long long)cpu_mask, tid, errno);
+        return AR_EFAILED;
+    }
+    return AR_EOK;
+}
+
+static int32_t osal_thread_apply_nice(pid_t tid, int32_t nice)
+{
+    if (setpriority(PRIO_PROCESS, (id_t)tid, nice)) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to set nice %d for tid %d, errno = %d\n",
+                   __func__, nice, tid, errno);
+        return AR_EFAILED;
+    }
+    return AR_EOK;
+}
+
+static void osal_thread_copy_name(char_t *dst, const char_t *name)
+{
+    strncpy(dst, name, AR_OSAL_THREAD_NAME_MAX_LEN - 1);
+    dst[AR_OSAL_THREAD_NAME_MAX_LEN - 1] = '\0';
+}
+
+/* Per thread settings are applied from the new thread itself, so they are in
+ * place before the client routine runs and cannot race with its exit. */
 static void* osal_thread_wrapper(void *param)
 {
     osal_int_thread_t *the_thread = (osal_int_thread_t *)param;
-    if (NULL != the_thread)
-        the_thread->fn(the_thread->param);
+    pid_t tid = osal_thread_gettid();
+
+    if (NULL == the_thread)
+        return NULL;
+
+    if (the_thread->name[0] && pthread_setname_np(pthread_self(), the_thread->name))
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to set thread name %s\n", __func__, the_thread->name);
+    if (the_thread->cpu_affinity_mask)
+        (void)osal_thread_apply_affinity(tid, the_thread->cpu_affinity_mask);
+    if (AR_OSAL_THREAD_SCHED_OTHER == the_thread->sched_policy && the_thread->nice)
+        (void)osal_thread_apply_nice(tid, the_thread->nice);
+    atomic_store(&the_thread->tid, tid);
+
+    the_thread->fn(the_thread->param);
     return NULL;
 }
 
@@ -76,22 +159,39 @@ done:
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
-int32_t ar_osal_thread_create(_Out_  ar_osal_thread_t *ret_thread,
-                                 _In_ ar_osal_thread_attr_t *attr_ptr,
-                                 _In_ ar_osal_thread_start_routine osal_thread_start,
-                                 _In_opt_ void *osal_thread_param)
+int32_t ar_osal_thread_attr_ext_init(_Out_ ar_osal_thread_attr_ext_t *attr_ext)
+{
+    int32_t rc;
+
+    if (NULL == attr_ext)
+        return AR_EBADPARAM;
+
+    memset(attr_ext, 0, sizeof(ar_osal_thread_attr_ext_t));
+    rc = ar_osal_thread_attr_init(&attr_ext->attr);
+    if (rc)
+        return rc;
+    attr_ext->struct_size = sizeof(ar_osal_thread_attr_ext_t);
+    attr_ext->sched_policy = AR_OSAL_THREAD_SCHED_INHERIT;
+    return AR_EOK;
+}
+
+/* True when a caller built with attr_ext->struct_size set the given field */
+#define OSAL_THREAD_ATTR_EXT_HAS(attr_ext, field) \
+    ((attr_ext)->struct_size >= offsetof(ar_osal_thread_attr_ext_t, field) + \
+                                sizeof(((ar_osal_thread_attr_ext_t *)0)->field))
+
+static int32_t osal_thread_create(ar_osal_thread_t *ret_thread,
+                                  const ar_osal_thread_attr_ext_t *attr_ext,
+                                  ar_osal_thread_start_routine osal_thread_start,
+                                  void *osal_thread_param)
 {
     int32_t rc;
     osal_int_thread_t *the_thread;
     pthread_attr_t attr;
     void *ret_val;
     struct sched_param sch_param;
-
-    if (NULL == ret_thread || NULL == attr_ptr) {
-        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: ret_thread or attr_ptr is NULL\n", __func__);
-        rc = AR_EBADPARAM;
-        goto done;
-    }
+    int policy = SCHED_OTHER;
+    const ar_osal_thread_attr_t *attr_ptr = &attr_ext->attr;
 
     the_thread = (osal_int_thread_t *) malloc(sizeof(osal_int_thread_t));
     if (NULL == the_thread) {
@@ -115,6 +215,21 @@ int32_t ar_osal_thread_create(_Out_  ar_osal_thread_t *ret_thread,
 
     memset(&sch_param, 0, sizeof(sch_param));
     sch_param.sched_priority = attr_ptr->priority;
+    if (AR_OSAL_THREAD_SCHED_INHERIT != attr_ext->sched_policy) {
+        rc = osal_thread_to_policy(attr_ext->sched_policy, &policy);
+        if (rc) {
+            AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Invalid scheduling policy %d\n", __func__, attr_ext->sched_policy);
+            goto err_set;
+        }
+        if (SCHED_OTHER == policy)
+            sch_param.sched_priority = 0;
+        if (pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED) ||
+            pthread_attr_setschedpolicy(&attr, policy)) {
+            AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to set scheduling policy %d\n", __func__, policy);
+            rc = AR_EFAILED;
+            goto err_set;
+        }
+    }
     rc = pthread_attr_setschedparam (&attr, &sch_param);
     if (rc) {
         AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to set thread priority , rc = %d\n", __func__, rc);
@@ -130,23 +245,28 @@ int32_t ar_osal_thread_create(_Out_  ar_osal_thread_t *ret_thread,
     }
     the_thread->fn = osal_thread_start;
     the_thread->param = osal_thread_param;
+    atomic_init(&the_thread->tid, 0);
+    the_thread->sched_policy = attr_ext->sched_policy;
+    the_thread->nice = attr_ext->nice;
+    the_thread->cpu_affinity_mask = attr_ext->cpu_affinity_mask;
+    the_thread->name[0] = '\0';
+    if (attr_ptr->thread_name)
+        osal_thread_copy_name(the_thread->name, attr_ptr->thread_name);
     rc = pthread_create(&the_thread->pthread_handle, &attr,
                       osal_thread_wrapper, the_thread);
+    if (EPERM == rc && AR_OSAL_THREAD_SCHED_INHERIT != attr_ext->sched_policy) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: No permission for policy %d priority %d, inheriting caller's\n",
+                   __func__, attr_ext->sched_policy, attr_ptr->priority);
+        (void)pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        rc = pthread_create(&the_thread->pthread_handle, &attr,
+                          osal_thread_wrapper, the_thread);
+    }
     if (rc) {
         AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to create thread, rc = %d\n", __func__, rc);
         rc = AR_EFAILED;
         goto err_set;
     }
 
-    if (attr_ptr->thread_name){
-        rc = pthread_setname_np(the_thread->pthread_handle, attr_ptr->thread_name);
-        if (rc) {
-            AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to create thread, rc = %d\n", __func__, rc);
-            rc = AR_EFAILED;
-            goto err_destroy;
-        }
-    }
-
     rc = pthread_attr_destroy(&attr);
     if (rc) {
         AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to destroy attributes, rc = %d\n", __func__, rc);
@@ -170,6 +290,51 @@ done:
     return rc;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_thread_create(_Out_  ar_osal_thread_t *ret_thread,
+                                 _In_ ar_osal_thread_attr_t *attr_ptr,
+                                 _In_ ar_osal_thread_start_routine osal_thread_start,
+                                 _In_opt_ void *osal_thread_param)
+{
+    ar_osal_thread_attr_ext_t attr_ext;
+
+    if (NULL == ret_thread || NULL == attr_ptr) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: ret_thread or attr_ptr is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+
+    memset(&attr_ext, 0, sizeof(attr_ext));
+    attr_ext.struct_size = sizeof(attr_ext);
+    attr_ext.attr = *attr_ptr;
+    attr_ext.sched_policy = AR_OSAL_THREAD_SCHED_INHERIT;
+    return osal_thread_create(ret_thread, &attr_ext, osal_thread_start, osal_thread_param);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_thread_create_ext(_Out_ ar_osal_thread_t *ret_thread,
+                                  _In_ const ar_osal_thread_attr_ext_t *attr_ext,
+                                  _In_ ar_osal_thread_start_routine osal_thread_start,
+                                  _In_opt_ void *osal_thread_param)
+{
+    ar_osal_thread_attr_ext_t attr_cur;
+
+    if (NULL == ret_thread || NULL == attr_ext) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: ret_thread or attr_ext is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+    if (!OSAL_THREAD_ATTR_EXT_HAS(attr_ext, attr)) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Unsupported attribute size %u\n", __func__, attr_ext->struct_size);
+        return AR_EBADPARAM;
+    }
+
+    /* Copy what the caller's version knows, the rest keeps its default */
+    memset(&attr_cur, 0, sizeof(attr_cur));
+    memcpy(&attr_cur, attr_ext,
+           attr_ext->struct_size < sizeof(attr_cur) ? attr_ext->struct_size : sizeof(attr_cur));
+    attr_cur.struct_size = sizeof(attr_cur);
+    return osal_thread_create(ret_thread, &attr_cur, osal_thread_start, osal_thread_param);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 int32_t ar_osal_thread_join_destroy(_In_ ar_osal_thread_t thread)
 {
@@ -309,6 +474,112 @@ int64_t ar_osal_thread_get_id()
     return (int64_t)pthread_self();
 }
 
+static int32_t osal_thread_set_sched(pthread_t pthread_handle, pid_t tid, int32_t sched_policy,
+                                     int32_t priority, int32_t nice)
+{
+    int32_t rc;
+    int policy;
+    struct sched_param sch_param;
+
+    rc = osal_thread_to_policy(sched_policy, &policy);
+    if (rc) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Invalid scheduling policy %d\n", __func__, sched_policy);
+        return rc;
+    }
+
+    memset(&sch_param, 0, sizeof(sch_param));
+    sch_param.sched_priority = (SCHED_OTHER == policy) ? 0 : priority;
+    rc = pthread_setschedparam(pthread_handle, policy, &sch_param);
+    if (rc) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to set policy %d priority %d, rc = %d\n",
+                   __func__, policy, sch_param.sched_priority, rc);
+        return AR_EFAILED;
+    }
+    if (SCHED_OTHER == policy)
+        rc = osal_thread_apply_nice(tid, nice);
+    return rc;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_thread_set_sched(_In_ ar_osal_thread_t thread, _In_ int32_t policy,
+                                 _In_ int32_t priority, _In_ int32_t nice)
+{
+    osal_int_thread_t *the_thread = (osal_int_thread_t *)thread;
+    pid_t tid;
+
+    if (NULL == the_thread) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Thread is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+    tid = atomic_load(&the_thread->tid);
+    if (0 == tid) {
+        return AR_ENOTREADY;
+    }
+    return osal_thread_set_sched(the_thread->pthread_handle, tid, policy, priority, nice);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_thread_self_set_sched(_In_ int32_t policy, _In_ int32_t priority, _In_ int32_t nice)
+{
+    return osal_thread_set_sched(pthread_self(), osal_thread_gettid(), policy, priority, nice);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_thread_set_affinity(_In_ ar_osal_thread_t thread, _In_ uint64_t cpu_mask)
+{
+    osal_int_thread_t *the_thread = (osal_int_thread_t *)thread;
+    pid_t tid;
+
+    if (NULL == the_thread) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Thread is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+    tid = atomic_load(&the_thread->tid);
+    if (0 == tid) {
+        return AR_ENOTREADY;
+    }
+    return osal_thread_apply_affinity(tid, cpu_mask);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_thread_self_set_affinity(_In_ uint64_t cpu_mask)
+{
+    return osal_thread_apply_affinity(osal_thread_gettid(), cpu_mask);
+}
+
+static int32_t osal_thread_set_name(pthread_t pthread_handle, const char_t *thread_name)
+{
+    int32_t rc;
+    char_t name[AR_OSAL_THREAD_NAME_MAX_LEN];
+
+    if (NULL == thread_name) {
+        return AR_EBADPARAM;
+    }
+    osal_thread_copy_name(name, thread_name);
+    rc = pthread_setname_np(pthread_handle, name);
+    if (rc) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Failed to set thread name %s, rc = %d\n", __func__, name, rc);
+        rc = AR_EFAILED;
+    }
+    return rc;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_thread_set_name(_In_ ar_osal_thread_t thread, _In_ const char_t *name)
+{
+    if (NULL == thread) {
+        AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Thread is NULL\n", __func__);
+        return AR_EBADPARAM;
+    }
+    return osal_thread_set_name(((osal_int_thread_t *)thread)->pthread_handle, name);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_thread_self_set_name(_In_ const char_t *name)
+{
+    return osal_thread_set_name(pthread_self(), name);
+}
+
 int32_t ar_osal_thread_self_terminate()
 {
     AR_LOG_ERR(AR_OSAL_THREAD_LOG_TAG,"%s: Not Implemented\n", __func__);
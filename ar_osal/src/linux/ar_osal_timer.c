@@ -9,10 +9,58 @@
  *  SPDX-License-Identifier: BSD-3-Clause
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#define AR_OSAL_TIMER_LOG_TAG  "COTI"
 #include <time.h>
 #include <math.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
 #include "ar_osal_error.h"
 #include "ar_osal_heap.h"
+#include "ar_osal_log.h"
+#include "ar_osal_timer.h"
+
+#define OSAL_TIMER_WHEEL_SLOTS  256 /* power of two */
+#define OSAL_TIMER_TICK_NS      (1000000ULL)
+
+typedef struct osal_timer {
+    struct osal_timer  *prev;
+    struct osal_timer  *next;
+    uint64_t            expiry_ns;
+    uint64_t            period_ns;
+    ar_osal_timer_cb_t  cb;
+    void               *cb_data;
+    uint32_t            seq;        /* bumped by start and cancel */
+    struct osal_timer **list;       /* wheel slot or expired list, NULL when idle */
+    bool_t              in_callback;
+} osal_timer_t;
+
+/* Timer service: one thread, one timerfd, one wheel */
+typedef struct osal_timer_service {
+    pthread_mutex_t  lock;
+    pthread_cond_t   cb_done;
+    pthread_t        thread;
+    int              tfd;
+    uint32_t         num_timers;
+    bool_t           stop;
+    bool_t           stopping;      /* thread being joined */
+    uint64_t         last_tick;     /* wheel position, in ticks */
+    uint64_t         armed_ns;      /* programmed expiry, 0 when disarmed */
+    osal_timer_t    *expired;       /* due, waiting for their callback */
+    osal_timer_t    *wheel[OSAL_TIMER_WHEEL_SLOTS];
+} osal_timer_service_t;
+
+static osal_timer_service_t osal_timer_svc = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cb_done = PTHREAD_COND_INITIALIZER,
+    .tfd = -1,
+};
 
 /**
  * \brief ar_timer_get_time_in_us
@@ -47,3 +95,296 @@ uint64_t ar_timer_get_time_in_ms(void)
 
     return ms;
 }
+
+static uint64_t osal_timer_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static osal_timer_t **osal_timer_slot(uint64_t expiry_ns)
+{
+    return &osal_timer_svc.wheel[(expiry_ns / OSAL_TIMER_TICK_NS) & (OSAL_TIMER_WHEEL_SLOTS - 1)];
+}
+
+static void osal_timer_link(osal_timer_t *timer, osal_timer_t **list)
+{
+    timer->prev = NULL;
+    timer->next = *list;
+    if (*list)
+        (*list)->prev = timer;
+    *list = timer;
+    timer->list = list;
+}
+
+static void osal_timer_unlink(osal_timer_t *timer)
+{
+    if (NULL == timer->list)
+        return;
+    if (timer->prev)
+        timer->prev->next = timer->next;
+    else
+        *timer->list = timer->next;
+    if (timer->next)
+        timer->next->prev = timer->prev;
+    timer->prev = timer->next = NULL;
+    timer->list = NULL;
+}
+
+/* Programs the timerfd for expiry_ns if it is earlier than what is armed */
+static void osal_timer_arm(uint64_t expiry_ns, bool_t force)
+{
+    struct itimerspec its;
+
+    if (!force && osal_timer_svc.armed_ns && osal_timer_svc.armed_ns <= expiry_ns)
+        return;
+
+    memset(&its, 0, sizeof(its));
+    if (expiry_ns) {
+        /* round up to the tick the timer is filed under */
+        expiry_ns = ((expiry_ns + OSAL_TIMER_TICK_NS - 1) / OSAL_TIMER_TICK_NS) * OSAL_TIMER_TICK_NS;
+        its.it_value.tv_sec = (time_t)(expiry_ns / 1000000000ULL);
+        its.it_value.tv_nsec = (long)(expiry_ns % 1000000000ULL);
+    }
+    if (timerfd_settime(osal_timer_svc.tfd, TFD_TIMER_ABSTIME, &its, NULL)) {
+        AR_LOG_ERR(AR_OSAL_TIMER_LOG_TAG,"%s: timerfd_settime failed, errno = %d\n", __func__, errno);
+        return;
+    }
+    osal_timer_svc.armed_ns = expiry_ns;
+}
+
+static uint64_t osal_timer_earliest(void)
+{
+    uint64_t earliest = 0;
+
+    for (uint32_t i = 0; i < OSAL_TIMER_WHEEL_SLOTS; i++) {
+        for (osal_timer_t *t = osal_timer_svc.wheel[i]; t; t = t->next) {
+            if (0 == earliest || t->expiry_ns < earliest)
+                earliest = t->expiry_ns;
+        }
+    }
+    return earliest;
+}
+
+/* Moves every timer due at now_ns from the wheel to the expired list */
+static void osal_timer_collect(uint64_t now_ns)
+{
+    uint64_t now_tick = now_ns / OSAL_TIMER_TICK_NS;
+    uint64_t tick = osal_timer_svc.last_tick;
+    uint64_t slots = now_tick - tick + 1;
+    osal_timer_t *t, *next;
+
+    if (slots > OSAL_TIMER_WHEEL_SLOTS)
+        slots = OSAL_TIMER_WHEEL_SLOTS;
+
+    for (; slots; slots--, tick++) {
+        for (t = osal_timer_svc.wheel[tick & (OSAL_TIMER_WHEEL_SLOTS - 1)]; t; t = next) {
+            next = t->next;
+            if (t->expiry_ns / OSAL_TIMER_TICK_NS > now_tick)
+                continue;
+            osal_timer_unlink(t);
+            osal_timer_link(t, &osal_timer_svc.expired);
+        }
+    }
+    osal_timer_svc.last_tick = now_tick;
+}
+
+static void *osal_timer_thread(void *arg)
+{
+    osal_timer_t *t;
+    uint64_t ticks, now_ns;
+    uint32_t seq;
+
+    (void)arg;
+    pthread_mutex_lock(&osal_timer_svc.lock);
+    while (!osal_timer_svc.stop) {
+        pthread_mutex_unlock(&osal_timer_svc.lock);
+        if (read(osal_timer_svc.tfd, &ticks, sizeof(ticks)) < 0 && EINTR != errno && EAGAIN != errno)
+            AR_LOG_ERR(AR_OSAL_TIMER_LOG_TAG,"%s: timerfd read failed, errno = %d\n", __func__, errno);
+        pthread_mutex_lock(&osal_timer_svc.lock);
+        if (osal_timer_svc.stop)
+            break;
+
+        osal_timer_svc.armed_ns = 0;
+        now_ns = osal_timer_now_ns();
+        osal_timer_collect(now_ns);
+        /* cancel takes timers off the expired list, so a callback may
+         * cancel or destroy any other timer */
+        while (NULL != (t = osal_timer_svc.expired)) {
+            osal_timer_unlink(t);
+            seq = t->seq;
+            t->in_callback = TRUE;
+            pthread_mutex_unlock(&osal_timer_svc.lock);
+            t->cb(t->cb_data);
+            pthread_mutex_lock(&osal_timer_svc.lock);
+            t->in_callback = FALSE;
+            /* periodic timers rearm unless restarted or cancelled meanwhile */
+            if (seq == t->seq && t->period_ns && NULL == t->list) {
+                t->expiry_ns += t->period_ns;
+                now_ns = osal_timer_now_ns();
+                if (t->expiry_ns <= now_ns)
+                    t->expiry_ns += ((now_ns - t->expiry_ns) / t->period_ns + 1) * t->period_ns;
+                osal_timer_link(t, osal_timer_slot(t->expiry_ns));
+            }
+            pthread_cond_broadcast(&osal_timer_svc.cb_done);
+        }
+        osal_timer_arm(osal_timer_earliest(), TRUE);
+    }
+    pthread_mutex_unlock(&osal_timer_svc.lock);
+    return NULL;
+}
+
+/* Called with the service lock held */
+static int32_t osal_timer_service_get(void)
+{
+    int rc;
+
+    while (osal_timer_svc.stopping)
+        pthread_cond_wait(&osal_timer_svc.cb_done, &osal_timer_svc.lock);
+    if (osal_timer_svc.num_timers++)
+        return AR_EOK;
+
+    osal_timer_svc.tfd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (osal_timer_svc.tfd < 0) {
+        AR_LOG_ERR(AR_OSAL_TIMER_LOG_TAG,"%s: timerfd_create failed, errno = %d\n", __func__, errno);
+        goto fail;
+    }
+    osal_timer_svc.stop = FALSE;
+    osal_timer_svc.armed_ns = 0;
+    osal_timer_svc.last_tick = osal_timer_now_ns() / OSAL_TIMER_TICK_NS;
+    rc = pthread_create(&osal_timer_svc.thread, NULL, osal_timer_thread, NULL);
+    if (rc) {
+        AR_LOG_ERR(AR_OSAL_TIMER_LOG_TAG,"%s: Failed to create timer thread, rc = %d\n", __func__, rc);
+        close(osal_timer_svc.tfd);
+        osal_timer_svc.tfd = -1;
+        goto fail;
+    }
+    (void)pthread_setname_np(osal_timer_svc.thread, "ar_osal_timer");
+    return AR_EOK;
+
+fail:
+    osal_timer_svc.num_timers--;
+    return AR_EFAILED;
+}
+
+/* Called with the service lock held, drops it while joining the thread */
+static void osal_timer_service_put(void)
+{
+    pthread_t thread = osal_timer_svc.thread;
+
+    if (--osal_timer_svc.num_timers)
+        return;
+
+    osal_timer_svc.stop = TRUE;
+    osal_timer_svc.stopping = TRUE;
+    osal_timer_arm(1, TRUE);
+    pthread_mutex_unlock(&osal_timer_svc.lock);
+    pthread_join(thread, NULL);
+    pthread_mutex_lock(&osal_timer_svc.lock);
+    close(osal_timer_svc.tfd);
+    osal_timer_svc.tfd = -1;
+    osal_timer_svc.stopping = FALSE;
+    pthread_cond_broadcast(&osal_timer_svc.cb_done);
+}
+
+static bool_t osal_timer_on_service_thread(void)
+{
+    return osal_timer_svc.num_timers && pthread_equal(pthread_self(), osal_timer_svc.thread);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_timer_create(_Out_ ar_osal_timer_t *timer, _In_ ar_osal_timer_cb_t cb, _In_opt_ void *cb_data)
+{
+    osal_timer_t *the_timer;
+    int32_t rc;
+
+    if (NULL == timer || NULL == cb) {
+        return AR_EBADPARAM;
+    }
+    the_timer = (osal_timer_t *)calloc(1, sizeof(osal_timer_t));
+    if (NULL == the_timer) {
+        AR_LOG_ERR(AR_OSAL_TIMER_LOG_TAG,"%s: failed to allocate memory for timer\n", __func__);
+        return AR_ENOMEMORY;
+    }
+    the_timer->cb = cb;
+    the_timer->cb_data = cb_data;
+
+    pthread_mutex_lock(&osal_timer_svc.lock);
+    rc = osal_timer_service_get();
+    pthread_mutex_unlock(&osal_timer_svc.lock);
+    if (rc) {
+        free(the_timer);
+        return rc;
+    }
+    *timer = the_timer;
+    return AR_EOK;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_timer_start(_In_ ar_osal_timer_t timer, _In_ uint64_t delay_us, _In_ uint64_t period_us)
+{
+    osal_timer_t *the_timer = (osal_timer_t *)timer;
+
+    if (NULL == the_timer) {
+        return AR_EBADPARAM;
+    }
+
+    pthread_mutex_lock(&osal_timer_svc.lock);
+    osal_timer_unlink(the_timer);
+    the_timer->seq++;
+    the_timer->period_ns = period_us * 1000ULL;
+    the_timer->expiry_ns = osal_timer_now_ns() + delay_us * 1000ULL;
+    osal_timer_link(the_timer, osal_timer_slot(the_timer->expiry_ns));
+    /* the service thread rearms itself after running callbacks */
+    if (!osal_timer_on_service_thread())
+        osal_timer_arm(the_timer->expiry_ns, FALSE);
+    pthread_mutex_unlock(&osal_timer_svc.lock);
+    return AR_EOK;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_timer_cancel(_In_ ar_osal_timer_t timer)
+{
+    osal_timer_t *the_timer = (osal_timer_t *)timer;
+
+    if (NULL == the_timer) {
+        return AR_EBADPARAM;
+    }
+
+    pthread_mutex_lock(&osal_timer_svc.lock);
+    osal_timer_unlink(the_timer);
+    the_timer->seq++;
+    the_timer->period_ns = 0;
+    if (!osal_timer_on_service_thread()) {
+        while (the_timer->in_callback)
+            pthread_cond_wait(&osal_timer_svc.cb_done, &osal_timer_svc.lock);
+    }
+    pthread_mutex_unlock(&osal_timer_svc.lock);
+    return AR_EOK;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+int32_t ar_osal_timer_destroy(_In_ ar_osal_timer_t timer)
+{
+    int32_t rc;
+
+    if (NULL == timer) {
+        return AR_EBADPARAM;
+    }
+    if (osal_timer_on_service_thread() && ((osal_timer_t *)timer)->in_callback) {
+        AR_LOG_ERR(AR_OSAL_TIMER_LOG_TAG,"%s: timer destroyed from its own callback\n", __func__);
+        return AR_EUNEXPECTED;
+    }
+
+    rc = ar_osal_timer_cancel(timer);
+    if (rc) {
+        return rc;
+    }
+    pthread_mutex_lock(&osal_timer_svc.lock);
+    osal_timer_service_put();
+    pthread_mutex_unlock(&osal_timer_svc.lock);
+    free(timer);
+    return AR_EOK;
+}
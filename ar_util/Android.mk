@@ -8,6 +8,7 @@ LOCAL_VENDOR_MODULE := true
 
 LOCAL_SRC_FILES := \
     src/ar_util_list.c \
+    src/ar_util_queue.c \
     src/ar_util_data_log.c \
     src/ar_util_err_detection.c
 
@@ -33,17 +34,21 @@ LOCAL_VENDOR_MODULE := true
 LOCAL_SRC_FILES := \
     test/src/ar_osal_mutex_thread.c \
     test/src/ar_osal_signal_thread.c \
+    test/src/ar_osal_signal2_thread.c \
     test/src/ar_osal_test.c \
     test/src/ar_osal_test_service.c \
     test/src/ar_test_file_io.c \
     test/src/ar_test_heap.c \
     test/src/ar_test_list.c \
+    test/src/ar_test_queue.c \
     test/src/ar_test_mem_op.c \
     test/src/ar_test_shmem.c \
     test/src/ar_test_sleep.c \
+    test/src/ar_test_timer.c \
     test/src/ar_test_string.c\
     test/src/ar_test_data_log.c \
-    test/src/ar_test_log_pkt_op.c
+    test/src/ar_test_log_pkt_op.c \
+    test/src/ar_test_log.c
 
 LOCAL_SHARED_LIBRARIES := \
     liblog \
@@ -133,6 +133,26 @@ typedef struct ar_data_log_blob_fmt_t
     uint8_t data[0];                /**< The data */
 }ar_data_log_blob_fmt_t;
 
+/**< Called once the data logger no longer references a buffer passed to
+ar_data_log_submit_async(...). status is the result of logging it. */
+typedef void (*ar_data_log_release_cb_t)(
+    void *cb_ctx, int8_t *buffer, int32_t status);
+
+/**< Asynchronous logging counters, see ar_data_log_get_async_stats(...) */
+typedef struct ar_data_log_async_stats_t
+{
+    uint64_t num_queued;            /**< Buffers accepted by the async queue */
+    uint64_t num_logged;            /**< Buffers serialized by the worker */
+    uint64_t num_failed;            /**< Buffers the worker failed to log */
+    uint64_t num_dropped;           /**< Buffers rejected because the queue was full */
+    uint64_t max_latency_us;        /**< Longest time from submit to serialization */
+    uint32_t queue_depth;           /**< Capacity of the async queue */
+    uint32_t max_queued;            /**< Highest number of buffers waiting at once */
+}ar_data_log_async_stats_t;
+
+/** Number of buffers the async queue holds before submits are dropped */
+#define AR_DATA_LOG_ASYNC_QUEUE_DEPTH 256
+
 /*=============================================================================
 Function Declarations
 =============================================================================*/
@@ -257,6 +277,79 @@ int32_t ar_data_log_submit(ar_data_log_submit_info_t *info);
 */
 void ar_data_log_free(void *log_pkt_payload_ptr, ar_log_pkt_type_t pkt_type);
 
+/**
+* \brief
+*   Starts or stops the asynchronous logging worker. While it runs,
+*   ar_data_log_submit_async(...) only queues a reference to the buffer and
+*   the worker formats and commits the log packets. Stopping logs whatever
+*   is still queued before returning.
+*
+* \param[in] enable: TRUE to start the worker, FALSE to stop it
+*
+* \return
+* 0       -- Success
+* Nonzero -- Failure
+*
+* \dependencies
+* ar_data_log_init(...) must be called first
+*/
+int32_t ar_data_log_set_async(bool_t enable);
+
+/**
+* \brief
+*   Submits a buffer for logging without copying it. The buffer and the
+*   channel mapping it refers to stay owned by the data logger until
+*   release_cb is called; the submit info and packet info are copied.
+*   A zero log_time_stamp is replaced with the submit time.
+*
+*   When the async worker is not running the buffer is logged in the
+*   calling thread and release_cb is called before returning.
+*   When the queue is full the buffer is dropped, counted, and the call
+*   returns AR_ENORESOURCE without calling release_cb.
+*
+* \param[in] info:       the submit info, as for ar_data_log_submit(...)
+* \param[in] release_cb: optional, called when the buffer can be reused
+* \param[in] cb_ctx:     passed back to release_cb
+*
+* \return
+* 0       -- Success
+* AR_ENORESOURCE -- queue full, the buffer was not taken
+* Nonzero -- Failure
+*
+* \dependencies
+* None
+*/
+int32_t ar_data_log_submit_async(ar_data_log_submit_info_t *info,
+    ar_data_log_release_cb_t release_cb, void *cb_ctx);
+
+/**
+* \brief
+*   Waits until every buffer queued so far has been logged
+*
+* \return
+* 0       -- Success
+* Nonzero -- Failure
+*
+* \dependencies
+* None
+*/
+int32_t ar_data_log_flush(void);
+
+/**
+* \brief
+*   Reads the asynchronous logging counters
+*
+* \param[out] stats: receives the counters
+*
+* \return
+* 0       -- Success
+* Nonzero -- Failure
+*
+* \dependencies
+* None
+*/
+int32_t ar_data_log_get_async_stats(ar_data_log_async_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,236 @@
+#ifndef AR_UTIL_QUEUE_H
+#define AR_UTIL_QUEUE_H
+
+/**
+ * \file ar_util_queue.h
+ * \brief
+ *        Defines public AudioReach UTIL APIs for lock-free rings and
+ *        object free-stacks.
+ *
+ *        All containers work on caller supplied storage and never allocate.
+ *        Producer and consumer indices sit on separate cache lines so the two
+ *        sides do not invalidate each other on every operation.
+ * \copyright
+ *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ar_osal_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/** Assumed cache line size, used to pad indices owned by different threads */
+#define AR_UTIL_CACHE_LINE_SIZE (64)
+
+/**
+ * Single producer, single consumer ring of fixed size elements.
+ * Exactly one thread may push and exactly one thread may pop.
+ */
+typedef struct ar_spsc_ring_t
+{
+	/**< Next slot to write, written by the producer only. */
+	volatile uint32_t head;
+	/**< Producer's last observed tail, avoids reading the consumer line. */
+	uint32_t cached_tail;
+	uint8_t pad0[AR_UTIL_CACHE_LINE_SIZE - 8];
+	/**< Next slot to read, written by the consumer only. */
+	volatile uint32_t tail;
+	/**< Consumer's last observed head. */
+	uint32_t cached_head;
+	uint8_t pad1[AR_UTIL_CACHE_LINE_SIZE - 8];
+	/**< Element storage, num_elems * elem_size bytes. */
+	uint8_t *buf;
+	/**< Size of one element in bytes. */
+	uint32_t elem_size;
+	/**< num_elems - 1, num_elems is a power of two. */
+	uint32_t mask;
+} ar_spsc_ring_t;
+
+/**
+ * Multi producer, single consumer ring of fixed size elements.
+ * Any number of threads may push, exactly one thread may pop.
+ * Each slot carries a sequence number that tells the consumer when the
+ * producer that claimed it has finished writing.
+ */
+typedef struct ar_mpsc_ring_t
+{
+	/**< Next slot to claim, shared by all producers. */
+	volatile uint32_t enqueue_pos;
+	uint8_t pad0[AR_UTIL_CACHE_LINE_SIZE - 4];
+	/**< Next slot to read, written by the consumer only. */
+	volatile uint32_t dequeue_pos;
+	uint8_t pad1[AR_UTIL_CACHE_LINE_SIZE - 4];
+	/**< Slot storage, see AR_MPSC_RING_STORAGE_SIZE. */
+	uint8_t *slots;
+	/**< Size of one element in bytes. */
+	uint32_t elem_size;
+	/**< Size of one slot, sequence number plus element, 8 byte aligned. */
+	uint32_t slot_size;
+	/**< num_elems - 1, num_elems is a power of two. */
+	uint32_t mask;
+} ar_mpsc_ring_t;
+
+/** Bytes of storage an ar_mpsc_ring_t needs for num_elems elements.
+ *  Each slot is an 8 byte sequence header followed by the element. */
+#define AR_MPSC_RING_SLOT_SIZE(elem_size) \
+	((((uint32_t)(elem_size)) + sizeof(uint64_t) + 7u) & ~7u)
+#define AR_MPSC_RING_STORAGE_SIZE(elem_size, num_elems) \
+	((size_t)AR_MPSC_RING_SLOT_SIZE(elem_size) * (num_elems))
+
+/**
+ * Lock-free stack of free fixed size objects carved from one pool.
+ * Any thread may push or pop. The link to the next free object is kept in
+ * the first word of each free object; the head carries a generation count
+ * so a pop racing with pop/push/pop of the same object fails its swap.
+ */
+typedef struct ar_free_stack_t
+{
+	/**< Generation in the upper half, object index + 1 in the lower half. */
+	volatile uint64_t head;
+	uint8_t pad0[AR_UTIL_CACHE_LINE_SIZE - 8];
+	/**< Number of objects currently on the stack. */
+	volatile uint32_t count;
+	uint8_t pad1[AR_UTIL_CACHE_LINE_SIZE - 4];
+	/**< Object pool, num_objs * obj_size bytes. */
+	uint8_t *pool;
+	/**< Size of one object in bytes, a multiple of 4. */
+	uint32_t obj_size;
+	/**< Number of objects in the pool. */
+	uint32_t num_objs;
+} ar_free_stack_t;
+
+/**
+ * \brief ar_spsc_ring_init: initialize an empty ring.
+ * \param[in] ring: pointer to ar_spsc_ring_t.
+ * \param[in] storage: num_elems * elem_size bytes of element storage.
+ * \param[in] elem_size: size of one element in bytes.
+ * \param[in] num_elems: capacity, must be a power of two.
+ *
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_spsc_ring_init(ar_spsc_ring_t *ring, void *storage,
+	uint32_t elem_size, uint32_t num_elems);
+
+/**
+ * \brief ar_spsc_ring_push: copy one element into the ring.
+ *        Producer thread only.
+ * \param[in] ring: pointer to ar_spsc_ring_t.
+ * \param[in] elem: elem_size bytes to copy in.
+ *
+ * \return
+ *  0 -- Success
+ *  AR_ENORESOURCE -- ring is full
+ */
+int32_t ar_spsc_ring_push(ar_spsc_ring_t *ring, const void *elem);
+
+/**
+ * \brief ar_spsc_ring_pop: copy the oldest element out of the ring.
+ *        Consumer thread only.
+ * \param[in] ring: pointer to ar_spsc_ring_t.
+ * \param[out] elem: elem_size bytes to copy out to.
+ *
+ * \return
+ *  0 -- Success
+ *  AR_ENOTEXIST -- ring is empty
+ */
+int32_t ar_spsc_ring_pop(ar_spsc_ring_t *ring, void *elem);
+
+/**
+ * \brief ar_spsc_ring_get_count: number of queued elements. Exact when
+ *        called from the producer or the consumer, a snapshot otherwise.
+ * \param[in] ring: pointer to ar_spsc_ring_t.
+ *
+ * \return number of elements in the ring.
+ */
+uint32_t ar_spsc_ring_get_count(ar_spsc_ring_t *ring);
+
+/**
+ * \brief ar_mpsc_ring_init: initialize an empty ring.
+ * \param[in] ring: pointer to ar_mpsc_ring_t.
+ * \param[in] storage: AR_MPSC_RING_STORAGE_SIZE(elem_size, num_elems) bytes,
+ *            8 byte aligned.
+ * \param[in] elem_size: size of one element in bytes.
+ * \param[in] num_elems: capacity, must be a power of two.
+ *
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_mpsc_ring_init(ar_mpsc_ring_t *ring, void *storage,
+	uint32_t elem_size, uint32_t num_elems);
+
+/**
+ * \brief ar_mpsc_ring_push: copy one element into the ring.
+ *        Safe from any number of threads.
+ * \param[in] ring: pointer to ar_mpsc_ring_t.
+ * \param[in] elem: elem_size bytes to copy in.
+ *
+ * \return
+ *  0 -- Success
+ *  AR_ENORESOURCE -- ring is full
+ */
+int32_t ar_mpsc_ring_push(ar_mpsc_ring_t *ring, const void *elem);
+
+/**
+ * \brief ar_mpsc_ring_pop: copy the oldest published element out of the
+ *        ring. Consumer thread only.
+ * \param[in] ring: pointer to ar_mpsc_ring_t.
+ * \param[out] elem: elem_size bytes to copy out to.
+ *
+ * \return
+ *  0 -- Success
+ *  AR_ENOTEXIST -- ring is empty, or the oldest slot is still being written
+ */
+int32_t ar_mpsc_ring_pop(ar_mpsc_ring_t *ring, void *elem);
+
+/**
+ * \brief ar_free_stack_init: initialize a stack holding every object of
+ *        the pool.
+ * \param[in] stack: pointer to ar_free_stack_t.
+ * \param[in] pool: num_objs * obj_size bytes, 4 byte aligned.
+ * \param[in] obj_size: size of one object, a non zero multiple of 4.
+ * \param[in] num_objs: number of objects in the pool.
+ *
+ * \return
+ *  0 -- Success
+ *  Nonzero -- Failure
+ */
+int32_t ar_free_stack_init(ar_free_stack_t *stack, void *pool,
+	uint32_t obj_size, uint32_t num_objs);
+
+/**
+ * \brief ar_free_stack_pop: take a free object.
+ * \param[in] stack: pointer to ar_free_stack_t.
+ *
+ * \return object pointer, NULL if the stack is empty.
+ */
+void *ar_free_stack_pop(ar_free_stack_t *stack);
+
+/**
+ * \brief ar_free_stack_push: return an object taken from this stack.
+ * \param[in] stack: pointer to ar_free_stack_t.
+ * \param[in] obj: object pointer returned by ar_free_stack_pop.
+ *
+ * \return
+ *  0 -- Success
+ *  AR_EBADPARAM -- obj does not belong to the pool
+ */
+int32_t ar_free_stack_push(ar_free_stack_t *stack, void *obj);
+
+/**
+ * \brief ar_free_stack_get_count: number of free objects, a snapshot.
+ * \param[in] stack: pointer to ar_free_stack_t.
+ *
+ * \return number of objects on the stack.
+ */
+uint32_t ar_free_stack_get_count(ar_free_stack_t *stack);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* AR_UTIL_QUEUE_H */
@@ -16,6 +16,13 @@
 #include "ar_osal_mem_op.h"
 #include "ar_osal_log_pkt_op.h"
 #include "ar_osal_types.h"
+#include "ar_osal_timer.h"
+#include "ar_osal_heap.h"
+#include "ar_osal_mutex.h"
+#include "ar_osal_signal.h"
+#include "ar_osal_sleep.h"
+#include "ar_osal_thread.h"
+#include "ar_util_queue.h"
 
 #define AR_DATA_LOG_LOG_TAG "AR Data Logger"
 #define AR_DATA_LOG_ERR(...) AR_LOG_ERR(AR_DATA_LOG_LOG_TAG, __VA_ARGS__)
@@ -35,6 +42,59 @@ typedef struct fragment_info_t
     uint32_t offset;
 }fragment_info_t;
 
+/*
+-------------------------------------------------------------------------------
+|    Asynchronous logging
+-------------------------------------------------------------------------------
+*/
+#define AR_DATA_LOG_ASYNC_THREAD_NAME "ar_data_log"
+
+/* Packet info is copied at submit time, the caller's copy may be on its stack */
+typedef union data_log_pkt_info_u
+{
+    ar_data_log_pcm_pkt_info_t      pcm;
+    ar_data_log_generic_pkt_info_t  generic;
+}data_log_pkt_info_u;
+
+typedef struct data_log_async_entry_t
+{
+    ar_data_log_submit_info_t   info;
+    data_log_pkt_info_u         pkt_info;
+    uint64_t                    submit_time_us;
+    ar_data_log_release_cb_t    release_cb;
+    void                        *cb_ctx;
+}data_log_async_entry_t;
+
+typedef struct data_log_async_t
+{
+    ar_mpsc_ring_t      ring;
+    void                *ring_storage;
+    ar_osal_thread_t    thread;
+    ar_osal_signal_t    signal;
+    volatile uint32_t   enabled;
+    volatile uint32_t   stop;
+    /* set by the worker before it waits, producers signal only then */
+    volatile uint32_t   idle;
+    /* producers between checking enabled and queueing */
+    volatile uint32_t   num_users;
+    volatile uint64_t   num_queued;
+    volatile uint64_t   num_logged;
+    volatile uint64_t   num_failed;
+    volatile uint64_t   num_dropped;
+    volatile uint64_t   max_latency_us;
+    volatile uint32_t   max_queued;
+}data_log_async_t;
+
+static data_log_async_t data_log_async;
+static ar_osal_mutex_storage_t data_log_async_lock = AR_OSAL_MUTEX_STATIC_INIT;
+static ar_heap_info data_log_heap_info =
+{
+    AR_HEAP_ALIGN_8_BYTES,
+    AR_HEAP_POOL_DEFAULT,
+    AR_HEAP_ID_DEFAULT,
+    AR_HEAP_TAG_DEFAULT
+};
+
 /*
 -------------------------------------------------------------------------------
 |    Internal Helper Function Prototypes
@@ -65,6 +125,12 @@ static int32_t _log_generic_pkt(
 static int32_t _log_raw_pkt(
     void *log_pkt, int8_t *buffer, uint32_t buffer_size);
 
+static int32_t _log_submit(ar_data_log_submit_info_t *info);
+
+static int32_t _log_copy_info(
+    ar_data_log_submit_info_t *info, ar_data_log_submit_info_t *info_copy,
+    data_log_pkt_info_u *pkt_info_copy, uint64_t now_us);
+
 /*
 -------------------------------------------------------------------------------
 |    Public Functions
@@ -87,6 +153,8 @@ int32_t ar_data_log_deinit()
 {
     int32_t status = AR_EOK;
 
+    (void)ar_data_log_set_async(FALSE);
+
     status = ar_log_pkt_op_deinit();
     if (AR_FAILED(status))
     {
@@ -172,7 +240,8 @@ int32_t ar_data_log_commit(ar_data_log_commit_info_t *info)
         log_pkt_pcm->header.cmn_struct.user_session_info.tag = AR_AUDIOLOG_CNTR_USER_SESSION;
         log_pkt_pcm->header.cmn_struct.user_session_info.size = sizeof(ar_log_pkt_user_session_t);
         log_pkt_pcm->header.cmn_struct.user_session_info.user_session_id = 0;
-        uint64_t timestamp = 0;// posal_timer_get_time(); ar osal needs to support timer op
+        uint64_t timestamp = pcm_log_pkt_info->log_time_stamp ?
+            pcm_log_pkt_info->log_time_stamp : ar_timer_get_time_in_us();
         log_pkt_pcm->header.cmn_struct.user_session_info.time_stamp = timestamp;
 
         log_pkt_pcm->header.pcm_data_fmt.tag = AR_AUDIOLOG_CNTR_PCM_DATA_FORMAT;
@@ -225,7 +294,10 @@ int32_t ar_data_log_commit(ar_data_log_commit_info_t *info)
         log_pkt_bitstream->header.cmn_struct.user_session_info.tag = AR_AUDIOLOG_CNTR_USER_SESSION;
         log_pkt_bitstream->header.cmn_struct.user_session_info.size = sizeof(ar_log_pkt_user_session_t);
         log_pkt_bitstream->header.cmn_struct.user_session_info.user_session_id = 0;
-        uint64_t timestamp = 0;//posal_timer_get_time(); ar osal needs to support timer op
+        ar_data_log_pcm_pkt_info_t *bs_log_pkt_info =
+            (ar_data_log_pcm_pkt_info_t*)info->pkt_info;
+        uint64_t timestamp = (bs_log_pkt_info && bs_log_pkt_info->log_time_stamp) ?
+            bs_log_pkt_info->log_time_stamp : ar_timer_get_time_in_us();
         log_pkt_bitstream->header.cmn_struct.user_session_info.time_stamp = timestamp;
 
         log_pkt_bitstream->header.bs_data_fmt.tag = AR_AUDIOLOG_CNTR_BS_DATA_FORMAT;
@@ -251,7 +323,8 @@ int32_t ar_data_log_commit(ar_data_log_commit_info_t *info)
         log_pkt_generic->header.info.fragment_length = (uint16_t)info->buffer_size;
         log_pkt_generic->header.info.fragment_offset = 0;
         log_pkt_generic->header.info.buffer_length = info->buffer_size;
-        log_pkt_generic->header.info.time_stamp = pkt_info->log_time_stamp;
+        log_pkt_generic->header.info.time_stamp = pkt_info->log_time_stamp ?
+            pkt_info->log_time_stamp : ar_timer_get_time_in_us();
 
         log_pkt_generic->header.cmd.header_length = 1;
         log_pkt_generic->header.cmd.version = 1;
@@ -281,17 +354,238 @@ int32_t ar_data_log_commit(ar_data_log_commit_info_t *info)
 }
 
 int32_t ar_data_log_submit(ar_data_log_submit_info_t *info)
+{
+    int32_t                     status = AR_EOK;
+    ar_data_log_submit_info_t   info_copy;
+    data_log_pkt_info_u         pkt_info_copy;
+
+    if (!info)
+    {
+        AR_DATA_LOG_ERR("Status[%d]: Bad input parameter", AR_EBADPARAM);
+        return AR_EBADPARAM;
+    }
+
+    if (!ar_data_log_code_status(info->log_code))
+    {
+        AR_DATA_LOG_DBG("Log code 0x%x is not enabled.", info->log_code);
+        return AR_EOK;
+    }
+
+    status = _log_copy_info(
+        info, &info_copy, &pkt_info_copy, ar_timer_get_time_in_us());
+    if (AR_FAILED(status))
+    {
+        return status;
+    }
+
+    return _log_submit(&info_copy);
+}
+
+static int32_t _log_async_signal_worker(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&data_log_async.idle, __ATOMIC_RELAXED) &&
+        __atomic_exchange_n(&data_log_async.idle, 0, __ATOMIC_ACQ_REL))
+    {
+        return ar_osal_signal_set(data_log_async.signal);
+    }
+    return AR_EOK;
+}
+
+static void _log_async_process(data_log_async_entry_t *entry)
 {
     int32_t     status = AR_EOK;
-    int8_t      *buffer_ptr = NULL;
-    uint32_t    remaining_buffer_size = 0;
-    void        *log_pkt = NULL;
-    uint32_t    log_pkt_size = 0;
-    uint32_t    max_log_pkt_size = 0;
-    uint8_t     interleaved = 0;
-    uint32_t    num_channels = 0;
-    bool_t      is_first_seg = TRUE;
-    fragment_info_t fragment = { 0 };
+    uint64_t    latency_us = 0;
+    uint32_t    queued = 0;
+
+    /* the entry was copied through the ring, point back at its packet info */
+    if (entry->info.pkt_info)
+    {
+        entry->info.pkt_info = &entry->pkt_info;
+    }
+
+    queued = (uint32_t)(__atomic_load_n(&data_log_async.num_queued, __ATOMIC_RELAXED) -
+        data_log_async.num_logged - data_log_async.num_failed);
+    if (queued > data_log_async.max_queued)
+    {
+        __atomic_store_n(&data_log_async.max_queued, queued, __ATOMIC_RELAXED);
+    }
+
+    status = _log_submit(&entry->info);
+
+    latency_us = ar_timer_get_time_in_us() - entry->submit_time_us;
+    if (latency_us > data_log_async.max_latency_us)
+    {
+        __atomic_store_n(&data_log_async.max_latency_us, latency_us, __ATOMIC_RELAXED);
+    }
+
+    if (entry->release_cb)
+    {
+        entry->release_cb(entry->cb_ctx, entry->info.buffer, status);
+    }
+
+    if (AR_FAILED(status))
+    {
+        __atomic_fetch_add(&data_log_async.num_failed, 1, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        __atomic_fetch_add(&data_log_async.num_logged, 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void _log_async_worker(void *arg)
+{
+    data_log_async_entry_t entry;
+
+    __UNREFERENCED_PARAM(arg);
+
+    for (;;)
+    {
+        if (AR_EOK == ar_mpsc_ring_pop(&data_log_async.ring, &entry))
+        {
+            _log_async_process(&entry);
+            continue;
+        }
+
+        /* everything queued before stop was set has been logged */
+        if (__atomic_load_n(&data_log_async.stop, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+
+        __atomic_store_n(&data_log_async.idle, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (AR_EOK == ar_mpsc_ring_pop(&data_log_async.ring, &entry))
+        {
+            __atomic_store_n(&data_log_async.idle, 0, __ATOMIC_RELAXED);
+            _log_async_process(&entry);
+            continue;
+        }
+        if (!__atomic_load_n(&data_log_async.stop, __ATOMIC_ACQUIRE))
+        {
+            (void)ar_osal_signal_wait(data_log_async.signal);
+        }
+        (void)ar_osal_signal_clear(data_log_async.signal);
+        __atomic_store_n(&data_log_async.idle, 0, __ATOMIC_RELAXED);
+    }
+}
+
+static int32_t _log_async_start(void)
+{
+    int32_t                 status = AR_EOK;
+    size_t                  storage_size = 0;
+    ar_osal_thread_attr_t   thread_attr;
+
+    storage_size = AR_MPSC_RING_STORAGE_SIZE(
+        sizeof(data_log_async_entry_t), AR_DATA_LOG_ASYNC_QUEUE_DEPTH);
+    data_log_async.ring_storage =
+        ar_heap_malloc(storage_size, &data_log_heap_info);
+    if (!data_log_async.ring_storage)
+    {
+        AR_DATA_LOG_ERR("Status[%d]: Unable to allocate the async queue",
+            AR_ENOMEMORY);
+        return AR_ENOMEMORY;
+    }
+
+    status = ar_mpsc_ring_init(&data_log_async.ring,
+        data_log_async.ring_storage, sizeof(data_log_async_entry_t),
+        AR_DATA_LOG_ASYNC_QUEUE_DEPTH);
+    if (AR_FAILED(status))
+    {
+        goto free_storage;
+    }
+
+    status = ar_osal_signal_create(&data_log_async.signal);
+    if (AR_FAILED(status))
+    {
+        AR_DATA_LOG_ERR("Status[%d]: Unable to create the async signal",
+            status);
+        goto free_storage;
+    }
+
+    data_log_async.stop = 0;
+    data_log_async.idle = 0;
+
+    status = ar_osal_thread_attr_init(&thread_attr);
+    if (AR_SUCCEEDED(status))
+    {
+        thread_attr.thread_name = AR_DATA_LOG_ASYNC_THREAD_NAME;
+        status = ar_osal_thread_create(&data_log_async.thread,
+            &thread_attr, _log_async_worker, NULL);
+    }
+    if (AR_FAILED(status))
+    {
+        AR_DATA_LOG_ERR("Status[%d]: Unable to start the async worker",
+            status);
+        goto destroy_signal;
+    }
+
+    __atomic_store_n(&data_log_async.enabled, 1, __ATOMIC_RELEASE);
+    return AR_EOK;
+
+destroy_signal:
+    (void)ar_osal_signal_destroy(data_log_async.signal);
+    data_log_async.signal = NULL;
+free_storage:
+    ar_heap_free(data_log_async.ring_storage, &data_log_heap_info);
+    data_log_async.ring_storage = NULL;
+    return status;
+}
+
+static void _log_async_stop(void)
+{
+    __atomic_store_n(&data_log_async.enabled, 0, __ATOMIC_SEQ_CST);
+
+    /* a producer that saw the worker enabled may still be queueing */
+    while (__atomic_load_n(&data_log_async.num_users, __ATOMIC_SEQ_CST))
+    {
+        (void)ar_osal_micro_sleep(100);
+    }
+
+    __atomic_store_n(&data_log_async.stop, 1, __ATOMIC_RELEASE);
+    (void)ar_osal_signal_set(data_log_async.signal);
+    (void)ar_osal_thread_join_destroy(data_log_async.thread);
+    data_log_async.thread = NULL;
+
+    (void)ar_osal_signal_destroy(data_log_async.signal);
+    data_log_async.signal = NULL;
+    ar_heap_free(data_log_async.ring_storage, &data_log_heap_info);
+    data_log_async.ring_storage = NULL;
+}
+
+int32_t ar_data_log_set_async(bool_t enable)
+{
+    int32_t status = AR_EOK;
+
+    (void)ar_osal_mutex_lock(&data_log_async_lock);
+    if (enable && !data_log_async.enabled)
+    {
+        status = _log_async_start();
+        if (AR_SUCCEEDED(status))
+        {
+            AR_DATA_LOG_INFO("Asynchronous data logging started");
+        }
+    }
+    else if (!enable && data_log_async.enabled)
+    {
+        _log_async_stop();
+        AR_DATA_LOG_INFO("Asynchronous data logging stopped, "
+            "logged %llu failed %llu dropped %llu",
+            (unsigned long long)data_log_async.num_logged,
+            (unsigned long long)data_log_async.num_failed,
+            (unsigned long long)data_log_async.num_dropped);
+    }
+    (void)ar_osal_mutex_unlock(&data_log_async_lock);
+
+    return status;
+}
+
+int32_t ar_data_log_submit_async(ar_data_log_submit_info_t *info,
+    ar_data_log_release_cb_t release_cb, void *cb_ctx)
+{
+    int32_t                 status = AR_EOK;
+    data_log_async_entry_t  entry;
 
     if (!info)
     {
@@ -301,10 +595,97 @@ int32_t ar_data_log_submit(ar_data_log_submit_info_t *info)
 
     if (!ar_data_log_code_status(info->log_code))
     {
-        AR_DATA_LOG_DBG("Log code 0x%x is not enabled.");
+        if (release_cb)
+        {
+            release_cb(cb_ctx, info->buffer, AR_EOK);
+        }
         return AR_EOK;
     }
 
+    entry.submit_time_us = ar_timer_get_time_in_us();
+    entry.release_cb = release_cb;
+    entry.cb_ctx = cb_ctx;
+    status = _log_copy_info(info, &entry.info, &entry.pkt_info,
+        entry.submit_time_us);
+    if (AR_FAILED(status))
+    {
+        return status;
+    }
+
+    __atomic_fetch_add(&data_log_async.num_users, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&data_log_async.enabled, __ATOMIC_SEQ_CST))
+    {
+        __atomic_fetch_sub(&data_log_async.num_users, 1, __ATOMIC_RELEASE);
+
+        status = _log_submit(&entry.info);
+        if (release_cb)
+        {
+            release_cb(cb_ctx, info->buffer, status);
+        }
+        return status;
+    }
+
+    __atomic_fetch_add(&data_log_async.num_queued, 1, __ATOMIC_RELAXED);
+    status = ar_mpsc_ring_push(&data_log_async.ring, &entry);
+    if (AR_FAILED(status))
+    {
+        __atomic_fetch_sub(&data_log_async.num_queued, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&data_log_async.num_dropped, 1, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        (void)_log_async_signal_worker();
+    }
+    __atomic_fetch_sub(&data_log_async.num_users, 1, __ATOMIC_RELEASE);
+
+    return status;
+}
+
+int32_t ar_data_log_flush(void)
+{
+    uint64_t target = __atomic_load_n(&data_log_async.num_queued, __ATOMIC_ACQUIRE);
+
+    while (__atomic_load_n(&data_log_async.enabled, __ATOMIC_ACQUIRE) &&
+        (__atomic_load_n(&data_log_async.num_logged, __ATOMIC_ACQUIRE) +
+         __atomic_load_n(&data_log_async.num_failed, __ATOMIC_ACQUIRE)) < target)
+    {
+        (void)ar_osal_micro_sleep(1000);
+    }
+
+    return AR_EOK;
+}
+
+int32_t ar_data_log_get_async_stats(ar_data_log_async_stats_t *stats)
+{
+    if (!stats)
+    {
+        return AR_EBADPARAM;
+    }
+
+    stats->num_queued = __atomic_load_n(&data_log_async.num_queued, __ATOMIC_RELAXED);
+    stats->num_logged = __atomic_load_n(&data_log_async.num_logged, __ATOMIC_RELAXED);
+    stats->num_failed = __atomic_load_n(&data_log_async.num_failed, __ATOMIC_RELAXED);
+    stats->num_dropped = __atomic_load_n(&data_log_async.num_dropped, __ATOMIC_RELAXED);
+    stats->max_latency_us = __atomic_load_n(&data_log_async.max_latency_us, __ATOMIC_RELAXED);
+    stats->queue_depth = AR_DATA_LOG_ASYNC_QUEUE_DEPTH;
+    stats->max_queued = __atomic_load_n(&data_log_async.max_queued, __ATOMIC_RELAXED);
+
+    return AR_EOK;
+}
+
+static int32_t _log_submit(ar_data_log_submit_info_t *info)
+{
+    int32_t     status = AR_EOK;
+    int8_t      *buffer_ptr = NULL;
+    uint32_t    remaining_buffer_size = 0;
+    void        *log_pkt = NULL;
+    uint32_t    log_pkt_size = 0;
+    uint32_t    max_log_pkt_size = 0;
+    uint8_t     interleaved = 0;
+    uint32_t    num_channels = 0;
+    bool_t      is_first_seg = TRUE;
+    fragment_info_t fragment = { 0 };
+
     status = _get_max_log_pkt_data_size(info->pkt_type, &max_log_pkt_size);
     if (AR_FAILED(status))
     {
@@ -449,6 +830,47 @@ void ar_data_log_free(void *log_pkt_payload_ptr, ar_log_pkt_type_t pkt_type)
 -------------------------------------------------------------------------------
 */
 
+/* Copies the submit info and its packet info, stamping the copy with now_us
+ * when the caller left the timestamp zero */
+static int32_t _log_copy_info(
+    ar_data_log_submit_info_t *info, ar_data_log_submit_info_t *info_copy,
+    data_log_pkt_info_u *pkt_info_copy, uint64_t now_us)
+{
+    *info_copy = *info;
+
+    switch (info->pkt_type)
+    {
+    case AR_DATA_LOG_PKT_TYPE_AUDIO_BITSTREAM:
+    case AR_DATA_LOG_PKT_TYPE_AUDIO_PCM:
+        if (!info->pkt_info)
+            break;
+        pkt_info_copy->pcm = *(ar_data_log_pcm_pkt_info_t *)info->pkt_info;
+        if (0 == pkt_info_copy->pcm.log_time_stamp)
+            pkt_info_copy->pcm.log_time_stamp = now_us;
+        info_copy->pkt_info = &pkt_info_copy->pcm;
+        return AR_EOK;
+    case AR_DATA_LOG_PKT_TYPE_GENERIC:
+        if (!info->pkt_info)
+            break;
+        pkt_info_copy->generic = *(ar_data_log_generic_pkt_info_t *)info->pkt_info;
+        if (0 == pkt_info_copy->generic.log_time_stamp)
+            pkt_info_copy->generic.log_time_stamp = now_us;
+        info_copy->pkt_info = &pkt_info_copy->generic;
+        return AR_EOK;
+    case AR_DATA_LOG_PKT_TYPE_RAW:
+        info_copy->pkt_info = NULL;
+        return AR_EOK;
+    default:
+        AR_DATA_LOG_ERR("Status[%d]: Unsupported packet type %d",
+            AR_EUNSUPPORTED, info->pkt_type);
+        return AR_EUNSUPPORTED;
+    }
+
+    AR_DATA_LOG_ERR("Status[%d]: Packet info is null for packet type %d",
+        AR_EBADPARAM, info->pkt_type);
+    return AR_EBADPARAM;
+}
+
 int32_t _get_max_log_pkt_data_size(
     ar_log_pkt_type_t pkt_type, uint32_t *max_log_pkt_data_size)
 {
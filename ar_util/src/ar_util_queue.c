@@ -0,0 +1,324 @@
+/**
+ * \file ar_util_queue.c
+ * \brief
+ *        This file contains the implementation for the lock-free rings and
+ *        the object free-stack.
+ * \copyright
+ *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ar_util_queue.h"
+#include "ar_osal_error.h"
+
+#define AR_QUEUE_IS_POW2(x) ((0 != (x)) && (0 == ((x) & ((x) - 1))))
+
+/* Offset of the element within an MPSC slot, after the sequence header */
+#define AR_MPSC_SLOT_HDR_SIZE ((uint32_t)sizeof(uint64_t))
+
+#define AR_FREE_STACK_GEN(head)   ((uint32_t)((head) >> 32))
+#define AR_FREE_STACK_IDX(head)   ((uint32_t)(head))
+#define AR_FREE_STACK_HEAD(gen, idx) (((uint64_t)(gen) << 32) | (uint64_t)(idx))
+
+/*
+ * SPSC ring
+ *
+ * head and tail run freely and wrap at 2^32, the slot is index & mask.
+ * The producer publishes an element by storing head with release semantics
+ * after copying it in, the consumer frees a slot by storing tail after
+ * copying it out. Each side re-reads the other's index only when its
+ * cached copy says the ring is full or empty.
+ */
+int32_t ar_spsc_ring_init(ar_spsc_ring_t *ring, void *storage,
+	uint32_t elem_size, uint32_t num_elems)
+{
+	if (NULL == ring || NULL == storage || 0 == elem_size ||
+		!AR_QUEUE_IS_POW2(num_elems))
+	{
+		return AR_EBADPARAM;
+	}
+
+	memset(ring, 0, sizeof(*ring));
+	ring->buf = (uint8_t *)storage;
+	ring->elem_size = elem_size;
+	ring->mask = num_elems - 1;
+
+	return AR_EOK;
+}
+
+int32_t ar_spsc_ring_push(ar_spsc_ring_t *ring, const void *elem)
+{
+	uint32_t head;
+
+	if (NULL == ring || NULL == elem)
+	{
+		return AR_EBADPARAM;
+	}
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	if (head - ring->cached_tail > ring->mask)
+	{
+		ring->cached_tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		if (head - ring->cached_tail > ring->mask)
+		{
+			return AR_ENORESOURCE;
+		}
+	}
+
+	memcpy(ring->buf + (size_t)(head & ring->mask) * ring->elem_size,
+		elem, ring->elem_size);
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+	return AR_EOK;
+}
+
+int32_t ar_spsc_ring_pop(ar_spsc_ring_t *ring, void *elem)
+{
+	uint32_t tail;
+
+	if (NULL == ring || NULL == elem)
+	{
+		return AR_EBADPARAM;
+	}
+
+	tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	if (tail == ring->cached_head)
+	{
+		ring->cached_head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		if (tail == ring->cached_head)
+		{
+			return AR_ENOTEXIST;
+		}
+	}
+
+	memcpy(elem, ring->buf + (size_t)(tail & ring->mask) * ring->elem_size,
+		ring->elem_size);
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+	return AR_EOK;
+}
+
+uint32_t ar_spsc_ring_get_count(ar_spsc_ring_t *ring)
+{
+	uint32_t tail;
+
+	if (NULL == ring)
+	{
+		return 0;
+	}
+
+	tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+}
+
+/*
+ * MPSC ring
+ *
+ * Slot i starts with sequence i. A producer claims position pos when the
+ * slot's sequence equals pos, by advancing enqueue_pos with a CAS, and
+ * publishes the element by setting the sequence to pos + 1. The consumer
+ * reads position pos once the sequence is pos + 1 and hands the slot to
+ * the next lap by setting it to pos + num_elems.
+ */
+static inline uint32_t *ar_mpsc_ring_slot_seq(ar_mpsc_ring_t *ring, uint32_t pos)
+{
+	return (uint32_t *)(ring->slots + (size_t)(pos & ring->mask) * ring->slot_size);
+}
+
+int32_t ar_mpsc_ring_init(ar_mpsc_ring_t *ring, void *storage,
+	uint32_t elem_size, uint32_t num_elems)
+{
+	if (NULL == ring || NULL == storage || 0 == elem_size ||
+		!AR_QUEUE_IS_POW2(num_elems) || ((uintptr_t)storage & 7))
+	{
+		return AR_EBADPARAM;
+	}
+
+	memset(ring, 0, sizeof(*ring));
+	ring->slots = (uint8_t *)storage;
+	ring->elem_size = elem_size;
+	ring->slot_size = AR_MPSC_RING_SLOT_SIZE(elem_size);
+	ring->mask = num_elems - 1;
+
+	for (uint32_t i = 0; i < num_elems; i++)
+	{
+		__atomic_store_n(ar_mpsc_ring_slot_seq(ring, i), i, __ATOMIC_RELAXED);
+	}
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	return AR_EOK;
+}
+
+int32_t ar_mpsc_ring_push(ar_mpsc_ring_t *ring, const void *elem)
+{
+	uint32_t *seq_ptr;
+	uint32_t pos;
+	int32_t diff;
+
+	if (NULL == ring || NULL == elem)
+	{
+		return AR_EBADPARAM;
+	}
+
+	pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+	for (;;)
+	{
+		seq_ptr = ar_mpsc_ring_slot_seq(ring, pos);
+		diff = (int32_t)(__atomic_load_n(seq_ptr, __ATOMIC_ACQUIRE) - pos);
+		if (0 == diff)
+		{
+			if (__atomic_compare_exchange_n(&ring->enqueue_pos, &pos, pos + 1,
+				TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			{
+				break;
+			}
+			/* lost the race, pos now holds the current enqueue_pos */
+		}
+		else if (diff < 0)
+		{
+			/* the consumer has not released this slot from the last lap */
+			return AR_ENORESOURCE;
+		}
+		else
+		{
+			pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+		}
+	}
+
+	memcpy((uint8_t *)seq_ptr + AR_MPSC_SLOT_HDR_SIZE, elem, ring->elem_size);
+	__atomic_store_n(seq_ptr, pos + 1, __ATOMIC_RELEASE);
+
+	return AR_EOK;
+}
+
+int32_t ar_mpsc_ring_pop(ar_mpsc_ring_t *ring, void *elem)
+{
+	uint32_t *seq_ptr;
+	uint32_t pos;
+
+	if (NULL == ring || NULL == elem)
+	{
+		return AR_EBADPARAM;
+	}
+
+	pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+	seq_ptr = ar_mpsc_ring_slot_seq(ring, pos);
+	if (__atomic_load_n(seq_ptr, __ATOMIC_ACQUIRE) != pos + 1)
+	{
+		return AR_ENOTEXIST;
+	}
+
+	memcpy(elem, (uint8_t *)seq_ptr + AR_MPSC_SLOT_HDR_SIZE, ring->elem_size);
+	__atomic_store_n(seq_ptr, pos + ring->mask + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&ring->dequeue_pos, pos + 1, __ATOMIC_RELAXED);
+
+	return AR_EOK;
+}
+
+/*
+ * Free-stack
+ *
+ * Objects are named by index + 1 so that 0 ends the chain. A free object
+ * holds the name of the next free object in its first word. Every push and
+ * pop bumps the generation in the head, so a pop that read a stale next
+ * link cannot succeed after the object was taken and returned meanwhile.
+ */
+int32_t ar_free_stack_init(ar_free_stack_t *stack, void *pool,
+	uint32_t obj_size, uint32_t num_objs)
+{
+	uint8_t *obj;
+
+	if (NULL == stack || NULL == pool || 0 == obj_size || 0 == num_objs ||
+		(obj_size & 3) || ((uintptr_t)pool & 3) || UINT32_MAX == num_objs)
+	{
+		return AR_EBADPARAM;
+	}
+
+	memset(stack, 0, sizeof(*stack));
+	stack->pool = (uint8_t *)pool;
+	stack->obj_size = obj_size;
+	stack->num_objs = num_objs;
+
+	for (uint32_t i = 0; i < num_objs; i++)
+	{
+		obj = stack->pool + (size_t)i * obj_size;
+		*(uint32_t *)obj = (i + 1 < num_objs) ? i + 2 : 0;
+	}
+	__atomic_store_n(&stack->count, num_objs, __ATOMIC_RELAXED);
+	__atomic_store_n(&stack->head, AR_FREE_STACK_HEAD(0, 1), __ATOMIC_RELEASE);
+
+	return AR_EOK;
+}
+
+void *ar_free_stack_pop(ar_free_stack_t *stack)
+{
+	uint64_t old_head;
+	uint64_t new_head;
+	uint32_t idx;
+	uint32_t next;
+	uint8_t *obj;
+
+	if (NULL == stack)
+	{
+		return NULL;
+	}
+
+	old_head = __atomic_load_n(&stack->head, __ATOMIC_ACQUIRE);
+	do
+	{
+		idx = AR_FREE_STACK_IDX(old_head);
+		if (0 == idx)
+		{
+			return NULL;
+		}
+		obj = stack->pool + (size_t)(idx - 1) * stack->obj_size;
+		/* may be stale if another thread owns obj by now, the CAS catches it */
+		next = __atomic_load_n((uint32_t *)obj, __ATOMIC_RELAXED);
+		new_head = AR_FREE_STACK_HEAD(AR_FREE_STACK_GEN(old_head) + 1, next);
+	} while (!__atomic_compare_exchange_n(&stack->head, &old_head, new_head,
+		TRUE, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+	__atomic_fetch_sub(&stack->count, 1, __ATOMIC_RELAXED);
+	return obj;
+}
+
+int32_t ar_free_stack_push(ar_free_stack_t *stack, void *obj)
+{
+	uint64_t old_head;
+	uint64_t new_head;
+	size_t offset;
+	uint32_t idx;
+
+	if (NULL == stack || NULL == obj || (uint8_t *)obj < stack->pool)
+	{
+		return AR_EBADPARAM;
+	}
+	offset = (size_t)((uint8_t *)obj - stack->pool);
+	if ((offset % stack->obj_size) ||
+		(offset / stack->obj_size) >= stack->num_objs)
+	{
+		return AR_EBADPARAM;
+	}
+	idx = (uint32_t)(offset / stack->obj_size) + 1;
+
+	/* count before publishing so a racing pop never takes it below zero */
+	__atomic_fetch_add(&stack->count, 1, __ATOMIC_RELAXED);
+	old_head = __atomic_load_n(&stack->head, __ATOMIC_RELAXED);
+	do
+	{
+		__atomic_store_n((uint32_t *)obj, AR_FREE_STACK_IDX(old_head), __ATOMIC_RELAXED);
+		new_head = AR_FREE_STACK_HEAD(AR_FREE_STACK_GEN(old_head) + 1, idx);
+	} while (!__atomic_compare_exchange_n(&stack->head, &old_head, new_head,
+		TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	return AR_EOK;
+}
+
+uint32_t ar_free_stack_get_count(ar_free_stack_t *stack)
+{
+	if (NULL == stack)
+	{
+		return 0;
+	}
+	return __atomic_load_n(&stack->count, __ATOMIC_RELAXED);
+}
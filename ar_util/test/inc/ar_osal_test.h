@@ -11,13 +11,18 @@ void ar_test_file_main();
 void ar_test_shmem_main();
 
 void ar_test_util_list_main();
+void ar_test_queue_main();
 
 void ar_test_mutex_thread_main();
 
 void ar_test_signal_thread_main();
 
+void ar_test_signal2_thread_main();
+
 void ar_test_sleep_main();
 
+void ar_test_timer_main();
+
 void ar_test_servreg_main();
 
 void ar_test_heap_main();
@@ -28,3 +33,5 @@ void ar_test_string_main();
 
 void ar_test_data_log_main();
 
+void ar_test_log_main();
+
@@ -73,6 +73,30 @@ void ar_test_mutex_thread_main()
 		AR_LOG_ERR(LOG_TAG,"ar_osal_mutex_destroy destroy failed(%d)", status);
 	}
 
+	/* priority inheritance with adaptive spinning, and an embedded mutex */
+	{
+		ar_osal_mutex_attr_t mutex_attr = { AR_OSAL_MUTEX_ATTR_PRIO_INHERIT | AR_OSAL_MUTEX_ATTR_ADAPTIVE, 0 };
+		static ar_osal_mutex_storage_t mutex_storage = AR_OSAL_MUTEX_STATIC_INIT;
+
+		status = ar_osal_mutex_create_v2(&ghMutex, &mutex_attr);
+		if (AR_EOK != status)
+		{
+			AR_LOG_ERR(LOG_TAG,"ar_osal_mutex_create_v2 error: %d", status);
+			goto end;
+		}
+		ar_osal_mutex_lock(ghMutex);
+		ar_osal_mutex_unlock(ghMutex);
+		ar_osal_mutex_destroy(ghMutex);
+
+		ar_osal_mutex_lock(&mutex_storage);
+		ar_osal_mutex_unlock(&mutex_storage);
+		status = ar_osal_mutex_deinit(&mutex_storage);
+		if (AR_EOK != status)
+		{
+			AR_LOG_ERR(LOG_TAG,"ar_osal_mutex_deinit on static storage failed(%d)", status);
+		}
+	}
+
 	/* fuzz test*/
 	ar_osal_mutex_lock(NULL);
 	ar_osal_mutex_unlock(NULL);
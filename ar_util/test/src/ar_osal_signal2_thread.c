@@ -0,0 +1,70 @@
+/*
+*  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+*  SPDX-License-Identifier: BSD-3-Clause
+*/
+#include <stdio.h>
+#include "ar_osal_types.h"
+#include "ar_osal_signal2.h"
+#include "ar_osal_thread.h"
+#include "ar_osal_sleep.h"
+#include "ar_osal_error.h"
+#include "ar_osal_test.h"
+#include "ar_osal_log.h"
+
+#define SIGNAL2_DATA_READY  (0x1)
+#define SIGNAL2_STOP        (0x2)
+
+static ar_osal_signal2_t gSignal2 = NULL;
+
+static int32_t Signal2SetterProc(void *arg)
+{
+	(void)arg;
+	ar_osal_micro_sleep(10000);
+	(void)ar_osal_signal2_set(gSignal2, SIGNAL2_DATA_READY);
+	ar_osal_micro_sleep(10000);
+	(void)ar_osal_signal2_set(gSignal2, SIGNAL2_STOP);
+	return 0;
+}
+
+void ar_test_signal2_thread_main()
+{
+	ar_osal_thread_attr_t osal_thread_attr = { NULL, 1024, 0 };
+	ar_osal_thread_t setter = NULL;
+	uint32_t signals = 0;
+	int32_t status;
+
+	status = ar_osal_signal2_create(&gSignal2);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "ar_osal_signal2_create failed (%d)", status);
+		return;
+	}
+
+	status = ar_osal_thread_attr_init(&osal_thread_attr);
+	if (AR_EOK == status)
+		status = ar_osal_thread_create(&setter, &osal_thread_attr,
+			(ar_osal_thread_start_routine)Signal2SetterProc, NULL);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "ar_osal_thread_create error: %d", status);
+		goto end;
+	}
+
+	signals = ar_osal_signal2_wait_any(gSignal2, SIGNAL2_DATA_READY | SIGNAL2_STOP);
+	AR_LOG_DEBUG(LOG_TAG, "wait_any returned signals 0x%x", signals);
+
+	signals = ar_osal_signal2_wait_all(gSignal2, SIGNAL2_DATA_READY | SIGNAL2_STOP);
+	if ((SIGNAL2_DATA_READY | SIGNAL2_STOP) != signals)
+		AR_LOG_ERR(LOG_TAG, "wait_all returned signals 0x%x", signals);
+
+	(void)ar_osal_thread_join_destroy(setter);
+
+	(void)ar_osal_signal2_clear(gSignal2, SIGNAL2_DATA_READY | SIGNAL2_STOP);
+	status = ar_osal_signal2_timedwait_any(gSignal2, SIGNAL2_DATA_READY, 1000000, &signals);
+	if (AR_ETIMEOUT != status)
+		AR_LOG_ERR(LOG_TAG, "timedwait_any on cleared signal returned %d", status);
+
+end:
+	(void)ar_osal_signal2_destroy(gSignal2);
+	gSignal2 = NULL;
+}
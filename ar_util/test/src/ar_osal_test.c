@@ -21,11 +21,21 @@ void main()
 	ar_test_signal_thread_main();
 	AR_LOG_DEBUG(LOG_TAG," signal thread test case ended ");
 	AR_LOG_DEBUG(LOG_TAG,"*******************************************************************");
+	AR_LOG_DEBUG(LOG_TAG," signal2 thread test case starting ");
+	/* signal2 thread test case*/
+	ar_test_signal2_thread_main();
+	AR_LOG_DEBUG(LOG_TAG," signal2 thread test case ended ");
+	AR_LOG_DEBUG(LOG_TAG,"*******************************************************************");
 	AR_LOG_DEBUG(LOG_TAG," list test case starting ");
 	/* list test case*/
 	ar_test_util_list_main();
 	AR_LOG_DEBUG(LOG_TAG," list test case ended ");
 	AR_LOG_DEBUG(LOG_TAG,"*******************************************************************");
+	AR_LOG_DEBUG(LOG_TAG," queue test case starting ");
+	/* lock-free ring and free-stack test case*/
+	ar_test_queue_main();
+	AR_LOG_DEBUG(LOG_TAG," queue test case ended ");
+	AR_LOG_DEBUG(LOG_TAG,"*******************************************************************");
 	AR_LOG_DEBUG(LOG_TAG," shmem test case starting ");
 	/* shmem test case*/
 	ar_test_shmem_main();
@@ -41,6 +51,11 @@ void main()
 	ar_test_sleep_main();
 	AR_LOG_DEBUG(LOG_TAG, " sleep test case ended ");
 	AR_LOG_DEBUG(LOG_TAG, "*******************************************************************");
+	AR_LOG_DEBUG(LOG_TAG, " timer test case starting ");
+	/* timer test case*/
+	ar_test_timer_main();
+	AR_LOG_DEBUG(LOG_TAG, " timer test case ended ");
+	AR_LOG_DEBUG(LOG_TAG, "*******************************************************************");
 	AR_LOG_DEBUG(LOG_TAG, " Servreg test case starting ");
 	/* Servreg test case*/
 	ar_test_servreg_main();
@@ -65,6 +80,11 @@ void main()
     /* data log test case*/
     ar_test_data_log_main();
     AR_LOG_DEBUG(LOG_TAG, " data logging test case ended ");
+    AR_LOG_DEBUG(LOG_TAG, "*******************************************************************");
+    AR_LOG_DEBUG(LOG_TAG, " log test case starting ");
+    /* asynchronous log ordering and flush on deinit test case*/
+    ar_test_log_main();
+    AR_LOG_DEBUG(LOG_TAG, " log test case ended ");
     AR_LOG_DEBUG(LOG_TAG, "*******************************************************************");
 
 
@@ -59,6 +59,7 @@ int32_t ar_test_pcm_data_logging(ar_heap_info *heap_info);
 int32_t ar_test_bitstream_data_logging(ar_heap_info *heap_info);
 int32_t ar_test_generic_data_logging(ar_heap_info *heap_info);
 int32_t ar_test_raw_data_logging(ar_heap_info *heap_info);
+int32_t ar_test_async_data_logging(ar_heap_info *heap_info);
 int32_t ar_util_test_data_log_file_read(
     const char_t *file, uint32_t file_access,
     void *read_data, size_t read_size, size_t *file_size, size_t *bytes_read);
@@ -162,6 +163,11 @@ void ar_test_data_log_submit()
     ar_fdelete(file);
     ar_test_raw_data_logging(&heap_info);
     if (AR_SUCCEEDED(status)) num_tests++;
+
+    /* Async Logging:       Queue buffers to the logging thread */
+    ar_fdelete(file);
+    ar_test_async_data_logging(&heap_info);
+    if (AR_SUCCEEDED(status)) num_tests++;
 }
 
 void ar_test_data_log_commit()
@@ -748,6 +754,123 @@ end:
     return status;
 }
 
+typedef struct ar_test_async_ctx_t
+{
+    int8_t *buffer;
+    uint32_t num_released;
+    int32_t status;
+}ar_test_async_ctx_t;
+
+static void ar_test_async_release(void *cb_ctx, int8_t *buffer, int32_t status)
+{
+    ar_test_async_ctx_t *ctx = (ar_test_async_ctx_t*)cb_ctx;
+
+    if (buffer != ctx->buffer && AR_SUCCEEDED(ctx->status))
+        ctx->status = AR_EFAILED;
+    if (AR_FAILED(status))
+        ctx->status = status;
+    ctx->num_released++;
+}
+
+int32_t ar_test_async_data_logging(ar_heap_info *heap_info)
+{
+    int32_t status = AR_EOK;
+    uint32_t num_buffers = 8;
+    ar_test_buffer_t data_buffer = { 0 };
+    ar_data_log_generic_pkt_info_t pkt_info = { 0 };
+    ar_data_log_submit_info_t submit_info = { 0 };
+    ar_data_log_async_stats_t stats = { 0 };
+    ar_test_async_ctx_t ctx = { 0 };
+
+    data_buffer.size = 256;
+    data_buffer.buffer = ar_heap_malloc(data_buffer.size, heap_info);
+    if (!data_buffer.buffer)
+    {
+        return AR_ENOMEMORY;
+    }
+    for (uint32_t i = 0; i < data_buffer.size; i++)
+    {
+        ((uint8_t*)data_buffer.buffer)[i] = (uint8_t)i;
+    }
+
+    status = ar_data_log_set_async(TRUE);
+    if (AR_FAILED(status))
+    {
+        AR_DATA_LOG_TEST_ERR("Status[%d]: "
+            "Failed to enable async logging", status);
+        goto end;
+    }
+
+    pkt_info.format = AR_LOG_PKT_GENERIC_FMT_CAL_BLOB;
+
+    submit_info.buffer = (int8_t*)data_buffer.buffer;
+    submit_info.buffer_size = (uint32_t)data_buffer.size;
+    submit_info.pkt_info = &pkt_info;
+    submit_info.pkt_type = AR_DATA_LOG_PKT_TYPE_GENERIC;
+    submit_info.log_code = AR_DATA_LOG_CODE_ATS;
+
+    ctx.buffer = submit_info.buffer;
+
+    /* pkt_info goes out of scope in real callers, it must be copied */
+    for (uint32_t i = 0; i < num_buffers; i++)
+    {
+        status = ar_data_log_submit_async(
+            &submit_info, ar_test_async_release, &ctx);
+        if (AR_FAILED(status))
+        {
+            AR_DATA_LOG_TEST_ERR("Status[%d]: "
+                "Failed to queue buffer %d", status, i);
+            goto disable;
+        }
+    }
+
+    status = ar_data_log_flush();
+    if (AR_FAILED(status))
+    {
+        goto disable;
+    }
+
+    status = ar_data_log_get_async_stats(&stats);
+    if (AR_SUCCEEDED(status) && (ctx.num_released != num_buffers ||
+        stats.num_logged + stats.num_failed != stats.num_queued))
+    {
+        AR_DATA_LOG_TEST_ERR("Released %d of %d buffers, "
+            "queued %llu logged %llu failed %llu", ctx.num_released,
+            num_buffers, (unsigned long long)stats.num_queued,
+            (unsigned long long)stats.num_logged,
+            (unsigned long long)stats.num_failed);
+        status = AR_EFAILED;
+    }
+    if (AR_SUCCEEDED(status))
+    {
+        status = ctx.status;
+    }
+
+disable:
+    (void)ar_data_log_set_async(FALSE);
+
+    /* with async off the buffer is logged and released before returning */
+    if (AR_SUCCEEDED(status))
+    {
+        ctx.num_released = 0;
+        status = ar_data_log_submit_async(
+            &submit_info, ar_test_async_release, &ctx);
+        if (AR_SUCCEEDED(status) && 1 != ctx.num_released)
+            status = AR_EFAILED;
+    }
+
+end:
+    if (data_buffer.buffer)
+        ar_heap_free(data_buffer.buffer, heap_info);
+
+    if (AR_FAILED(status))
+    {
+        AR_DATA_LOG_TEST_ERR("Status[%d]: "
+            "Async Packet Logging test failed", status);
+    }
+    return status;
+}
+
 int32_t ar_test_raw_data_logging(ar_heap_info *heap_info)
 {
     int32_t status = AR_EOK;
@@ -7,53 +7,138 @@
 #include "ar_osal_log.h"
 #include "ar_osal_types.h"
 #include "ar_osal_error.h"
+#include <stdlib.h>
+
+/* Logs and aborts on failure, independent of NDEBUG */
+#define AR_TEST_HEAP_CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			AR_LOG_ERR(LOG_TAG, "%s:%d check failed: %s", __func__, __LINE__, #cond); \
+			abort(); \
+		} \
+	} while (0)
+
+static ar_heap_tag_stats ar_test_heap_tag_stats(uint32_t tag)
+{
+	ar_heap_tag_stats tag_stats[AR_HEAP_MAX_TAGS];
+	ar_heap_tag_stats found = { 0 };
+	uint32_t num_tags = 0;
+
+	AR_TEST_HEAP_CHECK(AR_EOK == ar_heap_get_tag_stats(tag_stats, AR_HEAP_MAX_TAGS, &num_tags));
+	for (uint32_t i = 0; i < num_tags && i < AR_HEAP_MAX_TAGS; i++)
+	{
+		if (tag_stats[i].tag == tag)
+			found = tag_stats[i];
+	}
+	return found;
+}
+
 
 void ar_test_heap_main()
 {
-	int32_t status = AR_EOK;
 	void* pBuff = NULL;
 	size_t BuffSize = 4096;
 	ar_heap_info heap_info = { AR_HEAP_ALIGN_DEFAULT, AR_HEAP_ID_DEFAULT,AR_HEAP_POOL_DEFAULT, AR_HEAP_TAG_DEFAULT };
+	ar_heap_info test_info = { AR_HEAP_ALIGN_DEFAULT, AR_HEAP_POOL_DEFAULT, AR_HEAP_ID_DEFAULT, 0x31545354 };
+	ar_heap_tag_stats before, after;
 	int32_t* IntPtr;
-	status = ar_heap_init();
-	if (AR_EOK != status)
-	{
-		AR_LOG_ERR(LOG_TAG, "failed ar_heap_init %d ", status);
-		goto end;
-	}
+
+	AR_TEST_HEAP_CHECK(AR_EOK == ar_heap_init());
 
 	pBuff = ar_heap_malloc(BuffSize, &heap_info);
-	if (NULL == pBuff)
-	{
-		AR_LOG_ERR(LOG_TAG, "failed ar_heap_malloc: size%d ", BuffSize);
-		goto end;
-	}
+	AR_TEST_HEAP_CHECK(NULL != pBuff);
 	IntPtr = (int32_t*)pBuff;
 	AR_LOG_DEBUG(LOG_TAG, "allocated address: 0x%p, size: 0x%x alignment:8 0x%p", pBuff, BuffSize, ((uintptr_t)pBuff % 8));
 	AR_LOG_DEBUG(LOG_TAG, " value [0]:%d,[1]:%d,[2]:%d,[3]:%d, ", IntPtr[0], IntPtr[1], IntPtr[2], IntPtr[3]);
 	ar_heap_free(pBuff, &heap_info);
 
-	pBuff = NULL;
 	BuffSize = 32;
 	pBuff = ar_heap_calloc(BuffSize, &heap_info);
-	if (NULL == pBuff)
-	{
-		AR_LOG_ERR(LOG_TAG, "failed ar_heap_calloc: size%d ", BuffSize);
-		goto end;
-	}
-
+	AR_TEST_HEAP_CHECK(NULL != pBuff);
 	IntPtr = (int32_t*)pBuff;
-	AR_LOG_DEBUG(LOG_TAG, "allocated address: 0x%p, size: 0x%x alignment:8 0x%p", pBuff, BuffSize, ((uintptr_t)pBuff % 8));
-	AR_LOG_DEBUG(LOG_TAG, " value [0]:%d,[1]:%d,[2]:%d,[3]:%d, ", IntPtr[0], IntPtr[1], IntPtr[2], IntPtr[3]);
+	AR_TEST_HEAP_CHECK(0 == IntPtr[0] && 0 == IntPtr[7]);
+	ar_heap_free(pBuff, &heap_info);
+
+	/* default pool blocks of any size stay compatible with the system allocator */
+	pBuff = ar_heap_malloc(BuffSize, &heap_info);
+	AR_TEST_HEAP_CHECK(NULL != pBuff);
+	free(pBuff);
+	pBuff = ar_heap_malloc(8192, &heap_info);
+	AR_TEST_HEAP_CHECK(NULL != pBuff);
+	pBuff = realloc(pBuff, 16384);
+	AR_TEST_HEAP_CHECK(NULL != pBuff);
+	free(pBuff);
 
+	/* memory is uncharged from the tag it was allocated with */
+	before = ar_test_heap_tag_stats(test_info.tag);
+	pBuff = ar_heap_malloc(100, &test_info);
+	AR_TEST_HEAP_CHECK(NULL != pBuff);
+	after = ar_test_heap_tag_stats(test_info.tag);
+	AR_TEST_HEAP_CHECK(after.bytes_in_use == before.bytes_in_use + 100);
+	AR_TEST_HEAP_CHECK(after.num_allocs == before.num_allocs + 1);
 	ar_heap_free(pBuff, &heap_info);
+	after = ar_test_heap_tag_stats(test_info.tag);
+	AR_TEST_HEAP_CHECK(after.bytes_in_use == before.bytes_in_use);
+	AR_TEST_HEAP_CHECK(after.num_frees == before.num_frees + 1);
 
-	status = ar_heap_deinit();
-	if (AR_EOK != status)
+	/* foreign pointers are rejected without touching the counters */
+	pBuff = malloc(BuffSize);
+	AR_TEST_HEAP_CHECK(NULL != pBuff);
+	before = ar_test_heap_tag_stats(test_info.tag);
+	ar_heap_free(pBuff, &test_info);
+	after = ar_test_heap_tag_stats(test_info.tag);
+	AR_TEST_HEAP_CHECK(after.bytes_in_use == before.bytes_in_use);
+	AR_TEST_HEAP_CHECK(after.num_frees == before.num_frees);
+	free(pBuff);
+
+	/* powers of two beyond the enum are taken as a byte alignment */
+	ar_heap_info align_info = test_info;
+	align_info.align_bytes = (ar_heap_align_bytes)64;
+	pBuff = ar_heap_malloc(BuffSize, &align_info);
+	AR_TEST_HEAP_CHECK(NULL != pBuff && 0 == ((uintptr_t)pBuff % 64));
+	ar_heap_free(pBuff, &align_info);
+	align_info.align_bytes = AR_HEAP_ALIGN_16_BYTES;
+	pBuff = ar_heap_malloc(BuffSize, &align_info);
+	AR_TEST_HEAP_CHECK(NULL != pBuff && 0 == ((uintptr_t)pBuff % 16));
+	ar_heap_free(pBuff, &align_info);
+
+	/* slab allocations freed together are fully uncharged */
+	ar_heap_info slab_info = test_info;
+	void *small_buffs[512];
+	slab_info.pool_type = AR_HEAP_POOL_SLAB;
+	before = ar_test_heap_tag_stats(test_info.tag);
+	for (uint32_t i = 0; i < 512; i++)
+	{
+		small_buffs[i] = ar_heap_malloc(64, &slab_info);
+		AR_TEST_HEAP_CHECK(NULL != small_buffs[i] && 0 == ((uintptr_t)small_buffs[i] % 16));
+	}
+	after = ar_test_heap_tag_stats(test_info.tag);
+	AR_TEST_HEAP_CHECK(after.bytes_in_use == before.bytes_in_use + 512 * 64);
+	for (uint32_t i = 0; i < 512; i++)
+		ar_heap_free(small_buffs[i], &heap_info);
+	after = ar_test_heap_tag_stats(test_info.tag);
+	AR_TEST_HEAP_CHECK(after.bytes_in_use == before.bytes_in_use);
+	AR_TEST_HEAP_CHECK(after.num_frees == before.num_frees + 512);
+
+	/* arena allocations are released in bulk and accounted to their tag */
+	ar_heap_info arena_info = { AR_HEAP_ALIGN_DEFAULT, AR_HEAP_POOL_ARENA, AR_HEAP_ID_DEFAULT, 0x54534554 };
+	AR_TEST_HEAP_CHECK(AR_EOK == ar_heap_arena_create(arena_info.tag, 0));
+	for (uint32_t i = 0; i < 100; i++)
 	{
-		AR_LOG_ERR(LOG_TAG, "failed ar_heap_deinit %d ", status);
-		goto end;
+		pBuff = ar_heap_malloc(BuffSize * (i + 1), &arena_info);
+		AR_TEST_HEAP_CHECK(NULL != pBuff && 0 == ((uintptr_t)pBuff % 16));
+		ar_heap_free(pBuff, &arena_info);
 	}
-end:
-	return;
+	align_info = arena_info;
+	align_info.align_bytes = (ar_heap_align_bytes)256;
+	pBuff = ar_heap_malloc(BuffSize, &align_info);
+	AR_TEST_HEAP_CHECK(NULL != pBuff && 0 == ((uintptr_t)pBuff % 256));
+	after = ar_test_heap_tag_stats(arena_info.tag);
+	AR_TEST_HEAP_CHECK(0 != after.bytes_in_use);
+	AR_TEST_HEAP_CHECK(AR_EOK == ar_heap_arena_reset(arena_info.tag));
+	after = ar_test_heap_tag_stats(arena_info.tag);
+	AR_TEST_HEAP_CHECK(0 == after.bytes_in_use && after.num_allocs == after.num_frees);
+	AR_TEST_HEAP_CHECK(AR_EOK == ar_heap_arena_destroy(arena_info.tag));
+
+	AR_TEST_HEAP_CHECK(AR_EOK == ar_heap_deinit());
 }
@@ -0,0 +1,152 @@
+/*
+*  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+*  SPDX-License-Identifier: BSD-3-Clause
+*/
+#include <stdio.h>
+#include <string.h>
+#include "ar_osal_types.h"
+#include "ar_osal_mutex.h"
+#include "ar_osal_thread.h"
+#include "ar_osal_error.h"
+#include "ar_osal_log.h"
+#include "ar_osal_test.h"
+
+#define LOG_TEST_MSGS_PER_THREAD  (32)
+#define LOG_TEST_MAX_MSGS         (4 * LOG_TEST_MSGS_PER_THREAD)
+#define LOG_TEST_MSG_LEN          (256)
+
+static ar_osal_mutex_t log_test_lock;
+static char_t log_test_msgs[LOG_TEST_MAX_MSGS][LOG_TEST_MSG_LEN];
+static uint32_t log_test_num_msgs;
+
+static void log_test_writer(uint32_t level, const char_t *log_tag, const char_t *msg)
+{
+	(void)level;
+	if (NULL == log_tag || strcmp(log_tag, LOG_TAG))
+		return;
+	ar_osal_mutex_lock(log_test_lock);
+	if (log_test_num_msgs < LOG_TEST_MAX_MSGS)
+	{
+		strncpy(log_test_msgs[log_test_num_msgs], msg, LOG_TEST_MSG_LEN - 1);
+		log_test_msgs[log_test_num_msgs][LOG_TEST_MSG_LEN - 1] = '\0';
+		log_test_num_msgs++;
+	}
+	ar_osal_mutex_unlock(log_test_lock);
+}
+
+static void log_test_emit(char_t id, uint32_t seq)
+{
+	/* the same line for both modes, so their output can be compared */
+	AR_LOG_INFO(LOG_TAG, "log test %c %u %s", id, seq, "str");
+}
+
+static void log_test_thread(void *arg)
+{
+	for (uint32_t i = 0; i < LOG_TEST_MSGS_PER_THREAD; i++)
+		log_test_emit(*(char_t *)arg, i);
+}
+
+/* Returns the sequence number of message idx if it was logged by id, else -1 */
+static int32_t log_test_seq(uint32_t idx, char_t id)
+{
+	const char_t *body = strstr(log_test_msgs[idx], "log test ");
+	char_t msg_id;
+	uint32_t seq;
+
+	if (NULL == body || 2 != sscanf(body, "log test %c %u", &msg_id, &seq) || msg_id != id)
+		return -1;
+	return (int32_t)seq;
+}
+
+void ar_test_log_main()
+{
+	int32_t status;
+	ar_osal_thread_t thread = NULL;
+	ar_osal_thread_attr_t thread_attr;
+	char_t sync_msg[LOG_TEST_MSG_LEN];
+	char_t thread_id = 'B';
+	int32_t next_a = 0, next_b = 0, seq;
+	bool_t a_seen = FALSE, ok = TRUE;
+
+	status = ar_osal_mutex_create(&log_test_lock);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "ar_osal_mutex_create error: %d", status);
+		return;
+	}
+	ar_log_set_writer(log_test_writer);
+
+	/* synchronous reference line */
+	log_test_emit('S', 0);
+
+	status = ar_log_set_async(TRUE);
+	if (AR_EOK != status)
+	{
+		ar_log_set_writer(NULL);
+		AR_LOG_ERR(LOG_TAG, "ar_log_set_async error: %d", status);
+		goto end;
+	}
+
+	/* B logs from its own thread and is joined before A starts, so every
+	   B line must be written before any A line */
+	status = ar_osal_thread_attr_init(&thread_attr);
+	if (AR_EOK == status)
+		status = ar_osal_thread_create(&thread, &thread_attr, log_test_thread, &thread_id);
+	if (AR_EOK == status)
+		ar_osal_thread_join_destroy(thread);
+	for (uint32_t i = 0; i < LOG_TEST_MSGS_PER_THREAD; i++)
+		log_test_emit('A', i);
+
+	/* deinit must write everything still queued */
+	ar_log_deinit();
+	ar_log_set_writer(NULL);
+
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "log thread error: %d", status);
+		goto end;
+	}
+	if (log_test_num_msgs != 1 + 2 * LOG_TEST_MSGS_PER_THREAD)
+	{
+		AR_LOG_ERR(LOG_TAG, "expected %d log lines, got %u", 1 + 2 * LOG_TEST_MSGS_PER_THREAD,
+			log_test_num_msgs);
+		goto end;
+	}
+
+	for (uint32_t i = 1; i < log_test_num_msgs; i++)
+	{
+		if ((seq = log_test_seq(i, 'B')) >= 0)
+		{
+			ok = ok && !a_seen && seq == next_b++;
+		}
+		else if ((seq = log_test_seq(i, 'A')) >= 0)
+		{
+			a_seen = TRUE;
+			ok = ok && seq == next_a++;
+		}
+		else
+		{
+			ok = FALSE;
+		}
+	}
+	if (!ok)
+		AR_LOG_ERR(LOG_TAG, "asynchronous log lines out of order");
+
+	/* the asynchronous line differs from the synchronous one only in the
+	   id, both are logged from the same line of log_test_emit() */
+	if (0 != log_test_seq(0, 'S') || 0 != log_test_seq(1, 'B'))
+	{
+		AR_LOG_ERR(LOG_TAG, "unexpected first log lines \"%s\", \"%s\"", log_test_msgs[0],
+			log_test_msgs[1]);
+		goto end;
+	}
+	snprintf(sync_msg, sizeof(sync_msg), "%s", log_test_msgs[0]);
+	*strstr(sync_msg, "log test S") = '\0';
+	if (strncmp(log_test_msgs[1], sync_msg, strlen(sync_msg)) ||
+		strcmp(log_test_msgs[1] + strlen(sync_msg), "log test B 0 str"))
+		AR_LOG_ERR(LOG_TAG, "asynchronous line \"%s\" does not match \"%s\"", log_test_msgs[1],
+			log_test_msgs[0]);
+
+end:
+	ar_osal_mutex_destroy(log_test_lock);
+}
@@ -2,6 +2,7 @@
 *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 *  SPDX-License-Identifier: BSD-3-Clause
 */
+#include <stdlib.h>
 #include "ar_osal_test.h"
 #include "ar_osal_mem_op.h"
 #include "ar_osal_log.h"
@@ -44,5 +45,35 @@ void ar_test_mem_op_main()
 		AR_LOG_DEBUG(LOG_TAG, "BufA[%d]: %d ", i, BufA[i]);
 	}
 
+	/* streaming copy of a buffer large enough to bypass the cache */
+	size_t BigSize = AR_MEM_CPY_NT_MIN_SIZE * 16 + 3;
+	uint8_t* pBigA = malloc(BigSize);
+	uint8_t* pBigB = malloc(BigSize);
+	if (NULL != pBigA && NULL != pBigB)
+	{
+		for (size_t i = 0; i < BigSize; i++)
+		{
+			pBigA[i] = (uint8_t)i;
+		}
+		status = ar_mem_cpy_nt(pBigB + 1, BigSize - 1, pBigA, BigSize - 1);
+		AR_LOG_DEBUG(LOG_TAG, "ar_mem_cpy_nt(%d), cmp(%d) expected == 0 ", status, ar_mem_cmp(pBigB + 1, pBigA, BigSize - 1));
+	}
+	free(pBigA);
+	free(pBigB);
+
+	/* fused PCM conversions */
+	int16_t Pcm16[10] = { -32768, -1, 0, 1, 32767, 100, -100, 2, -2, 3 };
+	int32_t Pcm32[10] = { 0 };
+	int16_t Planar[10] = { 0 };
+	status = ar_pcm_convert_16_to_32(Pcm32, sizeof(Pcm32), Pcm16, 10);
+	AR_LOG_DEBUG(LOG_TAG, "ar_pcm_convert_16_to_32(%d) [0]:0x%x [4]:0x%x ", status, Pcm32[0], Pcm32[4]);
+	status = ar_pcm_convert_16_to_24_in_32(Pcm32, sizeof(Pcm32), Pcm16, 10);
+	AR_LOG_DEBUG(LOG_TAG, "ar_pcm_convert_16_to_24_in_32(%d) [0]:0x%x [4]:0x%x ", status, Pcm32[0], Pcm32[4]);
+	status = ar_pcm_deinterleave(Planar, sizeof(Planar), Pcm16, sizeof(Pcm16), 2, sizeof(int16_t));
+	if (AR_EOK == status)
+		status = ar_pcm_interleave(Pcm32, sizeof(Pcm32), Planar, sizeof(Planar), 2, sizeof(int16_t));
+	AR_LOG_DEBUG(LOG_TAG, "ar_pcm_deinterleave/interleave(%d), cmp(%d) expected == 0 ", status, ar_mem_cmp(Pcm32, Pcm16, sizeof(Pcm16)));
+	AR_LOG_DEBUG(LOG_TAG, "ar_pcm_interleave(%d), expected %d ", ar_pcm_interleave(Pcm32, sizeof(Pcm32), Planar, 7, 2, sizeof(int16_t)), AR_EBADPARAM);
+
 	return;
 }
@@ -0,0 +1,288 @@
+/*
+*  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+*  SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "ar_osal_test.h"
+#include "ar_util_queue.h"
+#include "ar_osal_log.h"
+#include "ar_osal_types.h"
+#include "ar_osal_error.h"
+#include "ar_osal_thread.h"
+#include "ar_osal_sleep.h"
+
+#define AR_QUEUE_TEST_ELEMS     (64)
+#define AR_QUEUE_TEST_ITEMS     (100000)
+#define AR_QUEUE_TEST_PRODUCERS (4)
+#define AR_QUEUE_TEST_OBJS      (16)
+
+static ar_spsc_ring_t spsc_ring;
+static uint32_t spsc_storage[AR_QUEUE_TEST_ELEMS];
+
+static ar_mpsc_ring_t mpsc_ring;
+static uint64_t mpsc_storage[AR_MPSC_RING_STORAGE_SIZE(sizeof(uint32_t), AR_QUEUE_TEST_ELEMS) / sizeof(uint64_t)];
+
+static volatile bool_t mpsc_stop;
+
+static ar_free_stack_t free_stack;
+static uint32_t free_pool[AR_QUEUE_TEST_OBJS][4];
+
+typedef struct
+{
+	uint32_t id;
+	int32_t errors;
+} ar_queue_test_ctx_t;
+
+static void spsc_producer(void *param)
+{
+	for (uint32_t i = 0; i < AR_QUEUE_TEST_ITEMS; i++)
+	{
+		while (AR_ENORESOURCE == ar_spsc_ring_push(&spsc_ring, &i))
+			(void)ar_osal_micro_sleep(1);
+	}
+}
+
+static void mpsc_producer(void *param)
+{
+	ar_queue_test_ctx_t *ctx = (ar_queue_test_ctx_t *)param;
+	uint32_t value;
+
+	/* encode producer id in the top byte so the consumer can check order */
+	for (uint32_t i = 0; i < AR_QUEUE_TEST_ITEMS; i++)
+	{
+		value = (ctx->id << 24) | i;
+		while (AR_ENORESOURCE == ar_mpsc_ring_push(&mpsc_ring, &value))
+		{
+			if (mpsc_stop)
+				return;
+			(void)ar_osal_micro_sleep(1);
+		}
+	}
+}
+
+static void free_stack_worker(void *param)
+{
+	ar_queue_test_ctx_t *ctx = (ar_queue_test_ctx_t *)param;
+	volatile uint32_t *obj;
+
+	for (uint32_t i = 0; i < AR_QUEUE_TEST_ITEMS; i++)
+	{
+		obj = (volatile uint32_t *)ar_free_stack_pop(&free_stack);
+		if (NULL == obj)
+			continue;
+		/* nobody else may hold this object while we own it */
+		obj[1] = ctx->id;
+		obj[2] = i;
+		if (obj[1] != ctx->id || obj[2] != i)
+			ctx->errors++;
+		if (AR_EOK != ar_free_stack_push(&free_stack, (void *)obj))
+			ctx->errors++;
+	}
+}
+
+static int32_t ar_test_queue_spsc(void)
+{
+	int32_t status = AR_EOK;
+	ar_osal_thread_t thread = NULL;
+	ar_osal_thread_attr_t thread_attr;
+	uint32_t value = 0;
+	uint32_t expected = 0;
+
+	status = ar_spsc_ring_init(&spsc_ring, spsc_storage, sizeof(uint32_t), 63);
+	if (AR_EBADPARAM != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "spsc init accepted a non power of two size %d", status);
+		return AR_EFAILED;
+	}
+	status = ar_spsc_ring_init(&spsc_ring, spsc_storage, sizeof(uint32_t), AR_QUEUE_TEST_ELEMS);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "failed ar_spsc_ring_init %d", status);
+		return status;
+	}
+
+	/* fill to capacity, one more push must fail */
+	for (uint32_t i = 0; i < AR_QUEUE_TEST_ELEMS; i++)
+		(void)ar_spsc_ring_push(&spsc_ring, &i);
+	if (AR_ENORESOURCE != ar_spsc_ring_push(&spsc_ring, &value) ||
+		AR_QUEUE_TEST_ELEMS != ar_spsc_ring_get_count(&spsc_ring))
+	{
+		AR_LOG_ERR(LOG_TAG, "spsc ring full handling failed");
+		return AR_EFAILED;
+	}
+	while (AR_EOK == ar_spsc_ring_pop(&spsc_ring, &value))
+		;
+
+	(void)ar_osal_thread_attr_init(&thread_attr);
+	status = ar_osal_thread_create(&thread, &thread_attr, spsc_producer, NULL);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "failed ar_osal_thread_create %d", status);
+		return status;
+	}
+	while (expected < AR_QUEUE_TEST_ITEMS)
+	{
+		if (AR_EOK != ar_spsc_ring_pop(&spsc_ring, &value))
+		{
+			(void)ar_osal_micro_sleep(1);
+			continue;
+		}
+		if (value != expected)
+		{
+			AR_LOG_ERR(LOG_TAG, "spsc ring out of order, got %u expected %u", value, expected);
+			status = AR_EFAILED;
+			break;
+		}
+		expected++;
+	}
+	(void)ar_osal_thread_join_destroy(thread);
+	return status;
+}
+
+static int32_t ar_test_queue_mpsc(void)
+{
+	int32_t status = AR_EOK;
+	ar_osal_thread_t threads[AR_QUEUE_TEST_PRODUCERS] = { NULL };
+	ar_queue_test_ctx_t ctx[AR_QUEUE_TEST_PRODUCERS];
+	uint32_t next[AR_QUEUE_TEST_PRODUCERS] = { 0 };
+	ar_osal_thread_attr_t thread_attr;
+	uint32_t received = 0;
+	uint32_t value = 0;
+	uint32_t id;
+
+	status = ar_mpsc_ring_init(&mpsc_ring, mpsc_storage, sizeof(uint32_t), AR_QUEUE_TEST_ELEMS);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "failed ar_mpsc_ring_init %d", status);
+		return status;
+	}
+	if (AR_ENOTEXIST != ar_mpsc_ring_pop(&mpsc_ring, &value))
+	{
+		AR_LOG_ERR(LOG_TAG, "mpsc pop from an empty ring succeeded");
+		return AR_EFAILED;
+	}
+
+	mpsc_stop = FALSE;
+	(void)ar_osal_thread_attr_init(&thread_attr);
+	for (uint32_t i = 0; i < AR_QUEUE_TEST_PRODUCERS; i++)
+	{
+		ctx[i].id = i;
+		ctx[i].errors = 0;
+		status = ar_osal_thread_create(&threads[i], &thread_attr, mpsc_producer, &ctx[i]);
+		if (AR_EOK != status)
+		{
+			AR_LOG_ERR(LOG_TAG, "failed ar_osal_thread_create %d", status);
+			goto end;
+		}
+	}
+
+	/* each producer's values must arrive in the order it pushed them */
+	while (received < AR_QUEUE_TEST_PRODUCERS * AR_QUEUE_TEST_ITEMS)
+	{
+		if (AR_EOK != ar_mpsc_ring_pop(&mpsc_ring, &value))
+		{
+			(void)ar_osal_micro_sleep(1);
+			continue;
+		}
+		id = value >> 24;
+		if (id >= AR_QUEUE_TEST_PRODUCERS || (value & 0xFFFFFF) != next[id])
+		{
+			AR_LOG_ERR(LOG_TAG, "mpsc ring out of order, got 0x%x", value);
+			status = AR_EFAILED;
+			goto end;
+		}
+		next[id]++;
+		received++;
+	}
+
+end:
+	/* let producers stuck on a full ring give up */
+	mpsc_stop = TRUE;
+	for (uint32_t i = 0; i < AR_QUEUE_TEST_PRODUCERS; i++)
+	{
+		if (NULL != threads[i])
+			(void)ar_osal_thread_join_destroy(threads[i]);
+	}
+	return status;
+}
+
+static int32_t ar_test_queue_free_stack(void)
+{
+	int32_t status = AR_EOK;
+	ar_osal_thread_t threads[AR_QUEUE_TEST_PRODUCERS] = { NULL };
+	ar_queue_test_ctx_t ctx[AR_QUEUE_TEST_PRODUCERS];
+	ar_osal_thread_attr_t thread_attr;
+	void *objs[AR_QUEUE_TEST_OBJS];
+	uint32_t num_objs = 0;
+
+	status = ar_free_stack_init(&free_stack, free_pool, sizeof(free_pool[0]), AR_QUEUE_TEST_OBJS);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "failed ar_free_stack_init %d", status);
+		return status;
+	}
+
+	/* drain, check every object is handed out once, and refill */
+	while (NULL != (objs[num_objs] = ar_free_stack_pop(&free_stack)))
+	{
+		for (uint32_t i = 0; i < num_objs; i++)
+		{
+			if (objs[i] == objs[num_objs])
+			{
+				AR_LOG_ERR(LOG_TAG, "free stack returned %p twice", objs[i]);
+				return AR_EFAILED;
+			}
+		}
+		if (++num_objs == AR_QUEUE_TEST_OBJS)
+			break;
+	}
+	if (AR_QUEUE_TEST_OBJS != num_objs || NULL != ar_free_stack_pop(&free_stack) ||
+		AR_EBADPARAM != ar_free_stack_push(&free_stack, (uint8_t *)objs[0] + 1))
+	{
+		AR_LOG_ERR(LOG_TAG, "free stack drain failed, %u objects", num_objs);
+		return AR_EFAILED;
+	}
+	for (uint32_t i = 0; i < num_objs; i++)
+		(void)ar_free_stack_push(&free_stack, objs[i]);
+
+	(void)ar_osal_thread_attr_init(&thread_attr);
+	for (uint32_t i = 0; i < AR_QUEUE_TEST_PRODUCERS; i++)
+	{
+		ctx[i].id = i;
+		ctx[i].errors = 0;
+		status = ar_osal_thread_create(&threads[i], &thread_attr, free_stack_worker, &ctx[i]);
+		if (AR_EOK != status)
+		{
+			AR_LOG_ERR(LOG_TAG, "failed ar_osal_thread_create %d", status);
+			break;
+		}
+	}
+	for (uint32_t i = 0; i < AR_QUEUE_TEST_PRODUCERS; i++)
+	{
+		if (NULL == threads[i])
+			continue;
+		(void)ar_osal_thread_join_destroy(threads[i]);
+		if (ctx[i].errors)
+		{
+			AR_LOG_ERR(LOG_TAG, "free stack worker %u saw %d errors", i, ctx[i].errors);
+			status = AR_EFAILED;
+		}
+	}
+	if (AR_QUEUE_TEST_OBJS != ar_free_stack_get_count(&free_stack))
+	{
+		AR_LOG_ERR(LOG_TAG, "free stack leaked objects, count %u", ar_free_stack_get_count(&free_stack));
+		status = AR_EFAILED;
+	}
+	return status;
+}
+
+void ar_test_queue_main()
+{
+	int32_t status = AR_EOK;
+
+	status = ar_test_queue_spsc();
+	AR_LOG_DEBUG(LOG_TAG, "spsc ring test status %d", status);
+	status = ar_test_queue_mpsc();
+	AR_LOG_DEBUG(LOG_TAG, "mpsc ring test status %d", status);
+	status = ar_test_queue_free_stack();
+	AR_LOG_DEBUG(LOG_TAG, "free stack test status %d", status);
+}
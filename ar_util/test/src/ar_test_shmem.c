@@ -46,6 +46,27 @@ void ar_test_shmem_main()
 		AR_LOG_ERR(LOG_TAG,"failed to shmem free %d ", status);
 		goto end;
 	}
+
+	/* memfd backed allocation on huge pages, descriptor returned in pa_lsw */
+	shmem_info.buf_size = 4 * 1024 * 1024;
+	shmem_info.flags = (AR_SHMEM_BACKEND_MEMFD << AR_SHMEM_SHIFT_BACKEND_FLAG) |
+		(AR_SHMEM_PAGE_HUGETLB << AR_SHMEM_SHIFT_PAGE_FLAG);
+	status = ar_shmem_alloc(&shmem_info);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG,"failed to memfd shmem alloc(%d): size%d ", status, shmem_info.buf_size);
+		goto end;
+	}
+	AR_LOG_INFO(LOG_TAG,"memfd shmem address: 0x%p, fd: %d, mem_type(0x%x), index_type(0x%x) ",
+		shmem_info.vaddr, shmem_info.pa_lsw, shmem_info.mem_type, shmem_info.index_type);
+	((uint8_t *)shmem_info.vaddr)[shmem_info.buf_size - 1] = 0xA5;
+
+	status = ar_shmem_free(&shmem_info);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG,"failed to memfd shmem free %d ", status);
+		goto end;
+	}
 end:
 	return;
 }
@@ -0,0 +1,74 @@
+/*
+*  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+*  SPDX-License-Identifier: BSD-3-Clause
+*/
+#include "ar_osal_test.h"
+#include "ar_osal_timer.h"
+#include "ar_osal_sleep.h"
+#include "ar_osal_log.h"
+#include "ar_osal_types.h"
+#include "ar_osal_error.h"
+
+static volatile uint32_t oneshot_count = 0;
+static volatile uint32_t periodic_count = 0;
+
+static void ar_test_oneshot_cb(void *cb_data)
+{
+	oneshot_count++;
+	AR_LOG_DEBUG(LOG_TAG, "one-shot timer fired at %llu ms", ar_timer_get_time_in_ms());
+}
+
+static void ar_test_periodic_cb(void *cb_data)
+{
+	ar_osal_timer_t *timer = (ar_osal_timer_t *)cb_data;
+
+	// cancelling from the callback itself must not block
+	if (++periodic_count == 5)
+		ar_osal_timer_cancel(*timer);
+}
+
+void ar_test_timer_main()
+{
+	int32_t status = AR_EOK;
+	ar_osal_timer_t oneshot = NULL;
+	ar_osal_timer_t periodic = NULL;
+
+	status = ar_osal_timer_create(&oneshot, ar_test_oneshot_cb, NULL);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "failed ar_osal_timer_create %d ", status);
+		goto end;
+	}
+	status = ar_osal_timer_create(&periodic, ar_test_periodic_cb, &periodic);
+	if (AR_EOK != status)
+	{
+		AR_LOG_ERR(LOG_TAG, "failed ar_osal_timer_create %d ", status);
+		goto end;
+	}
+
+	// 10 msec one-shot and 5 msec periodic, stopped by its callback after 5 runs
+	AR_LOG_DEBUG(LOG_TAG, "timers started at %llu ms", ar_timer_get_time_in_ms());
+	ar_osal_timer_start(oneshot, 10000, 0);
+	ar_osal_timer_start(periodic, 5000, 5000);
+	ar_osal_micro_sleep(100000);
+	if (1 != oneshot_count || 5 != periodic_count)
+	{
+		AR_LOG_ERR(LOG_TAG, "unexpected expiries: one-shot(%d) periodic(%d)", oneshot_count, periodic_count);
+	}
+
+	// a cancelled timer must not fire
+	ar_osal_timer_start(oneshot, 10000, 0);
+	status = ar_osal_timer_cancel(oneshot);
+	ar_osal_micro_sleep(30000);
+	if (AR_EOK != status || 1 != oneshot_count)
+	{
+		AR_LOG_ERR(LOG_TAG, "cancelled timer fired: status(%d) count(%d)", status, oneshot_count);
+	}
+
+end:
+	if (oneshot)
+		ar_osal_timer_destroy(oneshot);
+	if (periodic)
+		ar_osal_timer_destroy(periodic);
+	return;
+}
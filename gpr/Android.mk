@@ -18,7 +18,9 @@ LOCAL_SRC_FILES := \
     core/src/hash_based/gpr_session_island.c \
     ext/dynamic_allocation/src/gpr_dynamic_allocation.c \
     ext/logging/src/gpr_log_generic.c \
+    ext/logging/src/gpr_trace.c \
     ext/logging/stub_src/gpr_log_diag_stub.c \
+    ext/metrics/src/gpr_metrics.c \
     datalinks/gpr_lx/src/gpr_lx.c \
     platform/linux/gpr_init_lx_wrapper.c
 
@@ -37,6 +39,7 @@ LOCAL_C_INCLUDES := \
     $(LOCAL_PATH)/core/src \
     $(LOCAL_PATH)/ext/dynamic_allocation/inc \
     $(LOCAL_PATH)/ext/logging/inc \
+    $(LOCAL_PATH)/ext/metrics/inc \
     $(LOCAL_PATH)/datalinks/gpr_lx/inc
 
 LOCAL_EXPORT_C_INCLUDE_DIRS := $(LOCAL_PATH)/api
@@ -34,6 +34,25 @@ extern "C" {
     2. GPR_HEAP_INDEX_1  */
 typedef uint8_t gpr_heap_index_t;
 
+/* Packet priority classes, see __gpr_cmd_get_packet_class() */
+
+/* Control commands, responses and events */
+#define GPR_PKT_CLASS_CONTROL 0
+
+/* Data commands, responses and events, including basic responses to data
+   commands. Served from their own packet pools first and dispatched ahead of
+   control traffic where the datalink supports it. */
+#define GPR_PKT_CLASS_DATA    1
+
+/* Send flags for __gpr_cmd_async_send_v2() */
+
+/* Packet is sent immediately */
+#define GPR_SEND_FLAG_NONE        0x0
+
+/* Datalink may queue the packet and send it together with later packets to
+   the same domain, see __gpr_cmd_flush() */
+#define GPR_SEND_FLAG_DEFER_FLUSH 0x1
+
 /** @ingroup gpr_func_proto_callback
   Prototype of a packet callback function.
 
@@ -68,8 +87,12 @@ struct gpr_packet_pool_info_v2_t
    uint8_t is_dynamic;
    /*  Flag to indicate if the packets in the pool need to be allocated dynamically or statcially at init.*/
 
-   uint16_t reserved;
-    /* Reserved field for alignment, must be set to 0*/
+   uint16_t pkt_class;
+   /* Packet class the pool is reserved for, formerly a reserved field.
+        @valid_values
+          0 - GPR_PKT_CLASS_CONTROL, pool is shared by all packets
+          1 - GPR_PKT_CLASS_DATA, pool only serves data packets and is tried
+              before the shared pools for them. Must be a static pool. */
 
    uint32_t num_packets;
    /* Max number of packets in the pool.
@@ -82,6 +105,68 @@ struct gpr_packet_pool_info_v2_t
    /* Size of each packet in the pool.*/
 };
 
+/* Scheduling policies of the datalink threads, see gpr_init_cfg_t */
+#define GPR_THREAD_POLICY_DEFAULT 0 /* Inherit the creating thread's policy, or
+                                       SCHED_FIFO on Linux if a priority is set */
+#define GPR_THREAD_POLICY_FIFO    1
+#define GPR_THREAD_POLICY_RR      2
+#define GPR_THREAD_POLICY_OTHER   3
+
+/* Receive thread layouts of a datalink port, see gpr_init_cfg_t */
+
+/* One thread per port reads and dispatches every packet */
+#define GPR_RX_THREAD_MODE_SINGLE        0
+
+/* The port thread dispatches data commands, responses and events itself and
+   hands all other packets to a second control dispatch thread, so data done
+   events never wait behind slow control callbacks */
+#define GPR_RX_THREAD_MODE_SPLIT_CONTROL 1
+
+/* Scheduling of one datalink helper thread. A zero field takes the value of
+   the receive thread settings in gpr_init_cfg_t. */
+typedef struct gpr_thread_cfg_t gpr_thread_cfg_t;
+
+struct gpr_thread_cfg_t
+{
+   uint32_t policy;
+   /* Scheduling policy, GPR_THREAD_POLICY_* */
+
+   uint32_t priority;
+   /* Scheduling priority. Ignored for GPR_THREAD_POLICY_OTHER */
+
+   uint64_t cpu_mask;
+   /* Bit n set allows the thread to run on CPU n */
+};
+
+/* Configuration passed to gpr_init_v2(). Zero-filled means datalink defaults. */
+typedef struct gpr_init_cfg_t gpr_init_cfg_t;
+
+struct gpr_init_cfg_t
+{
+   uint32_t rx_thread_policy;
+   /* Scheduling policy of the receive threads, GPR_THREAD_POLICY_* */
+
+   uint32_t rx_thread_priority;
+   /* Scheduling priority of the receive threads, 0 for the datalink default.
+      Ignored for GPR_THREAD_POLICY_OTHER. */
+
+   uint64_t rx_thread_cpu_mask;
+   /* Bit n set allows the receive threads to run on CPU n, 0 for no affinity */
+
+   uint32_t rx_thread_mode;
+   /* Receive thread layout, GPR_RX_THREAD_MODE_* */
+
+   uint32_t reserved;
+   /* Reserved field for alignment, must be set to 0 */
+
+   gpr_thread_cfg_t ctrl_thread;
+   /* Control dispatch thread of GPR_RX_THREAD_MODE_SPLIT_CONTROL. A zero
+      priority runs it one level below the receive thread. */
+
+   gpr_thread_cfg_t tx_thread;
+   /* Thread that sends deferred packets */
+};
+
 /*****************************************************************************
  * Core Routines                                                             *
  ****************************************************************************/
@@ -116,6 +201,29 @@ if ( rc )
 */
 GPR_EXTERNAL uint32_t gpr_init(void);
 
+/**
+  Performs external initialization of the GPR infrastructure with receive
+  thread configuration.
+
+  @datatypes
+  #gpr_init_cfg_t
+
+  @param[in] cfg  Receive thread scheduling, affinity and layout. NULL behaves
+                  like gpr_init().
+
+  @detdesc
+  The configuration applies to every datalink port opened by this call.
+  Clients such as GSL call gpr_init() themselves; calling gpr_init_v2() before
+  them makes their gpr_init() a no-op, so the configuration sticks.
+
+  @return
+  #AR_EOK -- When successful.
+
+  @dependencies
+  None.
+*/
+GPR_EXTERNAL uint32_t gpr_init_v2(const gpr_init_cfg_t *cfg);
+
 /**
   To initialize GPR with particular domain.
 
@@ -457,6 +457,96 @@ if ( rc )
  */
 uint32_t __gpr_cmd_async_send(gpr_packet_t *packet);
 
+/** @ingroup gpr_cmd_async_send
+  Sends a message asynchronously to another service, optionally letting the
+  data link layer defer the transmission.
+
+  @datatypes
+  #gpr_packet_t
+
+  @param[in] packet      Pointer to the packet (message) to send.
+  @param[in] send_flags  Bitmask of GPR_SEND_FLAG_* values. Set to
+                         #GPR_SEND_FLAG_NONE for the behavior of
+                         __gpr_cmd_async_send().
+
+  @detdesc
+  When #GPR_SEND_FLAG_DEFER_FLUSH is set, a data link layer that supports
+  batching may queue the packet and transmit it together with subsequent
+  packets to the same destination domain. Queued packets are transmitted when
+  __gpr_cmd_flush() is called, when a non-deferred packet is sent to the same
+  domain, when the data link's queue is full, or at the latest when the data
+  link's batching window expires.
+  @par
+  Data link layers without batching support, including local routing, send
+  the packet immediately.
+  @par
+  Once this function returns #AR_EOK the packet is owned by the GPR, even if
+  it has not been transmitted yet. If a deferred packet later fails to be
+  transmitted it is freed by the data link layer.
+
+  @return
+  #AR_EOK -- When successful.
+
+  @dependencies
+  GPR initialization must be completed via gpr_init().
+  @par
+  The source and destination services must be registered with the GPR.
+
+  @codeexample
+  @lstlisting
+#include "gpr_api_inline.h"
+
+//Queue a burst of buffers and hand them to the datalink in one go.
+for (i = 0; i < num_buffers; i++)
+{
+   rc = __gpr_cmd_async_send_v2( packet_ptr[i], GPR_SEND_FLAG_DEFER_FLUSH );
+   if ( rc )
+   {
+      ( void ) __gpr_cmd_free( packet_ptr[i] );
+      break;
+   }
+}
+( void ) __gpr_cmd_flush( dst_domain_id );
+  @endlstlisting
+ */
+uint32_t __gpr_cmd_async_send_v2(gpr_packet_t *packet, uint32_t send_flags);
+
+/** @ingroup gpr_cmd_async_send
+  Transmits all packets that were queued for a destination domain with
+  #GPR_SEND_FLAG_DEFER_FLUSH.
+
+  @param[in] dst_domain_id  Domain ID of the destination.
+
+  @return
+  #AR_EOK -- When successful or when nothing was queued.
+
+  @dependencies
+  GPR initialization must be completed via gpr_init().
+ */
+uint32_t __gpr_cmd_flush(uint32_t dst_domain_id);
+
+/** @ingroup gpr_cmd_get_packet_class
+  Gets the priority class of a packet.
+
+  @datatypes
+  #gpr_packet_t
+
+  @param[in] packet  Pointer to the packet.
+
+  @detdesc
+  The class follows the opcode type, see ar_guids.h. Data commands, data
+  command responses and data events are #GPR_PKT_CLASS_DATA, as are
+  #GPR_IBASIC_RSP_RESULT responses to data commands. Everything else is
+  #GPR_PKT_CLASS_CONTROL.
+
+  @return
+  #GPR_PKT_CLASS_CONTROL or #GPR_PKT_CLASS_DATA.
+
+  @dependencies
+  None.
+*/
+uint32_t __gpr_cmd_get_packet_class(gpr_packet_t *packet);
+
 /** @ingroup gpr_cmd_alloc
   Allocates a free message for delivery.
 
@@ -0,0 +1,152 @@
+#ifndef __GPR_METRICS_API_H__
+#define __GPR_METRICS_API_H__
+
+/**
+ * @file  gpr_metrics_api.h
+ * @brief This file contains the GPR latency and throughput metrics APIs
+ *
+ *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                    *
+ *****************************************************************************/
+#include "gpr_comdef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/*****************************************************************************
+ * Definitions                                                               *
+ ****************************************************************************/
+
+/** Number of latency histogram bins. Bin 0 counts round trips below 2 us,
+    bin n those in [2^n, 2^(n+1)) us and the last bin everything above. */
+#define GPR_METRICS_NUM_LATENCY_BINS 20
+
+/** Maximum number of opcode/destination pairs tracked */
+#define GPR_METRICS_MAX_OPCODE_ENTRIES 64
+
+/** Maximum number of packet pools reported */
+#define GPR_METRICS_MAX_POOLS 8
+
+/** Round trip statistics of one request opcode sent to one destination */
+typedef struct gpr_metrics_opcode_stats_t gpr_metrics_opcode_stats_t;
+
+struct gpr_metrics_opcode_stats_t
+{
+   uint32_t opcode;
+   /* Opcode of the request */
+
+   uint32_t dst_domain_id;
+   uint32_t dst_port;
+   /* Destination the request was sent to */
+
+   uint32_t num_requests;
+   /* Requests sent */
+
+   uint32_t num_responses;
+   /* Responses matched to a request by token and ports */
+
+   uint32_t min_latency_us;
+   uint32_t max_latency_us;
+   uint64_t total_latency_us;
+   /* Round trip time of the matched responses */
+
+   uint32_t latency_hist[GPR_METRICS_NUM_LATENCY_BINS];
+   /* Log2 histogram of the round trip time, see GPR_METRICS_NUM_LATENCY_BINS */
+};
+
+/** Occupancy of one packet pool */
+typedef struct gpr_metrics_pool_stats_t gpr_metrics_pool_stats_t;
+
+struct gpr_metrics_pool_stats_t
+{
+   uint32_t is_dynamic;
+   uint32_t packet_size;
+   uint32_t num_packets;
+   /* Pool size, as reported by __gpr_cmd_get_gpr_packet_info_v2() */
+
+   uint32_t num_in_use;
+   /* Packets currently allocated from the pool */
+};
+
+/** Snapshot returned by __gpr_cmd_get_metrics() */
+typedef struct gpr_metrics_snapshot_t gpr_metrics_snapshot_t;
+
+struct gpr_metrics_snapshot_t
+{
+   uint64_t start_time_us;
+   uint64_t snapshot_time_us;
+   /* ar_timer_get_time_in_us() when collection started and at the snapshot,
+      to turn the counters below into rates */
+
+   uint64_t tx_packets;
+   uint64_t tx_bytes;
+   uint64_t rx_packets;
+   uint64_t rx_bytes;
+   /* Packets exchanged with other domains */
+
+   uint32_t num_pending;
+   /* Requests waiting for a response */
+
+   uint32_t num_dropped_requests;
+   /* Requests no longer tracked because the pending table or the opcode
+      table was full */
+
+   uint32_t num_opcode_entries;
+   gpr_metrics_opcode_stats_t opcode_stats[GPR_METRICS_MAX_OPCODE_ENTRIES];
+
+   uint32_t num_pools;
+   gpr_metrics_pool_stats_t pool_stats[GPR_METRICS_MAX_POOLS];
+};
+
+/*****************************************************************************
+ * Metrics Routines                                                          *
+ ****************************************************************************/
+
+/**
+  Starts or stops metrics collection.
+
+  @param[in] enable  TRUE to start collecting, FALSE to stop.
+
+  @detdesc
+  Collection is off by default. Starting it clears all counters. Requests
+  (control and data commands) sent to another domain are remembered until a
+  response with the same token comes back from the port they were sent to;
+  the time in between is accounted to the request opcode and destination.
+  Stopping keeps the counters for __gpr_cmd_get_metrics().
+
+  @return
+  #AR_EOK -- When successful.
+
+  @dependencies
+  gpr_init() must have been called.
+*/
+uint32_t __gpr_cmd_metrics_enable(bool_t enable);
+
+/**
+  Copies the current metrics.
+
+  @param[out] snapshot  Buffer that receives the metrics.
+
+  @detdesc
+  Pool occupancy is sampled at the time of the call, the other fields cover
+  the time since collection was last started.
+
+  @return
+  #AR_EOK -- When successful.
+  #AR_EBADPARAM -- snapshot is NULL.
+
+  @dependencies
+  gpr_init() must have been called.
+*/
+uint32_t __gpr_cmd_get_metrics(gpr_metrics_snapshot_t *snapshot);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* __GPR_METRICS_API_H__ */
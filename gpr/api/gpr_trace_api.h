@@ -0,0 +1,180 @@
+#ifndef __GPR_TRACE_API_H__
+#define __GPR_TRACE_API_H__
+
+/**
+ * @file  gpr_trace_api.h
+ * @brief This file contains the GPR packet trace APIs
+ *
+ *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                    *
+ *****************************************************************************/
+#include "gpr_comdef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/*****************************************************************************
+ * Definitions                                                               *
+ ****************************************************************************/
+
+/** Number of records kept in the trace ring, a power of two */
+#define GPR_TRACE_NUM_RECORDS 1024
+
+/** Version of the trace ring image returned by __gpr_cmd_get_trace_image() */
+#define GPR_TRACE_IMAGE_VERSION 1
+
+/** Direction of a traced packet */
+#define GPR_TRACE_DIR_TX 0
+#define GPR_TRACE_DIR_RX 1
+
+/** Header of one packet as kept in the trace ring */
+typedef struct gpr_trace_record_t gpr_trace_record_t;
+
+struct gpr_trace_record_t
+{
+   uint64_t timestamp_us;
+   /* Time the packet went through GPR, ar_timer_get_time_in_us() */
+
+   uint32_t seq;
+   /* Position of the record in the trace plus one, 0 for an unused slot */
+
+   uint32_t opcode;
+   uint32_t token;
+   uint32_t src_port;
+   uint32_t dst_port;
+   uint32_t packet_size;
+   /* Packet header fields */
+
+   uint8_t src_domain_id;
+   uint8_t dst_domain_id;
+   uint8_t direction;
+   /* GPR_TRACE_DIR_TX or GPR_TRACE_DIR_RX */
+
+   uint8_t reserved;
+};
+
+/** Trace ring as found in memory and returned by __gpr_cmd_get_trace_image() */
+typedef struct gpr_trace_image_t gpr_trace_image_t;
+
+struct gpr_trace_image_t
+{
+   char_t   start_marker[8];
+   /* "GPRTRACE", to locate the ring in a memory dump */
+
+   uint32_t version;
+   /* GPR_TRACE_IMAGE_VERSION */
+
+   uint32_t num_records;
+   /* Capacity of the ring, GPR_TRACE_NUM_RECORDS */
+
+   uint32_t head;
+   /* Number of records written since init, the newest is at (head - 1) */
+
+   uint32_t reserved;
+
+   gpr_trace_record_t records[GPR_TRACE_NUM_RECORDS];
+
+   char_t   end_marker[8];
+   /* "GPRTREND" */
+};
+
+/** Trace configuration, see __gpr_cmd_set_trace_cfg() */
+typedef struct gpr_trace_cfg_t gpr_trace_cfg_t;
+
+struct gpr_trace_cfg_t
+{
+   uint32_t enable;
+   /* Nonzero to record packets */
+
+   uint32_t sample_interval;
+   /* Record one of every sample_interval matching packets, 0 or 1 for all */
+
+   uint32_t opcode_mask;
+   uint32_t opcode_value;
+   /* Only packets with (opcode & opcode_mask) == opcode_value are recorded.
+      A zero mask matches every packet. */
+
+   uint32_t max_records_per_sec;
+   /* Upper bound on records per second, 0 for no limit */
+};
+
+/*****************************************************************************
+ * Trace Routines                                                            *
+ ****************************************************************************/
+
+/**
+  Configures the GPR packet trace.
+
+  @param[in] cfg  Trace configuration.
+
+  @detdesc
+  The trace records the header of every packet sent or received through a
+  datalink into a fixed ring, without locks and without formatting. It is
+  disabled until enabled by this call. Filtering, sampling and rate limiting
+  apply to packets seen after this call.
+
+  @return
+  #AR_EOK -- When successful.
+  #AR_EBADPARAM -- cfg is NULL.
+
+  @dependencies
+  None.
+*/
+uint32_t __gpr_cmd_set_trace_cfg(const gpr_trace_cfg_t *cfg);
+
+/**
+  Copies the trace ring.
+
+  @param[out] image  Buffer that receives the ring.
+
+  @detdesc
+  The copy is taken while packets may still be recorded. Records that were
+  being overwritten during the copy are marked unused and skipped by
+  gpr_trace_decode().
+
+  @return
+  #AR_EOK -- When successful.
+
+  @dependencies
+  None.
+*/
+uint32_t __gpr_cmd_get_trace_image(gpr_trace_image_t *image);
+
+/**
+  Converts a trace ring image into text, one line per record, oldest first.
+
+  @param[in]  image      Ring image from __gpr_cmd_get_trace_image() or a
+                         memory dump.
+  @param[in]  image_size Size of the image in bytes.
+  @param[out] text       Buffer that receives NUL terminated text.
+  @param[in]  text_size  Size of the text buffer. Lines that do not fit are
+                         dropped.
+  @param[out] num_lines  Optional, number of records written to text.
+
+  @detdesc
+  Does not depend on GPR state, so it can be used offline on a ring image
+  saved from another process or device.
+
+  @return
+  #AR_EOK -- When successful.
+  #AR_EBADPARAM -- The image is not a trace ring of this version.
+
+  @dependencies
+  None.
+*/
+uint32_t gpr_trace_decode(const void *image,
+                          uint32_t    image_size,
+                          char_t     *text,
+                          uint32_t    text_size,
+                          uint32_t   *num_lines);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* __GPR_TRACE_API_H__ */
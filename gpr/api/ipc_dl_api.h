@@ -125,6 +125,56 @@ struct ipc_to_gpr_vtbl_t
      None.
    */
     uint32_t (*receive_done)(uint32_t domain_id, void *buf);
+
+   /**
+     Prototype of the optional %send_deferred() function for a data link layer.
+
+     @param[in] domain_id  ID of the domain to which packet is being sent.
+     @param[in] buf        Pointer to the packet.
+     @param[in] length     Size of the packet.
+
+     @detdesc
+     Queues the packet for transmission together with later packets to the
+     same domain. The data link layer must transmit queued packets in order
+     on %flush(), before any packet sent through %send(), and within a bounded
+     time even if %flush() is never called. send_done() is called for each
+     packet once it is transmitted, or when it is dropped after a failed
+     transmission.
+     @par
+     If the function returns an error the packet was not queued and remains
+     owned by the caller.
+     @par
+     Data link layers that do not batch packets leave this pointer NULL and
+     the GPR falls back to %send().
+
+     @return
+     #AR_EOK -- When successful.
+
+     @dependencies
+     None. @newpage
+   */
+    uint32_t (*send_deferred)(uint32_t domain_id, void *buf, uint32_t length);
+
+   /**
+     Prototype of the optional %flush() function for a data link layer.
+
+     @param[in] domain_id  ID of the domain whose queued packets are to be sent.
+
+     @detdesc
+     Transmits all packets queued through %send_deferred(). May be NULL when
+     %send_deferred() is NULL.
+     @par
+     Returns an error when a queued packet could not be transmitted, including
+     packets the data link layer sent and dropped on its own since the last
+     %flush().
+
+     @return
+     #AR_EOK -- When successful.
+
+     @dependencies
+     None.
+   */
+    uint32_t (*flush)(uint32_t domain_id);
 };
 
 
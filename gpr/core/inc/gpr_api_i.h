@@ -13,6 +13,7 @@
  * Includes                                                                    *
  *****************************************************************************/
 #include "gpr_api.h"
+#include "gpr_metrics_api.h"
 #include "ipc_dl_api.h"
 
 #ifdef __cplusplus
@@ -64,6 +65,37 @@ GPR_EXTERNAL uint32_t gpr_drv_init_domain(uint32_t domain_id);
 */
 GPR_INTERNAL uint32_t gpr_drv_deinit(void);
 
+/**
+  Returns the configuration given to gpr_init_v2(), all zero when GPR was
+  initialized with gpr_init(). Datalink layers read it while their ports are
+  initialized.
+
+  @return
+  Pointer to the configuration, never NULL.
+
+  @dependencies
+  None.
+*/
+GPR_INTERNAL const gpr_init_cfg_t *gpr_get_init_cfg(void);
+
+/**
+  Fills in the occupancy of the packet pools, read under the lock that
+  guards each pool.
+
+  @param[out] pool_stats  Array that receives one entry per pool.
+  @param[in]  max_pools   Number of entries in pool_stats.
+  @param[out] num_pools   Number of entries filled in.
+
+  @return
+  #AR_EOK -- When successful.
+
+  @dependencies
+  None.
+*/
+GPR_INTERNAL uint32_t gpr_drv_get_pool_usage(gpr_metrics_pool_stats_t *pool_stats,
+                                             uint32_t                  max_pools,
+                                             uint32_t                 *num_pools);
+
 /** @} */ /* end_addtogroup gpr_core_routines */
 
 /*****************************************************************************
@@ -410,6 +410,18 @@ static uint32_t gpr_drv_util_create_packet_pool_info_arrs(uint32_t
          return AR_EFAILED;
       }
 
+      // only static pools can be reserved for data packets, dynamic pool usage is not tracked per class
+      if ((packet_pool_info[idx].pkt_class > GPR_PKT_CLASS_DATA) ||
+          (packet_pool_info[idx].is_dynamic && (GPR_PKT_CLASS_CONTROL != packet_pool_info[idx].pkt_class)))
+      {
+         AR_MSG(DBG_ERROR_PRIO,
+                "Invalid packet class %lu for pool idx %lu, is_dynamic %lu",
+                packet_pool_info[idx].pkt_class,
+                idx,
+                packet_pool_info[idx].is_dynamic);
+         return AR_EFAILED;
+      }
+
       // if atleast one heap is from index 1, then use index 1 for allocating the array
       if (GPR_HEAP_INDEX_1 == packet_pool_info[idx].heap_index)
       {
@@ -531,9 +543,11 @@ GPR_EXTERNAL uint32_t gpr_drv_internal_init_v2(uint32_t                  default
                                                uint32_t                  num_packet_pools,
                                                gpr_packet_pool_info_v2_t packet_pool_info[])
 {
-   uint32_t rc;
-   uint32_t port_index = 0;
-   uint32_t domain_id  = 0;
+   uint32_t                   rc;
+   uint32_t                   port_index     = 0;
+   uint32_t                   domain_id      = 0;
+   const ar_osal_mutex_attr_t task_lock_attr = { AR_OSAL_MUTEX_ATTR_PRIO_INHERIT, 0 };
+   const ar_osal_mutex_attr_t isr_lock_attr  = { AR_OSAL_MUTEX_ATTR_PRIO_INHERIT | AR_OSAL_MUTEX_ATTR_ADAPTIVE, 0 };
    memset(&gpr_ctxt_struct_t, 0, sizeof(gpr_ctxt_struct_t));
    gpr_deinit_flag = FALSE;
 
@@ -543,13 +557,14 @@ GPR_EXTERNAL uint32_t gpr_drv_internal_init_v2(uint32_t                  default
       goto bailout;
    }
 
-   /* Create gpr mutexes */
-   rc = ar_osal_mutex_create((ar_osal_mutex_t *)&gpr_ctxt_struct_t.gpr_drv_task_lock);
+   /* Create gpr mutexes. The rx thread may run at RT priority, so the owner
+      inherits its priority; the isr lock only guards list updates. */
+   rc = ar_osal_mutex_create_v2((ar_osal_mutex_t *)&gpr_ctxt_struct_t.gpr_drv_task_lock, &task_lock_attr);
    if (rc)
    {
       goto bailout;
    }
-   rc = ar_osal_mutex_create((ar_osal_mutex_t *)&gpr_ctxt_struct_t.gpr_drv_isr_lock);
+   rc = ar_osal_mutex_create_v2((ar_osal_mutex_t *)&gpr_ctxt_struct_t.gpr_drv_isr_lock, &isr_lock_attr);
    if (rc)
    {
       goto bailout;
@@ -606,6 +621,7 @@ GPR_EXTERNAL uint32_t gpr_drv_internal_init_v2(uint32_t                  default
          gpr_ctxt_struct_t.static_pool_arr[new_pool_index].buf_size    = buf_size;
          gpr_ctxt_struct_t.static_pool_arr[new_pool_index].num_packets = num_packets;
          gpr_ctxt_struct_t.static_pool_arr[new_pool_index].heap_index  = packet_pool_info[idx].heap_index;
+         gpr_ctxt_struct_t.static_pool_arr[new_pool_index].pkt_class   = packet_pool_info[idx].pkt_class;
 
          uint32_t gpr_memq_size_per_packet =
             GPR_MEMQ_UNIT_OVERHEAD_V + buf_size + (GPR_DRV_METADATA_ITEMS_V * GPR_MEMQ_BYTES_PER_METADATA_ITEM_V);
@@ -726,13 +742,13 @@ GPR_INTERNAL uint32_t gpr_drv_internal_init(struct ipc_dl_t gpr_ipc_dl_table[],
    packet_pool_info[0].num_packets = num_packets_1;
    packet_pool_info[0].packet_size = buf_size_1;
    packet_pool_info[0].is_dynamic  = FALSE;
-   packet_pool_info[0].reserved    = 0;
+   packet_pool_info[0].pkt_class   = GPR_PKT_CLASS_CONTROL;
 
    packet_pool_info[1].heap_index  = GPR_HEAP_INDEX_DEFAULT;
    packet_pool_info[1].num_packets = num_packets_2;
    packet_pool_info[1].packet_size = buf_size_2;
    packet_pool_info[1].is_dynamic  = FALSE;
-   packet_pool_info[1].reserved    = 0;
+   packet_pool_info[1].pkt_class   = GPR_PKT_CLASS_CONTROL;
 
    struct ipc_dl_v2_t gpr_ipc_dl_v2_table[GPR_PL_NUM_TOTAL_DOMAINS_V];
    memset(&gpr_ipc_dl_v2_table[0], 0, (sizeof(struct ipc_dl_v2_t) * GPR_PL_NUM_TOTAL_DOMAINS_V));
@@ -1190,7 +1206,7 @@ uint32_t __gpr_cmd_get_gpr_packet_info_v2(uint32_t *num_packet_pools, gpr_packet
          packet_pool_info_arr[idx].heap_index  = gpr_ctxt_struct_t.static_pool_arr[idx].heap_index;
          packet_pool_info_arr[idx].num_packets = gpr_ctxt_struct_t.static_pool_arr[idx].num_packets;
          packet_pool_info_arr[idx].packet_size = gpr_ctxt_struct_t.static_pool_arr[idx].buf_size;
-         packet_pool_info_arr[idx].reserved    = 0;
+         packet_pool_info_arr[idx].pkt_class   = gpr_ctxt_struct_t.static_pool_arr[idx].pkt_class;
       }
 
       // populate dynamic pool info
@@ -1200,10 +1216,46 @@ uint32_t __gpr_cmd_get_gpr_packet_info_v2(uint32_t *num_packet_pools, gpr_packet
          packet_pool_info_arr[idx].heap_index  = gpr_ctxt_struct_t.dyn_pool_arr[idx].heap_index;
          packet_pool_info_arr[idx].num_packets = gpr_ctxt_struct_t.dyn_pool_arr[idx].max_num_packets;
          packet_pool_info_arr[idx].packet_size = gpr_ctxt_struct_t.dyn_pool_arr[idx].buf_size;
-         packet_pool_info_arr[idx].reserved    = 0;
+         packet_pool_info_arr[idx].pkt_class   = GPR_PKT_CLASS_CONTROL;
       }
    }
 
    return AR_EOK;
 }
+GPR_INTERNAL uint32_t gpr_drv_get_pool_usage(gpr_metrics_pool_stats_t *pool_stats,
+                                             uint32_t                  max_pools,
+                                             uint32_t                 *num_pools)
+{
+   gpr_drv_pkt_static_pool_info_t *static_pool;
+   gpr_list_t                     *free_q;
+   uint32_t                        num = 0;
+
+   for (uint32_t idx = 0; (idx < gpr_ctxt_struct_t.num_static_packet_pools) && (num < max_pools); idx++, num++)
+   {
+      static_pool                 = &gpr_ctxt_struct_t.static_pool_arr[idx];
+      free_q                      = &static_pool->free_packets_memq->free_q;
+      pool_stats[num].is_dynamic  = FALSE;
+      pool_stats[num].packet_size = static_pool->buf_size;
+      pool_stats[num].num_packets = static_pool->num_packets;
+
+      // The free queue size changes under the queue's own lock
+      free_q->lock_fn();
+      pool_stats[num].num_in_use = static_pool->num_packets - free_q->size;
+      free_q->unlock_fn();
+   }
+
+   for (uint32_t idx = 0; (idx < gpr_ctxt_struct_t.num_dyn_packet_pools) && (num < max_pools); idx++, num++)
+   {
+      pool_stats[num].is_dynamic  = TRUE;
+      pool_stats[num].packet_size = gpr_ctxt_struct_t.dyn_pool_arr[idx].buf_size;
+      pool_stats[num].num_packets = gpr_ctxt_struct_t.dyn_pool_arr[idx].max_num_packets;
+
+      gpr_drv_isr_lock_fn();
+      pool_stats[num].num_in_use = gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets;
+      gpr_drv_isr_unlock_fn();
+   }
+
+   *num_pools = num;
+   return AR_EOK;
+}
 //end of file
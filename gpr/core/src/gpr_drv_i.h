@@ -73,6 +73,7 @@ typedef struct gpr_drv_pkt_static_pool_info_t
    uint32_t          buf_size;
    uint32_t          num_packets;
    gpr_heap_index_t  heap_index;
+   uint16_t          pkt_class; /* GPR_PKT_CLASS_DATA pools only serve data packets */
 } gpr_drv_pkt_static_pool_info_t;
 
 /* Info related to each of the dynamic packet pool, currently only one dynamic pool is supported.*/
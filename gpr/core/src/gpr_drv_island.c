@@ -13,6 +13,8 @@
  * Includes                                                                    *
  *****************************************************************************/
 #include "gpr_drv_i.h"
+#include "gpr_trace_api.h"
+#include "gpr_metrics.h"
 
 /*****************************************************************************
  * Global variables                                                          *
@@ -48,6 +50,121 @@ void gpr_drv_isr_unlock_fn(void)
    (void)ar_osal_mutex_unlock(gpr_ctxt_struct_t.gpr_drv_isr_lock);
 }
 
+/* Opcode type to packet class, see __gpr_cmd_get_packet_class() */
+static uint32_t gpr_opcode_to_class(uint32_t opcode)
+{
+   uint32_t opcode_type = ((opcode & AR_GUID_TYPE_MASK) >> AR_GUID_TYPE_SHIFT);
+
+   if ((AR_GUID_TYPE_DATA_CMD == opcode_type) || (AR_GUID_TYPE_DATA_CMD_RSP == opcode_type) ||
+       (AR_GUID_TYPE_DATA_EVENT == opcode_type))
+   {
+      return GPR_PKT_CLASS_DATA;
+   }
+   return GPR_PKT_CLASS_CONTROL;
+}
+
+/* Allocates from the first static pool of pool_class that fits the packet. */
+static gpr_packet_t *gpr_static_pool_alloc(uint32_t          packet_size,
+                                           gpr_heap_index_t  heap_index,
+                                           uint16_t          pool_class,
+                                           bool_t           *found_packet_pool)
+{
+   for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_static_packet_pools; idx++)
+   {
+      if (packet_size <= gpr_ctxt_struct_t.static_pool_arr[idx].buf_size &&
+          (heap_index == gpr_ctxt_struct_t.static_pool_arr[idx].heap_index) &&
+          (pool_class == gpr_ctxt_struct_t.static_pool_arr[idx].pkt_class))
+      {
+         *found_packet_pool = TRUE;
+         return (gpr_packet_t *)gpr_memq_alloc(gpr_ctxt_struct_t.static_pool_arr[idx].free_packets_memq);
+      }
+   }
+   return NULL;
+}
+
+/**
+  @brief Allocates a free message of the given priority class.
+
+  @detdesc
+  Data packets are allocated from the static pools reserved for them first,
+  so that control bursts cannot exhaust them, then from the shared pools like
+  every other packet.
+
+  @return
+  #AR_EOK when successful.
+*/
+static uint32_t gpr_cmd_alloc_class(uint32_t          alloc_size,
+                                    gpr_heap_index_t  heap_index,
+                                    uint32_t          pkt_class,
+                                    gpr_packet_t    **ret_packet)
+{
+   gpr_packet_t *new_packet  = NULL;
+   uint32_t      packet_size = (GPR_PKT_HEADER_BYTE_SIZE_V + alloc_size);
+
+   if (NULL == ret_packet)
+   {
+      AR_MSG(DBG_ERROR_PRIO, "alloc_error, NULL packet");
+      return AR_EBADPARAM;
+   }
+
+   bool_t found_packet_pool = FALSE;
+   if (GPR_PKT_CLASS_DATA == pkt_class)
+   {
+      new_packet = gpr_static_pool_alloc(packet_size, heap_index, GPR_PKT_CLASS_DATA, &found_packet_pool);
+   }
+   if (NULL == new_packet)
+   {
+      new_packet = gpr_static_pool_alloc(packet_size, heap_index, GPR_PKT_CLASS_CONTROL, &found_packet_pool);
+   }
+
+   // If packet couldnt not be allocated in static pool, check dynamic pool
+   if (NULL == new_packet)
+   {
+      for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_dyn_packet_pools; idx++)
+      {
+         if ((packet_size <= gpr_ctxt_struct_t.dyn_pool_arr[idx].buf_size) &&
+             (gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets <
+              gpr_ctxt_struct_t.dyn_pool_arr[idx].max_num_packets) &&
+             (heap_index == gpr_ctxt_struct_t.dyn_pool_arr[idx].heap_index))
+         {
+            found_packet_pool = TRUE;
+
+            gpr_allocate_dynamic_packet(&new_packet, packet_size);
+            if (new_packet == NULL)
+            {
+               AR_MSG(DBG_ERROR_PRIO, "alloc_error unsupported size %lu, heap_index: %lu", alloc_size, heap_index);
+               return AR_ENORESOURCE;
+            }
+            gpr_drv_isr_lock_fn();
+            gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets++;
+            gpr_drv_isr_unlock_fn();
+         }
+      }
+   }
+
+   /* Check if packet has been allocated from a dynamic/static pool.*/
+   if (new_packet == NULL)
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "alloc_error, NULL packet found_packet_pool %lu, alloc size %lu heap_index %lu",
+             found_packet_pool,
+             alloc_size,
+             heap_index);
+      return AR_ENORESOURCE;
+   }
+
+   ar_mem_set(new_packet, 0, sizeof(gpr_packet_t));
+   new_packet->header = GPR_SET_FIELD(GPR_PKT_VERSION, GPR_PKT_VERSION_V) |
+                        GPR_SET_FIELD(GPR_PKT_HEADER_SIZE, GPR_PKT_HEADER_WORD_SIZE_V) |
+                        GPR_SET_FIELD(GPR_PKT_PACKET_SIZE, packet_size);
+   new_packet->opcode      = GPR_UNDEFINED_ID_V;
+   new_packet->client_data = GPR_PKT_INIT_CLIENT_DATA_V;
+   new_packet->reserved    = GPR_PKT_INIT_RESERVED_V;
+   *ret_packet             = new_packet;
+
+   return AR_EOK;
+}
+
 /**
   @brief Sends an asynchronous message to other modules.
 
@@ -66,8 +183,30 @@ void gpr_drv_isr_unlock_fn(void)
   #AR_EOK when successful.
 */
 uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
+{
+   return __gpr_cmd_async_send_v2(packet, GPR_SEND_FLAG_NONE);
+}
+
+/**
+  @brief Sends an asynchronous message to other modules, optionally allowing
+  the datalink to defer the transmission.
+
+  @param[in] packet      Packet (message) to send.
+  @param[in] send_flags  GPR_SEND_FLAG_* bitmask.
+
+  @detdesc
+  With GPR_SEND_FLAG_DEFER_FLUSH the packet is handed to the datalink's
+  send_deferred function when it provides one, so that a burst of packets can
+  be transmitted together. See __gpr_cmd_flush().
+
+  @return
+  #AR_EOK when successful.
+*/
+uint32_t __gpr_cmd_async_send_v2(gpr_packet_t *packet, uint32_t send_flags)
 {
    uint32_t rc = AR_EOK;
+   uint32_t (*ipc_send_fn)(uint32_t domain_id, void *buf, uint32_t length);
+
    if (NULL == packet)
    {
       AR_MSG(DBG_ERROR_PRIO, "Param pointer is NULL");
@@ -91,6 +230,10 @@ uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
    {
       // Log incoming and outgoing packets
       gpr_log_packet(packet);
+      gpr_trace_packet(packet,
+                       (gpr_ctxt_struct_t.default_domain_id == packet->dst_domain_id) ? GPR_TRACE_DIR_RX
+                                                                                     : GPR_TRACE_DIR_TX);
+      gpr_metrics_packet(packet, (gpr_ctxt_struct_t.default_domain_id == packet->dst_domain_id));
    }
 
    if (GPR_PL_MAX_DOMAIN_ID_V < domain_id)
@@ -110,6 +253,12 @@ uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
       return AR_EFAILED;
    }
 
+   ipc_send_fn = local_gpr_ipc_dl_table[domain_id].fn_ptr->send;
+   if ((send_flags & GPR_SEND_FLAG_DEFER_FLUSH) && (NULL != local_gpr_ipc_dl_table[domain_id].fn_ptr->send_deferred))
+   {
+      ipc_send_fn = local_gpr_ipc_dl_table[domain_id].fn_ptr->send_deferred;
+   }
+
    // check if the packet is from a static packet pool.
    // if so, set memq metadata and then send the packet
    // else, just call send
@@ -141,7 +290,7 @@ uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
          /* Sets the packet ownership to destination before sending */
          gpr_memq_node_set_metadata(block, packet, 0, packet->dst_port);
 
-         rc = local_gpr_ipc_dl_table[domain_id].fn_ptr->send(domain_id, packet, packet_len);
+         rc = ipc_send_fn(domain_id, packet, packet_len);
          if (rc)
          {
             /* Sets the packet owner to source if send fails for any reason */
@@ -170,7 +319,7 @@ uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
              packet->dst_domain_id,
              packet->dst_port);
 #endif
-      rc = local_gpr_ipc_dl_table[domain_id].fn_ptr->send(domain_id, packet, packet_len);
+      rc = ipc_send_fn(domain_id, packet, packet_len);
 
       if (rc)
       {
@@ -186,6 +335,36 @@ uint32_t __gpr_cmd_async_send(gpr_packet_t *packet)
 
    return rc;
 }
+
+/**
+  @brief Sends all packets queued with GPR_SEND_FLAG_DEFER_FLUSH to a domain.
+
+  @param[in] dst_domain_id  Domain id of the destination.
+
+  @return
+  #AR_EOK when successful.
+*/
+uint32_t __gpr_cmd_flush(uint32_t dst_domain_id)
+{
+   if (GPR_PL_MAX_DOMAIN_ID_V < dst_domain_id)
+   {
+      AR_MSG(DBG_ERROR_PRIO,
+             "GPR flush: Domain ID out of bounds %lu, Max ID supported %lu",
+             dst_domain_id,
+             GPR_PL_MAX_DOMAIN_ID_V);
+      return AR_EBADPARAM;
+   }
+
+   if ((NULL == local_gpr_ipc_dl_table[dst_domain_id].fn_ptr) ||
+       (NULL == local_gpr_ipc_dl_table[dst_domain_id].fn_ptr->flush))
+   {
+      /* Datalink sends every packet immediately, nothing to flush */
+      return AR_EOK;
+   }
+
+   return local_gpr_ipc_dl_table[dst_domain_id].fn_ptr->flush(dst_domain_id);
+}
+
 /**
   @brief Allocates a free message for delivery.
 
@@ -223,74 +402,31 @@ uint32_t __gpr_cmd_alloc(uint32_t alloc_size, gpr_packet_t **ret_packet)
 */
 uint32_t __gpr_cmd_alloc_v2(uint32_t alloc_size, gpr_heap_index_t heap_index, gpr_packet_t **ret_packet)
 {
-   gpr_memq_block_t *block;
-   gpr_packet_t     *new_packet  = NULL;
-   uint32_t          packet_size = (GPR_PKT_HEADER_BYTE_SIZE_V + alloc_size);
-
-   if (NULL == ret_packet)
-   {
-      AR_MSG(DBG_ERROR_PRIO, "alloc_error, NULL packet");
-      return AR_EBADPARAM;
-   }
+   return gpr_cmd_alloc_class(alloc_size, heap_index, GPR_PKT_CLASS_CONTROL, ret_packet);
+}
 
-   bool_t found_packet_pool = FALSE;
-   for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_static_packet_pools; idx++)
-   {
-      if (packet_size <= gpr_ctxt_struct_t.static_pool_arr[idx].buf_size &&
-          (heap_index == gpr_ctxt_struct_t.static_pool_arr[idx].heap_index))
-      {
-         found_packet_pool = TRUE;
+/**
+  @brief Gets the priority class of a packet.
 
-         block      = gpr_ctxt_struct_t.static_pool_arr[idx].free_packets_memq;
-         new_packet = (gpr_packet_t *)gpr_memq_alloc(block);
-         break;
-      }
-   }
+  @param[in] packet  Packet to classify.
 
-   // If packet couldnt not be allocated in static pool, check dynamic pool
-   if (NULL == new_packet)
+  @return
+  GPR_PKT_CLASS_CONTROL or GPR_PKT_CLASS_DATA.
+*/
+uint32_t __gpr_cmd_get_packet_class(gpr_packet_t *packet)
+{
+   if (NULL == packet)
    {
-      for (uint32_t idx = 0; idx < gpr_ctxt_struct_t.num_dyn_packet_pools; idx++)
-      {
-         if ((packet_size <= gpr_ctxt_struct_t.dyn_pool_arr[idx].buf_size) &&
-             (gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets <
-              gpr_ctxt_struct_t.dyn_pool_arr[idx].max_num_packets) &&
-             (heap_index == gpr_ctxt_struct_t.dyn_pool_arr[idx].heap_index))
-         {
-            found_packet_pool = TRUE;
-
-            gpr_allocate_dynamic_packet(&new_packet, packet_size);
-            if (new_packet == NULL)
-            {
-               AR_MSG(DBG_ERROR_PRIO, "alloc_error unsupported size %lu, heap_index: %lu", alloc_size, heap_index);
-               return AR_ENORESOURCE;
-            }
-            gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets++;
-         }
-      }
+      return GPR_PKT_CLASS_CONTROL;
    }
 
-   /* Check if packet has been allocated from a dynamic/static pool.*/
-   if (new_packet == NULL)
+   // Basic responses take the class of the command they complete.
+   if ((GPR_IBASIC_RSP_RESULT == packet->opcode) &&
+       (GPR_PKT_GET_PAYLOAD_BYTE_SIZE(packet->header) >= sizeof(gpr_ibasic_rsp_result_t)))
    {
-      AR_MSG(DBG_ERROR_PRIO,
-             "alloc_error, NULL packet found_packet_pool %lu, alloc size %lu heap_index %lu",
-             found_packet_pool,
-             alloc_size,
-             heap_index);
-      return AR_ENORESOURCE;
+      return gpr_opcode_to_class(GPR_PKT_GET_PAYLOAD(gpr_ibasic_rsp_result_t, packet)->opcode);
    }
-
-   ar_mem_set(new_packet, 0, sizeof(gpr_packet_t));
-   new_packet->header = GPR_SET_FIELD(GPR_PKT_VERSION, GPR_PKT_VERSION_V) |
-                        GPR_SET_FIELD(GPR_PKT_HEADER_SIZE, GPR_PKT_HEADER_WORD_SIZE_V) |
-                        GPR_SET_FIELD(GPR_PKT_PACKET_SIZE, packet_size);
-   new_packet->opcode      = GPR_UNDEFINED_ID_V;
-   new_packet->client_data = GPR_PKT_INIT_CLIENT_DATA_V;
-   new_packet->reserved    = GPR_PKT_INIT_RESERVED_V;
-   *ret_packet             = new_packet;
-
-   return AR_EOK;
+   return gpr_opcode_to_class(packet->opcode);
 }
 
 /**
@@ -348,7 +484,9 @@ uint32_t __gpr_cmd_free(gpr_packet_t *packet)
          {
             if (gpr_check_and_free_dynamic_packet(packet) == AR_EOK)
             {
+               gpr_drv_isr_lock_fn();
                gpr_ctxt_struct_t.dyn_pool_arr[idx].curr_num_packets--;
+               gpr_drv_isr_unlock_fn();
                return AR_EOK;
             }
          }
@@ -439,7 +577,7 @@ uint32_t __gpr_cmd_alloc_ext_v2(gpr_cmd_alloc_ext_v2_t *args)
       return AR_EBADPARAM;
    }
 
-   rc = __gpr_cmd_alloc_v2(args->payload_size, args->heap_index, &new_packet);
+   rc = gpr_cmd_alloc_class(args->payload_size, args->heap_index, gpr_opcode_to_class(args->opcode), &new_packet);
    if (rc)
    {
       return rc;
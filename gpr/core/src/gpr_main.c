@@ -16,6 +16,7 @@
 #include "ar_osal_error.h"
 #include "ar_types.h"
 #include "gpr_log.h"
+#include "gpr_metrics.h"
 #include "gpr_api_i.h"
 #include "ar_msg.h"
 
@@ -24,6 +25,7 @@
  ****************************************************************************/
 bool_t gpr_init_flag = FALSE;
 bool_t gpr_init_domain_flags[GPR_PL_NUM_TOTAL_DOMAINS_V] = {FALSE};
+static gpr_init_cfg_t gpr_init_cfg;
 
 /*****************************************************************************
  * Core Routine Implementations                                              *
@@ -55,10 +57,64 @@ GPR_EXTERNAL uint32_t gpr_init(void)
       return AR_EFAILED;
    }
 #endif
+   if (AR_EOK != gpr_metrics_init())
+   {
+      AR_MSG(DBG_ERROR_PRIO, "GPR metrics init failed, metrics are not available");
+   }
    gpr_init_flag = TRUE;
    return AR_EOK;
 }
 
+/**
+  @brief gpr_init function with receive thread configuration.
+
+  @detdesc
+  The configuration is kept until gpr_deinit() and read by the datalink layers
+  through gpr_get_init_cfg() while gpr_drv_init() opens their ports.
+
+  @return
+  #AR_EOK when successful.
+*/
+GPR_EXTERNAL uint32_t gpr_init_v2(const gpr_init_cfg_t *cfg)
+{
+   uint32_t rc;
+
+   if (gpr_init_flag)
+   {
+      AR_MSG(DBG_HIGH_PRIO, "GPR is already initialized, rx thread cfg ignored");
+      return AR_EOK;
+   }
+   if (NULL != cfg)
+   {
+      if ((cfg->rx_thread_policy > GPR_THREAD_POLICY_OTHER) ||
+          (cfg->ctrl_thread.policy > GPR_THREAD_POLICY_OTHER) ||
+          (cfg->tx_thread.policy > GPR_THREAD_POLICY_OTHER) ||
+          (cfg->rx_thread_mode > GPR_RX_THREAD_MODE_SPLIT_CONTROL))
+      {
+         AR_MSG(DBG_ERROR_PRIO,
+                "GPR init: invalid thread policy %lu/%lu/%lu or mode %lu",
+                cfg->rx_thread_policy,
+                cfg->ctrl_thread.policy,
+                cfg->tx_thread.policy,
+                cfg->rx_thread_mode);
+         return AR_EBADPARAM;
+      }
+      gpr_init_cfg = *cfg;
+   }
+
+   rc = gpr_init();
+   if (AR_EOK != rc)
+   {
+      memset(&gpr_init_cfg, 0, sizeof(gpr_init_cfg));
+   }
+   return rc;
+}
+
+GPR_INTERNAL const gpr_init_cfg_t *gpr_get_init_cfg(void)
+{
+   return &gpr_init_cfg;
+}
+
 /**
   @brief Enhanced gpr_init function to allow domain based initialization.
 
@@ -96,6 +152,10 @@ GPR_EXTERNAL uint32_t gpr_init_domain(uint32_t domain_id)
       return AR_EFAILED;
    }
 #endif
+   if (AR_EOK != gpr_metrics_init())
+   {
+      AR_MSG(DBG_ERROR_PRIO, "GPR metrics init failed, metrics are not available");
+   }
    gpr_init_flag = TRUE;
    gpr_init_domain_flags[domain_id] = TRUE;
    return AR_EOK;
@@ -109,6 +169,9 @@ GPR_EXTERNAL uint32_t gpr_deinit(void)
 
    (void)gpr_log_deinit();
 
+   (void)gpr_metrics_deinit();
+
+   memset(&gpr_init_cfg, 0, sizeof(gpr_init_cfg));
    gpr_init_flag = FALSE;
    return AR_EOK;
 }
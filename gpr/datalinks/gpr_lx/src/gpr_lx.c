@@ -14,6 +14,8 @@
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <time.h>
+#include <sys/uio.h>
 #include "ar_osal_log.h"
 
 #ifdef GPR_USE_CUTILS
@@ -25,7 +27,10 @@
 #endif
 
 #include <pthread.h>
+#include <sched.h>
 #include "gpr_comdef.h"
+#include "gpr_api_i.h"
+#include "gpr_api_inline.h"
 #include "ipc_dl_api.h"
 #include "gpr_ids_domains.h"
 #include "ar_osal_error.h"
@@ -36,6 +41,13 @@
 #define GPR_DL_LX_APPS_SPF_DRV "/dev/aud_pasthru_apps"
 #define GPR_DL_LX_BUF_SIZE 4096 /*bytes*/
 #define GPR_DL_LX_NO_OF_BUFFERS 8
+#define GPR_DL_LX_RX_THREAD_PRIORITY 3
+/*
+ * Deferred packets are written with a single writev() once this many are
+ * queued, on flush, or when the oldest one has waited GPR_DL_LX_TX_WINDOW_US.
+ */
+#define GPR_DL_LX_TX_BATCH_MAX 16
+#define GPR_DL_LX_TX_WINDOW_US 500
 
 /** Data receive notification callback type*/
 typedef uint32_t (*gpr_dl_lx_receive_cb)(void *ptr, uint32_t length);
@@ -48,10 +60,23 @@ typedef struct gpr_dl_lx_buf{
     void *buffer;
 }gpr_dl_lx_buf_t;
 
+typedef struct gpr_dl_lx_rx_pkt{
+    struct listnode node;
+    void *buffer;
+    uint32_t size;
+}gpr_dl_lx_rx_pkt_t;
+
 typedef struct gpr_dl_lx_port{
     uint32_t domain_id;
     pthread_t receiver_thread;
     bool thread_exit;
+    /* control dispatch thread, see GPR_RX_THREAD_MODE_SPLIT_CONTROL */
+    bool split_control;
+    bool ctrl_thread_exit;
+    pthread_t ctrl_thread;
+    pthread_mutex_t ctrl_lock;
+    pthread_cond_t ctrl_cond;
+    struct listnode ctrl_list;
     gpr_dl_lx_receive_cb rx_cb;
     gpr_dl_lx_send_done_cb send_done;
     int drv_fd;
@@ -59,6 +84,18 @@ typedef struct gpr_dl_lx_port{
     struct listnode buff_list;
     pthread_mutex_t buff_list_lock;
     int buf_cnt;
+    /* deferred send queue, see gpr_dl_lx_send_deferred() */
+    bool tx_batching;
+    bool tx_thread_exit;
+    pthread_t tx_flush_thread;
+    pthread_mutex_t tx_lock;
+    pthread_cond_t tx_cond;
+    struct iovec tx_iov[GPR_DL_LX_TX_BATCH_MAX];
+    uint32_t tx_cnt;
+    struct timespec tx_first_ts;
+    /* deferred packets dropped so far, and the error reported by the next flush */
+    uint32_t tx_drop_cnt;
+    uint32_t tx_pending_error;
 } gpr_dl_lx_port_t;
 
 /*Array of structure pointers each member pointer corresponds to one domain*/
@@ -68,11 +105,17 @@ static uint32_t gpr_dl_lx_send(uint32_t domain_id, void *buf, uint32_t size);
 
 static uint32_t gpr_dl_lx_receive_done(uint32_t domain_id, void *buf);
 
+static uint32_t gpr_dl_lx_send_deferred(uint32_t domain_id, void *buf, uint32_t size);
+
+static uint32_t gpr_dl_lx_flush(uint32_t domain_id);
+
 /*ipc datalink function table*/
 static ipc_to_gpr_vtbl_t gpr_dl_lx_vtbl =
 {
    gpr_dl_lx_send,
    gpr_dl_lx_receive_done,
+   gpr_dl_lx_send_deferred,
+   gpr_dl_lx_flush,
 };
 
 void deallocate_buffers(gpr_dl_lx_port_t *dl_lx_port)
@@ -187,8 +230,183 @@ uint32_t put_buffer(gpr_dl_lx_port_t *dl_lx_port, void *buf)
     return AR_EOK;
 }
 
+/* Datalink threads, each scheduled with its own gpr_init_cfg_t settings */
+enum {
+    GPR_DL_LX_RX_THREAD,
+    GPR_DL_LX_CTRL_THREAD,
+    GPR_DL_LX_TX_THREAD,
+};
+
+/*
+ * Resolves the scheduling of a datalink thread. Fields the caller left zero
+ * for the control and tx threads take the receive thread settings, the
+ * control thread then running one priority level below a configured one.
+ */
+static void gpr_dl_lx_get_thread_cfg(int thread, gpr_thread_cfg_t *tcfg)
+{
+    const gpr_init_cfg_t *cfg = gpr_get_init_cfg();
+    const gpr_thread_cfg_t *own = NULL;
+
+    tcfg->policy = cfg->rx_thread_policy;
+    tcfg->priority = cfg->rx_thread_priority;
+    tcfg->cpu_mask = cfg->rx_thread_cpu_mask;
+
+    if (thread == GPR_DL_LX_CTRL_THREAD) {
+        own = &cfg->ctrl_thread;
+        if ((own->priority == 0) && (tcfg->priority > 1))
+            tcfg->priority--;
+    } else if (thread == GPR_DL_LX_TX_THREAD) {
+        own = &cfg->tx_thread;
+    }
+
+    if (own == NULL)
+        return;
+    if (own->policy != GPR_THREAD_POLICY_DEFAULT)
+        tcfg->policy = own->policy;
+    if (own->priority)
+        tcfg->priority = own->priority;
+    if (own->cpu_mask)
+        tcfg->cpu_mask = own->cpu_mask;
+}
+
+/*
+ * Pins the calling thread to the CPUs of its gpr_init_v2() settings. Done
+ * from the thread itself since pthread_setaffinity_np() is not available on
+ * bionic.
+ */
+static void gpr_dl_lx_set_thread_affinity(int thread)
+{
+    gpr_thread_cfg_t tcfg;
+    cpu_set_t cpus;
+    uint32_t cpu;
+
+    gpr_dl_lx_get_thread_cfg(thread, &tcfg);
+    if (tcfg.cpu_mask == 0)
+        return;
+
+    CPU_ZERO(&cpus);
+    for (cpu = 0; (cpu < 64) && (cpu < CPU_SETSIZE); cpu++) {
+        if (tcfg.cpu_mask & (1ULL << cpu))
+            CPU_SET(cpu, &cpus);
+    }
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) < 0) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d set affinity 0x%llx failed %d", __func__, __LINE__,
+                (unsigned long long)tcfg.cpu_mask, errno);
+    }
+}
+
+/*
+ * Creates a datalink thread with the scheduling policy and priority given to
+ * gpr_init_v2(). Without a configuration the thread is created the way it
+ * always was, inheriting the caller's policy and priority.
+ */
+static int gpr_dl_lx_create_thread(pthread_t *thread, const char *name,
+                                   void *(*thread_fn)(void *), void *arg,
+                                   int thread_id)
+{
+    gpr_thread_cfg_t tcfg;
+    pthread_attr_t tattr;
+    struct sched_param param = { .sched_priority = GPR_DL_LX_RX_THREAD_PRIORITY };
+    int policy = SCHED_FIFO;
+    int status;
+
+    gpr_dl_lx_get_thread_cfg(thread_id, &tcfg);
+    if (tcfg.policy == GPR_THREAD_POLICY_RR)
+        policy = SCHED_RR;
+    else if (tcfg.policy == GPR_THREAD_POLICY_OTHER)
+        policy = SCHED_OTHER;
+    if (tcfg.priority)
+        param.sched_priority = tcfg.priority;
+    if (param.sched_priority > sched_get_priority_max(policy))
+        param.sched_priority = sched_get_priority_max(policy);
+    if (param.sched_priority < sched_get_priority_min(policy))
+        param.sched_priority = sched_get_priority_min(policy);
+
+    pthread_attr_init(&tattr);
+    pthread_attr_setschedparam(&tattr, &param);
+    pthread_attr_setschedpolicy(&tattr, policy);
+    if ((tcfg.policy != GPR_THREAD_POLICY_DEFAULT) || tcfg.priority)
+        pthread_attr_setinheritsched(&tattr, PTHREAD_EXPLICIT_SCHED);
+
+    status = pthread_create(thread, &tattr, thread_fn, arg);
+    if (status == EPERM) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d no permission for policy %d priority %d, inheriting caller's",
+                __func__, __LINE__, policy, param.sched_priority);
+        pthread_attr_setinheritsched(&tattr, PTHREAD_INHERIT_SCHED);
+        status = pthread_create(thread, &tattr, thread_fn, arg);
+    }
+    pthread_attr_destroy(&tattr);
+    if (status == 0)
+        pthread_setname_np(*thread, name);
+    return status;
+}
+
 #define NUM_FDS 2
 
+/*
+ * Data class packets stay on the receiver thread in
+ * GPR_RX_THREAD_MODE_SPLIT_CONTROL.
+ */
+static bool gpr_dl_lx_is_data_packet(void *buf, uint32_t size)
+{
+    gpr_packet_t *packet = (gpr_packet_t *)buf;
+
+    if ((size < sizeof(gpr_packet_t)) ||
+        (GPR_PKT_GET_PACKET_BYTE_SIZE(packet->header) > size))
+        return false;
+    return __gpr_cmd_get_packet_class(packet) == GPR_PKT_CLASS_DATA;
+}
+
+static uint32_t gpr_dl_lx_queue_ctrl_packet(gpr_dl_lx_port_t *dl_lx_port, void *buf, uint32_t size)
+{
+    gpr_dl_lx_rx_pkt_t *rx_pkt;
+
+    rx_pkt = (gpr_dl_lx_rx_pkt_t *)malloc(sizeof(gpr_dl_lx_rx_pkt_t));
+    if (rx_pkt == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d malloc failed", __func__, __LINE__);
+        return AR_ENOMEMORY;
+    }
+    rx_pkt->buffer = buf;
+    rx_pkt->size = size;
+    pthread_mutex_lock(&dl_lx_port->ctrl_lock);
+    list_add_tail(&dl_lx_port->ctrl_list, &rx_pkt->node);
+    pthread_cond_signal(&dl_lx_port->ctrl_cond);
+    pthread_mutex_unlock(&dl_lx_port->ctrl_lock);
+    return AR_EOK;
+}
+
+void *ctrl_thread_loop(void *priv_data)
+{
+    gpr_dl_lx_port_t *dl_lx_port = (gpr_dl_lx_port_t *)priv_data;
+    gpr_dl_lx_rx_pkt_t *rx_pkt;
+    struct listnode *item;
+    uint32_t status;
+
+    gpr_dl_lx_set_thread_affinity(GPR_DL_LX_CTRL_THREAD);
+    pthread_mutex_lock(&dl_lx_port->ctrl_lock);
+    while (!dl_lx_port->ctrl_thread_exit) {
+        if (list_empty(&dl_lx_port->ctrl_list)) {
+            pthread_cond_wait(&dl_lx_port->ctrl_cond, &dl_lx_port->ctrl_lock);
+            continue;
+        }
+        item = list_head(&dl_lx_port->ctrl_list);
+        list_remove(item);
+        pthread_mutex_unlock(&dl_lx_port->ctrl_lock);
+
+        rx_pkt = node_to_item(item, gpr_dl_lx_rx_pkt_t, node);
+        status = dl_lx_port->rx_cb(rx_pkt->buffer, rx_pkt->size);
+        if (status != AR_EOK) {
+            AR_LOG_ERR(LOG_TAG,"%s:%d receive callback failed", __func__, __LINE__);
+        }
+        free(rx_pkt);
+
+        pthread_mutex_lock(&dl_lx_port->ctrl_lock);
+    }
+    pthread_mutex_unlock(&dl_lx_port->ctrl_lock);
+    AR_LOG_DEBUG(LOG_TAG,"%s:%d exiting ctrl thread", __func__, __LINE__);
+    return NULL;
+}
+
 void *receiver_thread_loop(void *priv_data)
 {
     uint32_t status;
@@ -201,6 +419,7 @@ void *receiver_thread_loop(void *priv_data)
         AR_LOG_ERR(LOG_TAG,"%s:%d invalid port instance", __func__, __LINE__);
         return NULL;
     }
+    gpr_dl_lx_set_thread_affinity(GPR_DL_LX_RX_THREAD);
     pfd = (struct pollfd *)calloc(NUM_FDS, sizeof(struct pollfd));
     if (pfd == NULL) {
         AR_LOG_ERR(LOG_TAG,"%s:%d calloc failed for poll fd", __func__, __LINE__);
@@ -258,6 +477,10 @@ void *receiver_thread_loop(void *priv_data)
             if ((receive_size <= 0) || (receive_size > GPR_DL_LX_BUF_SIZE)) {
                 AR_LOG_ERR(LOG_TAG,"%s:%d read failed %d", __func__, __LINE__, errno);
                 put_buffer(dl_lx_port, buf);
+            } else if (dl_lx_port->split_control &&
+                       !gpr_dl_lx_is_data_packet(buf, receive_size)) {
+                if (gpr_dl_lx_queue_ctrl_packet(dl_lx_port, buf, receive_size) != AR_EOK)
+                    put_buffer(dl_lx_port, buf);
             } else {
                 if (dl_lx_port->rx_cb) {
                     status = dl_lx_port->rx_cb(buf, receive_size);
@@ -283,14 +506,181 @@ void *receiver_thread_loop(void *priv_data)
     return NULL;
 }
 
+/*
+ * Writes all queued packets with writev() and empties the queue. The packets
+ * are copied to iov so that they can be completed with
+ * gpr_dl_lx_tx_complete() after tx_lock is dropped; the first *sent_cnt of
+ * them reached the driver. Returns 0 or the errno of the failed write.
+ *
+ * The audio packet drivers implement .write only, so the kernel issues one
+ * driver write per iovec and packet boundaries are preserved.
+ */
+static int gpr_dl_lx_tx_flush_locked(gpr_dl_lx_port_t *dl_lx_port, struct iovec *iov,
+                                     uint32_t *cnt, uint32_t *sent_cnt)
+{
+    ssize_t written;
+    uint32_t prev_sent_cnt;
+    int error = 0;
+
+    *cnt = dl_lx_port->tx_cnt;
+    *sent_cnt = 0;
+    memcpy(iov, dl_lx_port->tx_iov, dl_lx_port->tx_cnt * sizeof(struct iovec));
+    dl_lx_port->tx_cnt = 0;
+
+    while (*sent_cnt < *cnt) {
+        written = writev(dl_lx_port->drv_fd, &iov[*sent_cnt], *cnt - *sent_cnt);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            error = errno;
+            break;
+        }
+        prev_sent_cnt = *sent_cnt;
+        while ((*sent_cnt < *cnt) && (written >= (ssize_t)iov[*sent_cnt].iov_len)) {
+            written -= iov[*sent_cnt].iov_len;
+            (*sent_cnt)++;
+        }
+        if ((written > 0) || (*sent_cnt == prev_sent_cnt)) {
+            /* the driver takes whole packets, a short write is a failure */
+            error = EIO;
+            break;
+        }
+    }
+    AR_LOG_DEBUG(LOG_TAG,"%s:Flushed %d of %d packets",__func__, *sent_cnt, *cnt);
+    return error;
+}
+
+/*
+ * Completes packets returned by gpr_dl_lx_tx_flush_locked(). Packets that
+ * were not written are dropped, except own_buf which is left to the caller.
+ * When the caller cannot return the error to the sender, report_later keeps
+ * it for the next gpr_dl_lx_flush() on the port.
+ */
+static uint32_t gpr_dl_lx_tx_complete(gpr_dl_lx_port_t *dl_lx_port, struct iovec *iov,
+                                      uint32_t cnt, uint32_t sent_cnt, int error,
+                                      void *own_buf, bool report_later)
+{
+    uint32_t status;
+    uint32_t i, drop_cnt = 0;
+
+    for (i = 0; i < cnt; i++) {
+        if (i >= sent_cnt) {
+            if (iov[i].iov_base == own_buf)
+                continue;
+            drop_cnt++;
+        }
+        dl_lx_port->send_done(iov[i].iov_base, iov[i].iov_len);
+    }
+
+    if (sent_cnt == cnt)
+        return AR_EOK;
+    status = (error == ENETRESET) ? AR_ESUBSYSRESET : AR_EFAILED;
+
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    dl_lx_port->tx_drop_cnt += drop_cnt;
+    if (report_later && (drop_cnt != 0))
+        dl_lx_port->tx_pending_error = status;
+    AR_LOG_ERR(LOG_TAG,"%s:%d write to driver failed %d, dropped %d deferred packets (%d total)",
+            __func__, __LINE__, error, drop_cnt, dl_lx_port->tx_drop_cnt);
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+    return status;
+}
+
+static void gpr_dl_lx_tx_deadline(gpr_dl_lx_port_t *dl_lx_port, struct timespec *ts)
+{
+    *ts = dl_lx_port->tx_first_ts;
+    ts->tv_nsec += GPR_DL_LX_TX_WINDOW_US * 1000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+void *tx_flush_thread_loop(void *priv_data)
+{
+    gpr_dl_lx_port_t *dl_lx_port = (gpr_dl_lx_port_t *)priv_data;
+    struct iovec iov[GPR_DL_LX_TX_BATCH_MAX];
+    struct timespec deadline, now;
+    uint32_t cnt, sent_cnt;
+    int error;
+
+    gpr_dl_lx_set_thread_affinity(GPR_DL_LX_TX_THREAD);
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    while (!dl_lx_port->tx_thread_exit) {
+        if (dl_lx_port->tx_cnt == 0) {
+            pthread_cond_wait(&dl_lx_port->tx_cond, &dl_lx_port->tx_lock);
+            continue;
+        }
+        gpr_dl_lx_tx_deadline(dl_lx_port, &deadline);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((now.tv_sec < deadline.tv_sec) ||
+            ((now.tv_sec == deadline.tv_sec) && (now.tv_nsec < deadline.tv_nsec))) {
+            pthread_cond_timedwait(&dl_lx_port->tx_cond, &dl_lx_port->tx_lock, &deadline);
+            continue;
+        }
+        error = gpr_dl_lx_tx_flush_locked(dl_lx_port, iov, &cnt, &sent_cnt);
+        pthread_mutex_unlock(&dl_lx_port->tx_lock);
+        gpr_dl_lx_tx_complete(dl_lx_port, iov, cnt, sent_cnt, error, NULL, true);
+        pthread_mutex_lock(&dl_lx_port->tx_lock);
+    }
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+    AR_LOG_DEBUG(LOG_TAG,"%s:%d exiting tx flush thread", __func__, __LINE__);
+    return NULL;
+}
+
+/*
+ * Stops the control thread and returns the packets it did not dispatch to
+ * the receive buffer pool.
+ */
+static void gpr_dl_lx_stop_ctrl_thread(gpr_dl_lx_port_t *dl_lx_port)
+{
+    gpr_dl_lx_rx_pkt_t *rx_pkt;
+    struct listnode *item;
+
+    if (!dl_lx_port->split_control)
+        return;
+
+    pthread_mutex_lock(&dl_lx_port->ctrl_lock);
+    dl_lx_port->ctrl_thread_exit = true;
+    pthread_cond_broadcast(&dl_lx_port->ctrl_cond);
+    pthread_mutex_unlock(&dl_lx_port->ctrl_lock);
+    pthread_join(dl_lx_port->ctrl_thread, NULL);
+    dl_lx_port->split_control = false;
+
+    while (!list_empty(&dl_lx_port->ctrl_list)) {
+        item = list_head(&dl_lx_port->ctrl_list);
+        list_remove(item);
+        rx_pkt = node_to_item(item, gpr_dl_lx_rx_pkt_t, node);
+        put_buffer(dl_lx_port, rx_pkt->buffer);
+        free(rx_pkt);
+    }
+}
+
+/*
+ * Releases a port whose setup failed part way. The receiver and tx flush
+ * threads must not be running.
+ */
+static void gpr_dl_lx_free_port(gpr_dl_lx_port_t *dl_lx_port)
+{
+    gpr_dl_lx_stop_ctrl_thread(dl_lx_port);
+    deallocate_buffers(dl_lx_port);
+    pthread_cond_destroy(&dl_lx_port->ctrl_cond);
+    pthread_mutex_destroy(&dl_lx_port->ctrl_lock);
+    pthread_cond_destroy(&dl_lx_port->tx_cond);
+    pthread_mutex_destroy(&dl_lx_port->tx_lock);
+    pthread_mutex_destroy(&dl_lx_port->buff_list_lock);
+    close(dl_lx_port->intpipe[0]);
+    close(dl_lx_port->intpipe[1]);
+    close(dl_lx_port->drv_fd);
+    free(dl_lx_port);
+}
 
 static gpr_dl_lx_port_t * gpr_dl_lx_local_init(uint32_t src_domain_id, uint32_t dst_domain_id)
 {
     gpr_dl_lx_port_t *dl_lx_port;
     uint32_t status = 0;
     char *drv_name = NULL;
-    pthread_attr_t tattr;
-    struct sched_param param = { .sched_priority = 3 };
+    pthread_condattr_t cattr;
 
     if ((dst_domain_id < 0) || (dst_domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V)
         || (src_domain_id < 0) || (src_domain_id >= GPR_PL_NUM_TOTAL_DOMAINS_V)) {
@@ -339,31 +729,61 @@ static gpr_dl_lx_port_t * gpr_dl_lx_local_init(uint32_t src_domain_id, uint32_t
 
     if ((dl_lx_port->drv_fd < 0) || (pipe(dl_lx_port->intpipe) < 0) ) {
         AR_LOG_ERR(LOG_TAG,"%s:%d driver open failed %d for %s", __func__, __LINE__, errno, drv_name);
+        if (dl_lx_port->drv_fd >= 0)
+            close(dl_lx_port->drv_fd);
         free(dl_lx_port);
         return NULL;
     }
 
     pthread_mutex_init(&dl_lx_port->buff_list_lock,
                           (const pthread_mutexattr_t *) NULL);
+    pthread_mutex_init(&dl_lx_port->tx_lock,
+                          (const pthread_mutexattr_t *) NULL);
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&dl_lx_port->tx_cond, &cattr);
+    pthread_condattr_destroy(&cattr);
+    pthread_mutex_init(&dl_lx_port->ctrl_lock,
+                          (const pthread_mutexattr_t *) NULL);
+    pthread_cond_init(&dl_lx_port->ctrl_cond, (const pthread_condattr_t *) NULL);
+    list_init(&dl_lx_port->ctrl_list);
 
     status = allocate_buffers(dl_lx_port, GPR_DL_LX_BUF_SIZE,
                              GPR_DL_LX_NO_OF_BUFFERS);
     if (status) {
         AR_LOG_ERR(LOG_TAG,"%s:%d buffer allocation failed", __func__, __LINE__);
-        free(dl_lx_port);
+        gpr_dl_lx_free_port(dl_lx_port);
         return NULL;
     }
-    pthread_attr_init (&tattr);
-    pthread_attr_setschedparam (&tattr, &param);
-    pthread_attr_setschedpolicy(&tattr, SCHED_FIFO);
-    status = pthread_create(&dl_lx_port->receiver_thread, &tattr,
-                    receiver_thread_loop, dl_lx_port);
+    /* Start the control thread first, the receiver thread hands packets to it */
+    if (gpr_get_init_cfg()->rx_thread_mode == GPR_RX_THREAD_MODE_SPLIT_CONTROL) {
+        status = gpr_dl_lx_create_thread(&dl_lx_port->ctrl_thread, "gpr_ctrl_thread",
+                        ctrl_thread_loop, dl_lx_port, GPR_DL_LX_CTRL_THREAD);
+        if (status) {
+            AR_LOG_ERR(LOG_TAG,"%s:%d error:%d ctrl pthread_create fail, using single rx thread",
+                    __func__, __LINE__, status);
+        } else {
+            dl_lx_port->split_control = true;
+        }
+    }
+
+    status = gpr_dl_lx_create_thread(&dl_lx_port->receiver_thread, "gpr_receiver_thread",
+                    receiver_thread_loop, dl_lx_port, GPR_DL_LX_RX_THREAD);
     if (status) {
         AR_LOG_ERR(LOG_TAG,"%s:%d error:%d pthread_create fail", __func__, __LINE__, status);
-        free(dl_lx_port);
+        gpr_dl_lx_free_port(dl_lx_port);
         return NULL;
     }
-    pthread_setname_np(dl_lx_port->receiver_thread, "gpr_receiver_thread");
+
+    /* Without the flush thread deferred packets are sent immediately */
+    status = gpr_dl_lx_create_thread(&dl_lx_port->tx_flush_thread, "gpr_tx_flush_thread",
+                    tx_flush_thread_loop, dl_lx_port, GPR_DL_LX_TX_THREAD);
+    if (status) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d error:%d tx flush pthread_create fail, batching disabled",
+                __func__, __LINE__, status);
+    } else {
+        dl_lx_port->tx_batching = true;
+    }
     return dl_lx_port;
 }
 
@@ -372,6 +792,9 @@ static uint32_t gpr_dl_lx_local_deinit(uint32_t src_domain_id, uint32_t dst_doma
 {
     uint32_t status = AR_EOK;
     gpr_dl_lx_port_t *dl_lx_port;
+    struct iovec iov[GPR_DL_LX_TX_BATCH_MAX];
+    uint32_t cnt, sent_cnt;
+    int error;
 
     if (gpr_dl_lx_ports[dst_domain_id] == NULL) {
         AR_LOG_ERR(LOG_TAG,"%s:%d deinit already done", __func__, __LINE__);
@@ -379,6 +802,21 @@ static uint32_t gpr_dl_lx_local_deinit(uint32_t src_domain_id, uint32_t dst_doma
     }
     dl_lx_port = gpr_dl_lx_ports[dst_domain_id];
     gpr_dl_lx_ports[dst_domain_id] = NULL;
+
+    /* Stop the tx flush thread and send whatever is still queued */
+    if (dl_lx_port->tx_batching) {
+        pthread_mutex_lock(&dl_lx_port->tx_lock);
+        dl_lx_port->tx_thread_exit = true;
+        pthread_cond_broadcast(&dl_lx_port->tx_cond);
+        pthread_mutex_unlock(&dl_lx_port->tx_lock);
+        pthread_join(dl_lx_port->tx_flush_thread, NULL);
+    }
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    error = gpr_dl_lx_tx_flush_locked(dl_lx_port, iov, &cnt, &sent_cnt);
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+    gpr_dl_lx_tx_complete(dl_lx_port, iov, cnt, sent_cnt, error, NULL, false);
+    pthread_cond_destroy(&dl_lx_port->tx_cond);
+    pthread_mutex_destroy(&dl_lx_port->tx_lock);
     /*
      * Set thread exit to true and then close the driver instance
      * this should unblock the poll and then we do a pthread_join
@@ -395,6 +833,9 @@ static uint32_t gpr_dl_lx_local_deinit(uint32_t src_domain_id, uint32_t dst_doma
     if (status < 0){
         AR_LOG_ERR(LOG_TAG,"%s:%d pthread_join failed", __func__, __LINE__);
     }
+    gpr_dl_lx_stop_ctrl_thread(dl_lx_port);
+    pthread_cond_destroy(&dl_lx_port->ctrl_cond);
+    pthread_mutex_destroy(&dl_lx_port->ctrl_lock);
     close(dl_lx_port->drv_fd);
     dl_lx_port->drv_fd = 0;
     free(dl_lx_port);
@@ -415,19 +856,20 @@ uint32_t ipc_dl_lx_init(uint32_t src_domain_id,
         return AR_EBADPARAM;
     }
 
+    /* Checked first so that no port with running threads is left behind */
+    if (!p_gpr_to_ipc_vtbl->receive || !p_gpr_to_ipc_vtbl->send_done) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d no gpr cbs error out", __func__, __LINE__);
+        return AR_EBADPARAM;
+    }
+
     dl_lx_port = gpr_dl_lx_local_init(src_domain_id, dest_domain_id);
     if (dl_lx_port == NULL) {
         AR_LOG_ERR(LOG_TAG,"%s:%d local_init failed", __func__, __LINE__);
         return AR_EFAILED;
     }
     *pp_ipc_to_gpr_vtbl = &gpr_dl_lx_vtbl;
-    if (p_gpr_to_ipc_vtbl->receive && p_gpr_to_ipc_vtbl->send_done) {
-        dl_lx_port->rx_cb = p_gpr_to_ipc_vtbl->receive;
-        dl_lx_port->send_done = p_gpr_to_ipc_vtbl->send_done;
-    } else {
-        AR_LOG_ERR(LOG_TAG,"%s:%d no gpr cbs error out", __func__, __LINE__);
-        return AR_EBADPARAM;
-    }
+    dl_lx_port->rx_cb = p_gpr_to_ipc_vtbl->receive;
+    dl_lx_port->send_done = p_gpr_to_ipc_vtbl->send_done;
     gpr_dl_lx_ports[dest_domain_id] = dl_lx_port;
 
     return AR_EOK;
@@ -441,16 +883,10 @@ uint32_t ipc_dl_lx_deinit(uint32_t src_domain_id, uint32_t dest_domain_id)
    return status;
 }
 
-static uint32_t gpr_dl_lx_send(uint32_t domain_id, void *buf, uint32_t size)
+static uint32_t gpr_dl_lx_write_packet(gpr_dl_lx_port_t *dl_lx_port, void *buf, uint32_t size)
 {
     int32_t status;
-    gpr_dl_lx_port_t *dl_lx_port;
 
-    if ((dl_lx_port = gpr_dl_lx_ports[domain_id]) == NULL) {
-        AR_LOG_ERR(LOG_TAG,"%s:%d port domain %d not initialized", __func__, __LINE__,
-              domain_id);
-        return AR_ENOTEXIST;
-    }
     AR_LOG_DEBUG(LOG_TAG,"%s:Sending buffer of size %d to driver",__func__, size);
     status = write(dl_lx_port->drv_fd, buf, size);
     if (status < 0) {
@@ -465,6 +901,88 @@ static uint32_t gpr_dl_lx_send(uint32_t domain_id, void *buf, uint32_t size)
     return AR_EOK;
 }
 
+/*
+ * Appends a packet to the deferred queue and writes the queue out when
+ * flush_now is set or the queue is full. A packet that is not deferred is
+ * still queued behind earlier deferred ones so that ordering is kept.
+ */
+static uint32_t gpr_dl_lx_enqueue(gpr_dl_lx_port_t *dl_lx_port, void *buf, uint32_t size,
+                                  bool flush_now)
+{
+    struct iovec iov[GPR_DL_LX_TX_BATCH_MAX];
+    uint32_t cnt = 0, sent_cnt = 0;
+    int error = 0;
+
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    if (flush_now && (dl_lx_port->tx_cnt == 0)) {
+        pthread_mutex_unlock(&dl_lx_port->tx_lock);
+        return gpr_dl_lx_write_packet(dl_lx_port, buf, size);
+    }
+
+    dl_lx_port->tx_iov[dl_lx_port->tx_cnt].iov_base = buf;
+    dl_lx_port->tx_iov[dl_lx_port->tx_cnt].iov_len = size;
+    if (++dl_lx_port->tx_cnt == 1) {
+        clock_gettime(CLOCK_MONOTONIC, &dl_lx_port->tx_first_ts);
+        pthread_cond_signal(&dl_lx_port->tx_cond);
+    }
+    if (flush_now || (dl_lx_port->tx_cnt == GPR_DL_LX_TX_BATCH_MAX))
+        error = gpr_dl_lx_tx_flush_locked(dl_lx_port, iov, &cnt, &sent_cnt);
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+
+    return gpr_dl_lx_tx_complete(dl_lx_port, iov, cnt, sent_cnt, error, buf, false);
+}
+
+static uint32_t gpr_dl_lx_send(uint32_t domain_id, void *buf, uint32_t size)
+{
+    gpr_dl_lx_port_t *dl_lx_port;
+
+    if ((dl_lx_port = gpr_dl_lx_ports[domain_id]) == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d port domain %d not initialized", __func__, __LINE__,
+              domain_id);
+        return AR_ENOTEXIST;
+    }
+    return gpr_dl_lx_enqueue(dl_lx_port, buf, size, true);
+}
+
+static uint32_t gpr_dl_lx_send_deferred(uint32_t domain_id, void *buf, uint32_t size)
+{
+    gpr_dl_lx_port_t *dl_lx_port;
+
+    if ((dl_lx_port = gpr_dl_lx_ports[domain_id]) == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d port domain %d not initialized", __func__, __LINE__,
+              domain_id);
+        return AR_ENOTEXIST;
+    }
+    return gpr_dl_lx_enqueue(dl_lx_port, buf, size, !dl_lx_port->tx_batching);
+}
+
+/*
+ * Also reports a failure of the flush thread since the last flush, so that
+ * deferred packets it dropped are not lost silently.
+ */
+static uint32_t gpr_dl_lx_flush(uint32_t domain_id)
+{
+    gpr_dl_lx_port_t *dl_lx_port;
+    struct iovec iov[GPR_DL_LX_TX_BATCH_MAX];
+    uint32_t cnt, sent_cnt;
+    uint32_t status, pending_error;
+    int error;
+
+    if ((dl_lx_port = gpr_dl_lx_ports[domain_id]) == NULL) {
+        AR_LOG_ERR(LOG_TAG,"%s:%d port domain %d not initialized", __func__, __LINE__,
+              domain_id);
+        return AR_ENOTEXIST;
+    }
+    pthread_mutex_lock(&dl_lx_port->tx_lock);
+    error = gpr_dl_lx_tx_flush_locked(dl_lx_port, iov, &cnt, &sent_cnt);
+    pending_error = dl_lx_port->tx_pending_error;
+    dl_lx_port->tx_pending_error = AR_EOK;
+    pthread_mutex_unlock(&dl_lx_port->tx_lock);
+
+    status = gpr_dl_lx_tx_complete(dl_lx_port, iov, cnt, sent_cnt, error, NULL, false);
+    return (status != AR_EOK) ? status : pending_error;
+}
+
 static uint32_t gpr_dl_lx_receive_done(uint32_t domain_id, void *buf)
 {
     uint32_t status;
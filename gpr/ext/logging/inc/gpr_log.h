@@ -39,6 +39,14 @@ GPR_INTERNAL uint32_t gpr_log_deinit(void);
  *
  */
 GPR_INTERNAL int32_t gpr_log_packet (gpr_packet_t* packet);
+
+/**
+ * Record the header of the given gpr packet in the binary trace ring,
+ * subject to the filter set through __gpr_cmd_set_trace_cfg()
+ * \param[in] direction GPR_TRACE_DIR_TX or GPR_TRACE_DIR_RX
+ *
+ */
+GPR_INTERNAL void gpr_trace_packet(gpr_packet_t *packet, uint32_t direction);
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
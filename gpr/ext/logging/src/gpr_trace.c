@@ -0,0 +1,274 @@
+/**
+ * \file gpr_trace.c
+ * \brief
+ *    This file contains the binary GPR packet trace ring
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                    *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "ar_osal_mem_op.h"
+#include "ar_osal_error.h"
+#include "ar_osal_timer.h"
+#include "gpr_api_i.h"
+#include "gpr_log.h"
+#include "gpr_trace_api.h"
+
+/*****************************************************************************
+ * Defines                                                                   *
+ ****************************************************************************/
+
+#define GPR_TRACE_RECORD_IDX_MASK (GPR_TRACE_NUM_RECORDS - 1)
+#define GPR_TRACE_US_PER_SEC      1000000
+
+/*****************************************************************************
+ * Variables                                                                 *
+ ****************************************************************************/
+
+/* Live ring. It has the layout of gpr_trace_image_t, with the fields that
+   are updated concurrently declared atomic, so it can be copied out as an
+   image and still be located in a memory dump. */
+typedef struct gpr_trace_live_record_t
+{
+   uint64_t         timestamp_us;
+   _Atomic uint32_t seq;
+   uint32_t         opcode;
+   uint32_t         token;
+   uint32_t         src_port;
+   uint32_t         dst_port;
+   uint32_t         packet_size;
+   uint8_t          src_domain_id;
+   uint8_t          dst_domain_id;
+   uint8_t          direction;
+   uint8_t          reserved;
+} gpr_trace_live_record_t;
+
+typedef struct gpr_trace_live_ring_t
+{
+   char_t                  start_marker[8];
+   uint32_t                version;
+   uint32_t                num_records;
+   _Atomic uint32_t        head;
+   uint32_t                reserved;
+   gpr_trace_live_record_t records[GPR_TRACE_NUM_RECORDS];
+   char_t                  end_marker[8];
+} gpr_trace_live_ring_t;
+
+_Static_assert(sizeof(gpr_trace_live_record_t) == sizeof(gpr_trace_record_t), "trace record layout");
+_Static_assert(offsetof(gpr_trace_live_record_t, seq) == offsetof(gpr_trace_record_t, seq), "trace record layout");
+_Static_assert(sizeof(gpr_trace_live_ring_t) == sizeof(gpr_trace_image_t), "trace ring layout");
+_Static_assert(offsetof(gpr_trace_live_ring_t, head) == offsetof(gpr_trace_image_t, head), "trace ring layout");
+_Static_assert(offsetof(gpr_trace_live_ring_t, records) == offsetof(gpr_trace_image_t, records), "trace ring layout");
+
+static gpr_trace_live_ring_t gpr_trace_ring = {
+   .start_marker = { 'G', 'P', 'R', 'T', 'R', 'A', 'C', 'E' },
+   .version      = GPR_TRACE_IMAGE_VERSION,
+   .num_records  = GPR_TRACE_NUM_RECORDS,
+   .end_marker   = { 'G', 'P', 'R', 'T', 'R', 'E', 'N', 'D' },
+};
+
+/* Configuration, each field is read on its own by gpr_trace_packet().
+   Tracing is off until enabled with __gpr_cmd_set_trace_cfg(). */
+static atomic_uint gpr_trace_enable;
+static atomic_uint gpr_trace_sample_interval;
+static atomic_uint gpr_trace_opcode_mask;
+static atomic_uint gpr_trace_opcode_value;
+static atomic_uint gpr_trace_max_per_sec;
+
+static atomic_uint gpr_trace_sample_cnt;
+static atomic_uint gpr_trace_window_sec;
+static atomic_uint gpr_trace_window_cnt;
+
+/*****************************************************************************
+ * Function Definitions                                                      *
+ ****************************************************************************/
+
+/* Returns TRUE when the records/sec budget of the current second is spent */
+static bool_t gpr_trace_rate_limited(uint64_t time_us)
+{
+   uint32_t max_per_sec = atomic_load_explicit(&gpr_trace_max_per_sec, memory_order_relaxed);
+   uint32_t now_sec;
+   uint32_t window_sec;
+
+   if (0 == max_per_sec)
+   {
+      return FALSE;
+   }
+
+   now_sec    = (uint32_t)(time_us / GPR_TRACE_US_PER_SEC);
+   window_sec = atomic_load_explicit(&gpr_trace_window_sec, memory_order_relaxed);
+   if ((window_sec != now_sec) &&
+       atomic_compare_exchange_strong_explicit(&gpr_trace_window_sec,
+                                               &window_sec,
+                                               now_sec,
+                                               memory_order_relaxed,
+                                               memory_order_relaxed))
+   {
+      atomic_store_explicit(&gpr_trace_window_cnt, 0, memory_order_relaxed);
+   }
+
+   return (atomic_fetch_add_explicit(&gpr_trace_window_cnt, 1, memory_order_relaxed) >= max_per_sec);
+}
+
+GPR_INTERNAL void gpr_trace_packet(gpr_packet_t *packet, uint32_t direction)
+{
+   gpr_trace_live_record_t *record;
+   uint32_t                 sample_interval;
+   uint32_t                 idx;
+   uint64_t                 time_us;
+
+   if (!atomic_load_explicit(&gpr_trace_enable, memory_order_relaxed))
+   {
+      return;
+   }
+
+   if ((packet->opcode & atomic_load_explicit(&gpr_trace_opcode_mask, memory_order_relaxed)) !=
+       atomic_load_explicit(&gpr_trace_opcode_value, memory_order_relaxed))
+   {
+      return;
+   }
+
+   sample_interval = atomic_load_explicit(&gpr_trace_sample_interval, memory_order_relaxed);
+   if ((sample_interval > 1) &&
+       (0 != (atomic_fetch_add_explicit(&gpr_trace_sample_cnt, 1, memory_order_relaxed) % sample_interval)))
+   {
+      return;
+   }
+
+   time_us = ar_timer_get_time_in_us();
+   if (gpr_trace_rate_limited(time_us))
+   {
+      return;
+   }
+
+   /* Claim a slot. The head is the only index, so the slot and the sequence
+      number both come from this one fetch_add. seq is cleared while the record
+      is written and set last, so a reader can tell a complete record from one
+      being overwritten. */
+   idx    = atomic_fetch_add_explicit(&gpr_trace_ring.head, 1, memory_order_relaxed);
+   record = &gpr_trace_ring.records[idx & GPR_TRACE_RECORD_IDX_MASK];
+
+   atomic_store_explicit(&record->seq, 0, memory_order_relaxed);
+   atomic_thread_fence(memory_order_release);
+
+   record->timestamp_us  = time_us;
+   record->opcode        = packet->opcode;
+   record->token         = packet->token;
+   record->src_port      = packet->src_port;
+   record->dst_port      = packet->dst_port;
+   record->packet_size   = GPR_PKT_GET_PACKET_BYTE_SIZE(packet->header);
+   record->src_domain_id = packet->src_domain_id;
+   record->dst_domain_id = packet->dst_domain_id;
+   record->direction     = (uint8_t)direction;
+
+   atomic_store_explicit(&record->seq, idx + 1, memory_order_release);
+}
+
+uint32_t __gpr_cmd_set_trace_cfg(const gpr_trace_cfg_t *cfg)
+{
+   if (NULL == cfg)
+   {
+      return AR_EBADPARAM;
+   }
+
+   atomic_store(&gpr_trace_opcode_mask, cfg->opcode_mask);
+   atomic_store(&gpr_trace_opcode_value, cfg->opcode_value & cfg->opcode_mask);
+   atomic_store(&gpr_trace_sample_interval, cfg->sample_interval);
+   atomic_store(&gpr_trace_max_per_sec, cfg->max_records_per_sec);
+   atomic_store(&gpr_trace_enable, cfg->enable ? 1 : 0);
+
+   return AR_EOK;
+}
+
+uint32_t __gpr_cmd_get_trace_image(gpr_trace_image_t *image)
+{
+   uint32_t seq;
+
+   if (NULL == image)
+   {
+      return AR_EBADPARAM;
+   }
+
+   (void)ar_mem_cpy(image, sizeof(gpr_trace_image_t), &gpr_trace_ring, sizeof(gpr_trace_image_t));
+   image->head = atomic_load(&gpr_trace_ring.head);
+
+   /* Drop records that changed while they were copied */
+   for (uint32_t i = 0; i < GPR_TRACE_NUM_RECORDS; i++)
+   {
+      atomic_thread_fence(memory_order_acquire);
+      seq = atomic_load_explicit(&gpr_trace_ring.records[i].seq, memory_order_relaxed);
+      if (seq != image->records[i].seq)
+      {
+         image->records[i].seq = 0;
+      }
+   }
+
+   return AR_EOK;
+}
+
+uint32_t gpr_trace_decode(const void *image,
+                          uint32_t    image_size,
+                          char_t     *text,
+                          uint32_t    text_size,
+                          uint32_t   *num_lines)
+{
+   const gpr_trace_image_t  *ring = (const gpr_trace_image_t *)image;
+   const gpr_trace_record_t *record;
+   uint32_t                  first;
+   uint32_t                  offset = 0;
+   uint32_t                  lines  = 0;
+   int                       len;
+
+   if ((NULL == ring) || (image_size < sizeof(gpr_trace_image_t)) || (NULL == text) || (0 == text_size) ||
+       (0 != ar_mem_cmp(ring->start_marker, "GPRTRACE", sizeof(ring->start_marker))) ||
+       (GPR_TRACE_IMAGE_VERSION != ring->version) || (GPR_TRACE_NUM_RECORDS != ring->num_records))
+   {
+      return AR_EBADPARAM;
+   }
+
+   text[0] = '\0';
+   first   = (ring->head > GPR_TRACE_NUM_RECORDS) ? (ring->head - GPR_TRACE_NUM_RECORDS) : 0;
+   for (uint32_t idx = first; idx != ring->head; idx++)
+   {
+      record = &ring->records[idx & GPR_TRACE_RECORD_IDX_MASK];
+      if (record->seq != (idx + 1))
+      {
+         continue;
+      }
+
+      len = snprintf(&text[offset],
+                     text_size - offset,
+                     "%llu %s seq %u opcode 0x%08x token 0x%08x src %u:0x%x dst %u:0x%x size %u\n",
+                     (unsigned long long)record->timestamp_us,
+                     (GPR_TRACE_DIR_RX == record->direction) ? "RX" : "TX",
+                     record->seq,
+                     record->opcode,
+                     record->token,
+                     record->src_domain_id,
+                     record->src_port,
+                     record->dst_domain_id,
+                     record->dst_port,
+                     record->packet_size);
+      if ((len < 0) || ((uint32_t)len >= (text_size - offset)))
+      {
+         text[offset] = '\0';
+         break;
+      }
+      offset += (uint32_t)len;
+      lines++;
+   }
+
+   if (NULL != num_lines)
+   {
+      *num_lines = lines;
+   }
+   return AR_EOK;
+}
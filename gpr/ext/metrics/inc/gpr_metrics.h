@@ -0,0 +1,48 @@
+#ifndef __GPR_METRICS_H__
+#define __GPR_METRICS_H__
+
+/**
+ * \file gpr_metrics.h
+ * \brief
+ *  	This file contains GPR APIs for collecting per opcode latency metrics.
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "gpr_api.h"
+#include "gpr_metrics_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /*__cplusplus*/
+
+/**
+ * Initialize gpr metrics, collection stays off until __gpr_cmd_metrics_enable().
+ * Called once the gpr driver is up, further calls return AR_EOK.
+ * \return AR_EOK (0) when successful.
+ *
+ */
+GPR_INTERNAL uint32_t gpr_metrics_init(void);
+
+/**
+ * De-initialize gpr metrics, and clean up resources
+ * \return AR_EOK (0) when successful.
+ *
+ */
+GPR_INTERNAL uint32_t gpr_metrics_deinit(void);
+
+/**
+ * Account the given gpr packet exchanged with another domain
+ * \param[in] is_rx TRUE when the packet was received from the other domain
+ *
+ */
+GPR_INTERNAL void gpr_metrics_packet(gpr_packet_t *packet, bool_t is_rx);
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif /* __GPR_METRICS_H__ */
@@ -0,0 +1,292 @@
+/**
+ * \file gpr_metrics.c
+ * \brief
+ *    This file contains the GPR per opcode latency and throughput metrics
+ *
+ *
+ * \copyright
+ *  Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+ *  SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/******************************************************************************
+ * Includes                                                                    *
+ *****************************************************************************/
+#include <stdatomic.h>
+#include "ar_osal_mem_op.h"
+#include "ar_osal_mutex.h"
+#include "ar_osal_error.h"
+#include "ar_osal_timer.h"
+#include "ar_guids.h"
+#include "ar_msg.h"
+#include "gpr_api_i.h"
+#include "gpr_metrics.h"
+
+/*****************************************************************************
+ * Defines                                                                   *
+ ****************************************************************************/
+
+/* Requests waiting for a response, the oldest is dropped when full */
+#define GPR_METRICS_MAX_PENDING 64
+
+typedef struct gpr_metrics_pending_t
+{
+   uint64_t send_time_us;
+   uint32_t token;
+   uint32_t src_port;
+   uint32_t dst_port;
+   uint16_t dst_domain_id;
+   uint16_t in_use;
+   gpr_metrics_opcode_stats_t *stats;
+} gpr_metrics_pending_t;
+
+/*****************************************************************************
+ * Variables                                                                 *
+ ****************************************************************************/
+
+static ar_osal_mutex_t        gpr_metrics_mutex;
+static atomic_bool            gpr_metrics_enabled;
+static gpr_metrics_snapshot_t gpr_metrics;
+static gpr_metrics_pending_t  gpr_metrics_pending[GPR_METRICS_MAX_PENDING];
+
+/*****************************************************************************
+ * Function Definitions                                                      *
+ ****************************************************************************/
+
+GPR_INTERNAL uint32_t gpr_metrics_init(void)
+{
+   uint32_t result;
+
+   if (NULL != gpr_metrics_mutex)
+   {
+      // Already initialized, e.g. by gpr_init_domain() for another domain
+      return AR_EOK;
+   }
+
+   result = ar_osal_mutex_create(&gpr_metrics_mutex);
+   if (AR_EOK != result)
+   {
+      gpr_metrics_mutex = NULL;
+      return AR_EFAILED;
+   }
+   atomic_store(&gpr_metrics_enabled, FALSE);
+   return AR_EOK;
+}
+
+GPR_INTERNAL uint32_t gpr_metrics_deinit(void)
+{
+   atomic_store(&gpr_metrics_enabled, FALSE);
+   if (NULL != gpr_metrics_mutex)
+   {
+      (void)ar_osal_mutex_destroy(gpr_metrics_mutex);
+      gpr_metrics_mutex = NULL;
+   }
+   return AR_EOK;
+}
+
+static uint32_t gpr_metrics_latency_bin(uint64_t latency_us)
+{
+   uint32_t bin = 0;
+
+   while ((latency_us >= 2) && (bin < (GPR_METRICS_NUM_LATENCY_BINS - 1)))
+   {
+      latency_us >>= 1;
+      bin++;
+   }
+   return bin;
+}
+
+static gpr_metrics_opcode_stats_t *gpr_metrics_find_opcode(gpr_packet_t *packet)
+{
+   gpr_metrics_opcode_stats_t *stats;
+   uint32_t                    idx;
+
+   for (idx = 0; idx < gpr_metrics.num_opcode_entries; idx++)
+   {
+      stats = &gpr_metrics.opcode_stats[idx];
+      if ((stats->opcode == packet->opcode) && (stats->dst_domain_id == packet->dst_domain_id) &&
+          (stats->dst_port == packet->dst_port))
+      {
+         return stats;
+      }
+   }
+
+   if (GPR_METRICS_MAX_OPCODE_ENTRIES == idx)
+   {
+      return NULL;
+   }
+
+   stats                 = &gpr_metrics.opcode_stats[gpr_metrics.num_opcode_entries++];
+   stats->opcode         = packet->opcode;
+   stats->dst_domain_id  = packet->dst_domain_id;
+   stats->dst_port       = packet->dst_port;
+   stats->min_latency_us = UINT32_MAX;
+   return stats;
+}
+
+static void gpr_metrics_add_request(gpr_packet_t *packet, uint64_t time_us)
+{
+   gpr_metrics_opcode_stats_t *stats = gpr_metrics_find_opcode(packet);
+   gpr_metrics_pending_t      *slot  = &gpr_metrics_pending[0];
+
+   if (NULL == stats)
+   {
+      gpr_metrics.num_dropped_requests++;
+      return;
+   }
+   stats->num_requests++;
+
+   for (uint32_t idx = 0; idx < GPR_METRICS_MAX_PENDING; idx++)
+   {
+      if (!gpr_metrics_pending[idx].in_use)
+      {
+         slot = &gpr_metrics_pending[idx];
+         break;
+      }
+      if (gpr_metrics_pending[idx].send_time_us < slot->send_time_us)
+      {
+         slot = &gpr_metrics_pending[idx];
+      }
+   }
+
+   if (slot->in_use)
+   {
+      // Table full, give up on the oldest request
+      gpr_metrics.num_dropped_requests++;
+   }
+   else
+   {
+      gpr_metrics.num_pending++;
+   }
+
+   slot->send_time_us  = time_us;
+   slot->token         = packet->token;
+   slot->src_port      = packet->src_port;
+   slot->dst_port      = packet->dst_port;
+   slot->dst_domain_id = packet->dst_domain_id;
+   slot->in_use        = TRUE;
+   slot->stats         = stats;
+}
+
+static void gpr_metrics_match_response(gpr_packet_t *packet, uint64_t time_us)
+{
+   gpr_metrics_pending_t      *slot;
+   gpr_metrics_opcode_stats_t *stats;
+   uint64_t                    latency_us;
+
+   for (uint32_t idx = 0; idx < GPR_METRICS_MAX_PENDING; idx++)
+   {
+      slot = &gpr_metrics_pending[idx];
+      if (!slot->in_use || (slot->token != packet->token) || (slot->src_port != packet->dst_port) ||
+          (slot->dst_port != packet->src_port) || (slot->dst_domain_id != packet->src_domain_id))
+      {
+         continue;
+      }
+
+      stats      = slot->stats;
+      latency_us = time_us - slot->send_time_us;
+      stats->num_responses++;
+      stats->total_latency_us += latency_us;
+      stats->latency_hist[gpr_metrics_latency_bin(latency_us)]++;
+      if (latency_us > UINT32_MAX)
+      {
+         latency_us = UINT32_MAX;
+      }
+      if ((uint32_t)latency_us < stats->min_latency_us)
+      {
+         stats->min_latency_us = (uint32_t)latency_us;
+      }
+      if ((uint32_t)latency_us > stats->max_latency_us)
+      {
+         stats->max_latency_us = (uint32_t)latency_us;
+      }
+
+      slot->in_use = FALSE;
+      gpr_metrics.num_pending--;
+      return;
+   }
+}
+
+GPR_INTERNAL void gpr_metrics_packet(gpr_packet_t *packet, bool_t is_rx)
+{
+   uint32_t opcode_type;
+   uint32_t packet_size;
+   uint64_t time_us;
+
+   if (!atomic_load_explicit(&gpr_metrics_enabled, memory_order_relaxed))
+   {
+      return;
+   }
+
+   time_us     = ar_timer_get_time_in_us();
+   packet_size = GPR_PKT_GET_PACKET_BYTE_SIZE(packet->header);
+   opcode_type = (packet->opcode & AR_GUID_TYPE_MASK) >> AR_GUID_TYPE_SHIFT;
+
+   (void)ar_osal_mutex_lock(gpr_metrics_mutex);
+   if (is_rx)
+   {
+      gpr_metrics.rx_packets++;
+      gpr_metrics.rx_bytes += packet_size;
+      if ((AR_GUID_TYPE_CONTROL_CMD_RSP == opcode_type) || (AR_GUID_TYPE_DATA_CMD_RSP == opcode_type))
+      {
+         gpr_metrics_match_response(packet, time_us);
+      }
+   }
+   else
+   {
+      gpr_metrics.tx_packets++;
+      gpr_metrics.tx_bytes += packet_size;
+      if ((AR_GUID_TYPE_CONTROL_CMD == opcode_type) || (AR_GUID_TYPE_DATA_CMD == opcode_type))
+      {
+         gpr_metrics_add_request(packet, time_us);
+      }
+   }
+   (void)ar_osal_mutex_unlock(gpr_metrics_mutex);
+}
+
+uint32_t __gpr_cmd_metrics_enable(bool_t enable)
+{
+   if (NULL == gpr_metrics_mutex)
+   {
+      return AR_ENOTREADY;
+   }
+
+   (void)ar_osal_mutex_lock(gpr_metrics_mutex);
+   if (enable && !atomic_load(&gpr_metrics_enabled))
+   {
+      (void)ar_mem_set(&gpr_metrics, 0, sizeof(gpr_metrics));
+      (void)ar_mem_set(gpr_metrics_pending, 0, sizeof(gpr_metrics_pending));
+      gpr_metrics.start_time_us = ar_timer_get_time_in_us();
+   }
+   atomic_store(&gpr_metrics_enabled, enable ? TRUE : FALSE);
+   (void)ar_osal_mutex_unlock(gpr_metrics_mutex);
+
+   AR_MSG(DBG_HIGH_PRIO, "GPR metrics: collection %s", enable ? "started" : "stopped");
+   return AR_EOK;
+}
+
+uint32_t __gpr_cmd_get_metrics(gpr_metrics_snapshot_t *snapshot)
+{
+   if (NULL == snapshot)
+   {
+      return AR_EBADPARAM;
+   }
+   if (NULL == gpr_metrics_mutex)
+   {
+      return AR_ENOTREADY;
+   }
+
+   (void)ar_osal_mutex_lock(gpr_metrics_mutex);
+   (void)ar_mem_cpy(snapshot, sizeof(gpr_metrics_snapshot_t), &gpr_metrics, sizeof(gpr_metrics));
+   (void)ar_osal_mutex_unlock(gpr_metrics_mutex);
+
+   for (uint32_t idx = 0; idx < snapshot->num_opcode_entries; idx++)
+   {
+      if (0 == snapshot->opcode_stats[idx].num_responses)
+      {
+         snapshot->opcode_stats[idx].min_latency_us = 0;
+      }
+   }
+   snapshot->snapshot_time_us = ar_timer_get_time_in_us();
+   return gpr_drv_get_pool_usage(snapshot->pool_stats, GPR_METRICS_MAX_POOLS, &snapshot->num_pools);
+}
@@ -27,7 +27,7 @@
 #endif
 #endif
 
-#define GPR_NUM_PACKETS_TYPE 3
+#define GPR_NUM_PACKETS_TYPE 4
 
 #define GPR_NUM_PACKETS_1 ( 100 )
 #define GPR_DRV_BYTES_PER_PACKET_1 ( 512 )
@@ -36,6 +36,10 @@
 #define GPR_NUM_PACKETS_3 ( 0 )
 #define GPR_DRV_BYTES_PER_PACKET_3 ( 65536 )
 
+/* Reserved for data path commands so control bursts cannot starve them */
+#define GPR_NUM_DATA_PACKETS ( 32 )
+#define GPR_DRV_BYTES_PER_DATA_PACKET ( 512 )
+
 #ifdef PLATFORM_SLATE
 #undef GPR_NUM_PACKETS_2
 #define GPR_NUM_PACKETS_2 ( 8 )
@@ -56,6 +60,7 @@ struct gpr_packet_pool_info_v2_t gpr_lx_packet_pool_table[GPR_NUM_PACKETS_TYPE]=
    { GPR_HEAP_INDEX_DEFAULT, 0, 0, GPR_NUM_PACKETS_1, GPR_DRV_BYTES_PER_PACKET_1},
    { GPR_HEAP_INDEX_DEFAULT, 0, 0, GPR_NUM_PACKETS_2, GPR_DRV_BYTES_PER_PACKET_2},
    { GPR_HEAP_INDEX_DEFAULT, 1, 0, GPR_NUM_PACKETS_3, GPR_DRV_BYTES_PER_PACKET_3},
+   { GPR_HEAP_INDEX_DEFAULT, 0, GPR_PKT_CLASS_DATA, GPR_NUM_DATA_PACKETS, GPR_DRV_BYTES_PER_DATA_PACKET},
 };
 
 uint32_t num_domains = 0;
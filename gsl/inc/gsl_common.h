@@ -274,6 +274,8 @@ int32_t gsl_send_spf_cmd(struct gpr_packet_t **packet,
 	struct gsl_signal *sig_p, gpr_packet_t **rsp_pkt);
 int32_t gsl_send_spf_cmd_wait_for_basic_rsp(gpr_packet_t **packet,
 	struct gsl_signal *sig_p);
+int32_t gsl_send_spf_cmd_deferred(gpr_packet_t **packet);
+int32_t gsl_flush_spf_cmds(uint32_t dest_domain);
 int32_t gsl_send_spf_satellite_info(uint32_t proc_id,
 	uint32_t supported_ss_mask, uint32_t src_port, struct gsl_signal *sig_p);
 
@@ -318,6 +320,13 @@ static inline int32_t gsl_memcpy(void *dst, size_t dst_size, const void *src,
 	return ar_mem_cpy(dst, dst_size, src, size);
 }
 
+/* for large buffers only the DSP reads, keeps them out of the host cache */
+static inline int32_t gsl_memcpy_nt(void *dst, size_t dst_size,
+	const void *src, size_t size)
+{
+	return ar_mem_cpy_nt(dst, dst_size, src, size);
+}
+
 static inline void *gsl_mem_realloc(void *p, size_t old_sz, size_t new_sz)
 {
 	void *new_p = NULL;
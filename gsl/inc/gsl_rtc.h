@@ -106,6 +106,21 @@ int32_t gsl_rtc_graph_get_non_persist_data(struct gsl_graph *graph,
 int32_t gsl_rtc_graph_set_non_persist_data(struct gsl_graph *graph,
 	uint32_t total_size, uint8_t *sg_cal_data);
 
+/**
+ * \brief Get or set non-persist data for a list of parameters that may span
+ * several graphs, with one APM_CMD_GET_CFG/APM_CMD_SET_CFG per processor
+ *
+ * \param[in] opcode: APM_CMD_GET_CFG or APM_CMD_SET_CFG
+ * \param[in] graphs: graph obj of each entry, NULL for entries the caller
+ *	already failed
+ * \param[in/out] params: entries, error_code of each is updated and for get
+ *	the payload too
+ *
+ * \return AR_EOK if every entry succeeded, error otherwise
+ */
+int32_t gsl_rtc_graph_bulk_non_persist_data(uint32_t opcode,
+	struct gsl_graph **graphs, struct gsl_rtc_bulk_param *params);
+
 /**
  * \brief Set persist data for the given subgraph in the graph
  *
@@ -20,6 +20,8 @@ enum gsl_rtc_request_type {
 	GSL_RTC_PREPARE_CHANGE_GRAPH,
 	GSL_RTC_CHANGE_GRAPH,
 	GSL_RTC_CONN_INFO_CHANGE,
+	GSL_RTC_GET_NON_PERSIST_DATA_BULK,
+	GSL_RTC_SET_NON_PERSIST_DATA_BULK,
 };
 
 typedef int32_t(*gsl_rtc_cb_t)(enum gsl_rtc_request_type req, void *cb_data);
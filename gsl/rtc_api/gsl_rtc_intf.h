@@ -91,6 +91,44 @@ struct gsl_rtc_persist_param {
 	struct gsl_rtc_key_vector *ckv;
 };
 
+/**
+ * Header of one entry of a bulk non-persist request, immediately followed by
+ * size bytes of payload. From miid onwards the layout matches the
+ * {MIID, PID, Size, ErrorCode, VariablePayload} param data used by
+ * struct gsl_rtc_param.
+ */
+struct gsl_rtc_bulk_entry {
+	/** GSL graph handle the module belongs to */
+	uint32_t graph_handle;
+	/** sgid of the subgraph the module belongs to */
+	uint32_t sgid;
+	/** module instance id */
+	uint32_t miid;
+	/** parameter id */
+	uint32_t pid;
+	/** payload size in bytes, must be a multiple of 4 */
+	uint32_t size;
+	/** output, AR_EOK or the error reported for this entry */
+	uint32_t error_code;
+};
+
+struct gsl_rtc_bulk_param {
+	/** number of entries in the entries buffer */
+	uint32_t num_entries;
+	/** total size of the entries buffer in bytes */
+	uint32_t total_size;
+	/**
+	 * Pointer to num_entries back to back entries, each a
+	 * struct gsl_rtc_bulk_entry followed by its payload. Entries may
+	 * span any number of graphs and subgraphs.
+	 */
+	uint8_t *entries;
+};
+
+/** size in bytes of a bulk entry including its payload */
+#define GSL_RTC_BULK_ENTRY_SIZE(entry) \
+	(sizeof(struct gsl_rtc_bulk_entry) + (entry)->size)
+
 struct gsl_rtc_prepare_change_graph_info {
 	/* GSL graph handle */
 	uint32_t graph_handle;
@@ -248,6 +286,32 @@ int32_t gsl_rtc_set_persist_data(struct gsl_rtc_persist_param *rtc_param);
  */
 int32_t gsl_rtc_set_non_persist_data(struct gsl_rtc_param *rtc_param);
 
+/**
+ * \brief get non-persist calibration data for many parameters at once
+ *  Entries are grouped by processor and each group is read with a single
+ *  APM_CMD_GET_CFG. The payload and error_code of every entry are updated.
+ *  RTC client is responsible to allocate/free the memory
+ *  for gsl_rtc_bulk_param
+ *
+ * \param[in/out] rtc_param: pointer to struct gsl_rtc_bulk_param
+ *
+ * \return AR_EOK if every entry succeeded, error code otherwise
+ */
+int32_t gsl_rtc_get_non_persist_data_bulk(struct gsl_rtc_bulk_param *rtc_param);
+
+/**
+ * \brief set non-persist calibration data for many parameters at once
+ *  Entries are grouped by processor and each group is written with a single
+ *  APM_CMD_SET_CFG. The error_code of every entry is updated.
+ *  RTC client is responsible to allocate/free the memory
+ *  for gsl_rtc_bulk_param
+ *
+ * \param[in/out] rtc_param: pointer to struct gsl_rtc_bulk_param
+ *
+ * \return AR_EOK if every entry succeeded, error code otherwise
+ */
+int32_t gsl_rtc_set_non_persist_data_bulk(struct gsl_rtc_bulk_param *rtc_param);
+
 /**
  * \brief Prepare for graph change operation, this will update GSL state and
  * close subgraphs and connections that are no longer needed but will not open
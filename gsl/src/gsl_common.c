@@ -156,6 +156,22 @@ int32_t gsl_allocate_gpr_packet(uint32_t opcode, uint32_t src_port,
 	return rc;
 }
 
+static uint32_t debug_token; /* token is echoed in SPF log */
+
+/*
+ * Commands are sent from several threads, so each call draws its own token
+ * from the counter atomically. Values that shift out to zero are skipped.
+ */
+static void gsl_insert_debug_token(gpr_packet_t *packet)
+{
+	uint32_t token;
+
+	do {
+		token = __atomic_fetch_add(&debug_token, 1, __ATOMIC_RELAXED);
+	} while ((token << DEBUG_TOKEN_SHIFT) == 0);
+	INSERT_DEBUG_TOKEN(packet->token, token);
+}
+
 /* Payload must be 8B aligned for spf */
 int32_t gsl_send_spf_cmd(gpr_packet_t **packet, struct gsl_signal *sig_p,
 	gpr_packet_t **rsp_pkt)
@@ -165,7 +181,6 @@ int32_t gsl_send_spf_cmd(gpr_packet_t **packet, struct gsl_signal *sig_p,
 	uint32_t opcode = (*packet)->opcode;
 	struct gsl_servreg_handle_list *restart_handle_list;
 	bool_t do_restart = false;
-	static uint32_t debug_token = 0; /* token is echoed in SPF log */
 
 	#ifdef GSL_DEBUG_ENABLE
 	/* Cache debug variables for later
@@ -175,10 +190,7 @@ int32_t gsl_send_spf_cmd(gpr_packet_t **packet, struct gsl_signal *sig_p,
 		dst_port = (*packet)->dst_port;
 	#endif
 	if(opcode != APM_CMD_REGISTER_MODULE_EVENTS) {
-		if ((debug_token << DEBUG_TOKEN_SHIFT) == 0)
-			++debug_token;
-		INSERT_DEBUG_TOKEN((*packet)->token, debug_token);
-		++debug_token;
+		gsl_insert_debug_token(*packet);
         	if(sig_p == NULL)
 			GSL_VERBOSE("sending pkt opcode 0x%x token 0x%08x", opcode, (*packet)->token);
 	}
@@ -266,6 +278,38 @@ exit:
 	return rc;
 }
 
+/*
+ * Send a command that needs no response and let GPR batch it with the
+ * following ones to the same domain. Caller must call gsl_flush_spf_cmds()
+ * once the burst is queued and before it blocks waiting on SPF.
+ */
+int32_t gsl_send_spf_cmd_deferred(gpr_packet_t **packet)
+{
+	int32_t rc;
+
+	gsl_insert_debug_token(*packet);
+	GSL_VERBOSE("queueing pkt opcode 0x%x token 0x%08x", (*packet)->opcode,
+		(*packet)->token);
+
+	rc = __gpr_cmd_async_send_v2(*packet, GPR_SEND_FLAG_DEFER_FLUSH);
+	if (rc)
+		__gpr_cmd_free(*packet);
+
+	return rc;
+}
+
+int32_t gsl_flush_spf_cmds(uint32_t dest_domain)
+{
+	int32_t rc;
+
+	rc = __gpr_cmd_flush(dest_domain);
+	if (rc)
+		GSL_ERR("failed to flush queued spf cmds to domain %d rc %d",
+			dest_domain, rc);
+
+	return rc;
+}
+
 int32_t gsl_send_spf_cmd_wait_for_basic_rsp(gpr_packet_t **packet,
 	struct gsl_signal *sig_p)
 {
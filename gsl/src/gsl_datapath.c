@@ -1108,7 +1108,7 @@ exit:
 static int32_t gsl_dp_write_shmem(struct gsl_data_path_info *dp_info,
 	struct gsl_buff_internal *buff, struct gsl_metadata_buff_internal *md_buff,
 	uintptr_t offset, uint32_t buff_idx, uint32_t  size,
-	struct gsl_buff *client_buff)
+	struct gsl_buff *client_buff, bool_t defer)
 {
 	data_cmd_wr_sh_mem_ep_data_buffer_v2_t *write_cmd;
 	media_format_t *media_fmt;
@@ -1196,7 +1196,10 @@ static int32_t gsl_dp_write_shmem(struct gsl_data_path_info *dp_info,
 	GSL_LOG_PKT("send_pkt", dp_info->src_port, send_pkt, sizeof(*send_pkt) +
 		gpr_pld_size, NULL, 0);
 
-	rc = gsl_send_spf_cmd(&send_pkt, NULL, NULL);
+	if (defer)
+		rc = gsl_send_spf_cmd_deferred(&send_pkt);
+	else
+		rc = gsl_send_spf_cmd(&send_pkt, NULL, NULL);
 	if (rc)
 		GSL_ERR("wite shmem failed with %d", rc);
 
@@ -1207,7 +1210,7 @@ exit:
 static int32_t gsl_dp_read_shmem(struct gsl_data_path_info *dp_info,
 	struct gsl_buff_internal *internal_buf,
 	struct gsl_metadata_buff_internal *md_buff, uintptr_t offset,
-	uint32_t read_sz, uint32_t buff_idx)
+	uint32_t read_sz, uint32_t buff_idx, bool_t defer)
 {
 	data_cmd_rd_sh_mem_ep_data_buffer_v2_t *read_cmd;
 	int32_t rc;
@@ -1248,7 +1251,10 @@ static int32_t gsl_dp_read_shmem(struct gsl_data_path_info *dp_info,
 	GSL_LOG_PKT("send_pkt", dp_info->src_port, send_pkt, sizeof(*send_pkt) +
 		sizeof(*read_cmd), NULL, 0);
 
-	rc = gsl_send_spf_cmd(&send_pkt, NULL, NULL);
+	if (defer)
+		rc = gsl_send_spf_cmd_deferred(&send_pkt);
+	else
+		rc = gsl_send_spf_cmd(&send_pkt, NULL, NULL);
 	if (rc)
 		GSL_ERR("failed send spf cmd %d", rc);
 
@@ -1257,7 +1263,7 @@ exit:
 }
 
 static int32_t gsl_dp_read_nonshmem(struct gsl_data_path_info *dp_info,
-	uint32_t md_buff_size, uint32_t read_sz, uint32_t buff_idx)
+	uint32_t md_buff_size, uint32_t read_sz, uint32_t buff_idx, bool_t defer)
 {
 	data_cmd_rd_sh_mem_ep_data_buffer_v2_t *read_cmd;
 	int32_t rc;
@@ -1286,7 +1292,10 @@ static int32_t gsl_dp_read_nonshmem(struct gsl_data_path_info *dp_info,
 	GSL_LOG_PKT("send_pkt", dp_info->src_port, gsl_msg.gpr_packet,
 		sizeof(*gsl_msg.gpr_packet) + sizeof(*read_cmd), NULL, 0);
 
-	rc = gsl_send_spf_cmd(&gsl_msg.gpr_packet, NULL, NULL);
+	if (defer)
+		rc = gsl_send_spf_cmd_deferred(&gsl_msg.gpr_packet);
+	else
+		rc = gsl_send_spf_cmd(&gsl_msg.gpr_packet, NULL, NULL);
 	if (rc)
 		GSL_ERR("failed send spf cmd %d", rc);
 
@@ -1315,6 +1324,8 @@ static int32_t gsl_dp_write_nonshmem(struct gsl_data_path_info *dp_info,
 			internal_buf = gsl_find_next_avail_buffer(dp_info,
 				&buf_idx);
 			if (!internal_buf) {
+				/* push out what this call queued before giving up or waiting */
+				gsl_flush_spf_cmds(dp_info->master_proc_id);
 				if (GSL_DP_DATA_MODE(dp_info) ==
 					GSL_DATA_MODE_NON_BLOCKING) {
 					/* NON-BLOCKING mode */
@@ -1387,7 +1398,7 @@ static int32_t gsl_dp_write_nonshmem(struct gsl_data_path_info *dp_info,
 			write_cmd->timestamp_msw = 0;
 		}
 
-		rc = gsl_send_spf_cmd(&internal_buf->gsl_msg.gpr_packet, NULL, NULL);
+		rc = gsl_send_spf_cmd_deferred(&internal_buf->gsl_msg.gpr_packet);
 		if (rc != AR_EOK) {
 			GSL_VERBOSE("%s fail rc = %d", __func__, rc);
 			goto exit;
@@ -1403,6 +1414,7 @@ static int32_t gsl_dp_write_nonshmem(struct gsl_data_path_info *dp_info,
 		gsl_dp_write_send_eos(dp_info);
 
 exit:
+	gsl_flush_spf_cmds(dp_info->master_proc_id);
 	return rc;
 }
 
@@ -1425,6 +1437,8 @@ static int32_t gsl_dp_write_heap(struct gsl_data_path_info *dp_info,
 			internal_buf = gsl_find_next_avail_buffer(dp_info,
 				&buf_idx);
 			if (!internal_buf) {
+				/* push out what this call queued before giving up or waiting */
+				gsl_flush_spf_cmds(dp_info->master_proc_id);
 				if (GSL_DP_DATA_MODE(dp_info) ==
 					GSL_DATA_MODE_NON_BLOCKING) {
 					/* NON-BLOCKING mode */
@@ -1464,8 +1478,8 @@ static int32_t gsl_dp_write_heap(struct gsl_data_path_info *dp_info,
 
 		GSL_VERBOSE("Write buf idx %d, bytes: %d", buf_idx, write_buff_size);
 
-		gsl_memcpy(internal_buf->gsl_msg.shmem.v_addr, buff_size, buff_addr,
-			write_buff_size);
+		gsl_memcpy_nt(internal_buf->gsl_msg.shmem.v_addr, buff_size,
+			buff_addr, write_buff_size);
 
 		/*
 		 * Copy the metadata to shared memory, note that for blocking and
@@ -1485,7 +1499,7 @@ static int32_t gsl_dp_write_heap(struct gsl_data_path_info *dp_info,
 		}
 
 		rc = gsl_dp_write_shmem(dp_info, internal_buf, internal_md_buf, 0,
-			buf_idx, write_buff_size, buff);
+			buf_idx, write_buff_size, buff, TRUE);
 		if (rc != AR_EOK) {
 			GSL_VERBOSE("gsl_dp_write_shmem fail rc=%d", rc);
 			goto exit;
@@ -1501,6 +1515,7 @@ static int32_t gsl_dp_write_heap(struct gsl_data_path_info *dp_info,
 		gsl_dp_write_send_eos(dp_info);
 
 exit:
+	gsl_flush_spf_cmds(dp_info->master_proc_id);
 	return rc;
 }
 
@@ -1610,6 +1625,8 @@ static int32_t gsl_dp_read_heap(struct gsl_data_path_info *dp_info,
 			internal_buf = gsl_find_next_avail_buffer(dp_info,
 				&buf_idx);
 			if (!internal_buf) {
+				/* push out what this call queued before giving up or waiting */
+				gsl_flush_spf_cmds(dp_info->master_proc_id);
 				if (GSL_DP_DATA_MODE(dp_info) == GSL_DATA_MODE_NON_BLOCKING) {
 					/* NON-BLOCKING mode */
 					GSL_VERBOSE("No buff available");
@@ -1658,7 +1675,7 @@ static int32_t gsl_dp_read_heap(struct gsl_data_path_info *dp_info,
 		/* queue the buffer back to spf */
 		if (!dp_info->is_shmem_supported) {
 			rc = gsl_dp_read_nonshmem(dp_info, buff->metadata_size,
-				dp_info->config.buff_size, buf_idx);
+				dp_info->config.buff_size, buf_idx, TRUE);
 			if (rc != AR_EOK)
 				goto exit;
 		} else {
@@ -1683,7 +1700,7 @@ static int32_t gsl_dp_read_heap(struct gsl_data_path_info *dp_info,
 
 			/* queue the shmem buffer back to spf */
 			rc = gsl_dp_read_shmem(dp_info, internal_buf, internal_md_buf, 0,
-				dp_info->config.buff_size, buf_idx);
+				dp_info->config.buff_size, buf_idx, TRUE);
 			if (rc != AR_EOK)
 				goto exit;
 		}
@@ -1693,6 +1710,7 @@ static int32_t gsl_dp_read_heap(struct gsl_data_path_info *dp_info,
 		buff_size -= read_buff_size;
 	}
 exit:
+	gsl_flush_spf_cmds(dp_info->master_proc_id);
 	return rc;
 }
 
@@ -1730,7 +1748,7 @@ static int32_t gsl_dp_write_extern_mem(struct gsl_data_path_info *dp_info,
 	}
 
 	rc = gsl_dp_write_shmem(dp_info, &internal_buf,	internal_md_buf,
-		buff->alloc_info.offset, cache_idx, buff->size, buff);
+		buff->alloc_info.offset, cache_idx, buff->size, buff, FALSE);
 	if (rc != AR_EOK) {
 		GSL_VERBOSE("gsl_dp_write_shmem fail rc=%d", rc);
 		goto exit;
@@ -1773,7 +1791,7 @@ static int32_t gsl_dp_read_extern_mem(struct gsl_data_path_info *dp_info,
 	}
 
 	rc = gsl_dp_read_shmem(dp_info, &internal_buf, internal_md_buf,
-		buff->alloc_info.offset, buff->size, cache_idx);
+		buff->alloc_info.offset, buff->size, cache_idx, FALSE);
 	if (rc != AR_EOK) {
 		GSL_VERBOSE("gsl_dp_read_shmem fail rc=%d", rc);
 		goto exit;
@@ -1805,8 +1823,13 @@ void gsl_dp_destroy_cache_refcount_lock(void)
 int32_t gsl_data_path_init(struct gsl_data_path_info *dp_info)
 {
 	int32_t rc = AR_EOK;
+	/* the RT client thread waits on this lock in read/write */
+	const ar_osal_mutex_attr_t pi_attr = {
+		.flags = AR_OSAL_MUTEX_ATTR_PRIO_INHERIT,
+		.spin_count = 0
+	};
 
-	rc = ar_osal_mutex_create(&dp_info->lock);
+	rc = ar_osal_mutex_create_v2(&dp_info->lock, &pi_attr);
 	if (rc) {
 		GSL_ERR("failed to create mutex: %d", rc);
 		goto exit;
@@ -2031,7 +2054,7 @@ int32_t gsl_dp_read(struct gsl_data_path_info *dp_info, struct gsl_buff *buff,
 			internal_md_buff->size = buff->metadata_size;
 		}
 		rc = gsl_dp_read_shmem(dp_info, internal_buff, internal_md_buff,
-			offset, buff->size, buff_idx);
+			offset, buff->size, buff_idx, FALSE);
 		/*
 		 * in shared memory mode the read is returned immediately and no data
 		 * is filled till we get buff done
@@ -2095,7 +2118,7 @@ int32_t gsl_dp_write(struct gsl_data_path_info *dp_info, struct gsl_buff *buff,
 			}
 		}
 		rc = gsl_dp_write_shmem(dp_info, internal_buff, internal_md_buff,
-			offset, buff_idx, buff->size, buff);
+			offset, buff_idx, buff->size, buff, FALSE);
 		*consumed_size = buff->size;
 
 		if (buff->flags & GSL_BUFF_FLAG_EOS)
@@ -2499,7 +2522,7 @@ int32_t gsl_dp_queue_read_buffers_to_spf(struct gsl_data_path_info *dp_info)
 				if (!dp_info->is_shmem_supported) {
 					gsl_dp_read_nonshmem(dp_info,
 						dp_info->config.max_metadata_size,
-						dp_info->config.buff_size, i);
+						dp_info->config.buff_size, i, TRUE);
 					continue;
 				}
 
@@ -2519,9 +2542,10 @@ int32_t gsl_dp_queue_read_buffers_to_spf(struct gsl_data_path_info *dp_info)
 				}
 
 				gsl_dp_read_shmem(dp_info, internal_buff,
-					internal_md_buf, 0,	dp_info->config.buff_size, i);
+					internal_md_buf, 0,	dp_info->config.buff_size, i, TRUE);
 			}
 		}
+		gsl_flush_spf_cmds(dp_info->master_proc_id);
 	}
 
 	return rc;
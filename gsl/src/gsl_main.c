@@ -238,6 +238,10 @@ static int32_t gsl_rtc_callback(enum gsl_rtc_request_type req, void *cb_data)
 	struct gsl_rtc_prepare_change_graph_info *prep_change_graph_params;
 	struct gsl_rtc_change_graph_info *change_graph_params;
 	struct gsl_rtc_conn_info *rtc_conn_info;
+	struct gsl_rtc_bulk_param *rtc_bulk_data;
+	struct gsl_rtc_bulk_entry *bulk_entry;
+	struct gsl_graph **bulk_graphs;
+	uint32_t j;
 
 	int32_t rc = AR_EOK;
 
@@ -440,6 +444,30 @@ static int32_t gsl_rtc_callback(enum gsl_rtc_request_type req, void *cb_data)
 		}
 		GSL_MUTEX_UNLOCK(gsl_ctxt.open_close_lock);
 		break;
+	case GSL_RTC_GET_NON_PERSIST_DATA_BULK:
+	case GSL_RTC_SET_NON_PERSIST_DATA_BULK:
+		rtc_bulk_data = (struct gsl_rtc_bulk_param *)cb_data;
+		bulk_graphs = gsl_mem_zalloc(rtc_bulk_data->num_entries *
+			sizeof(*bulk_graphs));
+		if (!bulk_graphs) {
+			rc = AR_ENOMEMORY;
+			break;
+		}
+		GSL_MUTEX_LOCK(gsl_ctxt.open_close_lock);
+		payload = rtc_bulk_data->entries;
+		for (j = 0; j < rtc_bulk_data->num_entries; ++j) {
+			bulk_entry = (struct gsl_rtc_bulk_entry *)payload;
+			bulk_graphs[j] = to_gsl_graph(
+				(gsl_handle_t)(uintptr_t)bulk_entry->graph_handle);
+			bulk_entry->error_code = bulk_graphs[j] ? AR_EOK : AR_EBADPARAM;
+			payload += GSL_RTC_BULK_ENTRY_SIZE(bulk_entry);
+		}
+		rc = gsl_rtc_graph_bulk_non_persist_data(
+			(req == GSL_RTC_GET_NON_PERSIST_DATA_BULK) ?
+			APM_CMD_GET_CFG : APM_CMD_SET_CFG, bulk_graphs, rtc_bulk_data);
+		GSL_MUTEX_UNLOCK(gsl_ctxt.open_close_lock);
+		gsl_mem_free(bulk_graphs);
+		break;
 	default:
 		GSL_MUTEX_LOCK(gsl_ctxt.open_close_lock);
 		if ((req == GSL_RTC_GET_PERSIST_DATA) ||
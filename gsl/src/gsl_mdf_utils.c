@@ -367,9 +367,9 @@ int32_t gsl_mdf_utils_get_supported_ss_info_from_acdb(void)
 exit:
 	gsl_mem_free(acdb_rsp.buf);
 	if (rc && _gsl_glb_mdf_info.ss_groups)
-		 free(_gsl_glb_mdf_info.ss_groups);
+		 gsl_mem_free(_gsl_glb_mdf_info.ss_groups);
 	if (rc && _gsl_glb_mdf_info.pd_info)
-		 free(_gsl_glb_mdf_info.pd_info);
+		 gsl_mem_free(_gsl_glb_mdf_info.pd_info);
 
 	return rc;
 }
@@ -351,6 +351,185 @@ exit:
 	return rc;
 }
 
+static inline struct gsl_rtc_bulk_entry *gsl_rtc_bulk_get_entry(
+	struct gsl_rtc_bulk_param *params, uint32_t offset)
+{
+	return (struct gsl_rtc_bulk_entry *)(params->entries + offset);
+}
+
+/*
+ * Send all entries whose graph runs on proc_id, starting at entry first, as
+ * one get/set cfg. Params are packed 8 byte aligned in entry order and the
+ * error code SPF wrote to each param is handed back to its entry.
+ */
+static int32_t gsl_rtc_bulk_send_proc_cfg(uint32_t opcode, uint32_t proc_id,
+	uint32_t first, uint32_t first_offset, struct gsl_graph **graphs,
+	struct gsl_rtc_bulk_param *params)
+{
+	int32_t rc = AR_EOK;
+	struct apm_cmd_header_t *cmd_header;
+	struct apm_cmd_rsp_get_cfg_t *get_cfg_rsp;
+	struct gsl_rtc_bulk_entry *entry;
+	apm_module_param_data_t *param_data;
+	gpr_packet_t *rsp_pkt = NULL;
+	gsl_msg_t gsl_msg;
+	uint8_t *rsp_cal_data = NULL;
+	uint32_t payload_size = 0, pos = 0, offset, i;
+	bool_t is_shmem_supported = TRUE;
+	bool_t is_param_err = FALSE;
+
+	offset = first_offset;
+	for (i = first; i < params->num_entries; ++i) {
+		entry = gsl_rtc_bulk_get_entry(params, offset);
+		offset += GSL_RTC_BULK_ENTRY_SIZE(entry);
+		if (graphs[i] && graphs[i]->proc_id == proc_id)
+			payload_size += sizeof(*param_data) +
+				GSL_ALIGN_8BYTE(entry->size);
+	}
+
+	__gpr_cmd_is_shared_mem_supported(proc_id, &is_shmem_supported);
+	rc = gsl_msg_alloc(opcode, rtc_internal_ctxt.src_port,
+			   APM_MODULE_INSTANCE_ID, sizeof(*cmd_header),
+			   0, proc_id, payload_size, false, &gsl_msg);
+	if (rc) {
+		GSL_ERR("gsl msg alloc failed %d", rc);
+		goto set_entry_status;
+	}
+
+	gsl_memset(gsl_msg.payload, 0, payload_size);
+	offset = first_offset;
+	for (i = first; i < params->num_entries; ++i) {
+		entry = gsl_rtc_bulk_get_entry(params, offset);
+		offset += GSL_RTC_BULK_ENTRY_SIZE(entry);
+		if (!graphs[i] || graphs[i]->proc_id != proc_id)
+			continue;
+		param_data = (apm_module_param_data_t *)(gsl_msg.payload + pos);
+		param_data->module_instance_id = entry->miid;
+		param_data->param_id = entry->pid;
+		param_data->param_size = entry->size;
+		gsl_memcpy(param_data + 1, entry->size, entry + 1, entry->size);
+		pos += sizeof(*param_data) + GSL_ALIGN_8BYTE(entry->size);
+	}
+
+	cmd_header = GPR_PKT_GET_PAYLOAD(struct apm_cmd_header_t,
+					 gsl_msg.gpr_packet);
+	cmd_header->payload_size = payload_size;
+
+	GSL_LOG_PKT("send_pkt", rtc_internal_ctxt.src_port, gsl_msg.gpr_packet,
+		    sizeof(*gsl_msg.gpr_packet) + sizeof(*cmd_header), gsl_msg.payload,
+		    cmd_header->payload_size);
+
+	if (is_shmem_supported) {
+		cmd_header->mem_map_handle = gsl_msg.shmem.spf_mmap_handle;
+		cmd_header->payload_address_lsw = (uint32_t)gsl_msg.shmem.spf_addr;
+		cmd_header->payload_address_msw =
+			(uint32_t)(gsl_msg.shmem.spf_addr >> 32);
+		rc = gsl_send_spf_cmd_wait_for_basic_rsp(&gsl_msg.gpr_packet,
+							 &rtc_internal_ctxt.sig);
+		rsp_cal_data = gsl_msg.payload;
+	} else if (opcode == APM_CMD_GET_CFG) {
+		rc = gsl_send_spf_cmd(&gsl_msg.gpr_packet,
+				      &rtc_internal_ctxt.sig, &rsp_pkt);
+		if (!rc && rsp_pkt) {
+			get_cfg_rsp = GPR_PKT_GET_PAYLOAD(
+				struct apm_cmd_rsp_get_cfg_t, rsp_pkt);
+			rc = get_cfg_rsp->status;
+			rsp_cal_data = (uint8_t *)get_cfg_rsp +
+				sizeof(apm_cmd_rsp_get_cfg_t);
+		} else if (!rc) {
+			rc = AR_EFAILED;
+		}
+	} else {
+		/* in-band set cfg only reports one status for the whole packet */
+		rc = gsl_send_spf_cmd_wait_for_basic_rsp(&gsl_msg.gpr_packet,
+							 &rtc_internal_ctxt.sig);
+	}
+	if (rc)
+		GSL_ERR("Bulk cfg cmd 0x%x to proc %d failure:%d", opcode,
+			proc_id, rc);
+
+	if (rsp_cal_data) {
+		pos = 0;
+		offset = first_offset;
+		for (i = first; i < params->num_entries; ++i) {
+			entry = gsl_rtc_bulk_get_entry(params, offset);
+			offset += GSL_RTC_BULK_ENTRY_SIZE(entry);
+			if (!graphs[i] || graphs[i]->proc_id != proc_id)
+				continue;
+			param_data = (apm_module_param_data_t *)(rsp_cal_data + pos);
+			entry->error_code = param_data->error_code;
+			if (param_data->error_code)
+				is_param_err = TRUE;
+			else if (opcode == APM_CMD_GET_CFG)
+				gsl_memcpy(entry + 1, entry->size, param_data + 1,
+					entry->size);
+			pos += sizeof(*param_data) + GSL_ALIGN_8BYTE(entry->size);
+		}
+	}
+
+	gsl_msg_free(&gsl_msg);
+	if (rsp_pkt)
+		__gpr_cmd_free(rsp_pkt);
+
+set_entry_status:
+	/* a failure SPF did not pin on any param applies to the whole group */
+	if (rc && !is_param_err) {
+		offset = first_offset;
+		for (i = first; i < params->num_entries; ++i) {
+			entry = gsl_rtc_bulk_get_entry(params, offset);
+			offset += GSL_RTC_BULK_ENTRY_SIZE(entry);
+			if (graphs[i] && graphs[i]->proc_id == proc_id)
+				entry->error_code = (uint32_t)rc;
+		}
+	}
+	return rc;
+}
+
+int32_t gsl_rtc_graph_bulk_non_persist_data(uint32_t opcode,
+	struct gsl_graph **graphs, struct gsl_rtc_bulk_param *params)
+{
+	int32_t rc = AR_EOK, proc_rc;
+	struct gsl_rtc_bulk_entry *entry;
+	uint32_t offset = 0, i, j;
+
+	for (i = 0; i < params->num_entries; ++i) {
+		entry = gsl_rtc_bulk_get_entry(params, offset);
+		if (graphs[i]) {
+			entry->error_code = AR_EOK;
+			if (!gsl_graph_get_sg_ptr(graphs[i], entry->sgid)) {
+				GSL_ERR("sgid 0x%x not in graph 0x%x", entry->sgid,
+					entry->graph_handle);
+				entry->error_code = AR_EBADPARAM;
+				graphs[i] = NULL;
+			}
+		}
+		if (entry->error_code && !rc)
+			rc = (int32_t)entry->error_code;
+		offset += GSL_RTC_BULK_ENTRY_SIZE(entry);
+	}
+
+	/* one command per processor, sent when its first entry is reached */
+	offset = 0;
+	for (i = 0; i < params->num_entries; ++i) {
+		entry = gsl_rtc_bulk_get_entry(params, offset);
+		if (graphs[i]) {
+			for (j = 0; j < i; ++j) {
+				if (graphs[j] && graphs[j]->proc_id == graphs[i]->proc_id)
+					break;
+			}
+			if (j == i) {
+				proc_rc = gsl_rtc_bulk_send_proc_cfg(opcode,
+					graphs[i]->proc_id, i, offset, graphs, params);
+				if (proc_rc && !rc)
+					rc = proc_rc;
+			}
+		}
+		offset += GSL_RTC_BULK_ENTRY_SIZE(entry);
+	}
+
+	return rc;
+}
+
 int32_t gsl_rtc_graph_set_persist_data(struct gsl_graph *graph,
 	struct gsl_rtc_persist_param *params)
 {
@@ -83,6 +83,53 @@ int32_t gsl_rtc_set_non_persist_data(struct gsl_rtc_param *rtc_param)
 	return rtc_ctxt.rtc_cb(GSL_RTC_SET_NON_PERSIST_DATA, rtc_param);
 }
 
+/*
+ * check every entry lies within the buffer so the layers below can walk
+ * the list without re-checking sizes
+ */
+static int32_t gsl_rtc_check_bulk_param(struct gsl_rtc_bulk_param *rtc_param)
+{
+	struct gsl_rtc_bulk_entry *entry;
+	uint32_t offset = 0, i;
+
+	if (!rtc_param || !rtc_param->entries || !rtc_param->num_entries)
+		return AR_EBADPARAM;
+
+	for (i = 0; i < rtc_param->num_entries; ++i) {
+		if (rtc_param->total_size - offset < sizeof(*entry))
+			return AR_EBADPARAM;
+		entry = (struct gsl_rtc_bulk_entry *)(rtc_param->entries + offset);
+		if ((entry->size & 3) || entry->size >
+			rtc_param->total_size - offset - sizeof(*entry))
+			return AR_EBADPARAM;
+		offset += GSL_RTC_BULK_ENTRY_SIZE(entry);
+	}
+
+	return AR_EOK;
+}
+
+int32_t gsl_rtc_get_non_persist_data_bulk(struct gsl_rtc_bulk_param *rtc_param)
+{
+	if (gsl_rtc_check_bulk_param(rtc_param))
+		return AR_EBADPARAM;
+
+	if (!is_gsl_rtc_inited())
+		return AR_EFAILED;
+
+	return rtc_ctxt.rtc_cb(GSL_RTC_GET_NON_PERSIST_DATA_BULK, rtc_param);
+}
+
+int32_t gsl_rtc_set_non_persist_data_bulk(struct gsl_rtc_bulk_param *rtc_param)
+{
+	if (gsl_rtc_check_bulk_param(rtc_param))
+		return AR_EBADPARAM;
+
+	if (!is_gsl_rtc_inited())
+		return AR_EFAILED;
+
+	return rtc_ctxt.rtc_cb(GSL_RTC_SET_NON_PERSIST_DATA_BULK, rtc_param);
+}
+
 int32_t gsl_rtc_prepare_change_graph(
 	struct gsl_rtc_prepare_change_graph_info *rtc_param)
 {
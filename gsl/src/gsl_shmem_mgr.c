@@ -1755,6 +1755,10 @@ int32_t gsl_shmem_init(uint32_t num_master_procs, uint32_t *master_procs)
 	struct gsl_shmem_page *page = NULL;
 	bool_t is_shmem_supported = FALSE;
 	uint32_t bin_idx = 0;
+	const ar_osal_mutex_attr_t pi_attr = {
+		.flags = AR_OSAL_MUTEX_ATTR_PRIO_INHERIT,
+		.spin_count = 0
+	};
 
 	/* register with GPR */
 	rc = __gpr_cmd_register(GSL_SHMEM_SRC_PORT,
@@ -1802,7 +1806,9 @@ int32_t gsl_shmem_init(uint32_t num_master_procs, uint32_t *master_procs)
 		if (!ctxt[master_procs[i]])
 			continue;
 
-		rc = ar_osal_mutex_create(&ctxt[master_procs[i]]->mutex);
+		/* RT clients allocate shmem while normal threads may hold it */
+		rc = ar_osal_mutex_create_v2(&ctxt[master_procs[i]]->mutex,
+			&pi_attr);
 		if (rc) {
 			GSL_ERR("ar mutex create failed %d", rc);
 			goto cleanup;